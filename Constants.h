@@ -9,7 +9,11 @@
 #ifndef SleepMate_Constants_h
 #define SleepMate_Constants_h
 
-#define UIColorFromRGB(rgbValue) [UIColor colorWithRed:((float)((rgbValue & 0xFF0000) >> 16))/255.0 green:((float)((rgbValue & 0xFF00) >> 8))/255.0 blue:((float)(rgbValue & 0xFF))/255.0 alpha:1.0]
+// Channels scale by a constant reciprocal rather than dividing each one.
+#define UIColorFromRGB(rgbValue) [UIColor colorWithRed:(CGFloat)(((rgbValue) >> 16) & 0xFF) * (1.0 / 255.0) \
+                                                 green:(CGFloat)(((rgbValue) >> 8) & 0xFF) * (1.0 / 255.0) \
+                                                  blue:(CGFloat)((rgbValue) & 0xFF) * (1.0 / 255.0) \
+                                                 alpha:1.0]
 
 
 #define BG_STOREKIT_STATUS @"enable_multiple_bg_selection"
@@ -74,8 +74,9 @@ class DatabaseManager: ObservableObject {
     
     @MainActor
     func prePopulate() async {
-        // Clean up any duplicate sounds first
-        await removeDuplicateSounds()
+        // Index sounds and backgrounds, from the snapshot or one fetch each;
+        // building it also deletes duplicate sounds
+        CatalogIndex.shared.load(managedObjectContext)
         
         // Reset favorite status for existing default sounds
         await resetDefaultSoundsFavoriteStatus()
@@ -93,14 +94,12 @@ class DatabaseManager: ObservableObject {
         let context = managedObjectContext
         let animations = AnimationRegistry.shared.animations
         
+        let catalog = CatalogIndex.shared
+        
         // Create entities for all available animations
         for animation in animations {
             // Check if entity already exists
-            let request = BackgroundEntity.fetchRequest()
-            request.predicate = NSPredicate(format: "animationType == %@", animation.id)
-            
-            let existingEntities = (try? context.fetch(request)) ?? []
-            if existingEntities.isEmpty {
+            if !catalog.contains(SLPCatalogKindBackground, animation.id) {
                 // Create new animation entity
                 guard let entity = NSEntityDescription.entity(forEntityName: "Background", in: context) else { continue }
                 let backgroundEntity = BackgroundEntity(entity: entity, insertInto: context)
@@ -114,13 +113,12 @@ class DatabaseManager: ObservableObject {
         }
         
         // Select a default animation if none is selected
-        let selectedRequest = BackgroundEntity.fetchSelectedBackground()
-        let selectedEntities = (try? context.fetch(selectedRequest)) ?? []
-        if selectedEntities.isEmpty, let firstAnimation = animations.first {
-            let request = BackgroundEntity.fetchRequest()
-            request.predicate = NSPredicate(format: "animationType == %@", firstAnimation.id)
-            if let entity = (try? context.fetch(request))?.first {
-                entity.isSelected = true
+        if catalog.rows(SLPCatalogKindBackground, SLPCatalogFlagSelected).isEmpty,
+           let firstAnimation = animations.first {
+            let row = catalog.row(SLPCatalogKindBackground, firstAnimation.id)
+            if row != SLPCatalogNotFound {
+                catalog.select(SLPCatalogKindBackground, row)
+                catalog.writeBack()
             }
         }
         
@@ -142,18 +140,20 @@ class DatabaseManager: ObservableObject {
             ("Stream", "stream.mp3", nil),
             ("Waterfall", "waterfall.mp3", nil),
             ("Waves", "waves.mp3", nil),
-            ("Wind", "wind.mp3", nil)
+            ("Wind", "wind.mp3", nil),
+            // Generated by the mixer; no asset in the bundle
+            ("White Noise", ProceduralNoise.white.soundName, nil),
+            ("Pink Noise", ProceduralNoise.pink.soundName, nil),
+            ("Brown Noise", ProceduralNoise.brown.soundName, nil)
         ]
         
         let context = managedObjectContext
         
-        // Check if default sounds already exist to prevent duplicates
-        let existingSounds = fetchAllSounds()
-        let existingTitles = Set(existingSounds.compactMap { $0.bTitle })
+        let catalog = CatalogIndex.shared
         
         for (title, url1, url2) in defaultSounds {
             // Only add if this sound doesn't already exist
-            if !existingTitles.contains(title) {
+            if !catalog.contains(SLPCatalogKindSound, title) {
                 guard let entity = NSEntityDescription.entity(forEntityName: "Sound", in: context) else { continue }
                 let sound = SoundEntity(entity: entity, insertInto: context)
                 sound.bTitle = title
@@ -201,64 +201,20 @@ class DatabaseManager: ObservableObject {
     
     @MainActor
     func resetDefaultSoundsFavoriteStatus() async {
-        let context = managedObjectContext
-        let request = SoundEntity.fetchAllSounds()
+        let catalog = CatalogIndex.shared
         
-        do {
-            let allSounds = try context.fetch(request)
-            var updatedCount = 0
-            
-            for sound in allSounds {
-                // Reset favorite status for default sounds (those with .mp3 files in bundle)
-                if let soundUrl = sound.soundUrl1, soundUrl.hasSuffix(".mp3") {
-                    if sound.isFavorite {
-                        sound.isFavorite = false
-                        updatedCount += 1
-                    }
-                }
-            }
-            
-            if updatedCount > 0 {
-                await saveContextAsync()
-                print("Reset favorite status for \(updatedCount) default sounds")
+        // Only the favorites are read, from the index
+        for row in catalog.rows(SLPCatalogKindSound, SLPCatalogFlagFavorite) {
+            // Reset favorite status for default sounds (those with .mp3 files in bundle)
+            if let soundUrl = catalog.soundUrl1(row), soundUrl.hasSuffix(".mp3") {
+                catalog.setFlag(SLPCatalogKindSound, row, SLPCatalogFlagFavorite, false)
             }
-        } catch {
-            print("Error resetting favorite status: \(error)")
         }
-    }
-    
-    @MainActor
-    func removeDuplicateSounds() async {
-        let context = managedObjectContext
-        let request = SoundEntity.fetchAllSounds()
         
-        do {
-            let allSounds = try context.fetch(request)
-            var seenTitles: Set<String> = []
-            var soundsToDelete: [SoundEntity] = []
-            
-            for sound in allSounds {
-                guard let title = sound.bTitle else { continue }
-                
-                if seenTitles.contains(title) {
-                    // This is a duplicate
-                    soundsToDelete.append(sound)
-                } else {
-                    seenTitles.insert(title)
-                }
-            }
-            
-            // Delete duplicates
-            for sound in soundsToDelete {
-                context.delete(sound)
-            }
-            
-            if !soundsToDelete.isEmpty {
-                await saveContextAsync()
-                print("Removed \(soundsToDelete.count) duplicate sounds")
-            }
-        } catch {
-            print("Error removing duplicate sounds: \(error)")
+        let updatedCount = catalog.writeBack()
+        if updatedCount > 0 {
+            await saveContextAsync()
+            print("Reset favorite status for \(updatedCount) default sounds")
         }
     }
 
@@ -266,75 +222,54 @@ class DatabaseManager: ObservableObject {
     
     @MainActor
     func fetchAllSounds() -> [SoundEntity] {
-        let context = managedObjectContext
-        let request = SoundEntity.fetchAllSounds()
-        
-        do {
-            return try context.fetch(request)
-        } catch {
-            print("Error fetching sounds: \(error)")
-            return []
+        Tracing.span(.storage, "db.fetchAllSounds") {
+            let context = managedObjectContext
+            let request = SoundEntity.fetchAllSounds()
+            
+            do {
+                return try context.fetch(request)
+            } catch {
+                print("Error fetching sounds: \(error)")
+                return []
+            }
         }
     }
     
     @MainActor
     func fetchAllBackgrounds() -> [BackgroundEntity] {
-        let context = managedObjectContext
-        let request = BackgroundEntity.fetchAllBackgrounds()
-        
-        do {
-            return try context.fetch(request)
-        } catch {
-            print("Error fetching backgrounds: \(error)")
-            return []
+        Tracing.span(.storage, "db.fetchAllBackgrounds") {
+            let context = managedObjectContext
+            let request = BackgroundEntity.fetchAllBackgrounds()
+            
+            do {
+                return try context.fetch(request)
+            } catch {
+                print("Error fetching backgrounds: \(error)")
+                return []
+            }
         }
     }
     
     @MainActor
     func fetchSelectedSound() -> SoundEntity? {
-        let context = managedObjectContext
-        let request = SoundEntity.fetchSelectedSound()
-        
-        do {
-            return try context.fetch(request).first
-        } catch {
-            print("Error fetching selected sound: \(error)")
-            return nil
+        Tracing.span(.storage, "db.fetchSelectedSound") {
+            CatalogIndex.shared.first(SLPCatalogKindSound, SLPCatalogFlagSelected, as: SoundEntity.self)
         }
     }
     
     @MainActor
     func fetchSelectedSoundsForMixing() -> [SoundEntity] {
-        let context = managedObjectContext
-        let request = SoundEntity.fetchSelectedSoundsForMixing()
-        
-        do {
-            return try context.fetch(request)
-        } catch {
-            print("Error fetching selected sounds for mixing: \(error)")
-            return []
+        Tracing.span(.storage, "db.fetchSelectedSoundsForMixing") {
+            CatalogIndex.shared.all(SLPCatalogKindSound, SLPCatalogFlagSelectedForMixing, as: SoundEntity.self)
+                .sorted { ($0.bTitle ?? "") < ($1.bTitle ?? "") }
         }
     }
     
     @MainActor
     func fetchSelectedBackground() -> BackgroundEntity? {
-        let context = managedObjectContext
-        let request = BackgroundEntity.fetchSelectedBackground()
-        
-        do {
-            let results = try context.fetch(request)
-            guard let background = results.first else { return nil }
-            
-            // Ensure we have a properly formed BackgroundEntity with animationType
-            if background.animationType == nil {
-                print("⚠️ Found background entity without animationType - skipping")
-                return nil
-            }
-            
-            return background
-        } catch {
-            print("❌ Error fetching selected background: \(error)")
-            return nil
+        Tracing.span(.storage, "db.fetchSelectedBackground") {
+            // Backgrounds without an animationType are never indexed
+            CatalogIndex.shared.first(SLPCatalogKindBackground, SLPCatalogFlagSelected, as: BackgroundEntity.self)
         }
     }
     
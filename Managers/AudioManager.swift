@@ -28,7 +28,12 @@ class AudioManager: NSObject, ObservableObject {
     
     // MARK: - Legacy AVAudioPlayer (for compatibility)
     private var audioPlayer: AVAudioPlayer?
-    private var fadeCancellable: AnyCancellable?
+    
+    // MARK: - Procedural Noise
+    /// Noise sounds have no file for AVAudioPlayer; they play as a voice of
+    /// the native mixer instead
+    private var noisePlayer: AudioChannelPlayer?
+    private static let noisePreviewSeconds: TimeInterval = 10
     
     // MARK: - Core Data
     private let coreDataStack: CoreDataStack
@@ -111,8 +116,9 @@ class AudioManager: NSObject, ObservableObject {
         isLooping = loop
         playCompletionHandler = completion
         
-        // Try to load from bundle first
-        if let soundPath = Bundle.main.path(forResource: url.replacingOccurrences(of: ".mp3", with: ""), ofType: "mp3") {
+        if ProceduralNoise(soundName: url) != nil {
+            playNoise(named: url, loop: loop)
+        } else if let soundPath = Bundle.main.path(forResource: url.replacingOccurrences(of: ".mp3", with: ""), ofType: "mp3") {
             playLocalSound(path: soundPath, loop: loop)
         } else if let soundURL = URL(string: url) {
             if soundURL.scheme != nil {
@@ -170,14 +176,49 @@ class AudioManager: NSObject, ObservableObject {
         }.resume()
     }
     
+    /// Noise never ends on its own, so a preview (`loop == false`) stops
+    /// after a few seconds and then reports completion like a file would.
+    private func playNoise(named soundName: String, loop: Bool) {
+        let engine = AudioMixingEngine.shared
+        Task {
+            guard let player = await engine.playSound(named: soundName, volume: isMuted ? 0 : volume, loop: true) else {
+                return
+            }
+            // A stop or another sound may have arrived while the voice started
+            guard currentSoundURL == soundName, noisePlayer == nil else {
+                await engine.stopSound(player)
+                return
+            }
+            noisePlayer = player
+            isPlaying = true
+            
+            guard !loop else { return }
+            try? await Task.sleep(nanoseconds: UInt64(Self.noisePreviewSeconds * 1_000_000_000))
+            guard noisePlayer === player else { return }
+            stopNoise()
+            isPlaying = false
+            currentSoundURL = nil
+            playCompletionHandler?()
+            playCompletionHandler = nil
+        }
+    }
+    
+    private func stopNoise(fadeOutDuration: TimeInterval = 0) {
+        guard let player = noisePlayer else { return }
+        noisePlayer = nil
+        Task {
+            await AudioMixingEngine.shared.stopSound(player, fadeOutDuration: fadeOutDuration)
+        }
+    }
+    
     // MARK: - Audio Control
     func stopAllSounds() {
-        fadeCancellable?.cancel()
-        fadeCancellable = nil
+        audioPlayer?.cancelFade()
         
         audioPlayer?.stop()
         audioPlayer = nil
         audioPlayerNode.stop()
+        stopNoise()
         
         isPlaying = false
         currentSoundURL = nil
@@ -186,13 +227,20 @@ class AudioManager: NSObject, ObservableObject {
     func pauseAudio() {
         audioPlayer?.pause()
         audioPlayerNode.pause()
+        // Noise has no position to keep; silencing it is a pause
+        if let player = noisePlayer {
+            AudioMixingEngine.shared.setVolume(0, for: player)
+        }
         isPlaying = false
     }
     
     func resumeAudio() {
         audioPlayer?.play()
         audioPlayerNode.play()
-        isPlaying = audioPlayer?.isPlaying ?? false
+        if let player = noisePlayer {
+            AudioMixingEngine.shared.setVolume(isMuted ? 0 : volume, for: player)
+        }
+        isPlaying = noisePlayer != nil || (audioPlayer?.isPlaying ?? false)
     }
     
     func setVolume(_ newVolume: Float) {
@@ -201,6 +249,9 @@ class AudioManager: NSObject, ObservableObject {
         if !isMuted {
             audioPlayer?.volume = volume
             audioMixer.outputVolume = volume
+            if let player = noisePlayer {
+                AudioMixingEngine.shared.setVolume(volume, for: player)
+            }
         }
     }
     
@@ -214,70 +265,57 @@ class AudioManager: NSObject, ObservableObject {
             audioPlayer?.volume = volume
             audioMixer.outputVolume = volume
         }
+        if let player = noisePlayer {
+            AudioMixingEngine.shared.setVolume(isMuted ? 0 : volume, for: player)
+        }
     }
     
     // MARK: - Fade Effects
+    
+    /// The player ramps its own volume on the audio thread; the main actor
+    /// only wakes once, when the fade has finished.
     func fadeOutAndStop(duration: TimeInterval, completion: (() -> Void)? = nil) {
         fadeCompletionHandler = completion
         
-        guard let player = audioPlayer, player.isPlaying else {
-            completion?()
+        if let noise = noisePlayer {
+            noisePlayer = nil
+            Task {
+                await AudioMixingEngine.shared.stopSound(noise, fadeOutDuration: duration)
+                stopAllSounds()
+                fadeCompletionHandler?()
+                fadeCompletionHandler = nil
+            }
             return
         }
         
-        let originalVolume = player.volume
-        let fadeSteps = 20
-        let stepDuration = duration / Double(fadeSteps)
-        let volumeStep = originalVolume / Float(fadeSteps)
-        
-        // Use a reference type to capture currentStep
-        class StepCounter {
-            var value = 0
+        guard let player = audioPlayer, player.isPlaying else {
+            completion?()
+            return
         }
-        let currentStep = StepCounter()
         
-        fadeCancellable = Timer.publish(every: stepDuration, on: .main, in: .common)
-            .autoconnect()
-            .sink { [weak self] _ in
-                guard let self = self, let player = self.audioPlayer else { return }
-                
-                currentStep.value += 1
-                let newVolume = originalVolume - (volumeStep * Float(currentStep.value))
-                
-                if newVolume <= 0 || currentStep.value >= fadeSteps {
-                    self.fadeCancellable?.cancel()
-                    self.fadeCancellable = nil
-                    self.stopAllSounds()
-                    self.fadeCompletionHandler?()
-                    self.fadeCompletionHandler = nil
-                } else {
-                    player.volume = newVolume
-                }
+        player.fadeToVolume(0.0, duration: duration) { [weak self] in
+            Task { @MainActor in
+                guard let self = self else { return }
+                self.stopAllSounds()
+                self.fadeCompletionHandler?()
+                self.fadeCompletionHandler = nil
             }
+        }
     }
     
     func fadeIn(duration: TimeInterval) {
+        if let noise = noisePlayer {
+            AudioMixingEngine.shared.setVolume(0, for: noise)
+            let target = volume
+            Task {
+                await AudioMixingEngine.shared.rampVolume(of: noise, to: target, duration: duration)
+            }
+            return
+        }
         guard let player = audioPlayer else { return }
         
         player.volume = 0
-        let targetVolume = volume
-        let fadeSteps = 20
-        let stepDuration = duration / Double(fadeSteps)
-        let volumeStep = targetVolume / Float(fadeSteps)
-        
-        var currentStep = 0
-        
-        Timer.scheduledTimer(withTimeInterval: stepDuration, repeats: true) { timer in
-            currentStep += 1
-            let newVolume = volumeStep * Float(currentStep)
-            
-            if newVolume >= targetVolume || currentStep >= fadeSteps {
-                timer.invalidate()
-                player.volume = targetVolume
-            } else {
-                player.volume = newVolume
-            }
-        }
+        player.fadeToVolume(volume, duration: duration)
     }
     
     // MARK: - App Lifecycle Handling
@@ -349,7 +387,7 @@ class AudioManager: NSObject, ObservableObject {
     
     deinit {
         NotificationCenter.default.removeObserver(self)
-        fadeCancellable?.cancel()
+        audioPlayer?.cancelFade()
         // Stop sounds synchronously in deinit to avoid capturing self
         audioPlayer?.stop()
         audioPlayer = nil
@@ -16,6 +16,17 @@ class BrightnessManager: ObservableObject {
     private var originalBrightness: Double = 0.5
     private var isSleepModeActive = false
     private var shouldRestoreOnTouch = false
+    private var ramp: Ramp?
+    private var rampTask: Task<Void, Never>?
+    
+    /// A planned brightness ramp and when it started
+    private struct Ramp {
+        let steps: [SLPBrightnessStep]
+        let startDate: Date
+    }
+    
+    private static let rampConfig = SLPBrightnessRampGetDefaultConfig()
+    private static let restoreDuration: TimeInterval = 1.0
     
     // MARK: - Published Properties
     @Published var currentBrightness: Double = 0.5
@@ -29,6 +40,8 @@ class BrightnessManager: ObservableObject {
         if settingsManager.lastBrightnessLevel > 0 {
             setBrightness(settingsManager.lastBrightnessLevel, animated: false)
         }
+        
+        setupNotifications()
     }
     
     // MARK: - Public Methods
@@ -36,19 +49,16 @@ class BrightnessManager: ObservableObject {
     /// Sets the screen brightness to the specified level
     /// - Parameters:
     ///   - level: Brightness level (0.01 to 1.0)
-    ///   - animated: Whether to animate the transition
-    ///   - duration: Animation duration (default: 0.5 seconds)
+    ///   - animated: Whether to ramp to the level
+    ///   - duration: Ramp duration (default: 0.5 seconds)
     func setBrightness(_ level: Double, animated: Bool = true, duration: TimeInterval = 0.5) {
         let clampedLevel = max(0.01, min(1.0, level))
         
         if animated {
-            withAnimation(.easeInOut(duration: duration)) {
-                UIScreen.main.brightness = clampedLevel
-                currentBrightness = clampedLevel
-            }
+            startRamp(to: clampedLevel, duration: duration)
         } else {
-            UIScreen.main.brightness = clampedLevel
-            currentBrightness = clampedLevel
+            cancelRamp()
+            apply(clampedLevel)
         }
         
         // Save the brightness level unless we're in sleep mode
@@ -57,7 +67,8 @@ class BrightnessManager: ObservableObject {
         }
     }
     
-    /// Dims the screen for sleep mode if auto-brightness is enabled
+    /// Dims the screen for sleep mode if auto-brightness is enabled, gradually
+    /// over the sleep dim duration
     func dimForSleep() {
         print("🔆 BrightnessManager.dimForSleep() called")
         print("🔆 Auto-brightness enabled: \(settingsManager.isAutoBrightnessEnabled)")
@@ -88,10 +99,7 @@ class BrightnessManager: ObservableObject {
         
         print("🔆 Setting brightness from \(originalBrightness) to \(targetBrightness)")
         
-        withAnimation(.easeInOut(duration: 2.0)) {
-            UIScreen.main.brightness = targetBrightness
-            currentBrightness = targetBrightness
-        }
+        startRamp(to: targetBrightness, duration: settingsManager.sleepDimDuration)
         
         print("BrightnessManager: Dimmed for sleep mode (\(Int(targetBrightness * 100))%)")
     }
@@ -117,10 +125,7 @@ class BrightnessManager: ObservableObject {
         
         print("🔆 Restoring brightness from \(UIScreen.main.brightness) to \(originalBrightness)")
         
-        withAnimation(.easeInOut(duration: 1.0)) {
-            UIScreen.main.brightness = originalBrightness
-            currentBrightness = originalBrightness
-        }
+        startRamp(to: originalBrightness, duration: Self.restoreDuration)
         
         // Update saved brightness level to the restored value
         settingsManager.lastBrightnessLevel = originalBrightness
@@ -128,7 +133,8 @@ class BrightnessManager: ObservableObject {
         print("BrightnessManager: Restored brightness from sleep mode (\(Int(originalBrightness * 100))%)")
     }
     
-    /// Sets flag to restore brightness on next user touch (used when timer expires)
+    /// Sets flag to restore brightness on next user touch (used when timer expires).
+    /// A dim still in progress carries on meanwhile.
     func scheduleRestoreOnTouch() {
         print("🔆 BrightnessManager.scheduleRestoreOnTouch() called")
         print("🔆 Auto-brightness enabled: \(settingsManager.isAutoBrightnessEnabled)")
@@ -153,10 +159,7 @@ class BrightnessManager: ObservableObject {
         shouldRestoreOnTouch = false
         isSleepModeActive = false
         
-        withAnimation(.easeInOut(duration: 1.0)) {
-            UIScreen.main.brightness = originalBrightness
-            currentBrightness = originalBrightness
-        }
+        startRamp(to: originalBrightness, duration: Self.restoreDuration)
         
         // Update saved brightness level to the restored value
         settingsManager.lastBrightnessLevel = originalBrightness
@@ -169,12 +172,100 @@ class BrightnessManager: ObservableObject {
         isSleepModeActive = false
         let targetBrightness = settingsManager.lastBrightnessLevel
         
-        UIScreen.main.brightness = targetBrightness
-        currentBrightness = targetBrightness
+        cancelRamp()
+        apply(targetBrightness)
         
         print("BrightnessManager: Force restored to \(Int(targetBrightness * 100))%")
     }
     
+    // MARK: - Ramps
+    
+    /// Replaces any running ramp with one to `target` over `duration`. Screen
+    /// brightness can't be animated, so the ramp is a planned list of updates,
+    /// even in perceived lightness and only as many as can be seen.
+    private func startRamp(to target: Double, duration: TimeInterval) {
+        cancelRamp()
+        let from = Double(UIScreen.main.brightness)
+        let count = SLPBrightnessRampPlan(from, target, duration, Self.rampConfig, nil, 0)
+        guard count > 0 else { return }
+        
+        var steps = [SLPBrightnessStep](repeating: SLPBrightnessStep(), count: count)
+        SLPBrightnessRampPlan(from, target, duration, Self.rampConfig, &steps, count)
+        ramp = Ramp(steps: steps, startDate: Date())
+        print("🔆 Ramping brightness from \(from) to \(target) over \(Int(duration))s in \(count) updates")
+        resumeRamp()
+    }
+    
+    /// Catches up with the ramp's schedule and issues the rest of its steps on
+    /// time; does nothing when no ramp is pending or one is already running
+    private func resumeRamp() {
+        guard let ramp = ramp, rampTask == nil else { return }
+        
+        rampTask = Task { [weak self] in
+            let elapsed = Date().timeIntervalSince(ramp.startDate)
+            var index = ramp.steps.withUnsafeBufferPointer { steps in
+                SLPBrightnessRampGetStepsDue(steps.baseAddress!, steps.count, elapsed)
+            }
+            if index > 0 {
+                self?.apply(ramp.steps[index - 1].brightness)
+            }
+            
+            while index < ramp.steps.count {
+                let wait = ramp.steps[index].time - Date().timeIntervalSince(ramp.startDate)
+                if wait > 0 {
+                    try? await Task.sleep(nanoseconds: UInt64(wait * 1_000_000_000))
+                }
+                guard !Task.isCancelled, let self = self else { return }
+                self.apply(ramp.steps[index].brightness)
+                index += 1
+            }
+            
+            self?.ramp = nil
+            self?.rampTask = nil
+        }
+    }
+    
+    /// Stops issuing updates but keeps the ramp, so `resumeRamp` can pick it
+    /// up where its schedule has got to by then
+    private func pauseRamp() {
+        rampTask?.cancel()
+        rampTask = nil
+    }
+    
+    private func cancelRamp() {
+        pauseRamp()
+        ramp = nil
+    }
+    
+    private func apply(_ level: Double) {
+        UIScreen.main.brightness = level
+        currentBrightness = level
+    }
+    
+    /// iOS puts the system brightness back while the app is inactive, so a ramp
+    /// pauses then and resumes at its scheduled level when the app is back
+    private func setupNotifications() {
+        NotificationCenter.default.addObserver(
+            forName: UIApplication.willResignActiveNotification,
+            object: nil,
+            queue: .main
+        ) { [weak self] _ in
+            Task { @MainActor in
+                self?.pauseRamp()
+            }
+        }
+        
+        NotificationCenter.default.addObserver(
+            forName: UIApplication.didBecomeActiveNotification,
+            object: nil,
+            queue: .main
+        ) { [weak self] _ in
+            Task { @MainActor in
+                self?.resumeRamp()
+            }
+        }
+    }
+    
     // MARK: - Preset Methods
     
     /// Sets brightness to dim level (10%)
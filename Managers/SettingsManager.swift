@@ -33,6 +33,7 @@ class SettingsManager: ObservableObject {
         static let isAutoBrightnessEnabled = "isAutoBrightnessEnabled"
         static let lastBrightnessLevel = "lastBrightnessLevel"
         static let sleepModeBrightnessLevel = "sleepModeBrightnessLevel"
+        static let sleepDimDuration = "sleepDimDuration"
     }
     
     // MARK: - Default Values
@@ -55,6 +56,7 @@ class SettingsManager: ObservableObject {
         static let isAutoBrightnessEnabled = true
         static let lastBrightnessLevel: Double = 0.5
         static let sleepModeBrightnessLevel: Double = 0.1
+        static let sleepDimDuration: TimeInterval = 1200.0 // 20 minutes
     }
     
     private let userDefaults = UserDefaults.standard
@@ -220,6 +222,18 @@ class SettingsManager: ObservableObject {
         }
     }
     
+    /// How long the screen takes to dim to the sleep level
+    var sleepDimDuration: TimeInterval {
+        get {
+            let value = userDefaults.double(forKey: Keys.sleepDimDuration)
+            return value >= 0 ? value : Defaults.sleepDimDuration
+        }
+        set {
+            userDefaults.set(max(0, newValue), forKey: Keys.sleepDimDuration)
+            objectWillChange.send()
+        }
+    }
+    
     // MARK: - Initialization
     init() {
         // Load current values or set defaults
@@ -258,7 +272,8 @@ class SettingsManager: ObservableObject {
             Keys.lastDatabaseVersion: Defaults.lastDatabaseVersion,
             Keys.isAutoBrightnessEnabled: Defaults.isAutoBrightnessEnabled,
             Keys.lastBrightnessLevel: Defaults.lastBrightnessLevel,
-            Keys.sleepModeBrightnessLevel: Defaults.sleepModeBrightnessLevel
+            Keys.sleepModeBrightnessLevel: Defaults.sleepModeBrightnessLevel,
+            Keys.sleepDimDuration: Defaults.sleepDimDuration
         ]
         
         userDefaults.register(defaults: defaults)
@@ -308,8 +323,7 @@ class SettingsManager: ObservableObject {
     }
     
     private func updateAnalyticsConsent() {
-        // Enable or disable analytics based on user preference
-        // This would integrate with analytics SDKs like Flurry
+        Analytics.shared.isEnabled = isAnalyticsEnabled
     }
     
     // MARK: - Utility Methods
@@ -23,7 +23,8 @@ class TimerManager: ObservableObject {
     private let audioManager: AudioManager
     
     // MARK: - Timer Components
-    private var cancellables = Set<AnyCancellable>()
+    private var tickTimer: TimerScheduler.Token?
+    private var endTimer: TimerScheduler.Token?
     private var startTime: Date?
     private var pausedTime: TimeInterval = 0
     private var fadeOutDuration: TimeInterval = 10.0
@@ -61,7 +62,7 @@ class TimerManager: ObservableObject {
     }
     
     func stopTimer() {
-        cancellables.removeAll()
+        stopInternalTimer()
         isRunning = false
         isPaused = false
         timeRemaining = 0
@@ -73,7 +74,7 @@ class TimerManager: ObservableObject {
     func pauseTimer() {
         guard isRunning && !isPaused else { return }
         
-        cancellables.removeAll()
+        stopInternalTimer()
         isPaused = true
         
         // Store how much time has passed
@@ -100,17 +101,52 @@ class TimerManager: ObservableObject {
         duration += additionalTime
         timeRemaining += additionalTime
         updateProgress()
+        
+        if !isPaused {
+            scheduleEnd()
+        }
     }
     
     // MARK: - Internal Timer
+    /// The countdown display ticks every second with some tolerance, so it
+    /// shares wakeups with other timers; the end has its own critical timer
+    /// and stays on time when the screen is off.
     private func startInternalTimer() {
-        // Use SwiftUI's Timer.publish for non-blocking timer
-        Timer.publish(every: 1, on: .main, in: .common)
-            .autoconnect()
-            .sink { [weak self] _ in
+        stopInternalTimer()
+        tickTimer = TimerScheduler.shared.schedule(after: 1, repeating: 1, tolerance: 0.25) { [weak self] in
+            Task { @MainActor in
                 self?.updateTimer()
             }
-            .store(in: &cancellables)
+        }
+        scheduleEnd()
+    }
+    
+    private func scheduleEnd() {
+        guard let startTime = startTime else { return }
+        let remaining = max(0, duration - pausedTime - Date().timeIntervalSince(startTime))
+        TimerScheduler.shared.cancel(endTimer)
+        endTimer = TimerScheduler.shared.schedule(after: remaining, tolerance: 0, critical: true) { [weak self] in
+            Task { @MainActor in
+                self?.endTimerFired()
+            }
+        }
+    }
+    
+    private func endTimerFired() {
+        guard isRunning && !isPaused else { return }
+        updateTimer()
+        if isRunning {
+            timeRemaining = 0
+            timerUpdatedSubject.send(timeRemaining)
+            timerCompleted()
+        }
+    }
+    
+    private func stopInternalTimer() {
+        TimerScheduler.shared.cancel(tickTimer)
+        TimerScheduler.shared.cancel(endTimer)
+        tickTimer = nil
+        endTimer = nil
     }
     
     private func updateTimer() {
@@ -136,7 +172,7 @@ class TimerManager: ObservableObject {
     }
     
     private func timerCompleted() {
-        cancellables.removeAll()
+        stopInternalTimer()
         isRunning = false
         isPaused = false
         timeRemaining = 0
@@ -239,7 +275,8 @@ class TimerManager: ObservableObject {
     
     deinit {
         // Clean up synchronously in deinit to avoid capturing self
-        cancellables.removeAll()
+        TimerScheduler.shared.cancel(tickTimer)
+        TimerScheduler.shared.cancel(endTimer)
         UNUserNotificationCenter.current().removePendingNotificationRequests(withIdentifiers: ["sleepster.timer.completed"])
     }
 }
\ No newline at end of file
@@ -24,7 +24,9 @@ class PerformanceMonitor: ObservableObject {
     @Published var audioLatency: Double = 0.0
     @Published var frameRate: Double = 60.0
     
-    private var monitoringTimer: Timer?
+    @Published var timerWakeupsPerHour: Double = 0.0
+    
+    private var monitoringTimer: TimerScheduler.Token?
     private var isMonitoring = false
     
     private init() {
@@ -37,7 +39,7 @@ class PerformanceMonitor: ObservableObject {
         guard !isMonitoring else { return }
         
         isMonitoring = true
-        monitoringTimer = Timer.scheduledTimer(withTimeInterval: 1.0, repeats: true) { [weak self] _ in
+        monitoringTimer = TimerScheduler.shared.schedule(after: 1.0, repeating: 1.0, tolerance: 0.5) { [weak self] in
             Task { @MainActor in
                 self?.updateMetrics()
             }
@@ -45,7 +47,7 @@ class PerformanceMonitor: ObservableObject {
     }
     
     func stopMonitoring() {
-        monitoringTimer?.invalidate()
+        TimerScheduler.shared.cancel(monitoringTimer)
         monitoringTimer = nil
         isMonitoring = false
     }
@@ -54,6 +56,7 @@ class PerformanceMonitor: ObservableObject {
         memoryUsage = getCurrentMemoryUsage()
         cpuUsage = getCurrentCPUUsage()
         audioLatency = AudioMixingEngine.shared.currentLatency
+        timerWakeupsPerHour = TimerScheduler.shared.metrics.wakeupsPerHour
         frameRate = UIScreen.main.maximumFramesPerSecond > 0 ? Double(UIScreen.main.maximumFramesPerSecond) : 60.0
     }
     
@@ -209,9 +212,9 @@ extension AudioMixingEngine {
     }
     
     func releaseUnusedResources() async {
-        // Remove inactive players - check if playerNode is playing
+        // Remove players whose mixer voice has already been released
         activePlayers.removeAll { player in
-            return !player.playerNode.isPlaying
+            return !player.isActive
         }
         
         // Optimize audio engine performance
@@ -276,20 +279,19 @@ extension View {
     }
 }
 
-/// Debounces rapid updates to improve performance
+/// Debounces rapid updates to improve performance. A debounced action may
+/// run up to a tenth of its delay late, which lets it share a wakeup.
 class DebounceManager {
-    private var workItems: [String: DispatchWorkItem] = [:]
+    private var timers: [String: TimerScheduler.Token] = [:]
     
     func debounce(key: String, delay: TimeInterval, action: @escaping () -> Void) {
-        // Cancel previous work item
-        workItems[key]?.cancel()
-        
-        // Create new work item
-        let workItem = DispatchWorkItem(block: action)
-        workItems[key] = workItem
+        // Cancel the pending action
+        TimerScheduler.shared.cancel(timers[key])
         
-        // Schedule execution
-        DispatchQueue.main.asyncAfter(deadline: .now() + delay, execute: workItem)
+        timers[key] = TimerScheduler.shared.schedule(after: delay, tolerance: delay * 0.1) { [weak self] in
+            self?.timers.removeValue(forKey: key)
+            action()
+        }
     }
 }
 
@@ -413,47 +415,6 @@ class BatteryOptimizer {
     }
 }
 
-// MARK: - Launch Time Optimization
-
-class LaunchOptimizer {
-    static let shared = LaunchOptimizer()
-    
-    private init() {}
-    
-    func optimizeAppLaunch() {
-        // Defer non-critical initializations
-        Task { @MainActor in
-            self.initializeNonCriticalServices()
-        }
-        
-        // Preload essential data
-        Task {
-            await preloadEssentialData()
-        }
-    }
-    
-    @MainActor
-    private func initializeNonCriticalServices() {
-        // Initialize services that aren't needed immediately
-        _ = ShortcutsManager.shared
-        _ = PerformanceMonitor.shared
-        _ = BatteryOptimizer.shared
-    }
-    
-    private func preloadEssentialData() async {
-        // Preload sounds library (using database manager)
-        await ServiceContainer.shared.databaseManager.prePopulate()
-        
-        // Preload user preferences (settings manager doesn't have async loading)
-        await MainActor.run {
-            _ = ServiceContainer.shared.settingsManager
-        }
-        
-        // Initialize StoreKit (using StoreKitManager directly)
-        await StoreKitManager.shared.loadProducts()
-    }
-}
-
 // MARK: - Performance Testing Utilities
 
 #if DEBUG
@@ -49,7 +49,7 @@ class ServiceContainer: ObservableObject {
     
     // MARK: - Animation Services (Phase 1)
     lazy var animationPerformanceMonitor: AnimationPerformanceMonitor = {
-        AnimationPerformanceMonitor()
+        AnimationPerformanceMonitor.shared
     }()
     
     lazy var errorHandler: ErrorHandler = {
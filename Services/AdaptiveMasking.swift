@@ -0,0 +1,99 @@
+//
+//  AdaptiveMasking.swift
+//  SleepMate
+//
+//  Keeps the mix just loud enough to cover the room through the night.
+//  SleepSoundMonitor's input tap hands every microphone buffer here; the
+//  native controller listens for a few hundred milliseconds every few
+//  seconds, compares what it heard with what the mixer was playing at the
+//  time, and its gain and EQ offsets are applied on the main actor on top
+//  of the user's own settings.
+//
+
+import AVFoundation
+import Foundation
+
+final class AdaptiveMasking {
+    static let shared = AdaptiveMasking()
+
+    /// Guards `controller`; buffers arrive on the tap's thread.
+    private let lock = NSLock()
+    private var controller: OpaquePointer?
+    private var reference: OpaquePointer?
+
+    private init() {}
+
+    var isRunning: Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        return controller != nil
+    }
+
+    // MARK: - Control
+
+    /// Starts matching microphone buffers against the mixer's output. False
+    /// when the microphone runs at another rate than the mixer, whose
+    /// output the echo reference holds.
+    @MainActor
+    @discardableResult
+    func start(sampleRate: Double) -> Bool {
+        let engine = AudioMixingEngine.shared
+        guard sampleRate == engine.sampleRate else {
+            #if DEBUG
+            print("AdaptiveMasking: microphone at \(sampleRate) Hz, output at \(engine.sampleRate) Hz")
+            #endif
+            return false
+        }
+
+        // Output reaches the tap's buffers after the output and input
+        // latency of the route.
+        let session = AVAudioSession.sharedInstance()
+        let echoDelay = session.outputLatency + session.inputLatency
+
+        lock.lock()
+        SLPMaskingControllerDestroy(controller)
+        controller = SLPMaskingControllerCreate(sampleRate, echoDelay)
+        reference = engine.echoReference
+        lock.unlock()
+        return true
+    }
+
+    /// Stops and hands the mix back to the user's settings.
+    @MainActor
+    func stop() {
+        lock.lock()
+        SLPMaskingControllerDestroy(controller)
+        controller = nil
+        lock.unlock()
+        AudioMixingEngine.shared.setMaskingAdjustment(gainDb: 0, equalizerOffsets: [])
+    }
+
+    // MARK: - Listening
+
+    /// Runs on the tap's thread. Between analysis windows this returns at
+    /// once.
+    func process(_ buffer: AVAudioPCMBuffer, at time: AVAudioTime) {
+        guard let samples = buffer.floatChannelData?[0], buffer.frameLength > 0, time.isHostTimeValid else {
+            return
+        }
+        let position = Int64(AVAudioTime.seconds(forHostTime: time.hostTime) * buffer.format.sampleRate)
+
+        var decision = SLPMaskingDecision()
+        lock.lock()
+        guard let controller = controller, let reference = reference else {
+            lock.unlock()
+            return
+        }
+        SLPMaskingControllerProcess(controller, reference, samples, Int(buffer.frameLength), position)
+        let changed = SLPMaskingControllerTakeDecision(controller, &decision)
+        lock.unlock()
+        guard changed else { return }
+
+        let offsets = withUnsafeBytes(of: decision.eqDb) { Array($0.bindMemory(to: Float.self)) }
+        Task { @MainActor [weak self] in
+            // A decision that lost the race with stop() is dropped.
+            guard self?.isRunning == true else { return }
+            AudioMixingEngine.shared.setMaskingAdjustment(gainDb: decision.gainDb, equalizerOffsets: offsets)
+        }
+    }
+}
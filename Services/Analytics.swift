@@ -0,0 +1,161 @@
+//
+//  Analytics.swift
+//  SleepMate
+//
+//  Front for analytics events, in place of calling an SDK such as Flurry
+//  synchronously from views and audio code. Logging only copies a small
+//  record into SleepsterCore's lock-free ring; a background flusher appends
+//  batches to analytics.jsonl in Application Support, from which a backend
+//  can be fed. Names are interned once, as static members of
+//  `Analytics.Name`, and parameters are passed without building a
+//  dictionary.
+//
+
+import Foundation
+
+final class Analytics {
+    static let shared = Analytics()
+
+    /// Nil when the log file cannot be opened; events are then discarded.
+    private let pipeline: OpaquePointer?
+
+    private static let capacity = 4096
+    private static let flushInterval: TimeInterval = 10
+
+    private init() {
+        pipeline = Self.logURL().flatMap {
+            SLPAnalyticsCreate($0.path, Self.capacity, Self.flushInterval)
+        }
+    }
+
+    /// Follows the user's consent; SettingsManager keeps it in step.
+    var isEnabled = true {
+        didSet {
+            guard let pipeline = pipeline else { return }
+            SLPAnalyticsSetEnabled(pipeline, isEnabled)
+        }
+    }
+
+    // MARK: - Logging
+    //
+    // Any thread. Up to three parameters; they are copied, never retained.
+
+    func log(_ event: Name, _ a: Parameter? = nil, _ b: Parameter? = nil, _ c: Parameter? = nil) {
+        send(event, a, b, c, SLPAnalyticsLogEvent)
+    }
+
+    func beginTimed(_ event: Name, _ a: Parameter? = nil, _ b: Parameter? = nil, _ c: Parameter? = nil) {
+        send(event, a, b, c, SLPAnalyticsBeginTimedEvent)
+    }
+
+    /// Parameters given here replace those the event started with.
+    func endTimed(_ event: Name, _ a: Parameter? = nil, _ b: Parameter? = nil, _ c: Parameter? = nil) {
+        send(event, a, b, c, SLPAnalyticsEndTimedEvent)
+    }
+
+    func logError(_ error: Name, message: Name? = nil) {
+        guard let pipeline = pipeline else { return }
+        SLPAnalyticsLogError(pipeline, error.id, message?.id ?? SLPAnalyticsNoName)
+    }
+
+    /// Writes what is queued now; blocks on file I/O, so call it off the
+    /// main thread.
+    func flush() {
+        guard let pipeline = pipeline else { return }
+        SLPAnalyticsFlush(pipeline)
+    }
+
+    // MARK: - Private Methods
+
+    fileprivate func intern(_ name: String) -> SLPAnalyticsName {
+        guard let pipeline = pipeline else { return SLPAnalyticsNoName }
+        return SLPAnalyticsIntern(pipeline, name)
+    }
+
+    private typealias Logger = (
+        OpaquePointer, SLPAnalyticsName, UnsafePointer<SLPAnalyticsParameter>?, Int
+    ) -> Bool
+
+    private func send(_ event: Name, _ a: Parameter?, _ b: Parameter?, _ c: Parameter?, _ logger: Logger) {
+        guard let pipeline = pipeline else { return }
+        let none = SLPAnalyticsParameter()
+        var parameters = (a?.raw ?? none, b?.raw ?? none, c?.raw ?? none)
+        let count = a == nil ? 0 : b == nil ? 1 : c == nil ? 2 : 3
+        withUnsafePointer(to: &parameters) { tuple in
+            tuple.withMemoryRebound(to: SLPAnalyticsParameter.self, capacity: 3) { base in
+                _ = logger(pipeline, event.id, base, count)
+            }
+        }
+    }
+
+    private static func logURL() -> URL? {
+        guard let directory = try? FileManager.default.url(
+            for: .applicationSupportDirectory,
+            in: .userDomainMask,
+            appropriateFor: nil,
+            create: true
+        ) else { return nil }
+        return directory.appendingPathComponent("analytics.jsonl")
+    }
+}
+
+// MARK: - Supporting Types
+
+extension Analytics {
+    /// An interned event, parameter or value name. Interning takes a lock,
+    /// so names live in static constants and are interned on first use.
+    struct Name {
+        fileprivate let id: SLPAnalyticsName
+
+        init(_ name: String) {
+            id = Analytics.shared.intern(name)
+        }
+    }
+
+    struct Parameter {
+        fileprivate let raw: SLPAnalyticsParameter
+
+        static func integer(_ key: Name, _ value: Int) -> Parameter {
+            var raw = SLPAnalyticsParameter()
+            raw.key = key.id
+            raw.type = SLPAnalyticsValueInteger
+            raw.integer = Int64(value)
+            return Parameter(raw: raw)
+        }
+
+        static func number(_ key: Name, _ value: Double) -> Parameter {
+            var raw = SLPAnalyticsParameter()
+            raw.key = key.id
+            raw.type = SLPAnalyticsValueNumber
+            raw.number = value
+            return Parameter(raw: raw)
+        }
+
+        static func name(_ key: Name, _ value: Name) -> Parameter {
+            var raw = SLPAnalyticsParameter()
+            raw.key = key.id
+            raw.type = SLPAnalyticsValueName
+            raw.name = value.id
+            return Parameter(raw: raw)
+        }
+    }
+}
+
+extension Analytics.Name {
+    // Events
+    static let soundPlayed = Analytics.Name("sound_played")
+    static let sleepTracking = Analytics.Name("sleep_tracking")
+
+    // Parameters
+    static let voices = Analytics.Name("voices")
+    static let volume = Analytics.Name("volume")
+    static let soundEvents = Analytics.Name("sound_events")
+
+    // Errors, by AppError.ErrorType
+    static let networkError = Analytics.Name("network_error")
+    static let dataCorruptionError = Analytics.Name("data_corruption_error")
+    static let userActionError = Analytics.Name("user_action_error")
+    static let validationError = Analytics.Name("validation_error")
+    static let criticalError = Analytics.Name("critical_error")
+    static let unknownError = Analytics.Name("unknown_error")
+}
@@ -246,26 +246,58 @@ struct AnimationSettings: Equatable {
 }
 
 // MARK: - Performance Monitor
-class AnimationPerformanceMonitor: ObservableObject {
-    @Published var currentFPS: Double = 60.0
-    @Published var batteryOptimizationEnabled: Bool = false
-    
+/// Chooses the frame rate (60, 30, 20 or 15 fps) and quality tier the
+/// backgrounds run at. Frame times go into SleepsterCore's pacer, which
+/// decides from percentiles of a rolling window with hysteresis, so a single
+/// slow frame no longer flips battery optimization on and off.
+final class AnimationPerformanceMonitor: ObservableObject {
+    static let shared = AnimationPerformanceMonitor()
+
+    @Published private(set) var targetFPS: Double = 60.0
+    @Published private(set) var qualityTier: SLPQualityTier = SLPQualityTierFull
+    @Published private(set) var batteryOptimizationEnabled: Bool = false
+
+    private let pacer = SLPFramePacerCreate()
     private var lastFrameTime: CFTimeInterval = 0
-    
+
+    deinit {
+        SLPFramePacerDestroy(pacer)
+    }
+
+    /// Frame rate at the median frame time of the current window
+    var currentFPS: Double {
+        let median = metrics.p50
+        return median > 0 ? 1.0 / median : targetFPS
+    }
+
+    /// Frame-time percentiles (seconds) and frame, late-frame and
+    /// level-change counts
+    var metrics: SLPFramePacerMetrics {
+        SLPFramePacerGetMetrics(pacer)
+    }
+
+    /// Records a frame ending now, for callers without a frame clock
     func updateFrameRate() {
         let currentTime = CACurrentMediaTime()
         if lastFrameTime > 0 {
-            let deltaTime = currentTime - lastFrameTime
-            currentFPS = 1.0 / deltaTime
+            recordFrame(currentTime - lastFrameTime)
         }
         lastFrameTime = currentTime
-        
-        // Enable battery optimization if FPS drops below threshold
-        batteryOptimizationEnabled = currentFPS < 30.0
     }
-    
-    var targetFPS: Double {
-        return batteryOptimizationEnabled ? 30.0 : 60.0
+
+    /// Records the interval since the previous frame
+    func recordFrame(_ seconds: TimeInterval) {
+        guard SLPFramePacerRecordFrame(pacer, seconds) else { return }
+        targetFPS = SLPFramePacerGetTargetFramesPerSecond(pacer)
+        qualityTier = SLPFramePacerGetTier(pacer)
+        batteryOptimizationEnabled = targetFPS < 60.0
+
+        #if DEBUG
+        let metrics = self.metrics
+        print("🎞️ Frame pacing: \(Int(targetFPS)) fps, tier \(qualityTier.rawValue) " +
+              "(p50 \(Int(metrics.p50 * 1000)) ms, p90 \(Int(metrics.p90 * 1000)) ms, " +
+              "change \(metrics.levelChanges))")
+        #endif
     }
 }
 
@@ -290,12 +322,35 @@ struct EnhancedCountingSheepView: View {
     let dimmed: Bool
     
     @State private var sheepPositions: [SheepData] = []
-    @State private var animationTimer: Timer?
-    @State private var floatingTimer: Timer?
+    @State private var animationTimer: TimerScheduler.Token?
     @State private var cloudPositions: [CloudData] = []
     @State private var windOffset: CGFloat = 0
-    @State private var twinklePhase: Double = 0
     @State private var grassSway: Double = 0
+    @StateObject private var particles: ParticleField
+    @State private var stars: ParticleField.System?
+    @State private var backdrop: Backdrop?
+    
+    init(intensity: Float, speed: Float, colorTheme: ColorTheme, dimmed: Bool) {
+        self.intensity = intensity
+        self.speed = speed
+        self.colorTheme = colorTheme
+        self.dimmed = dimmed
+        // The same stars every time this theme and intensity are shown
+        _particles = StateObject(wrappedValue: ParticleField(
+            seed: StaticLayers.seed("countingSheep", colorTheme.rawValue, "\(intensity)")
+        ))
+    }
+    
+    private var palette: ThemePalette {
+        ThemePalette.palette(for: colorTheme, dimmed: dimmed, intensity: intensity)
+    }
+    
+    /// Hills, grass and star sprites, rasterized once
+    private struct Backdrop {
+        let hills: StaticLayerImage?
+        let grass: StaticLayerImage?
+        let stars: StarSprites?
+    }
     
     private struct SheepData: Identifiable {
         let id = UUID()
@@ -341,11 +396,7 @@ struct EnhancedCountingSheepView: View {
                 ZStack {
                     // Deep sky
                     RadialGradient(
-                        colors: [
-                            dimmed ? .black.opacity(0.95) : .black.opacity(0.85),
-                            dimmed ? .indigo.opacity(0.4) : .indigo.opacity(0.6),
-                            dimmed ? .purple.opacity(0.2) : .purple.opacity(0.4)
-                        ],
+                        gradient: palette.gradient(SLPPaletteGradientMeadowSky),
                         center: .top,
                         startRadius: 0,
                         endRadius: geometry.size.height
@@ -353,11 +404,7 @@ struct EnhancedCountingSheepView: View {
                     
                     // Horizon glow
                     LinearGradient(
-                        colors: [
-                            .clear,
-                            dimmed ? .orange.opacity(0.05) : .orange.opacity(0.15),
-                            dimmed ? .yellow.opacity(0.02) : .yellow.opacity(0.08)
-                        ],
+                        gradient: palette.gradient(SLPPaletteGradientHorizonGlow),
                         startPoint: .top,
                         endPoint: .bottom
                     )
@@ -368,10 +415,7 @@ struct EnhancedCountingSheepView: View {
                     EnhancedCloudShape()
                         .fill(
                             LinearGradient(
-                                colors: [
-                                    Color.white.opacity(cloud.opacity * (dimmed ? 0.2 : 0.4)),
-                                    Color.gray.opacity(cloud.opacity * (dimmed ? 0.1 : 0.2))
-                                ],
+                                gradient: palette.gradient(SLPPaletteGradientCloud, level: cloud.opacity),
                                 startPoint: .topLeading,
                                 endPoint: .bottomTrailing
                             )
@@ -381,91 +425,37 @@ struct EnhancedCountingSheepView: View {
                         .blur(radius: (1.0 - cloud.scale) * 2)
                 }
                 
-                // Twinkling stars with varying sizes and intensity
-                ForEach(0..<Int(intensity * 50) + 20, id: \.self) { index in
-                    let starScale = CGFloat.random(in: 0.5...2.0)
-                    let twinkleSpeed = Double.random(in: 0.5...2.0)
-                    let starOpacity = sin(twinklePhase * twinkleSpeed + Double(index)) * 0.5 + 0.5
-                    
-                    StarShape()
-                        .fill(
-                            RadialGradient(
-                                colors: [
-                                    Color.white.opacity(starOpacity * (dimmed ? 0.3 : 0.8)),
-                                    Color.blue.opacity(starOpacity * (dimmed ? 0.1 : 0.3)),
-                                    .clear
-                                ],
-                                center: .center,
-                                startRadius: 0,
-                                endRadius: 3
-                            )
-                        )
-                        .frame(width: starScale * 3, height: starScale * 3)
-                        .position(
-                            x: CGFloat.random(in: 0...geometry.size.width),
-                            y: CGFloat.random(in: 0...(geometry.size.height * 0.6))
-                        )
-                        .scaleEffect(0.8 + starOpacity * 0.4)
+                // Twinkling stars: cached sprites, only their alpha changes
+                if let stars = stars, let sprites = backdrop?.stars {
+                    ForEach(0..<particles.count(of: stars), id: \.self) { index in
+                        let star = particles.particle(index, of: stars)
+                        Image(decorative: sprites.image(forSize: star.size), scale: sprites.scale)
+                            .opacity(star.alpha)
+                            .scaleEffect(0.8 + star.alpha * 0.4)
+                            .position(x: star.x, y: star.y)
+                    }
                 }
                 
                 // Rolling hills with atmospheric perspective
-                ForEach(0..<3, id: \.self) { layer in
-                    let layerDepth = CGFloat(layer + 1)
-                    EnhancedHillShape()
-                        .fill(
-                            LinearGradient(
-                                colors: [
-                                    Color.green.opacity((dimmed ? 0.2 : 0.4) / Double(layerDepth)),
-                                    Color.black.opacity((dimmed ? 0.6 : 0.4) * Double(layerDepth) / 3.0)
-                                ],
-                                startPoint: .top,
-                                endPoint: .bottom
-                            )
-                        )
-                        .offset(y: (geometry.size.height * 0.6) + CGFloat(layer * 20))
-                        .blur(radius: layerDepth - 1)
-                }
+                backdrop?.hills?.view
                 
-                // Enhanced grass with wind animation
-                ForEach(0..<Int(geometry.size.width / 15), id: \.self) { index in
-                    let grassHeight = CGFloat.random(in: 30...60)
-                    let swayOffset = sin(grassSway + Double(index) * 0.5) * 5
-                    
-                    EnhancedGrassShape()
-                        .fill(
-                            LinearGradient(
-                                colors: [
-                                    Color.green.opacity(dimmed ? 0.4 : 0.7),
-                                    Color.black.opacity(dimmed ? 0.7 : 0.5)
-                                ],
-                                startPoint: .top,
-                                endPoint: .bottom
-                            )
-                        )
-                        .frame(
-                            width: CGFloat.random(in: 2...4),
-                            height: grassHeight
-                        )
-                        .position(
-                            x: CGFloat(index * 15) + CGFloat.random(in: -3...3) + CGFloat(swayOffset),
-                            y: geometry.size.height - grassHeight/2 + CGFloat.random(in: -5...5)
-                        )
-                        .shadow(color: .black.opacity(0.3), radius: 1, x: 1, y: 1)
-                }
+                // Grass swaying in the wind
+                backdrop?.grass?.view
+                    .modifier(SwayEffect(phase: grassSway, amplitude: 5))
                 
                 // Enhanced sheep with depth and shadows
                 ForEach(sheepPositions) { sheep in
                     ZStack {
                         // Shadow
                         Ellipse()
-                            .fill(Color.black.opacity(sheep.shadowOpacity * (dimmed ? 0.2 : 0.4)))
+                            .fill(palette.color(SLPPaletteGradientSheepShadow, at: sheep.shadowOpacity))
                             .frame(width: 55 * sheep.scale, height: 12 * sheep.scale)
                             .position(x: sheep.x + 2, y: sheep.y + 20)
                             .blur(radius: 2)
                         
                         // Cartoon sheep using the enhanced shape approach
                         EnhancedSheepShape()
-                            .fill(getSheepColor(colorTheme: colorTheme, dimmed: dimmed, primary: true))
+                            .fill(palette.color(SLPSwatchSheepBody))
                             .frame(width: 50 * sheep.scale, height: 35 * sheep.scale)
                             .rotationEffect(.radians(sheep.currentRotation))
                             .position(x: sheep.x, y: sheep.y - sheep.jumpHeight)
@@ -482,11 +472,94 @@ struct EnhancedCountingSheepView: View {
         .onDisappear {
             stopAnimations()
         }
+        .onChange(of: dimmed) { _ in
+            setupBackdrop()
+        }
     }
     
     private func setupScene() {
         setupSheep()
         setupClouds()
+        setupStars()
+        setupBackdrop()
+    }
+    
+    private func setupStars() {
+        guard stars == nil else { return }
+        let bounds = UIScreen.main.bounds
+        
+        // Fixed positions; each twinkles fully off and on at its own rate
+        var config = SLPParticleConfig()
+        config.motion = SLPParticleMotionStatic
+        config.count = UInt32(Int(intensity * 50) + 20)
+        config.bounds = SLPParticleBounds(bounds, dx: 0, dy: 0)
+        config.x = SLPParticleRange(0...Float(bounds.width))
+        config.y = SLPParticleRange(0...Float(bounds.height) * 0.6)
+        config.size = SLPParticleRange(1.5...6)
+        config.alpha = SLPParticleRange(1...1)
+        config.twinkleRate = SLPParticleRange(Float.pi / 4 * speed...Float.pi * speed)
+        config.twinkleDepth = 1
+        stars = particles.add(config)
+    }
+    
+    /// Rasterizes the hills, grass and star sprites off the main thread, or
+    /// picks them up from the cache
+    private func setupBackdrop() {
+        // UIScreen is read here, on the main actor, never in the task
+        let bounds = UIScreen.main.bounds
+        let scale = UIScreen.main.scale
+        let key = StaticLayers.key("countingSheep", colorTheme.rawValue, intensity, dimmed)
+        let dimmed = self.dimmed
+        
+        Task.detached(priority: .userInitiated) {
+            let hills = (0..<3).map { layer -> SLPHillConfig in
+                let depth = Double(layer + 1)
+                return SLPHillConfig(
+                    top: Float(bounds.height * 0.6) + Float(layer * 20),
+                    height: Float(bounds.height),
+                    fill: SLPGradient([
+                        SLPColor(.green, opacity: (dimmed ? 0.2 : 0.4) / depth),
+                        SLPColor(.black, opacity: (dimmed ? 0.6 : 0.4) * depth / 3.0)
+                    ]),
+                    blur: Float(depth - 1)
+                )
+            }
+            
+            var grass = SLPGrassConfig()
+            grass.spacing = 15
+            grass.jitterX = 3
+            grass.jitterY = 5
+            grass.baseline = Float(bounds.height)
+            grass.bladeHeight = SLPParticleRange(30...60)
+            grass.bladeWidth = SLPParticleRange(2...4)
+            grass.fill = SLPGradient([
+                SLPColor(.green, opacity: dimmed ? 0.4 : 0.7),
+                SLPColor(.black, opacity: dimmed ? 0.7 : 0.5)
+            ])
+            grass.shadow = SLPColor(.black, opacity: 0.3)
+            grass.shadowRadius = 1
+            grass.shadowX = 1
+            grass.shadowY = 1
+            
+            var sprites = SLPStarSpriteConfig()
+            sprites.size = SLPParticleRange(1.5...6)
+            sprites.count = 8
+            sprites.fill = SLPGradient([
+                SLPColor(.white, opacity: dimmed ? 0.3 : 0.8),
+                SLPColor(.blue, opacity: dimmed ? 0.1 : 0.3),
+                .clear
+            ])
+            sprites.fillRadius = 3
+            
+            let built = Backdrop(
+                hills: StaticLayers.hills(key: key + "|hills", width: bounds.width,
+                                          top: bounds.height * 0.6, bottom: bounds.height, scale: scale,
+                                          hills: hills),
+                grass: StaticLayers.grass(key: key + "|grass", grass, width: bounds.width, scale: scale),
+                stars: StaticLayers.starSprites(key: key + "|stars", sprites, scale: scale)
+            )
+            await MainActor.run { backdrop = built }
+        }
     }
     
     private func setupSheep() {
@@ -547,13 +620,14 @@ struct EnhancedCountingSheepView: View {
     
     private func startAnimations() {
         // Sheep jumping animation
-        animationTimer = Timer.scheduledTimer(withTimeInterval: 3.0 / Double(speed), repeats: true) { _ in
+        let jumpInterval = 3.0 / Double(speed)
+        animationTimer = TimerScheduler.shared.schedule(after: jumpInterval, repeating: jumpInterval, tolerance: jumpInterval * 0.1) {
             animateSheep()
         }
         
-        // Floating sheep animation - smoother updates
-        floatingTimer = Timer.scheduledTimer(withTimeInterval: 0.033, repeats: true) { _ in
-            animateFloatingSheep()
+        // Floating sheep move with the particles, at the paced frame rate
+        particles.start { elapsed in
+            animateFloatingSheep(ticks: elapsed / 0.033)
         }
         
         // Continuous environmental animations
@@ -561,20 +635,15 @@ struct EnhancedCountingSheepView: View {
             windOffset = 100
         }
         
-        withAnimation(.linear(duration: 4.0 / Double(speed)).repeatForever(autoreverses: false)) {
-            twinklePhase = 2 * .pi
-        }
-        
         withAnimation(.easeInOut(duration: 6.0 / Double(speed)).repeatForever(autoreverses: true)) {
             grassSway = Double.pi
         }
     }
     
     private func stopAnimations() {
-        animationTimer?.invalidate()
+        TimerScheduler.shared.cancel(animationTimer)
         animationTimer = nil
-        floatingTimer?.invalidate()
-        floatingTimer = nil
+        particles.stop()
     }
     
     private func animateSheep() {
@@ -610,18 +679,19 @@ struct EnhancedCountingSheepView: View {
         }
     }
     
-    private func animateFloatingSheep() {
+    /// `ticks` is the frame's length in the 33 ms steps the motion was
+    /// tuned for
+    private func animateFloatingSheep(ticks: Double) {
         let bounds = UIScreen.main.bounds
-        let _ = CACurrentMediaTime()
         
         for i in 0..<sheepPositions.count {
             if sheepPositions[i].isFloating {
                 let sheep = sheepPositions[i]
                 
                 // Update phase values for natural variation
-                sheepPositions[i].verticalPhase += 0.015 * sheep.verticalFrequency * Double(speed)
-                sheepPositions[i].horizontalPhase += 0.01 * sheep.horizontalFrequency * Double(speed)
-                sheepPositions[i].rotationPhase += 0.008 * sheep.rotationFrequency * Double(speed)
+                sheepPositions[i].verticalPhase += 0.015 * sheep.verticalFrequency * Double(speed) * ticks
+                sheepPositions[i].horizontalPhase += 0.01 * sheep.horizontalFrequency * Double(speed) * ticks
+                sheepPositions[i].rotationPhase += 0.008 * sheep.rotationFrequency * Double(speed) * ticks
                 
                 // Organic floating motion using multiple sine waves
                 let verticalFloat = sin(sheepPositions[i].verticalPhase) * sheep.floatAmplitude * 0.4
@@ -632,7 +702,7 @@ struct EnhancedCountingSheepView: View {
                 let orbitalY = sin(sheepPositions[i].verticalPhase * 0.5) * sheep.floatRadius * 0.2
                 
                 // Gentle main drift movement
-                sheepPositions[i].baseX += sheep.driftSpeed * CGFloat(speed) * 0.03
+                sheepPositions[i].baseX += sheep.driftSpeed * CGFloat(speed) * 0.03 * CGFloat(ticks)
                 
                 // Combine all movements for natural, dreamlike floating
                 sheepPositions[i].x = sheep.baseX + horizontalFloat + orbitalX
@@ -670,215 +740,14 @@ struct EnhancedCountingSheepView: View {
     }
 }
 
-// MARK: - Helper Functions
-
-private func getSheepColor(colorTheme: ColorTheme, dimmed: Bool, primary: Bool) -> Color {
-    let baseOpacity = primary ? (dimmed ? 0.7 : 0.95) : (dimmed ? 0.3 : 0.5)
-    
-    switch colorTheme {
-    case .defaultTheme:
-        return primary ? Color.white.opacity(baseOpacity) : Color.gray.opacity(baseOpacity)
-    case .warm:
-        return primary ? Color.init(red: 1.0, green: 0.95, blue: 0.9).opacity(baseOpacity) : 
-                        Color.init(red: 0.8, green: 0.6, blue: 0.4).opacity(baseOpacity)
-    case .cool:
-        return primary ? Color.init(red: 0.9, green: 0.95, blue: 1.0).opacity(baseOpacity) : 
-                        Color.init(red: 0.6, green: 0.7, blue: 0.8).opacity(baseOpacity)
-    case .monochrome:
-        return primary ? Color.white.opacity(baseOpacity * 0.8) : Color.gray.opacity(baseOpacity)
-    }
-}
-
 // MARK: - Enhanced Shape Definitions
 
+/// Cartoon sheep: a scalloped body, face, droopy ears, eyes, nose and four
+/// legs with hooves, in units of a 60th of the smaller side. The outline is
+/// built once by SleepsterCore (`ShapeGeometry`).
 struct EnhancedSheepShape: Shape {
     func path(in rect: CGRect) -> Path {
-        var path = Path()
-        
-        // Scale factor based on rect size for consistent proportions
-        let scale = min(rect.width, rect.height) / 60
-        let centerX = rect.midX
-        let centerY = rect.midY
-        
-        // Create cartoon sheep matching reference image exactly
-        createFluffyBody(path: &path, centerX: centerX, centerY: centerY, scale: scale)
-        createSheepFace(path: &path, centerX: centerX, centerY: centerY, scale: scale)
-        createDroppyEars(path: &path, centerX: centerX, centerY: centerY, scale: scale)
-        createSheepEyes(path: &path, centerX: centerX, centerY: centerY, scale: scale)
-        createSheepNose(path: &path, centerX: centerX, centerY: centerY, scale: scale)
-        createSheepLegs(path: &path, centerX: centerX, centerY: centerY, scale: scale)
-        
-        return path
-    }
-    
-    private func createFluffyBody(path: inout Path, centerX: CGFloat, centerY: CGFloat, scale: CGFloat) {
-        // Main fluffy cloud body with perfect scalloped edges like reference
-        let bodyCenter = CGPoint(x: centerX - 2*scale, y: centerY + 2*scale)
-        let bodyWidth = 30*scale
-        let bodyHeight = 16*scale
-        
-        // Main body oval
-        path.addEllipse(in: CGRect(
-            x: bodyCenter.x - bodyWidth/2,
-            y: bodyCenter.y - bodyHeight/2,
-            width: bodyWidth,
-            height: bodyHeight
-        ))
-        
-        // Perfect scalloped edges like the reference image
-        let scallops = [
-            // Top row of scallops
-            CGRect(x: bodyCenter.x - 12*scale, y: bodyCenter.y - bodyHeight/2 - 2*scale, width: 5*scale, height: 5*scale),
-            CGRect(x: bodyCenter.x - 5*scale, y: bodyCenter.y - bodyHeight/2 - 2.5*scale, width: 4.5*scale, height: 4.5*scale),
-            CGRect(x: bodyCenter.x + 2*scale, y: bodyCenter.y - bodyHeight/2 - 2*scale, width: 4*scale, height: 4*scale),
-            CGRect(x: bodyCenter.x + 8*scale, y: bodyCenter.y - bodyHeight/2 - 1.5*scale, width: 3.5*scale, height: 3.5*scale),
-            
-            // Left side scallops
-            CGRect(x: bodyCenter.x - bodyWidth/2 - 2*scale, y: bodyCenter.y - 5*scale, width: 4*scale, height: 4*scale),
-            CGRect(x: bodyCenter.x - bodyWidth/2 - 1.5*scale, y: bodyCenter.y, width: 3.5*scale, height: 4*scale),
-            CGRect(x: bodyCenter.x - bodyWidth/2 - 2*scale, y: bodyCenter.y + 4*scale, width: 4*scale, height: 3.5*scale),
-            
-            // Right side scallops
-            CGRect(x: bodyCenter.x + bodyWidth/2 - 2*scale, y: bodyCenter.y - 3*scale, width: 3.5*scale, height: 4*scale),
-            CGRect(x: bodyCenter.x + bodyWidth/2 - 1.5*scale, y: bodyCenter.y + 2*scale, width: 4*scale, height: 3.5*scale),
-            
-            // Bottom scallops
-            CGRect(x: bodyCenter.x - 6*scale, y: bodyCenter.y + bodyHeight/2 - 1.5*scale, width: 4*scale, height: 3*scale),
-            CGRect(x: bodyCenter.x + 1*scale, y: bodyCenter.y + bodyHeight/2 - 2*scale, width: 3.5*scale, height: 3.5*scale),
-            CGRect(x: bodyCenter.x + 7*scale, y: bodyCenter.y + bodyHeight/2 - 1*scale, width: 3*scale, height: 3*scale)
-        ]
-        
-        for scallop in scallops {
-            path.addEllipse(in: scallop)
-        }
-    }
-    
-    private func createSheepFace(path: inout Path, centerX: CGFloat, centerY: CGFloat, scale: CGFloat) {
-        // White oval face positioned exactly like reference image
-        let faceCenter = CGPoint(x: centerX + 12*scale, y: centerY - 2*scale)
-        let faceWidth = 10*scale
-        let faceHeight = 12*scale
-        
-        path.addEllipse(in: CGRect(
-            x: faceCenter.x - faceWidth/2,
-            y: faceCenter.y - faceHeight/2,
-            width: faceWidth,
-            height: faceHeight
-        ))
-    }
-    
-    private func createDroppyEars(path: inout Path, centerX: CGFloat, centerY: CGFloat, scale: CGFloat) {
-        // Black droopy ears exactly like reference
-        let faceCenter = CGPoint(x: centerX + 12*scale, y: centerY - 2*scale)
-        let earWidth = 2.5*scale
-        let earHeight = 5*scale
-        
-        // Left ear
-        let leftEarCenter = CGPoint(x: faceCenter.x - 3*scale, y: faceCenter.y - 4*scale)
-        createDroppyEarShape(path: &path, center: leftEarCenter, width: earWidth, height: earHeight)
-        
-        // Right ear  
-        let rightEarCenter = CGPoint(x: faceCenter.x + 3*scale, y: faceCenter.y - 4*scale)
-        createDroppyEarShape(path: &path, center: rightEarCenter, width: earWidth, height: earHeight)
-    }
-    
-    private func createDroppyEarShape(path: inout Path, center: CGPoint, width: CGFloat, height: CGFloat) {
-        // Create perfect droopy ear shape wider at bottom like reference
-        path.move(to: CGPoint(x: center.x, y: center.y - height/2))
-        
-        // Smooth curves for droopy shape
-        path.addQuadCurve(
-            to: CGPoint(x: center.x + width/2, y: center.y - height/4),
-            control: CGPoint(x: center.x + width/2, y: center.y - height/2)
-        )
-        
-        path.addQuadCurve(
-            to: CGPoint(x: center.x + width/3, y: center.y + height/2),
-            control: CGPoint(x: center.x + width/2, y: center.y + height/4)
-        )
-        
-        path.addQuadCurve(
-            to: CGPoint(x: center.x - width/3, y: center.y + height/2),
-            control: CGPoint(x: center.x, y: center.y + height/2)
-        )
-        
-        path.addQuadCurve(
-            to: CGPoint(x: center.x - width/2, y: center.y - height/4),
-            control: CGPoint(x: center.x - width/2, y: center.y + height/4)
-        )
-        
-        path.addQuadCurve(
-            to: CGPoint(x: center.x, y: center.y - height/2),
-            control: CGPoint(x: center.x - width/2, y: center.y - height/2)
-        )
-    }
-    
-    private func createSheepEyes(path: inout Path, centerX: CGFloat, centerY: CGFloat, scale: CGFloat) {
-        // Simple black oval eyes like reference
-        let faceCenter = CGPoint(x: centerX + 12*scale, y: centerY - 2*scale)
-        let eyeWidth = 1.5*scale
-        let eyeHeight = 1.2*scale
-        
-        // Left eye
-        path.addEllipse(in: CGRect(
-            x: faceCenter.x - 2.5*scale - eyeWidth/2,
-            y: faceCenter.y - 1*scale - eyeHeight/2,
-            width: eyeWidth,
-            height: eyeHeight
-        ))
-        
-        // Right eye
-        path.addEllipse(in: CGRect(
-            x: faceCenter.x + 1.5*scale - eyeWidth/2,
-            y: faceCenter.y - 1*scale - eyeHeight/2,
-            width: eyeWidth,
-            height: eyeHeight
-        ))
-    }
-    
-    private func createSheepNose(path: inout Path, centerX: CGFloat, centerY: CGFloat, scale: CGFloat) {
-        // Small black nose
-        let faceCenter = CGPoint(x: centerX + 12*scale, y: centerY - 2*scale)
-        let noseSize = 0.8*scale
-        
-        path.addEllipse(in: CGRect(
-            x: faceCenter.x - noseSize/2,
-            y: faceCenter.y + 1.5*scale - noseSize/2,
-            width: noseSize,
-            height: noseSize * 0.7
-        ))
-    }
-    
-    private func createSheepLegs(path: inout Path, centerX: CGFloat, centerY: CGFloat, scale: CGFloat) {
-        // Four black legs with hooves exactly like reference
-        let bodyCenter = CGPoint(x: centerX - 2*scale, y: centerY + 2*scale)
-        let legWidth = 2*scale
-        let legHeight = 8*scale
-        let hoofWidth = 2.5*scale
-        let hoofHeight = 1.5*scale
-        
-        // Leg positions evenly spaced under body
-        let legPositions: [CGFloat] = [-8*scale, -3*scale, 3*scale, 8*scale]
-        
-        for legX in legPositions {
-            let legBottom = bodyCenter.y + 8*scale + legHeight
-            
-            // Leg (rectangle)
-            path.addRect(CGRect(
-                x: bodyCenter.x + legX - legWidth/2,
-                y: bodyCenter.y + 8*scale,
-                width: legWidth,
-                height: legHeight
-            ))
-            
-            // Hoof (oval at bottom)
-            path.addEllipse(in: CGRect(
-                x: bodyCenter.x + legX - hoofWidth/2,
-                y: legBottom - hoofHeight/2,
-                width: hoofWidth,
-                height: hoofHeight
-            ))
-        }
+        ShapeGeometry.path(SLPShapeSheep, in: rect)
     }
 }
 
@@ -1290,22 +1159,19 @@ struct EnhancedGentleWavesView: View {
     
     @State private var waveOffset: CGFloat = 0
     @State private var deepWaveOffset: CGFloat = 0
-    @State private var bubblePositions: [BubbleData] = []
+    @StateObject private var particles = ParticleField()
+    @State private var bubbles: ParticleField.System?
     @State private var shimmerOffset: CGFloat = 0
     @State private var surfaceGlitter: [GlitterData] = []
     @State private var seaweed: [SeaweedData] = []
     @State private var fish: [FishData] = []
     @State private var jellyfish: [JellyfishData] = []
-    @State private var plankton: [PlanktonData] = []
+    @State private var plankton: ParticleField.System?
     
-    private struct BubbleData: Identifiable {
-        let id = UUID()
-        var x: CGFloat
-        var y: CGFloat
-        let size: CGFloat
-        let riseSpeed: CGFloat
-        var opacity: Double
-        let wobblePhase: Double
+    private let planktonColors: [Color] = [.green, .cyan, .blue, .white, .yellow]
+    
+    private var palette: ThemePalette {
+        ThemePalette.palette(for: colorTheme, dimmed: dimmed, intensity: intensity)
     }
     
     private struct GlitterData: Identifiable {
@@ -1348,16 +1214,6 @@ struct EnhancedGentleWavesView: View {
         let tentacleCount: Int
     }
     
-    private struct PlanktonData: Identifiable {
-        let id = UUID()
-        var x: CGFloat
-        var y: CGFloat
-        let size: CGFloat
-        var glowPhase: Double
-        let color: Color
-        var driftVelocity: CGVector
-    }
-    
     var body: some View {
         GeometryReader { geometry in
             ZStack {
@@ -1365,12 +1221,7 @@ struct EnhancedGentleWavesView: View {
                 ZStack {
                     // Deep water gradient
                     RadialGradient(
-                        colors: [
-                            dimmed ? .black.opacity(0.9) : .indigo.opacity(0.8),
-                            dimmed ? .blue.opacity(0.3) : .blue.opacity(0.6),
-                            dimmed ? .teal.opacity(0.2) : .teal.opacity(0.5),
-                            dimmed ? .cyan.opacity(0.1) : .cyan.opacity(0.3)
-                        ],
+                        gradient: palette.gradient(SLPPaletteGradientOceanDepth),
                         center: .center,
                         startRadius: 0,
                         endRadius: geometry.size.height
@@ -1381,10 +1232,7 @@ struct EnhancedGentleWavesView: View {
                         CausticsShape(phase: shimmerOffset + CGFloat(index * 30))
                             .fill(
                                 LinearGradient(
-                                    colors: [
-                                        Color.cyan.opacity((dimmed ? 0.02 : 0.08) * Double(intensity)),
-                                        Color.white.opacity((dimmed ? 0.01 : 0.04) * Double(intensity))
-                                    ],
+                                    gradient: palette.gradient(SLPPaletteGradientCaustics),
                                     startPoint: .topLeading,
                                     endPoint: .bottomTrailing
                                 )
@@ -1403,26 +1251,22 @@ struct EnhancedGentleWavesView: View {
                 }
                 
                 // Rising bubbles with physics
-                ForEach(bubblePositions) { bubble in
-                    Circle()
-                        .fill(
-                            RadialGradient(
-                                colors: [
-                                    Color.white.opacity(bubble.opacity * (dimmed ? 0.2 : 0.4)),
-                                    Color.cyan.opacity(bubble.opacity * (dimmed ? 0.1 : 0.2)),
-                                    .clear
-                                ],
-                                center: .topLeading,
-                                startRadius: 0,
-                                endRadius: bubble.size
+                if let bubbles = bubbles {
+                    ForEach(0..<particles.count(of: bubbles), id: \.self) { index in
+                        let bubble = particles.particle(index, of: bubbles)
+                        Circle()
+                            .fill(
+                                RadialGradient(
+                                    gradient: palette.gradient(SLPPaletteGradientBubble, level: bubble.alpha),
+                                    center: .topLeading,
+                                    startRadius: 0,
+                                    endRadius: bubble.size
+                                )
                             )
-                        )
-                        .frame(width: bubble.size, height: bubble.size)
-                        .position(
-                            x: bubble.x + sin(bubble.wobblePhase) * 10,
-                            y: bubble.y
-                        )
-                        .shadow(color: .white.opacity(0.3), radius: 2)
+                            .frame(width: bubble.size, height: bubble.size)
+                            .position(x: bubble.x, y: bubble.y)
+                            .shadow(color: .white.opacity(0.3), radius: 2)
+                    }
                 }
                 
                 // Swaying seaweed at the bottom
@@ -1481,25 +1325,30 @@ struct EnhancedGentleWavesView: View {
                 }
                 
                 // Glowing plankton
-                ForEach(plankton) { planktonItem in
-                    Circle()
-                        .fill(
-                            RadialGradient(
-                                colors: [
-                                    planktonItem.color.opacity(dimmed ? 0.4 : 0.8),
-                                    planktonItem.color.opacity(dimmed ? 0.1 : 0.3),
-                                    .clear
-                                ],
-                                center: .center,
-                                startRadius: 0,
-                                endRadius: planktonItem.size
+                if let plankton = plankton {
+                    ForEach(0..<particles.count(of: plankton), id: \.self) { index in
+                        let planktonItem = particles.particle(index, of: plankton)
+                        let color = planktonColors[index % planktonColors.count]
+                        Circle()
+                            .fill(
+                                RadialGradient(
+                                    colors: [
+                                        color.opacity(dimmed ? 0.4 : 0.8),
+                                        color.opacity(dimmed ? 0.1 : 0.3),
+                                        .clear
+                                    ],
+                                    center: .center,
+                                    startRadius: 0,
+                                    endRadius: planktonItem.size
+                                )
                             )
-                        )
-                        .frame(width: planktonItem.size, height: planktonItem.size)
-                        .position(x: planktonItem.x, y: planktonItem.y)
-                        .scaleEffect(0.5 + sin(planktonItem.glowPhase) * 0.3)
-                        .blur(radius: 0.5)
-                        .blendMode(.screen)
+                            .frame(width: planktonItem.size, height: planktonItem.size)
+                            .position(x: planktonItem.x, y: planktonItem.y)
+                            // Glow of 0.25...1, so the scale swings 0.2...0.8
+                            .scaleEffect(0.8 * planktonItem.alpha)
+                            .blur(radius: 0.5)
+                            .blendMode(.screen)
+                    }
                 }
                 
                 // Multi-layered waves with depth
@@ -1596,19 +1445,21 @@ struct EnhancedGentleWavesView: View {
     }
     
     private func setupBubbles() {
-        bubblePositions = []
-        let bubbleCount = Int(intensity * 20) + 5
+        let bounds = UIScreen.main.bounds
         
-        for _ in 0..<bubbleCount {
-            bubblePositions.append(BubbleData(
-                x: CGFloat.random(in: 0...UIScreen.main.bounds.width),
-                y: CGFloat.random(in: UIScreen.main.bounds.height...UIScreen.main.bounds.height + 200),
-                size: CGFloat.random(in: 3...15),
-                riseSpeed: CGFloat.random(in: 20...60),
-                opacity: Double.random(in: 0.2...0.8),
-                wobblePhase: Double.random(in: 0...2 * .pi)
-            ))
-        }
+        // Rise from below the screen, wobbling, and come back at the bottom
+        var config = SLPParticleConfig()
+        config.motion = SLPParticleMotionFall
+        config.count = UInt32(Int(intensity * 20) + 5)
+        config.bounds = SLPParticleBounds(bounds, dx: 0, dy: 50)
+        config.x = SLPParticleRange(0...Float(bounds.width))
+        config.y = SLPParticleRange(Float(bounds.height)...Float(bounds.height) + 200)
+        config.velocityY = SLPParticleRange(-60 ... -20)
+        config.radiusX = SLPParticleRange(10...10)
+        config.orbitRate = SLPParticleRange(0.3...0.8)
+        config.size = SLPParticleRange(3...15)
+        config.alpha = SLPParticleRange(0.2...0.8)
+        bubbles = particles.add(config)
     }
     
     private func setupSurfaceGlitter() {
@@ -1687,24 +1538,25 @@ struct EnhancedGentleWavesView: View {
     }
     
     private func setupPlankton() {
-        plankton = []
-        let planktonCount = Int(intensity * 40) + 20
         let bounds = UIScreen.main.bounds
-        let planktonColors: [Color] = [.green, .cyan, .blue, .white, .yellow]
         
-        for _ in 0..<planktonCount {
-            plankton.append(PlanktonData(
-                x: CGFloat.random(in: 0...bounds.width),
-                y: CGFloat.random(in: 0...bounds.height),
-                size: CGFloat.random(in: 1...4),
-                glowPhase: Double.random(in: 0...2 * .pi),
-                color: planktonColors.randomElement() ?? .cyan,
-                driftVelocity: CGVector(
-                    dx: Double.random(in: -2...2),
-                    dy: Double.random(in: -2...2)
-                )
-            ))
-        }
+        // Slow drift plus a small organic loop, glowing as they go
+        var config = SLPParticleConfig()
+        config.motion = SLPParticleMotionOrbit
+        config.count = UInt32(Int(intensity * 40) + 20)
+        config.bounds = SLPParticleBounds(bounds, dx: 20, dy: 20)
+        config.x = SLPParticleRange(0...Float(bounds.width))
+        config.y = SLPParticleRange(0...Float(bounds.height))
+        config.velocityX = SLPParticleRange(-2...2)
+        config.velocityY = SLPParticleRange(-2...2)
+        config.radiusX = SLPParticleRange(5...7)
+        config.radiusY = SLPParticleRange(5...7)
+        config.orbitRate = SLPParticleRange(0.3...0.4)
+        config.size = SLPParticleRange(1...4)
+        config.alpha = SLPParticleRange(1...1)
+        config.twinkleRate = SLPParticleRange(speed...speed)
+        config.twinkleDepth = 0.75
+        plankton = particles.add(config)
     }
     
     private func startAnimations() {
@@ -1733,32 +1585,11 @@ struct EnhancedGentleWavesView: View {
         }
         
         // Marine life animations
+        particles.start()
         Timer.scheduledTimer(withTimeInterval: 0.1, repeats: true) { _ in
-            updateBubbles()
             updateSeaweed()
             updateFish()
             updateJellyfish()
-            updatePlankton()
-        }
-    }
-    
-    private func updateBubbles() {
-        for i in 0..<bubblePositions.count {
-            bubblePositions[i].y -= bubblePositions[i].riseSpeed * 0.1
-            bubblePositions[i].opacity = max(0, bubblePositions[i].opacity - 0.005)
-            
-            // Reset bubble if it reaches the top
-            if bubblePositions[i].y < -50 {
-                let newBubble = BubbleData(
-                    x: CGFloat.random(in: 0...UIScreen.main.bounds.width),
-                    y: UIScreen.main.bounds.height + 50,
-                    size: CGFloat.random(in: 3...15),
-                    riseSpeed: CGFloat.random(in: 20...60),
-                    opacity: Double.random(in: 0.2...0.8),
-                    wobblePhase: Double.random(in: 0...2 * .pi)
-                )
-                bubblePositions[i] = newBubble
-            }
         }
     }
     
@@ -1869,39 +1700,6 @@ struct EnhancedGentleWavesView: View {
             }
         }
     }
-    
-    private func updatePlankton() {
-        let bounds = UIScreen.main.bounds
-        
-        for i in 0..<plankton.count {
-            // Update glow animation
-            plankton[i].glowPhase += 0.1 * Double(speed)
-            
-            // Gentle drifting movement
-            plankton[i].x += CGFloat(plankton[i].driftVelocity.dx * 0.1)
-            plankton[i].y += CGFloat(plankton[i].driftVelocity.dy * 0.1)
-            
-            // Add some organic movement
-            let time = Date().timeIntervalSince1970
-            let organicX = sin(time * 0.3 + Double(i) * 0.1) * 2
-            let organicY = cos(time * 0.4 + Double(i) * 0.15) * 2
-            plankton[i].x += CGFloat(organicX * 0.1)
-            plankton[i].y += CGFloat(organicY * 0.1)
-            
-            // Boundary wrapping
-            if plankton[i].x > bounds.width + 20 {
-                plankton[i].x = -20
-            } else if plankton[i].x < -20 {
-                plankton[i].x = bounds.width + 20
-            }
-            
-            if plankton[i].y > bounds.height + 20 {
-                plankton[i].y = -20
-            } else if plankton[i].y < -20 {
-                plankton[i].y = bounds.height + 20
-            }
-        }
-    }
 }
 
 // MARK: - Enhanced Wave Shapes
@@ -2140,6 +1938,7 @@ struct EnhancedFireflyMeadowView: View {
     @State private var petals: [PetalData] = []
     @State private var mistParticles: [MistData] = []
     @State private var dewDrops: [DewData] = []
+    @State private var grassRows: [StaticLayerImage] = []
     @State private var moonGlow: Double = 0
     @State private var windPhase: Double = 0
     
@@ -2299,6 +2098,9 @@ struct EnhancedFireflyMeadowView: View {
             setupScene()
             startAnimations()
         }
+        .onChange(of: dimmed) { _ in
+            setupGrass()
+        }
     }
     
     private func setupScene() {
@@ -2306,6 +2108,7 @@ struct EnhancedFireflyMeadowView: View {
         setupPetals()
         setupMist()
         setupDewDrops()
+        setupGrass()
     }
     
     private func setupFireflies() {
@@ -2535,36 +2338,40 @@ struct EnhancedFireflyMeadowView: View {
     }
     
     private func grassLayers(geometry: GeometryProxy) -> some View {
-        ForEach(0..<3, id: \.self) { layer in
-            let grassDensity = 30 - (layer * 8)
-            let layerDepth = CGFloat(layer + 1)
-            
-            ForEach(0..<Int(geometry.size.width / CGFloat(grassDensity)), id: \.self) { index in
-                let grassHeight = CGFloat.random(in: 40...80) / layerDepth
-                let swayAmount = sin(windPhase + Double(index) * 0.3) * 8 / Double(layerDepth)
-                
-                EnhancedGrassShape()
-                    .fill(
-                        LinearGradient(
-                            colors: [
-                                Color.green.opacity((dimmed ? 0.4 : 0.7) / Double(layerDepth)),
-                                Color.black.opacity((dimmed ? 0.8 : 0.6) * Double(layerDepth) / 3.0)
-                            ],
-                            startPoint: .top,
-                            endPoint: .bottom
-                        )
-                    )
-                    .frame(
-                        width: CGFloat.random(in: 2...5) / layerDepth,
-                        height: grassHeight
-                    )
-                    .position(
-                        x: CGFloat(index * grassDensity) + CGFloat.random(in: -5...5) + CGFloat(swayAmount),
-                        y: geometry.size.height - grassHeight/2 + CGFloat(layer * 15)
-                    )
-                    .blur(radius: layerDepth - 1)
-                    .shadow(color: .black.opacity(0.3), radius: 1)
+        ForEach(grassRows.indices, id: \.self) { layer in
+            grassRows[layer].view
+                .modifier(SwayEffect(phase: windPhase, amplitude: 8 / CGFloat(layer + 1)))
+        }
+    }
+    
+    /// Rasterizes the three grass rows off the main thread, or picks them up
+    /// from the cache
+    private func setupGrass() {
+        // UIScreen is read here, on the main actor, never in the task
+        let bounds = UIScreen.main.bounds
+        let scale = UIScreen.main.scale
+        let key = StaticLayers.key("fireflyMeadow", colorTheme.rawValue, intensity, dimmed)
+        let dimmed = self.dimmed
+        
+        Task.detached(priority: .userInitiated) {
+            let rows = (0..<3).compactMap { layer -> StaticLayerImage? in
+                let depth = Float(layer + 1)
+                var config = SLPGrassConfig()
+                config.spacing = Float(30 - layer * 8)
+                config.jitterX = 5
+                config.baseline = Float(bounds.height) + Float(layer * 15)
+                config.bladeHeight = SLPParticleRange(40 / depth...80 / depth)
+                config.bladeWidth = SLPParticleRange(2 / depth...5 / depth)
+                config.fill = SLPGradient([
+                    SLPColor(.green, opacity: (dimmed ? 0.4 : 0.7) / Double(depth)),
+                    SLPColor(.black, opacity: (dimmed ? 0.8 : 0.6) * Double(depth) / 3.0)
+                ])
+                config.blur = depth - 1
+                config.shadow = SLPColor(.black, opacity: 0.3)
+                config.shadowRadius = 1
+                return StaticLayers.grass(key: key + "|grass\(layer)", config, width: bounds.width, scale: scale)
             }
+            await MainActor.run { grassRows = rows }
         }
     }
 }
@@ -2628,24 +2435,15 @@ struct EnhancedShootingStarsView: View {
     let colorTheme: ColorTheme
     let dimmed: Bool
     
-    @State private var stars: [StarData] = []
+    @StateObject private var particles = ParticleField()
+    @State private var stars: ParticleField.System?
     @State private var shootingStars: [ShootingStarData] = []
     @State private var nebulaClouds: [NebulaData] = []
-    @State private var cosmicDust: [DustData] = []
+    @State private var cosmicDust: ParticleField.System?
     @State private var galaxySpiral: Double = 0
     @State private var auroraWaves: [AuroraData] = []
     
-    private struct StarData: Identifiable {
-        let id = UUID()
-        let x: CGFloat
-        let y: CGFloat
-        let size: CGFloat
-        var twinklePhase: Double
-        var brightness: Double
-        let color: Color
-        let constellation: Int
-        var pulseRate: Double
-    }
+    private let starColors: [Color] = [.white, .blue, .yellow, .orange, .red, .cyan]
     
     private struct ShootingStarData: Identifiable {
         let id = UUID()
@@ -2680,15 +2478,6 @@ struct EnhancedShootingStarsView: View {
         let driftSpeed: CGFloat
     }
     
-    private struct DustData: Identifiable {
-        let id = UUID()
-        var x: CGFloat
-        var y: CGFloat
-        var opacity: Double
-        let size: CGFloat
-        var velocity: CGVector
-    }
-    
     private struct AuroraData: Identifiable {
         let id = UUID()
         let baseY: CGFloat
@@ -2777,14 +2566,17 @@ struct EnhancedShootingStarsView: View {
                 }
                 
                 // Cosmic dust
-                ForEach(cosmicDust) { dust in
-                    Circle()
-                        .fill(
-                            Color.white.opacity(dust.opacity * (dimmed ? 0.1 : 0.3))
-                        )
-                        .frame(width: dust.size, height: dust.size)
-                        .position(x: dust.x, y: dust.y)
-                        .blur(radius: 1)
+                if let cosmicDust = cosmicDust {
+                    ForEach(0..<particles.count(of: cosmicDust), id: \.self) { index in
+                        let dust = particles.particle(index, of: cosmicDust)
+                        Circle()
+                            .fill(
+                                Color.white.opacity(dust.alpha * (dimmed ? 0.1 : 0.3))
+                            )
+                            .frame(width: dust.size, height: dust.size)
+                            .position(x: dust.x, y: dust.y)
+                            .blur(radius: 1)
+                    }
                 }
                 
                 // Constellation patterns
@@ -2798,32 +2590,36 @@ struct EnhancedShootingStarsView: View {
                 }
                 
                 // Enhanced static stars with constellations
-                ForEach(stars) { star in
-                    ZStack {
-                        // Main star
-                        StarShape()
-                            .fill(
-                                RadialGradient(
-                                    colors: [
-                                        star.color.opacity(star.brightness * (dimmed ? 0.4 : 0.9)),
-                                        star.color.opacity(star.brightness * (dimmed ? 0.2 : 0.5)),
-                                        .clear
-                                    ],
-                                    center: .center,
-                                    startRadius: 0,
-                                    endRadius: star.size * 2
+                if let stars = stars {
+                    ForEach(0..<particles.count(of: stars), id: \.self) { index in
+                        let star = particles.particle(index, of: stars)
+                        let color = starColors[index % starColors.count]
+                        ZStack {
+                            // Main star
+                            StarShape()
+                                .fill(
+                                    RadialGradient(
+                                        colors: [
+                                            color.opacity(star.alpha * (dimmed ? 0.4 : 0.9)),
+                                            color.opacity(star.alpha * (dimmed ? 0.2 : 0.5)),
+                                            .clear
+                                        ],
+                                        center: .center,
+                                        startRadius: 0,
+                                        endRadius: star.size * 2
+                                    )
                                 )
-                            )
-                            .frame(width: star.size * 2, height: star.size * 2)
-                            .position(x: star.x, y: star.y)
-                            .scaleEffect(0.8 + star.brightness * 0.4)
-                            .blur(radius: star.size > 2 ? 1 : 0)
+                                .frame(width: star.size * 2, height: star.size * 2)
+                                .position(x: star.x, y: star.y)
+                                .scaleEffect(0.8 + star.alpha * 0.4)
+                                .blur(radius: star.size > 2 ? 1 : 0)
                         
-                        // Star core
-                        Circle()
-                            .fill(star.color.opacity(star.brightness))
-                            .frame(width: star.size * 0.3, height: star.size * 0.3)
-                            .position(x: star.x, y: star.y)
+                            // Star core
+                            Circle()
+                                .fill(color.opacity(star.alpha))
+                                .frame(width: star.size * 0.3, height: star.size * 0.3)
+                                .position(x: star.x, y: star.y)
+                        }
                     }
                 }
                 
@@ -2885,22 +2681,20 @@ struct EnhancedShootingStarsView: View {
     }
     
     private func setupStars() {
-        stars = []
-        let starCount = Int(intensity * 80) + 30
-        let starColors: [Color] = [.white, .blue, .yellow, .orange, .red, .cyan]
+        let bounds = UIScreen.main.bounds
         
-        for i in 0..<starCount {
-            stars.append(StarData(
-                x: CGFloat.random(in: 0...UIScreen.main.bounds.width),
-                y: CGFloat.random(in: 0...UIScreen.main.bounds.height * 0.8),
-                size: CGFloat.random(in: 1...4),
-                twinklePhase: Double.random(in: 0...2 * .pi),
-                brightness: Double.random(in: 0.4...1.0),
-                color: starColors.randomElement() ?? .white,
-                constellation: i % 3,
-                pulseRate: Double.random(in: 0.5...2.0)
-            ))
-        }
+        // Fixed stars twinkling between 0.4 and full brightness
+        var config = SLPParticleConfig()
+        config.motion = SLPParticleMotionStatic
+        config.count = UInt32(Int(intensity * 80) + 30)
+        config.bounds = SLPParticleBounds(bounds, dx: 0, dy: 0)
+        config.x = SLPParticleRange(0...Float(bounds.width))
+        config.y = SLPParticleRange(0...Float(bounds.height) * 0.8)
+        config.size = SLPParticleRange(1...4)
+        config.alpha = SLPParticleRange(1...1)
+        config.twinkleRate = SLPParticleRange(0.5 * speed...2 * speed)
+        config.twinkleDepth = 0.6
+        stars = particles.add(config)
     }
     
     private func setupNebulae() {
@@ -2922,21 +2716,20 @@ struct EnhancedShootingStarsView: View {
     }
     
     private func setupCosmicDust() {
-        cosmicDust = []
-        let dustCount = Int(intensity * 100) + 50
+        let bounds = UIScreen.main.bounds
         
-        for _ in 0..<dustCount {
-            cosmicDust.append(DustData(
-                x: CGFloat.random(in: 0...UIScreen.main.bounds.width),
-                y: CGFloat.random(in: 0...UIScreen.main.bounds.height),
-                opacity: Double.random(in: 0.1...0.4),
-                size: CGFloat.random(in: 0.5...2),
-                velocity: CGVector(
-                    dx: Double.random(in: -5...5),
-                    dy: Double.random(in: -2...2)
-                )
-            ))
-        }
+        // Drifts slowly and wraps around the screen edges
+        var config = SLPParticleConfig()
+        config.motion = SLPParticleMotionDrift
+        config.count = UInt32(Int(intensity * 100) + 50)
+        config.bounds = SLPParticleBounds(bounds, dx: 10, dy: 10)
+        config.x = SLPParticleRange(0...Float(bounds.width))
+        config.y = SLPParticleRange(0...Float(bounds.height))
+        config.velocityX = SLPParticleRange(-10...10)
+        config.velocityY = SLPParticleRange(-4...4)
+        config.size = SLPParticleRange(0.5...2)
+        config.alpha = SLPParticleRange(0.1...0.4)
+        cosmicDust = particles.add(config)
     }
     
     private func setupAurora() {
@@ -2960,11 +2753,10 @@ struct EnhancedShootingStarsView: View {
         }
         
         // Continuous updates
+        particles.start()
         Timer.scheduledTimer(withTimeInterval: 0.05, repeats: true) { _ in
-            updateStars()
             updateShootingStars()
             updateNebulae()
-            updateCosmicDust()
             updateAurora()
         }
         
@@ -2974,13 +2766,6 @@ struct EnhancedShootingStarsView: View {
         }
     }
     
-    private func updateStars() {
-        for i in 0..<stars.count {
-            stars[i].twinklePhase += 0.05 * stars[i].pulseRate * Double(speed)
-            stars[i].brightness = 0.4 + 0.6 * (sin(stars[i].twinklePhase) + 1) / 2
-        }
-    }
-    
     private func createShootingStar() {
         let bounds = UIScreen.main.bounds
         let startX = CGFloat.random(in: -150...bounds.width + 150)
@@ -3045,21 +2830,6 @@ struct EnhancedShootingStarsView: View {
         }
     }
     
-    private func updateCosmicDust() {
-        let bounds = UIScreen.main.bounds
-        
-        for i in 0..<cosmicDust.count {
-            cosmicDust[i].x += cosmicDust[i].velocity.dx * 0.1
-            cosmicDust[i].y += cosmicDust[i].velocity.dy * 0.1
-            
-            // Wrap around screen
-            if cosmicDust[i].x < -10 { cosmicDust[i].x = bounds.width + 10 }
-            if cosmicDust[i].x > bounds.width + 10 { cosmicDust[i].x = -10 }
-            if cosmicDust[i].y < -10 { cosmicDust[i].y = bounds.height + 10 }
-            if cosmicDust[i].y > bounds.height + 10 { cosmicDust[i].y = -10 }
-        }
-    }
-    
     private func updateAurora() {
         for i in 0..<auroraWaves.count {
             auroraWaves[i].wavePhase += 0.02 * Double(speed)
@@ -3363,11 +3133,7 @@ struct EnhancedGeometricPatternsView: View {
                     SacredMandalaShape()
                         .stroke(
                             RadialGradient(
-                                colors: [
-                                    getThemeColor().opacity((dimmed ? 0.1 : 0.3) * Double(intensity)),
-                                    getThemeColor().opacity((dimmed ? 0.05 : 0.15) * Double(intensity)),
-                                    .clear
-                                ],
+                                gradient: palette.gradient(SLPPaletteGradientMandalaGlow),
                                 center: .center,
                                 startRadius: 0,
                                 endRadius: 100
@@ -3388,13 +3154,12 @@ struct EnhancedGeometricPatternsView: View {
         }
     }
     
+    private var palette: ThemePalette {
+        ThemePalette.palette(for: colorTheme, dimmed: dimmed, intensity: intensity)
+    }
+    
     private func getThemeColor() -> Color {
-        switch colorTheme {
-        case .warm: return .orange
-        case .cool: return .cyan
-        case .monochrome: return .white
-        default: return .purple
-        }
+        palette.color(SLPSwatchAccent)
     }
     
     // MARK: - Data Structures for Enhanced Sacred Geometry
@@ -3600,7 +3365,7 @@ struct EnhancedGeometricPatternsView: View {
         let x = centerX + symbol.radius * cos(symbol.angle * .pi / 180)
         let y = centerY + symbol.radius * sin(symbol.angle * .pi / 180)
         
-        let strokeColor = getThemeColor().opacity(dimmed ? 0.3 : 0.6)
+        let strokeColor = palette.color(SLPSwatchAccentStroke)
         
         switch symbol.symbolType {
         case 0: 
@@ -3689,11 +3454,7 @@ struct EnhancedGeometricPatternsView: View {
         return RegularPolygonShape(sides: crystal.facets)
             .stroke(
                 RadialGradient(
-                    colors: [
-                        getThemeColor().opacity(opacity * (dimmed ? 0.3 : 0.7)),
-                        getThemeColor().opacity(opacity * (dimmed ? 0.1 : 0.4)),
-                        .clear
-                    ],
+                    gradient: palette.gradient(SLPPaletteGradientCrystal, level: opacity),
                     center: .center,
                     startRadius: 0,
                     endRadius: crystal.size / 2
@@ -3824,232 +3585,43 @@ struct EnhancedGeometricPatternsView: View {
 
 struct FlowerOfLifeShape: Shape {
     func path(in rect: CGRect) -> Path {
-        var path = Path()
-        let center = CGPoint(x: rect.midX, y: rect.midY)
-        let radius = min(rect.width, rect.height) / 6
-        
-        // Create the traditional Flower of Life pattern
-        let positions = [
-            CGPoint(x: 0, y: 0), // Center
-            CGPoint(x: radius, y: 0),
-            CGPoint(x: radius/2, y: radius * sqrt(3)/2),
-            CGPoint(x: -radius/2, y: radius * sqrt(3)/2),
-            CGPoint(x: -radius, y: 0),
-            CGPoint(x: -radius/2, y: -radius * sqrt(3)/2),
-            CGPoint(x: radius/2, y: -radius * sqrt(3)/2)
-        ]
-        
-        for position in positions {
-            let circleCenter = CGPoint(
-                x: center.x + position.x,
-                y: center.y + position.y
-            )
-            path.addEllipse(in: CGRect(
-                x: circleCenter.x - radius,
-                y: circleCenter.y - radius,
-                width: radius * 2,
-                height: radius * 2
-            ))
-        }
-        
-        return path
+        ShapeGeometry.path(SLPShapeFlowerOfLife, in: rect)
     }
 }
 
 struct MetatronsCubeShape: Shape {
     func path(in rect: CGRect) -> Path {
-        var path = Path()
-        let center = CGPoint(x: rect.midX, y: rect.midY)
-        let radius = min(rect.width, rect.height) / 3
-        
-        // Create Metatron's Cube pattern
-        let vertices: [CGPoint] = (0..<6).map { i in
-            let angle = Double(i) * .pi / 3
-            return CGPoint(
-                x: center.x + cos(angle) * radius,
-                y: center.y + sin(angle) * radius
-            )
-        }
-        
-        // Connect all vertices to create the cube
-        for i in 0..<vertices.count {
-            for j in (i+1)..<vertices.count {
-                path.move(to: vertices[i])
-                path.addLine(to: vertices[j])
-            }
-        }
-        
-        // Add center connections
-        for vertex in vertices {
-            path.move(to: center)
-            path.addLine(to: vertex)
-        }
-        
-        return path
+        ShapeGeometry.path(SLPShapeMetatronsCube, in: rect)
     }
 }
 
 struct TriquetraShape: Shape {
     func path(in rect: CGRect) -> Path {
-        var path = Path()
-        let center = CGPoint(x: rect.midX, y: rect.midY)
-        let radius = min(rect.width, rect.height) / 3
-        
-        // Create three interlocking circles
-        for i in 0..<3 {
-            let angle = Double(i) * 2 * .pi / 3
-            let circleCenter = CGPoint(
-                x: center.x + cos(angle) * radius * 0.5,
-                y: center.y + sin(angle) * radius * 0.5
-            )
-            
-            path.addEllipse(in: CGRect(
-                x: circleCenter.x - radius,
-                y: circleCenter.y - radius,
-                width: radius * 2,
-                height: radius * 2
-            ))
-        }
-        
-        return path
+        ShapeGeometry.path(SLPShapeTriquetra, in: rect)
     }
 }
 
 struct SriYantraShape: Shape {
     func path(in rect: CGRect) -> Path {
-        var path = Path()
-        let center = CGPoint(x: rect.midX, y: rect.midY)
-        let size = min(rect.width, rect.height) / 2
-        
-        // Create simplified Sri Yantra triangles
-        for i in 0..<4 {
-            let scale = 1.0 - Double(i) * 0.2
-            let rotation = Double(i) * 15
-            
-            // Upward triangle
-            let triangle1 = createTriangle(center: center, size: size * scale, rotation: rotation)
-            path.addPath(triangle1)
-            
-            // Downward triangle
-            let triangle2 = createTriangle(center: center, size: size * scale, rotation: rotation + 180)
-            path.addPath(triangle2)
-        }
-        
-        return path
-    }
-    
-    private func createTriangle(center: CGPoint, size: CGFloat, rotation: Double) -> Path {
-        var path = Path()
-        let radius = size / 2
-        
-        for i in 0..<3 {
-            let angle = Double(i) * 2 * .pi / 3 + rotation * .pi / 180
-            let point = CGPoint(
-                x: center.x + cos(angle) * radius,
-                y: center.y + sin(angle) * radius
-            )
-            
-            if i == 0 {
-                path.move(to: point)
-            } else {
-                path.addLine(to: point)
-            }
-        }
-        
-        path.closeSubpath()
-        return path
+        ShapeGeometry.path(SLPShapeSriYantra, in: rect)
     }
 }
 
 struct VesicaPiscisShape: Shape {
     func path(in rect: CGRect) -> Path {
-        var path = Path()
-        let center = CGPoint(x: rect.midX, y: rect.midY)
-        let radius = min(rect.width, rect.height) / 3
-        
-        // Two overlapping circles
-        let offset = radius * 0.6
-        
-        path.addEllipse(in: CGRect(
-            x: center.x - offset - radius,
-            y: center.y - radius,
-            width: radius * 2,
-            height: radius * 2
-        ))
-        
-        path.addEllipse(in: CGRect(
-            x: center.x + offset - radius,
-            y: center.y - radius,
-            width: radius * 2,
-            height: radius * 2
-        ))
-        
-        return path
+        ShapeGeometry.path(SLPShapeVesicaPiscis, in: rect)
     }
 }
 
 struct EnneagramShape: Shape {
     func path(in rect: CGRect) -> Path {
-        var path = Path()
-        let center = CGPoint(x: rect.midX, y: rect.midY)
-        let radius = min(rect.width, rect.height) / 2
-        
-        // Create 9-pointed star
-        let points = (0..<9).map { i in
-            let angle = Double(i) * 2 * .pi / 9 - .pi / 2
-            return CGPoint(
-                x: center.x + cos(angle) * radius,
-                y: center.y + sin(angle) * radius
-            )
-        }
-        
-        // Connect every 4th point
-        for i in 0..<9 {
-            let start = points[i]
-            let end = points[(i + 4) % 9]
-            path.move(to: start)
-            path.addLine(to: end)
-        }
-        
-        return path
+        ShapeGeometry.path(SLPShapeEnneagram, in: rect)
     }
 }
 
 struct SacredMandalaShape: Shape {
     func path(in rect: CGRect) -> Path {
-        var path = Path()
-        let center = CGPoint(x: rect.midX, y: rect.midY)
-        let maxRadius = min(rect.width, rect.height) / 2
-        
-        // Create concentric patterns
-        for ring in 1...5 {
-            let radius = maxRadius * CGFloat(ring) / 5
-            let points = ring * 8 // More points for outer rings
-            
-            for i in 0..<points {
-                let angle = Double(i) * 2 * .pi / Double(points)
-                let point = CGPoint(
-                    x: center.x + cos(angle) * radius,
-                    y: center.y + sin(angle) * radius
-                )
-                
-                if i == 0 {
-                    path.move(to: point)
-                } else {
-                    path.addLine(to: point)
-                }
-                
-                // Connect to center for inner rings
-                if ring <= 2 {
-                    path.move(to: center)
-                    path.addLine(to: point)
-                }
-            }
-            
-            path.closeSubpath()
-        }
-        
-        return path
+        ShapeGeometry.path(SLPShapeSacredMandala, in: rect)
     }
 }
 
@@ -4100,7 +3672,8 @@ struct EnhancedSoftRainView: View {
     let colorTheme: ColorTheme
     let dimmed: Bool
     
-    @State private var raindrops: [RaindropData] = []
+    @StateObject private var particles = ParticleField()
+    @State private var raindrops: ParticleField.System?
     @State private var lightningFlashes: [LightningData] = []
     @State private var cloudLayers: [CloudLayerData] = []
     @State private var splashes: [SplashData] = []
@@ -4108,17 +3681,6 @@ struct EnhancedSoftRainView: View {
     @State private var thunderRumble: Double = 0
     @State private var atmosphericPressure: Double = 0
     
-    private struct RaindropData: Identifiable {
-        let id = UUID()
-        var x: CGFloat
-        var y: CGFloat
-        let length: CGFloat
-        let opacity: Double
-        let fallSpeed: CGFloat
-        let thickness: CGFloat
-        let windSway: CGFloat
-    }
-    
     private struct LightningData: Identifiable {
         let id = UUID()
         let path: [CGPoint]
@@ -4233,27 +3795,33 @@ struct EnhancedSoftRainView: View {
                 }
                 
                 // Enhanced rain with wind effects
-                ForEach(raindrops) { drop in
-                    EnhancedRaindropShape()
-                        .stroke(
-                            LinearGradient(
-                                colors: [
-                                    Color.white.opacity(drop.opacity * (dimmed ? 0.4 : 0.7)),
-                                    Color.cyan.opacity(drop.opacity * (dimmed ? 0.2 : 0.4)),
-                                    Color.blue.opacity(drop.opacity * (dimmed ? 0.1 : 0.2))
-                                ],
-                                startPoint: .top,
-                                endPoint: .bottom
-                            ),
-                            lineWidth: drop.thickness
-                        )
-                        .frame(width: drop.thickness + 1, height: drop.length)
-                        .position(
-                            x: drop.x + sin(windPhase) * drop.windSway,
-                            y: drop.y
-                        )
-                        .rotationEffect(.degrees(15 + sin(windPhase) * 10))
-                        .blur(radius: 0.5)
+                if let raindrops = raindrops {
+                    ForEach(0..<particles.count(of: raindrops), id: \.self) { index in
+                        let drop = particles.particle(index, of: raindrops)
+                        // Longer drops are thicker and sway further
+                        let thickness = 0.8 + (drop.size - 10) * 0.08
+                        let windSway = 5 + (drop.size - 10)
+                        EnhancedRaindropShape()
+                            .stroke(
+                                LinearGradient(
+                                    colors: [
+                                        Color.white.opacity(drop.alpha * (dimmed ? 0.4 : 0.7)),
+                                        Color.cyan.opacity(drop.alpha * (dimmed ? 0.2 : 0.4)),
+                                        Color.blue.opacity(drop.alpha * (dimmed ? 0.1 : 0.2))
+                                    ],
+                                    startPoint: .top,
+                                    endPoint: .bottom
+                                ),
+                                lineWidth: thickness
+                            )
+                            .frame(width: thickness + 1, height: drop.size)
+                            .position(
+                                x: drop.x + sin(windPhase) * windSway,
+                                y: drop.y
+                            )
+                            .rotationEffect(.degrees(15 + sin(windPhase) * 10))
+                            .blur(radius: 0.5)
+                    }
                 }
                 
                 // Water splashes and ripples
@@ -4362,20 +3930,19 @@ struct EnhancedSoftRainView: View {
     }
     
     private func setupRain() {
-        raindrops = []
-        let dropCount = Int(intensity * 150) + 30
+        let bounds = UIScreen.main.bounds
         
-        for _ in 0..<dropCount {
-            raindrops.append(RaindropData(
-                x: CGFloat.random(in: -100...UIScreen.main.bounds.width + 100),
-                y: CGFloat.random(in: -UIScreen.main.bounds.height...0),
-                length: CGFloat.random(in: 10...25),
-                opacity: Double.random(in: 0.3...0.9),
-                fallSpeed: CGFloat.random(in: 250...500) * CGFloat(speed),
-                thickness: CGFloat.random(in: 0.8...2.0),
-                windSway: CGFloat.random(in: 5...20)
-            ))
-        }
+        // Size is the streak length; drops splash when they leave the bottom
+        var config = SLPParticleConfig()
+        config.motion = SLPParticleMotionFall
+        config.count = UInt32(Int(intensity * 150) + 30)
+        config.bounds = SLPParticleBounds(bounds, dx: 100, dy: 50)
+        config.x = SLPParticleRange(-100...Float(bounds.width) + 100)
+        config.y = SLPParticleRange(-Float(bounds.height)...0)
+        config.velocityY = SLPParticleRange(250 * speed...500 * speed)
+        config.size = SLPParticleRange(10...25)
+        config.alpha = SLPParticleRange(0.3...0.9)
+        raindrops = particles.add(config)
     }
     
     private func setupClouds() {
@@ -4420,7 +3987,10 @@ struct EnhancedSoftRainView: View {
             thunderRumble = 2 * .pi
         }
         
-        // Continuous updates
+        // Rain falls at the paced frame rate and splashes as it lands
+        particles.start { _ in
+            updateRain()
+        }
         Timer.scheduledTimer(withTimeInterval: 0.016, repeats: true) { _ in
             updateStorm()
         }
@@ -4432,28 +4002,18 @@ struct EnhancedSoftRainView: View {
     }
     
     private func updateStorm() {
-        updateRain()
         updateClouds()
         updateLightning()
         updateSplashes()
     }
     
     private func updateRain() {
+        guard let raindrops = raindrops else { return }
         let bounds = UIScreen.main.bounds
         
-        for i in 0..<raindrops.count {
-            raindrops[i].y += raindrops[i].fallSpeed * 0.016
-            
-            // Create splash when hitting ground
-            if raindrops[i].y > bounds.height - 20 && Double.random(in: 0...1) < 0.1 {
-                createSplash(at: CGPoint(x: raindrops[i].x, y: bounds.height - 10))
-            }
-            
-            // Reset raindrop
-            if raindrops[i].y > bounds.height + 50 {
-                raindrops[i].y = -50
-                raindrops[i].x = CGFloat.random(in: -100...bounds.width + 100)
-            }
+        // Splash where each drop hit the ground
+        particles.forEachExit(of: raindrops) { point in
+            createSplash(at: CGPoint(x: point.x, y: bounds.height - 10))
         }
     }
     
@@ -0,0 +1,198 @@
+//
+//  AppBootstrap.swift
+//  SleepMate
+//
+//  Starts the app's services in a declared order instead of whenever a lazy
+//  `ServiceContainer` property is first touched. Each service names its
+//  phase and the services it needs; SleepsterCore's bootstrap starts
+//  independent ones in parallel on its work-stealing pool and times each
+//  start, which also lands in the trace as an app span. Phases run on a
+//  serial queue, so the main thread never waits for the pool; main-actor
+//  services hop to it for their own start only.
+//
+
+import Foundation
+
+final class AppBootstrap {
+    typealias Phase = SLPBootPhase
+
+    static let shared = AppBootstrap()
+
+    private let bootstrap = SLPBootstrapCreate(0)
+    private let queue = DispatchQueue(label: "com.deanware.sleepster.bootstrap", qos: .userInitiated)
+    /// Passed to the core unretained, so kept alive here
+    private var services: [Service] = []
+    private var isRegistered = false
+    private var reported = 0
+
+    private final class Service {
+        let start: () async -> Bool
+        var succeeded = false
+
+        init(start: @escaping () async -> Bool) {
+            self.start = start
+        }
+    }
+
+    private init() {}
+
+    deinit {
+        SLPBootstrapDestroy(bootstrap)
+    }
+
+    /// Declares a service. Call on the main thread before the first run.
+    /// The pool thread starting it waits for `start` to finish.
+    func register(_ name: String, phase: Phase, after dependencies: [String] = [],
+                  start: @escaping () async -> Bool) {
+        let service = Service(start: start)
+        let copies = dependencies.map { UnsafePointer(strdup($0)!) }
+        defer { copies.forEach { free(UnsafeMutablePointer(mutating: $0)) } }
+        let context = Unmanaged.passUnretained(service).toOpaque()
+        let added = SLPBootstrapAdd(bootstrap, name, phase, copies, copies.count, false, { context in
+            let service = Unmanaged<Service>.fromOpaque(context!).takeUnretainedValue()
+            let finished = DispatchSemaphore(value: 0)
+            Task.detached(priority: .userInitiated) {
+                service.succeeded = await service.start()
+                finished.signal()
+            }
+            finished.wait()
+            return service.succeeded
+        }, context)
+        if added {
+            services.append(service)
+        }
+    }
+
+    /// Starts every service up to and including `phase` that has not
+    /// started yet; false if one failed or was skipped
+    @discardableResult
+    func run(_ phase: Phase) async -> Bool {
+        await withCheckedContinuation { continuation in
+            queue.async { [self] in
+                let succeeded = SLPBootstrapRun(bootstrap, phase)
+                #if DEBUG
+                let error = String(cString: SLPBootstrapGetError(bootstrap))
+                if !error.isEmpty {
+                    print("🚀 Bootstrap: \(error)")
+                }
+                report()
+                #endif
+                continuation.resume(returning: succeeded)
+            }
+        }
+    }
+
+    /// Every service that has finished, in the order it did
+    func timings() -> [SLPBootTiming] {
+        queue.sync {
+            var timings: UnsafePointer<SLPBootTiming>?
+            let count = SLPBootstrapGetTimings(bootstrap, &timings)
+            guard let timings = timings else { return [] }
+            return Array(UnsafeBufferPointer(start: timings, count: count))
+        }
+    }
+
+    // MARK: - Private Methods
+
+    #if DEBUG
+    /// Prints the services that finished since the last report. On the queue.
+    private func report() {
+        var timings: UnsafePointer<SLPBootTiming>?
+        let count = SLPBootstrapGetTimings(bootstrap, &timings)
+        guard let timings = timings else { return }
+        for timing in UnsafeBufferPointer(start: timings, count: count).dropFirst(reported) {
+            let status = timing.status == SLPBootStatusSucceeded ? "" : timing.status == SLPBootStatusFailed ? " FAILED" : " skipped"
+            let thread = timing.thread < 0 ? "caller" : "worker \(timing.thread)"
+            print(String(format: "🚀 %@: ready %.1f ms, %.1f–%.1f ms on %@%@",
+                         String(cString: timing.name), timing.ready * 1000, timing.begin * 1000,
+                         timing.end * 1000, thread, status))
+        }
+        reported = count
+    }
+    #endif
+}
+
+// MARK: - App Services
+
+extension AppBootstrap {
+    /// The app's launch graph. Critical services gate the first screen,
+    /// first-frame ones follow right after it, idle ones only warm caches
+    /// whose lazy properties would otherwise build them on first use.
+    @MainActor
+    func registerServices(_ container: ServiceContainer) {
+        guard !isRegistered else { return }
+        isRegistered = true
+
+        // Critical
+        register("coreData", phase: .critical) {
+            await container.coreDataStack.initializeAsync()
+            return true
+        }
+        register("settings", phase: .critical) { @MainActor in
+            _ = container.settingsManager
+            return true
+        }
+
+        // First frame
+        register("audioSession", phase: .firstFrame) { @MainActor in
+            _ = container.audioSessionManager
+            return true
+        }
+        register("audio", phase: .firstFrame, after: ["coreData", "audioSession"]) { @MainActor in
+            container.audioManager.setupAudioSession()
+            return true
+        }
+        register("timer", phase: .firstFrame, after: ["audio"]) { @MainActor in
+            _ = container.timerManager
+            return true
+        }
+        register("brightness", phase: .firstFrame, after: ["settings"]) { @MainActor in
+            _ = container.brightnessManager
+            return true
+        }
+        register("animations", phase: .firstFrame) {
+            _ = AnimationRegistry.shared
+            return true
+        }
+        register("database", phase: .firstFrame, after: ["coreData", "animations"]) {
+            await DatabaseManager.shared.prePopulate()
+            return true
+        }
+
+        // Idle
+        register("mixingEngine", phase: .idle, after: ["audioSession"]) { @MainActor in
+            _ = container.audioMixingEngine
+            return true
+        }
+        register("equalizer", phase: .idle, after: ["mixingEngine"]) { @MainActor in
+            _ = container.audioEqualizer
+            return true
+        }
+        register("effects", phase: .idle, after: ["mixingEngine"]) { @MainActor in
+            _ = container.audioEffectsProcessor
+            return true
+        }
+        register("shortcuts", phase: .idle) { @MainActor in
+            _ = ShortcutsManager.shared
+            return true
+        }
+        register("performanceMonitor", phase: .idle) { @MainActor in
+            _ = PerformanceMonitor.shared
+            return true
+        }
+        register("battery", phase: .idle) {
+            _ = BatteryOptimizer.shared
+            return true
+        }
+        register("store", phase: .idle) {
+            await StoreKitManager.shared.loadProducts()
+            return true
+        }
+    }
+}
+
+extension SLPBootPhase {
+    static let critical = SLPBootPhaseCritical
+    static let firstFrame = SLPBootPhaseFirstFrame
+    static let idle = SLPBootPhaseIdle
+}
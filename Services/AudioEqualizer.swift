@@ -5,50 +5,37 @@
 //  Created by Claude on Phase 4 Migration
 //
 
-import AVFoundation
 import Foundation
 import Combine
 
-/// Advanced audio equalizer with preset configurations
+/// Advanced audio equalizer with preset configurations.
+///
+/// The bands run inside the native mixer, on its master bus: every change
+/// sends the full ten-band curve as one batch, which the render thread
+/// designs into a single coefficient set and glides to without zipper noise.
 @MainActor
 class AudioEqualizer: ObservableObject {
     static let shared = AudioEqualizer()
     
     @Published var isEnabled = false
     @Published var currentPreset: EqualizerPreset = .flat
-    @Published var customBands: [Float] = Array(repeating: 0.0, count: 10)
+    @Published var customBands: [Float] = Array(repeating: 0.0, count: Int(SLPEqualizerBandCount))
     
-    // Frequency bands (Hz)
+    // Frequency bands (Hz), fixed by the native equalizer
     private let frequencyBands: [Float] = [
         32, 63, 125, 250, 500, 1000, 2000, 4000, 8000, 16000
     ]
     
-    private var audioEngine: AVAudioEngine?
-    private var eqNode: AVAudioUnitEQ?
+    private let mixingEngine: AudioMixingEngine
     
-    private init() {
-        setupEqualizer()
+    private init(mixingEngine: AudioMixingEngine = .shared) {
+        self.mixingEngine = mixingEngine
+        mixingEngine.setEqualizerEnabled(isEnabled)
+        applyCurrentSettings()
     }
     
     // MARK: - Public Interface
     
-    /// Apply equalizer to audio engine
-    func attachToAudioEngine(_ engine: AVAudioEngine, inputNode: AVAudioNode, outputNode: AVAudioNode) {
-        guard let eqNode = eqNode else { return }
-        
-        audioEngine = engine
-        
-        // Attach EQ node to engine
-        engine.attach(eqNode)
-        
-        // Connect: input -> EQ -> output
-        engine.connect(inputNode, to: eqNode, format: nil)
-        engine.connect(eqNode, to: outputNode, format: nil)
-        
-        // Apply current settings
-        applyCurrentSettings()
-    }
-    
     /// Set equalizer preset
     func setPreset(_ preset: EqualizerPreset) {
         currentPreset = preset
@@ -58,16 +45,16 @@ class AudioEqualizer: ObservableObject {
     
     /// Set custom band value
     func setBandValue(_ value: Float, for bandIndex: Int) {
-        guard bandIndex < customBands.count else { return }
+        guard customBands.indices.contains(bandIndex) else { return }
         customBands[bandIndex] = value
         currentPreset = .custom
-        applyBandValue(value, for: bandIndex)
+        applyCurrentSettings()
     }
     
     /// Enable/disable equalizer
     func setEnabled(_ enabled: Bool) {
         isEnabled = enabled
-        eqNode?.bypass = !enabled
+        mixingEngine.setEqualizerEnabled(enabled)
     }
     
     /// Reset all bands to flat
@@ -77,40 +64,8 @@ class AudioEqualizer: ObservableObject {
     
     // MARK: - Private Methods
     
-    private func setupEqualizer() {
-        // Create 10-band parametric EQ
-        eqNode = AVAudioUnitEQ(numberOfBands: frequencyBands.count)
-        
-        guard let eqNode = eqNode else { return }
-        
-        // Configure each band
-        for (index, frequency) in frequencyBands.enumerated() {
-            let band = eqNode.bands[index]
-            band.frequency = frequency
-            band.gain = 0.0
-            band.bandwidth = 1.0
-            band.filterType = .parametric
-        }
-        
-        // Set initial state
-        eqNode.bypass = !isEnabled
-    }
-    
     private func applyCurrentSettings() {
-        guard let eqNode = eqNode else { return }
-        
-        for (index, gain) in customBands.enumerated() {
-            if index < eqNode.bands.count {
-                eqNode.bands[index].gain = gain
-            }
-        }
-    }
-    
-    private func applyBandValue(_ gain: Float, for bandIndex: Int) {
-        guard let eqNode = eqNode,
-              bandIndex < eqNode.bands.count else { return }
-        
-        eqNode.bands[bandIndex].gain = gain
+        mixingEngine.setEqualizerGains(customBands)
     }
 }
 
@@ -218,6 +173,9 @@ enum EqualizerPreset: String, CaseIterable {
 
 // MARK: - Audio Processing Effects
 
+/// Reverb and delay on the native mixer's master bus. Settings are plain
+/// values on the render side, so every setter is cheap and glitch-free; a
+/// disabled effect costs nothing per block.
 @MainActor
 class AudioEffectsProcessor: ObservableObject {
     static let shared = AudioEffectsProcessor()
@@ -231,8 +189,7 @@ class AudioEffectsProcessor: ObservableObject {
     @Published var delayFeedback: Float = 0.2
     @Published var delayWetDryMix: Float = 0.2
     
-    private var reverbNode: AVAudioUnitReverb?
-    private var delayNode: AVAudioUnitDelay?
+    private let mixingEngine: AudioMixingEngine
     
     enum ReverbType: String, CaseIterable {
         case room = "Room"
@@ -240,96 +197,72 @@ class AudioEffectsProcessor: ObservableObject {
         case cathedral = "Cathedral"
         case plate = "Plate"
         
-        var avPreset: AVAudioUnitReverbPreset {
+        var nativePreset: SLPReverbPreset {
             switch self {
             case .room:
-                return .smallRoom
+                return SLPReverbPresetRoom
             case .hall:
-                return .mediumHall
+                return SLPReverbPresetHall
             case .cathedral:
-                return .cathedral
+                return SLPReverbPresetCathedral
             case .plate:
-                return .plate
+                return SLPReverbPresetPlate
             }
         }
     }
     
-    private init() {
-        setupEffects()
+    private init(mixingEngine: AudioMixingEngine = .shared) {
+        self.mixingEngine = mixingEngine
+        applyCurrentSettings()
     }
     
     // MARK: - Public Interface
     
-    func attachToAudioEngine(
-        _ engine: AVAudioEngine,
-        inputNode: AVAudioNode,
-        outputNode: AVAudioNode
-    ) {
-        guard let reverbNode = reverbNode,
-              let delayNode = delayNode else { return }
-        
-        engine.attach(reverbNode)
-        engine.attach(delayNode)
-        
-        // Connect chain: input -> delay -> reverb -> output
-        engine.connect(inputNode, to: delayNode, format: nil)
-        engine.connect(delayNode, to: reverbNode, format: nil)
-        engine.connect(reverbNode, to: outputNode, format: nil)
-        
-        applyCurrentSettings()
-    }
-    
     func setReverbEnabled(_ enabled: Bool) {
         reverbEnabled = enabled
-        reverbNode?.bypass = !enabled
+        mixingEngine.setReverbEnabled(enabled)
     }
     
     func setReverbType(_ type: ReverbType) {
         reverbType = type
-        reverbNode?.loadFactoryPreset(type.avPreset)
+        mixingEngine.setReverbPreset(type.nativePreset)
     }
     
     func setReverbWetDryMix(_ mix: Float) {
         reverbWetDryMix = mix
-        reverbNode?.wetDryMix = mix * 100 // AVAudioUnitReverb expects 0-100
+        mixingEngine.setReverbMix(mix)
     }
     
     func setDelayEnabled(_ enabled: Bool) {
         delayEnabled = enabled
-        delayNode?.bypass = !enabled
+        mixingEngine.setDelayEnabled(enabled)
     }
     
     func setDelayTime(_ time: TimeInterval) {
         delayTime = time
-        delayNode?.delayTime = time
+        mixingEngine.setDelayTime(time)
     }
     
     func setDelayFeedback(_ feedback: Float) {
         delayFeedback = feedback
-        delayNode?.feedback = feedback * 100 // 0-100 range
+        mixingEngine.setDelayFeedback(feedback)
     }
     
     func setDelayWetDryMix(_ mix: Float) {
         delayWetDryMix = mix
-        delayNode?.wetDryMix = mix * 100
+        mixingEngine.setDelayMix(mix)
     }
     
     // MARK: - Private Methods
     
-    private func setupEffects() {
-        reverbNode = AVAudioUnitReverb()
-        delayNode = AVAudioUnitDelay()
-        
-        reverbNode?.bypass = !reverbEnabled
-        delayNode?.bypass = !delayEnabled
-    }
-    
     private func applyCurrentSettings() {
         setReverbType(reverbType)
         setReverbWetDryMix(reverbWetDryMix)
         setDelayTime(delayTime)
         setDelayFeedback(delayFeedback)
         setDelayWetDryMix(delayWetDryMix)
+        setReverbEnabled(reverbEnabled)
+        setDelayEnabled(delayEnabled)
     }
 }
 
@@ -82,19 +82,17 @@ extension AVAudioPlayer {
 
 // MARK: - Fade Task
 
+/// AVAudioPlayer ramps its volume per sample inside its own render callback,
+/// so a fade needs no timer: the only wakeup is the one that delivers the
+/// completion once the ramp has run its course, on `TimerScheduler` with a
+/// tolerance that lets it share a wakeup.
 private class FadeTask {
     let player: AVAudioPlayer
     let targetVolume: Float
     let duration: TimeInterval
     let completion: (() -> Void)?
     
-    private let startVolume: Float
-    private let startTime: Date
-    private let volumeDelta: Float
-    private var timer: Timer?
-    
-    private static let fadeInterval: TimeInterval = 0.05
-    private static let volumeThreshold: Float = 0.01
+    private var completionTimer: TimerScheduler.Token?
     
     init(
         player: AVAudioPlayer,
@@ -106,36 +104,18 @@ private class FadeTask {
         self.targetVolume = targetVolume
         self.duration = duration
         self.completion = completion
-        self.startVolume = player.volume
-        self.startTime = Date()
-        self.volumeDelta = targetVolume - startVolume
-        
-        startFading()
     }
     
-    private func startFading() {
-        timer = Timer.scheduledTimer(withTimeInterval: Self.fadeInterval, repeats: true) { [weak self] _ in
-            self?.performFadeStep()
-        }
-    }
-    
-    private func performFadeStep() {
-        let elapsed = Date().timeIntervalSince(startTime)
-        let progress = min(elapsed / duration, 1.0)
+    func start() {
+        player.setVolume(targetVolume, fadeDuration: duration)
         
-        if progress >= 1.0 {
-            // Fade complete
-            finishFade()
-        } else {
-            // Update volume
-            let currentVolume = startVolume + Float(progress) * volumeDelta
-            player.volume = currentVolume
+        completionTimer = TimerScheduler.shared.schedule(after: duration, tolerance: 0.05) { [weak self] in
+            self?.finishFade()
         }
     }
     
     private func finishFade() {
-        timer?.invalidate()
-        timer = nil
+        completionTimer = nil
         
         player.volume = targetVolume
         completion?()
@@ -144,13 +124,22 @@ private class FadeTask {
         AudioFadeManager.shared.fadeCompleted(for: player)
     }
     
+    /// Stops the ramp where it is and drops the completion. Setting the
+    /// volume the player has reached, with no ramp, replaces the one running.
     func cancel() {
-        timer?.invalidate()
-        timer = nil
+        dropCompletion()
+        player.setVolume(player.volume, fadeDuration: 0)
+    }
+    
+    private func dropCompletion() {
+        TimerScheduler.shared.cancel(completionTimer)
+        completionTimer = nil
     }
     
+    /// Only drops the completion: a task released after being replaced must
+    /// not stop the ramp that replaced it.
     deinit {
-        cancel()
+        dropCompletion()
     }
 }
 
@@ -171,7 +160,8 @@ private class AudioFadeManager {
             // Cancel any existing fade for this player
             self?.activeFades[playerID]?.cancel()
             
-            // Start new fade
+            // Start new fade, after the cancel so it is not pinned in turn
+            fadeTask.start()
             self?.activeFades[playerID] = fadeTask
         }
     }
@@ -9,7 +9,12 @@ import AVFoundation
 import Foundation
 import Combine
 
-/// Advanced audio mixing engine for multiple simultaneous sounds
+/// Advanced audio mixing engine for multiple simultaneous sounds.
+///
+/// Mixing happens in the native SleepsterCore mixer: a single
+/// `AVAudioSourceNode` pulls every voice from one render callback, and all
+/// volume and play/stop changes reach that callback through a wait-free
+/// command queue, so the audio thread never waits on the main actor.
 @MainActor
 class AudioMixingEngine: ObservableObject {
     static let shared = AudioMixingEngine()
@@ -18,18 +23,64 @@ class AudioMixingEngine: ObservableObject {
     @Published var masterVolume: Float = 1.0
     @Published var isPlaying = false
     
-    private let maxConcurrentSounds = 5
+    /// Fires when a mix timeline reaches its end, after it has stopped every sound
+    let automationFinishedPublisher = PassthroughSubject<Void, Never>()
+    
+    /// Voice slots preallocated by the native mixer. Idle slots cost nothing
+    /// on the render thread, so this is a memory bound rather than a CPU one.
+    let maxConcurrentSounds: Int
     private var cancellables = Set<AnyCancellable>()
     
     // Audio engine components
     private let audioEngine = AVAudioEngine()
-    private let masterMixerNode = AVAudioMixerNode()
-    private var audioPlayerNodes: [AudioChannelPlayer: AVAudioPlayerNode] = [:]
-    private var audioFiles: [AudioChannelPlayer: AVAudioFile] = [:]
+    private let mixer: OpaquePointer
+    private var sourceNode: AVAudioSourceNode?
+    private var eventThread: Thread?
+    nonisolated let sampleRate: Double
+    
+    /// What the render callback played, on the host clock, so the
+    /// microphone side can tell the app's own output from the room
+    nonisolated let echoReference: OpaquePointer
+    
+    /// Bundled sounds pre-decoded by SoundPacker and memory-mapped. A voice
+    /// from the pack starts without decoding; sounds missing from it (or
+    /// builds without one) stream from their MP3 instead.
+    private let assetPack: OpaquePointer?
+    
+    /// The master bus as last configured, replayed onto offline renders
+    private var bus = BusSettings()
+    
+    /// Adaptive masking's change on top of the user's volume and EQ curve.
+    /// Live output only: offline renders keep the user's settings.
+    private var maskingGainDb: Float = 0
+    private var maskingOffsets: [Float] = []
+    
+    /// Callers suspended on a render-thread ramp, keyed by its token
+    private var pendingRamps: [SLPRampToken: CheckedContinuation<Bool, Never>] = [:]
+    
+    private static let maxVoices: UInt32 = 32
+    private static let maxBlockFrames: UInt32 = 4096
+    private static let streamLookaheadSeconds = 2.0
     
     private init() {
-        setupAudioEngine()
+        let outputRate = audioEngine.outputNode.outputFormat(forBus: 0).sampleRate
+        let config = SLPMixerConfig(
+            sampleRate: outputRate > 0 ? outputRate : 48_000,
+            maxVoices: Self.maxVoices,
+            maxBlockFrames: Self.maxBlockFrames
+        )
+        guard let mixer = SLPMixerCreate(config) else {
+            fatalError("Unable to allocate the native audio mixer")
+        }
+        self.mixer = mixer
+        self.sampleRate = config.sampleRate
+        self.echoReference = SLPEchoReferenceCreate(config.sampleRate)
+        self.assetPack = Bundle.main.path(forResource: "Sounds", ofType: "slpk").flatMap { SLPAssetPackOpen($0) }
+        self.maxConcurrentSounds = Int(SLPMixerGetMaxVoices(mixer))
+        
+        setupAudioEngine(sampleRate: config.sampleRate)
         setupNotificationObservers()
+        startEventPump()
     }
     
     // MARK: - Public Interface
@@ -47,71 +98,65 @@ class AudioMixingEngine: ObservableObject {
             return nil
         }
         
-        guard let soundURL = Bundle.main.url(forResource: soundName, withExtension: "mp3") else {
-            print("Sound file not found: \(soundName)")
-            return nil
-        }
-        
-        do {
-            let audioFile = try AVAudioFile(forReading: soundURL)
-            let playerNode = AVAudioPlayerNode()
-            
-            // Create channel player
-            let channelPlayer = AudioChannelPlayer(
-                id: UUID(),
-                soundName: soundName,
-                volume: volume,
-                isLooping: loop,
-                playerNode: playerNode
-            )
-            
-            // Connect to audio engine
-            audioEngine.attach(playerNode)
-            audioEngine.connect(playerNode, to: masterMixerNode, format: audioFile.processingFormat)
-            
-            // Store references
-            audioPlayerNodes[channelPlayer] = playerNode
-            audioFiles[channelPlayer] = audioFile
-            
-            // Schedule audio buffer
-            if loop {
-                scheduleLoopingBuffer(for: channelPlayer, audioFile: audioFile)
-            } else {
-                scheduleBuffer(for: channelPlayer, audioFile: audioFile)
+        let source: OpaquePointer
+        if let noise = ProceduralNoise(soundName: soundName) {
+            // Generated on the render thread: no file, no decoding, never ends
+            guard let noiseSource = SLPSourceCreateNoise(noise.nativeColor, UInt64.random(in: 0...UInt64.max)) else {
+                return nil
             }
-            
-            // Set initial volume
-            playerNode.volume = volume * masterVolume
-            
-            // Start playback
-            playerNode.play()
-            
-            // Add to active players
-            activePlayers.append(channelPlayer)
-            updatePlayingState()
-            
-            // Handle fade in
-            if fadeInDuration > 0 {
-                await fadeIn(channelPlayer, duration: fadeInDuration)
+            source = noiseSource
+        } else if let pack = assetPack, let packedSource = SLPSourceCreatePacked(pack, soundName, loop) {
+            // Plays straight from the mapped pack: no decoder, no prefill
+            source = packedSource
+        } else {
+            guard let soundURL = Bundle.main.url(forResource: soundName, withExtension: "mp3") else {
+                print("Sound file not found: \(soundName)")
+                return nil
             }
-            
-            return channelPlayer
-            
-        } catch {
-            print("Failed to load audio file: \(error)")
+            guard let streamSource = createSource(from: soundURL, loop: loop) else { return nil }
+            source = streamSource
+        }
+        
+        // Start silent when fading in; the fade raises the voice afterwards
+        let startVolume = fadeInDuration > 0 ? 0.0 : volume
+        let voiceID = SLPMixerPlay(mixer, source, startVolume)
+        guard voiceID != SLPVoiceIDInvalid else {
+            print("No free mixer voice for \(soundName)")
             return nil
         }
+        
+        // Create channel player
+        let channelPlayer = AudioChannelPlayer(
+            id: UUID(),
+            soundName: soundName,
+            volume: volume,
+            isLooping: loop,
+            voiceID: voiceID
+        )
+        
+        // Add to active players
+        activePlayers.append(channelPlayer)
+        updatePlayingState()
+        Analytics.shared.log(.soundPlayed, .integer(.voices, activePlayers.count), .number(.volume, Double(volume)))
+        
+        // Handle fade in
+        if fadeInDuration > 0 {
+            await fadeIn(channelPlayer, duration: fadeInDuration)
+        }
+        
+        return channelPlayer
     }
     
     /// Stop a specific sound
     func stopSound(_ channelPlayer: AudioChannelPlayer, fadeOutDuration: TimeInterval = 0.0) async {
-        guard let playerNode = audioPlayerNodes[channelPlayer] else { return }
+        guard activePlayers.contains(channelPlayer) else { return }
         
         if fadeOutDuration > 0 {
             await fadeOut(channelPlayer, duration: fadeOutDuration)
         }
         
-        playerNode.stop()
+        // A completed fade-out has already released the voice; this is then a no-op
+        SLPMixerStop(mixer, channelPlayer.voiceID)
         cleanup(channelPlayer)
     }
     
@@ -131,31 +176,15 @@ class AudioMixingEngine: ObservableObject {
             }
         }
         
-        // Stop all players immediately and forcefully
-        for player in playersToStop {
-            if let playerNode = audioPlayerNodes[player] {
-                playerNode.stop()
-                playerNode.reset() // Clear any scheduled buffers
-            }
-        }
-        
-        // Disconnect and detach nodes safely
-        for player in playersToStop {
-            if let playerNode = audioPlayerNodes[player] {
-                if audioEngine.attachedNodes.contains(playerNode) {
-                    audioEngine.disconnectNodeInput(playerNode)
-                    audioEngine.detach(playerNode)
-                }
-            }
-        }
+        // Every voice ramps to silence within a few milliseconds
+        SLPMixerStopAll(mixer)
         
         // Clear all collections immediately
-        await MainActor.run {
-            self.activePlayers.removeAll()
-            self.audioPlayerNodes.removeAll()
-            self.audioFiles.removeAll()
-            self.updatePlayingState()
+        for player in playersToStop {
+            player.isActive = false
         }
+        activePlayers.removeAll()
+        updatePlayingState()
         
         print("🔇 AudioMixingEngine stopAllSounds complete")
     }
@@ -164,11 +193,13 @@ class AudioMixingEngine: ObservableObject {
     func forceStopAll() {
         // Nuclear option: stop the entire audio engine
         audioEngine.stop()
+        SLPMixerStopAll(mixer)
         
         // Clear everything
+        for player in activePlayers {
+            player.isActive = false
+        }
         activePlayers.removeAll()
-        audioPlayerNodes.removeAll()
-        audioFiles.removeAll()
         
         // Restart the engine for future use
         do {
@@ -182,22 +213,143 @@ class AudioMixingEngine: ObservableObject {
     
     /// Set volume for a specific sound
     func setVolume(_ volume: Float, for channelPlayer: AudioChannelPlayer) {
-        guard let playerNode = audioPlayerNodes[channelPlayer] else { return }
+        guard channelPlayer.isActive else { return }
         
         channelPlayer.volume = volume
-        playerNode.volume = volume * masterVolume
+        SLPMixerSetVolume(mixer, channelPlayer.voiceID, volume)
+    }
+    
+    /// Ramps a sound's volume on the render thread, interpolated per sample,
+    /// and suspends until the ramp ends. No timer runs while it is in progress.
+    /// - Returns: `true` if the ramp reached `volume`, `false` if it was cut
+    ///   short by another volume change or by the sound stopping.
+    @discardableResult
+    func rampVolume(
+        of channelPlayer: AudioChannelPlayer,
+        to volume: Float,
+        duration: TimeInterval,
+        curve: SLPRampCurve = SLPRampCurveEqualPower,
+        stopWhenDone: Bool = false
+    ) async -> Bool {
+        guard channelPlayer.isActive else { return false }
+        
+        let token = SLPMixerRampVolume(mixer, channelPlayer.voiceID, volume, duration, curve, stopWhenDone)
+        guard token != 0 else { return false }
+        
+        // Events are drained on the main actor too, so the ramp cannot be
+        // reported before its continuation is registered
+        return await withCheckedContinuation { continuation in
+            pendingRamps[token] = continuation
+        }
+    }
+    
+    /// Tilts a procedural noise sound's spectrum, in dB per octave: 0 is
+    /// white, -3 pink and -6 brown. The colour glides to the new tilt.
+    func setNoiseTilt(_ dbPerOctave: Float, for channelPlayer: AudioChannelPlayer) {
+        guard channelPlayer.isActive, ProceduralNoise(soundName: channelPlayer.soundName) != nil else { return }
+        SLPMixerSetSourceParameter(mixer, channelPlayer.voiceID, UInt32(SLPNoiseParameterTilt), dbPerOctave)
     }
     
     /// Set master volume (affects all sounds)
     func setMasterVolume(_ volume: Float) {
         masterVolume = volume
-        
-        // Update all active players
-        for channelPlayer in activePlayers {
-            if let playerNode = audioPlayerNodes[channelPlayer] {
-                playerNode.volume = channelPlayer.volume * masterVolume
-            }
+        bus.masterVolume = volume
+        applyMasterVolume()
+    }
+    
+    /// Replace the whole master-bus EQ curve (dB per band) in one update;
+    /// the render thread glides to it rather than stepping band by band
+    func setEqualizerGains(_ gains: [Float]) {
+        bus.equalizerGains = gains
+        applyEqualizer()
+    }
+    
+    /// Turn the master-bus EQ on or off. Off costs nothing once it has
+    /// faded to flat.
+    func setEqualizerEnabled(_ enabled: Bool) {
+        bus.equalizerEnabled = enabled
+        applyEqualizer()
+    }
+    
+    /// Adaptive masking's gain and EQ offsets (dB), applied on top of the
+    /// user's volume and curve. A gain of 0 and no offsets clear it.
+    func setMaskingAdjustment(gainDb: Float, equalizerOffsets: [Float]) {
+        maskingGainDb = gainDb
+        maskingOffsets = equalizerOffsets
+        applyMasterVolume()
+        applyEqualizer()
+    }
+    
+    // MARK: - Master-bus effects
+    //
+    // Delay then reverb, after the EQ. Both are fully bypassed while
+    // disabled and stop running on their own once their tails have died
+    // away after the sounds stop.
+    
+    func setReverbEnabled(_ enabled: Bool) {
+        bus.reverbEnabled = enabled
+        SLPMixerSetReverbEnabled(mixer, enabled)
+    }
+    
+    func setReverbPreset(_ preset: SLPReverbPreset) {
+        bus.reverbPreset = preset
+        SLPMixerSetReverbPreset(mixer, preset)
+    }
+    
+    /// Wet share of the output, 0...1
+    func setReverbMix(_ wet: Float) {
+        bus.reverbMix = wet
+        SLPMixerSetReverbMix(mixer, wet)
+    }
+    
+    func setDelayEnabled(_ enabled: Bool) {
+        bus.delayEnabled = enabled
+        SLPMixerSetDelayEnabled(mixer, enabled)
+    }
+    
+    /// Changes glide to the new time instead of jumping
+    func setDelayTime(_ seconds: TimeInterval) {
+        bus.delayTime = seconds
+        SLPMixerSetDelayTime(mixer, seconds)
+    }
+    
+    func setDelayFeedback(_ feedback: Float) {
+        bus.delayFeedback = feedback
+        SLPMixerSetDelayFeedback(mixer, feedback)
+    }
+    
+    /// Wet share of the output, 0...1
+    func setDelayMix(_ wet: Float) {
+        bus.delayMix = wet
+        SLPMixerSetDelayMix(mixer, wet)
+    }
+    
+    // MARK: - Mix automation
+    
+    /// Plays a whole-night timeline (an `SLPAutomation`) on the render
+    /// thread, from `startingAt` seconds into it. Every breakpoint lands on
+    /// its sample with no timer running; channel lanes address `channels`
+    /// in order. At the timeline's end every sound stops and
+    /// `automationFinishedPublisher` fires.
+    @discardableResult
+    func startAutomation(
+        _ timeline: OpaquePointer,
+        channels: [AudioChannelPlayer],
+        startingAt: TimeInterval = 0
+    ) -> Bool {
+        let voices = channels.map { $0.isActive ? $0.voiceID : SLPVoiceIDInvalid }
+        let started = voices.withUnsafeBufferPointer { buffer in
+            SLPMixerAutomate(mixer, timeline, buffer.baseAddress, UInt32(buffer.count), startingAt)
+        }
+        if !started {
+            print("⚠️ Mix timeline not started: the mixer is busy")
         }
+        return started
+    }
+    
+    /// Hands volumes, EQ and effect mixes back to their own settings
+    func stopAutomation() {
+        SLPMixerStopAutomation(mixer)
     }
     
     /// Create a preset mix of sounds
@@ -216,12 +368,94 @@ class AudioMixingEngine: ObservableObject {
         }
     }
     
+    // MARK: - Offline rendering
+    
+    /// Renders `preset` to a stereo file, many times faster than real time,
+    /// through the current master volume, EQ and effects. Sounds fade in as
+    /// they do live and everything fades out over the last `fadeOutDuration`
+    /// seconds. Only packed sounds and generated noise can render offline;
+    /// sounds that would stream from MP3 are left out. The render runs on
+    /// worker threads, so the live mix keeps playing meanwhile. An
+    /// `automation` timeline plays over the render as it would live, with
+    /// channel lanes addressing the preset's sounds in order.
+    func renderPresetMix(
+        _ preset: AudioPreset,
+        duration: TimeInterval,
+        to url: URL,
+        fileType: SLPAudioFileType = SLPAudioFileTypeCAF,
+        fadeOutDuration: TimeInterval = 0.0,
+        automation: OpaquePointer? = nil
+    ) async -> SLPOfflineRenderStats? {
+        guard let mix = SLPOfflineMixCreate(sampleRate, duration) else { return nil }
+        
+        for (index, soundConfig) in preset.sounds.enumerated() {
+            let track = SLPOfflineTrackConfig(
+                volume: soundConfig.volume,
+                fadeInSeconds: soundConfig.fadeInDuration,
+                fadeOutSeconds: fadeOutDuration
+            )
+            let added: Bool
+            if let noise = ProceduralNoise(soundName: soundConfig.name) {
+                // Fixed seeds, so rendering the same preset twice gives the same file
+                added = SLPOfflineMixAddNoise(mix, noise.nativeColor, UInt64(index + 1), track)
+            } else if let pack = assetPack {
+                added = SLPOfflineMixAddPacked(mix, pack, soundConfig.name, soundConfig.loop, track)
+            } else {
+                added = false
+            }
+            if !added {
+                print("Not in the sound pack, left out of the render: \(soundConfig.name)")
+            }
+        }
+        bus.apply(to: mix)
+        SLPOfflineMixSetAutomation(mix, automation)
+        
+        let path = url.path
+        return await Task.detached(priority: .utility) { () -> SLPOfflineRenderStats? in
+            defer { SLPOfflineMixDestroy(mix) }
+            var stats = SLPOfflineRenderStats()
+            let config = SLPOfflineRenderConfig(threads: 0, chunkSeconds: 0)
+            guard SLPOfflineMixRenderToFile(mix, path, fileType, SLPSampleFormatInt16, config, &stats) else {
+                print("Offline render failed: \(url.lastPathComponent)")
+                return nil
+            }
+            return stats
+        }.value
+    }
+    
     // MARK: - Private Methods
     
-    private func setupAudioEngine() {
-        // Attach and connect master mixer
-        audioEngine.attach(masterMixerNode)
-        audioEngine.connect(masterMixerNode, to: audioEngine.outputNode, format: nil)
+    private func applyMasterVolume() {
+        SLPMixerSetMasterVolume(mixer, bus.masterVolume * powf(10, maskingGainDb / 20))
+    }
+    
+    /// The user's curve plus the masking offsets. Offsets turn the EQ on
+    /// over a flat curve when the user has it off.
+    private func applyEqualizer() {
+        let curve = bus.equalizerEnabled ? bus.equalizerGains : []
+        let count = max(curve.count, maskingOffsets.count)
+        let gains = (0..<count).map { band -> Float in
+            (band < curve.count ? curve[band] : 0) + (band < maskingOffsets.count ? maskingOffsets[band] : 0)
+        }
+        gains.withUnsafeBufferPointer { buffer in
+            guard let base = buffer.baseAddress else { return }
+            SLPMixerSetEQGains(mixer, base, UInt32(buffer.count))
+        }
+        SLPMixerSetEQEnabled(mixer, bus.equalizerEnabled || maskingOffsets.contains { $0 != 0 })
+    }
+    
+    private func setupAudioEngine(sampleRate: Double) {
+        guard let format = AVAudioFormat(standardFormatWithSampleRate: sampleRate, channels: 2) else {
+            print("Failed to create mixer output format")
+            return
+        }
+        
+        let node = Self.makeSourceNode(mixer: mixer, echoReference: echoReference, format: format)
+        sourceNode = node
+        
+        // Attach the native mixer and connect it straight to the output
+        audioEngine.attach(node)
+        audioEngine.connect(node, to: audioEngine.mainMixerNode, format: format)
         
         // Start the engine
         do {
@@ -231,6 +465,94 @@ class AudioMixingEngine: ObservableObject {
         }
     }
     
+    /// Built outside the main actor: the render block runs on the audio I/O
+    /// thread and must not inherit actor isolation.
+    private nonisolated static func makeSourceNode(
+        mixer: OpaquePointer,
+        echoReference: OpaquePointer,
+        format: AVAudioFormat
+    ) -> AVAudioSourceNode {
+        let sampleRate = format.sampleRate
+        // Render thread only: the position the next block starts at.
+        var next: Int64 = 0
+        var anchored = false
+        return AVAudioSourceNode(format: format) { _, timestamp, frameCount, audioBufferList -> OSStatus in
+            let buffers = UnsafeMutableAudioBufferListPointer(audioBufferList)
+            guard buffers.count >= 2,
+                  let left = buffers[0].mData?.assumingMemoryBound(to: Float.self),
+                  let right = buffers[1].mData?.assumingMemoryBound(to: Float.self) else {
+                return noErr
+            }
+            SLPMixerRender(mixer, left, right, frameCount)
+            // Positions count samples of host time, which the input tap's
+            // timestamps share. Converting every block's host time jitters
+            // by a sample either way, so blocks follow on from a running
+            // count, anchored to host time and re-anchored only on a real
+            // skip such as a dropped cycle or an engine restart.
+            let time = timestamp.pointee
+            if time.mFlags.contains(.hostTimeValid) {
+                let host = Int64((AVAudioTime.seconds(forHostTime: time.mHostTime) * sampleRate).rounded())
+                if !anchored || abs(host - next) > 16 {
+                    next = host
+                    anchored = true
+                }
+                SLPEchoReferenceWrite(echoReference, left, right, Int(frameCount), next)
+                next += Int64(frameCount)
+            }
+            return noErr
+        }
+    }
+    
+    /// Waits on the mixer's event semaphore instead of polling: the thread
+    /// only wakes when the render callback has released a voice.
+    private func startEventPump() {
+        let mixer = self.mixer
+        let thread = Thread { [weak self] in
+            while true {
+                guard SLPMixerWaitForEvents(mixer, -1) else { continue }
+                Task { @MainActor [weak self] in
+                    self?.drainMixerEvents()
+                }
+            }
+        }
+        thread.name = "AudioMixingEngine.events"
+        thread.qualityOfService = .utility
+        thread.start()
+        eventThread = thread
+    }
+    
+    private func drainMixerEvents() {
+        var events = [SLPMixerEvent](repeating: SLPMixerEvent(), count: 32)
+        var count = events.count
+        
+        while count == events.count {
+            count = Int(SLPMixerCollectEvents(mixer, &events, UInt32(events.count)))
+            
+            for event in events.prefix(count) {
+                switch event.type {
+                case SLPMixerEventVoiceFinished:
+                    if let player = activePlayers.first(where: { $0.voiceID == event.voice }) {
+                        cleanup(player)
+                    }
+                case SLPMixerEventRampFinished:
+                    pendingRamps.removeValue(forKey: event.ramp)?.resume(returning: true)
+                case SLPMixerEventRampCancelled:
+                    pendingRamps.removeValue(forKey: event.ramp)?.resume(returning: false)
+                case SLPMixerEventAutomationFinished:
+                    // The timeline has already stopped every voice
+                    for player in activePlayers {
+                        player.isActive = false
+                    }
+                    activePlayers.removeAll()
+                    updatePlayingState()
+                    automationFinishedPublisher.send()
+                default:
+                    break
+                }
+            }
+        }
+    }
+    
     private func setupNotificationObservers() {
         // Listen for audio session interruptions
         NotificationCenter.default
@@ -254,69 +576,33 @@ class AudioMixingEngine: ObservableObject {
                 }
             }
             .store(in: &cancellables)
-    }
-    
-    private func scheduleBuffer(for channelPlayer: AudioChannelPlayer, audioFile: AVAudioFile) {
-        guard let playerNode = audioPlayerNodes[channelPlayer] else { return }
-        
-        guard let buffer = createBuffer(from: audioFile) else { return }
         
-        playerNode.scheduleBuffer(buffer, at: nil, options: [], completionHandler: { [weak self] in
-            Task { @MainActor in
-                self?.cleanup(channelPlayer)
+        // A category or route change, e.g. the microphone starting for the
+        // night, stops the engine; start it again
+        NotificationCenter.default
+            .publisher(for: .AVAudioEngineConfigurationChange, object: audioEngine)
+            .sink { [weak self] _ in
+                Task { @MainActor in
+                    self?.handleConfigurationChange()
+                }
             }
-        })
-    }
-    
-    private func scheduleLoopingBuffer(for channelPlayer: AudioChannelPlayer, audioFile: AVAudioFile) {
-        guard let playerNode = audioPlayerNodes[channelPlayer] else { return }
-        
-        guard let buffer = createBuffer(from: audioFile) else { return }
-        
-        // Schedule buffer in a loop
-        func scheduleNext() {
-            guard audioPlayerNodes[channelPlayer] != nil else { return }
-            
-            playerNode.scheduleBuffer(buffer, at: nil, options: [], completionHandler: scheduleNext)
-        }
-        
-        scheduleNext()
+            .store(in: &cancellables)
     }
     
-    private func createBuffer(from audioFile: AVAudioFile) -> AVAudioPCMBuffer? {
-        guard let buffer = AVAudioPCMBuffer(
-            pcmFormat: audioFile.processingFormat,
-            frameCapacity: AVAudioFrameCount(audioFile.length)
-        ) else {
-            return nil
-        }
-        
-        do {
-            try audioFile.read(into: buffer)
-            return buffer
-        } catch {
-            print("Failed to read audio file into buffer: \(error)")
+    /// Streams the file through a small native ring buffer. The file is
+    /// memory-mapped and decoded incrementally on the shared decode thread,
+    /// so resident memory per voice is bounded by the lookahead, not the track length.
+    private func createSource(from url: URL, loop: Bool) -> OpaquePointer? {
+        guard let decoder = AudioStreamDecoder(url: url, outputSampleRate: sampleRate) else {
+            print("Failed to open audio stream: \(url.lastPathComponent)")
             return nil
         }
+        let config = SLPStreamingConfig(lookaheadSeconds: Self.streamLookaheadSeconds, loop: loop)
+        return SLPSourceCreateStream(decoder.makeCallbacks(), config)
     }
     
     private func cleanup(_ channelPlayer: AudioChannelPlayer) {
-        guard let playerNode = audioPlayerNodes[channelPlayer] else { 
-            // Still try to remove from active players even if node is missing
-            activePlayers.removeAll { $0.id == channelPlayer.id }
-            updatePlayingState()
-            return 
-        }
-        
-        // Disconnect and detach from engine
-        if audioEngine.attachedNodes.contains(playerNode) {
-            audioEngine.disconnectNodeInput(playerNode)
-            audioEngine.detach(playerNode)
-        }
-        
-        // Remove references
-        audioPlayerNodes.removeValue(forKey: channelPlayer)
-        audioFiles.removeValue(forKey: channelPlayer)
+        channelPlayer.isActive = false
         
         // Remove from active players
         activePlayers.removeAll { $0.id == channelPlayer.id }
@@ -328,17 +614,28 @@ class AudioMixingEngine: ObservableObject {
     }
     
     private func handleInterruption() async {
-        // Pause all players
-        for (_, playerNode) in audioPlayerNodes {
-            playerNode.pause()
-        }
+        // Pause the render callback; voices keep their positions
+        audioEngine.pause()
         updatePlayingState()
     }
     
+    private func handleConfigurationChange() {
+        // An interruption restarts the engine when it ends
+        guard !audioEngine.isRunning, !AudioSessionManager.shared.isInterrupted else { return }
+        do {
+            audioEngine.prepare()
+            try audioEngine.start()
+        } catch {
+            print("Failed to restart audio engine after a configuration change: \(error)")
+        }
+    }
+    
     private func resumePlayback() async {
-        // Resume all players
-        for (_, playerNode) in audioPlayerNodes {
-            playerNode.play()
+        // Resume the render callback
+        do {
+            try audioEngine.start()
+        } catch {
+            print("Failed to resume audio engine: \(error)")
         }
         updatePlayingState()
     }
@@ -346,39 +643,19 @@ class AudioMixingEngine: ObservableObject {
     // MARK: - Fade Effects
     
     private func fadeIn(_ channelPlayer: AudioChannelPlayer, duration: TimeInterval) async {
-        guard let playerNode = audioPlayerNodes[channelPlayer] else { return }
-        
-        let targetVolume = channelPlayer.volume * masterVolume
-        let steps = Int(duration / 0.05) // 50ms intervals
-        let volumeStep = targetVolume / Float(steps)
-        
-        playerNode.volume = 0.0
-        
-        for step in 1...steps {
-            let currentVolume = volumeStep * Float(step)
-            playerNode.volume = currentVolume
-            
-            try? await Task.sleep(nanoseconds: UInt64(0.05 * 1_000_000_000))
-        }
-        
-        playerNode.volume = targetVolume
+        await rampVolume(of: channelPlayer, to: channelPlayer.volume, duration: duration, curve: SLPRampCurveEqualPower)
     }
     
+    /// Fades to silence along an even dB curve and releases the voice on the
+    /// sample the fade ends.
     private func fadeOut(_ channelPlayer: AudioChannelPlayer, duration: TimeInterval) async {
-        guard let playerNode = audioPlayerNodes[channelPlayer] else { return }
-        
-        let startVolume = playerNode.volume
-        let steps = Int(duration / 0.05) // 50ms intervals
-        let volumeStep = startVolume / Float(steps)
-        
-        for step in 1...steps {
-            let currentVolume = startVolume - (volumeStep * Float(step))
-            playerNode.volume = max(0, currentVolume)
-            
-            try? await Task.sleep(nanoseconds: UInt64(0.05 * 1_000_000_000))
-        }
-        
-        playerNode.volume = 0.0
+        await rampVolume(
+            of: channelPlayer,
+            to: 0.0,
+            duration: duration,
+            curve: SLPRampCurveExponential,
+            stopWhenDone: true
+        )
     }
 }
 
@@ -390,20 +667,23 @@ class AudioChannelPlayer: ObservableObject, Identifiable, Hashable {
     @Published var volume: Float
     @Published var isLooping: Bool
     
-    let playerNode: AVAudioPlayerNode
+    /// Handle of the voice in the native mixer
+    let voiceID: SLPVoiceID
+    /// False once the voice has been stopped or has finished playing
+    @Published var isActive = true
     
     init(
         id: UUID,
         soundName: String,
         volume: Float,
         isLooping: Bool,
-        playerNode: AVAudioPlayerNode
+        voiceID: SLPVoiceID
     ) {
         self.id = id
         self.soundName = soundName
         self.volume = volume
         self.isLooping = isLooping
-        self.playerNode = playerNode
+        self.voiceID = voiceID
     }
     
     static func == (lhs: AudioChannelPlayer, rhs: AudioChannelPlayer) -> Bool {
@@ -415,6 +695,31 @@ class AudioChannelPlayer: ObservableObject, Identifiable, Hashable {
     }
 }
 
+/// Catalog sounds generated by the native mixer instead of played from a
+/// bundled file. Their `soundUrl1` is `noise://<colour>`.
+enum ProceduralNoise: String, CaseIterable {
+    case white
+    case pink
+    case brown
+    
+    static let scheme = "noise://"
+    
+    init?(soundName: String) {
+        guard soundName.hasPrefix(Self.scheme) else { return nil }
+        self.init(rawValue: String(soundName.dropFirst(Self.scheme.count)))
+    }
+    
+    var soundName: String { Self.scheme + rawValue }
+    
+    var nativeColor: SLPNoiseColor {
+        switch self {
+        case .white: return SLPNoiseColorWhite
+        case .pink: return SLPNoiseColorPink
+        case .brown: return SLPNoiseColorBrown
+        }
+    }
+}
+
 struct AudioPreset {
     let name: String
     let description: String
@@ -428,6 +733,30 @@ struct AudioPreset {
     }
 }
 
+/// Mirror of the native master-bus settings, which can only be written.
+/// Defaults match the native mixer's.
+private struct BusSettings {
+    var masterVolume: Float = 1.0
+    var equalizerEnabled = false
+    var equalizerGains: [Float] = []
+    var reverbEnabled = false
+    var reverbPreset = SLPReverbPresetRoom
+    var reverbMix: Float = 0.3
+    var delayEnabled = false
+    var delayTime: TimeInterval = 0.1
+    var delayFeedback: Float = 0.2
+    var delayMix: Float = 0.2
+    
+    func apply(to mix: OpaquePointer) {
+        SLPOfflineMixSetMasterVolume(mix, masterVolume)
+        equalizerGains.withUnsafeBufferPointer { buffer in
+            SLPOfflineMixSetEQ(mix, equalizerEnabled, buffer.baseAddress, UInt32(buffer.count))
+        }
+        SLPOfflineMixSetDelay(mix, delayEnabled, delayTime, delayFeedback, delayMix)
+        SLPOfflineMixSetReverb(mix, reverbEnabled, reverbPreset, reverbMix)
+    }
+}
+
 // MARK: - Predefined Presets
 
 extension AudioPreset {
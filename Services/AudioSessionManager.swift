@@ -74,13 +74,14 @@ class AudioSessionManager: NSObject, ObservableObject {
         }
     }
     
-    /// Configure audio session for recording (future feature)
+    /// Configure audio session for recording alongside the sleep mix; call
+    /// `configureSleepAudioSession()` when recording ends
     func configureRecordingSession() async throws {
         do {
             try audioSession.setCategory(
                 .playAndRecord,
                 mode: .default,
-                options: [.defaultToSpeaker, .allowBluetoothA2DP]
+                options: [.mixWithOthers, .defaultToSpeaker, .allowBluetoothA2DP]
             )
             
             try audioSession.setActive(true)
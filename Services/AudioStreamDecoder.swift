@@ -0,0 +1,147 @@
+//
+//  AudioStreamDecoder.swift
+//  SleepMate
+//
+//  Incremental decoder for bundled sound files, driven by the native
+//  streaming source on its background decode thread.
+//
+
+import Foundation
+import AudioToolbox
+
+/// Decodes a memory-mapped audio file a chunk at a time through ExtAudioFile.
+/// The file bytes are mapped rather than read, so only the pages the decoder
+/// touches are resident; the decoded output goes straight into the native
+/// ring buffer without an intermediate PCM copy.
+final class AudioStreamDecoder {
+
+    let sampleRate: Double
+    private(set) var frameCount: UInt64 = 0
+
+    private let data: Data
+    private var audioFile: AudioFileID?
+    private var extFile: ExtAudioFileRef?
+    private let bufferList: UnsafeMutableAudioBufferListPointer
+
+    /// Opens `url` and configures decoding to planar stereo float at `outputSampleRate`,
+    /// so the native side never has to resample.
+    init?(url: URL, outputSampleRate: Double) {
+        guard let mapped = try? Data(contentsOf: url, options: .alwaysMapped) else { return nil }
+        data = mapped
+        sampleRate = outputSampleRate
+        bufferList = AudioBufferList.allocate(maximumBuffers: 2)
+
+        var fileID: AudioFileID?
+        let openStatus = AudioFileOpenWithCallbacks(
+            Unmanaged.passUnretained(self).toOpaque(),
+            AudioStreamDecoder.readProc,
+            nil,
+            AudioStreamDecoder.getSizeProc,
+            nil,
+            kAudioFileMP3Type,
+            &fileID
+        )
+        // Failing after this point still runs deinit, which closes whatever was opened
+        guard openStatus == noErr, let fileID else { return nil }
+        audioFile = fileID
+
+        var ext: ExtAudioFileRef?
+        guard ExtAudioFileWrapAudioFileID(fileID, false, &ext) == noErr, let ext else { return nil }
+        extFile = ext
+
+        var clientFormat = AudioStreamBasicDescription(
+            mSampleRate: outputSampleRate,
+            mFormatID: kAudioFormatLinearPCM,
+            mFormatFlags: kAudioFormatFlagsNativeFloatPacked | kAudioFormatFlagIsNonInterleaved,
+            mBytesPerPacket: 4,
+            mFramesPerPacket: 1,
+            mBytesPerFrame: 4,
+            mChannelsPerFrame: 2,
+            mBitsPerChannel: 32,
+            mReserved: 0
+        )
+        var fileFormat = AudioStreamBasicDescription()
+        var formatSize = UInt32(MemoryLayout<AudioStreamBasicDescription>.size)
+        var fileFrames: Int64 = 0
+        var framesSize = UInt32(MemoryLayout<Int64>.size)
+        guard
+            ExtAudioFileSetProperty(ext, kExtAudioFileProperty_ClientDataFormat,
+                                    UInt32(MemoryLayout<AudioStreamBasicDescription>.size),
+                                    &clientFormat) == noErr,
+            ExtAudioFileGetProperty(ext, kExtAudioFileProperty_FileDataFormat,
+                                    &formatSize, &fileFormat) == noErr,
+            ExtAudioFileGetProperty(ext, kExtAudioFileProperty_FileLengthFrames,
+                                    &framesSize, &fileFrames) == noErr
+        else {
+            return nil
+        }
+
+        // Length is reported at the file rate; scale it to the client rate
+        let ratio = fileFormat.mSampleRate > 0 ? outputSampleRate / fileFormat.mSampleRate : 1
+        frameCount = UInt64(max(0, Double(fileFrames) * ratio))
+    }
+
+    deinit {
+        if let extFile { ExtAudioFileDispose(extFile) }
+        if let audioFile { AudioFileClose(audioFile) }
+        free(bufferList.unsafeMutablePointer)
+    }
+
+    /// Writes up to `frames` planar frames; returns 0 only at the end of the file.
+    func decode(left: UnsafeMutablePointer<Float>, right: UnsafeMutablePointer<Float>, frames: UInt64) -> UInt64 {
+        guard let extFile else { return 0 }
+        let byteSize = UInt32(frames) * UInt32(MemoryLayout<Float>.size)
+        bufferList[0] = AudioBuffer(mNumberChannels: 1, mDataByteSize: byteSize, mData: left)
+        bufferList[1] = AudioBuffer(mNumberChannels: 1, mDataByteSize: byteSize, mData: right)
+        var count = UInt32(frames)
+        guard ExtAudioFileRead(extFile, &count, bufferList.unsafeMutablePointer) == noErr else { return 0 }
+        return UInt64(count)
+    }
+
+    func seek(to frame: UInt64) -> Bool {
+        guard let extFile else { return false }
+        return ExtAudioFileSeek(extFile, Int64(frame)) == noErr
+    }
+
+    /// Hands ownership of the decoder to the native streaming source, which
+    /// calls `release` exactly once when the voice is destroyed.
+    func makeCallbacks() -> SLPDecoderCallbacks {
+        SLPDecoderCallbacks(
+            context: Unmanaged.passRetained(self).toOpaque(),
+            sampleRate: sampleRate,
+            frameCount: frameCount,
+            decode: { context, left, right, frames in
+                Unmanaged<AudioStreamDecoder>.fromOpaque(context!).takeUnretainedValue()
+                    .decode(left: left, right: right, frames: frames)
+            },
+            seek: { context, frame in
+                Unmanaged<AudioStreamDecoder>.fromOpaque(context!).takeUnretainedValue()
+                    .seek(to: frame)
+            },
+            release: { context in
+                Unmanaged<AudioStreamDecoder>.fromOpaque(context!).release()
+            }
+        )
+    }
+
+    // MARK: - AudioFile callbacks
+
+    private static let readProc: AudioFile_ReadProc = { clientData, position, requestCount, buffer, actualCount in
+        let decoder = Unmanaged<AudioStreamDecoder>.fromOpaque(clientData).takeUnretainedValue()
+        let size = Int64(decoder.data.count)
+        guard position < size else {
+            actualCount.pointee = 0
+            return kAudioFileEndOfFileError
+        }
+        let count = Int(min(Int64(requestCount), size - position))
+        decoder.data.withUnsafeBytes { bytes in
+            buffer.copyMemory(from: bytes.baseAddress! + Int(position), byteCount: count)
+        }
+        actualCount.pointee = UInt32(count)
+        return noErr
+    }
+
+    private static let getSizeProc: AudioFile_GetSizeProc = { clientData in
+        Int64(Unmanaged<AudioStreamDecoder>.fromOpaque(clientData).takeUnretainedValue().data.count)
+    }
+}
@@ -0,0 +1,395 @@
+//
+//  CatalogIndex.swift
+//  SleepMate
+//
+//  Keeps SleepsterCore's catalog in step with the Sound and Background
+//  entities in the view context, so that the selected sound, the mix, the
+//  selected background and existence checks by title or animation type are
+//  answered without a fetch. Rows map to their objects lazily: an object id
+//  is fetched by key the first time a row is handed out, then kept.
+//
+//  The store stays the source of truth. Edits made on the entities reach
+//  the index through the context's change notification; edits made here
+//  are written back to the entities by `writeBack`. A snapshot of the index
+//  is written when the app goes to the background, for a launch after the
+//  system ends it there. It is removed when the app comes back to the
+//  foreground, by the core on the index's first change after the write,
+//  and when read, so one on disk never predates a change to the store.
+//
+
+import CoreData
+import UIKit
+
+@MainActor
+final class CatalogIndex: NSObject {
+    typealias Kind = SLPCatalogKind
+
+    static let shared = CatalogIndex()
+
+    private var catalog = SLPCatalogCreate()
+    private weak var context: NSManagedObjectContext?
+    /// Row ids to object ids, per kind, and back
+    private var objectIDs: [Kind.RawValue: [UInt32: NSManagedObjectID]] = [:]
+    private var rows: [NSManagedObjectID: UInt32] = [:]
+    /// Placeholder for a record's key until the core fills it in
+    private static let empty = UnsafePointer(strdup("")!)
+
+    private var snapshotURL: URL? {
+        FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask).first?
+            .appendingPathComponent("catalog.snapshot")
+    }
+
+    private override init() {
+        super.init()
+        NotificationCenter.default.addObserver(
+            forName: UIApplication.didEnterBackgroundNotification,
+            object: nil,
+            queue: .main
+        ) { [weak self] _ in
+            Task { @MainActor in
+                self?.saveSnapshot()
+            }
+        }
+        NotificationCenter.default.addObserver(
+            forName: UIApplication.willEnterForegroundNotification,
+            object: nil,
+            queue: .main
+        ) { [weak self] _ in
+            Task { @MainActor in
+                self?.removeSnapshot()
+            }
+        }
+    }
+
+    // MARK: - Loading
+
+    /// Reads the snapshot, or builds the index with one fetch per entity
+    /// when there is none or its counts disagree with the store, then
+    /// follows `context`. Sounds whose title was already taken are deleted
+    /// while building; the caller saves.
+    func load(_ context: NSManagedObjectContext) {
+        guard self.context !== context else { return }
+        if let observed = self.context {
+            NotificationCenter.default.removeObserver(self, name: .NSManagedObjectContextObjectsDidChange,
+                                                      object: observed)
+        }
+        self.context = context
+        objectIDs = [:]
+        rows = [:]
+
+        Tracing.span(.storage, "catalog.load") {
+            if let url = snapshotURL, let loaded = SLPCatalogLoad(url.path) {
+                removeSnapshot()
+                if count(of: "Sound", in: context) == SLPCatalogGetCount(loaded, SLPCatalogKindSound)
+                    && count(of: "Background", in: context) == SLPCatalogGetCount(loaded, SLPCatalogKindBackground) {
+                    SLPCatalogDestroy(catalog)
+                    catalog = loaded
+                    return
+                }
+                SLPCatalogDestroy(loaded)
+            }
+            rebuild(context)
+        }
+
+        NotificationCenter.default.addObserver(self, selector: #selector(contextObjectsDidChange(_:)),
+                                               name: .NSManagedObjectContextObjectsDidChange, object: context)
+    }
+
+    /// Removes the snapshot, which the next change would make stale
+    func removeSnapshot() {
+        guard let url = snapshotURL else { return }
+        try? FileManager.default.removeItem(at: url)
+    }
+
+    /// Writes the snapshot if the index has been loaded
+    func saveSnapshot() {
+        guard context != nil, let url = snapshotURL else { return }
+        Tracing.span(.storage, "catalog.save") {
+            if !SLPCatalogSave(catalog, url.path) {
+                #if DEBUG
+                print("🗂️ CatalogIndex: could not write the snapshot")
+                #endif
+            }
+        }
+    }
+
+    // MARK: - Queries
+
+    func contains(_ kind: Kind, _ key: String) -> Bool {
+        row(kind, key) != SLPCatalogNotFound
+    }
+
+    func row(_ kind: Kind, _ key: String) -> UInt32 {
+        followed().processPendingChanges()
+        return SLPCatalogFind(catalog, kind, key)
+    }
+
+    /// The first object with `flag`, e.g. the selected sound
+    func first<T: NSManagedObject>(_ kind: Kind, _ flag: SLPCatalogFlag, as type: T.Type) -> T? {
+        followed().processPendingChanges()
+        let row = SLPCatalogGetFirst(catalog, kind, flag)
+        guard row != SLPCatalogNotFound else { return nil }
+        return objects(kind, [row]).first as? T
+    }
+
+    /// Every object with `flag`, in no particular order
+    func all<T: NSManagedObject>(_ kind: Kind, _ flag: SLPCatalogFlag, as type: T.Type) -> [T] {
+        objects(kind, rows(kind, flag)).compactMap { $0 as? T }
+    }
+
+    func rows(_ kind: Kind, _ flag: SLPCatalogFlag) -> [UInt32] {
+        followed().processPendingChanges()
+        var ids: UnsafePointer<UInt32>?
+        let count = SLPCatalogGetAll(catalog, kind, flag, &ids)
+        guard let ids = ids else { return [] }
+        return Array(UnsafeBufferPointer(start: ids, count: count))
+    }
+
+    /// The first sound URL of a sound row, as the index has it
+    func soundUrl1(_ row: UInt32) -> String? {
+        var sound = SLPCatalogSound(title: Self.empty, soundUrl1: nil, soundUrl2: nil, isFavorite: false,
+                                    isSelected: false, isSelectedForMixing: false)
+        guard SLPCatalogGetSound(catalog, row, &sound), let url = sound.soundUrl1 else { return nil }
+        return String(cString: url)
+    }
+
+    // MARK: - Changes
+
+    /// Sets a flag on the index only; `writeBack` carries it to the entity
+    @discardableResult
+    func setFlag(_ kind: Kind, _ row: UInt32, _ flag: SLPCatalogFlag, _ value: Bool) -> Bool {
+        SLPCatalogSetFlag(catalog, kind, row, flag, value, false)
+    }
+
+    /// Selects `row` and deselects the rest of its kind, on the index only
+    @discardableResult
+    func select(_ kind: Kind, _ row: UInt32) -> Bool {
+        SLPCatalogSelect(catalog, kind, row)
+    }
+
+    /// Copies the flags changed through the index onto their entities and
+    /// returns how many were touched. Only those objects are fetched; the
+    /// caller saves.
+    @discardableResult
+    func writeBack() -> Int {
+        var written = 0
+        for kind in [SLPCatalogKindSound, SLPCatalogKindBackground] {
+            var ids: UnsafePointer<UInt32>?
+            let count = SLPCatalogTakeChanges(catalog, kind, &ids)
+            guard let ids = ids, count > 0 else { continue }
+            let live = UnsafeBufferPointer(start: ids, count: count).filter {
+                SLPCatalogIsLive(catalog, kind, $0)
+            }
+            for (row, object) in boundObjects(kind, live) {
+                if let sound = object as? SoundEntity {
+                    sound.isFavorite = SLPCatalogGetFlag(catalog, kind, row, SLPCatalogFlagFavorite)
+                    sound.isSelected = SLPCatalogGetFlag(catalog, kind, row, SLPCatalogFlagSelected)
+                    sound.isSelectedForMixing = SLPCatalogGetFlag(catalog, kind, row, SLPCatalogFlagSelectedForMixing)
+                } else if let background = object as? BackgroundEntity {
+                    background.isFavorite = SLPCatalogGetFlag(catalog, kind, row, SLPCatalogFlagFavorite)
+                    background.isSelected = SLPCatalogGetFlag(catalog, kind, row, SLPCatalogFlagSelected)
+                }
+                written += 1
+            }
+        }
+        return written
+    }
+
+    // MARK: - Private Methods
+
+    private func rebuild(_ context: NSManagedObjectContext) {
+        SLPCatalogDestroy(catalog)
+        catalog = SLPCatalogCreate()
+        var duplicates = 0
+        for sound in (try? context.fetch(SoundEntity.fetchAllSounds())) ?? [] {
+            if case .duplicate = apply(sound) {
+                context.delete(sound)
+                duplicates += 1
+            }
+        }
+        for background in (try? context.fetch(BackgroundEntity.fetchAllBackgrounds())) ?? [] {
+            apply(background)
+        }
+        #if DEBUG
+        print("🗂️ CatalogIndex: built \(SLPCatalogGetCount(catalog, SLPCatalogKindSound)) sounds and "
+              + "\(SLPCatalogGetCount(catalog, SLPCatalogKindBackground)) backgrounds from the store"
+              + (duplicates > 0 ? ", removed \(duplicates) duplicate sounds" : ""))
+        #endif
+    }
+
+    /// The context followed, loading from the view context if nothing has
+    /// loaded the index yet
+    private func followed() -> NSManagedObjectContext {
+        if let context = context {
+            return context
+        }
+        let context = CoreDataStack.shared.viewContext
+        load(context)
+        return context
+    }
+
+    private func count(of entityName: String, in context: NSManagedObjectContext) -> Int {
+        (try? context.count(for: NSFetchRequest<NSFetchRequestResult>(entityName: entityName))) ?? -1
+    }
+
+    @objc private func contextObjectsDidChange(_ notification: Notification) {
+        let info = notification.userInfo ?? [:]
+        for key in [NSInsertedObjectsKey, NSUpdatedObjectsKey, NSRefreshedObjectsKey] {
+            for object in info[key] as? Set<NSManagedObject> ?? [] {
+                if let sound = object as? SoundEntity {
+                    apply(sound)
+                } else if let background = object as? BackgroundEntity {
+                    apply(background)
+                }
+            }
+        }
+        for object in info[NSDeletedObjectsKey] as? Set<NSManagedObject> ?? [] {
+            let kind = object is SoundEntity ? SLPCatalogKindSound : SLPCatalogKindBackground
+            guard object is SoundEntity || object is BackgroundEntity,
+                  let row = existingRow(kind, object, key: key(of: object, committed: false))
+            else { continue }
+            SLPCatalogRemove(catalog, kind, row, true)
+            unbind(kind, row)
+        }
+    }
+
+    private enum Applied {
+        case added, updated, duplicate, skipped
+    }
+
+    /// Adds or updates the object's row as the store has it
+    @discardableResult
+    private func apply(_ sound: SoundEntity) -> Applied {
+        guard let title = sound.bTitle else { return .skipped }
+        return withCString(sound.soundUrl1) { url1 in
+            withCString(sound.soundUrl2) { url2 in
+                title.withCString { title in
+                    var record = SLPCatalogSound(title: title, soundUrl1: url1, soundUrl2: url2,
+                                                 isFavorite: sound.isFavorite, isSelected: sound.isSelected,
+                                                 isSelectedForMixing: sound.isSelectedForMixing)
+                    return store(SLPCatalogKindSound, sound) { row in
+                        if let row = row {
+                            return (SLPCatalogUpdateSound(catalog, row, &record, true), nil)
+                        }
+                        var added = SLPCatalogNotFound
+                        return (SLPCatalogAddSound(catalog, &record, true, &added), added)
+                    }
+                }
+            }
+        }
+    }
+
+    @discardableResult
+    private func apply(_ background: BackgroundEntity) -> Applied {
+        guard let animationType = background.animationType else { return .skipped }
+        return withCString(background.colorTheme) { colorTheme in
+            animationType.withCString { animationType in
+                var record = SLPCatalogBackground(animationType: animationType, colorTheme: colorTheme,
+                                                  intensityLevel: background.intensityLevel,
+                                                  speedMultiplier: background.speedMultiplier,
+                                                  isFavorite: background.isFavorite,
+                                                  isSelected: background.isSelected)
+                return store(SLPCatalogKindBackground, background) { row in
+                    if let row = row {
+                        return (SLPCatalogUpdateBackground(catalog, row, &record, true), nil)
+                    }
+                    var added = SLPCatalogNotFound
+                    return (SLPCatalogAddBackground(catalog, &record, true, &added), added)
+                }
+            }
+        }
+    }
+
+    /// Runs `write` with the object's existing row, or nil to add one, and
+    /// binds the row it ends up in. `write` returns whether it succeeded
+    /// and, for an add, the new row.
+    private func store(_ kind: Kind, _ object: NSManagedObject,
+                       _ write: (UInt32?) -> (Bool, UInt32?)) -> Applied {
+        let existing = existingRow(kind, object, key: key(of: object, committed: true))
+        let (succeeded, added) = write(existing)
+        if let row = existing {
+            if succeeded {
+                bind(kind, row, object.objectID)
+                return .updated
+            }
+            return .skipped
+        }
+        guard let row = added, succeeded else {
+            // The key belongs to a row mirroring another object
+            return .duplicate
+        }
+        bind(kind, row, object.objectID)
+        return .added
+    }
+
+    /// The row mirroring `object`: the one bound to it, or the one holding
+    /// its key if that is bound to nothing else yet
+    private func existingRow(_ kind: Kind, _ object: NSManagedObject, key: String?) -> UInt32? {
+        if let row = rows[object.objectID], SLPCatalogIsLive(catalog, kind, row) {
+            return row
+        }
+        guard let key = key else { return nil }
+        let row = SLPCatalogFind(catalog, kind, key)
+        guard row != SLPCatalogNotFound, objectIDs[kind.rawValue]?[row] == nil else { return nil }
+        return row
+    }
+
+    /// The key the store last saved for the object, so a rename finds its
+    /// old row, or the current one
+    private func key(of object: NSManagedObject, committed: Bool) -> String? {
+        let name = object is SoundEntity ? "bTitle" : "animationType"
+        if committed, !object.isInserted, let key = object.committedValues(forKeys: [name])[name] as? String {
+            return key
+        }
+        return object.value(forKey: name) as? String
+    }
+
+    private func objects(_ kind: Kind, _ rows: [UInt32]) -> [NSManagedObject] {
+        boundObjects(kind, rows).map { $0.1 }
+    }
+
+    /// Objects for `rows`, fetching the ids of the ones not bound yet in
+    /// one request by key; rows without an object are left out
+    private func boundObjects(_ kind: Kind, _ rows: [UInt32]) -> [(UInt32, NSManagedObject)] {
+        guard let context = context else { return [] }
+        let bound = objectIDs[kind.rawValue] ?? [:]
+        let missing = rows.filter { bound[$0] == nil }
+        if !missing.isEmpty {
+            let isSound = kind == SLPCatalogKindSound
+            let keys = missing.compactMap { row -> String? in
+                guard let key = SLPCatalogGetKey(catalog, kind, row) else { return nil }
+                return String(cString: key)
+            }
+            let request = NSFetchRequest<NSManagedObject>(entityName: isSound ? "Sound" : "Background")
+            request.predicate = NSPredicate(format: "%K IN %@", isSound ? "bTitle" : "animationType", keys)
+            for object in (try? context.fetch(request)) ?? [] {
+                if let objectKey = key(of: object, committed: false) {
+                    let row = SLPCatalogFind(catalog, kind, objectKey)
+                    if row != SLPCatalogNotFound, objectIDs[kind.rawValue]?[row] == nil {
+                        bind(kind, row, object.objectID)
+                    }
+                }
+            }
+        }
+        let ids = objectIDs[kind.rawValue] ?? [:]
+        return rows.compactMap { row in ids[row].map { (row, context.object(with: $0)) } }
+    }
+
+    private func bind(_ kind: Kind, _ row: UInt32, _ objectID: NSManagedObjectID) {
+        // Temporary ids change on save; the row is found by key until then
+        guard !objectID.isTemporaryID else { return }
+        objectIDs[kind.rawValue, default: [:]][row] = objectID
+        rows[objectID] = row
+    }
+
+    private func unbind(_ kind: Kind, _ row: UInt32) {
+        if let objectID = objectIDs[kind.rawValue]?.removeValue(forKey: row) {
+            rows.removeValue(forKey: objectID)
+        }
+    }
+
+    private func withCString<R>(_ string: String?, _ body: (UnsafePointer<CChar>?) -> R) -> R {
+        guard let string = string else { return body(nil) }
+        return string.withCString { body($0) }
+    }
+}
@@ -107,6 +107,8 @@ class ErrorHandler: ObservableObject {
             logger.fault("\(logMessage)")
         }
         
+        Analytics.shared.logError(error.type.analyticsName)
+        
         // In debug mode, also print to console
         #if DEBUG
         print("🚨 \(logMessage)")
@@ -134,6 +136,17 @@ struct AppError: Error, Identifiable {
         case critical
         case unknown
         
+        var analyticsName: Analytics.Name {
+            switch self {
+            case .network: return .networkError
+            case .dataCorruption: return .dataCorruptionError
+            case .userAction: return .userActionError
+            case .validation: return .validationError
+            case .critical: return .criticalError
+            case .unknown: return .unknownError
+            }
+        }
+        
         var icon: String {
             switch self {
             case .network:
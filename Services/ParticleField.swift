@@ -0,0 +1,154 @@
+//
+//  ParticleField.swift
+//  SleepMate
+//
+//  Particles for the animated backgrounds, simulated by SleepsterCore in
+//  structure-of-arrays buffers. A running field is driven by a display link
+//  at the rate AnimationPerformanceMonitor chooses and advances in fixed
+//  steps with interpolated positions, so motion keeps its speed and stays
+//  smooth whatever rate frames come at. Views read positions straight from
+//  the native columns, so a frame copies nothing and allocates nothing.
+//
+
+import CoreGraphics
+import Foundation
+import QuartzCore
+
+final class ParticleField: ObservableObject {
+    /// One kind of particle in the field, e.g. the bubbles of the ocean
+    struct System: Hashable {
+        fileprivate let index: UInt32
+    }
+
+    struct Particle {
+        let x: CGFloat
+        let y: CGFloat
+        let size: CGFloat
+        let alpha: Double
+    }
+
+    /// Bumped by every step, so views reading the field redraw
+    @Published private(set) var frame: UInt64 = 0
+
+    private let scene: OpaquePointer
+    private var displayLink: CADisplayLink?
+    private var lastTimestamp: CFTimeInterval = 0
+    private var onFrame: ((TimeInterval) -> Void)?
+
+    /// Equal seeds give identical fields; the default differs every launch
+    init(seed: UInt64 = UInt64.random(in: 0...UInt64.max)) {
+        scene = SLPParticleSceneCreate(seed)
+    }
+
+    deinit {
+        displayLink?.invalidate()
+        SLPParticleSceneDestroy(scene)
+    }
+
+    /// Adds a kind of particle. Allocates, so call it while setting the
+    /// background up rather than per frame.
+    func add(_ config: SLPParticleConfig) -> System? {
+        let index = SLPParticleSceneAddSystem(scene, config)
+        return index >= 0 ? System(index: UInt32(index)) : nil
+    }
+
+    /// Advances every system by `seconds` and triggers a redraw
+    func step(_ seconds: TimeInterval) {
+        SLPParticleSceneStep(scene, seconds)
+        frame &+= 1
+    }
+
+    /// Advances on every display frame until stopped, reporting frame times
+    /// to the performance monitor. `onFrame` runs after each advance with
+    /// the frame's duration, e.g. to react to exits.
+    func start(onFrame: ((TimeInterval) -> Void)? = nil) {
+        self.onFrame = onFrame
+        guard displayLink == nil else { return }
+        let link = CADisplayLink(target: DisplayLinkTarget(self), selector: #selector(DisplayLinkTarget.tick(_:)))
+        link.preferredFramesPerSecond = Int(AnimationPerformanceMonitor.shared.targetFPS)
+        link.add(to: .main, forMode: .common)
+        displayLink = link
+        lastTimestamp = 0
+    }
+
+    func stop() {
+        displayLink?.invalidate()
+        displayLink = nil
+        onFrame = nil
+    }
+
+    fileprivate func tick(_ link: CADisplayLink) {
+        defer { lastTimestamp = link.timestamp }
+        guard lastTimestamp > 0 else { return }
+        let elapsed = link.timestamp - lastTimestamp
+        let monitor = AnimationPerformanceMonitor.shared
+        monitor.recordFrame(elapsed)
+        let target = Int(monitor.targetFPS)
+        if link.preferredFramesPerSecond != target {
+            link.preferredFramesPerSecond = target
+        }
+        Tracing.span(.animation, "animation.frame") {
+            SLPParticleSceneAdvance(scene, elapsed)
+            onFrame?(elapsed)
+        }
+        frame &+= 1
+    }
+
+    func count(of system: System) -> Int {
+        Int(SLPParticleSceneGetCount(scene, system.index))
+    }
+
+    func particle(_ index: Int, of system: System) -> Particle {
+        Particle(
+            x: CGFloat(SLPParticleSceneGetX(scene, system.index)[index]),
+            y: CGFloat(SLPParticleSceneGetY(scene, system.index)[index]),
+            size: CGFloat(SLPParticleSceneGetSize(scene, system.index)[index]),
+            alpha: Double(SLPParticleSceneGetAlpha(scene, system.index)[index])
+        )
+    }
+
+    /// Calls `body` with where each particle of a falling system left the
+    /// bounds during the last step or frame
+    func forEachExit(of system: System, _ body: (CGPoint) -> Void) {
+        var count: UInt32 = 0
+        guard let exits = SLPParticleSceneGetExits(scene, system.index, &count) else { return }
+        for exit in UnsafeBufferPointer(start: exits, count: Int(count)) {
+            body(CGPoint(x: CGFloat(exit.x), y: CGFloat(exit.y)))
+        }
+    }
+
+    func setWind(_ x: Float, _ y: Float, for system: System) {
+        SLPParticleSceneSetWind(scene, system.index, x, y)
+    }
+}
+
+/// CADisplayLink retains its target; this keeps it from retaining the field.
+private final class DisplayLinkTarget: NSObject {
+    private weak var field: ParticleField?
+
+    init(_ field: ParticleField) {
+        self.field = field
+    }
+
+    @objc func tick(_ link: CADisplayLink) {
+        guard let field = field else {
+            link.invalidate()
+            return
+        }
+        field.tick(link)
+    }
+}
+
+extension SLPParticleRange {
+    init(_ range: ClosedRange<Float>) {
+        self.init(min: range.lowerBound, max: range.upperBound)
+    }
+}
+
+extension SLPParticleBounds {
+    /// `rect` grown by `dx` on the left and right and `dy` above and below
+    init(_ rect: CGRect, dx: CGFloat, dy: CGFloat) {
+        let outer = rect.insetBy(dx: -dx, dy: -dy)
+        self.init(minX: Float(outer.minX), minY: Float(outer.minY), maxX: Float(outer.maxX), maxY: Float(outer.maxY))
+    }
+}
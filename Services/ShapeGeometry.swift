@@ -0,0 +1,77 @@
+//
+//  ShapeGeometry.swift
+//  SleepMate
+//
+//  Paths for the sacred-geometry and sheep shapes, from the unit outlines
+//  SleepsterCore tessellates once. `path(in:)` runs on every frame these
+//  shapes animate; it now returns the path already placed in that rect, or
+//  scales and translates the unit path into a new one, instead of
+//  rebuilding it with fresh trigonometry.
+//
+
+import SwiftUI
+
+enum ShapeGeometry {
+    private struct Key: Hashable {
+        let shape: UInt32
+        let x: CGFloat
+        let y: CGFloat
+        let width: CGFloat
+        let height: CGFloat
+    }
+
+    /// Animations place a handful of shapes in a handful of rects; the
+    /// limit only guards against a rect that changes every frame.
+    private static let placedLimit = 64
+
+    private static let lock = NSLock()
+    private static var unitPaths: [UInt32: Path] = [:]
+    private static var placed: [Key: Path] = [:]
+
+    /// `shape` centred in `rect` and scaled by its smaller side
+    static func path(_ shape: SLPShape, in rect: CGRect) -> Path {
+        let key = Key(shape: shape.rawValue, x: rect.minX, y: rect.minY, width: rect.width, height: rect.height)
+        lock.lock()
+        defer { lock.unlock() }
+        if let hit = placed[key] {
+            return hit
+        }
+        let unit = unitPaths[shape.rawValue] ?? makeUnitPath(shape)
+        unitPaths[shape.rawValue] = unit
+        let side = min(rect.width, rect.height)
+        let path = unit.applying(CGAffineTransform(a: side, b: 0, c: 0, d: side, tx: rect.midX, ty: rect.midY))
+        if placed.count >= placedLimit {
+            placed.removeAll(keepingCapacity: true)
+        }
+        placed[key] = path
+        return path
+    }
+
+    private static func makeUnitPath(_ shape: SLPShape) -> Path {
+        let outline = SLPShapeGetUnitPath(shape)
+        var path = Path()
+        var p = 0
+        func point(_ offset: Int) -> CGPoint {
+            CGPoint(x: CGFloat(outline.points[2 * (p + offset)]), y: CGFloat(outline.points[2 * (p + offset) + 1]))
+        }
+        for index in 0..<Int(outline.verbCount) {
+            switch SLPPathVerb(rawValue: UInt32(outline.verbs[index])) {
+            case SLPPathVerbMove:
+                path.move(to: point(0))
+                p += 1
+            case SLPPathVerbLine:
+                path.addLine(to: point(0))
+                p += 1
+            case SLPPathVerbQuad:
+                path.addQuadCurve(to: point(1), control: point(0))
+                p += 2
+            case SLPPathVerbCubic:
+                path.addCurve(to: point(2), control1: point(0), control2: point(1))
+                p += 3
+            default:
+                path.closeSubpath()
+            }
+        }
+        return path
+    }
+}
@@ -0,0 +1,226 @@
+//
+//  SleepSoundMonitor.swift
+//  SleepMate
+//
+//  Listens to the microphone during a tracked night and tags snoring,
+//  talking, coughing and loud noise with SleepsterCore's sound event
+//  detector. The input tap feeds the detector directly; it only transforms
+//  the moments that stand out from the room, so a quiet night costs little.
+//  Audio never leaves the device and is not kept, only the events. The
+//  same buffers drive AdaptiveMasking.
+//
+
+import AVFoundation
+import Foundation
+
+final class SleepSoundMonitor {
+    static let shared = SleepSoundMonitor()
+
+    private let engine = AVAudioEngine()
+    /// Guards the detector and `events`; the tap runs on its own thread.
+    private let lock = NSLock()
+    private var detector: OpaquePointer?
+    private var startDate = Date()
+    private var events: [SleepSoundEvent] = []
+    private var scratch = [SLPSoundEvent](repeating: SLPSoundEvent(), count: 16)
+
+    private(set) var isListening = false
+
+    private init() {}
+
+    // MARK: - Listening
+
+    /// Starts listening. False without microphone permission or when the
+    /// input cannot be started.
+    @discardableResult
+    func start() async -> Bool {
+        guard !isListening, await requestPermission() else { return false }
+
+        do {
+            try await AudioSessionManager.shared.configureRecordingSession()
+        } catch {
+            // The category may have changed before activation failed
+            restorePlaybackSession()
+            #if DEBUG
+            print("SleepSoundMonitor: recording session failed: \(error)")
+            #endif
+            return false
+        }
+
+        let input = engine.inputNode
+        let format = input.outputFormat(forBus: 0)
+        guard format.sampleRate > 0 else {
+            restorePlaybackSession()
+            return false
+        }
+
+        lock.lock()
+        detector = SLPSoundEventDetectorCreate(format.sampleRate)
+        startDate = Date()
+        events.removeAll()
+        lock.unlock()
+
+        input.installTap(onBus: 0, bufferSize: 4096, format: format) { [weak self] buffer, time in
+            self?.process(buffer)
+            AdaptiveMasking.shared.process(buffer, at: time)
+        }
+        do {
+            engine.prepare()
+            try engine.start()
+        } catch {
+            input.removeTap(onBus: 0)
+            release()
+            restorePlaybackSession()
+            #if DEBUG
+            print("SleepSoundMonitor: input failed to start: \(error)")
+            #endif
+            return false
+        }
+
+        isListening = true
+        await AdaptiveMasking.shared.start(sampleRate: format.sampleRate)
+        return true
+    }
+
+    /// Stops listening and returns the night's events, oldest first.
+    func stop() -> [SleepSoundEvent] {
+        guard isListening else { return [] }
+        isListening = false
+        engine.inputNode.removeTap(onBus: 0)
+        engine.stop()
+        Task { @MainActor in AdaptiveMasking.shared.stop() }
+        restorePlaybackSession()
+
+        lock.lock()
+        if let detector = detector {
+            SLPSoundEventDetectorFlush(detector)
+            drain(detector)
+        }
+        let night = events
+        lock.unlock()
+        release()
+        return night
+    }
+
+    // MARK: - Private Methods
+
+    private func requestPermission() async -> Bool {
+        await withCheckedContinuation { continuation in
+            AVAudioSession.sharedInstance().requestRecordPermission { granted in
+                continuation.resume(returning: granted)
+            }
+        }
+    }
+
+    /// Runs on the tap's thread. Only the first channel is analyzed; the
+    /// microphone is mono.
+    private func process(_ buffer: AVAudioPCMBuffer) {
+        guard let samples = buffer.floatChannelData?[0], buffer.frameLength > 0 else { return }
+        lock.lock()
+        defer { lock.unlock() }
+        guard let detector = detector else { return }
+        SLPSoundEventDetectorProcess(detector, samples, Int(buffer.frameLength))
+        drain(detector)
+    }
+
+    /// Moves finished events into `events`; called with the lock held.
+    private func drain(_ detector: OpaquePointer) {
+        while true {
+            let count = scratch.withUnsafeMutableBufferPointer {
+                SLPSoundEventDetectorTakeEvents(detector, $0.baseAddress!, $0.count)
+            }
+            for event in scratch.prefix(count) {
+                events.append(SleepSoundEvent(event, since: startDate))
+            }
+            if count < scratch.count { return }
+        }
+    }
+
+    /// Puts back the playback category the sleep mix runs under
+    private func restorePlaybackSession() {
+        Task { @MainActor in
+            do {
+                try await AudioSessionManager.shared.configureSleepAudioSession()
+            } catch {
+                #if DEBUG
+                print("SleepSoundMonitor: playback session failed: \(error)")
+                #endif
+            }
+        }
+    }
+
+    private func release() {
+        lock.lock()
+        SLPSoundEventDetectorDestroy(detector)
+        detector = nil
+        lock.unlock()
+    }
+}
+
+// MARK: - Supporting Types
+
+struct SleepSoundEvent: Codable {
+    enum Kind: String, Codable {
+        case snoring
+        case talking
+        case coughing
+        case loudNoise
+    }
+
+    let kind: Kind
+    let date: Date
+    let duration: TimeInterval
+    /// dBFS of the loudest moment.
+    let peakLevel: Float
+}
+
+extension SleepSoundEvent {
+    /// A detector event, whose time counts from `start`.
+    init(_ event: SLPSoundEvent, since start: Date) {
+        self.init(
+            kind: Kind(event.kind),
+            date: start.addingTimeInterval(event.time),
+            duration: TimeInterval(event.duration),
+            peakLevel: event.peakLevel
+        )
+    }
+
+    /// A stored event, whose time is seconds since 1970.
+    init(stored event: SLPSoundEvent) {
+        self.init(
+            kind: Kind(event.kind),
+            date: Date(timeIntervalSince1970: event.time),
+            duration: TimeInterval(event.duration),
+            peakLevel: event.peakLevel
+        )
+    }
+
+    var storedEvent: SLPSoundEvent {
+        SLPSoundEvent(
+            kind: kind.detectorKind,
+            time: date.timeIntervalSince1970,
+            duration: Float(duration),
+            peakLevel: peakLevel
+        )
+    }
+}
+
+private extension SleepSoundEvent.Kind {
+    init(_ kind: SLPSoundEventKind) {
+        switch kind {
+        case SLPSoundEventSnoring: self = .snoring
+        case SLPSoundEventTalking: self = .talking
+        case SLPSoundEventCoughing: self = .coughing
+        default: self = .loudNoise
+        }
+    }
+
+    var detectorKind: SLPSoundEventKind {
+        switch self {
+        case .snoring: return SLPSoundEventSnoring
+        case .talking: return SLPSoundEventTalking
+        case .coughing: return SLPSoundEventCoughing
+        case .loudNoise: return SLPSoundEventLoudNoise
+        }
+    }
+}
@@ -26,6 +26,16 @@ class SleepTracker: ObservableObject {
     private let healthStore = HKHealthStore()
     private var cancellables = Set<AnyCancellable>()
     
+    /// Every stored session, in SleepsterCore's append-only log. Appends and
+    /// compaction run in order on `sessionLogQueue`.
+    private let sessionLog = SleepTracker.openSessionLog()
+    private let sessionLogQueue = DispatchQueue(label: "SleepTracker.sessionLog", qos: .utility)
+    
+    /// Running statistics over every sleep sample in HealthKit, fed by an
+    /// anchored query as samples are added and deleted
+    private let sleepStats = SLPSleepStatsCreate()
+    private var sleepStatsQuery: HKAnchoredObjectQuery?
+    
     // HealthKit types we need
     private let sleepAnalysisType = HKObjectType.categoryType(forIdentifier: .sleepAnalysis)!
     private let heartRateType = HKObjectType.quantityType(forIdentifier: .heartRate)!
@@ -61,6 +71,7 @@ class SleepTracker: ObservableObject {
             isAuthorized = authorizationStatus == .sharingAuthorized
             
             if isAuthorized {
+                startSleepStatsQuery()
                 await loadRecentSleepData()
                 await generateSleepInsights()
             }
@@ -90,6 +101,14 @@ class SleepTracker: ObservableObject {
         currentSleepSession = session
         isTracking = true
         
+        // Stored now so a night cut short by a crash is still on record;
+        // stopping stores it again, replacing this one
+        await storeSleepSession(session)
+        
+        // Listen for snoring, talking and coughing through the night
+        await SleepSoundMonitor.shared.start()
+        Analytics.shared.beginTimed(.sleepTracking)
+        
         // Save sleep analysis to HealthKit
         await saveSleepAnalysis(session, category: .inBed)
         
@@ -108,6 +127,10 @@ class SleepTracker: ObservableObject {
         session.endTime = Date()
         session.actualDuration = session.endTime!.timeIntervalSince(session.startTime)
         
+        let soundEvents = SleepSoundMonitor.shared.stop()
+        session.soundEvents = soundEvents.isEmpty ? nil : soundEvents
+        Analytics.shared.endTimed(.sleepTracking, .integer(.soundEvents, soundEvents.count))
+        
         currentSleepSession = session
         isTracking = false
         
@@ -169,35 +192,15 @@ class SleepTracker: ObservableObject {
         guard isAuthorized else { return nil }
         
         let (startDate, endDate) = period.dateRange
-        let predicate = HKQuery.predicateForSamples(withStart: startDate, end: endDate, options: .strictStartDate)
+        let summary = sleepSummary(from: startDate, to: endDate)
         
-        return await withCheckedContinuation { continuation in
-            let query = HKSampleQuery(
-                sampleType: sleepAnalysisType,
-                predicate: predicate,
-                limit: HKObjectQueryNoLimit,
-                sortDescriptors: nil
-            ) { _, samples, error in
-                
-                if let error = error {
-                    print("Error fetching sleep statistics: \(error)")
-                    continuation.resume(returning: nil)
-                    return
-                }
-                
-                guard let sleepSamples = samples as? [HKCategorySample] else {
-                    continuation.resume(returning: nil)
-                    return
-                }
-                
-                Task { @MainActor in
-                    let statistics = self.calculateSleepStatistics(from: sleepSamples, period: period)
-                    continuation.resume(returning: statistics)
-                }
-            }
-            
-            healthStore.execute(query)
-        }
+        return SleepStatistics(
+            period: period,
+            totalSleepTime: summary.totalAsleep,
+            averageSleepTime: summary.averageAsleep,
+            sleepEfficiency: summary.efficiency,
+            numberOfSessions: Int(summary.asleepCount)
+        )
     }
     
     // MARK: - Private Methods
@@ -214,6 +217,80 @@ class SleepTracker: ObservableObject {
             .store(in: &cancellables)
     }
     
+    // MARK: - Statistics
+    
+    /// Streams every sleep sample into `sleepStats`: the whole history on
+    /// the first delivery, then only what is added or deleted.
+    private func startSleepStatsQuery() {
+        guard sleepStatsQuery == nil else { return }
+        
+        let handler: (HKAnchoredObjectQuery, [HKSample]?, [HKDeletedObject]?, HKQueryAnchor?, Error?) -> Void = {
+            [weak self] _, samples, deletedObjects, _, error in
+            
+            if let error = error {
+                print("Error fetching sleep statistics: \(error)")
+                return
+            }
+            
+            let sleepSamples = samples as? [HKCategorySample] ?? []
+            let deleted = deletedObjects ?? []
+            
+            Task { @MainActor in
+                self?.applySleepSamples(sleepSamples, deleted: deleted)
+            }
+        }
+        
+        let query = HKAnchoredObjectQuery(
+            type: sleepAnalysisType,
+            predicate: nil,
+            anchor: nil,
+            limit: HKObjectQueryNoLimit,
+            resultsHandler: handler
+        )
+        query.updateHandler = handler
+        sleepStatsQuery = query
+        healthStore.execute(query)
+    }
+    
+    private func applySleepSamples(_ samples: [HKCategorySample], deleted: [HKDeletedObject]) {
+        for object in deleted {
+            var uuid = object.uuid.uuid
+            withUnsafeBytes(of: &uuid) { bytes in
+                _ = SLPSleepStatsRemove(sleepStats, bytes.bindMemory(to: UInt8.self).baseAddress!)
+            }
+        }
+        
+        for sample in samples {
+            let category: SLPSleepCategory
+            switch HKCategoryValueSleepAnalysis(rawValue: sample.value) {
+            case .inBed: category = SLPSleepCategoryInBed
+            case .asleep: category = SLPSleepCategoryAsleep
+            default: continue
+            }
+            
+            var record = SLPSleepSample(
+                id: sample.uuid.uuid,
+                startTime: sample.startDate.timeIntervalSince1970,
+                endTime: sample.endDate.timeIntervalSince1970,
+                utcOffset: Int32(TimeZone.current.secondsFromGMT(for: sample.startDate)),
+                category: category
+            )
+            SLPSleepStatsAdd(sleepStats, &record)
+        }
+        
+        if !samples.isEmpty || !deleted.isEmpty {
+            Task { await generateSleepInsights() }
+        }
+    }
+    
+    /// Nights from the one holding `start` through the one holding `end`.
+    private func sleepSummary(from start: Date, to end: Date) -> SLPSleepSummary {
+        func night(of date: Date) -> Int64 {
+            SLPSleepStatsNightOf(date.timeIntervalSince1970, Int32(TimeZone.current.secondsFromGMT(for: date)))
+        }
+        return SLPSleepStatsGetRange(sleepStats, night(of: start), night(of: end))
+    }
+    
     private func saveSleepAnalysis(_ session: SleepSession, category: HKCategoryValueSleepAnalysis) async {
         let endTime = session.endTime ?? Date()
         
@@ -236,34 +313,60 @@ class SleepTracker: ObservableObject {
     }
     
     private func storeSleepSession(_ session: SleepSession) async {
-        // Store session in UserDefaults for local access
-        let encoder = JSONEncoder()
-        encoder.dateEncodingStrategy = .iso8601
-        
-        if (try? encoder.encode(session)) != nil {
-            var sessions = getStoredSessions()
-            sessions.append(session)
-            
-            // Keep only last 100 sessions
-            if sessions.count > 100 {
-                sessions = Array(sessions.suffix(100))
-            }
-            
-            if let sessionsData = try? encoder.encode(sessions) {
-                UserDefaults.standard.set(sessionsData, forKey: "StoredSleepSessions")
+        guard let log = sessionLog else { return }
+        await withCheckedContinuation { (continuation: CheckedContinuation<Void, Never>) in
+            sessionLogQueue.async {
+                let stored = session.withLogRecord { SLPSessionLogAppend(log, $0) }
+                if !stored {
+                    #if DEBUG
+                    print("⚠️ Failed to store sleep session \(session.id)")
+                    #endif
+                }
+                if SLPSessionLogNeedsCompaction(log) {
+                    SLPSessionLogCompact(log)
+                }
+                continuation.resume()
             }
         }
     }
     
     private func getStoredSessions() -> [SleepSession] {
-        guard let data = UserDefaults.standard.data(forKey: "StoredSleepSessions") else {
-            return []
+        guard let log = sessionLog else { return [] }
+        return sessionLogQueue.sync {
+            // Filled in by the log; SLPSleepSession has no empty value in Swift
+            let record = UnsafeMutablePointer<SLPSleepSession>.allocate(capacity: 1)
+            defer { record.deallocate() }
+            return (0..<SLPSessionLogGetCount(log)).compactMap { index in
+                SLPSessionLogGetSession(log, index, record) ? SleepSession(logRecord: record.pointee) : nil
+            }
         }
-        
-        let decoder = JSONDecoder()
-        decoder.dateDecodingStrategy = .iso8601
-        
-        return (try? decoder.decode([SleepSession].self, from: data)) ?? []
+    }
+    
+    /// Opens the log in Application Support, moving over the sessions the
+    /// app used to keep as one JSON array in UserDefaults.
+    private static func openSessionLog() -> OpaquePointer? {
+        guard let directory = try? FileManager.default.url(
+            for: .applicationSupportDirectory,
+            in: .userDomainMask,
+            appropriateFor: nil,
+            create: true
+        ) else { return nil }
+        let path = directory.appendingPathComponent("Sessions.slog").path
+        guard let log = SLPSessionLogOpen(path) else { return nil }
+        
+        let legacyKey = "StoredSleepSessions"
+        if let data = UserDefaults.standard.data(forKey: legacyKey) {
+            let decoder = JSONDecoder()
+            decoder.dateDecodingStrategy = .iso8601
+            let sessions = (try? decoder.decode([SleepSession].self, from: data)) ?? []
+            let moved = sessions.allSatisfy { session in
+                session.withLogRecord { SLPSessionLogAppend(log, $0) }
+            }
+            if moved {
+                UserDefaults.standard.removeObject(forKey: legacyKey)
+            }
+        }
+        return log
     }
     
     private func processSleepSamples(_ samples: [HKCategorySample]) {
@@ -287,72 +390,33 @@ class SleepTracker: ObservableObject {
     }
     
     private func generateSleepInsights() async {
-        guard !recentSleepData.isEmpty else { return }
+        let endDate = Date()
+        let startDate = Calendar.current.date(byAdding: .day, value: -30, to: endDate)!
+        let summary = sleepSummary(from: startDate, to: endDate)
+        guard summary.asleepCount > 0 || summary.inBedCount > 0 else { return }
         
         let insights = SleepInsights(
-            averageSleepDuration: calculateAverageSleepDuration(),
-            sleepEfficiency: calculateSleepEfficiency(),
-            bedtimeConsistency: calculateBedtimeConsistency(),
-            recommendations: generateRecommendations()
+            averageSleepDuration: summary.averageAsleep,
+            sleepEfficiency: summary.efficiency,
+            bedtimeConsistency: summary.bedtimeConsistency,
+            recommendations: generateRecommendations(for: summary)
         )
         
         sleepInsights = insights
     }
     
-    private func calculateAverageSleepDuration() -> TimeInterval {
-        let asleepData = recentSleepData.filter { $0.category == .asleep }
-        guard !asleepData.isEmpty else { return 0 }
-        
-        let totalDuration = asleepData.reduce(0) { $0 + $1.duration }
-        return totalDuration / Double(asleepData.count)
-    }
-    
-    private func calculateSleepEfficiency() -> Double {
-        let asleepData = recentSleepData.filter { $0.category == .asleep }
-        let inBedData = recentSleepData.filter { $0.category == .inBed }
-        
-        guard !asleepData.isEmpty, !inBedData.isEmpty else { return 0 }
-        
-        let totalAsleepTime = asleepData.reduce(0) { $0 + $1.duration }
-        let totalInBedTime = inBedData.reduce(0) { $0 + $1.duration }
-        
-        return totalInBedTime > 0 ? (totalAsleepTime / totalInBedTime) * 100 : 0
-    }
-    
-    private func calculateBedtimeConsistency() -> Double {
-        let bedtimes = recentSleepData
-            .filter { $0.category == .inBed }
-            .map { Calendar.current.component(.hour, from: $0.startTime) }
-        
-        guard bedtimes.count > 1 else { return 100 }
-        
-        let average = bedtimes.reduce(0, +) / bedtimes.count
-        let variance = bedtimes.reduce(0) { sum, bedtime in
-            sum + pow(Double(bedtime - average), 2)
-        } / Double(bedtimes.count)
-        
-        let standardDeviation = sqrt(variance)
-        
-        // Convert to consistency percentage (lower deviation = higher consistency)
-        return max(0, 100 - (standardDeviation * 10))
-    }
-    
-    private func generateRecommendations() -> [String] {
+    private func generateRecommendations(for summary: SLPSleepSummary) -> [String] {
         var recommendations: [String] = []
         
-        let avgDuration = calculateAverageSleepDuration()
-        let efficiency = calculateSleepEfficiency()
-        let consistency = calculateBedtimeConsistency()
-        
-        if avgDuration < 7 * 3600 { // Less than 7 hours
+        if summary.averageAsleep < 7 * 3600 { // Less than 7 hours
             recommendations.append("Try to get at least 7-9 hours of sleep per night")
         }
         
-        if efficiency < 80 {
+        if summary.efficiency < 80 {
             recommendations.append("Consider adjusting your sleep environment to improve sleep efficiency")
         }
         
-        if consistency < 70 {
+        if summary.bedtimeConsistency < 70 {
             recommendations.append("Try to maintain a consistent bedtime schedule")
         }
         
@@ -363,25 +427,6 @@ class SleepTracker: ObservableObject {
         return recommendations
     }
     
-    private func calculateSleepStatistics(from samples: [HKCategorySample], period: StatisticsPeriod) -> SleepStatistics {
-        let asleepSamples = samples.filter { $0.value == HKCategoryValueSleepAnalysis.asleep.rawValue }
-        let inBedSamples = samples.filter { $0.value == HKCategoryValueSleepAnalysis.inBed.rawValue }
-        
-        let totalSleepTime = asleepSamples.reduce(0) { $0 + $1.endDate.timeIntervalSince($1.startDate) }
-        let totalInBedTime = inBedSamples.reduce(0) { $0 + $1.endDate.timeIntervalSince($1.startDate) }
-        
-        let avgSleepTime = asleepSamples.isEmpty ? 0 : totalSleepTime / Double(asleepSamples.count)
-        let efficiency = totalInBedTime > 0 ? (totalSleepTime / totalInBedTime) * 100 : 0
-        
-        return SleepStatistics(
-            period: period,
-            totalSleepTime: totalSleepTime,
-            averageSleepTime: avgSleepTime,
-            sleepEfficiency: efficiency,
-            numberOfSessions: asleepSamples.count
-        )
-    }
-    
     private func getCurrentAudioSettings() -> AudioSettings {
         return AudioSettings(
             masterVolume: AudioMixingEngine.shared.masterVolume,
@@ -403,6 +448,9 @@ struct SleepSession: Codable, Identifiable {
     var soundsUsed: [String]
     var backgroundUsed: String?
     let audioSettings: AudioSettings
+    /// What the microphone heard; nil when nothing was detected or the
+    /// night was not monitored.
+    var soundEvents: [SleepSoundEvent]? = nil
     
     var duration: TimeInterval {
         return actualDuration ?? (endTime?.timeIntervalSince(startTime) ?? Date().timeIntervalSince(startTime))
@@ -413,6 +461,78 @@ struct SleepSession: Codable, Identifiable {
     }
 }
 
+// MARK: - Session Log Records
+
+extension SleepSession {
+    /// Calls `body` with the session as a log record. Its strings live until
+    /// `body` returns.
+    fileprivate func withLogRecord<T>(_ body: (UnsafePointer<SLPSleepSession>) -> T) -> T {
+        var owned: [UnsafeMutablePointer<CChar>] = []
+        defer { owned.forEach { free($0) } }
+        func copy(_ string: String) -> UnsafePointer<CChar> {
+            let pointer = strdup(string)!
+            owned.append(pointer)
+            return UnsafePointer(pointer)
+        }
+        
+        let sounds = soundsUsed.map(copy)
+        let active = audioSettings.activeSounds.map(copy)
+        let background = backgroundUsed.map(copy)
+        let preset = copy(audioSettings.equalizerPreset)
+        let events = (soundEvents ?? []).map(\.storedEvent)
+        return sounds.withUnsafeBufferPointer { soundsBuffer in
+            active.withUnsafeBufferPointer { activeBuffer in
+                events.withUnsafeBufferPointer { eventsBuffer in
+                    var record = SLPSleepSession(
+                        id: id.uuid,
+                        startTime: startTime.timeIntervalSince1970,
+                        endTime: endTime?.timeIntervalSince1970 ?? .nan,
+                        expectedDuration: expectedDuration,
+                        actualDuration: actualDuration ?? .nan,
+                        soundsUsed: soundsBuffer.baseAddress,
+                        soundsUsedCount: sounds.count,
+                        backgroundUsed: background,
+                        masterVolume: audioSettings.masterVolume,
+                        activeSounds: activeBuffer.baseAddress,
+                        activeSoundsCount: active.count,
+                        equalizerPreset: preset,
+                        effectsEnabled: audioSettings.effectsEnabled,
+                        soundEvents: eventsBuffer.baseAddress,
+                        soundEventsCount: events.count
+                    )
+                    return body(&record)
+                }
+            }
+        }
+    }
+    
+    fileprivate init(logRecord record: SLPSleepSession) {
+        func strings(_ pointers: UnsafePointer<UnsafePointer<CChar>>?, _ count: Int) -> [String] {
+            guard let pointers = pointers else { return [] }
+            return (0..<count).map { String(cString: pointers[$0]) }
+        }
+        
+        self.init(
+            id: UUID(uuid: record.id),
+            startTime: Date(timeIntervalSince1970: record.startTime),
+            endTime: record.endTime.isNaN ? nil : Date(timeIntervalSince1970: record.endTime),
+            expectedDuration: record.expectedDuration,
+            actualDuration: record.actualDuration.isNaN ? nil : record.actualDuration,
+            soundsUsed: strings(record.soundsUsed, record.soundsUsedCount),
+            backgroundUsed: record.backgroundUsed.map { String(cString: $0) },
+            audioSettings: AudioSettings(
+                masterVolume: record.masterVolume,
+                activeSounds: strings(record.activeSounds, record.activeSoundsCount),
+                equalizerPreset: String(cString: record.equalizerPreset),
+                effectsEnabled: record.effectsEnabled
+            ),
+            soundEvents: record.soundEvents.map { events in
+                (0..<record.soundEventsCount).map { SleepSoundEvent(stored: events[$0]) }
+            }
+        )
+    }
+}
+
 struct SleepData: Identifiable {
     let id: UUID
     let date: Date
@@ -0,0 +1,203 @@
+//
+//  StaticLayers.swift
+//  SleepMate
+//
+//  Parts of the animated backgrounds that do not change while they are on
+//  screen (hills, grass, star sprites), rasterized once by SleepsterCore
+//  from a seed. Views show them as plain images, so a body evaluation no
+//  longer rebuilds and re-randomizes dozens of gradient-filled shapes. The
+//  images are kept in an NSCache keyed by background, theme, intensity and
+//  screen, which lets the system reclaim them under memory pressure.
+//
+
+import SwiftUI
+import UIKit
+
+/// A rasterized layer and where it goes, in points.
+final class StaticLayerImage {
+    let image: CGImage
+    let frame: CGRect
+    let scale: CGFloat
+
+    fileprivate init(image: CGImage, frame: CGRect, scale: CGFloat) {
+        self.image = image
+        self.frame = frame
+        self.scale = scale
+    }
+}
+
+/// Star sprites of evenly spaced sizes, from smallest to largest.
+final class StarSprites {
+    let images: [CGImage]
+    let sizes: ClosedRange<CGFloat>
+    let scale: CGFloat
+
+    fileprivate init(images: [CGImage], sizes: ClosedRange<CGFloat>, scale: CGFloat) {
+        self.images = images
+        self.sizes = sizes
+        self.scale = scale
+    }
+
+    /// The sprite closest to a star `size` points across
+    func image(forSize size: CGFloat) -> CGImage {
+        let span = sizes.upperBound - sizes.lowerBound
+        let position = span > 0 ? (size - sizes.lowerBound) / span : 0
+        let index = Int((position * CGFloat(images.count - 1)).rounded())
+        return images[min(max(index, 0), images.count - 1)]
+    }
+}
+
+enum StaticLayers {
+    private static let cache = NSCache<NSString, AnyObject>()
+
+    /// The same seed on every launch for the same parts (String.hashValue
+    /// is randomized per process)
+    static func seed(_ parts: String...) -> UInt64 {
+        var hash: UInt64 = 0xcbf29ce484222325
+        for byte in parts.joined(separator: "|").utf8 {
+            hash = (hash ^ UInt64(byte)) &* 0x100000001b3
+        }
+        return hash
+    }
+
+    /// Cache key for a layer of `background` on the current screen; reads
+    /// UIScreen, so call it on the main actor
+    static func key(_ background: String, _ parts: CustomStringConvertible...) -> String {
+        let bounds = UIScreen.main.bounds
+        let screen = "\(Int(bounds.width))x\(Int(bounds.height))@\(UIScreen.main.scale)"
+        return ([background] + parts.map { $0.description } + [screen]).joined(separator: "|")
+    }
+
+    // The builders below run off the main actor, so the screen's width and
+    // scale come in as parameters rather than from UIScreen.
+
+    /// Hills back to front in a layer spanning `top`...`bottom`
+    static func hills(key: String, width: CGFloat, top: CGFloat, bottom: CGFloat, scale: CGFloat,
+                      hills: [SLPHillConfig]) -> StaticLayerImage? {
+        cached(key) {
+            let layer = hills.withUnsafeBufferPointer { buffer in
+                SLPStaticLayerCreateHills(Float(width), Float(top), Float(bottom), Float(scale),
+                                          buffer.baseAddress!, UInt32(buffer.count))
+            }
+            return makeImage(layer, scale: scale)
+        }
+    }
+
+    /// A row of grass `width` points wide; `config.seed`, `width` and
+    /// `scale` are filled in here
+    static func grass(key: String, _ config: SLPGrassConfig, width: CGFloat, scale: CGFloat) -> StaticLayerImage? {
+        cached(key) {
+            var config = config
+            config.seed = seed(key)
+            config.width = Float(width)
+            config.scale = Float(scale)
+            return makeImage(SLPStaticLayerCreateGrass(config), scale: scale)
+        }
+    }
+
+    /// Star sprites; `config.scale` is filled in here
+    static func starSprites(key: String, _ config: SLPStarSpriteConfig, scale: CGFloat) -> StarSprites? {
+        cached(key) {
+            var config = config
+            config.scale = Float(scale)
+            var cell: UInt32 = 0
+            let layer = SLPStaticLayerCreateStarSprites(config, &cell)
+            defer { SLPStaticLayerDestroy(layer) }
+            guard let strip = cgImage(layer) else { return nil }
+            let images = (0..<Int(strip.width) / Int(cell)).compactMap { index in
+                strip.cropping(to: CGRect(x: index * Int(cell), y: 0, width: Int(cell), height: Int(cell)))
+            }
+            guard !images.isEmpty else { return nil }
+            return StarSprites(
+                images: images,
+                sizes: CGFloat(config.size.min)...CGFloat(config.size.max),
+                scale: scale
+            )
+        }
+    }
+
+    private static func cached<T: AnyObject>(_ key: String, build: () -> T?) -> T? {
+        if let hit = cache.object(forKey: key as NSString) as? T {
+            return hit
+        }
+        guard let built = build() else { return nil }
+        cache.setObject(built, forKey: key as NSString)
+        return built
+    }
+
+    /// Copies the layer into an image and destroys it
+    private static func makeImage(_ layer: OpaquePointer, scale: CGFloat) -> StaticLayerImage? {
+        defer { SLPStaticLayerDestroy(layer) }
+        guard let image = cgImage(layer) else { return nil }
+        let frame = SLPStaticLayerGetFrame(layer)
+        return StaticLayerImage(
+            image: image,
+            frame: CGRect(x: CGFloat(frame.x), y: CGFloat(frame.y),
+                          width: CGFloat(frame.width), height: CGFloat(frame.height)),
+            scale: scale
+        )
+    }
+
+    private static func cgImage(_ layer: OpaquePointer) -> CGImage? {
+        let width = Int(SLPStaticLayerGetPixelWidth(layer))
+        let height = Int(SLPStaticLayerGetPixelHeight(layer))
+        guard width > 0, height > 0, let pixels = SLPStaticLayerGetPixels(layer) else { return nil }
+        let data = Data(bytes: pixels, count: width * height * 4)
+        guard let provider = CGDataProvider(data: data as CFData) else { return nil }
+        return CGImage(
+            width: width,
+            height: height,
+            bitsPerComponent: 8,
+            bitsPerPixel: 32,
+            bytesPerRow: width * 4,
+            space: CGColorSpaceCreateDeviceRGB(),
+            bitmapInfo: CGBitmapInfo(rawValue: CGImageAlphaInfo.premultipliedLast.rawValue),
+            provider: provider,
+            decode: nil,
+            shouldInterpolate: true,
+            intent: .defaultIntent
+        )
+    }
+}
+
+extension StaticLayerImage {
+    /// The layer at its place in a full-screen ZStack
+    var view: some View {
+        Image(decorative: image, scale: scale)
+            .position(x: frame.midX, y: frame.midY)
+    }
+}
+
+/// Sways a layer sideways by `amplitude * sin(phase)`. Animating `phase`
+/// moves the layer without evaluating the view's body.
+struct SwayEffect: GeometryEffect {
+    var phase: Double
+    var amplitude: CGFloat
+
+    var animatableData: Double {
+        get { phase }
+        set { phase = newValue }
+    }
+
+    func effectValue(size: CGSize) -> ProjectionTransform {
+        ProjectionTransform(CGAffineTransform(translationX: amplitude * CGFloat(sin(phase)), y: 0))
+    }
+}
+
+extension SLPColor {
+    init(_ color: Color, opacity: Double = 1) {
+        var red: CGFloat = 0, green: CGFloat = 0, blue: CGFloat = 0, alpha: CGFloat = 0
+        UIColor(color).getRed(&red, green: &green, blue: &blue, alpha: &alpha)
+        self.init(r: Float(red), g: Float(green), b: Float(blue), a: Float(alpha * CGFloat(opacity)))
+    }
+
+    static let clear = SLPColor(r: 0, g: 0, b: 0, a: 0)
+}
+
+extension SLPGradient {
+    /// Up to three evenly spaced stops
+    init(_ colors: [SLPColor]) {
+        let stops = Array(colors.prefix(3)) + Array(repeating: SLPColor.clear, count: max(0, 3 - colors.count))
+        self.init(stops: (stops[0], stops[1], stops[2]), count: UInt32(min(max(colors.count, 1), 3)))
+    }
+}
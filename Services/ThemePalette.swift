@@ -0,0 +1,122 @@
+//
+//  ThemePalette.swift
+//  SleepMate
+//
+//  The background colours for one colour theme, dimmed state and intensity
+//  tier, converted once from SleepsterCore's packed palette into SwiftUI
+//  colours and gradients. View bodies index into it instead of switching on
+//  the theme and building `.opacity(dimmed ? x : y)` colour arrays for every
+//  element on every frame. Gradients whose opacity follows an element
+//  (clouds, bubbles, crystals) are kept at 256 alpha levels, built the first
+//  time they are asked for. Main thread only, like the views using it.
+//
+
+import SwiftUI
+
+final class ThemePalette {
+    private static let levelCount = Int(SLPPaletteRampSize)
+    private static var palettes = [ThemePalette?](repeating: nil, count: 4 * 2 * Int(SLPPaletteTierCount))
+
+    /// The shared palette for a view's settings
+    static func palette(for theme: ColorTheme, dimmed: Bool, intensity: Float) -> ThemePalette {
+        let tier = SLPPaletteTier(intensity)
+        let index = (Int(theme.paletteTheme.rawValue) * 2 + (dimmed ? 1 : 0)) * Int(SLPPaletteTierCount) + Int(tier)
+        if let palette = palettes[index] {
+            return palette
+        }
+        let palette = ThemePalette(theme: theme.paletteTheme, dimmed: dimmed, tier: tier)
+        palettes[index] = palette
+        return palette
+    }
+
+    private let theme: SLPPaletteTheme
+    private let dimmed: Bool
+    private let tier: UInt32
+    private let swatches: [Color]
+    private let stops: [[UInt32]]
+    private let gradients: [Gradient]
+    private var levels: [UInt32: [Gradient]] = [:]
+    private var ramps: [UInt32: [Color]] = [:]
+
+    private init(theme: SLPPaletteTheme, dimmed: Bool, tier: UInt32) {
+        self.theme = theme
+        self.dimmed = dimmed
+        self.tier = tier
+        swatches = [SLPSwatchSheepBody, SLPSwatchAccent, SLPSwatchAccentStroke].map {
+            Self.color(SLPPaletteGetSwatch(theme, dimmed, tier, $0))
+        }
+        stops = (0...SLPPaletteGradientCrystal.rawValue).map { index in
+            let stops = SLPPaletteGetStops(theme, dimmed, tier, SLPPaletteGradient(rawValue: index))
+            let colors = [stops.colors.0, stops.colors.1, stops.colors.2, stops.colors.3]
+            return Array(colors.prefix(Int(stops.count)))
+        }
+        gradients = stops.map { Gradient(colors: $0.map { Self.color($0) }) }
+    }
+
+    // MARK: - Lookups
+
+    func color(_ swatch: SLPSwatch) -> Color {
+        swatches[Int(swatch.rawValue)]
+    }
+
+    func gradient(_ gradient: SLPPaletteGradient) -> Gradient {
+        gradients[Int(gradient.rawValue)]
+    }
+
+    /// The gradient with every stop's opacity scaled by `level`, 0...1, to
+    /// the nearest of 256
+    func gradient(_ gradient: SLPPaletteGradient, level: Double) -> Gradient {
+        let table = levels[gradient.rawValue] ?? buildLevels(gradient)
+        return table[Self.index(level)]
+    }
+
+    /// The colour at `position` 0...1 along the gradient, to the nearest of 256
+    func color(_ gradient: SLPPaletteGradient, at position: Double) -> Color {
+        let ramp = ramps[gradient.rawValue] ?? buildRamp(gradient)
+        return ramp[Self.index(position)]
+    }
+
+    // MARK: - Private Methods
+
+    private func buildLevels(_ gradient: SLPPaletteGradient) -> [Gradient] {
+        let stops = self.stops[Int(gradient.rawValue)]
+        let table = (0..<Self.levelCount).map { level in
+            Gradient(colors: stops.map { Self.color($0, opacity: Double(level) / Double(Self.levelCount - 1)) })
+        }
+        levels[gradient.rawValue] = table
+        return table
+    }
+
+    private func buildRamp(_ gradient: SLPPaletteGradient) -> [Color] {
+        let samples = SLPPaletteGetRamp(theme, dimmed, tier, gradient)
+        let ramp = UnsafeBufferPointer(start: samples, count: Self.levelCount).map { Self.color($0) }
+        ramps[gradient.rawValue] = ramp
+        return ramp
+    }
+
+    private static func index(_ fraction: Double) -> Int {
+        guard fraction > 0 else { return 0 }
+        return min(Int(fraction * Double(levelCount - 1) + 0.5), levelCount - 1)
+    }
+
+    /// A packed 0xRRGGBBAA colour, its alpha scaled by `opacity`
+    private static func color(_ packed: UInt32, opacity: Double = 1) -> Color {
+        let scale = 1.0 / 255.0
+        return Color(.sRGB,
+                     red: Double(packed >> 24) * scale,
+                     green: Double((packed >> 16) & 0xFF) * scale,
+                     blue: Double((packed >> 8) & 0xFF) * scale,
+                     opacity: Double(packed & 0xFF) * scale * opacity)
+    }
+}
+
+extension ColorTheme {
+    var paletteTheme: SLPPaletteTheme {
+        switch self {
+        case .defaultTheme: return SLPPaletteThemeDefault
+        case .warm: return SLPPaletteThemeWarm
+        case .cool: return SLPPaletteThemeCool
+        case .monochrome: return SLPPaletteThemeMonochrome
+        }
+    }
+}
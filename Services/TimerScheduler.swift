@@ -0,0 +1,160 @@
+//
+//  TimerScheduler.swift
+//  SleepMate
+//
+//  One dispatch timer for the app's delayed and periodic work. Callers give
+//  each timer a tolerance; SleepsterCore's timer wheel fires timers whose
+//  windows overlap on the same wakeup, and while the screen is off it
+//  stretches those windows so the night costs a few wakeups a minute.
+//  Handlers run on the main queue; scheduling and cancelling are safe from
+//  any thread.
+//
+
+import Foundation
+import UIKit
+
+final class TimerScheduler {
+    static let shared = TimerScheduler()
+
+    struct Token: Hashable {
+        fileprivate let id: SLPTimerID
+    }
+
+    private struct Entry {
+        let repeats: Bool
+        let handler: () -> Void
+    }
+
+    private let lock = NSLock()
+    private let wheel: OpaquePointer
+    private let source: DispatchSourceTimer
+    private let origin = DispatchTime.now().uptimeNanoseconds
+    private var entries: [SLPTimerID: Entry] = [:]
+    private var armedFor = Double.infinity
+    private var observers: [NSObjectProtocol] = []
+
+    private init() {
+        wheel = SLPTimerWheelCreate(0)
+        source = DispatchSource.makeTimerSource(queue: .main)
+        source.setEventHandler { [weak self] in
+            self?.fire()
+        }
+        source.schedule(deadline: .distantFuture)
+        source.activate()
+        observeScreen()
+    }
+
+    // MARK: - Scheduling
+
+    /// Runs `handler` once, `delay` from now and at most `tolerance` later.
+    /// With `interval`, it repeats on that period until cancelled. Critical
+    /// timers keep their tolerance while the screen is off.
+    @discardableResult
+    func schedule(
+        after delay: TimeInterval,
+        repeating interval: TimeInterval = 0,
+        tolerance: TimeInterval,
+        critical: Bool = false,
+        _ handler: @escaping () -> Void
+    ) -> Token {
+        lock.lock()
+        defer { lock.unlock() }
+        let id = SLPTimerWheelSchedule(wheel, now() + max(0, delay), max(0, interval), tolerance, critical)
+        entries[id] = Entry(repeats: interval > 0, handler: handler)
+        rearm()
+        return Token(id: id)
+    }
+
+    func cancel(_ token: Token?) {
+        guard let token = token else { return }
+        lock.lock()
+        defer { lock.unlock() }
+        if SLPTimerWheelCancel(wheel, token.id) {
+            entries.removeValue(forKey: token.id)
+            rearm()
+        }
+    }
+
+    /// Stretches the tolerance of non-critical timers; set while the screen
+    /// is off.
+    var lowPower: Bool = false {
+        didSet {
+            lock.lock()
+            defer { lock.unlock() }
+            SLPTimerWheelSetLowPower(wheel, lowPower)
+            rearm()
+        }
+    }
+
+    var metrics: SLPTimerWheelMetrics {
+        lock.lock()
+        defer { lock.unlock() }
+        return SLPTimerWheelGetMetrics(wheel)
+    }
+
+    // MARK: - Firing
+
+    private func now() -> Double {
+        Double(DispatchTime.now().uptimeNanoseconds - origin) / 1e9
+    }
+
+    private func fire() {
+        lock.lock()
+        var fired: UnsafePointer<SLPTimerID>?
+        let count = SLPTimerWheelAdvance(wheel, now(), &fired)
+        var handlers: [() -> Void] = []
+        handlers.reserveCapacity(count)
+        for index in 0..<count {
+            guard let id = fired?[index], let entry = entries[id] else { continue }
+            if !entry.repeats {
+                entries.removeValue(forKey: id)
+            }
+            handlers.append(entry.handler)
+        }
+        armedFor = .infinity
+        rearm()
+        lock.unlock()
+
+        for handler in handlers {
+            handler()
+        }
+    }
+
+    /// Points the dispatch timer at the wheel's next wakeup. Coalescing is
+    /// the wheel's job, so the dispatch timer gets no leeway of its own.
+    private func rearm() {
+        let next = SLPTimerWheelGetNextWakeup(wheel)
+        guard next != armedFor else { return }
+        armedFor = next
+        if next.isInfinite {
+            source.schedule(deadline: .distantFuture)
+        } else {
+            let deadline = DispatchTime(uptimeNanoseconds: origin + UInt64(max(0, next) * 1e9))
+            source.schedule(deadline: deadline, leeway: .milliseconds(1))
+        }
+    }
+
+    // MARK: - Screen
+
+    private func observeScreen() {
+        let center = NotificationCenter.default
+        let off: [Notification.Name] = [
+            UIApplication.protectedDataWillBecomeUnavailableNotification,
+            UIApplication.didEnterBackgroundNotification,
+        ]
+        let on: [Notification.Name] = [
+            UIApplication.protectedDataDidBecomeAvailableNotification,
+            UIApplication.willEnterForegroundNotification,
+        ]
+        for name in off {
+            observers.append(center.addObserver(forName: name, object: nil, queue: .main) { [weak self] _ in
+                self?.lowPower = true
+            })
+        }
+        for name in on {
+            observers.append(center.addObserver(forName: name, object: nil, queue: .main) { [weak self] _ in
+                self?.lowPower = false
+            })
+        }
+    }
+}
@@ -0,0 +1,78 @@
+//
+//  Tracing.swift
+//  SleepMate
+//
+//  Spans and counters for the app, recorded into the same per-thread rings
+//  as the spans SleepsterCore takes around mixing, effects and particles,
+//  and exported together as Chrome trace-event JSON. Off unless launched
+//  with `-SLPTracing YES`; while off a span only reads a flag. Names are
+//  StaticStrings because the trace keeps their pointers, not copies.
+//
+
+import Foundation
+
+enum Tracing {
+    typealias Category = SLPTraceCategory
+
+    static var isEnabled: Bool {
+        get { SLPTraceIsEnabled() }
+        set {
+            SLPTraceSetEnabled(newValue)
+            if newValue && Thread.isMainThread {
+                SLPTraceSetThreadName("main")
+            }
+        }
+    }
+
+    /// Follows the `SLPTracing` launch argument or default
+    static func configureFromDefaults() {
+        if UserDefaults.standard.bool(forKey: "SLPTracing") {
+            isEnabled = true
+        }
+    }
+
+    /// Times `body` as a span named `name`
+    @inline(__always)
+    static func span<T>(_ category: Category, _ name: StaticString, _ body: () throws -> T) rethrows -> T {
+        let begin = SLPTraceBegin()
+        defer {
+            if begin != 0 {
+                SLPTraceEnd(category, pointer(to: name), begin)
+            }
+        }
+        return try body()
+    }
+
+    static func counter(_ category: Category, _ name: StaticString, _ value: Double) {
+        guard isEnabled else { return }
+        SLPTraceCounter(category, pointer(to: name), value)
+    }
+
+    /// Writes what has been recorded to trace.json in Caches. Builds the
+    /// whole file in memory, so call it off the main thread.
+    @discardableResult
+    static func export() -> URL? {
+        guard isEnabled,
+              let directory = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask).first
+        else { return nil }
+        let url = directory.appendingPathComponent("trace.json")
+        guard SLPTraceExportChromeJson(url.path) else { return nil }
+        #if DEBUG
+        print("🧭 Trace written to \(url.path)")
+        #endif
+        return url
+    }
+
+    // MARK: - Private Methods
+
+    private static func pointer(to name: StaticString) -> UnsafePointer<CChar> {
+        UnsafeRawPointer(name.utf8Start).assumingMemoryBound(to: CChar.self)
+    }
+}
+
+extension SLPTraceCategory {
+    static let audio = SLPTraceCategoryAudio
+    static let animation = SLPTraceCategoryAnimation
+    static let storage = SLPTraceCategoryStorage
+    static let app = SLPTraceCategoryApp
+}
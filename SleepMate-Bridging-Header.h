@@ -15,6 +15,9 @@
 // MARK: - Utility (legacy singleton pattern)
 #import "SynthesizeSingleton.h"
 
+// MARK: - Native Core (C interface to SleepsterCore)
+#import "SleepsterCore/include/SleepsterCore.h"
+
 // MARK: - System Frameworks
 #import <AVFoundation/AVFoundation.h>
 #import <CoreData/CoreData.h>
@@ -43,16 +43,18 @@ struct SleepsterApp: App {
     
     private func setupApp() {
         NSLog("📱 SleepsterApp: setupApp() called")
+        Tracing.configureFromDefaults()
         // Pass dependencies to app delegate
         appDelegate.serviceContainer = serviceContainer
         appDelegate.appState = appState
         
-        // Initialize Core Data and heavy operations asynchronously
+        // Start services in dependency order, one phase at a time
+        let bootstrap = AppBootstrap.shared
+        bootstrap.registerServices(serviceContainer)
         Task {
-            NSLog("📱 SleepsterApp: Starting async initialization task")
-            // Initialize Core Data stack first
-            await serviceContainer.coreDataStack.initializeAsync()
-            NSLog("📱 SleepsterApp: Core Data initialization complete")
+            NSLog("📱 SleepsterApp: Starting critical services")
+            await bootstrap.run(.critical)
+            NSLog("📱 SleepsterApp: Critical services started")
             
             // Initialize color scheme to follow system setting (after Core Data is ready)
             await MainActor.run {
@@ -60,15 +62,8 @@ struct SleepsterApp: App {
                 NSLog("📱 SleepsterApp: Color scheme initialized to follow system setting")
             }
             
-            // Initialize database population in background (non-blocking)
-            Task.detached(priority: .background) {
-                await serviceContainer.databaseManager.prePopulate()
-            }
-            
-            // Setup audio session in background
-            Task.detached(priority: .utility) {
-                await serviceContainer.audioManager.setupAudioSession()
-            }
+            await bootstrap.run(.firstFrame)
+            await bootstrap.run(.idle)
         }
     }
     
@@ -154,6 +149,10 @@ struct ContentView: View {
             .onReceive(NotificationCenter.default.publisher(for: UIApplication.willResignActiveNotification)) { _ in
                 // Handle app going to background
                 serviceContainer.audioManager.handleAppWillResignActive()
+                DispatchQueue.global(qos: .utility).async {
+                    Analytics.shared.flush()
+                    Tracing.export()
+                }
             }
     }
 }
\ No newline at end of file
@@ -0,0 +1,136 @@
+//
+//  AnalyticsBench.cpp
+//  SleepsterCore
+//
+//  Cost of logging an event with three parameters, per call, as the number
+//  of producer threads grows. Two ways:
+//
+//  - dictionary: what a synchronous SDK call costs at the call site, at
+//    best: the parameters built into a fresh string-keyed map and handed
+//    over under a lock.
+//  - pipeline: `AnalyticsPipeline::logEvent` with interned names, while
+//    the flusher drains the ring into a file in the background. The ring
+//    holds a whole run, so every event is kept, however few cores there
+//    are for the flusher.
+//
+//  ns/event is CPU time on the logging thread, so threads that share a
+//  core are not charged for each other.
+//
+//  Usage: AnalyticsBench [events per thread]
+//
+
+#include "BenchUtil.hpp"
+
+#include "sleepster/Analytics.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace sleepster;
+using namespace sleepster::bench;
+
+namespace {
+
+struct Run {
+    double nsPerEvent = 0.0;
+    double eventsPerSecond = 0.0;
+    uint64_t dropped = 0;
+};
+
+double threadCpuSeconds() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+/// Runs `log(thread, i)` `count` times on each of `threads` threads, all
+/// released at once, and reports the mean CPU time per call.
+template <typename Log>
+Run measure(int threads, int count, Log log) {
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<double> seconds(static_cast<std::size_t>(threads));
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            const double start = threadCpuSeconds();
+            for (int i = 0; i < count; ++i) log(t, i);
+            seconds[static_cast<std::size_t>(t)] = threadCpuSeconds() - start;
+        });
+    }
+    while (ready.load() < threads) std::this_thread::yield();
+    const double start = nowSeconds();
+    go.store(true, std::memory_order_release);
+    for (std::thread& worker : workers) worker.join();
+    const double wall = nowSeconds() - start;
+
+    Run run;
+    double total = 0.0;
+    for (double s : seconds) total += s;
+    run.nsPerEvent = total / threads / count * 1e9;
+    run.eventsPerSecond = static_cast<double>(threads) * count / wall;
+    return run;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int count = argc > 1 ? std::atoi(argv[1]) : 200000;
+    const std::string path = "/tmp/sleepster_analytics_bench.jsonl";
+    const unsigned cores = std::thread::hardware_concurrency();
+
+    std::printf("%d events per thread, 3 parameters each, %u cores\n\n", count, cores);
+    std::printf("%-8s %-11s %10s %12s %9s\n", "threads", "logging", "ns/event", "events/s", "dropped");
+
+    for (int threads : {1, 2, 4, 8}) {
+        {
+            std::mutex lock;
+            std::vector<std::map<std::string, std::string>> delivered;
+            delivered.reserve(1024);
+            const Run run = measure(threads, count, [&](int thread, int i) {
+                std::map<std::string, std::string> parameters;
+                parameters["sound"] = "rain";
+                parameters["voices"] = std::to_string(thread);
+                parameters["volume"] = std::to_string(i);
+                std::lock_guard<std::mutex> guard(lock);
+                if (delivered.size() == 1024) delivered.clear();
+                delivered.push_back(std::move(parameters));
+            });
+            std::printf("%-8d %-11s %10.1f %12.3g %9s\n", threads, "dictionary", run.nsPerEvent,
+                        run.eventsPerSecond, "-");
+        }
+        {
+            std::remove(path.c_str());
+            AnalyticsConfig config;
+            config.capacity = static_cast<std::size_t>(threads) * count;
+            AnalyticsPipeline pipeline(AnalyticsFileSink::open(path), config);
+            const AnalyticsName event = pipeline.intern("sound_played");
+            const AnalyticsName sound = pipeline.intern("sound");
+            const AnalyticsName rain = pipeline.intern("rain");
+            const AnalyticsName voices = pipeline.intern("voices");
+            const AnalyticsName volume = pipeline.intern("volume");
+            Run run = measure(threads, count, [&](int thread, int i) {
+                const AnalyticsParameter parameters[] = {
+                    AnalyticsParameter::named(sound, rain),
+                    AnalyticsParameter::of(voices, static_cast<int64_t>(thread)),
+                    AnalyticsParameter::of(volume, static_cast<double>(i)),
+                };
+                pipeline.logEvent(event, parameters, 3);
+            });
+            pipeline.flush();
+            run.dropped = pipeline.metrics().dropped;
+            std::printf("%-8d %-11s %10.1f %12.3g %8.1f%%\n", threads, "pipeline", run.nsPerEvent,
+                        run.eventsPerSecond, 100.0 * static_cast<double>(run.dropped) / (threads * count));
+        }
+    }
+    std::remove(path.c_str());
+    return 0;
+}
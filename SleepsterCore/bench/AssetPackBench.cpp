@@ -0,0 +1,165 @@
+//
+//  AssetPackBench.cpp
+//  SleepsterCore
+//
+//  Time to first sample and CPU per voice for a sound played from the
+//  pre-decoded pack, against the streaming path the app uses for its MP3s
+//  and the older whole-file decode. Linux has no MP3 decoder here, so the
+//  streamed and whole-file cases decode 44.1 kHz 16-bit WAV and resample it
+//  to 48 kHz, as the app does; MP3 decoding on a device only adds to them.
+//
+//  "cold" runs drop the file from the page cache first, as after a reboot
+//  or memory pressure.
+//
+//  Usage: AssetPackBench [trackSeconds]
+//
+
+#include "BenchUtil.hpp"
+
+#include "sleepster/AssetPack.hpp"
+#include "sleepster/AssetPackWriter.hpp"
+#include "sleepster/StreamingSource.hpp"
+#include "sleepster/WavFile.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace sleepster;
+using namespace sleepster::bench;
+
+namespace {
+
+constexpr double kRate = 48000.0;
+constexpr double kTrackRate = 44100.0;
+constexpr std::size_t kBlock = 512;
+constexpr int kStarts = 25;
+constexpr double kRenderSeconds = 60.0;
+
+void evict(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+}
+
+/// Median over kStarts runs of `start`, which returns a ready source.
+template <typename Start>
+double medianMs(Start&& start, const std::string& evictPath) {
+    std::vector<double> times;
+    std::vector<float> left(kBlock), right(kBlock);
+    for (int i = 0; i < kStarts; ++i) {
+        if (!evictPath.empty()) evict(evictPath);
+        const double begin = nowSeconds();
+        std::unique_ptr<AudioSource> source = start();
+        source->render(left.data(), right.data(), kBlock);
+        times.push_back((nowSeconds() - begin) * 1e3);
+        sink += left[kBlock - 1];
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+std::unique_ptr<AudioSource> startStreamed(const std::string& wav) {
+    auto decoder = std::make_unique<ResamplingDecoder>(WavDecoder::open(wav), kRate);
+    auto source = std::make_unique<StreamingSource>(std::move(decoder), StreamingConfig{});
+    source->prepare(kRate, kBlock);
+    return source;
+}
+
+std::unique_ptr<AudioSource> startWholeFile(const std::string& wav) {
+    ResamplingDecoder decoder(WavDecoder::open(wav), kRate);
+    auto buffer = std::make_shared<PcmBuffer>();
+    buffer->sampleRate = kRate;
+    buffer->frameCount = static_cast<std::size_t>(decoder.frameCount());
+    buffer->channels.assign(2, std::vector<float>(buffer->frameCount));
+    buffer->frameCount = decoder.decode(buffer->channels[0].data(), buffer->channels[1].data(), buffer->frameCount);
+    auto source = std::make_unique<PcmSource>(buffer, true);
+    source->prepare(kRate, kBlock);
+    return source;
+}
+
+std::unique_ptr<AudioSource> startPacked(const std::shared_ptr<const AssetPack>& pack) {
+    auto source = std::make_unique<PackedSource>(pack, *pack->find("track"), true);
+    source->prepare(kRate, kBlock);
+    return source;
+}
+
+/// Render-thread nanoseconds per frame over kRenderSeconds, paced so a
+/// streaming worker keeps up as it would on a device.
+double renderNsPerFrame(AudioSource& source) {
+    std::vector<float> left(kBlock), right(kBlock);
+    const auto blocks = static_cast<std::size_t>(kRenderSeconds * kRate / kBlock);
+    double elapsed = 0.0;
+    for (std::size_t b = 0; b < blocks; ++b) {
+        if (b % 16 == 0) usleep(1000);
+        const double begin = nowSeconds();
+        source.render(left.data(), right.data(), kBlock);
+        elapsed += nowSeconds() - begin;
+        sink += left[kBlock - 1];
+    }
+    return elapsed * 1e9 / static_cast<double>(blocks * kBlock);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double trackSeconds = argc > 1 ? std::atof(argv[1]) : 180.0;
+    const std::string wav = "/tmp/sleepster_pack_bench_track.wav";
+    const std::string packPath = "/tmp/sleepster_pack_bench.slpk";
+    if (!writeSyntheticTrack(wav, trackSeconds, kTrackRate)) {
+        std::fprintf(stderr, "failed to write %s\n", wav.c_str());
+        return 1;
+    }
+
+    // Building the pack is the offline step; time it for reference.
+    const double packStart = nowSeconds();
+    {
+        auto decoder = WavDecoder::open(wav);
+        PcmBuffer buffer;
+        buffer.sampleRate = decoder->sampleRate();
+        buffer.frameCount = static_cast<std::size_t>(decoder->frameCount());
+        buffer.channels.assign(2, std::vector<float>(buffer.frameCount));
+        decoder->decode(buffer.channels[0].data(), buffer.channels[1].data(), buffer.frameCount);
+        EncodedAsset asset;
+        if (!encodeAsset("track", buffer, AssetPackOptions{}, asset) || !writeAssetPack(packPath, {asset}, kRate)) {
+            std::fprintf(stderr, "failed to write %s\n", packPath.c_str());
+            return 1;
+        }
+    }
+    std::printf("track: %.0f s stereo; pack built in %.1f s (offline)\n\n", trackSeconds, nowSeconds() - packStart);
+
+    std::printf("time to first sample (median of %d)\n", kStarts);
+    const auto pack = AssetPack::open(packPath);
+    std::printf("  %-34s %9.3f ms\n", "packed, pack already open",
+                medianMs([&] { return startPacked(pack); }, ""));
+    std::printf("  %-34s %9.3f ms\n", "packed, open pack + start",
+                medianMs([&] { return startPacked(AssetPack::open(packPath)); }, ""));
+    std::printf("  %-34s %9.3f ms\n", "packed, cold open + start",
+                medianMs([&] { return startPacked(AssetPack::open(packPath)); }, packPath));
+    std::printf("  %-34s %9.3f ms\n", "streamed (0.25 s prefill)", medianMs([&] { return startStreamed(wav); }, ""));
+    std::printf("  %-34s %9.3f ms\n", "streamed, cold", medianMs([&] { return startStreamed(wav); }, wav));
+    std::printf("  %-34s %9.3f ms\n", "whole-file decode", medianMs([&] { return startWholeFile(wav); }, ""));
+
+    std::printf("\nCPU per voice over %.0f s of playback\n", kRenderSeconds);
+    {
+        auto source = startPacked(pack);
+        const double ns = renderNsPerFrame(*source);
+        std::printf("  %-34s %9.2f ns/frame  (%.4f%% of one core)\n", "packed", ns, 100.0 * ns * kRate / 1e9);
+    }
+    {
+        StreamDecodeWorker& worker = StreamDecodeWorker::shared();
+        auto source = startStreamed(wav);
+        const double decodeStart = worker.cpuSeconds();
+        const double render = renderNsPerFrame(*source);
+        const double decode = (worker.cpuSeconds() - decodeStart) * 1e9 / (kRenderSeconds * kRate);
+        std::printf("  %-34s %9.2f ns/frame  (%.4f%% of one core)\n", "streamed, render + decode thread",
+                    render + decode, 100.0 * (render + decode) * kRate / 1e9);
+    }
+
+    std::remove(wav.c_str());
+    std::remove(packPath.c_str());
+    return 0;
+}
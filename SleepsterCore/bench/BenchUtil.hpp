@@ -0,0 +1,84 @@
+//
+//  BenchUtil.hpp
+//  SleepsterCore
+//
+//  Small helpers shared by the Linux benchmarks: wall and CPU clocks,
+//  resident memory, an output sink, and synthetic test assets.
+//
+
+#pragma once
+
+#include "sleepster/WavFile.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <sys/resource.h>
+#include <vector>
+
+namespace sleepster::bench {
+
+/// Consumes benchmark output so the optimiser cannot drop the work.
+inline volatile float sink = 0.0f;
+
+inline double nowSeconds() {
+    using Clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(Clock::now().time_since_epoch()).count();
+}
+
+inline double processCpuSeconds() {
+    timespec ts{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+/// Peak resident set size of this process in bytes.
+inline uint64_t peakRssBytes() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024u;
+#endif
+}
+
+/// Current resident set size in bytes (Linux; 0 elsewhere).
+inline uint64_t currentRssBytes() {
+    uint64_t pages = 0;
+    if (std::FILE* f = std::fopen("/proc/self/statm", "r")) {
+        unsigned long size = 0, resident = 0;
+        if (std::fscanf(f, "%lu %lu", &size, &resident) == 2) pages = resident;
+        std::fclose(f);
+    }
+    return pages * 4096u;
+}
+
+/// Writes a stereo 16-bit WAV of band-limited noise resembling a rain loop.
+inline bool writeSyntheticTrack(const std::string& path, double seconds, double sampleRate) {
+    const std::size_t frames = static_cast<std::size_t>(seconds * sampleRate);
+    std::vector<float> left(frames), right(frames);
+    uint32_t state = 0x12345678u;
+    float lowL = 0.0f, lowR = 0.0f;
+    for (std::size_t i = 0; i < frames; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        const float white = static_cast<float>(state) * (2.0f / 4294967296.0f) - 1.0f;
+        lowL += 0.05f * (white - lowL);
+        lowR += 0.07f * (white - lowR);
+        left[i] = 0.6f * lowL;
+        right[i] = 0.6f * lowR;
+    }
+    const float* channels[] = {left.data(), right.data()};
+    return writeWav(path, channels, 2, frames, sampleRate, WavFormat::Encoding::Pcm16);
+}
+
+inline double megabytes(uint64_t bytes) {
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+} // namespace sleepster::bench
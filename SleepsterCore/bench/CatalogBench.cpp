@@ -0,0 +1,196 @@
+//
+//  CatalogBench.cpp
+//  SleepsterCore
+//
+//  Startup and selection-change latency of the sound and background
+//  catalog at store sizes well past the app's own:
+//
+//  - build: indexing every record as it comes out of a store fetch, the
+//    path taken when there is no usable snapshot.
+//  - save and load of the snapshot; load is what a launch pays.
+//  - lookup of a random title, and of the selected sound and the mix.
+//  - a selection change: select a sound, read the selection back and take
+//    the rows to write back.
+//
+//  Lookups are set against scanning an array of the same records, a lower
+//  bound on what a store fetch without the index costs: the old
+//  existence check and fetchSelected* paths each scanned the table.
+//
+//  Usage: CatalogBench [records...] [--directory path]
+//
+
+#include "BenchUtil.hpp"
+
+#include "sleepster/Catalog.hpp"
+#include "sleepster/Random.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace sleepster;
+using namespace sleepster::bench;
+
+namespace {
+
+struct PlainSound {
+    std::string title;
+    std::string url;
+    bool favorite;
+    bool selected;
+    bool mixing;
+};
+
+CatalogSound soundOf(const PlainSound& plain) {
+    CatalogSound sound;
+    sound.title = plain.title;
+    sound.hasUrl1 = true;
+    sound.url1 = plain.url;
+    sound.favorite = plain.favorite;
+    sound.selected = plain.selected;
+    sound.selectedForMixing = plain.mixing;
+    return sound;
+}
+
+/// Best of `runs`, in seconds per operation.
+template <typename Body>
+double bestPerOp(int runs, int operations, Body body) {
+    double best = 1e30;
+    for (int run = 0; run < runs; ++run) {
+        const double start = nowSeconds();
+        for (int i = 0; i < operations; ++i) body(i);
+        best = std::min(best, (nowSeconds() - start) / operations);
+    }
+    return best;
+}
+
+volatile std::size_t gSink = 0;
+
+void benchmark(int records, const std::string& directory) {
+    std::vector<PlainSound> plain;
+    plain.reserve(static_cast<std::size_t>(records));
+    for (int i = 0; i < records; ++i) {
+        const std::string name = "Sound " + std::to_string(i * 7919 % records);
+        plain.push_back({name, "sounds/" + name + ".mp3", i % 5 == 0, i == records / 2, i % 97 == 0});
+    }
+    std::vector<CatalogSound> sounds;
+    sounds.reserve(plain.size());
+    for (const PlainSound& sound : plain) sounds.push_back(soundOf(sound));
+
+    // Build, as from a store fetch.
+    Catalog catalog;
+    const double buildStart = nowSeconds();
+    uint32_t id;
+    for (const CatalogSound& sound : sounds) catalog.addSound(sound, id, true);
+    for (int i = 0; i < records; ++i) {
+        CatalogBackground background;
+        background.animationType = "animation-" + std::to_string(i);
+        background.hasColorTheme = true;
+        background.colorTheme = "ocean";
+        catalog.addBackground(background, id, true);
+    }
+    const double buildSeconds = nowSeconds() - buildStart;
+
+    const std::string path = directory + "/sleepster_bench.catalog";
+    double saveBest = 1e30;
+    for (int run = 0; run < 5; ++run) {
+        const double start = nowSeconds();
+        catalog.save(path);
+        saveBest = std::min(saveBest, nowSeconds() - start);
+    }
+    std::size_t snapshotBytes = 0;
+    if (std::FILE* file = std::fopen(path.c_str(), "rb")) {
+        std::fseek(file, 0, SEEK_END);
+        snapshotBytes = static_cast<std::size_t>(std::ftell(file));
+        std::fclose(file);
+    }
+    double loadBest = 1e30;
+    for (int run = 0; run < 5; ++run) {
+        const double start = nowSeconds();
+        std::unique_ptr<Catalog> loaded = Catalog::load(path);
+        loadBest = std::min(loadBest, nowSeconds() - start);
+        gSink = gSink + (loaded ? loaded->size(CatalogKind::Sound) : 0);
+    }
+    std::remove(path.c_str());
+
+    // Lookups, by random title.
+    Random random(7);
+    std::vector<std::string> probes;
+    for (int i = 0; i < 4096; ++i) probes.push_back(plain[random.next() % plain.size()].title);
+    const int lookups = 200000;
+    const double findIndexed = bestPerOp(5, lookups, [&](int i) {
+        gSink = gSink + catalog.find(CatalogKind::Sound, probes[static_cast<std::size_t>(i) & 4095]);
+    });
+    const double findScanned = bestPerOp(3, 200, [&](int i) {
+        const std::string& title = probes[static_cast<std::size_t>(i) & 4095];
+        for (const PlainSound& sound : plain) {
+            if (sound.title == title) {
+                gSink = gSink + sound.url.size();
+                break;
+            }
+        }
+    });
+    const double selectedIndexed = bestPerOp(5, 20000, [&](int) {
+        gSink = gSink + catalog.firstWith(CatalogKind::Sound, CatalogFlag::Selected);
+    });
+    const double selectedScanned = bestPerOp(5, 200, [&](int) {
+        for (std::size_t i = 0; i < plain.size(); ++i) {
+            if (plain[i].selected) {
+                gSink = gSink + i;
+                break;
+            }
+        }
+    });
+    const double mixIndexed = bestPerOp(5, 2000, [&](int) {
+        gSink = gSink + catalog.allWith(CatalogKind::Sound, CatalogFlag::SelectedForMixing).size();
+    });
+    const double mixScanned = bestPerOp(5, 200, [&](int) {
+        std::vector<std::size_t> mix;
+        for (std::size_t i = 0; i < plain.size(); ++i) {
+            if (plain[i].mixing) mix.push_back(i);
+        }
+        gSink = gSink + mix.size();
+    });
+
+    // Selection changes.
+    catalog.takeChanges(CatalogKind::Sound);
+    const double selectionChange = bestPerOp(5, 20000, [&](int i) {
+        const uint32_t chosen = catalog.find(CatalogKind::Sound, probes[static_cast<std::size_t>(i) & 4095]);
+        catalog.select(CatalogKind::Sound, chosen);
+        gSink = gSink + catalog.firstWith(CatalogKind::Sound, CatalogFlag::Selected);
+        gSink = gSink + catalog.takeChanges(CatalogKind::Sound).size();
+    });
+
+    std::printf("%d sounds and %d backgrounds\n", records, records);
+    std::printf("  build from store rows   %9.2f ms\n", buildSeconds * 1e3);
+    std::printf("  save snapshot           %9.2f ms   %.2f MB, %.1f bytes per record\n", saveBest * 1e3,
+                megabytes(snapshotBytes), static_cast<double>(snapshotBytes) / (2.0 * records));
+    std::printf("  load snapshot           %9.2f ms\n", loadBest * 1e3);
+    std::printf("  %-22s %10s %12s\n", "", "indexed", "scanned");
+    std::printf("  %-22s %7.3f us %9.1f us\n", "find by title", findIndexed * 1e6, findScanned * 1e6);
+    std::printf("  %-22s %7.3f us %9.1f us\n", "selected sound", selectedIndexed * 1e6, selectedScanned * 1e6);
+    std::printf("  %-22s %7.3f us %9.1f us\n", "sounds in the mix", mixIndexed * 1e6, mixScanned * 1e6);
+    std::printf("  selection change        %7.3f us\n\n", selectionChange * 1e6);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<int> sizes;
+    std::string directory = "/tmp";
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--directory") == 0 && i + 1 < argc) {
+            directory = argv[++i];
+        } else {
+            sizes.push_back(std::atoi(argv[i]));
+        }
+    }
+    if (sizes.empty()) sizes = {10000, 100000};
+    for (int records : sizes) {
+        if (records > 0) benchmark(records, directory);
+    }
+    return static_cast<int>(gSink & 0);
+}
@@ -0,0 +1,570 @@
+//
+//  DspBench.cpp
+//  SleepsterCore
+//
+//  Micro-benchmarks of the audio kernels with a regression gate, so what
+//  mixing, fading, filtering, resampling, decoding and noise cost per frame
+//  is on record and a slower build fails instead of shipping. Each case
+//  renders stereo blocks of one size in a loop and reports ns per frame,
+//  best and median of several runs:
+//
+//  - mix: the whole mixer, N looping PCM voices at the mixer rate.
+//  - ramp: a voice mixed in under a fade that restarts every second, per
+//    curve.
+//  - biquad: the 10-band EQ cascade, vectorized and scalar.
+//  - resample: a 44.1 kHz PCM voice played at 48 kHz, and a 44.1 kHz WAV
+//    through ResamplingDecoder.
+//  - decode: WAV in 16-bit and float, as streamed voices read it.
+//  - noise: the procedural sources.
+//
+//  Results go to stdout and, with --output, to a JSON file. With
+//  --baseline, each case is compared against that file and the run exits
+//  with status 1 if any is more than --threshold (a fraction, 0.25 by
+//  default) slower. Cases missing from the baseline are reported, not
+//  failed. A missing or unreadable baseline fails the run with status 2:
+//  a gate with nothing to compare against would pass any change.
+//
+//  The comparison is of `relative`: each run's time over that of a fixed
+//  loop timed just before it, median of the runs. Shared and virtual
+//  machines drift in speed by half from one minute to the next; the ratio
+//  stays within a few percent, so a baseline holds across runs on the
+//  same machine, though not across machines. The gate therefore compares
+//  against a baseline the base revision recorded on the machine it runs
+//  on; the one under bench/baselines is a reference record only.
+//
+//  Record a baseline with several passes, so that it holds each case's
+//  usual cost: DspBench --passes 3 --output DspBench.baseline.json
+//
+//  Usage: DspBench [--output results.json] [--baseline baseline.json]
+//                  [--threshold 0.25] [--filter substring] [--frames N]
+//                  [--runs N] [--passes N]
+//
+
+#include "BenchUtil.hpp"
+
+#include "sleepster/Equalizer.hpp"
+#include "sleepster/GainRamp.hpp"
+#include "sleepster/MixKernels.hpp"
+#include "sleepster/Mixer.hpp"
+#include "sleepster/NoiseSource.hpp"
+#include "sleepster/PcmSource.hpp"
+#include "sleepster/WavFile.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace sleepster;
+using namespace sleepster::bench;
+
+namespace {
+
+constexpr double kRate = 48000.0;
+constexpr double kSourceRate = 44100.0;
+/// Which loop calibrationNs() times, stored with the results: relative
+/// costs against another loop do not compare.
+constexpr int kCalibration = 2;
+/// A run repeats its frames until it has taken this long, so that the
+/// cheapest cases are not timed over a millisecond or two.
+constexpr double kMinRunSeconds = 0.02;
+constexpr std::size_t kBlocks[] = {64, 256, 1024};
+
+struct Options {
+    std::string output;
+    std::string baseline;
+    std::string filter;
+    double threshold = 0.25;
+    /// Frames rendered per run, at least; about 22 s of audio.
+    std::size_t frames = 1u << 20;
+    int runs = 7;
+    /// Times each case is measured from scratch; the median is kept.
+    int passes = 1;
+};
+
+struct Result {
+    std::string name;
+    std::string kernel;
+    int voices = 1;
+    std::size_t block = 0;
+    double nsPerFrame = 0.0;
+    double medianNsPerFrame = 0.0;
+    /// Median ns per frame over ns per calibration iteration.
+    double relative = 0.0;
+};
+
+/// Renders one block into left/right.
+using Render = std::function<void(float* left, float* right, std::size_t frames)>;
+
+/// A fixed workload timed next to every run: ns per step of a chain of
+/// dependent integer multiply-adds. Each step waits for the one before,
+/// so its speed is the core's clock and nothing else: a vector loop runs
+/// at whatever the compiler made of it in that build, and differed by two
+/// times between the base and a changed build. One untimed repetition
+/// warms the clock up, then the median of kRepeats repetitions of about
+/// 2 ms each is kept, so that a preempted time slice does not move it.
+double calibrationNs() {
+    constexpr int kSteps = 1 << 20;
+    constexpr int kRepeats = 9;
+    std::vector<double> times;
+    for (int repeat = -1; repeat < kRepeats; ++repeat) {
+        // Seeded from the sink so that the chain cannot be folded.
+        uint64_t state = 0x9e3779b97f4a7c15ull + static_cast<uint64_t>(sink != 0.0f);
+        const double start = nowSeconds();
+        for (int step = 0; step < kSteps; ++step) {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            state ^= state >> 29;
+        }
+        const double elapsed = nowSeconds() - start;
+        sink = static_cast<float>(state & 0xFFFFu);
+        if (repeat >= 0) times.push_back(elapsed * 1e9 / kSteps);
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+/// Best and median ns per frame over `runs` runs of at least `frames`
+/// frames and kMinRunSeconds each,
+/// after one untimed warm-up run, and the median of each run's time
+/// relative to the calibration loop timed just before it.
+Result measure(const Options& options, std::size_t block, const Render& render) {
+    std::vector<float> left(block), right(block);
+    const std::size_t blocks = std::max<std::size_t>(1, options.frames / block);
+    std::vector<double> times;
+    std::vector<double> relative;
+    for (int run = -1; run < options.runs; ++run) {
+        const double calibration = calibrationNs();
+        const double start = nowSeconds();
+        std::size_t rendered = 0;
+        double elapsed = 0.0;
+        do {
+            for (std::size_t b = 0; b < blocks; ++b) render(left.data(), right.data(), block);
+            rendered += blocks * block;
+            elapsed = nowSeconds() - start;
+        } while (elapsed < kMinRunSeconds);
+        sink = sink + left[block - 1];
+        if (run < 0) continue;
+        times.push_back(elapsed * 1e9 / static_cast<double>(rendered));
+        relative.push_back(times.back() / calibration);
+    }
+    std::sort(times.begin(), times.end());
+    std::sort(relative.begin(), relative.end());
+    Result result;
+    result.block = block;
+    result.nsPerFrame = times.front();
+    result.medianNsPerFrame = times[times.size() / 2];
+    result.relative = relative[relative.size() / 2];
+    return result;
+}
+
+/// A second of band-limited noise at `rate`, for looping voices.
+std::shared_ptr<PcmBuffer> loopBuffer(double rate, uint32_t seed) {
+    const std::size_t frames = static_cast<std::size_t>(rate);
+    auto buffer = std::make_shared<PcmBuffer>();
+    buffer->sampleRate = rate;
+    buffer->frameCount = frames;
+    buffer->channels.assign(2, std::vector<float>(frames));
+    uint32_t state = seed | 1u;
+    float low = 0.0f;
+    for (std::size_t i = 0; i < frames; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        low += 0.05f * (static_cast<float>(state) * (2.0f / 4294967296.0f) - 1.0f - low);
+        buffer->channels[0][i] = 0.6f * low;
+        buffer->channels[1][i] = -0.6f * low;
+    }
+    return buffer;
+}
+
+/// The cases, registered up front so that any can be measured again.
+class Suite {
+public:
+    explicit Suite(const Options& options) : options_(options) {}
+
+    const std::vector<Result>& results() const { return results_; }
+
+    /// Adds a case per block size, unless filtered out. `make(block)`
+    /// builds fresh state and returns the function rendering one block.
+    void add(const std::string& kernel, const std::string& variant, int voices,
+             const std::function<Render(std::size_t block)>& make) {
+        for (std::size_t block : kBlocks) {
+            std::string name = kernel + "/" + variant;
+            if (voices > 0) name += "/voices=" + std::to_string(voices);
+            name += "/block=" + std::to_string(block);
+            if (!options_.filter.empty() && name.find(options_.filter) == std::string::npos) continue;
+            cases_.push_back({name, kernel, std::max(voices, 1), block, make});
+        }
+    }
+
+    /// Measures every case `passes` times, each with fresh state, keeping
+    /// the best time and the median of the rest.
+    void run(int passes) {
+        for (const Case& c : cases_) {
+            std::vector<Result> measured;
+            for (int pass = 0; pass < passes; ++pass) measured.push_back(measure(options_, c.block, c.make(c.block)));
+            Result result = measured.front();
+            std::vector<double> medians, relatives;
+            for (const Result& m : measured) {
+                result.nsPerFrame = std::min(result.nsPerFrame, m.nsPerFrame);
+                medians.push_back(m.medianNsPerFrame);
+                relatives.push_back(m.relative);
+            }
+            std::sort(medians.begin(), medians.end());
+            std::sort(relatives.begin(), relatives.end());
+            result.medianNsPerFrame = medians[medians.size() / 2];
+            result.relative = relatives[relatives.size() / 2];
+            result.name = c.name;
+            result.kernel = c.kernel;
+            result.voices = c.voices;
+            std::printf("%-40s %9.3f %9.3f %9.3f\n", c.name.c_str(), result.nsPerFrame, result.medianNsPerFrame,
+                        result.relative);
+            std::fflush(stdout);
+            results_.push_back(std::move(result));
+        }
+    }
+
+    /// The relative cost of the case at `index` in results(), measured
+    /// again from scratch.
+    double remeasure(std::size_t index) const {
+        const Case& c = cases_[index];
+        return measure(options_, c.block, c.make(c.block)).relative;
+    }
+
+private:
+    struct Case {
+        std::string name;
+        std::string kernel;
+        int voices;
+        std::size_t block;
+        std::function<Render(std::size_t block)> make;
+    };
+
+    const Options& options_;
+    std::vector<Case> cases_;
+    std::vector<Result> results_;
+};
+
+void addMix(Suite& suite) {
+    for (int voices : {1, 4, 8, 16}) {
+        suite.add("mix", "pcm", voices, [voices](std::size_t block) -> Render {
+            auto mixer = std::make_shared<Mixer>(MixerConfig{kRate, 32, static_cast<uint32_t>(block), 256});
+            for (int v = 0; v < voices; ++v) {
+                mixer->play(std::make_unique<PcmSource>(loopBuffer(kRate, static_cast<uint32_t>(v + 1)), true),
+                            0.2f);
+            }
+            return [mixer](float* left, float* right, std::size_t frames) { mixer->render(left, right, frames); };
+        });
+    }
+}
+
+void addRamps(Suite& suite) {
+    const struct {
+        const char* name;
+        RampCurve curve;
+    } curves[] = {
+        {"linear", RampCurve::Linear},
+        {"equal-power", RampCurve::EqualPower},
+        {"exponential", RampCurve::Exponential},
+    };
+    for (const auto& entry : curves) {
+        const RampCurve curve = entry.curve;
+        suite.add("ramp", entry.name, 0, [curve](std::size_t block) -> Render {
+            auto voice = loopBuffer(kRate, 3);
+            auto ramp = std::make_shared<GainRamp>(0.0f);
+            auto cursor = std::make_shared<std::size_t>(0);
+            return [voice, ramp, cursor, curve](float* left, float* right, std::size_t frames) {
+                if (!ramp->isRamping()) {
+                    ramp->start(ramp->target() > 0.5f ? 0.0f : 1.0f, static_cast<uint64_t>(kRate), curve);
+                }
+                if (*cursor + frames > voice->frameCount) *cursor = 0;
+                const float* sourceLeft = voice->channels[0].data() + *cursor;
+                const float* sourceRight = voice->channels[1].data() + *cursor;
+                *cursor += frames;
+                kernels::clear(left, frames);
+                kernels::clear(right, frames);
+                std::size_t offset = 0;
+                while (offset < frames) {
+                    float gainStart = 0.0f;
+                    float gainEnd = 0.0f;
+                    const std::size_t span = ramp->nextSpan(frames - offset, gainStart, gainEnd);
+                    kernels::mixAddRamp(left + offset, sourceLeft + offset, gainStart, gainEnd, span);
+                    kernels::mixAddRamp(right + offset, sourceRight + offset, gainStart, gainEnd, span);
+                    offset += span;
+                }
+            };
+        });
+    }
+}
+
+void addBiquads(Suite& suite) {
+    static const float kGains[Equalizer::kBandCount] = {3, 2, -1, -2, 0, 1, 2, 3, 4, 3};
+    for (bool vectorized : {true, false}) {
+        suite.add("biquad", vectorized ? "eq10" : "eq10-scalar", 0, [vectorized](std::size_t block) -> Render {
+            auto eq = std::make_shared<Equalizer>(kRate, block);
+            eq->setGains(kGains, Equalizer::kBandCount);
+            eq->setEnabled(true);
+            auto input = loopBuffer(kRate, 5);
+            return [eq, input, vectorized](float* left, float* right, std::size_t frames) {
+                // Fresh input every block, as from the mixer.
+                std::memcpy(left, input->channels[0].data(), frames * sizeof(float));
+                std::memcpy(right, input->channels[1].data(), frames * sizeof(float));
+                if (vectorized) {
+                    eq->process(left, right, frames);
+                } else {
+                    eq->processScalar(left, right, frames);
+                }
+            };
+        });
+    }
+}
+
+void addResampling(Suite& suite, const std::string& wav44) {
+    suite.add("resample", "pcm-44k1-to-48k", 0, [](std::size_t block) -> Render {
+        auto source = std::make_shared<PcmSource>(loopBuffer(kSourceRate, 7), true);
+        source->prepare(kRate, block);
+        return [source](float* left, float* right, std::size_t frames) { source->render(left, right, frames); };
+    });
+    suite.add("resample", "decoder-44k1-to-48k", 0, [wav44](std::size_t block) -> Render {
+        std::shared_ptr<Decoder> decoder = std::make_shared<ResamplingDecoder>(WavDecoder::open(wav44), kRate);
+        return [decoder](float* left, float* right, std::size_t frames) {
+            if (decoder->decode(left, right, frames) < frames) decoder->seek(0);
+        };
+    });
+}
+
+void addDecoding(Suite& suite, const std::string& pcm16, const std::string& float32) {
+    for (const auto& [variant, path] : {std::pair<std::string, std::string>{"wav-pcm16", pcm16},
+                                        std::pair<std::string, std::string>{"wav-float32", float32}}) {
+        suite.add("decode", variant, 0, [path = path](std::size_t block) -> Render {
+            std::shared_ptr<Decoder> decoder = WavDecoder::open(path);
+            return [decoder](float* left, float* right, std::size_t frames) {
+                if (decoder->decode(left, right, frames) < frames) decoder->seek(0);
+            };
+        });
+    }
+}
+
+void addNoise(Suite& suite) {
+    const struct {
+        const char* name;
+        NoiseColor color;
+    } colors[] = {
+        {"white", NoiseColor::White},
+        {"pink", NoiseColor::Pink},
+        {"brown", NoiseColor::Brown},
+    };
+    for (const auto& entry : colors) {
+        const NoiseColor color = entry.color;
+        suite.add("noise", entry.name, 0, [color](std::size_t block) -> Render {
+            auto source = std::make_shared<NoiseSource>(color, 1);
+            source->prepare(kRate, block);
+            return [source](float* left, float* right, std::size_t frames) { source->render(left, right, frames); };
+        });
+    }
+}
+
+bool writeJson(const std::string& path, const std::vector<Result>& results) {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) return false;
+    std::fprintf(file, "{\n  \"suite\": \"DspBench\",\n  \"unit\": \"ns/frame\",\n  \"sampleRate\": %.0f,\n", kRate);
+    std::fprintf(file, "  \"cores\": %u,\n  \"calibration\": %d,\n  \"results\": [\n",
+                 std::thread::hardware_concurrency(), kCalibration);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        std::fprintf(file,
+                     "    {\"name\": \"%s\", \"kernel\": \"%s\", \"voices\": %d, \"block\": %zu, "
+                     "\"nsPerFrame\": %.4f, \"medianNsPerFrame\": %.4f, \"relative\": %.4f}%s\n",
+                     r.name.c_str(), r.kernel.c_str(), r.voices, r.block, r.nsPerFrame, r.medianNsPerFrame,
+                     r.relative, i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+    return std::fclose(file) == 0;
+}
+
+struct Baseline {
+    /// Relative cost by case name.
+    std::map<std::string, double> relative;
+    /// Core count of the machine that recorded it.
+    unsigned cores = 0;
+    /// kCalibration of the build that recorded it; 0 before it was stored.
+    int calibration = 0;
+};
+
+/// Reads a file this tool wrote.
+bool readBaseline(const std::string& path, Baseline& out) {
+    std::ifstream file(path);
+    if (!file) return false;
+    std::string line;
+    const std::string coresKey = "\"cores\": ";
+    const std::string calibrationKey = "\"calibration\": ";
+    const std::string nameKey = "\"name\": \"";
+    const std::string timeKey = "\"relative\": ";
+    while (std::getline(file, line)) {
+        const std::size_t coresAt = line.find(coresKey);
+        if (coresAt != std::string::npos) {
+            out.cores = static_cast<unsigned>(std::atoi(line.c_str() + coresAt + coresKey.size()));
+        }
+        const std::size_t calibrationAt = line.find(calibrationKey);
+        if (calibrationAt != std::string::npos) {
+            out.calibration = std::atoi(line.c_str() + calibrationAt + calibrationKey.size());
+        }
+        const std::size_t name = line.find(nameKey);
+        const std::size_t time = line.find(timeKey);
+        if (name == std::string::npos || time == std::string::npos) continue;
+        const std::size_t nameStart = name + nameKey.size();
+        const std::size_t nameEnd = line.find('"', nameStart);
+        if (nameEnd == std::string::npos) continue;
+        out.relative[line.substr(nameStart, nameEnd - nameStart)] = std::atof(line.c_str() + time + timeKey.size());
+    }
+    return true;
+}
+
+/// Prints every case slower than the baseline allows; false if any is.
+/// A case over the threshold is measured again, up to kConfirmations
+/// times, and only fails if it is slow every time, since a case now and
+/// then runs slow as a whole, e.g. from where its buffers landed. The
+/// confirmations come in rounds a second apart after the whole suite, so
+/// that one slow spell of a shared machine does not account for all of
+/// them.
+bool compare(const Suite& suite, const Baseline& baseline, double threshold) {
+    constexpr int kConfirmations = 3;
+    const std::vector<Result>& results = suite.results();
+    if (baseline.cores != std::thread::hardware_concurrency()) {
+        std::printf("\nThe baseline was recorded on a machine with %u cores, this one has %u: "
+                    "record one here instead\n",
+                    baseline.cores, std::thread::hardware_concurrency());
+    }
+    std::vector<double> relative(results.size());
+    std::vector<double> expected(results.size(), 0.0);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto found = baseline.relative.find(results[i].name);
+        if (found != baseline.relative.end()) expected[i] = found->second;
+        relative[i] = results[i].relative;
+    }
+    const auto over = [&](std::size_t i) { return expected[i] > 0.0 && relative[i] / expected[i] - 1.0 > threshold; };
+    for (int round = 0; round < kConfirmations; ++round) {
+        bool waited = false;
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            if (!over(i)) continue;
+            if (!waited) std::this_thread::sleep_for(std::chrono::seconds(1));
+            waited = true;
+            relative[i] = std::min(relative[i], suite.remeasure(i));
+        }
+    }
+    int regressions = 0;
+    int missing = 0;
+    std::printf("\n%-40s %9s %9s %8s\n", "relative cost", "baseline", "now", "change");
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        if (expected[i] <= 0.0) {
+            ++missing;
+            continue;
+        }
+        const double change = relative[i] / expected[i] - 1.0;
+        const bool regressed = change > threshold;
+        if (regressed) ++regressions;
+        std::printf("%-40s %9.3f %9.3f %+7.1f%%%s\n", results[i].name.c_str(), expected[i], relative[i],
+                    100.0 * change, regressed ? "  REGRESSED" : "");
+    }
+    if (missing > 0) std::printf("%d cases are not in the baseline\n", missing);
+    std::printf("%d of %zu cases regressed by more than %.0f%%\n", regressions, results.size(), 100.0 * threshold);
+    return regressions == 0;
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string flag = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+        if (flag == "--output") {
+            options.output = value;
+        } else if (flag == "--baseline") {
+            options.baseline = value;
+        } else if (flag == "--threshold") {
+            options.threshold = std::atof(value);
+        } else if (flag == "--filter") {
+            options.filter = value;
+        } else if (flag == "--frames") {
+            options.frames = static_cast<std::size_t>(std::atoll(value));
+        } else if (flag == "--runs") {
+            options.runs = std::max(1, std::atoi(value));
+        } else if (flag == "--passes") {
+            options.passes = std::max(1, std::atoi(value));
+        } else {
+            return false;
+        }
+    }
+    return options.frames > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr,
+                     "usage: DspBench [--output results.json] [--baseline baseline.json] [--threshold 0.25]\n"
+                     "                [--filter substring] [--frames N] [--runs N] [--passes N]\n");
+        return 2;
+    }
+
+    const std::string pcm16 = "/tmp/sleepster_dsp_bench_pcm16.wav";
+    const std::string float32 = "/tmp/sleepster_dsp_bench_float32.wav";
+    const std::string wav44 = "/tmp/sleepster_dsp_bench_44k1.wav";
+    {
+        auto track = loopBuffer(kRate, 11);
+        const float* channels[] = {track->channels[0].data(), track->channels[1].data()};
+        auto track44 = loopBuffer(kSourceRate, 13);
+        const float* channels44[] = {track44->channels[0].data(), track44->channels[1].data()};
+        if (!writeWav(pcm16, channels, 2, track->frameCount, kRate, WavFormat::Encoding::Pcm16)
+            || !writeWav(float32, channels, 2, track->frameCount, kRate, WavFormat::Encoding::Float32)
+            || !writeWav(wav44, channels44, 2, track44->frameCount, kSourceRate, WavFormat::Encoding::Pcm16)) {
+            std::fprintf(stderr, "cannot write test tracks to /tmp\n");
+            return 2;
+        }
+    }
+
+    std::printf("Stereo at %.0f kHz, %zu frames per run, best and median of %d runs, %d passes\n\n",
+                kRate / 1000.0, options.frames, options.runs, options.passes);
+    std::printf("%-40s %9s %9s %9s\n", "case (ns/frame)", "best", "median", "relative");
+
+    Suite suite(options);
+    addMix(suite);
+    addRamps(suite);
+    addBiquads(suite);
+    addResampling(suite, wav44);
+    addDecoding(suite, pcm16, float32);
+    addNoise(suite);
+    suite.run(options.passes);
+
+    int status = 0;
+    if (!options.output.empty() && !writeJson(options.output, suite.results())) {
+        std::fprintf(stderr, "cannot write %s\n", options.output.c_str());
+        status = 2;
+    } else if (!options.baseline.empty()) {
+        Baseline baseline;
+        if (!readBaseline(options.baseline, baseline)) {
+            std::fprintf(stderr, "cannot read baseline %s: record one on the base revision first\n",
+                         options.baseline.c_str());
+            status = 2;
+        } else if (baseline.calibration != kCalibration) {
+            std::fprintf(stderr, "baseline %s was measured against another calibration loop: record it again\n",
+                         options.baseline.c_str());
+            status = 2;
+        } else if (!compare(suite, baseline, options.threshold)) {
+            status = 1;
+        }
+    }
+    std::remove(pcm16.c_str());
+    std::remove(float32.c_str());
+    std::remove(wav44.c_str());
+    return status;
+}
@@ -0,0 +1,131 @@
+//
+//  EffectsBench.cpp
+//  SleepsterCore
+//
+//  CPU time per second of stereo audio for the master-bus effects: the
+//  reverb at each ReverbType, the delay, and the bypassed and asleep states
+//  that should cost next to nothing.
+//
+//  Usage: EffectsBench [seconds]
+//
+
+#include "BenchUtil.hpp"
+
+#include "sleepster/Delay.hpp"
+#include "sleepster/Reverb.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+
+using namespace sleepster;
+using namespace sleepster::bench;
+
+namespace {
+
+constexpr double kRate = 48000.0;
+constexpr std::size_t kBlock = 512;
+
+/// Milliseconds of CPU per second of audio, best of three runs.
+template <typename Effect>
+double msPerSecond(Effect& effect, double seconds, bool silent) {
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    std::vector<float> inLeft(kBlock), inRight(kBlock), left(kBlock), right(kBlock);
+    if (!silent) {
+        for (std::size_t i = 0; i < kBlock; ++i) {
+            inLeft[i] = dist(rng);
+            inRight[i] = dist(rng);
+        }
+    }
+
+    const std::size_t blocks = static_cast<std::size_t>(seconds / 3 * kRate / kBlock);
+    double best = 1e30;
+    for (int run = 0; run < 3; ++run) {
+        const double start = nowSeconds();
+        for (std::size_t b = 0; b < blocks; ++b) {
+            std::copy(inLeft.begin(), inLeft.end(), left.begin());
+            std::copy(inRight.begin(), inRight.end(), right.begin());
+            effect.process(left.data(), right.data(), kBlock);
+            sink += left[kBlock - 1];
+        }
+        const double audioSeconds = static_cast<double>(blocks * kBlock) / kRate;
+        best = std::min(best, (nowSeconds() - start) * 1e3 / audioSeconds);
+    }
+    return best;
+}
+
+void report(const char* name, double ms) {
+    std::printf("%-22s %8.3f ms CPU per s of audio  (%.3f%% of real time)\n", name, ms, ms / 10.0);
+}
+
+/// Lets a freshly enabled effect finish its fade-in.
+template <typename Effect>
+void warmUp(Effect& effect) {
+    std::vector<float> left(kBlock, 0.1f), right(kBlock, 0.1f);
+    for (int i = 0; i < 20; ++i) effect.process(left.data(), right.data(), kBlock);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 60.0;
+    std::printf("Stereo effects at %.0f kHz, %zu-frame blocks, %.0f s of audio per case\n",
+                kRate / 1000.0, kBlock, seconds);
+
+    const struct {
+        const char* name;
+        ReverbPreset preset;
+    } presets[] = {
+        {"reverb room", ReverbPreset::Room},
+        {"reverb hall", ReverbPreset::Hall},
+        {"reverb cathedral", ReverbPreset::Cathedral},
+        {"reverb plate", ReverbPreset::Plate},
+    };
+    for (const auto& entry : presets) {
+        FdnReverb reverb(kRate, kBlock);
+        reverb.setPreset(entry.preset);
+        reverb.setEnabled(true);
+        warmUp(reverb);
+        report(entry.name, msPerSecond(reverb, seconds, false));
+    }
+
+    {
+        FdnReverb reverb(kRate, kBlock);
+        report("reverb bypassed", msPerSecond(reverb, seconds, false));
+    }
+    {
+        FdnReverb reverb(kRate, kBlock);
+        reverb.setPreset(ReverbPreset::Cathedral);
+        reverb.setEnabled(true);
+        warmUp(reverb);
+        // Well past the cathedral's tail, so only the silence check runs.
+        std::vector<float> left(kBlock), right(kBlock);
+        for (std::size_t b = 0; b < static_cast<std::size_t>(15.0 * kRate / kBlock); ++b) {
+            reverb.process(left.data(), right.data(), kBlock);
+        }
+        report("reverb asleep", msPerSecond(reverb, seconds, true));
+    }
+
+    {
+        StereoDelay delay(kRate, kBlock);
+        delay.setTime(0.1);
+        delay.setFeedback(0.2f);
+        delay.setEnabled(true);
+        warmUp(delay);
+        report("delay 100 ms", msPerSecond(delay, seconds, false));
+    }
+    {
+        StereoDelay delay(kRate, kBlock);
+        delay.setTime(0.005);
+        delay.setFeedback(0.2f);
+        delay.setEnabled(true);
+        warmUp(delay);
+        report("delay 5 ms (per-sample)", msPerSecond(delay, seconds, false));
+    }
+    {
+        StereoDelay delay(kRate, kBlock);
+        report("delay bypassed", msPerSecond(delay, seconds, false));
+    }
+    return 0;
+}
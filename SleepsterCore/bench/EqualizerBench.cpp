@@ -0,0 +1,85 @@
+//
+//  EqualizerBench.cpp
+//  SleepsterCore
+//
+//  ns per stereo frame for the 10-band EQ: vectorized cascade against the
+//  scalar reference, at both device sample rates, steady state and while a
+//  preset change is gliding.
+//
+//  Usage: EqualizerBench [seconds]
+//
+
+#include "BenchUtil.hpp"
+
+#include "sleepster/Equalizer.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+
+using namespace sleepster;
+using namespace sleepster::bench;
+
+namespace {
+
+constexpr std::size_t kBlock = 512;
+constexpr float kRock[Equalizer::kBandCount] = {3, 2, -1, -2, 0, 1, 2, 3, 4, 3};
+constexpr float kSleep[Equalizer::kBandCount] = {2, 1, 1, 0, 0, -1, -2, -3, -2, -1};
+
+template <typename Process>
+double nsPerFrame(double sampleRate, double seconds, bool gliding, Process process) {
+    Equalizer eq(sampleRate, kBlock);
+    eq.setGains(kRock, Equalizer::kBandCount);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    std::vector<float> inLeft(kBlock), inRight(kBlock), left(kBlock), right(kBlock);
+    for (std::size_t i = 0; i < kBlock; ++i) {
+        inLeft[i] = dist(rng);
+        inRight[i] = dist(rng);
+    }
+
+    const std::size_t blocks = static_cast<std::size_t>(seconds * sampleRate / kBlock);
+    // Alternating presets every 20 ms keeps the coefficients gliding throughout.
+    const std::size_t glideBlocks = static_cast<std::size_t>(Equalizer::kGlideSeconds * sampleRate / kBlock) + 1;
+    const double start = nowSeconds();
+    for (std::size_t b = 0; b < blocks; ++b) {
+        if (gliding && b % glideBlocks == 0) {
+            eq.setGains((b / glideBlocks) % 2 ? kSleep : kRock, Equalizer::kBandCount);
+        }
+        // Fresh input every block, as from the mixer; the copy costs the
+        // same for both paths.
+        std::copy(inLeft.begin(), inLeft.end(), left.begin());
+        std::copy(inRight.begin(), inRight.end(), right.begin());
+        process(eq, left.data(), right.data(), kBlock);
+        sink += left[kBlock - 1];
+    }
+    return (nowSeconds() - start) * 1e9 / static_cast<double>(blocks * kBlock);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 60.0;
+    std::printf("10-band stereo EQ, %zu-frame blocks, %.0f s of audio per case (best of 3)\n", kBlock, seconds);
+
+    for (double rate : {44100.0, 48000.0}) {
+        for (bool gliding : {false, true}) {
+            // Best of three, to keep scheduler noise out of the comparison.
+            double scalar = 1e30, vector = 1e30;
+            for (int run = 0; run < 3; ++run) {
+                scalar = std::min(scalar, nsPerFrame(rate, seconds / 3, gliding, [](Equalizer& eq, float* l, float* r, std::size_t n) {
+                    eq.processScalar(l, r, n);
+                }));
+                vector = std::min(vector, nsPerFrame(rate, seconds / 3, gliding, [](Equalizer& eq, float* l, float* r, std::size_t n) {
+                    eq.process(l, r, n);
+                }));
+            }
+            const double budget = 1e9 / rate;
+            std::printf("%5.1f kHz %-8s scalar %6.2f ns/frame  simd %6.2f ns/frame  speedup %.2fx  (%.2f%% of real time)\n",
+                        rate / 1000.0, gliding ? "gliding" : "steady", scalar, vector, scalar / vector,
+                        100.0 * vector / budget);
+        }
+    }
+    return 0;
+}
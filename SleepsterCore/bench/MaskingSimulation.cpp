@@ -0,0 +1,237 @@
+//
+//  MaskingSimulation.cpp
+//  SleepsterCore
+//
+//  Closed-loop runs of the masking controller through an hour of each
+//  noise profile. The app plays pink noise at the user's volume; what the
+//  controller asks for is applied through the master-bus EQ and a gain
+//  before it reaches the microphone, 6 dB down, along with the room. The
+//  figures that show the loop is stable are the reversals (times the gain
+//  changed direction) and the spread of the gain once a profile has
+//  settled; the coverage column shows the masking it bought.
+//
+//  Usage: MaskingSimulation [noise.wav ...]
+//  Each file is a recorded noise profile, looped for the hour at its own
+//  sample rate and taken at its recorded level against output at -26 dBFS.
+//
+
+#include "BenchUtil.hpp"
+
+#include "sleepster/Equalizer.hpp"
+#include "sleepster/MaskingController.hpp"
+#include "sleepster/NoiseSource.hpp"
+#include "sleepster/Random.hpp"
+#include "sleepster/WavFile.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace sleepster;
+using namespace sleepster::bench;
+
+namespace {
+
+constexpr std::size_t kBlock = 512;
+constexpr double kHour = 3600.0;
+constexpr double kPi = 3.141592653589793;
+/// The user's volume, on NoiseSource's -14 dBFS.
+constexpr float kUserVolume = 0.25f;
+constexpr float kEcho = 0.5f;
+
+float fromDb(float db) {
+    return std::pow(10.0f, db / 20.0f);
+}
+
+/// Fills `out` with `frames` samples of room noise starting at `time`.
+using Ambient = std::function<void(double time, float* out, std::size_t frames)>;
+
+struct Profile {
+    std::string name;
+    double sampleRate;
+    Ambient ambient;
+};
+
+/// Coloured noise whose level in dB relative to the output follows
+/// `levelAt(time)`.
+Ambient noise(NoiseColor color, double sampleRate, std::function<float(double)> levelAt) {
+    auto source = std::make_shared<NoiseSource>(color, static_cast<uint64_t>(color) + 11);
+    source->prepare(sampleRate, kBlock);
+    auto scratch = std::make_shared<std::vector<float>>(kBlock);
+    return [=](double time, float* out, std::size_t frames) {
+        source->render(out, scratch->data(), frames);
+        const float gain = kUserVolume * fromDb(levelAt(time));
+        for (std::size_t i = 0; i < frames; ++i) out[i] *= gain;
+    };
+}
+
+std::vector<Profile> synthesizedProfiles() {
+    const double rate = 48000.0;
+    std::vector<Profile> profiles;
+    profiles.push_back({"quiet bedroom", rate, noise(NoiseColor::Brown, rate, [](double) { return -24.0f; })});
+
+    // A car every 75 s, swelling 14 dB over eight seconds.
+    profiles.push_back({"traffic", rate, noise(NoiseColor::Brown, rate, [](double t) {
+                            const double phase = std::fmod(t, 75.0);
+                            const double swell = phase < 8.0 ? std::sin(kPi * phase / 8.0) : 0.0;
+                            return static_cast<float>(-14.0 + 14.0 * swell * swell);
+                        })});
+
+    // A fan on from 20 to 40 minutes.
+    auto fan = noise(NoiseColor::White, rate, [](double t) { return t >= 1200.0 && t < 2400.0 ? -6.0f : -60.0f; });
+    auto room = noise(NoiseColor::Pink, rate, [](double) { return -24.0f; });
+    profiles.push_back({"fan on 20-40 min", rate, [=](double t, float* out, std::size_t frames) {
+                            std::vector<float> fanNoise(frames);
+                            fan(t, fanNoise.data(), frames);
+                            room(t, out, frames);
+                            for (std::size_t i = 0; i < frames; ++i) out[i] += fanNoise[i];
+                        }});
+
+    // A partner snoring every 3.7 s over a quiet room.
+    auto base = noise(NoiseColor::Brown, rate, [](double) { return -24.0f; });
+    auto rumble = std::make_shared<Random>(9);
+    profiles.push_back({"snoring partner", rate, [=](double t, float* out, std::size_t frames) {
+                            base(t, out, frames);
+                            for (std::size_t i = 0; i < frames; ++i) {
+                                const double time = t + static_cast<double>(i) / rate;
+                                const double phase = std::fmod(time, 3.7);
+                                if (phase >= 1.4) continue;
+                                const double swell = std::sin(kPi * phase / 1.4);
+                                double buzz = 0.0;
+                                for (int k = 1; k <= 6; ++k) buzz += std::sin(2.0 * kPi * 90.0 * k * time) / (k * k);
+                                buzz += 0.2 * rumble->uniform(-1.0f, 1.0f);
+                                out[i] += kUserVolume * 0.4f * static_cast<float>(swell * swell * buzz);
+                            }
+                        }});
+    return profiles;
+}
+
+bool loadProfile(const char* path, Profile& profile) {
+    auto decoder = WavDecoder::open(path);
+    if (!decoder || decoder->frameCount() == 0) return false;
+    auto samples = std::make_shared<std::vector<float>>(decoder->frameCount());
+    std::vector<float> right(samples->size());
+    samples->resize(decoder->decode(samples->data(), right.data(), samples->size()));
+    for (std::size_t i = 0; i < samples->size(); ++i) (*samples)[i] = 0.5f * ((*samples)[i] + right[i]);
+    if (samples->empty()) return false;
+
+    const double rate = decoder->sampleRate();
+    profile = {path, rate, [samples, rate](double t, float* out, std::size_t frames) {
+                   std::size_t at = static_cast<std::size_t>(t * rate) % samples->size();
+                   for (std::size_t i = 0; i < frames; ++i) {
+                       out[i] = (*samples)[at];
+                       if (++at == samples->size()) at = 0;
+                   }
+               }};
+    return true;
+}
+
+struct Result {
+    float finalGain = 0.0f;
+    float lowGain = 0.0f;
+    float highGain = 0.0f;
+    float largestStep = 0.0f;
+    int reversals = 0;
+    /// Gain spread over the last half hour.
+    float settledSpread = 0.0f;
+    float meanCoverage = 0.0f;
+    double seconds = 0.0;
+};
+
+Result simulate(const Profile& profile) {
+    MaskingConfig config;
+    config.sampleRate = profile.sampleRate;
+    MaskingController controller(config);
+    NoiseSource output(NoiseColor::Pink, 1);
+    output.prepare(profile.sampleRate, kBlock);
+    Equalizer equalizer(profile.sampleRate, kBlock);
+    equalizer.setEnabled(true);
+
+    std::vector<float> left(kBlock), right(kBlock), room(kBlock), reference(kBlock), microphone(kBlock);
+    std::vector<float> gains;
+    double coverage = 0.0;
+    float gain = 1.0f;
+
+    const double start = nowSeconds();
+    const std::size_t total = static_cast<std::size_t>(kHour * profile.sampleRate);
+    std::size_t at = 0;
+    while (at < total) {
+        if (!controller.listening()) {
+            const std::size_t skip = std::min(total - at, controller.samplesUntilWindow());
+            controller.advance(skip);
+            at += skip;
+            continue;
+        }
+        const std::size_t frames = std::min(total - at, kBlock);
+        output.render(left.data(), right.data(), frames);
+        equalizer.process(left.data(), right.data(), frames);
+        profile.ambient(static_cast<double>(at) / profile.sampleRate, room.data(), frames);
+        for (std::size_t i = 0; i < frames; ++i) {
+            reference[i] = kUserVolume * gain * 0.5f * (left[i] + right[i]);
+            microphone[i] = kEcho * reference[i] + room[i];
+        }
+        const uint64_t windows = controller.windows();
+        controller.process(microphone.data(), reference.data(), frames);
+        at += frames;
+        if (controller.windows() == windows) continue;
+
+        MaskingDecision decision;
+        if (controller.takeDecision(decision)) {
+            gain = fromDb(decision.gainDb);
+            equalizer.setGains(decision.eqDb.data(), decision.eqDb.size());
+        }
+        gains.push_back(decision.gainDb);
+        coverage += decision.coverage;
+    }
+
+    Result result;
+    result.seconds = nowSeconds() - start;
+    if (gains.empty()) return result;
+    result.finalGain = gains.back();
+    result.lowGain = *std::min_element(gains.begin(), gains.end());
+    result.highGain = *std::max_element(gains.begin(), gains.end());
+    float lastStep = 0.0f;
+    for (std::size_t i = 1; i < gains.size(); ++i) {
+        const float step = gains[i] - gains[i - 1];
+        result.largestStep = std::max(result.largestStep, std::fabs(step));
+        if (step == 0.0f) continue;
+        if (lastStep != 0.0f && (step > 0.0f) != (lastStep > 0.0f)) ++result.reversals;
+        lastStep = step;
+    }
+    const auto half = gains.begin() + static_cast<std::ptrdiff_t>(gains.size() / 2);
+    result.settledSpread = *std::max_element(half, gains.end()) - *std::min_element(half, gains.end());
+    result.meanCoverage = static_cast<float>(coverage / static_cast<double>(gains.size()));
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<Profile> profiles;
+    if (argc > 1) {
+        for (int i = 1; i < argc; ++i) {
+            Profile profile;
+            if (!loadProfile(argv[i], profile)) {
+                std::fprintf(stderr, "cannot read %s\n", argv[i]);
+                return 1;
+            }
+            profiles.push_back(std::move(profile));
+        }
+    } else {
+        profiles = synthesizedProfiles();
+    }
+
+    std::printf("one hour per profile; gains in dB relative to the user's volume\n\n");
+    std::printf("%-18s %7s %15s %7s %9s %10s %9s %9s\n", "profile", "final", "range", "step", "reversals",
+                "last 30 m", "coverage", "run time");
+    for (const Profile& profile : profiles) {
+        const Result r = simulate(profile);
+        std::printf("%-18s %+7.1f %+6.1f..%+6.1f %7.1f %9d %8.1f dB %8.0f%% %7.2f s\n", profile.name.c_str(),
+                    r.finalGain, r.lowGain, r.highGain, r.largestStep, r.reversals, r.settledSpread,
+                    r.meanCoverage * 100.0f, r.seconds);
+    }
+    return 0;
+}
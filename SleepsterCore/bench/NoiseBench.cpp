@@ -0,0 +1,112 @@
+//
+//  NoiseBench.cpp
+//  SleepsterCore
+//
+//  Cost per stereo frame of the procedural noise sources, next to one
+//  streamed voice. The streamed voice decodes 16-bit WAV, the cheapest
+//  format there is, so an MP3 voice on a device costs more than shown.
+//
+//  Usage: NoiseBench [seconds]
+//
+
+#include "BenchUtil.hpp"
+
+#include "sleepster/NoiseSource.hpp"
+#include "sleepster/StreamingSource.hpp"
+#include "sleepster/WavFile.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace sleepster;
+using namespace sleepster::bench;
+
+namespace {
+
+constexpr double kRate = 48000.0;
+constexpr std::size_t kBlock = 512;
+
+/// Nanoseconds per frame, best of three runs. `everyBlock` runs before each
+/// block, outside the timing.
+template <typename EveryBlock>
+double nsPerFrame(AudioSource& source, double seconds, EveryBlock&& everyBlock) {
+    std::vector<float> left(kBlock), right(kBlock);
+    const std::size_t blocks = static_cast<std::size_t>(seconds / 3 * kRate / kBlock);
+    double best = 1e30;
+    for (int run = 0; run < 3; ++run) {
+        double elapsed = 0.0;
+        for (std::size_t b = 0; b < blocks; ++b) {
+            everyBlock(b);
+            const double start = nowSeconds();
+            source.render(left.data(), right.data(), kBlock);
+            elapsed += nowSeconds() - start;
+            sink += left[kBlock - 1];
+        }
+        best = std::min(best, elapsed * 1e9 / static_cast<double>(blocks * kBlock));
+    }
+    return best;
+}
+
+void report(const char* name, double ns) {
+    // One frame of real time at 48 kHz is 20833 ns.
+    std::printf("%-26s %8.2f ns/frame  (%.4f%% of one core)\n", name, ns, 100.0 * ns * kRate / 1e9);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 60.0;
+    std::printf("Stereo at %.0f kHz, %zu-frame blocks, %.0f s of audio per case\n", kRate / 1000.0, kBlock,
+                seconds);
+
+    const struct {
+        const char* name;
+        NoiseColor color;
+    } colors[] = {
+        {"noise white", NoiseColor::White},
+        {"noise pink", NoiseColor::Pink},
+        {"noise brown", NoiseColor::Brown},
+    };
+    for (const auto& entry : colors) {
+        NoiseSource source(entry.color, 1);
+        source.prepare(kRate, kBlock);
+        report(entry.name, nsPerFrame(source, seconds, [](std::size_t) {}));
+    }
+    {
+        // Sweeps between white and brown every half second, so most blocks
+        // run the blended path.
+        NoiseSource source(NoiseColor::White, 1);
+        source.prepare(kRate, kBlock);
+        const std::size_t period = static_cast<std::size_t>(0.5 * kRate / kBlock);
+        report("noise gliding tilt", nsPerFrame(source, seconds, [&](std::size_t b) {
+                   if (b % period == 0) {
+                       source.setParameter(NoiseSource::kTiltParameter, (b / period) % 2 ? 0.0f : -6.0f);
+                   }
+               }));
+    }
+
+    // One streamed voice: render-thread time plus the decode thread's CPU.
+    const std::string path = "/tmp/sleepster_noise_bench_track.wav";
+    if (!writeSyntheticTrack(path, 30.0, 44100.0)) {
+        std::fprintf(stderr, "failed to write %s\n", path.c_str());
+        return 1;
+    }
+    {
+        StreamingSource source(WavDecoder::open(path), StreamingConfig{});
+        source.prepare(kRate, kBlock);
+        StreamDecodeWorker& worker = StreamDecodeWorker::shared();
+        const double decodeStart = worker.cpuSeconds();
+        // Paced so the decode thread keeps up, as it would on a device.
+        const double render = nsPerFrame(source, seconds, [](std::size_t b) {
+            if (b % 16 == 0) usleep(1000);
+        });
+        const double frames = 3.0 * static_cast<std::size_t>(seconds / 3 * kRate / kBlock) * kBlock;
+        const double decode = (worker.cpuSeconds() - decodeStart) * 1e9 / frames;
+        report("streamed WAV render", render);
+        report("streamed WAV decode", decode);
+        report("streamed WAV total", render + decode);
+    }
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,114 @@
+//
+//  OfflineRenderBench.cpp
+//  SleepsterCore
+//
+//  Offline render throughput (seconds of audio per second of wall time) by
+//  thread count, for a preset-style mix: a looping sound from the pack, two
+//  noise beds, fades, and the EQ, delay and reverb all running. Thread
+//  counts beyond the machine's cores are still shown but cannot scale.
+//
+//  Usage: OfflineRenderBench [mixMinutes] [chunkSeconds]
+//
+
+#include "BenchUtil.hpp"
+
+#include "sleepster/AssetPack.hpp"
+#include "sleepster/AssetPackWriter.hpp"
+#include "sleepster/NoiseSource.hpp"
+#include "sleepster/OfflineRender.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+using namespace sleepster;
+using namespace sleepster::bench;
+
+namespace {
+
+constexpr double kRate = 48000.0;
+
+OfflineMix presetMix(const std::shared_ptr<const AssetPack>& pack, double seconds) {
+    OfflineMix mix;
+    mix.sampleRate = kRate;
+    mix.durationSeconds = seconds;
+    const AssetView view = *pack->find("track");
+    mix.tracks.push_back({[pack, view] { return std::make_unique<PackedSource>(pack, view, true); }, 0.8f, 2.0, 30.0});
+    mix.tracks.push_back({[] { return std::make_unique<NoiseSource>(NoiseColor::Pink, 1); }, 0.3f, 3.0, 30.0});
+    mix.tracks.push_back({[] { return std::make_unique<NoiseSource>(NoiseColor::Brown, 2); }, 0.2f, 3.0, 30.0});
+    mix.bus.equalizerEnabled = true;
+    mix.bus.equalizerGainsDb = {3, 2, 0, 0, -1, 0, 0, -2, -4, -6};
+    mix.bus.delayEnabled = true;
+    mix.bus.delaySeconds = 0.3;
+    mix.bus.delayFeedback = 0.3f;
+    mix.bus.reverbEnabled = true;
+    mix.bus.reverbPreset = ReverbPreset::Hall;
+    return mix;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double minutes = argc > 1 ? std::atof(argv[1]) : 10.0;
+    const double chunkSeconds = argc > 2 ? std::atof(argv[2]) : OfflineRenderOptions{}.chunkSeconds;
+    const std::string wav = "/tmp/sleepster_offline_bench_track.wav";
+    const std::string packPath = "/tmp/sleepster_offline_bench.slpk";
+    const std::string out = "/tmp/sleepster_offline_bench.caf";
+
+    if (!writeSyntheticTrack(wav, 60.0, kRate)) {
+        std::fprintf(stderr, "failed to write %s\n", wav.c_str());
+        return 1;
+    }
+    {
+        auto decoder = WavDecoder::open(wav);
+        PcmBuffer buffer;
+        buffer.sampleRate = decoder->sampleRate();
+        buffer.frameCount = static_cast<std::size_t>(decoder->frameCount());
+        buffer.channels.assign(2, std::vector<float>(buffer.frameCount));
+        decoder->decode(buffer.channels[0].data(), buffer.channels[1].data(), buffer.frameCount);
+        EncodedAsset asset;
+        if (!encodeAsset("track", buffer, AssetPackOptions{}, asset) || !writeAssetPack(packPath, {asset}, kRate)) {
+            std::fprintf(stderr, "failed to write %s\n", packPath.c_str());
+            return 1;
+        }
+    }
+    const auto pack = AssetPack::open(packPath);
+    const OfflineMix mix = presetMix(pack, minutes * 60.0);
+
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("mix: %.0f min, 3 tracks, EQ + delay + hall reverb; %.0f s chunks, %.1f s pre-roll; %u core(s)\n\n",
+                minutes, chunkSeconds, mix.bus.settlingSeconds(), cores);
+    const auto discard = [](const float* left, const float* right, std::size_t frames) {
+        sink += left[frames - 1] + right[frames - 1];
+        return true;
+    };
+
+    // One chunk: no pre-roll, the cost of the mix itself.
+    OfflineRenderStats single;
+    renderOffline(mix, {1, mix.durationSeconds}, discard, &single);
+    std::printf("  single pass, 1 thread: %.0fx real time\n\n", single.realTimeFactor);
+
+    std::printf("  %-8s %12s %10s %11s\n", "threads", "x real time", "speedup", "efficiency");
+
+    double baseline = 0.0;
+    for (unsigned threads = 1; threads <= std::max(4u, cores); threads *= 2) {
+        OfflineRenderStats stats;
+        renderOffline(mix, {threads, chunkSeconds}, discard, &stats);
+        if (threads == 1) baseline = stats.realTimeFactor;
+        const double speedup = stats.realTimeFactor / baseline;
+        std::printf("  %-8u %11.0fx %9.2fx %10.0f%%%s\n", threads, stats.realTimeFactor, speedup,
+                    100.0 * speedup / threads, threads > cores ? "  (more threads than cores)" : "");
+    }
+
+    // The whole path, including 16-bit conversion and the file writes.
+    OfflineRenderStats stats;
+    const bool ok = renderOfflineToFile(mix, {0, chunkSeconds}, out, AudioFileType::Caf,
+                                        WavFormat::Encoding::Pcm16, &stats);
+    std::printf("\n  to 16-bit CAF, %u thread(s): %.0fx real time%s\n", stats.threads, stats.realTimeFactor,
+                ok ? "" : " (write failed)");
+
+    std::remove(out.c_str());
+    std::remove(wav.c_str());
+    std::remove(packPath.c_str());
+    return 0;
+}
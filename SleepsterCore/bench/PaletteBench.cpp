@@ -0,0 +1,222 @@
+//
+//  PaletteBench.cpp
+//  SleepsterCore
+//
+//  Per-frame colour work of a busy background (sky, twelve clouds, eight
+//  sheep shadows, nine caustics, forty bubbles, a mandala and two dozen
+//  crystals), two ways:
+//
+//  - runtime: what the view bodies did. Every element switches on the
+//    theme for its base colour, picks the dimmed or lit opacity, scales
+//    it by its own alpha and intensity, and collects the stops in a fresh
+//    array, as a Swift array literal of Colors does.
+//  - palette: the view holds the palette for its theme, dimmed state and
+//    tier, with each per-element gradient prepared at 256 alpha levels as
+//    ThemePalette keeps them. An element indexes by its alpha.
+//
+//  It also reports the one-off cost and size of building every palette.
+//
+//  Usage: PaletteBench [frames]
+//
+
+#include "BenchUtil.hpp"
+
+#include "sleepster/Palette.hpp"
+#include "sleepster/Random.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace sleepster;
+using namespace sleepster::bench;
+
+static std::atomic<std::size_t> allocationCount{0};
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+constexpr int kClouds = 12;
+constexpr int kShadows = 8;
+constexpr int kCaustics = 9;
+constexpr int kBubbles = 40;
+constexpr int kCrystals = 24;
+
+struct Rgba {
+    float r, g, b, a;
+};
+
+volatile uint32_t gSink = 0;
+
+/// getThemeColor and friends, resolved per call.
+Rgba themeColor(PaletteTheme theme) {
+    switch (theme) {
+    case PaletteTheme::Warm: return {1.0f, 0.62f, 0.04f, 1.0f};
+    case PaletteTheme::Cool: return {0.39f, 0.82f, 1.0f, 1.0f};
+    case PaletteTheme::Monochrome: return {1.0f, 1.0f, 1.0f, 1.0f};
+    default: return {0.75f, 0.35f, 0.95f, 1.0f};
+    }
+}
+
+Rgba opacity(Rgba color, float alpha) {
+    color.a *= alpha;
+    return color;
+}
+
+uint32_t consume(const std::vector<Rgba>& stops) {
+    uint32_t hash = 0;
+    for (const Rgba& stop : stops) hash += packColor(stop.r, stop.g, stop.b, stop.a);
+    return hash;
+}
+
+/// Element alphas for a frame, the same for both ways.
+struct Scene {
+    float clouds[kClouds];
+    float shadows[kShadows];
+    float bubbles[kBubbles];
+    float crystals[kCrystals];
+
+    explicit Scene(uint64_t seed) {
+        Random random(seed);
+        for (float& alpha : clouds) alpha = random.uniform();
+        for (float& alpha : shadows) alpha = random.uniform();
+        for (float& alpha : bubbles) alpha = random.uniform();
+        for (float& alpha : crystals) alpha = random.uniform();
+    }
+};
+
+const Rgba kWhite = {1.0f, 1.0f, 1.0f, 1.0f};
+const Rgba kGray = {0.56f, 0.56f, 0.58f, 1.0f};
+const Rgba kBlack = {0.0f, 0.0f, 0.0f, 1.0f};
+const Rgba kCyan = {0.39f, 0.82f, 1.0f, 1.0f};
+const Rgba kClear = {0.0f, 0.0f, 0.0f, 0.0f};
+
+uint32_t runtimeFrame(const Scene& scene, PaletteTheme theme, bool dimmed, float intensity) {
+    uint32_t hash = consume({opacity(kBlack, dimmed ? 0.95f : 0.85f),
+                             opacity({0.37f, 0.36f, 0.9f, 1.0f}, dimmed ? 0.4f : 0.6f),
+                             opacity({0.75f, 0.35f, 0.95f, 1.0f}, dimmed ? 0.2f : 0.4f)});
+    for (float alpha : scene.clouds) {
+        hash += consume({opacity(kWhite, alpha * (dimmed ? 0.2f : 0.4f)),
+                         opacity(kGray, alpha * (dimmed ? 0.1f : 0.2f))});
+    }
+    for (float alpha : scene.shadows) {
+        hash += consume({opacity(kBlack, alpha * (dimmed ? 0.2f : 0.4f))});
+    }
+    for (int i = 0; i < kCaustics; ++i) {
+        hash += consume({opacity(kCyan, (dimmed ? 0.02f : 0.08f) * intensity),
+                         opacity(kWhite, (dimmed ? 0.01f : 0.04f) * intensity)});
+    }
+    for (float alpha : scene.bubbles) {
+        hash += consume({opacity(kWhite, alpha * (dimmed ? 0.2f : 0.4f)),
+                         opacity(kCyan, alpha * (dimmed ? 0.1f : 0.2f)), kClear});
+    }
+    hash += consume({opacity(themeColor(theme), (dimmed ? 0.1f : 0.3f) * intensity),
+                     opacity(themeColor(theme), (dimmed ? 0.05f : 0.15f) * intensity), kClear});
+    for (float alpha : scene.crystals) {
+        hash += consume({opacity(themeColor(theme), alpha * (dimmed ? 0.3f : 0.7f)),
+                         opacity(themeColor(theme), alpha * (dimmed ? 0.1f : 0.4f)), kClear});
+    }
+    return hash;
+}
+
+/// A palette's gradients at 256 alpha levels, as the app keeps them.
+struct LevelTable {
+    GradientStops levels[kPaletteGradientCount][palette::kRampSize];
+
+    explicit LevelTable(const Palette& colors) {
+        for (std::size_t g = 0; g < kPaletteGradientCount; ++g) {
+            const GradientStops& stops = colors.gradients[g];
+            for (std::size_t level = 0; level < palette::kRampSize; ++level) {
+                GradientStops& scaled = levels[g][level];
+                scaled.count = stops.count;
+                for (std::size_t i = 0; i < palette::kMaxStops; ++i) {
+                    const PackedColor color = stops.colors[i];
+                    const uint32_t alpha = (color & 0xFFu) * static_cast<uint32_t>(level) / 255u;
+                    scaled.colors[i] = (color & 0xFFFFFF00u) | alpha;
+                }
+            }
+        }
+    }
+
+    const GradientStops& at(PaletteGradient gradient, float alpha) const {
+        return levels[static_cast<std::size_t>(gradient)][static_cast<std::size_t>(alpha * 255.0f + 0.5f)];
+    }
+};
+
+uint32_t paletteFrame(const Scene& scene, const Palette& colors, const LevelTable& table) {
+    uint32_t hash = colors.stops(PaletteGradient::MeadowSky).colors[0];
+    for (float alpha : scene.clouds) hash += table.at(PaletteGradient::Cloud, alpha).colors[0];
+    for (float alpha : scene.shadows) hash += colors.sample(PaletteGradient::SheepShadow, alpha);
+    for (int i = 0; i < kCaustics; ++i) hash += colors.stops(PaletteGradient::Caustics).colors[0];
+    for (float alpha : scene.bubbles) hash += table.at(PaletteGradient::Bubble, alpha).colors[1];
+    hash += colors.stops(PaletteGradient::MandalaGlow).colors[0];
+    for (float alpha : scene.crystals) hash += table.at(PaletteGradient::Crystal, alpha).colors[0];
+    return hash;
+}
+
+struct Cost {
+    double usPerFrame = 1e30;
+    double allocationsPerFrame = 0.0;
+};
+
+template <typename Frame>
+Cost measure(int frames, Frame&& frame) {
+    Cost best;
+    for (int run = 0; run < 5; ++run) {
+        const std::size_t allocations = allocationCount.load();
+        const double start = nowSeconds();
+        for (int f = 0; f < frames; ++f) frame(f);
+        best.usPerFrame = std::min(best.usPerFrame, (nowSeconds() - start) * 1e6 / frames);
+        best.allocationsPerFrame = static_cast<double>(allocationCount.load() - allocations) / frames;
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? std::atoi(argv[1]) : 20000;
+
+    const double buildStart = nowSeconds();
+    gSink = gSink + themePalette(PaletteTheme::Default, false, 0).swatches[0];
+    const double buildMs = (nowSeconds() - buildStart) * 1e3;
+    const std::size_t count = palette::kThemeCount * 2 * palette::kTierCount;
+    std::printf("Every palette (%zu): built once in %.2f ms, %.0f KB\n", count, buildMs,
+                static_cast<double>(count * sizeof(Palette)) / 1024.0);
+
+    const double tableStart = nowSeconds();
+    const Palette& colors = themePalette(PaletteTheme::Cool, false, 2);
+    const LevelTable table(colors);
+    std::printf("Alpha levels for one palette: %.3f ms, %.0f KB\n\n", (nowSeconds() - tableStart) * 1e3,
+                static_cast<double>(sizeof(LevelTable)) / 1024.0);
+
+    std::vector<Scene> scenes;
+    for (uint64_t seed = 0; seed < 64; ++seed) scenes.emplace_back(seed);
+
+    const Cost runtime = measure(frames, [&](int f) {
+        gSink = gSink + runtimeFrame(scenes[static_cast<std::size_t>(f) & 63], PaletteTheme::Cool, false, 2.0f / 3.0f);
+    });
+    const Cost indexed = measure(frames, [&](int f) {
+        gSink = gSink + paletteFrame(scenes[static_cast<std::size_t>(f) & 63], colors, table);
+    });
+
+    std::printf("%-10s %14s %18s\n", "", "us per frame", "allocs per frame");
+    std::printf("%-10s %14.3f %18.1f\n", "runtime", runtime.usPerFrame, runtime.allocationsPerFrame);
+    std::printf("%-10s %14.3f %18.1f\n", "palette", indexed.usPerFrame, indexed.allocationsPerFrame);
+    return 0;
+}
@@ -0,0 +1,178 @@
+//
+//  ParticleBench.cpp
+//  SleepsterCore
+//
+//  Update cost per frame of the particle motions at 1k, 10k and 100k
+//  particles, next to an array-of-structs baseline written the way the
+//  Swift backgrounds used to update floating sheep: one struct per particle,
+//  doubles, and libm sin/cos per field. A 60 Hz frame is 16.7 ms.
+//
+//  Usage: ParticleBench [frames]
+//
+
+#include "BenchUtil.hpp"
+
+#include "sleepster/ParticleSystem.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace sleepster;
+using namespace sleepster::bench;
+
+namespace {
+
+constexpr double kStep = 1.0 / 60.0;
+
+ParticleConfig configFor(ParticleMotion motion, std::size_t count) {
+    ParticleConfig config;
+    config.motion = motion;
+    config.count = count;
+    config.bounds = {-200.0f, -50.0f, 600.0f, 900.0f};
+    config.x = {-200.0f, 600.0f};
+    config.y = {-50.0f, 900.0f};
+    config.size = {1.0f, 4.0f};
+    switch (motion) {
+    case ParticleMotion::Static:
+        break;
+    case ParticleMotion::Drift:
+        config.velocityX = {-10.0f, 10.0f};
+        config.velocityY = {-4.0f, 4.0f};
+        break;
+    case ParticleMotion::Orbit:
+        config.velocityX = {9.0f, 36.0f};
+        config.radiusX = {20.0f, 80.0f};
+        config.radiusY = {10.0f, 40.0f};
+        config.orbitRate = {0.3f, 1.4f};
+        break;
+    case ParticleMotion::Fall:
+        config.velocityY = {250.0f, 500.0f};
+        config.radiusX = {5.0f, 20.0f};
+        config.orbitRate = {0.5f, 1.5f};
+        config.windX = 30.0f;
+        break;
+    }
+    return config;
+}
+
+/// Microseconds per frame, best of three runs.
+template <typename Step>
+double usPerFrame(int frames, Step&& step) {
+    double best = 1e30;
+    for (int run = 0; run < 3; ++run) {
+        const double start = nowSeconds();
+        for (int f = 0; f < frames; ++f) step();
+        best = std::min(best, (nowSeconds() - start) * 1e6 / frames);
+    }
+    return best;
+}
+
+double sceneCost(const ParticleConfig& config, int frames) {
+    ParticleScene scene(1);
+    scene.add(config);
+    const double us = usPerFrame(frames, [&] { scene.update(kStep); });
+    sink += scene.system(0).x()[0];
+    return us;
+}
+
+/// The old per-struct update of a floating sheep, minus the SwiftUI state.
+struct FloatingSheep {
+    double x, y, baseX, baseY;
+    double verticalPhase, horizontalPhase, rotationPhase;
+    double verticalFrequency, horizontalFrequency, rotationFrequency;
+    double floatAmplitude, floatRadius, driftSpeed;
+    double jumpHeight, rotation, scale, baseScale, shadowOpacity;
+};
+
+double arrayOfStructsCost(std::size_t count, int frames) {
+    Random random(1);
+    std::vector<FloatingSheep> sheep(count);
+    for (auto& s : sheep) {
+        s = {};
+        s.baseX = random.uniform(-200.0f, 600.0f);
+        s.baseY = random.uniform(150.0f, 500.0f);
+        s.verticalPhase = random.uniform(0.0f, 6.28f);
+        s.horizontalPhase = random.uniform(0.0f, 6.28f);
+        s.rotationPhase = random.uniform(0.0f, 6.28f);
+        s.verticalFrequency = random.uniform(0.8f, 1.4f);
+        s.horizontalFrequency = random.uniform(0.5f, 1.0f);
+        s.rotationFrequency = random.uniform(0.3f, 0.7f);
+        s.floatAmplitude = random.uniform(15.0f, 40.0f);
+        s.floatRadius = random.uniform(20.0f, 80.0f);
+        s.driftSpeed = random.uniform(0.3f, 1.2f);
+        s.baseScale = random.uniform(1.2f, 2.0f);
+    }
+    const double us = usPerFrame(frames, [&] {
+        for (auto& s : sheep) {
+            s.verticalPhase += 0.015 * s.verticalFrequency;
+            s.horizontalPhase += 0.01 * s.horizontalFrequency;
+            s.rotationPhase += 0.008 * s.rotationFrequency;
+            const double vertical = std::sin(s.verticalPhase) * s.floatAmplitude * 0.4;
+            const double horizontal = std::cos(s.horizontalPhase) * s.floatAmplitude * 0.6;
+            const double orbitalX = std::cos(s.horizontalPhase * 0.7) * s.floatRadius * 0.3;
+            const double orbitalY = std::sin(s.verticalPhase * 0.5) * s.floatRadius * 0.2;
+            s.baseX += s.driftSpeed * 0.03;
+            s.x = s.baseX + horizontal + orbitalX;
+            s.jumpHeight = vertical + orbitalY;
+            s.rotation = std::sin(s.rotationPhase) * 0.1;
+            s.scale = s.baseScale * (1.0 + std::sin(s.verticalPhase * 1.3) * 0.05);
+            s.shadowOpacity = 0.1 + std::fabs(s.jumpHeight) / s.floatAmplitude * 0.3;
+            if (s.x > 800.0) s.baseX = -200.0;
+        }
+    });
+    sink += static_cast<float>(sheep[0].x);
+    return us;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? std::atoi(argv[1]) : 600;
+    std::printf("Update cost per %.1f ms frame, best of 3 x %d frames\n\n", kStep * 1000.0, frames);
+    std::printf("%-28s %12s %12s %12s\n", "", "1k", "10k", "100k");
+
+    const std::size_t counts[] = {1000, 10000, 100000};
+    const struct {
+        const char* name;
+        ParticleMotion motion;
+        bool twinkle;
+    } cases[] = {
+        {"static + twinkle", ParticleMotion::Static, true},
+        {"drift", ParticleMotion::Drift, false},
+        {"orbit", ParticleMotion::Orbit, false},
+        {"orbit + twinkle", ParticleMotion::Orbit, true},
+        {"fall with wind and sway", ParticleMotion::Fall, false},
+    };
+    for (const auto& entry : cases) {
+        std::printf("%-28s", entry.name);
+        for (std::size_t count : counts) {
+            ParticleConfig config = configFor(entry.motion, count);
+            if (entry.twinkle) {
+                config.twinkleRate = {0.5f, 2.0f};
+                config.twinkleDepth = 0.6f;
+            }
+            const double us = sceneCost(config, count >= 100000 ? frames / 10 : frames);
+            std::printf(" %9.1f us", us);
+        }
+        std::printf("\n");
+    }
+
+    std::printf("%-28s", "AoS floating sheep (old)");
+    for (std::size_t count : counts) {
+        std::printf(" %9.1f us", arrayOfStructsCost(count, count >= 100000 ? frames / 10 : frames));
+    }
+    std::printf("\n\nns per particle per frame at 100k:\n");
+    for (const auto& entry : cases) {
+        ParticleConfig config = configFor(entry.motion, 100000);
+        if (entry.twinkle) {
+            config.twinkleRate = {0.5f, 2.0f};
+            config.twinkleDepth = 0.6f;
+        }
+        std::printf("  %-26s %6.2f ns\n", entry.name, sceneCost(config, frames / 10) * 1000.0 / 100000.0);
+    }
+    std::printf("  %-26s %6.2f ns\n", "AoS floating sheep (old)",
+                arrayOfStructsCost(100000, frames / 10) * 1000.0 / 100000.0);
+    return 0;
+}
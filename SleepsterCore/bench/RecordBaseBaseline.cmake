@@ -0,0 +1,43 @@
+#
+#  RecordBaseBaseline.cmake
+#  SleepsterCore
+#
+#  Builds DspBench as of the revision BASE in a scratch worktree and
+#  records its baseline to OUTPUT, so that bench_gate measures a change
+#  against the code it changes, on the same machine.
+#
+#  cmake -DSOURCE_DIR=... -DWORK_DIR=... -DBASE=HEAD -DOUTPUT=... -P RecordBaseBaseline.cmake
+#
+
+foreach(variable SOURCE_DIR WORK_DIR BASE OUTPUT)
+    if(NOT DEFINED ${variable})
+        message(FATAL_ERROR "RecordBaseBaseline.cmake needs -D${variable}=...")
+    endif()
+endforeach()
+
+find_package(Git REQUIRED)
+
+function(run)
+    execute_process(COMMAND ${ARGN} RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "failed (${result}): ${ARGN}")
+    endif()
+endfunction()
+
+execute_process(COMMAND ${GIT_EXECUTABLE} -C ${SOURCE_DIR} rev-parse --show-toplevel
+                OUTPUT_VARIABLE top OUTPUT_STRIP_TRAILING_WHITESPACE RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${SOURCE_DIR} is not in a git checkout")
+endif()
+file(RELATIVE_PATH core ${top} ${SOURCE_DIR})
+
+set(tree ${WORK_DIR}/base)
+execute_process(COMMAND ${GIT_EXECUTABLE} -C ${top} worktree remove --force ${tree} OUTPUT_QUIET ERROR_QUIET)
+file(REMOVE_RECURSE ${tree})
+run(${GIT_EXECUTABLE} -C ${top} worktree add --detach ${tree} ${BASE})
+run(${CMAKE_COMMAND} -S ${tree}/${core} -B ${tree}/_build -DCMAKE_BUILD_TYPE=Release
+    -DSLEEPSTER_BUILD_TESTS=OFF -DSLEEPSTER_BUILD_TOOLS=OFF)
+run(${CMAKE_COMMAND} --build ${tree}/_build --target DspBench --parallel)
+run(${tree}/_build/DspBench --passes 3 --output ${OUTPUT})
+run(${GIT_EXECUTABLE} -C ${top} worktree remove --force ${tree})
+message(STATUS "Recorded the baseline of ${BASE} in ${OUTPUT}")
@@ -0,0 +1,178 @@
+//
+//  SessionLogBench.cpp
+//  SleepsterCore
+//
+//  Cost of keeping ten years of nightly sleep sessions:
+//
+//  - append: storing one session in the log, over the first and the last
+//    hundred nights, against what SleepTracker did before, re-encoding and
+//    rewriting every stored session (timed at the 100th and the last
+//    night). The old store was JSON in UserDefaults; rewriting the log's
+//    own binary encoding is a lower bound on its cost.
+//  - load: opening the log (index only) and decoding every session.
+//  - compaction of a log in which every night was stored twice, once when
+//    it started and once when it ended.
+//
+//  Usage: SessionLogBench [years] [directory]
+//
+
+#include "BenchUtil.hpp"
+
+#include "sleepster/SessionLog.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace sleepster;
+using namespace sleepster::bench;
+
+namespace {
+
+SleepSessionRecord nightOf(int night) {
+    static const char* const kSounds[] = {"Rain", "Ocean Waves", "Thunderstorm", "White Noise", "Forest"};
+    SleepSessionRecord session;
+    for (int i = 0; i < 4; ++i) session.id[i] = static_cast<uint8_t>(night >> (8 * i));
+    session.startTime = 1.4e9 + night * 86400.0;
+    session.endTime = session.startTime + 7.0 * 3600.0 + (night % 90) * 60.0;
+    session.expectedDuration = 8 * 3600.0;
+    session.actualDuration = session.endTime - session.startTime;
+    session.soundsUsed = {kSounds[night % 5], kSounds[(night + 2) % 5]};
+    session.hasBackground = true;
+    session.backgroundUsed = "Counting Sheep";
+    session.masterVolume = 0.6f;
+    session.activeSounds = session.soundsUsed;
+    session.equalizerPreset = "Sleep";
+    session.effectsEnabled = night % 2 == 0;
+    return session;
+}
+
+void removeLog(const std::string& path) {
+    std::remove(path.c_str());
+    std::remove((path + ".idx").c_str());
+}
+
+/// What storing one more session cost before: encode them all, write them
+/// all.
+double rewriteAll(const std::vector<SleepSessionRecord>& sessions, const std::string& path) {
+    const double start = nowSeconds();
+    std::vector<uint8_t> blob;
+    for (const SleepSessionRecord& session : sessions) encodeSession(session, blob);
+    if (std::FILE* file = std::fopen(path.c_str(), "wb")) {
+        std::fwrite(blob.data(), 1, blob.size(), file);
+        std::fclose(file);
+    }
+    return nowSeconds() - start;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int years = argc > 1 ? std::atoi(argv[1]) : 10;
+    const std::string directory = argc > 2 ? argv[2] : "/tmp";
+    const int nights = years * 365;
+    const std::string path = directory + "/sleepster_bench.slog";
+    const std::string blobPath = directory + "/sleepster_bench.blob";
+
+    std::vector<SleepSessionRecord> sessions;
+    for (int night = 0; night < nights; ++night) sessions.push_back(nightOf(night));
+
+    // Appends, timed one by one.
+    removeLog(path);
+    SessionLogOptions options;
+    options.syncEachAppend = false;
+    std::vector<double> appendSeconds;
+    {
+        auto log = SessionLog::open(path, options);
+        if (!log) {
+            std::fprintf(stderr, "cannot open %s\n", path.c_str());
+            return 1;
+        }
+        for (const SleepSessionRecord& session : sessions) {
+            const double start = nowSeconds();
+            log->append(session);
+            appendSeconds.push_back(nowSeconds() - start);
+        }
+    }
+    auto meanMicros = [&](std::size_t from, std::size_t count) {
+        double total = 0.0;
+        for (std::size_t i = from; i < from + count; ++i) total += appendSeconds[i];
+        return total / static_cast<double>(count) * 1e6;
+    };
+    const std::size_t tail = std::min<std::size_t>(100, sessions.size());
+
+    std::vector<SleepSessionRecord> prefix(sessions.begin(), sessions.begin() + tail);
+    const double rewriteEarly = rewriteAll(prefix, blobPath);
+    const double rewriteLate = rewriteAll(sessions, blobPath);
+    std::remove(blobPath.c_str());
+
+    // A synced append, as the app makes them.
+    double syncedMicros = 0.0;
+    {
+        auto log = SessionLog::open(path);
+        const int appends = 20;
+        const double start = nowSeconds();
+        for (int i = 0; i < appends; ++i) log->append(nightOf(nights + i));
+        syncedMicros = (nowSeconds() - start) / appends * 1e6;
+    }
+    removeLog(path);
+    {
+        auto log = SessionLog::open(path, options);
+        for (const SleepSessionRecord& session : sessions) log->append(session);
+    }
+
+    std::printf("%d nights (%d years)\n\n", nights, years);
+    std::printf("%-34s %12s %12s\n", "store one session", "first 100", "last 100");
+    std::printf("%-34s %10.1f us %10.1f us\n", "log append", meanMicros(0, tail),
+                meanMicros(sessions.size() - tail, tail));
+    std::printf("%-34s %10.1f us %10.1f us\n", "rewrite every session (old store)", rewriteEarly * 1e6,
+                rewriteLate * 1e6);
+    std::printf("%-34s %10.1f us\n\n", "log append with fsync", syncedMicros);
+
+    // Loading, best of five.
+    double openBest = 1e30;
+    double loadBest = 1e30;
+    std::size_t loaded = 0;
+    for (int run = 0; run < 5; ++run) {
+        const double start = nowSeconds();
+        auto log = SessionLog::open(path, options);
+        const double opened = nowSeconds();
+        SleepSessionRecord session;
+        loaded = 0;
+        for (std::size_t i = 0; i < log->size(); ++i) loaded += log->read(i, session) ? 1 : 0;
+        openBest = std::min(openBest, opened - start);
+        loadBest = std::min(loadBest, nowSeconds() - start);
+    }
+    std::printf("open (index only)          %8.2f ms\n", openBest * 1e3);
+    std::printf("open and decode %zu     %8.2f ms\n", loaded, loadBest * 1e3);
+
+    std::size_t logBytes = 0;
+    {
+        auto log = SessionLog::open(path, options);
+        logBytes = log->fileBytes();
+    }
+    const std::size_t indexBytes = sessionlog::kHeaderSize + sessions.size() * sessionlog::kEntrySize;
+    std::printf("log %.2f MB, index %.2f MB, %.0f bytes per session\n\n", megabytes(logBytes),
+                megabytes(indexBytes), static_cast<double>(logBytes) / sessions.size());
+
+    // Compaction of a log that stored every night twice.
+    removeLog(path);
+    {
+        auto log = SessionLog::open(path, options);
+        for (const SleepSessionRecord& session : sessions) {
+            SleepSessionRecord running = session;
+            running.endTime = running.actualDuration = std::nan("");
+            log->append(running);
+            log->append(session);
+        }
+        const std::size_t before = log->fileBytes();
+        const double start = nowSeconds();
+        log->compact();
+        std::printf("compaction %.2f MB -> %.2f MB   %8.2f ms\n", megabytes(before), megabytes(log->fileBytes()),
+                    (nowSeconds() - start) * 1e3);
+    }
+    removeLog(path);
+    return 0;
+}
@@ -0,0 +1,274 @@
+//
+//  ShapeGeometryBench.cpp
+//  SleepsterCore
+//
+//  Path construction cost per frame for each shape the sacred-geometry
+//  background draws, plus the sheep, two ways:
+//
+//  - rebuilt: what `path(in:)` did on every call. A fresh path is built
+//    with libm sin/cos for every vertex, as the SwiftUI shapes were written.
+//  - placed: the unit outline from `unitShape` is scaled and translated
+//    into a buffer that is reused from frame to frame. This is what a
+//    rect change costs; at an unchanged rect the app returns the path it
+//    already placed.
+//
+//  It also reports the heap allocations made per frame.
+//
+//  Usage: ShapeGeometryBench [frames]
+//
+
+#include "BenchUtil.hpp"
+
+#include "sleepster/ShapeGeometry.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace sleepster;
+using namespace sleepster::bench;
+
+static std::atomic<std::size_t> allocationCount{0};
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+struct Rect {
+    float x, y, width, height;
+    float midX() const { return x + width / 2.0f; }
+    float midY() const { return y + height / 2.0f; }
+    float side() const { return std::min(width, height); }
+};
+
+// MARK: - Shapes as they were written
+//
+// Each follows the SwiftUI shape's original `path(in:)`, trig included.
+
+void flowerOfLife(ShapePath& path, const Rect& rect) {
+    const float radius = rect.side() / 6.0f;
+    const float h = radius * std::sqrt(3.0f) / 2.0f;
+    const float offsets[7][2] = {{0, 0}, {radius, 0}, {radius / 2, h}, {-radius / 2, h},
+                                 {-radius, 0}, {-radius / 2, -h}, {radius / 2, -h}};
+    for (const auto& offset : offsets) {
+        path.addEllipse(rect.midX() + offset[0] - radius, rect.midY() + offset[1] - radius,
+                        radius * 2.0f, radius * 2.0f);
+    }
+}
+
+void metatronsCube(ShapePath& path, const Rect& rect) {
+    const float radius = rect.side() / 3.0f;
+    float vx[6], vy[6];
+    for (int i = 0; i < 6; ++i) {
+        const double angle = i * kPi / 3.0;
+        vx[i] = rect.midX() + static_cast<float>(std::cos(angle)) * radius;
+        vy[i] = rect.midY() + static_cast<float>(std::sin(angle)) * radius;
+    }
+    for (int i = 0; i < 6; ++i) {
+        for (int j = i + 1; j < 6; ++j) {
+            path.moveTo(vx[i], vy[i]);
+            path.lineTo(vx[j], vy[j]);
+        }
+    }
+    for (int i = 0; i < 6; ++i) {
+        path.moveTo(rect.midX(), rect.midY());
+        path.lineTo(vx[i], vy[i]);
+    }
+}
+
+void triquetra(ShapePath& path, const Rect& rect) {
+    const float radius = rect.side() / 3.0f;
+    for (int i = 0; i < 3; ++i) {
+        const double angle = i * 2.0 * kPi / 3.0;
+        const float cx = rect.midX() + static_cast<float>(std::cos(angle)) * radius * 0.5f;
+        const float cy = rect.midY() + static_cast<float>(std::sin(angle)) * radius * 0.5f;
+        path.addEllipse(cx - radius, cy - radius, radius * 2.0f, radius * 2.0f);
+    }
+}
+
+void triangle(ShapePath& path, const Rect& rect, float size, double rotation) {
+    // Built as its own path and appended, as createTriangle did.
+    ShapePath piece;
+    const float radius = size / 2.0f;
+    for (int i = 0; i < 3; ++i) {
+        const double angle = i * 2.0 * kPi / 3.0 + rotation * kPi / 180.0;
+        const float px = rect.midX() + static_cast<float>(std::cos(angle)) * radius;
+        const float py = rect.midY() + static_cast<float>(std::sin(angle)) * radius;
+        if (i == 0) {
+            piece.moveTo(px, py);
+        } else {
+            piece.lineTo(px, py);
+        }
+    }
+    piece.close();
+    const auto& points = piece.points();
+    path.moveTo(points[0], points[1]);
+    path.lineTo(points[2], points[3]);
+    path.lineTo(points[4], points[5]);
+    path.close();
+}
+
+void sriYantra(ShapePath& path, const Rect& rect) {
+    const float size = rect.side() / 2.0f;
+    for (int i = 0; i < 4; ++i) {
+        const float scale = 1.0f - static_cast<float>(i) * 0.2f;
+        triangle(path, rect, size * scale, i * 15.0);
+        triangle(path, rect, size * scale, i * 15.0 + 180.0);
+    }
+}
+
+void vesicaPiscis(ShapePath& path, const Rect& rect) {
+    const float radius = rect.side() / 3.0f;
+    const float offset = radius * 0.6f;
+    path.addEllipse(rect.midX() - offset - radius, rect.midY() - radius, radius * 2.0f, radius * 2.0f);
+    path.addEllipse(rect.midX() + offset - radius, rect.midY() - radius, radius * 2.0f, radius * 2.0f);
+}
+
+void enneagram(ShapePath& path, const Rect& rect) {
+    const float radius = rect.side() / 2.0f;
+    std::vector<float> px, py;
+    for (int i = 0; i < 9; ++i) {
+        const double angle = i * 2.0 * kPi / 9.0 - kPi / 2.0;
+        px.push_back(rect.midX() + static_cast<float>(std::cos(angle)) * radius);
+        py.push_back(rect.midY() + static_cast<float>(std::sin(angle)) * radius);
+    }
+    for (int i = 0; i < 9; ++i) {
+        path.moveTo(px[i], py[i]);
+        path.lineTo(px[(i + 4) % 9], py[(i + 4) % 9]);
+    }
+}
+
+void sacredMandala(ShapePath& path, const Rect& rect) {
+    const float maxRadius = rect.side() / 2.0f;
+    for (int ring = 1; ring <= 5; ++ring) {
+        const float radius = maxRadius * static_cast<float>(ring) / 5.0f;
+        const int points = ring * 8;
+        for (int i = 0; i < points; ++i) {
+            const double angle = i * 2.0 * kPi / points;
+            const float px = rect.midX() + static_cast<float>(std::cos(angle)) * radius;
+            const float py = rect.midY() + static_cast<float>(std::sin(angle)) * radius;
+            if (i == 0) {
+                path.moveTo(px, py);
+            } else {
+                path.lineTo(px, py);
+            }
+            if (ring <= 2) {
+                path.moveTo(rect.midX(), rect.midY());
+                path.lineTo(px, py);
+            }
+        }
+        path.close();
+    }
+}
+
+void sheep(ShapePath& path, const Rect& rect) {
+    // Same elements as the cached outline, placed point by point.
+    const ShapePath& unit = unitShape(ShapeKind::Sheep);
+    const float scale = rect.side() / 60.0f;
+    const auto& points = unit.points();
+    std::size_t p = 0;
+    auto x = [&](std::size_t i) { return rect.midX() + points[i] * 60.0f * scale; };
+    auto y = [&](std::size_t i) { return rect.midY() + points[i] * 60.0f * scale; };
+    for (PathVerb verb : unit.verbs()) {
+        switch (verb) {
+        case PathVerb::Move: path.moveTo(x(p), y(p + 1)); p += 2; break;
+        case PathVerb::Line: path.lineTo(x(p), y(p + 1)); p += 2; break;
+        case PathVerb::Quad: path.quadTo(x(p), y(p + 1), x(p + 2), y(p + 3)); p += 4; break;
+        case PathVerb::Cubic:
+            path.cubicTo(x(p), y(p + 1), x(p + 2), y(p + 3), x(p + 4), y(p + 5));
+            p += 6;
+            break;
+        case PathVerb::Close: path.close(); break;
+        }
+    }
+}
+
+struct Case {
+    const char* name;
+    ShapeKind kind;
+    void (*rebuild)(ShapePath&, const Rect&);
+};
+
+const Case kCases[] = {
+    {"flower of life", ShapeKind::FlowerOfLife, flowerOfLife},
+    {"metatron's cube", ShapeKind::MetatronsCube, metatronsCube},
+    {"triquetra", ShapeKind::Triquetra, triquetra},
+    {"sri yantra", ShapeKind::SriYantra, sriYantra},
+    {"vesica piscis", ShapeKind::VesicaPiscis, vesicaPiscis},
+    {"enneagram", ShapeKind::Enneagram, enneagram},
+    {"sacred mandala", ShapeKind::SacredMandala, sacredMandala},
+    {"sheep", ShapeKind::Sheep, sheep},
+};
+
+struct Cost {
+    double nsPerFrame = 0.0;
+    double allocationsPerFrame = 0.0;
+};
+
+/// Best of three runs; the rect breathes a little each frame so neither
+/// side can be folded away.
+template <typename Frame>
+Cost measure(int frames, Frame&& frame) {
+    Cost best{1e30, 0.0};
+    for (int run = 0; run < 3; ++run) {
+        const std::size_t allocations = allocationCount.load();
+        const double start = nowSeconds();
+        for (int f = 0; f < frames; ++f) {
+            const float side = 300.0f + static_cast<float>(f % 7);
+            frame(Rect{40.0f, 200.0f, side, side});
+        }
+        best.nsPerFrame = std::min(best.nsPerFrame, (nowSeconds() - start) * 1e9 / frames);
+        best.allocationsPerFrame = static_cast<double>(allocationCount.load() - allocations) / frames;
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? std::atoi(argv[1]) : 100000;
+
+    // Built once, outside the timings.
+    for (const Case& c : kCases) unitShape(c.kind);
+
+    std::printf("%-16s %7s %13s %13s %8s %15s\n", "", "points", "rebuilt ns", "placed ns", "speedup",
+                "allocs rebuilt");
+    for (const Case& c : kCases) {
+        const Cost rebuilt = measure(frames, [&](const Rect& rect) {
+            ShapePath path;
+            c.rebuild(path, rect);
+            sink += path.points().back();
+        });
+
+        const ShapePath& unit = unitShape(c.kind);
+        std::vector<float> placed(unit.points().size());
+        const Cost cached = measure(frames, [&](const Rect& rect) {
+            placeShape(unit, rect.x, rect.y, rect.width, rect.height, placed.data());
+            sink += placed.back();
+        });
+
+        std::printf("%-16s %7zu %13.0f %13.1f %7.0fx %15.1f\n", c.name, unit.pointCount(), rebuilt.nsPerFrame,
+                    cached.nsPerFrame, rebuilt.nsPerFrame / cached.nsPerFrame, rebuilt.allocationsPerFrame);
+        if (cached.allocationsPerFrame > 0.0) {
+            std::printf("  placed path allocated %.1f times per frame\n", cached.allocationsPerFrame);
+        }
+    }
+    return 0;
+}
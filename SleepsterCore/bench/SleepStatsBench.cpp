@@ -0,0 +1,147 @@
+//
+//  SleepStatsBench.cpp
+//  SleepsterCore
+//
+//  Sleep statistics over years of HealthKit-sized history: a watch records
+//  an in-bed sample and a dozen or more asleep segments a night. Each
+//  `StatisticsPeriod` is queried two ways:
+//
+//  - rescan: what SleepTracker did, filtering the whole sample array for
+//    the period and reducing what is left, once per statistic.
+//  - running: one range query on `SleepStats`, which summarizes the
+//    period's nights in O(log n) merges.
+//
+//  Adding and removing samples are timed too, as they now carry the cost.
+//
+//  Usage: SleepStatsBench [years]
+//
+
+#include "BenchUtil.hpp"
+
+#include "sleepster/Random.hpp"
+#include "sleepster/SleepStats.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace sleepster;
+using namespace sleepster::bench;
+
+namespace {
+
+constexpr double kDay = 86400.0;
+constexpr double kHour = 3600.0;
+
+volatile double gSink = 0.0;
+
+std::vector<SleepSample> history(int nights, int64_t lastNight) {
+    Random random(42);
+    std::vector<SleepSample> samples;
+    uint32_t number = 0;
+    auto add = [&](double start, double duration, SleepCategory category) {
+        SleepSample sample;
+        ++number;
+        for (int i = 0; i < 4; ++i) sample.id[i] = static_cast<uint8_t>(number >> (8 * i));
+        sample.startTime = start;
+        sample.endTime = start + duration;
+        sample.utcOffset = -5 * 3600;
+        sample.category = category;
+        samples.push_back(sample);
+    };
+    for (int night = 0; night < nights; ++night) {
+        const double evening = static_cast<double>(lastNight - nights + 1 + night) * kDay + 5 * kHour;
+        const double bedtime = evening + (21.0 + 3.0 * random.uniform()) * kHour;
+        add(bedtime, (7.0 + 2.0 * random.uniform()) * kHour, SleepCategory::InBed);
+        double start = bedtime + 0.25 * kHour;
+        const int segments = 10 + static_cast<int>(random.next() % 10);
+        for (int segment = 0; segment < segments; ++segment) {
+            const double length = (0.3 + 0.4 * random.uniform()) * kHour;
+            add(start, length, SleepCategory::Asleep);
+            start += length + 0.05 * kHour;
+        }
+    }
+    return samples;
+}
+
+/// One pass of the old code: filter to the period, then reduce.
+double rescan(const std::vector<SleepSample>& samples, double from, double to, SleepCategory category) {
+    std::vector<double> durations;
+    for (const SleepSample& sample : samples) {
+        if (sample.startTime >= from && sample.startTime < to && sample.category == category) {
+            durations.push_back(sample.endTime - sample.startTime);
+        }
+    }
+    double total = 0.0;
+    for (double duration : durations) total += duration;
+    return durations.empty() ? 0.0 : total / static_cast<double>(durations.size());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int years = argc > 1 ? std::atoi(argv[1]) : 10;
+    const int nights = years * 365;
+    const int64_t today = 20000;
+    std::vector<SleepSample> samples = history(nights, today);
+
+    // HealthKit hands over history in no particular order.
+    Random random(7);
+    for (std::size_t i = samples.size() - 1; i > 0; --i) std::swap(samples[i], samples[random.next() % (i + 1)]);
+
+    SleepStats stats;
+    double start = nowSeconds();
+    for (const SleepSample& sample : samples) stats.add(sample);
+    const double addSeconds = nowSeconds() - start;
+
+    std::printf("%d nights (%d years), %zu samples\n\n", nights, years, samples.size());
+    std::printf("add      %8.0f ns/sample   (%.1f ms for the history)\n", addSeconds / samples.size() * 1e9,
+                addSeconds * 1e3);
+
+    struct Period {
+        const char* name;
+        int nights;
+    };
+    const Period periods[] = {{"week", 7}, {"month", 30}, {"quarter", 91}, {"year", 365}};
+    std::printf("\n%-10s %14s %14s %10s\n", "period", "rescan", "running", "speedup");
+    for (const Period& period : periods) {
+        const double to = static_cast<double>(today + 1) * kDay + 12 * kHour + 5 * kHour;
+        const double from = to - period.nights * kDay;
+
+        // The old statistics made an asleep pass and an in-bed pass.
+        const int rescans = 20;
+        start = nowSeconds();
+        for (int i = 0; i < rescans; ++i) {
+            gSink = gSink + rescan(samples, from, to, SleepCategory::Asleep);
+            gSink = gSink + rescan(samples, from, to, SleepCategory::InBed);
+        }
+        const double rescanSeconds = (nowSeconds() - start) / rescans;
+
+        const int queries = 200000;
+        start = nowSeconds();
+        for (int i = 0; i < queries; ++i) {
+            const int64_t last = today - (i & 63);
+            const SleepSummary summary = stats.range(last - period.nights + 1, last);
+            gSink = gSink + summary.asleep.mean + summary.efficiency();
+        }
+        const double runningSeconds = (nowSeconds() - start) / queries;
+        std::printf("%-10s %11.1f us %11.0f ns %9.0fx\n", period.name, rescanSeconds * 1e6, runningSeconds * 1e9,
+                    rescanSeconds / runningSeconds);
+    }
+
+    const int lookups = 1000000;
+    start = nowSeconds();
+    for (int i = 0; i < lookups; ++i) {
+        const int64_t night = today - (i % nights);
+        gSink = gSink + stats.week(SleepStats::weekOf(night)).asleep.mean +
+               stats.month(SleepStats::monthOf(night)).inBed.mean;
+    }
+    std::printf("\nweek + month rollup lookup %6.0f ns\n", (nowSeconds() - start) / lookups * 1e9);
+
+    const std::size_t removals = samples.size() / 10;
+    start = nowSeconds();
+    for (std::size_t i = 0; i < removals; ++i) stats.remove(samples[i].id);
+    std::printf("remove   %8.0f ns/sample\n", (nowSeconds() - start) / removals * 1e9);
+    return 0;
+}
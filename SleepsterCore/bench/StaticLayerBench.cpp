@@ -0,0 +1,199 @@
+//
+//  StaticLayerBench.cpp
+//  SleepsterCore
+//
+//  Frame cost of the counting-sheep backdrop (stars, three hills, a row of
+//  grass) on a 390 x 844 pt screen at 3x, two ways:
+//
+//  - redrawn: what re-randomizing the shapes on every body evaluation
+//    amounts to. Each frame draws fresh random stars and blades and
+//    rasterizes them again, grass shadow included.
+//  - cached: the layers are rasterized once. A frame only steps the star
+//    twinkle, which is a static particle system.
+//
+//  It also reports the one-off cost and size of the cached layers, and the
+//  heap allocations made per frame.
+//
+//  Usage: StaticLayerBench [frames]
+//
+
+#include "BenchUtil.hpp"
+
+#include "sleepster/ParticleSystem.hpp"
+#include "sleepster/StaticLayer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace sleepster;
+using namespace sleepster::bench;
+
+static std::atomic<std::size_t> allocationCount{0};
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+constexpr float kWidth = 390.0f;
+constexpr float kHeight = 844.0f;
+constexpr float kScale = 3.0f;
+constexpr std::size_t kStars = 70;
+
+Gradient twoStops(Rgba top, Rgba bottom) {
+    Gradient gradient;
+    gradient.stops[0] = top;
+    gradient.stops[1] = bottom;
+    return gradient;
+}
+
+Gradient starFill() {
+    Gradient gradient;
+    gradient.stops[0] = {1.0f, 1.0f, 1.0f, 0.8f};
+    gradient.stops[1] = {0.0f, 0.48f, 1.0f, 0.3f};
+    gradient.stops[2] = {};
+    gradient.count = 3;
+    return gradient;
+}
+
+std::vector<HillConfig> hills() {
+    std::vector<HillConfig> layers;
+    for (int layer = 0; layer < 3; ++layer) {
+        const float depth = static_cast<float>(layer + 1);
+        HillConfig hill;
+        hill.top = kHeight * 0.6f + 20.0f * static_cast<float>(layer);
+        hill.height = kHeight;
+        hill.fill = twoStops({0.2f, 0.78f, 0.35f, 0.4f / depth}, {0.0f, 0.0f, 0.0f, 0.4f * depth / 3.0f});
+        hill.blur = depth - 1.0f;
+        layers.push_back(hill);
+    }
+    return layers;
+}
+
+GrassConfig grass(uint64_t seed) {
+    GrassConfig config;
+    config.seed = seed;
+    config.width = kWidth;
+    config.scale = kScale;
+    config.spacing = 15.0f;
+    config.jitterX = 3.0f;
+    config.jitterY = 5.0f;
+    config.baseline = kHeight;
+    config.fill = twoStops({0.2f, 0.78f, 0.35f, 0.7f}, {0.0f, 0.0f, 0.0f, 0.5f});
+    config.shadow = {0.0f, 0.0f, 0.0f, 0.3f};
+    config.shadowRadius = 1.0f;
+    config.shadowX = 1.0f;
+    config.shadowY = 1.0f;
+    return config;
+}
+
+StarSpriteConfig sprites() {
+    StarSpriteConfig config;
+    config.scale = kScale;
+    config.fill = starFill();
+    return config;
+}
+
+ParticleConfig twinklingStars() {
+    ParticleConfig config;
+    config.count = kStars;
+    config.bounds = {0.0f, 0.0f, kWidth, kHeight};
+    config.x = {0.0f, kWidth};
+    config.y = {0.0f, kHeight * 0.6f};
+    config.size = {1.5f, 6.0f};
+    config.twinkleRate = {0.785f, 3.14f};
+    config.twinkleDepth = 1.0f;
+    return config;
+}
+
+struct Cost {
+    double usPerFrame = 0.0;
+    double allocationsPerFrame = 0.0;
+};
+
+template <typename Frame>
+Cost measure(int frames, Frame&& frame) {
+    Cost best{1e30, 0.0};
+    for (int run = 0; run < 3; ++run) {
+        const std::size_t allocations = allocationCount.load();
+        const double start = nowSeconds();
+        for (int f = 0; f < frames; ++f) frame(f);
+        best.usPerFrame = std::min(best.usPerFrame, (nowSeconds() - start) * 1e6 / frames);
+        best.allocationsPerFrame = static_cast<double>(allocationCount.load() - allocations) / frames;
+    }
+    return best;
+}
+
+/// The parts that changed on every evaluation, rasterized from scratch with
+/// fresh random stars and blades. The hills never changed, so they are left
+/// out.
+void redrawBackdrop(int frame) {
+    StaticLayer screen(0.0f, 0.0f, kWidth, kHeight, kScale);
+    Random random(static_cast<uint64_t>(frame));
+    const Paint star{starFill(), true, 0.0f, 0.0f, 3.0f};
+    for (std::size_t i = 0; i < kStars; ++i) {
+        const float size = random.uniform(1.5f, 6.0f);
+        const float x = random.uniform(0.0f, kWidth);
+        const float y = random.uniform(0.0f, kHeight * 0.6f);
+        std::vector<Point> points;
+        for (int k = 0; k < 10; ++k) {
+            const float angle = static_cast<float>(k) * 3.14159265f / 5.0f;
+            const float r = (k % 2 == 0 ? 0.5f : 0.2f) * size;
+            points.push_back({x + std::cos(angle) * r, y + std::sin(angle) * r});
+        }
+        Paint paint = star;
+        paint.x = x;
+        paint.y = y;
+        fillPolygon(screen, points, paint);
+    }
+    const StaticLayer grassLayer = renderGrass(grass(static_cast<uint64_t>(frame)));
+    sink += grassLayer.bitmap.pixel(0, 0).a + screen.bitmap.pixel(0, 0).a;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? std::atoi(argv[1]) : 600;
+
+    // One-off build of the cached layers.
+    const double buildStart = nowSeconds();
+    const StaticLayer hillLayer = renderHills(kWidth, kHeight * 0.6f, kHeight, kScale, hills());
+    const StaticLayer grassLayer = renderGrass(grass(1));
+    const StaticLayer spriteLayer = renderStarSprites(sprites());
+    const double buildMs = (nowSeconds() - buildStart) * 1e3;
+    const std::size_t bytes = hillLayer.bitmap.byteCount() + grassLayer.bitmap.byteCount() +
+                              spriteLayer.bitmap.byteCount();
+    std::printf("Cached layers at %.0fx: built once in %.1f ms, %.2f MB\n", kScale, buildMs, bytes / 1048576.0);
+    std::printf("  hills   %5d x %4d px\n", hillLayer.bitmap.width(), hillLayer.bitmap.height());
+    std::printf("  grass   %5d x %4d px\n", grassLayer.bitmap.width(), grassLayer.bitmap.height());
+    std::printf("  sprites %5d x %4d px\n\n", spriteLayer.bitmap.width(), spriteLayer.bitmap.height());
+
+    const Cost redrawn = measure(std::max(1, frames / 20), redrawBackdrop);
+
+    ParticleScene scene(1);
+    scene.add(twinklingStars());
+    const Cost cached = measure(frames, [&](int) {
+        scene.update(1.0 / 60.0);
+        sink += scene.system(0).alpha()[0];
+    });
+
+    std::printf("%-10s %14s %18s\n", "", "us per frame", "allocs per frame");
+    std::printf("%-10s %14.1f %18.1f\n", "redrawn", redrawn.usPerFrame, redrawn.allocationsPerFrame);
+    std::printf("%-10s %14.3f %18.1f\n", "cached", cached.usPerFrame, cached.allocationsPerFrame);
+    return 0;
+}
@@ -0,0 +1,139 @@
+//
+//  StreamingDecodeBench.cpp
+//  SleepsterCore
+//
+//  Compares the old whole-file decode (one PcmBuffer per voice) with the
+//  streaming path for a five-voice mix. Each mode runs in its own child
+//  process so peak RSS is measured independently.
+//
+//  Usage: StreamingDecodeBench [trackSeconds] [voices] [lookaheadSeconds]
+//
+
+#include "BenchUtil.hpp"
+
+#include "sleepster/Mixer.hpp"
+#include "sleepster/PcmSource.hpp"
+#include "sleepster/StreamingSource.hpp"
+#include "sleepster/WavFile.hpp"
+
+#include <cstdlib>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace sleepster;
+using namespace sleepster::bench;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr std::size_t kBlock = 512;
+/// Audio rendered per mode; long enough to wrap short tracks.
+constexpr double kRenderSeconds = 60.0;
+
+struct Options {
+    double trackSeconds = 180.0;
+    int voices = 5;
+    double lookahead = 2.0;
+};
+
+void renderMix(Mixer& mixer) {
+    std::vector<float> left(kBlock), right(kBlock);
+    const std::size_t blocks = static_cast<std::size_t>(kRenderSeconds * kSampleRate / kBlock);
+    for (std::size_t b = 0; b < blocks; ++b) {
+        mixer.render(left.data(), right.data(), kBlock);
+        // Rendering runs far faster than real time; pause regularly so the
+        // decode thread keeps up as it would on a device.
+        if (b % 16 == 0) usleep(1000);
+    }
+}
+
+void runWholeFile(const std::string& path, const Options& options) {
+    const uint64_t baseline = currentRssBytes();
+    const double cpuStart = processCpuSeconds();
+
+    Mixer mixer(MixerConfig{kSampleRate, 32, kBlock, 256});
+    for (int v = 0; v < options.voices; ++v) {
+        // Mirrors AVAudioPCMBuffer(frameCapacity: file.length) + read(into:).
+        auto decoder = WavDecoder::open(path);
+        auto buffer = std::make_shared<PcmBuffer>();
+        buffer->sampleRate = decoder->sampleRate();
+        buffer->frameCount = decoder->frameCount();
+        buffer->channels.assign(2, std::vector<float>(buffer->frameCount));
+        decoder->decode(buffer->channels[0].data(), buffer->channels[1].data(), buffer->frameCount);
+        mixer.play(std::make_unique<PcmSource>(buffer, true), 0.2f);
+    }
+    const double decodeCpu = processCpuSeconds() - cpuStart;
+    renderMix(mixer);
+
+    std::printf("whole-file  voices=%d  peakRSS=%.1f MB  (+%.1f MB over baseline)  "
+                "decodeCPU/voice=%.2f ms\n",
+                options.voices, megabytes(peakRssBytes()), megabytes(peakRssBytes() - baseline),
+                1000.0 * decodeCpu / options.voices);
+}
+
+void runStreaming(const std::string& path, const Options& options) {
+    const uint64_t baseline = currentRssBytes();
+    StreamDecodeWorker& worker = StreamDecodeWorker::shared();
+
+    Mixer mixer(MixerConfig{kSampleRate, 32, kBlock, 256});
+    std::size_t ringBytes = 0;
+    std::vector<StreamingSource*> sources;
+    for (int v = 0; v < options.voices; ++v) {
+        StreamingConfig config;
+        config.lookaheadSeconds = options.lookahead;
+        auto source = std::make_unique<StreamingSource>(WavDecoder::open(path), config);
+        StreamingSource* raw = source.get();
+        mixer.play(std::move(source), 0.2f);
+        ringBytes += raw->bufferBytes();
+        sources.push_back(raw);
+    }
+    renderMix(mixer);
+
+    uint64_t underruns = 0;
+    for (StreamingSource* source : sources) underruns += source->underrunFrames();
+
+    const double decodeCpu = worker.cpuSeconds();
+    std::printf("streaming   voices=%d  peakRSS=%.1f MB  (+%.1f MB over baseline)  ring=%.2f MB/voice  "
+                "decodeCPU/voice=%.2f ms per %.0f s (%.3f%% of one core)  wakeups=%llu  underrunFrames=%llu\n",
+                options.voices, megabytes(peakRssBytes()), megabytes(peakRssBytes() - baseline),
+                megabytes(ringBytes) / options.voices, 1000.0 * decodeCpu / options.voices,
+                kRenderSeconds, 100.0 * decodeCpu / options.voices / kRenderSeconds,
+                static_cast<unsigned long long>(worker.wakeups()),
+                static_cast<unsigned long long>(underruns));
+}
+
+template <typename Fn>
+void inChild(Fn&& fn) {
+    std::fflush(stdout);
+    const pid_t pid = fork();
+    if (pid == 0) {
+        fn();
+        std::fflush(stdout);
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (argc > 1) options.trackSeconds = std::atof(argv[1]);
+    if (argc > 2) options.voices = std::atoi(argv[2]);
+    if (argc > 3) options.lookahead = std::atof(argv[3]);
+
+    const std::string path = "/tmp/sleepster_bench_track.wav";
+    if (!writeSyntheticTrack(path, options.trackSeconds, 44100.0)) {
+        std::fprintf(stderr, "failed to write %s\n", path.c_str());
+        return 1;
+    }
+    std::printf("track: %.0f s, 44.1 kHz stereo 16-bit, mixed at 48 kHz, lookahead %.1f s\n",
+                options.trackSeconds, options.lookahead);
+
+    inChild([&] { runWholeFile(path, options); });
+    inChild([&] { runStreaming(path, options); });
+
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,138 @@
+//
+//  TraceBench.cpp
+//  SleepsterCore
+//
+//  What tracing costs. First per span, around a loop body of a few
+//  nanoseconds:
+//
+//  - compiled out: the loop built with SLEEPSTER_TRACING=0, in
+//    TraceBenchCompiledOut.cpp; it should match the bare loop.
+//  - off: tracing compiled in but not enabled, one relaxed load per span.
+//  - on: two clock reads and one event written to the thread's ring.
+//
+//  Then the mixer's render callback, with five noise voices, the equalizer,
+//  delay and reverb all running, so five spans and a counter per block,
+//  off and on.
+//
+//  Usage: TraceBench [spans]
+//
+
+#include "BenchUtil.hpp"
+
+#include "sleepster/Mixer.hpp"
+#include "sleepster/NoiseSource.hpp"
+#include "sleepster/Trace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace sleepster;
+using namespace sleepster::bench;
+
+/// TraceBenchCompiledOut.cpp: the same loop as `spanLoop`, macros compiled out.
+double compiledOutLoop(int count, float seed);
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr std::size_t kBlock = 512;
+
+/// A few nanoseconds of work the optimiser cannot drop.
+inline float work(float x) {
+    return x * 0.999f + 0.001f;
+}
+
+float bareLoop(int count, float x) {
+    for (int i = 0; i < count; ++i) x = work(x);
+    return x;
+}
+
+float spanLoop(int count, float x) {
+    for (int i = 0; i < count; ++i) {
+        SLP_TRACE_SPAN(App, "bench.span");
+        x = work(x);
+    }
+    return x;
+}
+
+float counterLoop(int count, float x) {
+    for (int i = 0; i < count; ++i) {
+        SLP_TRACE_COUNTER(App, "bench.counter", x);
+        x = work(x);
+    }
+    return x;
+}
+
+/// Nanoseconds per iteration, best of five.
+template <typename Loop>
+double nsPerIteration(int count, Loop loop) {
+    double best = 1e30;
+    for (int run = 0; run < 5; ++run) {
+        const double start = nowSeconds();
+        sink = sink + loop(count, sink);
+        best = std::min(best, (nowSeconds() - start) * 1e9 / count);
+    }
+    return best;
+}
+
+/// Microseconds per 512-frame block, best of three seconds-long runs.
+double usPerBlock(Mixer& mixer) {
+    std::vector<float> left(kBlock), right(kBlock);
+    const int blocks = static_cast<int>(kSampleRate / kBlock) * 10;
+    double best = 1e30;
+    for (int run = 0; run < 3; ++run) {
+        const double start = nowSeconds();
+        for (int b = 0; b < blocks; ++b) mixer.render(left.data(), right.data(), kBlock);
+        best = std::min(best, (nowSeconds() - start) * 1e6 / blocks);
+        sink = sink + left[0];
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int count = argc > 1 ? std::atoi(argv[1]) : 2000000;
+    std::printf("%d spans per run, best of five; %zu events per thread ring\n\n", count, Tracer::kEventsPerThread);
+    std::printf("%-16s %10s %12s\n", "span", "ns/iter", "overhead ns");
+
+    const double bare = nsPerIteration(count, bareLoop);
+    const double compiledOut = nsPerIteration(count, [](int n, float x) {
+        return static_cast<float>(compiledOutLoop(n, x));
+    });
+    Tracer::setEnabled(false);
+    const double off = nsPerIteration(count, spanLoop);
+    Tracer::setEnabled(true);
+    const double on = nsPerIteration(count, spanLoop);
+    const double counter = nsPerIteration(count, counterLoop);
+    Tracer::setEnabled(false);
+
+    std::printf("%-16s %10.2f %12s\n", "bare loop", bare, "-");
+    std::printf("%-16s %10.2f %12.2f\n", "compiled out", compiledOut, compiledOut - bare);
+    std::printf("%-16s %10.2f %12.2f\n", "off", off, off - bare);
+    std::printf("%-16s %10.2f %12.2f\n", "on", on, on - bare);
+    std::printf("%-16s %10.2f %12.2f\n", "counter on", counter, counter - bare);
+
+    Mixer mixer(MixerConfig{kSampleRate, 32, kBlock, 256});
+    for (int v = 0; v < 5; ++v) {
+        mixer.play(std::make_unique<NoiseSource>(NoiseColor::Pink, static_cast<uint64_t>(v + 1)), 0.2f);
+    }
+    const float gains[] = {3.0f, -2.0f, 1.0f, 0.0f, -4.0f, 2.0f, 1.0f, -1.0f, 3.0f, 0.5f};
+    mixer.equalizer().setGains(gains, sizeof gains / sizeof gains[0]);
+    mixer.equalizer().setEnabled(true);
+    mixer.delay().setEnabled(true);
+    mixer.reverb().setEnabled(true);
+
+    std::printf("\n%-16s %10s %12s\n", "render 512", "us/block", "% of block");
+    const double blockUs = kBlock / kSampleRate * 1e6;
+    Tracer::setEnabled(false);
+    const double renderOff = usPerBlock(mixer);
+    Tracer::setEnabled(true);
+    const double renderOn = usPerBlock(mixer);
+    Tracer::setEnabled(false);
+    std::printf("%-16s %10.2f %11.3f%%\n", "tracing off", renderOff, 100.0 * renderOff / blockUs);
+    std::printf("%-16s %10.2f %11.3f%%\n", "tracing on", renderOn, 100.0 * renderOn / blockUs);
+    return 0;
+}
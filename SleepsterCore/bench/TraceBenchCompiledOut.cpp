@@ -0,0 +1,20 @@
+//
+//  TraceBenchCompiledOut.cpp
+//  SleepsterCore
+//
+//  TraceBench's span loop built as it is with SLEEPSTER_TRACING=0.
+//
+
+#undef SLEEPSTER_TRACING
+#define SLEEPSTER_TRACING 0
+
+#include "sleepster/Trace.hpp"
+
+double compiledOutLoop(int count, float seed) {
+    float x = seed;
+    for (int i = 0; i < count; ++i) {
+        SLP_TRACE_SPAN(App, "bench.span");
+        x = x * 0.999f + 0.001f;
+    }
+    return x;
+}
@@ -0,0 +1,83 @@
+//
+//  SLPAnalytics.h
+//  SleepsterCore
+//
+//  Local analytics pipeline in front of any backend. Names are interned
+//  once into ids; logging then copies a fixed record into a lock-free ring
+//  without allocating, from any thread. A background flusher appends the
+//  ring to a file as JSON lines in batches, with timed events folded into
+//  per-event counts and durations.
+//
+
+#ifndef SLPAnalytics_h
+#define SLPAnalytics_h
+
+#include "SLPBase.h"
+
+SLP_EXTERN_C_BEGIN
+
+typedef struct SLPAnalytics SLPAnalytics;
+
+/// An interned name; SLPAnalyticsNoName when interning failed.
+typedef uint16_t SLPAnalyticsName;
+static const SLPAnalyticsName SLPAnalyticsNoName = 0xFFFF;
+
+typedef enum {
+    SLPAnalyticsValueInteger = 0,
+    SLPAnalyticsValueNumber = 1,
+    /// An interned string.
+    SLPAnalyticsValueName = 2,
+} SLPAnalyticsValueType;
+
+/// Only the field `type` names is read.
+typedef struct {
+    SLPAnalyticsName key;
+    SLPAnalyticsValueType type;
+    int64_t integer;
+    double number;
+    SLPAnalyticsName name;
+} SLPAnalyticsParameter;
+
+/// Events keep this many parameters; the rest are dropped.
+static const size_t SLPAnalyticsMaxParameters = 3;
+
+typedef struct {
+    uint64_t written;
+    uint64_t dropped;
+    uint64_t batches;
+    uint64_t failedBatches;
+} SLPAnalyticsMetrics;
+
+/// Appends to the file at `path`. `capacity` records fit in the ring;
+/// the flusher runs every `flushIntervalSeconds`, or sooner once half of
+/// them are queued. NULL if the file cannot be opened.
+SLPAnalytics *_Nullable SLPAnalyticsCreate(const char *_Nonnull path, size_t capacity,
+                                           double flushIntervalSeconds);
+/// Writes what is still queued first.
+void SLPAnalyticsDestroy(SLPAnalytics *_Nullable analytics);
+
+/// Takes a lock; intern names once, up front. The same string always gets
+/// the same id.
+SLPAnalyticsName SLPAnalyticsIntern(SLPAnalytics *_Nonnull analytics, const char *_Nonnull name);
+
+// Any thread, never blocking or allocating. False when the event was
+// dropped because the ring was full, or logging is off.
+bool SLPAnalyticsLogEvent(SLPAnalytics *_Nonnull analytics, SLPAnalyticsName event,
+                          const SLPAnalyticsParameter *_Nullable parameters, size_t count);
+bool SLPAnalyticsBeginTimedEvent(SLPAnalytics *_Nonnull analytics, SLPAnalyticsName event,
+                                 const SLPAnalyticsParameter *_Nullable parameters, size_t count);
+/// Non-empty parameters replace those the event started with.
+bool SLPAnalyticsEndTimedEvent(SLPAnalytics *_Nonnull analytics, SLPAnalyticsName event,
+                               const SLPAnalyticsParameter *_Nullable parameters, size_t count);
+/// `message` may be SLPAnalyticsNoName.
+bool SLPAnalyticsLogError(SLPAnalytics *_Nonnull analytics, SLPAnalyticsName error, SLPAnalyticsName message);
+
+/// While off, events are discarded without being counted.
+void SLPAnalyticsSetEnabled(SLPAnalytics *_Nonnull analytics, bool enabled);
+/// Writes everything queued now, on the calling thread.
+void SLPAnalyticsFlush(SLPAnalytics *_Nonnull analytics);
+SLPAnalyticsMetrics SLPAnalyticsGetMetrics(const SLPAnalytics *_Nonnull analytics);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPAnalytics_h */
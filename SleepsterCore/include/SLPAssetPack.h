@@ -0,0 +1,47 @@
+//
+//  SLPAssetPack.h
+//  SleepsterCore
+//
+//  The pre-decoded sound pack built by tools/SoundPacker. Opening maps the
+//  file; sources play straight from the mapping, so a voice starts without
+//  decoding anything.
+//
+
+#ifndef SLPAssetPack_h
+#define SLPAssetPack_h
+
+#include "SLPMixer.h"
+
+SLP_EXTERN_C_BEGIN
+
+typedef struct SLPAssetPack SLPAssetPack;
+
+typedef struct {
+    double sampleRate;
+    uint32_t channelCount;
+    uint32_t frameCount;
+    /// Looping playback wraps from loopEnd back to loopStart (frames).
+    uint32_t loopStart;
+    uint32_t loopEnd;
+    /// Integrated loudness, LUFS.
+    float loudness;
+    /// Largest absolute sample, 0...1.
+    float peak;
+} SLPAssetInfo;
+
+/// Returns NULL if the file is missing or not a valid pack.
+SLPAssetPack *_Nullable SLPAssetPackOpen(const char *_Nonnull path);
+
+/// Voices created from the pack keep the mapping alive until they finish.
+void SLPAssetPackClose(SLPAssetPack *_Nullable pack);
+
+bool SLPAssetPackGetInfo(const SLPAssetPack *_Nonnull pack, const char *_Nonnull name,
+                         SLPAssetInfo *_Nonnull info);
+
+/// Returns NULL if the pack has no sound called `name`.
+SLPSource *_Nullable SLPSourceCreatePacked(const SLPAssetPack *_Nonnull pack, const char *_Nonnull name,
+                                           bool loop);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPAssetPack_h */
@@ -0,0 +1,68 @@
+//
+//  SLPAutomation.h
+//  SleepsterCore
+//
+//  Whole-night mix timelines: sparse breakpoints for channel volumes, the
+//  master volume, the EQ preset and the effect mixes, played by the mixer
+//  on the render thread (SLPMixerAutomate) or baked into an offline render
+//  (SLPOfflineMixSetAutomation). Build a timeline on one thread; it is
+//  copied when handed to either.
+//
+
+#ifndef SLPAutomation_h
+#define SLPAutomation_h
+
+#include "SLPBase.h"
+
+SLP_EXTERN_C_BEGIN
+
+typedef struct SLPAutomation SLPAutomation;
+
+typedef enum {
+    /// Linear gain (0...4) on top of a channel's volume.
+    SLPAutomationTargetChannelVolume = 0,
+    /// Linear gain (0...4) on top of the master volume.
+    SLPAutomationTargetMasterVolume = 1,
+    /// Index returned by SLPAutomationAddEQPreset.
+    SLPAutomationTargetEQPreset = 2,
+    /// Wet share, 0...1, of an enabled effect.
+    SLPAutomationTargetDelayMix = 3,
+    SLPAutomationTargetReverbMix = 4,
+} SLPAutomationTarget;
+
+typedef enum {
+    /// Jumps on the breakpoint's sample.
+    SLPBreakpointShapeStep = 0,
+    /// Ramps from the lane's previous breakpoint; see SLPRampCurve.
+    SLPBreakpointShapeLinear = 1,
+    SLPBreakpointShapeEqualPower = 2,
+    SLPBreakpointShapeExponential = 3,
+} SLPBreakpointShape;
+
+SLPAutomation *_Nullable SLPAutomationCreate(void);
+void SLPAutomationDestroy(SLPAutomation *_Nullable automation);
+
+/// Adds an EQ curve (gains in dB; missing bands are flat) and returns its
+/// index for SLPAutomationTargetEQPreset breakpoints.
+uint32_t SLPAutomationAddEQPreset(SLPAutomation *_Nonnull automation, const float *_Nullable gainsDb,
+                                  uint32_t count);
+
+/// `channel` indexes the channels given to SLPMixerAutomate (or the offline
+/// mix's tracks) and is ignored for other targets. `timeMs` counts from
+/// the start of the timeline.
+void SLPAutomationAddBreakpoint(SLPAutomation *_Nonnull automation, SLPAutomationTarget target, uint32_t channel,
+                                uint64_t timeMs, float value, SLPBreakpointShape shape);
+
+/// Every voice stops `timeMs` into the timeline; 0 for no end.
+void SLPAutomationSetEnd(SLPAutomation *_Nonnull automation, uint64_t timeMs);
+uint64_t SLPAutomationGetEnd(const SLPAutomation *_Nonnull automation);
+
+/// Writes the serialized timeline to `out` if it fits in `capacity` bytes
+/// and returns its size either way; pass NULL to size it.
+size_t SLPAutomationEncode(const SLPAutomation *_Nonnull automation, uint8_t *_Nullable out, size_t capacity);
+/// NULL unless `data` is a whole, valid encoding.
+SLPAutomation *_Nullable SLPAutomationDecode(const uint8_t *_Nonnull data, size_t length);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPAutomation_h */
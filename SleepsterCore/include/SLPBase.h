@@ -0,0 +1,30 @@
+//
+//  SLPBase.h
+//  SleepsterCore
+//
+//  Shared macros for the C interface that Swift imports through
+//  SleepMate-Bridging-Header.h.
+//
+
+#ifndef SLPBase_h
+#define SLPBase_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+#define SLP_EXTERN_C_BEGIN extern "C" {
+#define SLP_EXTERN_C_END }
+#else
+#define SLP_EXTERN_C_BEGIN
+#define SLP_EXTERN_C_END
+#endif
+
+// Nullability qualifiers only exist in Clang; the Linux GCC build ignores them.
+#if !defined(__clang__)
+#define _Nullable
+#define _Nonnull
+#endif
+
+#endif /* SLPBase_h */
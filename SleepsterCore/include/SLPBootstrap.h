@@ -0,0 +1,77 @@
+//
+//  SLPBootstrap.h
+//  SleepsterCore
+//
+//  Starts the app's services in dependency order, phase by phase, with
+//  independent ones in parallel on a work-stealing pool the bootstrap
+//  owns. Services flagged to run on the calling thread, such as main-actor
+//  ones, run on whichever thread called SLPBootstrapRun while it waits.
+//
+
+#ifndef SLPBootstrap_h
+#define SLPBootstrap_h
+
+#include "SLPBase.h"
+
+SLP_EXTERN_C_BEGIN
+
+typedef struct SLPBootstrap SLPBootstrap;
+
+typedef enum {
+    /// Before the first frame.
+    SLPBootPhaseCritical = 0,
+    /// Just after the first frame.
+    SLPBootPhaseFirstFrame = 1,
+    SLPBootPhaseIdle = 2,
+} SLPBootPhase;
+
+typedef enum {
+    SLPBootStatusPending = 0,
+    SLPBootStatusSucceeded = 1,
+    SLPBootStatusFailed = 2,
+    /// Not started because a dependency failed or was skipped.
+    SLPBootStatusSkipped = 3,
+} SLPBootStatus;
+
+typedef struct {
+    /// Valid as long as the bootstrap.
+    const char *_Nonnull name;
+    SLPBootPhase phase;
+    SLPBootStatus status;
+    /// Pool worker index, or -1 for the calling thread.
+    int thread;
+    /// Seconds since the bootstrap was created.
+    double ready;
+    double begin;
+    double end;
+} SLPBootTiming;
+
+/// Returns false if the service could not start.
+typedef bool (*SLPBootStart)(void *_Nullable context);
+
+/// `threads` 0 sizes the pool to the device.
+SLPBootstrap *_Nonnull SLPBootstrapCreate(size_t threads);
+void SLPBootstrapDestroy(SLPBootstrap *_Nullable bootstrap);
+
+/// `dependencies` names services that must start first, in this phase or
+/// an earlier one. Returns false if `name` is already taken.
+bool SLPBootstrapAdd(SLPBootstrap *_Nonnull bootstrap, const char *_Nonnull name, SLPBootPhase phase,
+                     const char *_Nonnull const *_Nullable dependencies, size_t dependencyCount,
+                     bool onCallingThread, SLPBootStart _Nonnull start, void *_Nullable context);
+
+/// Starts every pending service up to and including `phase` and returns
+/// once all have finished. False if one failed or was skipped, or the
+/// dependencies are missing, cyclic or out of phase; SLPBootstrapGetError
+/// then says which.
+bool SLPBootstrapRun(SLPBootstrap *_Nonnull bootstrap, SLPBootPhase phase);
+/// Empty unless the last run failed validation.
+const char *_Nonnull SLPBootstrapGetError(const SLPBootstrap *_Nonnull bootstrap);
+
+/// Every service that has finished, in the order it did, in `*timings`;
+/// valid until the next call on the bootstrap.
+size_t SLPBootstrapGetTimings(SLPBootstrap *_Nonnull bootstrap,
+                              const SLPBootTiming *_Nullable *_Nonnull timings);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPBootstrap_h */
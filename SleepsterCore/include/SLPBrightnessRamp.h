@@ -0,0 +1,45 @@
+//
+//  SLPBrightnessRamp.h
+//  SleepsterCore
+//
+//  Timed screen-brightness updates for long ramps, even in perceived
+//  lightness and only as many as the change can be seen in.
+//  `BrightnessManager` plans a ramp here and issues the steps itself.
+//
+
+#ifndef SLPBrightnessRamp_h
+#define SLPBrightnessRamp_h
+
+#include "SLPBase.h"
+
+SLP_EXTERN_C_BEGIN
+
+/// See sleepster::BrightnessRampConfig.
+typedef struct {
+    double gamma;
+    /// In L*, 0...100.
+    double lightnessStep;
+    /// Seconds.
+    double minimumInterval;
+} SLPBrightnessRampConfig;
+
+typedef struct {
+    /// Seconds from the start of the ramp.
+    double time;
+    double brightness;
+} SLPBrightnessStep;
+
+/// Gamma 2.2, one L* per step, at most ten updates a second.
+SLPBrightnessRampConfig SLPBrightnessRampGetDefaultConfig(void);
+
+/// Writes up to `capacity` steps of the ramp from `from` to `to` over
+/// `duration` seconds and returns how many it needs; pass NULL to count.
+size_t SLPBrightnessRampPlan(double from, double to, double duration, SLPBrightnessRampConfig config,
+                             SLPBrightnessStep *_Nullable steps, size_t capacity);
+
+/// How many of the steps are due `elapsed` seconds into the ramp.
+size_t SLPBrightnessRampGetStepsDue(const SLPBrightnessStep *_Nonnull steps, size_t count, double elapsed);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPBrightnessRamp_h */
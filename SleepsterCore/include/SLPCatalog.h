@@ -0,0 +1,111 @@
+//
+//  SLPCatalog.h
+//  SleepsterCore
+//
+//  In-memory index of the Sound and Background records in the Core Data
+//  store: lookups by title or animation type are a hash probe, and the
+//  selected, favorite and mixing sets are bitsets. Changes made here are
+//  kept as pending until taken and written to the store; changes the store
+//  made itself are applied with `fromStore` set. Persists as a versioned
+//  snapshot that loads in one read. Not thread-safe.
+//
+
+#ifndef SLPCatalog_h
+#define SLPCatalog_h
+
+#include "SLPBase.h"
+
+SLP_EXTERN_C_BEGIN
+
+typedef struct SLPCatalog SLPCatalog;
+
+typedef enum {
+    SLPCatalogKindSound = 0,
+    SLPCatalogKindBackground = 1,
+} SLPCatalogKind;
+
+typedef enum {
+    SLPCatalogFlagFavorite = 0,
+    SLPCatalogFlagSelected = 1,
+    /// Sounds only.
+    SLPCatalogFlagSelectedForMixing = 2,
+} SLPCatalogFlag;
+
+/// No such record.
+static const uint32_t SLPCatalogNotFound = 0xFFFFFFFFu;
+
+/// Strings are UTF-8; NULL where the store has nil.
+typedef struct {
+    const char *_Nonnull title;
+    const char *_Nullable soundUrl1;
+    const char *_Nullable soundUrl2;
+    bool isFavorite;
+    bool isSelected;
+    bool isSelectedForMixing;
+} SLPCatalogSound;
+
+typedef struct {
+    const char *_Nonnull animationType;
+    const char *_Nullable colorTheme;
+    int32_t intensityLevel;
+    float speedMultiplier;
+    bool isFavorite;
+    bool isSelected;
+} SLPCatalogBackground;
+
+SLPCatalog *_Nonnull SLPCatalogCreate(void);
+/// NULL if there is no snapshot at `path` or it is from another version or
+/// damaged; rebuild from the store then. The first change removes the file.
+SLPCatalog *_Nullable SLPCatalogLoad(const char *_Nonnull path);
+/// Replaces the snapshot at `path`, which the next change removes.
+bool SLPCatalogSave(const SLPCatalog *_Nonnull catalog, const char *_Nonnull path);
+void SLPCatalogDestroy(SLPCatalog *_Nullable catalog);
+/// Changes with every edit, so a saved snapshot can be told from a stale one.
+uint64_t SLPCatalogGetRevision(const SLPCatalog *_Nonnull catalog);
+
+/// False if the key is taken, with the record holding it in `*id`.
+bool SLPCatalogAddSound(SLPCatalog *_Nonnull catalog, const SLPCatalogSound *_Nonnull sound, bool fromStore,
+                        uint32_t *_Nonnull id);
+bool SLPCatalogAddBackground(SLPCatalog *_Nonnull catalog, const SLPCatalogBackground *_Nonnull background,
+                             bool fromStore, uint32_t *_Nonnull id);
+/// False if `id` is not live or the new key belongs to another record.
+bool SLPCatalogUpdateSound(SLPCatalog *_Nonnull catalog, uint32_t id, const SLPCatalogSound *_Nonnull sound,
+                           bool fromStore);
+bool SLPCatalogUpdateBackground(SLPCatalog *_Nonnull catalog, uint32_t id,
+                                const SLPCatalogBackground *_Nonnull background, bool fromStore);
+bool SLPCatalogRemove(SLPCatalog *_Nonnull catalog, SLPCatalogKind kind, uint32_t id, bool fromStore);
+
+/// The live record with this title or animation type, or SLPCatalogNotFound.
+uint32_t SLPCatalogFind(const SLPCatalog *_Nonnull catalog, SLPCatalogKind kind, const char *_Nonnull key);
+bool SLPCatalogIsLive(const SLPCatalog *_Nonnull catalog, SLPCatalogKind kind, uint32_t id);
+/// The record's title or animation type, valid until the next change; NULL
+/// if `id` was never a record.
+const char *_Nullable SLPCatalogGetKey(const SLPCatalog *_Nonnull catalog, SLPCatalogKind kind, uint32_t id);
+/// Live records.
+size_t SLPCatalogGetCount(const SLPCatalog *_Nonnull catalog, SLPCatalogKind kind);
+/// Fills `out`, whose strings stay valid until the next Get call on the
+/// catalog. Removed records still read. False if `id` was never a record.
+bool SLPCatalogGetSound(SLPCatalog *_Nonnull catalog, uint32_t id, SLPCatalogSound *_Nonnull out);
+bool SLPCatalogGetBackground(SLPCatalog *_Nonnull catalog, uint32_t id, SLPCatalogBackground *_Nonnull out);
+
+bool SLPCatalogSetFlag(SLPCatalog *_Nonnull catalog, SLPCatalogKind kind, uint32_t id, SLPCatalogFlag flag,
+                       bool value, bool fromStore);
+bool SLPCatalogGetFlag(const SLPCatalog *_Nonnull catalog, SLPCatalogKind kind, uint32_t id, SLPCatalogFlag flag);
+/// Selects `id` and deselects every other record of its kind.
+bool SLPCatalogSelect(SLPCatalog *_Nonnull catalog, SLPCatalogKind kind, uint32_t id);
+/// The first live record with the flag, or SLPCatalogNotFound.
+uint32_t SLPCatalogGetFirst(const SLPCatalog *_Nonnull catalog, SLPCatalogKind kind, SLPCatalogFlag flag);
+/// Every live record with the flag in `*ids`, valid until the next Get
+/// call on the catalog.
+size_t SLPCatalogGetAll(SLPCatalog *_Nonnull catalog, SLPCatalogKind kind, SLPCatalogFlag flag,
+                        const uint32_t *_Nullable *_Nonnull ids);
+
+/// Records changed here since last taken, in `*ids` as for
+/// SLPCatalogGetAll; no longer pending once taken. A record that is no
+/// longer live is to be deleted from the store.
+size_t SLPCatalogTakeChanges(SLPCatalog *_Nonnull catalog, SLPCatalogKind kind,
+                             const uint32_t *_Nullable *_Nonnull ids);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPCatalog_h */
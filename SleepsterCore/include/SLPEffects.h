@@ -0,0 +1,39 @@
+//
+//  SLPEffects.h
+//  SleepsterCore
+//
+//  Delay and reverb on the mixer's master bus, after the EQ. Calls follow
+//  the mixer's single-control-thread rule. Both effects start bypassed and
+//  cost nothing until enabled.
+//
+
+#ifndef SLPEffects_h
+#define SLPEffects_h
+
+#include "SLPMixer.h"
+
+SLP_EXTERN_C_BEGIN
+
+typedef enum {
+    SLPReverbPresetRoom = 0,
+    SLPReverbPresetHall = 1,
+    SLPReverbPresetCathedral = 2,
+    SLPReverbPresetPlate = 3,
+} SLPReverbPreset;
+
+void SLPMixerSetReverbEnabled(SLPMixer *_Nonnull mixer, bool enabled);
+void SLPMixerSetReverbPreset(SLPMixer *_Nonnull mixer, SLPReverbPreset preset);
+/// Wet share of the output, 0...1.
+void SLPMixerSetReverbMix(SLPMixer *_Nonnull mixer, float wet);
+
+void SLPMixerSetDelayEnabled(SLPMixer *_Nonnull mixer, bool enabled);
+/// Up to 2 s; changes glide instead of jumping.
+void SLPMixerSetDelayTime(SLPMixer *_Nonnull mixer, double seconds);
+/// Fraction of the output fed back, clamped below ±1.
+void SLPMixerSetDelayFeedback(SLPMixer *_Nonnull mixer, float feedback);
+/// Wet share of the output, 0...1.
+void SLPMixerSetDelayMix(SLPMixer *_Nonnull mixer, float wet);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPEffects_h */
@@ -0,0 +1,30 @@
+//
+//  SLPEqualizer.h
+//  SleepsterCore
+//
+//  Ten-band EQ on the mixer's master bus. Calls follow the mixer's
+//  single-control-thread rule; a whole curve is applied in one update and
+//  glides into place on the render thread.
+//
+
+#ifndef SLPEqualizer_h
+#define SLPEqualizer_h
+
+#include "SLPMixer.h"
+
+SLP_EXTERN_C_BEGIN
+
+/// Bands are centred on 32, 63, 125, 250, 500, 1k, 2k, 4k, 8k and 16k Hz.
+enum { SLPEqualizerBandCount = 10 };
+
+void SLPMixerSetEQEnabled(SLPMixer *_Nonnull mixer, bool enabled);
+
+/// Sets all band gains (dB, clamped to ±24) at once; missing bands are flat.
+void SLPMixerSetEQGains(SLPMixer *_Nonnull mixer, const float *_Nonnull gainsDb, uint32_t count);
+
+/// Width of every band in octaves.
+void SLPMixerSetEQBandwidth(SLPMixer *_Nonnull mixer, float octaves);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPEqualizer_h */
@@ -0,0 +1,50 @@
+//
+//  SLPFramePacer.h
+//  SleepsterCore
+//
+//  Frame-rate and quality choice for the animated backgrounds, from a
+//  rolling histogram of frame times. Feed it every frame's interval; it
+//  changes level only on percentiles, with hysteresis.
+//
+
+#ifndef SLPFramePacer_h
+#define SLPFramePacer_h
+
+#include "SLPBase.h"
+
+SLP_EXTERN_C_BEGIN
+
+typedef struct SLPFramePacer SLPFramePacer;
+
+typedef enum {
+    SLPQualityTierFull = 0,
+    SLPQualityTierReduced = 1,
+    SLPQualityTierMinimal = 2,
+} SLPQualityTier;
+
+/// Frame-time percentiles (seconds) of the current window and counters
+/// since creation.
+typedef struct {
+    double p50;
+    double p90;
+    double p99;
+    uint64_t frames;
+    uint64_t lateFrames;
+    uint64_t levelChanges;
+} SLPFramePacerMetrics;
+
+SLPFramePacer *_Nonnull SLPFramePacerCreate(void);
+void SLPFramePacerDestroy(SLPFramePacer *_Nullable pacer);
+
+/// Records the interval since the previous frame; returns true when the
+/// target rate or tier changed.
+bool SLPFramePacerRecordFrame(SLPFramePacer *_Nonnull pacer, double seconds);
+
+/// 60, 30, 20 or 15.
+double SLPFramePacerGetTargetFramesPerSecond(const SLPFramePacer *_Nonnull pacer);
+SLPQualityTier SLPFramePacerGetTier(const SLPFramePacer *_Nonnull pacer);
+SLPFramePacerMetrics SLPFramePacerGetMetrics(const SLPFramePacer *_Nonnull pacer);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPFramePacer_h */
@@ -0,0 +1,52 @@
+//
+//  SLPGeometry.h
+//  SleepsterCore
+//
+//  Unit outlines of the sacred-geometry and sheep shapes. Each is built
+//  once; a view turns it into a path and places it in a rect with a scale
+//  and a translation instead of recomputing it.
+//
+
+#ifndef SLPGeometry_h
+#define SLPGeometry_h
+
+#include "SLPBase.h"
+
+SLP_EXTERN_C_BEGIN
+
+typedef enum {
+    SLPShapeFlowerOfLife = 0,
+    SLPShapeMetatronsCube = 1,
+    SLPShapeTriquetra = 2,
+    SLPShapeSriYantra = 3,
+    SLPShapeVesicaPiscis = 4,
+    SLPShapeEnneagram = 5,
+    SLPShapeSacredMandala = 6,
+    SLPShapeSheep = 7,
+} SLPShape;
+
+/// Move and line take one point, quad two (control, end), cubic three (two
+/// controls, end) and close none.
+typedef enum {
+    SLPPathVerbMove = 0,
+    SLPPathVerbLine = 1,
+    SLPPathVerbQuad = 2,
+    SLPPathVerbCubic = 3,
+    SLPPathVerbClose = 4,
+} SLPPathVerb;
+
+/// An outline centred on the origin, for a rect whose smaller side is 1.
+/// `points` holds `pointCount` interleaved x, y pairs.
+typedef struct {
+    const uint8_t *_Nonnull verbs;
+    uint32_t verbCount;
+    const float *_Nonnull points;
+    uint32_t pointCount;
+} SLPShapePath;
+
+/// The arrays stay valid for the life of the process. Safe on any thread.
+SLPShapePath SLPShapeGetUnitPath(SLPShape shape);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPGeometry_h */
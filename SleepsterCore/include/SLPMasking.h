@@ -0,0 +1,63 @@
+//
+//  SLPMasking.h
+//  SleepsterCore
+//
+//  Ambient-adaptive masking level. The render callback records what it
+//  plays into an echo reference; the microphone tap hands its buffers to
+//  the controller, which now and then compares them with the reference to
+//  measure the room and suggests a gain and EQ offsets that keep the mix
+//  just above it. Positions on both sides are sample counts on one clock,
+//  such as host time times the sample rate.
+//
+
+#ifndef SLPMasking_h
+#define SLPMasking_h
+
+#include "SLPBase.h"
+#include "SLPEqualizer.h"
+
+SLP_EXTERN_C_BEGIN
+
+typedef struct SLPEchoReference SLPEchoReference;
+typedef struct SLPMaskingController SLPMaskingController;
+
+/// Changes to apply on top of the user's volume and EQ curve.
+typedef struct {
+    float gainDb;
+    float eqDb[SLPEqualizerBandCount];
+    /// Share of the measured bands that stay masked.
+    float coverage;
+} SLPMaskingDecision;
+
+typedef struct {
+    uint64_t windows;
+    uint64_t analyzedFrames;
+    /// Microphone buffers heard while the matching output was missing from
+    /// the reference; they are skipped.
+    uint64_t unmatchedBuffers;
+} SLPMaskingMetrics;
+
+/// Holds two seconds of output.
+SLPEchoReference *_Nonnull SLPEchoReferenceCreate(double sampleRate);
+void SLPEchoReferenceDestroy(SLPEchoReference *_Nullable reference);
+/// Render thread: wait-free, never allocates.
+void SLPEchoReferenceWrite(SLPEchoReference *_Nonnull reference, const float *_Nonnull left,
+                           const float *_Nonnull right, size_t frames, int64_t position);
+
+/// `echoDelaySeconds` is how long output takes to reach the microphone
+/// buffers: output and input latency.
+SLPMaskingController *_Nonnull SLPMaskingControllerCreate(double sampleRate, double echoDelaySeconds);
+void SLPMaskingControllerDestroy(SLPMaskingController *_Nullable controller);
+
+/// Microphone thread. `position` is the capture time of the first sample.
+/// Between analysis windows this returns at once.
+void SLPMaskingControllerProcess(SLPMaskingController *_Nonnull controller,
+                                 const SLPEchoReference *_Nonnull reference, const float *_Nonnull microphone,
+                                 size_t count, int64_t position);
+/// Fills `out`; true when it changed since the last call.
+bool SLPMaskingControllerTakeDecision(SLPMaskingController *_Nonnull controller, SLPMaskingDecision *_Nonnull out);
+SLPMaskingMetrics SLPMaskingControllerGetMetrics(const SLPMaskingController *_Nonnull controller);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPMasking_h */
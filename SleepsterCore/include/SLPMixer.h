@@ -0,0 +1,120 @@
+//
+//  SLPMixer.h
+//  SleepsterCore
+//
+//  C interface to the real-time mixer. Everything except SLPMixerRender is
+//  called from one control thread (the main actor); SLPMixerRender is
+//  called from the audio render callback and never locks or allocates.
+//
+
+#ifndef SLPMixer_h
+#define SLPMixer_h
+
+#include "SLPAutomation.h"
+#include "SLPBase.h"
+
+SLP_EXTERN_C_BEGIN
+
+typedef struct SLPMixer SLPMixer;
+typedef struct SLPSource SLPSource;
+
+/// Voice handle; SLPVoiceIDInvalid (0) is never returned for a live voice.
+typedef uint32_t SLPVoiceID;
+static const SLPVoiceID SLPVoiceIDInvalid = 0;
+
+typedef struct {
+    double sampleRate;
+    uint32_t maxVoices;
+    uint32_t maxBlockFrames;
+} SLPMixerConfig;
+
+/// Identifies one volume ramp; 0 means the ramp could not be scheduled.
+typedef uint32_t SLPRampToken;
+
+typedef enum {
+    SLPRampCurveLinear = 0,
+    /// sin/cos law; use for crossfades.
+    SLPRampCurveEqualPower = 1,
+    /// Even steps in dB over a 60 dB range; use for long fades to silence.
+    SLPRampCurveExponential = 2,
+} SLPRampCurve;
+
+typedef enum {
+    SLPMixerEventVoiceFinished = 0,
+    SLPMixerEventRampFinished = 1,
+    SLPMixerEventRampCancelled = 2,
+    /// A timeline reached its end and stopped every voice; no voice is set.
+    SLPMixerEventAutomationFinished = 3,
+} SLPMixerEventType;
+
+typedef struct {
+    SLPMixerEventType type;
+    SLPVoiceID voice;
+    /// Set for ramp events, 0 otherwise.
+    SLPRampToken ramp;
+} SLPMixerEvent;
+
+// MARK: - Lifetime
+
+SLPMixer *_Nullable SLPMixerCreate(SLPMixerConfig config);
+void SLPMixerDestroy(SLPMixer *_Nullable mixer);
+uint32_t SLPMixerGetMaxVoices(const SLPMixer *_Nonnull mixer);
+
+// MARK: - Sources
+
+/// Copies `frameCount` frames from planar float channels (1 or 2).
+SLPSource *_Nullable SLPSourceCreatePCM(const float *_Nonnull const *_Nonnull channels,
+                                        uint32_t channelCount, uint64_t frameCount,
+                                        double sampleRate, bool loop);
+
+/// Only for sources that were never passed to SLPMixerPlay.
+void SLPSourceDestroy(SLPSource *_Nullable source);
+
+// MARK: - Control
+
+/// Takes ownership of `source` whether or not a voice could be started.
+SLPVoiceID SLPMixerPlay(SLPMixer *_Nonnull mixer, SLPSource *_Nonnull source, float volume);
+bool SLPMixerStop(SLPMixer *_Nonnull mixer, SLPVoiceID voice);
+void SLPMixerStopAll(SLPMixer *_Nonnull mixer);
+bool SLPMixerSetVolume(SLPMixer *_Nonnull mixer, SLPVoiceID voice, float volume);
+void SLPMixerSetMasterVolume(SLPMixer *_Nonnull mixer, float volume);
+/// Changes a live control of the voice's source (see SLPNoise.h), applied
+/// on the render thread in order with other commands.
+bool SLPMixerSetSourceParameter(SLPMixer *_Nonnull mixer, SLPVoiceID voice, uint32_t parameter,
+                                float value);
+
+/// Ramps a voice to `volume` over `seconds` on the render thread. Its end is
+/// reported once, as SLPMixerEventRampFinished or SLPMixerEventRampCancelled
+/// carrying the returned token. With `stopWhenDone` the voice is released
+/// when the ramp finishes.
+SLPRampToken SLPMixerRampVolume(SLPMixer *_Nonnull mixer, SLPVoiceID voice, float volume,
+                                double seconds, SLPRampCurve curve, bool stopWhenDone);
+
+/// Plays a copy of `automation` on the render thread from `startSeconds`
+/// into it, replacing any timeline already playing; channel lanes address
+/// `channels`. Its end is reported as SLPMixerEventAutomationFinished.
+/// False if the mixer is too busy to take it; try again after collecting
+/// events.
+bool SLPMixerAutomate(SLPMixer *_Nonnull mixer, const SLPAutomation *_Nonnull automation,
+                      const SLPVoiceID *_Nullable channels, uint32_t channelCount, double startSeconds);
+/// Returns automated gains, EQ and effect mixes to their own settings.
+void SLPMixerStopAutomation(SLPMixer *_Nonnull mixer);
+
+bool SLPMixerIsVoiceActive(const SLPMixer *_Nonnull mixer, SLPVoiceID voice);
+uint32_t SLPMixerGetActiveVoiceCount(const SLPMixer *_Nonnull mixer);
+
+/// Reclaims released voices and copies up to `maxEvents` events.
+uint32_t SLPMixerCollectEvents(SLPMixer *_Nonnull mixer, SLPMixerEvent *_Nullable events,
+                               uint32_t maxEvents);
+
+/// Blocks until the render thread posts events; safe from any thread.
+bool SLPMixerWaitForEvents(SLPMixer *_Nonnull mixer, int64_t timeoutMs);
+
+// MARK: - Render
+
+void SLPMixerRender(SLPMixer *_Nonnull mixer, float *_Nonnull left, float *_Nonnull right,
+                    uint32_t frameCount);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPMixer_h */
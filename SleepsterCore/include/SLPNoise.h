@@ -0,0 +1,34 @@
+//
+//  SLPNoise.h
+//  SleepsterCore
+//
+//  Procedural noise sources. They are generated on the render thread, need
+//  no asset or decoding, and play until stopped.
+//
+
+#ifndef SLPNoise_h
+#define SLPNoise_h
+
+#include "SLPMixer.h"
+
+SLP_EXTERN_C_BEGIN
+
+typedef enum {
+    SLPNoiseColorWhite = 0,
+    SLPNoiseColorPink = 1,
+    SLPNoiseColorBrown = 2,
+} SLPNoiseColor;
+
+/// Parameter ids for SLPMixerSetSourceParameter on a noise voice.
+enum {
+    /// Spectral tilt in dB per octave, -6 (brown) ... -3 (pink) ... 0 (white);
+    /// changes glide over about 50 ms.
+    SLPNoiseParameterTilt = 0,
+};
+
+/// Equal seeds give identical noise.
+SLPSource *_Nullable SLPSourceCreateNoise(SLPNoiseColor color, uint64_t seed);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPNoise_h */
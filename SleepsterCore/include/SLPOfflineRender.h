@@ -0,0 +1,101 @@
+//
+//  SLPOfflineRender.h
+//  SleepsterCore
+//
+//  Renders a mix faster than real time, split across worker threads: for
+//  pre-rendered overnight mixes and reproducible test output. Build the mix
+//  on one thread; rendering blocks the calling thread until it is done, so
+//  call it off the main actor.
+//
+
+#ifndef SLPOfflineRender_h
+#define SLPOfflineRender_h
+
+#include "SLPAssetPack.h"
+#include "SLPAutomation.h"
+#include "SLPEffects.h"
+#include "SLPNoise.h"
+
+SLP_EXTERN_C_BEGIN
+
+typedef struct SLPOfflineMix SLPOfflineMix;
+
+typedef enum {
+    SLPAudioFileTypeWAV = 0,
+    /// No 4 GB limit; use for renders longer than about six hours.
+    SLPAudioFileTypeCAF = 1,
+} SLPAudioFileType;
+
+typedef enum {
+    SLPSampleFormatInt16 = 0,
+    SLPSampleFormatFloat32 = 1,
+} SLPSampleFormat;
+
+typedef struct {
+    float volume;
+    /// Equal-power rise from silence at the start of the render.
+    double fadeInSeconds;
+    /// Exponential fall to silence ending with the render.
+    double fadeOutSeconds;
+} SLPOfflineTrackConfig;
+
+typedef struct {
+    /// 0 uses one thread per core.
+    uint32_t threads;
+    /// Length of the independently rendered pieces; 0 for the default (30 s).
+    double chunkSeconds;
+} SLPOfflineRenderConfig;
+
+typedef struct {
+    uint64_t frames;
+    uint32_t threads;
+    uint32_t chunks;
+    double wallSeconds;
+    /// Seconds of audio per second of wall time.
+    double realTimeFactor;
+} SLPOfflineRenderStats;
+
+SLPOfflineMix *_Nullable SLPOfflineMixCreate(double sampleRate, double durationSeconds);
+void SLPOfflineMixDestroy(SLPOfflineMix *_Nullable mix);
+
+// MARK: - Tracks
+
+/// Returns false if the pack has no sound called `name`. The mix keeps the
+/// pack's mapping alive.
+bool SLPOfflineMixAddPacked(SLPOfflineMix *_Nonnull mix, const SLPAssetPack *_Nonnull pack,
+                            const char *_Nonnull name, bool loop, SLPOfflineTrackConfig config);
+bool SLPOfflineMixAddNoise(SLPOfflineMix *_Nonnull mix, SLPNoiseColor color, uint64_t seed,
+                           SLPOfflineTrackConfig config);
+/// Returns false if the file is missing or not a supported WAV.
+bool SLPOfflineMixAddWAV(SLPOfflineMix *_Nonnull mix, const char *_Nonnull path, bool loop,
+                         SLPOfflineTrackConfig config);
+
+// MARK: - Master bus
+
+void SLPOfflineMixSetMasterVolume(SLPOfflineMix *_Nonnull mix, float volume);
+/// Gains in dB; missing bands are flat.
+void SLPOfflineMixSetEQ(SLPOfflineMix *_Nonnull mix, bool enabled, const float *_Nullable gainsDb,
+                        uint32_t count);
+void SLPOfflineMixSetDelay(SLPOfflineMix *_Nonnull mix, bool enabled, double seconds, float feedback,
+                           float wet);
+void SLPOfflineMixSetReverb(SLPOfflineMix *_Nonnull mix, bool enabled, SLPReverbPreset preset, float wet);
+/// Copies the timeline; channel lanes address tracks in the order they were
+/// added. NULL removes it.
+void SLPOfflineMixSetAutomation(SLPOfflineMix *_Nonnull mix, const SLPAutomation *_Nullable automation);
+
+// MARK: - Rendering
+
+/// Stereo file, written as the render goes. A failed render leaves no file.
+bool SLPOfflineMixRenderToFile(const SLPOfflineMix *_Nonnull mix, const char *_Nonnull path,
+                               SLPAudioFileType type, SLPSampleFormat format, SLPOfflineRenderConfig config,
+                               SLPOfflineRenderStats *_Nullable stats);
+
+/// Fills `left`/`right` with up to `capacity` frames of the render; the
+/// rest of the mix is not rendered.
+bool SLPOfflineMixRenderToBuffer(const SLPOfflineMix *_Nonnull mix, float *_Nonnull left, float *_Nonnull right,
+                                 uint64_t capacity, SLPOfflineRenderConfig config,
+                                 SLPOfflineRenderStats *_Nullable stats);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPOfflineRender_h */
@@ -0,0 +1,64 @@
+//
+//  SLPPalette.h
+//  SleepsterCore
+//
+//  Background colours resolved once per colour theme, dimmed state and
+//  intensity tier. Colours are packed 0xRRGGBBAA with straight alpha. Every
+//  palette is built on first use and stays valid for the life of the
+//  process, so a view converts what it needs once and indexes into it on
+//  every frame. Safe on any thread.
+//
+
+#ifndef SLPPalette_h
+#define SLPPalette_h
+
+#include "SLPBase.h"
+
+SLP_EXTERN_C_BEGIN
+
+/// ColorTheme, in its declaration order.
+typedef enum {
+    SLPPaletteThemeDefault = 0,
+    SLPPaletteThemeWarm = 1,
+    SLPPaletteThemeCool = 2,
+    SLPPaletteThemeMonochrome = 3,
+} SLPPaletteTheme;
+
+typedef enum {
+    SLPSwatchSheepBody = 0,
+    SLPSwatchAccent = 1,
+    SLPSwatchAccentStroke = 2,
+} SLPSwatch;
+
+typedef enum {
+    SLPPaletteGradientMeadowSky = 0,
+    SLPPaletteGradientHorizonGlow = 1,
+    SLPPaletteGradientCloud = 2,
+    SLPPaletteGradientSheepShadow = 3,
+    SLPPaletteGradientOceanDepth = 4,
+    SLPPaletteGradientCaustics = 5,
+    SLPPaletteGradientBubble = 6,
+    SLPPaletteGradientMandalaGlow = 7,
+    SLPPaletteGradientCrystal = 8,
+} SLPPaletteGradient;
+
+static const uint32_t SLPPaletteTierCount = 4;
+static const uint32_t SLPPaletteRampSize = 256;
+
+/// Evenly spaced stops; `count` is 2, 3 or 4.
+typedef struct {
+    uint32_t colors[4];
+    uint32_t count;
+} SLPGradientStops;
+
+/// The tier for a view's intensity, 0...1.
+uint32_t SLPPaletteTier(float intensity);
+uint32_t SLPPaletteGetSwatch(SLPPaletteTheme theme, bool dimmed, uint32_t tier, SLPSwatch swatch);
+SLPGradientStops SLPPaletteGetStops(SLPPaletteTheme theme, bool dimmed, uint32_t tier, SLPPaletteGradient gradient);
+/// SLPPaletteRampSize colours sampled evenly along the gradient.
+const uint32_t *_Nonnull SLPPaletteGetRamp(SLPPaletteTheme theme, bool dimmed, uint32_t tier,
+                                           SLPPaletteGradient gradient);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPPalette_h */
@@ -0,0 +1,105 @@
+//
+//  SLPParticles.h
+//  SleepsterCore
+//
+//  Particle scenes for the animated backgrounds. A scene is created and
+//  stepped on the main thread; views read positions straight from the
+//  column buffers, which stay valid for the scene's lifetime.
+//
+
+#ifndef SLPParticles_h
+#define SLPParticles_h
+
+#include "SLPBase.h"
+
+SLP_EXTERN_C_BEGIN
+
+typedef struct SLPParticleScene SLPParticleScene;
+
+typedef enum {
+    /// Stays where it spawned.
+    SLPParticleMotionStatic = 0,
+    /// Constant velocity, wrapping around the bounds.
+    SLPParticleMotionDrift = 1,
+    /// Circles a drifting anchor.
+    SLPParticleMotionOrbit = 2,
+    /// Falls (or rises) with the wind and re-enters after leaving.
+    SLPParticleMotionFall = 3,
+} SLPParticleMotion;
+
+typedef struct {
+    float min;
+    float max;
+} SLPParticleRange;
+
+typedef struct {
+    float minX;
+    float minY;
+    float maxX;
+    float maxY;
+} SLPParticleBounds;
+
+/// Ranges are sampled per particle at spawn; zeroed fields are off. See
+/// sleepster::ParticleConfig for what each one means per motion.
+typedef struct {
+    SLPParticleMotion motion;
+    uint32_t count;
+    SLPParticleBounds bounds;
+    SLPParticleRange x;
+    SLPParticleRange y;
+    /// Points per second.
+    SLPParticleRange velocityX;
+    SLPParticleRange velocityY;
+    SLPParticleRange radiusX;
+    SLPParticleRange radiusY;
+    /// Radians per second.
+    SLPParticleRange orbitRate;
+    SLPParticleRange size;
+    SLPParticleRange alpha;
+    /// Radians per second; zero for a steady alpha.
+    SLPParticleRange twinkleRate;
+    float twinkleDepth;
+    float windX;
+    float windY;
+} SLPParticleConfig;
+
+/// A falling particle that left through the far edge during the last step.
+typedef struct {
+    uint32_t index;
+    float x;
+    float y;
+} SLPParticleExit;
+
+/// Equal seeds and equal steps give identical scenes.
+SLPParticleScene *_Nonnull SLPParticleSceneCreate(uint64_t seed);
+void SLPParticleSceneDestroy(SLPParticleScene *_Nullable scene);
+
+/// Returns the new system's index, or -1 for an invalid config.
+int32_t SLPParticleSceneAddSystem(SLPParticleScene *_Nonnull scene, SLPParticleConfig config);
+/// Advances every system; never allocates. Steps longer than 0.25 s are
+/// shortened to that.
+void SLPParticleSceneStep(SLPParticleScene *_Nonnull scene, double seconds);
+/// Advances by `seconds` of display time in fixed 1/60 s steps (at most
+/// eight) and interpolates positions between the last two, so motion is
+/// smooth at any frame rate. Returns the number of steps taken.
+int32_t SLPParticleSceneAdvance(SLPParticleScene *_Nonnull scene, double seconds);
+
+void SLPParticleSceneSetBounds(SLPParticleScene *_Nonnull scene, uint32_t system, SLPParticleBounds bounds);
+void SLPParticleSceneSetWind(SLPParticleScene *_Nonnull scene, uint32_t system, float x, float y);
+
+// MARK: - Reading
+
+uint32_t SLPParticleSceneGetCount(const SLPParticleScene *_Nonnull scene, uint32_t system);
+/// Positions to draw, interpolated after SLPParticleSceneAdvance.
+const float *_Nonnull SLPParticleSceneGetX(const SLPParticleScene *_Nonnull scene, uint32_t system);
+const float *_Nonnull SLPParticleSceneGetY(const SLPParticleScene *_Nonnull scene, uint32_t system);
+const float *_Nonnull SLPParticleSceneGetSize(const SLPParticleScene *_Nonnull scene, uint32_t system);
+const float *_Nonnull SLPParticleSceneGetAlpha(const SLPParticleScene *_Nonnull scene, uint32_t system);
+/// Exits from the last step, or from every step of the last advance; valid
+/// until the next one.
+const SLPParticleExit *_Nullable SLPParticleSceneGetExits(const SLPParticleScene *_Nonnull scene, uint32_t system,
+                                                          uint32_t *_Nonnull count);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPParticles_h */
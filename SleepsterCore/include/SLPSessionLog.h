@@ -0,0 +1,65 @@
+//
+//  SLPSessionLog.h
+//  SleepsterCore
+//
+//  Append-only store for the sleep sessions SleepTracker records. Storing a
+//  session costs one appended record whatever the history holds; storing
+//  it again under the same id replaces it. Safe to call from any thread,
+//  so compaction can run on a background queue.
+//
+
+#ifndef SLPSessionLog_h
+#define SLPSessionLog_h
+
+#include "SLPBase.h"
+#include "SLPSoundEvents.h"
+
+SLP_EXTERN_C_BEGIN
+
+typedef struct SLPSessionLog SLPSessionLog;
+
+/// Strings are UTF-8. Times, sound event times included, are seconds since
+/// 1970; NaN marks an end time or actual duration that is not known yet.
+typedef struct {
+    uint8_t id[16];
+    double startTime;
+    double endTime;
+    double expectedDuration;
+    double actualDuration;
+    const char *_Nonnull const *_Nullable soundsUsed;
+    size_t soundsUsedCount;
+    const char *_Nullable backgroundUsed;
+    float masterVolume;
+    const char *_Nonnull const *_Nullable activeSounds;
+    size_t activeSoundsCount;
+    const char *_Nonnull equalizerPreset;
+    bool effectsEnabled;
+    const SLPSoundEvent *_Nullable soundEvents;
+    size_t soundEventsCount;
+} SLPSleepSession;
+
+/// Opens or creates the log at `path` (and its index beside it), recovering
+/// from an interrupted write. NULL if it cannot be opened.
+SLPSessionLog *_Nullable SLPSessionLogOpen(const char *_Nonnull path);
+void SLPSessionLogClose(SLPSessionLog *_Nullable log);
+
+/// False if the write failed.
+bool SLPSessionLogAppend(SLPSessionLog *_Nonnull log, const SLPSleepSession *_Nonnull session);
+bool SLPSessionLogRemove(SLPSessionLog *_Nonnull log, const uint8_t *_Nonnull id);
+
+/// Live sessions, oldest first.
+size_t SLPSessionLogGetCount(const SLPSessionLog *_Nonnull log);
+/// Fills `out` with the `index`th session. Its strings and sound events stay
+/// valid until the next call on this log from the same thread.
+bool SLPSessionLogGetSession(const SLPSessionLog *_Nonnull log, size_t index, SLPSleepSession *_Nonnull out);
+
+/// True once superseded and removed records take up half of a log of at
+/// least 64 KB.
+bool SLPSessionLogNeedsCompaction(const SLPSessionLog *_Nonnull log);
+/// Rewrites the log with only the live sessions; blocks, so run it off the
+/// main thread.
+bool SLPSessionLogCompact(SLPSessionLog *_Nonnull log);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPSessionLog_h */
@@ -0,0 +1,70 @@
+//
+//  SLPSleepStats.h
+//  SleepsterCore
+//
+//  Running sleep statistics behind `SleepTracker`'s insights. HealthKit
+//  samples are added and removed as they arrive; any range of nights, and
+//  each ISO week and calendar month, is then summarized without visiting
+//  the samples again.
+//
+
+#ifndef SLPSleepStats_h
+#define SLPSleepStats_h
+
+#include "SLPBase.h"
+
+SLP_EXTERN_C_BEGIN
+
+typedef struct SLPSleepStats SLPSleepStats;
+
+typedef enum {
+    SLPSleepCategoryInBed = 0,
+    SLPSleepCategoryAsleep = 1,
+} SLPSleepCategory;
+
+/// Times are seconds since 1970; `utcOffset` is the local time zone's
+/// offset at `startTime`, in seconds east of UTC.
+typedef struct {
+    uint8_t id[16];
+    double startTime;
+    double endTime;
+    int32_t utcOffset;
+    SLPSleepCategory category;
+} SLPSleepSample;
+
+/// Durations and bedtimes are in seconds; bedtimes count from local
+/// midnight. `efficiency` and `bedtimeConsistency` are percentages.
+typedef struct {
+    uint64_t asleepCount;
+    double totalAsleep;
+    double averageAsleep;
+    double asleepDeviation;
+    uint64_t inBedCount;
+    double totalInBed;
+    double efficiency;
+    double meanBedtime;
+    double bedtimeDeviation;
+    double bedtimeConsistency;
+} SLPSleepSummary;
+
+SLPSleepStats *_Nonnull SLPSleepStatsCreate(void);
+void SLPSleepStatsDestroy(SLPSleepStats *_Nullable stats);
+
+/// False when the sample is already held or its times are invalid.
+bool SLPSleepStatsAdd(SLPSleepStats *_Nonnull stats, const SLPSleepSample *_Nonnull sample);
+bool SLPSleepStatsRemove(SLPSleepStats *_Nonnull stats, const uint8_t *_Nonnull id);
+size_t SLPSleepStatsGetCount(const SLPSleepStats *_Nonnull stats);
+
+/// The night holding `time`: local days since 1970-01-01, counted from
+/// noon, so a night is named after the evening it starts.
+int64_t SLPSleepStatsNightOf(double time, int32_t utcOffset);
+/// Nights `firstNight` through `lastNight`, inclusive.
+SLPSleepSummary SLPSleepStatsGetRange(const SLPSleepStats *_Nonnull stats, int64_t firstNight, int64_t lastNight);
+/// The ISO week or calendar month holding `night`.
+SLPSleepSummary SLPSleepStatsGetWeek(const SLPSleepStats *_Nonnull stats, int64_t night);
+SLPSleepSummary SLPSleepStatsGetMonth(const SLPSleepStats *_Nonnull stats, int64_t night);
+SLPSleepSummary SLPSleepStatsGetTotal(const SLPSleepStats *_Nonnull stats);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPSleepStats_h */
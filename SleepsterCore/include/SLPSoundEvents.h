@@ -0,0 +1,58 @@
+//
+//  SLPSoundEvents.h
+//  SleepsterCore
+//
+//  Streaming detector for snoring, talking, coughing and loud noise in
+//  microphone audio. Processing never allocates and costs a level
+//  measurement per hop while the room is quiet; finished events wait in a
+//  fixed-size queue until taken.
+//
+
+#ifndef SLPSoundEvents_h
+#define SLPSoundEvents_h
+
+#include "SLPBase.h"
+
+SLP_EXTERN_C_BEGIN
+
+typedef struct SLPSoundEventDetector SLPSoundEventDetector;
+
+typedef enum {
+    SLPSoundEventSnoring = 1,
+    SLPSoundEventTalking = 2,
+    SLPSoundEventCoughing = 3,
+    SLPSoundEventLoudNoise = 4,
+} SLPSoundEventKind;
+
+/// `time` is seconds since the detector started; in a stored session it is
+/// seconds since 1970. `peakLevel` is dBFS.
+typedef struct {
+    SLPSoundEventKind kind;
+    double time;
+    float duration;
+    float peakLevel;
+} SLPSoundEvent;
+
+typedef struct {
+    uint64_t analyzedHops;
+    uint64_t gatedHops;
+    uint64_t droppedEvents;
+    float noiseFloor;
+} SLPSoundEventDetectorMetrics;
+
+SLPSoundEventDetector *_Nonnull SLPSoundEventDetectorCreate(double sampleRate);
+void SLPSoundEventDetectorDestroy(SLPSoundEventDetector *_Nullable detector);
+
+/// Mono samples, any count at a time, from one thread.
+void SLPSoundEventDetectorProcess(SLPSoundEventDetector *_Nonnull detector, const float *_Nonnull samples,
+                                  size_t count);
+/// Ends the event in progress.
+void SLPSoundEventDetectorFlush(SLPSoundEventDetector *_Nonnull detector);
+/// Moves up to `capacity` finished events to `events`, oldest first.
+size_t SLPSoundEventDetectorTakeEvents(SLPSoundEventDetector *_Nonnull detector, SLPSoundEvent *_Nonnull events,
+                                       size_t capacity);
+SLPSoundEventDetectorMetrics SLPSoundEventDetectorGetMetrics(const SLPSoundEventDetector *_Nonnull detector);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPSoundEvents_h */
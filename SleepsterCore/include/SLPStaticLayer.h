@@ -0,0 +1,94 @@
+//
+//  SLPStaticLayer.h
+//  SleepsterCore
+//
+//  Pre-rasterized background layers (hills, grass, star sprites). Build a
+//  layer once when a background appears, copy its pixels into an image and
+//  destroy it; nothing here is needed per frame.
+//
+
+#ifndef SLPStaticLayer_h
+#define SLPStaticLayer_h
+
+#include "SLPParticles.h"
+
+SLP_EXTERN_C_BEGIN
+
+typedef struct SLPStaticLayer SLPStaticLayer;
+
+/// Straight (not premultiplied) colour, every channel 0...1.
+typedef struct {
+    float r;
+    float g;
+    float b;
+    float a;
+} SLPColor;
+
+/// Evenly spaced stops; `count` is 1, 2 or 3.
+typedef struct {
+    SLPColor stops[3];
+    uint32_t count;
+} SLPGradient;
+
+typedef struct {
+    /// EnhancedHillShape's frame, in points.
+    float top;
+    float height;
+    /// Top to bottom of the frame.
+    SLPGradient fill;
+    float blur;
+} SLPHillConfig;
+
+typedef struct {
+    uint64_t seed;
+    float width;
+    float scale;
+    float spacing;
+    float jitterX;
+    float jitterY;
+    /// Where the blades stand, in points from the top of the screen.
+    float baseline;
+    SLPParticleRange bladeHeight;
+    SLPParticleRange bladeWidth;
+    SLPGradient fill;
+    float blur;
+    SLPColor shadow;
+    float shadowRadius;
+    float shadowX;
+    float shadowY;
+} SLPGrassConfig;
+
+typedef struct {
+    float scale;
+    SLPParticleRange size;
+    uint32_t count;
+    SLPGradient fill;
+    float fillRadius;
+} SLPStarSpriteConfig;
+
+/// Where a layer sits, in points.
+typedef struct {
+    float x;
+    float y;
+    float width;
+    float height;
+} SLPLayerFrame;
+
+/// Hills back to front in a layer spanning `top`...`bottom`.
+SLPStaticLayer *_Nonnull SLPStaticLayerCreateHills(float width, float top, float bottom, float scale,
+                                                   const SLPHillConfig *_Nonnull hills, uint32_t count);
+SLPStaticLayer *_Nonnull SLPStaticLayerCreateGrass(SLPGrassConfig config);
+/// Sprite i is the square of `*cellPixels` pixels starting at column
+/// i * `*cellPixels`.
+SLPStaticLayer *_Nonnull SLPStaticLayerCreateStarSprites(SLPStarSpriteConfig config, uint32_t *_Nonnull cellPixels);
+void SLPStaticLayerDestroy(SLPStaticLayer *_Nullable layer);
+
+SLPLayerFrame SLPStaticLayerGetFrame(const SLPStaticLayer *_Nonnull layer);
+/// Premultiplied RGBA, eight bits per channel, rows top to bottom.
+uint32_t SLPStaticLayerGetPixelWidth(const SLPStaticLayer *_Nonnull layer);
+uint32_t SLPStaticLayerGetPixelHeight(const SLPStaticLayer *_Nonnull layer);
+const uint8_t *_Nullable SLPStaticLayerGetPixels(const SLPStaticLayer *_Nonnull layer);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPStaticLayer_h */
@@ -0,0 +1,49 @@
+//
+//  SLPStreaming.h
+//  SleepsterCore
+//
+//  Streaming sources: audio is decoded on a background thread into a small
+//  ring buffer per voice instead of being decoded whole up front.
+//
+
+#ifndef SLPStreaming_h
+#define SLPStreaming_h
+
+#include "SLPMixer.h"
+
+SLP_EXTERN_C_BEGIN
+
+/// Decoder implemented by the host (the app wraps ExtAudioFile). All
+/// callbacks run on the background decode thread, except for a short
+/// prefill on the thread that calls SLPMixerPlay.
+typedef struct {
+    void *_Nullable context;
+    /// Native rate of the decoded audio; resampled to the mixer rate if needed.
+    double sampleRate;
+    /// Total frames, or 0 when unknown.
+    uint64_t frameCount;
+    /// Writes up to `frames` planar stereo frames; returns 0 only at end of stream.
+    uint64_t (*_Nonnull decode)(void *_Nullable context, float *_Nonnull left,
+                                float *_Nonnull right, uint64_t frames);
+    bool (*_Nonnull seek)(void *_Nullable context, uint64_t frame);
+    /// Called once when the source is destroyed.
+    void (*_Nullable release)(void *_Nullable context);
+} SLPDecoderCallbacks;
+
+typedef struct {
+    /// Seconds buffered ahead of the render cursor (default 2).
+    double lookaheadSeconds;
+    bool loop;
+} SLPStreamingConfig;
+
+SLPSource *_Nullable SLPSourceCreateStream(SLPDecoderCallbacks callbacks, SLPStreamingConfig config);
+
+/// Streams a memory-mapped WAV file (16/24-bit PCM or 32-bit float).
+SLPSource *_Nullable SLPSourceCreateWAVStream(const char *_Nonnull path, SLPStreamingConfig config);
+
+/// CPU seconds spent by the shared decode thread since launch.
+double SLPStreamingGetDecodeCPUSeconds(void);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPStreaming_h */
@@ -0,0 +1,54 @@
+//
+//  SLPTimerWheel.h
+//  SleepsterCore
+//
+//  The coalescing timer wheel behind the app's `TimerScheduler`. Times are
+//  seconds on the caller's clock; the wheel fires a timer anywhere between
+//  its deadline and the end of its tolerance, batching timers whose windows
+//  overlap into one wakeup.
+//
+
+#ifndef SLPTimerWheel_h
+#define SLPTimerWheel_h
+
+#include "SLPBase.h"
+
+SLP_EXTERN_C_BEGIN
+
+typedef struct SLPTimerWheel SLPTimerWheel;
+
+/// Never reused while the wheel lives; 0 names no timer.
+typedef uint64_t SLPTimerID;
+
+typedef struct {
+    uint64_t wakeups;
+    uint64_t fired;
+    double wakeupsPerHour;
+} SLPTimerWheelMetrics;
+
+/// `now` becomes the wheel's origin.
+SLPTimerWheel *_Nonnull SLPTimerWheelCreate(double now);
+void SLPTimerWheelDestroy(SLPTimerWheel *_Nullable wheel);
+
+/// `interval` 0 schedules a one-shot. Critical timers keep their tolerance
+/// in low-power mode.
+SLPTimerID SLPTimerWheelSchedule(SLPTimerWheel *_Nonnull wheel, double deadline, double interval,
+                                 double tolerance, bool critical);
+/// Returns false when the timer already fired or was cancelled.
+bool SLPTimerWheelCancel(SLPTimerWheel *_Nonnull wheel, SLPTimerID timer);
+
+/// When to call SLPTimerWheelAdvance next; infinity when nothing is
+/// scheduled.
+double SLPTimerWheelGetNextWakeup(const SLPTimerWheel *_Nonnull wheel);
+
+/// Moves the clock to `now` and returns how many timers fired. Their ids
+/// are in `*fired`, valid until the next call on the wheel.
+size_t SLPTimerWheelAdvance(SLPTimerWheel *_Nonnull wheel, double now,
+                            const SLPTimerID *_Nullable *_Nonnull fired);
+
+void SLPTimerWheelSetLowPower(SLPTimerWheel *_Nonnull wheel, bool enabled);
+SLPTimerWheelMetrics SLPTimerWheelGetMetrics(const SLPTimerWheel *_Nonnull wheel);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPTimerWheel_h */
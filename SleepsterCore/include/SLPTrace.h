@@ -0,0 +1,54 @@
+//
+//  SLPTrace.h
+//  SleepsterCore
+//
+//  Spans and counters recorded into per-thread lock-free rings, alongside
+//  those the core records itself around mixing, effects and particles, and
+//  exported as Chrome trace-event JSON for chrome://tracing or Perfetto.
+//  Recording never locks or allocates; while tracing is off it returns at
+//  once.
+//
+
+#ifndef SLPTrace_h
+#define SLPTrace_h
+
+#include "SLPBase.h"
+
+SLP_EXTERN_C_BEGIN
+
+typedef enum {
+    SLPTraceCategoryAudio = 0,
+    SLPTraceCategoryAnimation = 1,
+    SLPTraceCategoryStorage = 2,
+    SLPTraceCategoryApp = 3,
+} SLPTraceCategory;
+
+typedef struct {
+    uint64_t recorded;
+    uint64_t overwritten;
+    uint64_t untracked;
+} SLPTraceMetrics;
+
+/// Allocates the rings the first time tracing is turned on.
+void SLPTraceSetEnabled(bool enabled);
+bool SLPTraceIsEnabled(void);
+/// Names the calling thread's track in the export. Takes a lock.
+void SLPTraceSetThreadName(const char *_Nonnull name);
+
+/// When a span starts; 0 while tracing is off.
+uint64_t SLPTraceBegin(void);
+/// Records the span from `begin`, unless `begin` is 0. `name` is kept, not
+/// copied, so it must live as long as the trace: a string literal.
+void SLPTraceEnd(SLPTraceCategory category, const char *_Nonnull name, uint64_t begin);
+/// `name` as for SLPTraceEnd.
+void SLPTraceCounter(SLPTraceCategory category, const char *_Nonnull name, double value);
+
+/// Forgets what was recorded so far.
+void SLPTraceClear(void);
+/// Writes what the rings hold; false if the file cannot be written.
+bool SLPTraceExportChromeJson(const char *_Nonnull path);
+SLPTraceMetrics SLPTraceGetMetrics(void);
+
+SLP_EXTERN_C_END
+
+#endif /* SLPTrace_h */
@@ -0,0 +1,36 @@
+//
+//  SleepsterCore.h
+//  SleepsterCore
+//
+//  Umbrella header for the C interface imported by the app's bridging
+//  header. The C++ API lives under include/sleepster/.
+//
+
+#ifndef SleepsterCore_h
+#define SleepsterCore_h
+
+#include "SLPAnalytics.h"
+#include "SLPAssetPack.h"
+#include "SLPAutomation.h"
+#include "SLPBootstrap.h"
+#include "SLPBrightnessRamp.h"
+#include "SLPCatalog.h"
+#include "SLPEffects.h"
+#include "SLPEqualizer.h"
+#include "SLPFramePacer.h"
+#include "SLPGeometry.h"
+#include "SLPMasking.h"
+#include "SLPMixer.h"
+#include "SLPNoise.h"
+#include "SLPOfflineRender.h"
+#include "SLPPalette.h"
+#include "SLPParticles.h"
+#include "SLPSessionLog.h"
+#include "SLPSleepStats.h"
+#include "SLPSoundEvents.h"
+#include "SLPStaticLayer.h"
+#include "SLPStreaming.h"
+#include "SLPTimerWheel.h"
+#include "SLPTrace.h"
+
+#endif /* SleepsterCore_h */
@@ -0,0 +1,262 @@
+//
+//  Analytics.hpp
+//  SleepsterCore
+//
+//  Local analytics pipeline that sits in front of any backend. Event and
+//  parameter names are interned once, up front, into 16-bit ids, so logging
+//  an event copies a fixed 64-byte record into an MpscQueue and never
+//  builds a dictionary, takes a lock or allocates; any thread, the render
+//  thread included, may log. A background flusher wakes every few seconds,
+//  or as soon as half the ring has filled, and hands what it drained to a
+//  sink in one batch. Timed events never reach the sink one by one: the
+//  flusher pairs each end with its start and folds the duration into a
+//  per-event count, total, minimum and maximum, written once per batch.
+//
+//  When the ring is full an event is dropped and counted, never waited for.
+//
+
+#pragma once
+
+#include "sleepster/MpscQueue.hpp"
+#include "sleepster/Semaphore.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace sleepster {
+
+/// An interned event, error or parameter name, or string value.
+using AnalyticsName = uint16_t;
+constexpr AnalyticsName kNoAnalyticsName = 0xFFFF;
+
+enum class AnalyticsKind : uint8_t {
+    Event = 0,
+    TimedBegin = 1,
+    TimedEnd = 2,
+    Error = 3,
+};
+
+enum class AnalyticsValueType : uint8_t {
+    Integer = 0,
+    Number = 1,
+    Name = 2,
+};
+
+struct AnalyticsParameter {
+    AnalyticsName key = kNoAnalyticsName;
+    AnalyticsValueType type = AnalyticsValueType::Integer;
+    union {
+        int64_t integer = 0;
+        double number;
+        AnalyticsName name;
+    };
+
+    static AnalyticsParameter of(AnalyticsName key, int64_t value) noexcept;
+    static AnalyticsParameter of(AnalyticsName key, double value) noexcept;
+    static AnalyticsParameter named(AnalyticsName key, AnalyticsName value) noexcept;
+};
+
+/// One logged event as it travels through the ring.
+struct AnalyticsRecord {
+    /// Parameters past this many are dropped.
+    static constexpr std::size_t kMaxParameters = 3;
+
+    /// Steady clock, nanoseconds.
+    uint64_t time = 0;
+    /// The event, or for an error its id.
+    AnalyticsName name = kNoAnalyticsName;
+    AnalyticsKind kind = AnalyticsKind::Event;
+    uint8_t parameterCount = 0;
+    AnalyticsParameter parameters[kMaxParameters];
+};
+
+static_assert(sizeof(AnalyticsRecord) == 64, "one record per cache line");
+
+/// Thread-safe table of interned names. Interning takes a lock and may
+/// allocate; looking a name up does neither.
+class AnalyticsNames {
+public:
+    explicit AnalyticsNames(std::size_t capacity);
+
+    AnalyticsNames(const AnalyticsNames&) = delete;
+    AnalyticsNames& operator=(const AnalyticsNames&) = delete;
+
+    /// The id of `name`, added if new; kNoAnalyticsName when the table is
+    /// full or the name is empty.
+    AnalyticsName intern(std::string_view name);
+    /// Empty for ids never handed out.
+    std::string_view name(AnalyticsName id) const noexcept;
+
+    std::size_t size() const noexcept { return count_.load(std::memory_order_acquire); }
+    std::size_t capacity() const noexcept { return capacity_; }
+
+private:
+    const std::size_t capacity_;
+    std::unique_ptr<std::string[]> names_;
+    /// Names below this count are written and never change again.
+    std::atomic<std::size_t> count_{0};
+    std::mutex mutex_;
+    std::unordered_map<std::string, AnalyticsName> ids_;
+};
+
+/// A timed event's runs that ended since the last batch.
+struct AnalyticsTiming {
+    AnalyticsName event = kNoAnalyticsName;
+    uint32_t count = 0;
+    double totalSeconds = 0.0;
+    double minSeconds = 0.0;
+    double maxSeconds = 0.0;
+    /// Parameters of the last run: those it ended with, or if none, those
+    /// it started with.
+    uint8_t parameterCount = 0;
+    AnalyticsParameter parameters[AnalyticsRecord::kMaxParameters];
+};
+
+struct AnalyticsBatch {
+    const AnalyticsNames* names = nullptr;
+    /// Events and errors, in the order they were logged.
+    const AnalyticsRecord* records = nullptr;
+    std::size_t recordCount = 0;
+    const AnalyticsTiming* timings = nullptr;
+    std::size_t timingCount = 0;
+    /// Events the full ring turned away since the last batch.
+    uint64_t dropped = 0;
+    /// Seconds since 1970 at steady time 0; add a record's time.
+    double epoch = 0.0;
+    /// Seconds since 1970 when the batch was drained.
+    double now = 0.0;
+
+    double wallTime(uint64_t steadyNanos) const noexcept { return epoch + static_cast<double>(steadyNanos) * 1e-9; }
+};
+
+/// Where batches go. Called on the flusher thread, or the thread calling
+/// AnalyticsPipeline::flush, one batch at a time.
+class AnalyticsSink {
+public:
+    virtual ~AnalyticsSink() = default;
+    /// False if the batch could not be stored; it is not retried.
+    virtual bool write(const AnalyticsBatch& batch) = 0;
+};
+
+/// Appends each batch to a file as JSON lines, in a single write.
+class AnalyticsFileSink : public AnalyticsSink {
+public:
+    /// nullptr if `path` cannot be opened for appending.
+    static std::unique_ptr<AnalyticsFileSink> open(const std::string& path);
+    ~AnalyticsFileSink() override;
+
+    bool write(const AnalyticsBatch& batch) override;
+
+private:
+    explicit AnalyticsFileSink(int fd) : fd_(fd) {}
+
+    int fd_;
+    /// Reused from batch to batch.
+    std::string text_;
+};
+
+struct AnalyticsConfig {
+    /// Records the ring holds.
+    std::size_t capacity = 4096;
+    /// Names that can be interned.
+    std::size_t nameCapacity = 1024;
+    /// How often the flusher wakes when the ring is quiet.
+    double flushIntervalSeconds = 10.0;
+};
+
+struct AnalyticsMetrics {
+    /// Records handed to the sink, and timed runs folded into timings.
+    uint64_t written = 0;
+    uint64_t dropped = 0;
+    uint64_t batches = 0;
+    uint64_t failedBatches = 0;
+};
+
+class AnalyticsPipeline {
+public:
+    explicit AnalyticsPipeline(std::unique_ptr<AnalyticsSink> sink, const AnalyticsConfig& config = {});
+    /// Stops the flusher and writes what is still queued.
+    ~AnalyticsPipeline();
+
+    AnalyticsPipeline(const AnalyticsPipeline&) = delete;
+    AnalyticsPipeline& operator=(const AnalyticsPipeline&) = delete;
+
+    AnalyticsName intern(std::string_view name) { return names_.intern(name); }
+    const AnalyticsNames& names() const noexcept { return names_; }
+
+    // Any thread; lock-free and never allocating. False when the event was
+    // dropped or logging is off.
+    bool logEvent(AnalyticsName event, const AnalyticsParameter* parameters = nullptr,
+                  std::size_t count = 0) noexcept;
+    /// Starts a run of `event`; a second start restarts it.
+    bool beginTimedEvent(AnalyticsName event, const AnalyticsParameter* parameters = nullptr,
+                         std::size_t count = 0) noexcept;
+    /// Ends the run; parameters given here replace those it started with.
+    bool endTimedEvent(AnalyticsName event, const AnalyticsParameter* parameters = nullptr,
+                       std::size_t count = 0) noexcept;
+    bool logError(AnalyticsName error, AnalyticsName message) noexcept;
+
+    /// Off drops events at once, without counting them; for when the user
+    /// has not consented.
+    void setEnabled(bool enabled) noexcept { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool enabled() const noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+    /// Drains the ring into the sink on the calling thread.
+    void flush();
+
+    AnalyticsMetrics metrics() const noexcept;
+
+private:
+    struct Timing {
+        uint64_t startedAt = 0;
+        bool running = false;
+        AnalyticsTiming ended;
+    };
+
+    bool enqueue(AnalyticsKind kind, AnalyticsName name, const AnalyticsParameter* parameters,
+                 std::size_t count) noexcept;
+    void run();
+    /// With `drainMutex_` held.
+    void drain();
+    void fold(const AnalyticsRecord& record);
+    void writeBatch();
+
+    const AnalyticsConfig config_;
+    AnalyticsNames names_;
+    std::unique_ptr<AnalyticsSink> sink_;
+    MpscQueue<AnalyticsRecord> queue_;
+    /// Pushes between wakeups of the flusher; a power of two.
+    const std::size_t wakeEvery_;
+    const AnalyticsName messageKey_;
+    std::atomic<bool> enabled_{true};
+    double epoch_ = 0.0;
+
+    std::mutex drainMutex_;
+    std::vector<AnalyticsRecord> records_;
+    /// Indexed by event name.
+    std::vector<Timing> timings_;
+    /// Names of the timings that ended since the last batch, then the
+    /// timings handed to the sink.
+    std::vector<AnalyticsName> ended_;
+    std::vector<AnalyticsTiming> endedTimings_;
+    uint64_t droppedReported_ = 0;
+
+    alignas(64) std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> failedBatches_{0};
+
+    Semaphore wakeup_;
+    std::atomic<bool> running_{true};
+    std::thread thread_;
+};
+
+} // namespace sleepster
@@ -0,0 +1,120 @@
+//
+//  AssetPack.hpp
+//  SleepsterCore
+//
+//  Reader for the sound pack built by tools/SoundPacker: one file holding
+//  every bundled sound as 16-bit PCM, already at the mixer's rate, with
+//  precomputed loop points and loudness. The file is memory-mapped and
+//  sources play straight out of the mapping, so starting a voice costs an
+//  index lookup rather than a decode.
+//
+//  Layout (little-endian):
+//
+//      header   "SLPK", version, sample rate, entry count, index offset,
+//               file size                                       32 bytes
+//      index    one 96-byte entry per asset, sorted by name
+//      data     interleaved int16 frames per asset, page-aligned
+//
+
+#pragma once
+
+#include "sleepster/AudioSource.hpp"
+#include "sleepster/MappedFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sleepster {
+
+namespace assetpack {
+
+constexpr char kMagic[4] = {'S', 'L', 'P', 'K'};
+constexpr uint32_t kVersion = 1;
+constexpr std::size_t kHeaderSize = 32;
+constexpr std::size_t kEntrySize = 96;
+/// Longest name, in bytes; names are NUL-padded to this.
+constexpr std::size_t kNameBytes = 64;
+constexpr std::size_t kDataAlignment = 4096;
+
+enum class Encoding : uint16_t {
+    Pcm16 = 1,
+};
+
+} // namespace assetpack
+
+/// A sound inside a mapped pack. `samples` points into the mapping and is
+/// valid as long as the pack is.
+struct AssetView {
+    const int16_t* samples = nullptr;
+    uint32_t channelCount = 0;
+    uint32_t frameCount = 0;
+    /// Playback wraps from loopEnd back to loopStart (frames).
+    uint32_t loopStart = 0;
+    uint32_t loopEnd = 0;
+    double sampleRate = 0.0;
+    /// Integrated loudness (ITU-R BS.1770), LUFS.
+    float loudness = 0.0f;
+    /// Largest absolute sample, 0...1.
+    float peak = 0.0f;
+};
+
+class AssetPack {
+public:
+    /// Maps and validates `path`. Returns nullptr if the file is missing,
+    /// truncated, or not a pack this reader understands.
+    static std::shared_ptr<const AssetPack> open(const std::string& path);
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    double sampleRate() const noexcept { return sampleRate_; }
+    std::size_t size() const noexcept { return entries_.size(); }
+    const std::string& nameAt(std::size_t index) const noexcept { return entries_[index].name; }
+    const AssetView& viewAt(std::size_t index) const noexcept { return entries_[index].view; }
+
+    /// Binary search of the sorted index; nullptr if absent. Does not
+    /// allocate.
+    const AssetView* find(const char* name) const noexcept;
+
+private:
+    struct Entry {
+        std::string name;
+        AssetView view;
+    };
+
+    explicit AssetPack(MappedFile file) : file_(std::move(file)) {}
+    bool parse();
+
+    MappedFile file_;
+    double sampleRate_ = 0.0;
+    std::vector<Entry> entries_;
+};
+
+/// Plays an asset straight from the pack's mapping. Holding the pack keeps
+/// the mapping alive for as long as the voice exists.
+class PackedSource final : public AudioSource {
+public:
+    PackedSource(std::shared_ptr<const AssetPack> pack, const AssetView& view, bool loop);
+
+    void prepare(double sampleRate, std::size_t maxBlockFrames) override;
+    bool seek(uint64_t frame) override;
+    std::size_t render(float* left, float* right, std::size_t frames) noexcept override;
+
+private:
+    std::size_t renderDirect(float* left, float* right, std::size_t frames) noexcept;
+    std::size_t renderResampled(float* left, float* right, std::size_t frames) noexcept;
+    /// Frame at which playback wraps or ends.
+    uint32_t endFrame() const noexcept { return loop_ ? view_.loopEnd : view_.frameCount; }
+
+    std::shared_ptr<const AssetPack> pack_;
+    const AssetView view_;
+    const bool loop_;
+    double step_ = 1.0;
+    double position_ = 0.0;
+    uint32_t cursor_ = 0;
+};
+
+} // namespace sleepster
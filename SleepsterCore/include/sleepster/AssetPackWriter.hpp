@@ -0,0 +1,63 @@
+//
+//  AssetPackWriter.hpp
+//  SleepsterCore
+//
+//  Offline side of the sound pack, used by tools/SoundPacker and the tests:
+//  resamples each sound to the pack rate with a windowed-sinc filter, trims
+//  the silent padding lossy encoders add at both ends, picks a loop end
+//  that joins the loop start without a click, measures loudness, and
+//  writes the container AssetPack reads.
+//
+
+#pragma once
+
+#include "sleepster/AssetPack.hpp"
+#include "sleepster/PcmSource.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sleepster {
+
+struct AssetPackOptions {
+    /// Rate everything is converted to; match the device's output rate.
+    double sampleRate = 48000.0;
+    /// How far before the end to search for the best loop end.
+    double loopSearchSeconds = 0.05;
+};
+
+/// One sound ready to be written.
+struct EncodedAsset {
+    std::string name;
+    uint32_t channelCount = 0;
+    uint32_t frameCount = 0;
+    uint32_t loopStart = 0;
+    uint32_t loopEnd = 0;
+    float loudness = 0.0f;
+    float peak = 0.0f;
+    /// Interleaved 16-bit frames.
+    std::vector<int16_t> samples;
+};
+
+/// Converts `buffer` for the pack. Returns false if the name is empty or too
+/// long, or the sound is silent.
+bool encodeAsset(const std::string& name, const PcmBuffer& buffer, const AssetPackOptions& options,
+                 EncodedAsset& out);
+
+/// Writes `assets` (in any order) to `path` through a temporary file that is
+/// renamed into place, so readers never see a partial pack.
+bool writeAssetPack(const std::string& path, std::vector<EncodedAsset> assets, double sampleRate);
+
+/// Integrated loudness of planar channels in LUFS (ITU-R BS.1770-4:
+/// K-weighting, 400 ms blocks, absolute and relative gates). Returns -70
+/// for material that is entirely below the absolute gate.
+double integratedLoudness(const float* const* channels, uint32_t channelCount, std::size_t frameCount,
+                          double sampleRate);
+
+/// Band-limited resampling with a Blackman-windowed sinc; offline quality,
+/// not real-time cost.
+std::vector<float> resampleOffline(const std::vector<float>& input, double fromRate, double toRate);
+
+} // namespace sleepster
@@ -0,0 +1,69 @@
+//
+//  AudioFileWriter.hpp
+//  SleepsterCore
+//
+//  Incremental WAV or CAF writer for renders too long to hold in memory.
+//  Frames are appended as they arrive and the header sizes are filled in by
+//  finish(). WAV stops at 4 GB of samples (about 6 hours of 16-bit stereo
+//  at 48 kHz); CAF has 64-bit sizes, and an unfinished CAF file still reads
+//  to its last complete frame.
+//
+
+#pragma once
+
+#include "sleepster/WavFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sleepster {
+
+enum class AudioFileType : uint8_t {
+    Wav,
+    Caf,
+};
+
+class AudioFileWriter {
+public:
+    /// Creates `path` for 1 or 2 channels of 16-bit PCM or 32-bit float.
+    /// Returns nullptr for other formats or if the file cannot be created.
+    static std::unique_ptr<AudioFileWriter> create(const std::string& path, AudioFileType type,
+                                                   uint32_t channelCount, double sampleRate,
+                                                   WavFormat::Encoding encoding);
+
+    /// Closes the file; call finish() first to keep it.
+    ~AudioFileWriter();
+
+    AudioFileWriter(const AudioFileWriter&) = delete;
+    AudioFileWriter& operator=(const AudioFileWriter&) = delete;
+
+    /// Appends `frames` frames of planar channels. 16-bit output is clamped
+    /// and rounded. Returns false on a write error or when a WAV file would
+    /// outgrow its 32-bit sizes.
+    bool write(const float* const* channels, std::size_t frames);
+
+    /// Writes the final sizes into the header and closes the file.
+    bool finish();
+
+    uint64_t framesWritten() const noexcept { return frames_; }
+
+private:
+    AudioFileWriter(std::FILE* file, AudioFileType type, uint32_t channelCount, WavFormat::Encoding encoding);
+
+    bool patch(long offset, const std::vector<uint8_t>& bytes);
+
+    std::FILE* file_;
+    const AudioFileType type_;
+    const uint32_t channelCount_;
+    const bool isFloat_;
+    const uint32_t blockAlign_;
+    uint64_t frames_ = 0;
+    bool ok_ = true;
+    std::vector<uint8_t> block_;
+};
+
+} // namespace sleepster
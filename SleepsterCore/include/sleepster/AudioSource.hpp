@@ -0,0 +1,39 @@
+//
+//  AudioSource.hpp
+//  SleepsterCore
+//
+//  Anything the mixer can play: decoded buffers, streams, generators.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sleepster {
+
+class AudioSource {
+public:
+    virtual ~AudioSource() = default;
+
+    /// Called on the control thread before the source is handed to the
+    /// mixer. This is the only place a source may allocate.
+    virtual void prepare(double sampleRate, std::size_t maxBlockFrames) {}
+
+    /// Control thread, after prepare() and before the first render: puts
+    /// the source where it would be after rendering `frame` frames at the
+    /// prepared rate. Offline rendering uses this to start a stretch of the
+    /// timeline in the middle. Returns false if the source cannot seek.
+    virtual bool seek(uint64_t frame) { return false; }
+
+    /// Render thread. Writes up to `frames` stereo frames into `left` and
+    /// `right` and returns how many were written. Returning fewer than
+    /// requested means the source has finished and the voice is released.
+    virtual std::size_t render(float* left, float* right, std::size_t frames) noexcept = 0;
+
+    /// Render thread, between blocks. Sources with live controls (the noise
+    /// generators) define their own parameter ids; others ignore the call.
+    virtual void setParameter(uint32_t parameter, float value) noexcept {}
+};
+
+} // namespace sleepster
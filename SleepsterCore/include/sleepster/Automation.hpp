@@ -0,0 +1,131 @@
+//
+//  Automation.hpp
+//  SleepsterCore
+//
+//  Whole-night mix automation: "rain at 60% for half an hour, crossfade to
+//  brown noise, drop 6 dB at 2 am, stop at 6:30". A timeline is a set of
+//  sparse breakpoint lanes, one per channel volume, the master volume, the
+//  EQ preset and each effect's wet share, plus an optional end at which
+//  every voice stops. The Mixer plays it on the render thread, starting
+//  each step or ramp on the sample its breakpoint falls on, so nothing on
+//  the control side has to wake up during the night.
+//
+//  Times are whole milliseconds from the start of the timeline: finer than
+//  any automation needs, and exact in the serialized form. That form is
+//  small enough to keep beside a saved mix (little-endian):
+//
+//      "SLPA", version                                      5 bytes
+//      end (0 for none), preset count                       varints
+//      presets      kBandCount gains (dB)                   f32 each
+//      lane count                                           varint
+//      lanes        target, channel, point count            u8, varints
+//      points       time since the previous point, shape,   varint, u8,
+//                   value (a preset index for the EQ lane)  f32 or varint
+//      CRC-32 of everything before it                       4 bytes
+//
+
+#pragma once
+
+#include "sleepster/Equalizer.hpp"
+#include "sleepster/GainRamp.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sleepster {
+
+namespace automation {
+
+constexpr char kMagic[4] = {'S', 'L', 'P', 'A'};
+constexpr uint8_t kVersion = 1;
+
+} // namespace automation
+
+enum class AutomationTarget : uint8_t {
+    /// A voice's gain, on top of its own volume; the lane's channel picks it.
+    ChannelVolume = 0,
+    /// The master gain, on top of the master volume.
+    MasterVolume = 1,
+    /// Index into the timeline's EQ presets; the master EQ glides to it.
+    EqualizerPreset = 2,
+    /// Wet share, 0...1, of an enabled delay or reverb.
+    DelayMix = 3,
+    ReverbMix = 4,
+};
+
+constexpr std::size_t kAutomationTargetCount = 5;
+
+/// How a lane arrives at a breakpoint's value.
+enum class BreakpointShape : uint8_t {
+    /// Jumps on the breakpoint's sample. The EQ lane always steps (and
+    /// glides as the EQ does); gain steps click, so give them a short ramp.
+    Step = 0,
+    /// Ramps from the previous breakpoint (or the start) to this one.
+    /// Wet shares ramp linearly whatever the curve.
+    Linear = 1,
+    EqualPower = 2,
+    Exponential = 3,
+};
+
+struct Breakpoint {
+    uint64_t timeMs;
+    /// Gain (linear, 0...4), wet share or preset index.
+    float value;
+    BreakpointShape shape;
+};
+
+struct AutomationLane {
+    AutomationTarget target;
+    /// ChannelVolume only.
+    uint32_t channel = 0;
+    /// In time order; breakpoints at the same time apply in this order.
+    std::vector<Breakpoint> points;
+};
+
+struct AutomationTimeline {
+    std::vector<AutomationLane> lanes;
+    std::vector<std::array<float, Equalizer::kBandCount>> equalizerPresets;
+    /// Every voice stops here and the mixer reports AutomationFinished;
+    /// 0 leaves the last values in place.
+    uint64_t endMs = 0;
+
+    bool empty() const noexcept { return lanes.empty() && endMs == 0; }
+    /// The lane for `target` (and `channel`), added if there is none.
+    AutomationLane& lane(AutomationTarget target, uint32_t channel = 0);
+};
+
+/// One step or ramp start, on its sample.
+struct AutomationAction {
+    uint64_t frame;
+    AutomationTarget target;
+    RampCurve curve;
+    /// Channel, or preset for the EQ lane.
+    uint32_t index;
+    float value;
+    /// Ramp length from `frame`; 0 jumps.
+    uint64_t frames;
+};
+
+struct AutomationSchedule {
+    /// In frame order; actions on the same frame keep lane order.
+    std::vector<AutomationAction> actions;
+    /// UINT64_MAX without an end.
+    uint64_t endFrame = UINT64_MAX;
+};
+
+constexpr uint64_t automationFrame(uint64_t timeMs, double sampleRate) noexcept {
+    return static_cast<uint64_t>(static_cast<double>(timeMs) * sampleRate / 1000.0 + 0.5);
+}
+
+/// The timeline at `sampleRate`. Values are clamped to their target's
+/// range, and EQ breakpoints naming a missing preset are dropped.
+AutomationSchedule scheduleAutomation(const AutomationTimeline& timeline, double sampleRate);
+
+/// Appends the serialized timeline to `out`.
+void encodeAutomation(const AutomationTimeline& timeline, std::vector<uint8_t>& out);
+/// False, leaving `out` empty, for anything but a whole, valid encoding.
+bool decodeAutomation(const uint8_t* data, std::size_t length, AutomationTimeline& out);
+
+} // namespace sleepster
@@ -0,0 +1,44 @@
+//
+//  Biquad.hpp
+//  SleepsterCore
+//
+//  Second-order filter sections (RBJ cookbook designs) in transposed direct
+//  form II, the building block of the equalizer.
+//
+
+#pragma once
+
+namespace sleepster {
+
+/// Normalised coefficients (a0 == 1).
+struct BiquadCoefficients {
+    float b0 = 1.0f;
+    float b1 = 0.0f;
+    float b2 = 0.0f;
+    float a1 = 0.0f;
+    float a2 = 0.0f;
+
+    /// Passes the signal through unchanged.
+    static constexpr BiquadCoefficients identity() noexcept { return {}; }
+
+    /// Peaking bell at `frequency` Hz, `gainDb` high, `bandwidthOctaves` wide
+    /// (the parameterisation AVAudioUnitEQ uses). Frequencies are clamped
+    /// below Nyquist.
+    static BiquadCoefficients peaking(double sampleRate, double frequency, double gainDb,
+                                      double bandwidthOctaves) noexcept;
+};
+
+struct BiquadState {
+    float z1 = 0.0f;
+    float z2 = 0.0f;
+};
+
+/// One sample through one section.
+inline float processBiquad(const BiquadCoefficients& c, BiquadState& s, float x) noexcept {
+    const float y = c.b0 * x + s.z1;
+    s.z1 = c.b1 * x - c.a1 * y + s.z2;
+    s.z2 = c.b2 * x - c.a2 * y;
+    return y;
+}
+
+} // namespace sleepster
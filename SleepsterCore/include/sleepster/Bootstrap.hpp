@@ -0,0 +1,123 @@
+//
+//  Bootstrap.hpp
+//  SleepsterCore
+//
+//  Starts the app's services in dependency order instead of whatever order
+//  their first use happens to trigger. Each service names the services it
+//  needs and the phase it belongs to: critical (before the first frame),
+//  first frame (just after it) or idle. Running a phase starts every
+//  service of that phase and earlier that has not started yet, each as
+//  soon as its dependencies have, with independent ones in parallel on a
+//  WorkStealingPool. Services tied to the calling thread, such as
+//  main-actor ones, run on it while it waits. A service that fails skips
+//  everything depending on it. Every start is timed, and recorded as a
+//  trace span when tracing is on.
+//
+
+#pragma once
+
+#include "sleepster/WorkStealingPool.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sleepster {
+
+enum class BootPhase : uint8_t {
+    Critical = 0,
+    FirstFrame = 1,
+    Idle = 2,
+};
+
+enum class BootAffinity : uint8_t {
+    /// Any pool worker.
+    Pool = 0,
+    /// The thread calling Bootstrap::run.
+    Caller = 1,
+};
+
+enum class BootStatus : uint8_t {
+    Pending = 0,
+    Succeeded = 1,
+    Failed = 2,
+    /// Not started because a dependency failed or was skipped.
+    Skipped = 3,
+};
+
+struct BootService {
+    std::string name;
+    BootPhase phase = BootPhase::Critical;
+    BootAffinity affinity = BootAffinity::Pool;
+    /// Names of services that must have started first, in this phase or
+    /// an earlier one.
+    std::vector<std::string> dependencies;
+    /// False if the service could not start.
+    std::function<bool()> start;
+};
+
+struct BootTiming {
+    /// Valid as long as the Bootstrap.
+    const char* name = nullptr;
+    BootPhase phase = BootPhase::Critical;
+    BootStatus status = BootStatus::Pending;
+    /// Pool worker index, or -1 for the calling thread.
+    int thread = -1;
+    // Seconds since the Bootstrap was created: when the last dependency
+    // finished, and when the start began and ended. All three are equal
+    // for skipped services.
+    double ready = 0.0;
+    double begin = 0.0;
+    double end = 0.0;
+};
+
+class Bootstrap {
+public:
+    Bootstrap();
+    ~Bootstrap();
+
+    Bootstrap(const Bootstrap&) = delete;
+    Bootstrap& operator=(const Bootstrap&) = delete;
+
+    /// False if the name is already taken or `start` is empty.
+    bool add(BootService service);
+
+    /// Every dependency must exist and belong to the same phase or an
+    /// earlier one, and there may be no cycles. Otherwise false, with
+    /// what is wrong in `error`.
+    bool validate(std::string& error) const;
+
+    /// Starts every pending service up to and including `phase` and
+    /// returns once all have finished. Not reentrant. False if one failed
+    /// or was skipped, or validation failed, in which case nothing starts.
+    bool run(BootPhase phase, WorkStealingPool& pool);
+
+    /// Why the last run failed validation; empty if it did not.
+    const std::string& error() const noexcept { return error_; }
+
+    BootStatus status(const std::string& name) const;
+    /// Every service that has finished, in the order it did.
+    std::vector<BootTiming> timings() const;
+
+private:
+    struct Entry;
+    struct Run;
+
+    void execute(Run& run, std::size_t index);
+    /// Marks `index` and everything depending on it in this run as
+    /// skipped. Called with the run's lock held.
+    void skip(Run& run, std::size_t index, double now);
+    double secondsSince(uint64_t nanoseconds) const noexcept;
+
+    /// Entries never move, so their names stay valid for trace spans.
+    std::vector<std::unique_ptr<Entry>> entries_;
+    std::unordered_map<std::string, std::size_t> byName_;
+    std::vector<std::size_t> finished_;
+    std::string error_;
+    const uint64_t epoch_;
+};
+
+} // namespace sleepster
@@ -0,0 +1,63 @@
+//
+//  BrightnessRamp.hpp
+//  SleepsterCore
+//
+//  Step plans for long screen-brightness ramps, such as dimming over the
+//  first half hour of sleep. Screen brightness cannot be animated, only
+//  set, so a ramp is a list of timed updates. The planner moves evenly in
+//  CIE lightness (L*) rather than in brightness: the panel's luminance
+//  follows brightness^gamma, and equal L* steps look equal whether the
+//  screen is bright or nearly dark. Each update is the smallest change
+//  worth seeing, so a ramp issues only as many updates as the change in
+//  lightness calls for and never more than one per minimum interval.
+//
+//  Planning is a pure function of its arguments; the caller owns the clock
+//  and the timer that issues the updates.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace sleepster {
+
+struct BrightnessRampConfig {
+    /// Luminance = brightness^gamma.
+    double gamma = 2.2;
+    /// Smallest change worth issuing, in L* (0...100); one L* is about a
+    /// just-noticeable difference.
+    double lightnessStep = 1.0;
+    /// Closest two updates may be, in seconds. Short ramps take fewer,
+    /// larger steps instead.
+    double minimumInterval = 0.1;
+};
+
+struct BrightnessStep {
+    /// Seconds from the start of the ramp.
+    double time;
+    /// 0...1, as UIScreen takes it.
+    double brightness;
+};
+
+/// L* of the screen at `brightness`, 0...100.
+double brightnessToLightness(double brightness, double gamma) noexcept;
+double lightnessToBrightness(double lightness, double gamma) noexcept;
+
+/// Plans a ramp from `from` to `to` (both clamped to 0...1) over `duration`
+/// seconds. Steps are even in L*; each is issued once the ramp has reached
+/// it, so the last lands on `to` exactly at `duration`. A ramp with
+/// nothing to change has no steps, and one with no duration has a single
+/// step at 0. Writes at most `capacity` steps to `out` and returns how
+/// many the ramp needs, so a null `out` just counts them.
+std::size_t planBrightnessRamp(double from, double to, double duration, const BrightnessRampConfig& config,
+                               BrightnessStep* out, std::size_t capacity) noexcept;
+
+std::vector<BrightnessStep> planBrightnessRamp(double from, double to, double duration,
+                                               const BrightnessRampConfig& config = {});
+
+/// How many of the steps are due `elapsed` seconds into the ramp; a
+/// resumed ramp applies step `due - 1` and continues from step `due`.
+std::size_t brightnessStepsDue(const BrightnessStep* steps, std::size_t count, double elapsed) noexcept;
+
+} // namespace sleepster
@@ -0,0 +1,182 @@
+//
+//  Catalog.hpp
+//  SleepsterCore
+//
+//  In-memory index of the Sound and Background records the app keeps in
+//  Core Data, so that finding a sound by title, a background by animation
+//  type, or whatever is selected, favorite or in the mix costs a hash probe
+//  or a bitset scan instead of a store fetch. Strings live in one pool and
+//  each record is a few fixed-size fields; a flag is one bit per record.
+//
+//  The index is a cache in front of the store, not a replacement for it.
+//  Changes made through the catalog mark their records unsynced until the
+//  owner writes them to the store and takes them with takeChanges(); rows
+//  the store changed itself are applied with the `fromStore` variants,
+//  which mark nothing. Ids are row numbers and stay put while the catalog
+//  lives; a removed row keeps its id, and its fields, until its removal
+//  has been taken.
+//
+//  A snapshot holds until the catalog changes: the first change after a
+//  save or load removes the file it went to or came from, so a launch
+//  after a crash never loads flags older than the ones last set.
+//
+//  Snapshot layout (little-endian), read back in one read:
+//
+//      header  "SLPC", version, revision, sound rows, background rows,
+//              string bytes, CRC-32 of everything after the header   32 bytes
+//      sounds       title, url 1, url 2, flags                      16 bytes
+//      backgrounds  animation type, color theme, intensity, speed,
+//                   flags                                           20 bytes
+//      strings      NUL-terminated, addressed by offset; 0xFFFFFFFF is nil
+//
+//  Not thread-safe: the app keeps it on the main actor, beside the view
+//  context.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sleepster {
+
+namespace catalog {
+
+constexpr char kMagic[4] = {'S', 'L', 'P', 'C'};
+constexpr uint32_t kVersion = 1;
+constexpr std::size_t kHeaderSize = 32;
+constexpr std::size_t kSoundRowSize = 16;
+constexpr std::size_t kBackgroundRowSize = 20;
+
+} // namespace catalog
+
+enum class CatalogKind : uint8_t {
+    Sound = 0,
+    Background = 1,
+};
+
+enum class CatalogFlag : uint8_t {
+    Favorite = 0,
+    Selected = 1,
+    /// Sounds only.
+    SelectedForMixing = 2,
+};
+
+struct CatalogSound {
+    /// The key; unique among live sounds.
+    std::string title;
+    bool hasUrl1 = false;
+    std::string url1;
+    bool hasUrl2 = false;
+    std::string url2;
+    bool favorite = false;
+    bool selected = false;
+    bool selectedForMixing = false;
+};
+
+struct CatalogBackground {
+    /// The key; unique among live backgrounds.
+    std::string animationType;
+    bool hasColorTheme = false;
+    std::string colorTheme;
+    int32_t intensityLevel = 2;
+    float speedMultiplier = 1.0f;
+    bool favorite = false;
+    bool selected = false;
+};
+
+class Catalog {
+public:
+    static constexpr uint32_t kNotFound = 0xFFFFFFFFu;
+
+    Catalog();
+    ~Catalog();
+
+    Catalog(const Catalog&) = delete;
+    Catalog& operator=(const Catalog&) = delete;
+
+    /// Reads a snapshot. Returns nullptr when the file is missing, from
+    /// another version or damaged, so the owner rebuilds from the store.
+    /// The loaded catalog removes the file on its first change.
+    static std::unique_ptr<Catalog> load(const std::string& path);
+    /// Writes a snapshot beside `path` and renames it into place, leaving
+    /// out removed rows whose removal has been taken; ids of the rows kept
+    /// are renumbered in order on the next load. The next change, from the
+    /// store or not, removes the file again.
+    bool save(const std::string& path) const;
+
+    // MARK: - Records
+
+    /// False if the title is taken, with the live row holding it in `id`.
+    bool addSound(const CatalogSound& sound, uint32_t& id, bool fromStore = false);
+    bool addBackground(const CatalogBackground& background, uint32_t& id, bool fromStore = false);
+    /// Replaces every field, key included. False if `id` is not live or
+    /// the new key belongs to another row.
+    bool updateSound(uint32_t id, const CatalogSound& sound, bool fromStore = false);
+    bool updateBackground(uint32_t id, const CatalogBackground& background, bool fromStore = false);
+    bool remove(CatalogKind kind, uint32_t id, bool fromStore = false);
+
+    /// False if `id` was never a row; removed rows keep their last fields.
+    bool sound(uint32_t id, CatalogSound& out) const;
+    bool background(uint32_t id, CatalogBackground& out) const;
+    /// The row's key; nullptr as for sound(). Valid until the next change.
+    const char* key(CatalogKind kind, uint32_t id) const noexcept;
+
+    /// The live row with this title or animation type, or kNotFound.
+    uint32_t find(CatalogKind kind, const std::string& key) const noexcept;
+    bool isLive(CatalogKind kind, uint32_t id) const noexcept;
+    /// Live rows.
+    std::size_t size(CatalogKind kind) const noexcept;
+    /// Row ids handed out so far, live or not.
+    std::size_t rowCount(CatalogKind kind) const noexcept;
+
+    // MARK: - Flags
+
+    /// False if `id` is not live or the flag does not apply to `kind`.
+    bool setFlag(CatalogKind kind, uint32_t id, CatalogFlag flag, bool value, bool fromStore = false);
+    bool flag(CatalogKind kind, uint32_t id, CatalogFlag flag) const noexcept;
+    /// Selects `id` and clears every other selection of its kind.
+    bool select(CatalogKind kind, uint32_t id);
+    /// The lowest live row with the flag, or kNotFound.
+    uint32_t firstWith(CatalogKind kind, CatalogFlag flag) const noexcept;
+    /// Every live row with the flag, in id order.
+    std::vector<uint32_t> allWith(CatalogKind kind, CatalogFlag flag) const;
+    std::size_t countWith(CatalogKind kind, CatalogFlag flag) const noexcept;
+
+    // MARK: - Write-back
+
+    /// Rows changed through the catalog since they were last taken, in id
+    /// order, and forgets them. Read each with sound() or background() and
+    /// isLive() to see whether to write or delete it.
+    std::vector<uint32_t> takeChanges(CatalogKind kind);
+    std::size_t pendingChanges(CatalogKind kind) const noexcept;
+    /// Bumped by every change, from the store or not, so the owner can
+    /// tell whether its last snapshot is stale.
+    uint64_t revision() const noexcept { return revision_; }
+
+private:
+    struct Rows;
+
+    Rows& rows(CatalogKind kind) noexcept;
+    const Rows& rows(CatalogKind kind) const noexcept;
+    uint32_t intern(const std::string& value);
+    /// Points `offset` at `value`, or nil, interning it only if it changed.
+    void assign(uint32_t& offset, bool present, const std::string& value);
+    const char* string(uint32_t offset) const noexcept;
+    bool setKey(Rows& rows, uint32_t id, const std::string& key);
+    void touch(Rows& rows, uint32_t id, bool fromStore);
+
+    /// NUL-terminated strings; rows address them by offset.
+    std::string strings_;
+    std::unique_ptr<Rows> sounds_;
+    std::unique_ptr<Rows> backgrounds_;
+    uint64_t revision_ = 0;
+    /// The snapshot that matches the rows as they are, removed on the next
+    /// change; empty once removed.
+    mutable std::string snapshot_;
+};
+
+} // namespace sleepster
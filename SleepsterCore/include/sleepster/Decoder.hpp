@@ -0,0 +1,64 @@
+//
+//  Decoder.hpp
+//  SleepsterCore
+//
+//  Pull-style decoder interface used by streaming sources. Decoders run on
+//  the background decode thread, never on the render thread, so they may
+//  block on I/O. Output is always planar stereo float; mono inputs are
+//  duplicated to both channels.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace sleepster {
+
+class Decoder {
+public:
+    virtual ~Decoder() = default;
+
+    virtual double sampleRate() const noexcept = 0;
+
+    /// Total length in frames, or 0 when unknown.
+    virtual uint64_t frameCount() const noexcept = 0;
+
+    /// Decodes up to `frames` frames. Returns 0 only at end of stream.
+    virtual std::size_t decode(float* left, float* right, std::size_t frames) = 0;
+
+    /// Repositions to `frame`. Returns false if the decoder cannot seek.
+    virtual bool seek(uint64_t frame) = 0;
+};
+
+/// Converts another decoder's output to `targetRate` with linear
+/// interpolation. Used when an asset's rate differs from the mixer's.
+class ResamplingDecoder final : public Decoder {
+public:
+    ResamplingDecoder(std::unique_ptr<Decoder> inner, double targetRate);
+
+    double sampleRate() const noexcept override { return targetRate_; }
+    uint64_t frameCount() const noexcept override;
+    std::size_t decode(float* left, float* right, std::size_t frames) override;
+    bool seek(uint64_t frame) override;
+
+private:
+    bool refill();
+
+    std::unique_ptr<Decoder> inner_;
+    const double targetRate_;
+    const double step_;
+
+    static constexpr std::size_t kChunk = 1024;
+    // Two frames of history precede the freshly decoded chunk so the
+    // interpolator can always look one frame back.
+    std::vector<float> left_;
+    std::vector<float> right_;
+    std::size_t available_ = 0;
+    double position_ = 0.0;
+    bool ended_ = false;
+};
+
+} // namespace sleepster
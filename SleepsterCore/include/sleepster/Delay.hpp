@@ -0,0 +1,110 @@
+//
+//  Delay.hpp
+//  SleepsterCore
+//
+//  Stereo feedback delay for the master bus. The read tap sits at a
+//  fractional position with Hermite interpolation, so a new delay time is
+//  reached by gliding the tap (a brief pitch bend, as on a tape delay)
+//  rather than by jumping and clicking. Disabled, the effect costs one
+//  atomic load per block; enabled, it stops running once its echoes have
+//  died away after the input went silent.
+//
+
+#pragma once
+
+#include "sleepster/DelayLine.hpp"
+#include "sleepster/EffectStage.hpp"
+#include "sleepster/TripleBuffer.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace sleepster {
+
+class StereoDelay {
+public:
+    /// Longest delay time, as AVAudioUnitDelay.
+    static constexpr double kMaxSeconds = 2.0;
+    /// Time constant with which the tap and feedback follow a new setting.
+    static constexpr double kGlideSeconds = 0.05;
+    /// Fastest the tap moves, in samples per sample: large changes bend the
+    /// pitch by at most this fraction instead of racing through the line.
+    static constexpr float kMaxGlideRate = 0.5f;
+    /// Feedback is kept below unity so the echoes always die away.
+    static constexpr float kMaxFeedback = 0.98f;
+
+    StereoDelay(double sampleRate, std::size_t maxBlockFrames);
+
+    StereoDelay(const StereoDelay&) = delete;
+    StereoDelay& operator=(const StereoDelay&) = delete;
+
+    // MARK: - Control thread
+
+    /// Enabling starts from an empty line; disabling fades the wet signal
+    /// out and then bypasses the effect.
+    void setEnabled(bool enabled);
+    void setTime(double seconds);
+    /// Fraction of the output fed back, -kMaxFeedback...kMaxFeedback.
+    void setFeedback(float feedback);
+    /// Wet share of the output, 0...1.
+    void setMix(float wet);
+
+    bool isEnabled() const noexcept { return settings_.enabled; }
+
+    // MARK: - Render thread
+
+    void process(float* left, float* right, std::size_t frames) noexcept;
+
+    /// Drives the wet share from an automation timeline: ramps to `wet` over
+    /// `frames` frames, `elapsed` of which have already gone by. While it
+    /// does, mix changes from the control thread wait for restoreMix().
+    void automateMix(float wet, uint64_t frames, uint64_t elapsed) noexcept;
+    /// Returns to the control thread's wet share.
+    void restoreMix() noexcept;
+
+    /// True while the effect does work on each block (enabled and not asleep).
+    bool isRunning() const noexcept { return !bypassed_ && !tail_.isAsleep(); }
+
+private:
+    struct Settings {
+        bool enabled = false;
+        double seconds = 0.1;
+        float feedback = 0.2f;
+        float wet = 0.2f;
+    };
+
+    void publish();
+    void apply(const Settings& settings) noexcept;
+    float mixTarget() const noexcept { return automatedWet_ < 0.0f ? wet_ : automatedWet_; }
+    void renderWet(const float* left, const float* right, std::size_t frames) noexcept;
+    void renderGliding(const float* left, const float* right, std::size_t frames) noexcept;
+
+    const double sampleRate_;
+    const std::size_t maxBlockFrames_;
+    const uint64_t declickFrames_;
+    const float glideCoefficient_;
+
+    // Control-thread state.
+    Settings settings_;
+    TripleBuffer<Settings> snapshots_;
+
+    // Render-thread state.
+    DelayLine lineLeft_;
+    DelayLine lineRight_;
+    float delay_ = 0.0f;
+    float targetDelay_ = 0.0f;
+    float feedback_ = 0.0f;
+    float targetFeedback_ = 0.0f;
+    float wet_ = 0.0f;
+    /// Negative unless a timeline drives the mix.
+    float automatedWet_ = -1.0f;
+    bool enabled_ = false;
+    bool bypassed_ = true;
+    WetDryMix mix_;
+    TailTracker tail_;
+    std::vector<float> wetLeft_;
+    std::vector<float> wetRight_;
+    std::vector<float> segment_;
+};
+
+} // namespace sleepster
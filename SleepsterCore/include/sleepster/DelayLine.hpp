@@ -0,0 +1,70 @@
+//
+//  DelayLine.hpp
+//  SleepsterCore
+//
+//  Power-of-two ring buffer shared by the delay and reverb effects. Reads
+//  address samples by how many writes ago they happened, so a delay of D
+//  samples is read(D) taken just before the current input is written.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace sleepster {
+
+/// Weights of the four-point Hermite (Catmull-Rom) interpolator at
+/// fractional position `f` between the two middle taps.
+struct HermiteWeights {
+    float w0, w1, w2, w3;
+
+    static HermiteWeights at(float f) noexcept {
+        const float f2 = f * f;
+        const float f3 = f2 * f;
+        return {-0.5f * f + f2 - 0.5f * f3,
+                1.0f - 2.5f * f2 + 1.5f * f3,
+                0.5f * f + 2.0f * f2 - 1.5f * f3,
+                -0.5f * f2 + 0.5f * f3};
+    }
+};
+
+class DelayLine {
+public:
+    DelayLine() = default;
+
+    /// Allocates room for at least `history` past samples.
+    explicit DelayLine(std::size_t history);
+
+    void clear() noexcept;
+
+    void write(float x) noexcept {
+        buffer_[writeIndex_] = x;
+        writeIndex_ = (writeIndex_ + 1) & mask_;
+    }
+
+    /// The sample written `delay` writes ago; 1 is the most recent.
+    float read(std::size_t delay) const noexcept { return buffer_[(writeIndex_ - delay) & mask_]; }
+
+    /// Hermite-interpolated read between whole-sample taps. `delay` must be
+    /// at least 2 so every tap has already been written.
+    float readFractional(float delay) const noexcept {
+        const std::size_t whole = static_cast<std::size_t>(delay);
+        const HermiteWeights w = HermiteWeights::at(delay - static_cast<float>(whole));
+        return w.w0 * read(whole - 1) + w.w1 * read(whole) + w.w2 * read(whole + 1) + w.w3 * read(whole + 2);
+    }
+
+    /// Copies `count` consecutive samples, oldest first, starting with the
+    /// one written `oldestDelay` writes ago. Requires oldestDelay >= count.
+    void readBlock(std::size_t oldestDelay, float* out, std::size_t count) const noexcept;
+
+    /// Writes `count` samples in order.
+    void writeBlock(const float* in, std::size_t count) noexcept;
+
+private:
+    std::vector<float> buffer_;
+    std::size_t mask_ = 0;
+    std::size_t writeIndex_ = 0;
+};
+
+} // namespace sleepster
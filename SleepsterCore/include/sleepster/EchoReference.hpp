@@ -0,0 +1,63 @@
+//
+//  EchoReference.hpp
+//  SleepsterCore
+//
+//  The last second or so of what the app played, kept so the microphone
+//  side can tell its own output from the room. The render thread writes
+//  each block, downmixed to mono, at its position on a shared sample clock;
+//  the microphone thread reads the span that was playing when a buffer was
+//  captured. Both ends are wait-free: a read that the writer overtook
+//  reports failure instead of returning torn samples.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace sleepster {
+
+class EchoReference {
+public:
+    /// Holds at least `minimumFrames` samples, rounded up to a power of two.
+    explicit EchoReference(std::size_t minimumFrames);
+
+    EchoReference(const EchoReference&) = delete;
+    EchoReference& operator=(const EchoReference&) = delete;
+
+    /// Render thread. Stores `frames` samples starting at `position`. A
+    /// jump forward leaves silence in the gap. A step back to samples still
+    /// held, as timestamp jitter makes, overwrites them in place; a jump
+    /// further back restarts the history.
+    void write(const float* left, const float* right, std::size_t frames, int64_t position) noexcept;
+
+    /// Any one other thread. Copies samples `position` onward; false when
+    /// some of them have not been written yet or were already overwritten.
+    bool read(float* out, std::size_t frames, int64_t position) const noexcept;
+
+    std::size_t capacity() const noexcept { return capacity_; }
+    /// One past the last position written; 0 before the first write.
+    int64_t end() const noexcept { return end_.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<float>& at(int64_t position) const noexcept {
+        return samples_[static_cast<std::size_t>(position) & mask_];
+    }
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<std::atomic<float>[]> samples_;
+    /// First position of the current history; moves when it restarts.
+    std::atomic<int64_t> begin_{0};
+    /// Raised before samples are overwritten and `end_` after, so a reader
+    /// can tell whether the writer reached its span while it copied.
+    std::atomic<int64_t> claimed_{0};
+    std::atomic<int64_t> end_{0};
+    /// Odd while the writer overwrites samples it wrote before.
+    std::atomic<uint64_t> rewrites_{0};
+    bool written_ = false;
+};
+
+} // namespace sleepster
@@ -0,0 +1,78 @@
+//
+//  EffectStage.hpp
+//  SleepsterCore
+//
+//  Plumbing shared by the master-bus effects: the declicked wet/dry blend,
+//  and the tail tracker that lets an effect stop running once its output
+//  has died away after the input went silent.
+//
+
+#pragma once
+
+#include "sleepster/GainRamp.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sleepster {
+
+/// out = dry * in + wet * effect, with both gains ramped on every change.
+class WetDryMix {
+public:
+    /// Fully dry: what a bypassed effect sounds like.
+    WetDryMix() noexcept : dry_(1.0f), wet_(0.0f) {}
+
+    /// Moves to `wet` (0...1, dry = 1 - wet) over `frames` frames.
+    void rampTo(float wet, uint64_t frames) noexcept;
+
+    /// Jumps to the current targets.
+    void settle() noexcept;
+
+    /// Moves `frames` frames further through a ramp without blending them.
+    void advance(uint64_t frames) noexcept {
+        dry_.advance(frames);
+        wet_.advance(frames);
+    }
+
+    bool isRamping() const noexcept { return dry_.isRamping() || wet_.isRamping(); }
+    /// True once the blend has come to rest fully dry.
+    bool isDry() const noexcept { return !isRamping() && wet_.current() == 0.0f && dry_.current() == 1.0f; }
+
+    /// Blends `wetLeft`/`wetRight` into `left`/`right` in place.
+    void apply(float* left, float* right, const float* wetLeft, const float* wetRight,
+               std::size_t frames) noexcept;
+
+private:
+    GainRamp dry_;
+    GainRamp wet_;
+};
+
+/// Counts silent input and reports when the effect's tail has run out.
+class TailTracker {
+public:
+    /// Peak level below which input counts as silence (-100 dBFS).
+    static constexpr float kSilence = 1e-5f;
+
+    /// How long output keeps sounding after the input stops.
+    void setTailFrames(uint64_t frames) noexcept { tailFrames_ = frames; }
+
+    /// Call once per block before processing it. Returns false when the
+    /// block is silent and every earlier sound has decayed, so the effect
+    /// can skip it.
+    bool shouldRun(const float* left, const float* right, std::size_t frames) noexcept;
+
+    /// Starts counting afresh, as for an effect that has just been cleared.
+    void reset() noexcept {
+        silentFrames_ = 0;
+        asleep_ = false;
+    }
+
+    bool isAsleep() const noexcept { return asleep_; }
+
+private:
+    uint64_t tailFrames_ = 0;
+    uint64_t silentFrames_ = 0;
+    bool asleep_ = false;
+};
+
+} // namespace sleepster
@@ -0,0 +1,131 @@
+//
+//  Equalizer.hpp
+//  SleepsterCore
+//
+//  Ten-band stereo graphic EQ for the master bus. The bands run as a biquad
+//  cascade vectorized across channels and adjacent bands; a whole curve is
+//  designed in one batch on the control thread and handed to the render
+//  thread as a single snapshot, where the coefficients glide to their new
+//  values instead of stepping.
+//
+
+#pragma once
+
+#include "sleepster/Biquad.hpp"
+#include "sleepster/TripleBuffer.hpp"
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace sleepster {
+
+class Equalizer {
+public:
+    static constexpr std::size_t kBandCount = 10;
+    /// Centre frequencies of the bands, in Hz.
+    static constexpr std::array<float, kBandCount> kFrequencies = {
+        32, 63, 125, 250, 500, 1000, 2000, 4000, 8000, 16000,
+    };
+    /// Coefficients move to a new curve over this long.
+    static constexpr double kGlideSeconds = 0.02;
+    /// Coefficients are held constant across this many frames while gliding.
+    static constexpr std::size_t kGlideStepFrames = 32;
+
+    /// A whole designed response, ready for the render thread.
+    struct Curve {
+        std::array<BiquadCoefficients, kBandCount> bands{};
+        bool flat = true;
+    };
+
+    Equalizer(double sampleRate, std::size_t maxBlockFrames);
+
+    Equalizer(const Equalizer&) = delete;
+    Equalizer& operator=(const Equalizer&) = delete;
+
+    // MARK: - Control thread
+
+    /// Sets every band gain (dB) at once. Bands beyond `count` are flat.
+    void setGains(const float* gainsDb, std::size_t count);
+
+    /// Width of every band in octaves (default 1, as AVAudioUnitEQ).
+    void setBandwidth(float octaves);
+
+    /// Disabling glides to a flat response and then stops processing.
+    void setEnabled(bool enabled);
+
+    bool isEnabled() const noexcept { return enabled_; }
+
+    /// Designs band gains (dB) at the current bandwidth without applying
+    /// them, for glideTo(). Bands beyond `count` are flat.
+    Curve design(const float* gainsDb, std::size_t count) const;
+
+    // MARK: - Render thread
+
+    /// Glides to a curve designed ahead of time, whether or not the EQ is
+    /// enabled. Control-thread changes wait until restore().
+    void glideTo(const Curve& curve) noexcept;
+
+    /// Glides back to the control thread's curve.
+    void restore() noexcept;
+
+    /// Filters `left`/`right` in place.
+    void process(float* left, float* right, std::size_t frames) noexcept;
+
+    /// Same result as process() using plain per-sample code; kept as the
+    /// reference the vector path is tested and benchmarked against.
+    void processScalar(float* left, float* right, std::size_t frames) noexcept;
+
+    /// True while the EQ is flat and skipping its work entirely.
+    bool isIdle() const noexcept { return idle_; }
+
+private:
+    /// Bands are processed in pairs; one SIMD vector holds
+    /// {band k left, band k right, band k+1 left, band k+1 right}.
+    static constexpr std::size_t kPairs = kBandCount / 2;
+    static constexpr std::size_t kLanes = kPairs * 4;
+    static_assert(kBandCount % 2 == 0, "bands are processed in pairs");
+
+    /// Coefficients and filter state in lane order, one array per term.
+    struct Lanes {
+        alignas(16) float b0[kLanes];
+        alignas(16) float b1[kLanes];
+        alignas(16) float b2[kLanes];
+        alignas(16) float a1[kLanes];
+        alignas(16) float a2[kLanes];
+    };
+
+    void publish();
+    void beginGlide(const Curve& curve) noexcept;
+    template <bool Vectorized>
+    void processChunked(float* left, float* right, std::size_t frames) noexcept;
+    void runVector(float* left, float* right, std::size_t frames) noexcept;
+    void runScalar(float* left, float* right, std::size_t frames) noexcept;
+    void advanceGlide() noexcept;
+
+    const double sampleRate_;
+    const std::size_t maxBlockFrames_;
+
+    // Control-thread state.
+    std::array<float, kBandCount> gains_{};
+    float bandwidth_ = 1.0f;
+    bool enabled_ = true;
+    TripleBuffer<Curve> snapshots_;
+
+    // Render-thread state.
+    Lanes current_{};
+    Lanes target_{};
+    Lanes step_{};
+    alignas(16) float z1_[kLanes] = {};
+    alignas(16) float z2_[kLanes] = {};
+    std::size_t glideSteps_ = 0;
+    std::size_t glideRemaining_ = 0;
+    std::size_t glideFramesLeftInStep_ = 0;
+    bool targetFlat_ = true;
+    bool idle_ = true;
+    /// Set between glideTo() and restore().
+    bool overridden_ = false;
+    std::vector<float> interleaved_;
+};
+
+} // namespace sleepster
@@ -0,0 +1,70 @@
+//
+//  FrameArena.hpp
+//  SleepsterCore
+//
+//  Bump allocator for scratch that lives for one animation frame. Storage
+//  is reserved up front; allocating is a pointer bump and reset() frees
+//  everything at once, so a frame never touches the heap.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace sleepster {
+
+class FrameArena {
+public:
+    /// Largest alignment handed out; enough for every SIMD type used here.
+    static constexpr std::size_t kAlignment = 16;
+
+    explicit FrameArena(std::size_t capacityBytes = 0) { reserve(capacityBytes); }
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /// Grows the storage to at least `capacityBytes` and frees everything
+    /// handed out. The only call that allocates; not for use mid-frame.
+    void reserve(std::size_t capacityBytes) {
+        if (capacityBytes > capacity_) {
+            storage_.reset(new unsigned char[capacityBytes + kAlignment]);
+            const auto address = reinterpret_cast<std::uintptr_t>(storage_.get());
+            base_ = storage_.get() + (kAlignment - address % kAlignment) % kAlignment;
+            capacity_ = capacityBytes;
+        }
+        used_ = 0;
+    }
+
+    /// Uninitialised room for `count` values, or nullptr once the arena is
+    /// exhausted. Nothing is destroyed on reset, hence the trivial types.
+    template <typename T>
+    T* allocate(std::size_t count) noexcept {
+        static_assert(std::is_trivially_destructible_v<T>, "arena memory is released without destructors");
+        static_assert(alignof(T) <= kAlignment, "over-aligned type");
+        const std::size_t offset = (used_ + alignof(T) - 1) / alignof(T) * alignof(T);
+        if (offset > capacity_ || count > (capacity_ - offset) / sizeof(T)) return nullptr;
+        used_ = offset + count * sizeof(T);
+        if (used_ > highWater_) highWater_ = used_;
+        return reinterpret_cast<T*>(base_ + offset);
+    }
+
+    /// Frees everything allocated since the last reset.
+    void reset() noexcept { used_ = 0; }
+
+    std::size_t capacity() const noexcept { return capacity_; }
+    std::size_t used() const noexcept { return used_; }
+    /// Most bytes in use at once since construction, for sizing.
+    std::size_t highWater() const noexcept { return highWater_; }
+
+private:
+    std::unique_ptr<unsigned char[]> storage_;
+    unsigned char* base_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t used_ = 0;
+    std::size_t highWater_ = 0;
+};
+
+} // namespace sleepster
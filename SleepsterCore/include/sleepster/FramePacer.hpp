@@ -0,0 +1,182 @@
+//
+//  FramePacer.hpp
+//  SleepsterCore
+//
+//  Frame pacing for the animated backgrounds. `FramePacer` keeps a rolling
+//  histogram of frame times and picks a frame rate (60, 30, 20 or 15 fps)
+//  and a quality tier from its percentiles rather than from single frames,
+//  so one hitch never flips quality. Moving down happens as soon as a
+//  window of frames is late; moving up is a probe made after a hold, and a
+//  probe that fails doubles the hold, so a device on the edge settles
+//  instead of oscillating.
+//
+//  `FixedTimestep` turns display-rate frame times into a whole number of
+//  fixed simulation steps plus an interpolation factor, so motion runs at
+//  the same speed and stays smooth whatever rate frames arrive at.
+//
+//  Nothing here reads a clock: callers pass the frame times in, which is
+//  what lets the tests replay synthetic traces.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sleepster {
+
+/// Frame times of the last `capacity` frames, binned so a percentile costs
+/// one pass over the bins and recording costs two counter updates.
+class FrameTimeHistogram {
+public:
+    /// Bins of a quarter millisecond up to 100 ms; longer frames share the
+    /// last bin.
+    static constexpr double kBinSeconds = 0.00025;
+    static constexpr std::size_t kBinCount = 401;
+
+    explicit FrameTimeHistogram(std::size_t capacity = 120);
+
+    /// Adds a frame, dropping the oldest once `capacity` frames are held.
+    void record(double seconds) noexcept;
+    void clear() noexcept;
+
+    std::size_t count() const noexcept { return count_; }
+    std::size_t capacity() const noexcept { return ring_.size(); }
+    /// Frame time at or below which `fraction` (0...1) of the window lies,
+    /// at the upper edge of its bin; 0 while empty.
+    double percentile(double fraction) const noexcept;
+
+private:
+    static std::size_t binOf(double seconds) noexcept;
+
+    std::array<uint32_t, kBinCount> bins_{};
+    std::vector<uint16_t> ring_;
+    std::size_t next_ = 0;
+    std::size_t count_ = 0;
+};
+
+/// What a background may spend on detail; views drop layers and particles
+/// as it goes down.
+enum class QualityTier : uint8_t {
+    Full,
+    Reduced,
+    Minimal,
+};
+
+/// One rung of the pacing ladder.
+struct PaceLevel {
+    double framesPerSecond;
+    QualityTier tier;
+};
+
+/// Fastest first.
+constexpr std::array<PaceLevel, 4> kPaceLevels{{
+    {60.0, QualityTier::Full},
+    {30.0, QualityTier::Full},
+    {20.0, QualityTier::Reduced},
+    {15.0, QualityTier::Minimal},
+}};
+
+struct FramePacerConfig {
+    /// Frames in the rolling window.
+    std::size_t windowFrames = 120;
+    /// Frames at a new level before it is judged.
+    std::size_t settleFrames = 30;
+    /// Percentile the decisions look at.
+    double percentile = 0.9;
+    /// A level is missed when that percentile exceeds its frame interval by
+    /// this factor.
+    double lateFactor = 1.25;
+    /// ... and healthy enough to probe upwards when it stays within this.
+    double healthyFactor = 1.05;
+    /// Time at a healthy level before probing the next faster one; doubled
+    /// by every failed probe up to maxHoldSeconds.
+    double holdSeconds = 5.0;
+    double maxHoldSeconds = 120.0;
+    /// A probe that has not been missed after this long has succeeded.
+    double probeSeconds = 3.0;
+};
+
+struct LevelChange {
+    /// Seconds of recorded frames before the change.
+    double time;
+    int from;
+    int to;
+    /// The percentile that decided it.
+    double frameTime;
+};
+
+class FramePacer {
+public:
+    explicit FramePacer(const FramePacerConfig& config = {});
+
+    /// Records the interval since the previous frame. Returns true when the
+    /// level changed.
+    bool recordFrame(double seconds) noexcept;
+
+    /// Index into kPaceLevels.
+    int level() const noexcept { return level_; }
+    double targetFramesPerSecond() const noexcept { return kPaceLevels[level_].framesPerSecond; }
+    QualityTier tier() const noexcept { return kPaceLevels[level_].tier; }
+
+    const FrameTimeHistogram& histogram() const noexcept { return histogram_; }
+    /// Percentile of the current window, in seconds.
+    double percentile(double fraction) const noexcept { return histogram_.percentile(fraction); }
+
+    uint64_t frameCount() const noexcept { return frames_; }
+    /// Frames longer than the level's interval by lateFactor.
+    uint64_t lateFrameCount() const noexcept { return lateFrames_; }
+    uint64_t levelChangeCount() const noexcept { return changes_; }
+    /// The most recent changes, oldest first; at most kChangeHistory.
+    static constexpr std::size_t kChangeHistory = 16;
+    std::size_t recentChangeCount() const noexcept;
+    const LevelChange& recentChange(std::size_t index) const noexcept;
+
+    /// Current hold before the next upward probe.
+    double holdSeconds() const noexcept { return hold_; }
+
+private:
+    void moveTo(int level, double frameTime) noexcept;
+
+    FramePacerConfig config_;
+    FrameTimeHistogram histogram_;
+    int level_ = 0;
+    double time_ = 0.0;
+    double levelSince_ = 0.0;
+    double hold_;
+    /// Time the running probe started, or < 0 when none is running.
+    double probeSince_ = -1.0;
+    std::size_t framesAtLevel_ = 0;
+    uint64_t frames_ = 0;
+    uint64_t lateFrames_ = 0;
+    uint64_t changes_ = 0;
+    std::array<LevelChange, kChangeHistory> history_{};
+};
+
+/// Fixed-step clock: accumulates frame times and hands out whole steps.
+class FixedTimestep {
+public:
+    explicit FixedTimestep(double step = 1.0 / 60.0, int maxSteps = 8) noexcept
+        : step_(step), maxSteps_(maxSteps) {}
+
+    /// Adds a frame's time and returns how many steps to simulate. Time
+    /// beyond maxSteps is dropped, so a long stall slows motion down for a
+    /// frame instead of fast-forwarding it.
+    int advance(double seconds) noexcept;
+
+    /// How far the leftover time is into the next step, 0...1: draw
+    /// previous + (current - previous) * alpha.
+    double alpha() const noexcept { return accumulated_ / step_; }
+    double step() const noexcept { return step_; }
+    int maxSteps() const noexcept { return maxSteps_; }
+    void reset() noexcept { accumulated_ = 0.0; }
+
+private:
+    double step_;
+    int maxSteps_;
+    double accumulated_ = 0.0;
+};
+
+} // namespace sleepster
@@ -0,0 +1,132 @@
+//
+//  GainRamp.hpp
+//  SleepsterCore
+//
+//  Sample-accurate gain ramps for the render thread. Curves are stored as
+//  piecewise-linear tables built at compile time, so a ramp of any length
+//  reduces to a handful of linear spans that the SIMD ramp kernels can
+//  apply directly.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace sleepster {
+
+enum class RampCurve : uint8_t {
+    /// Gain moves in equal steps.
+    Linear,
+    /// sin/cos law: two opposing equal-power ramps keep summed power constant.
+    EqualPower,
+    /// Equal steps in dB across kExponentialRangeDb, so loudness changes evenly.
+    Exponential,
+};
+
+/// Dynamic range covered by RampCurve::Exponential before it snaps to silence.
+constexpr double kExponentialRangeDb = 60.0;
+
+namespace ramp_detail {
+
+constexpr std::size_t kSegments = 256;
+using Table = std::array<float, kSegments + 1>;
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kLn10 = 2.30258509299404568402;
+
+/// Taylor series; accurate to double precision on [0, pi/2].
+constexpr double sinSeries(double x) {
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 12; ++n) {
+        term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+        sum += term;
+    }
+    return sum;
+}
+
+/// exp(x) for moderate |x|: a short series on x/64, then squared six times.
+constexpr double expSeries(double x) {
+    const double y = x / 64.0;
+    double term = 1.0;
+    double sum = 1.0;
+    for (int n = 1; n < 16; ++n) {
+        term *= y / n;
+        sum += term;
+    }
+    for (int i = 0; i < 6; ++i) sum *= sum;
+    return sum;
+}
+
+constexpr double linearShape(double t) { return t; }
+
+constexpr double equalPowerShape(double t) { return sinSeries(t * kPi * 0.5); }
+
+constexpr double exponentialShape(double t) {
+    const double floor = expSeries(-kExponentialRangeDb / 20.0 * kLn10);
+    const double gain = expSeries(-kExponentialRangeDb / 20.0 * kLn10 * (1.0 - t));
+    return (gain - floor) / (1.0 - floor);
+}
+
+template <typename Shape>
+constexpr Table makeTable(Shape shape) {
+    Table table{};
+    for (std::size_t i = 0; i <= kSegments; ++i) {
+        table[i] = static_cast<float>(shape(static_cast<double>(i) / kSegments));
+    }
+    return table;
+}
+
+inline constexpr Table kLinear = makeTable(linearShape);
+inline constexpr Table kEqualPower = makeTable(equalPowerShape);
+inline constexpr Table kExponential = makeTable(exponentialShape);
+
+} // namespace ramp_detail
+
+/// Rising shape of `curve` at `t` in [0, 1], read from its table. Falling
+/// ramps use the mirror image, so a fade-out is the time reverse of a fade-in.
+float rampShape(RampCurve curve, double t) noexcept;
+
+/// Gain state for one voice (or the master bus). Not thread-safe; owned by
+/// the render thread.
+class GainRamp {
+public:
+    GainRamp() noexcept = default;
+    explicit GainRamp(float gain) noexcept { reset(gain); }
+
+    /// Jumps to `gain` and cancels any ramp in progress.
+    void reset(float gain) noexcept;
+
+    /// Ramps from the current gain to `target` over `frames` frames. A
+    /// zero-length ramp jumps straight to the target.
+    void start(float target, uint64_t frames, RampCurve curve) noexcept;
+
+    bool isRamping() const noexcept { return position_ < length_; }
+    float current() const noexcept { return current_; }
+    float target() const noexcept { return target_; }
+
+    /// Advances through the next stretch of at most `maxFrames` frames over
+    /// which the gain is linear, and returns its length. `gainStart` is the
+    /// gain before the span and `gainEnd` the gain on its last frame, which is
+    /// the convention kernels::mixAddRamp expects. Once the ramp has ended,
+    /// the whole of `maxFrames` comes back as one constant span.
+    std::size_t nextSpan(std::size_t maxFrames, float& gainStart, float& gainEnd) noexcept;
+
+    /// Moves `frames` frames further through the ramp without producing
+    /// them, landing on the gain nextSpan() would have reached.
+    void advance(uint64_t frames) noexcept;
+
+private:
+    float valueAt(uint64_t frame) const noexcept;
+
+    const ramp_detail::Table* table_ = &ramp_detail::kLinear;
+    float from_ = 0.0f;
+    float target_ = 0.0f;
+    float current_ = 0.0f;
+    uint64_t length_ = 0;
+    uint64_t position_ = 0;
+};
+
+} // namespace sleepster
@@ -0,0 +1,48 @@
+//
+//  MappedFile.hpp
+//  SleepsterCore
+//
+//  Read-only memory mapping of a whole file. Pages are faulted in on demand
+//  and can be dropped by the kernel under pressure, so mapping a large asset
+//  costs address space rather than resident memory.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace sleepster {
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// Maps `path`. Returns false (leaving the object empty) on failure.
+    bool open(const std::string& path);
+    void close() noexcept;
+
+    bool isOpen() const noexcept { return data_ != nullptr; }
+    const uint8_t* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+
+    /// Hints that [offset, offset + length) will be read front to back.
+    void adviseSequential(std::size_t offset, std::size_t length) const noexcept;
+
+    /// Drops resident pages fully inside [offset, offset + length). They are
+    /// faulted back in from the file if read again.
+    void release(std::size_t offset, std::size_t length) const noexcept;
+
+private:
+    const uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+} // namespace sleepster
@@ -0,0 +1,170 @@
+//
+//  MaskingController.hpp
+//  SleepsterCore
+//
+//  Keeps the mix just loud enough to mask the room. For a few hundred
+//  milliseconds every few seconds it compares the microphone with what the
+//  app was playing at the time (EchoReference) in the equalizer's octave
+//  bands. Per band, a regression of microphone power on output power over
+//  many frames separates the echo of our own output, whose frame-to-frame
+//  fluctuations the microphone repeats, from the room's noise, which they
+//  do not explain; what is left of the microphone's mean power once the
+//  echo is taken out is the room. Where the output is silent in a band, the
+//  microphone hears the room alone.
+//
+//  From the room's noise and the output level at the microphone, each
+//  window yields the smallest broadband gain that, with equalizer offsets
+//  of at most `maxEqDb`, keeps the output `marginDb` above the room in a
+//  `coverage` share of the bands. Gains move toward it in bounded steps
+//  with a deadband, and the target does not depend on the gain in force,
+//  so the loop settles instead of hunting. The equalizer's bells overlap,
+//  so offsets are solved for against their combined response rather than
+//  set band by band.
+//
+//  Nothing allocates after construction. Between windows a call only moves
+//  the clock forward.
+//
+
+#pragma once
+
+#include "sleepster/Equalizer.hpp"
+#include "sleepster/RealFft.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sleepster {
+
+struct MaskingConfig {
+    double sampleRate = 48000.0;
+    /// Each window listens this long ...
+    double analysisSeconds = 0.3;
+    /// ... once per period.
+    double periodSeconds = 4.0;
+    /// How far the output should stand above the room in a band.
+    float marginDb = 3.0f;
+    /// Share of the measured bands to keep masked.
+    float coverage = 0.75f;
+    /// Limits of the broadband gain, relative to the user's volume.
+    float minGainDb = -12.0f;
+    float maxGainDb = 9.0f;
+    /// Limit of each equalizer offset, either way.
+    float maxEqDb = 6.0f;
+    /// Largest change per window. Falls are slower than rises, so the mix
+    /// fades down unnoticed while a louder room is answered within half a
+    /// minute.
+    float riseDbPerWindow = 1.0f;
+    float fallDbPerWindow = 0.5f;
+    /// Smaller changes are left alone.
+    float deadbandDb = 1.5f;
+};
+
+struct MaskingDecision {
+    /// Broadband gain to apply on top of the user's volume.
+    float gainDb = 0.0f;
+    /// Offsets to add to the user's equalizer curve.
+    std::array<float, Equalizer::kBandCount> eqDb{};
+    /// Share of the measured bands masked once this is applied.
+    float coverage = 0.0f;
+};
+
+class MaskingController {
+public:
+    static constexpr std::size_t kBandCount = Equalizer::kBandCount;
+
+    explicit MaskingController(const MaskingConfig& config = {});
+
+    /// Feeds `count` microphone samples and the output that was playing
+    /// when they were captured, already aligned.
+    void process(const float* microphone, const float* reference, std::size_t count) noexcept;
+    /// Moves the clock on by `count` samples that were not heard.
+    void advance(std::size_t count) noexcept;
+
+    /// True while a window is open and samples are wanted.
+    bool listening() const noexcept { return phase_ < windowSamples_; }
+    /// Samples to pass before the next window opens; 0 while listening.
+    std::size_t samplesUntilWindow() const noexcept;
+
+    /// The current decision; true, once, after a window changed it.
+    bool takeDecision(MaskingDecision& out) noexcept;
+    const MaskingDecision& decision() const noexcept { return decision_; }
+
+    /// Room noise at the microphone, dB of power per band; -inf until
+    /// measured.
+    float ambientDb(std::size_t band) const noexcept;
+    /// Microphone power per unit of output power, dB; -inf until learned.
+    float couplingDb(std::size_t band) const noexcept;
+    /// Bands the microphone can measure at this sample rate.
+    bool measures(std::size_t band) const noexcept { return bands_[band].measured; }
+
+    std::size_t frameSize() const noexcept { return fft_.size(); }
+    uint64_t windows() const noexcept { return windows_; }
+    uint64_t analyzedFrames() const noexcept { return analyzedFrames_; }
+    /// Heap bytes held; fixed from construction.
+    std::size_t memoryBytes() const noexcept;
+
+private:
+    struct Band {
+        /// FFT bins summed into the band.
+        uint32_t firstBin = 0;
+        uint32_t lastBin = 0;
+        bool measured = false;
+        /// Regression of microphone power (y) on output power (x), over
+        /// deviations from each window's means so that the room changing
+        /// between windows, or our own gain steps, do not bias it. Older
+        /// windows are forgotten exponentially.
+        double frames = 0.0;
+        double sxx = 0.0;
+        double sxy = 0.0;
+        double coupling = 0.0;
+        bool coupled = false;
+        /// Smoothed room power.
+        double ambient = 0.0;
+        bool heard = false;
+        /// Smoothed output level at the user's own settings, dB.
+        float base = 0.0f;
+        bool based = false;
+    };
+
+    void analyzeFrame() noexcept;
+    void closeWindow() noexcept;
+    void decide(const std::array<float, kBandCount>& outputDb) noexcept;
+    /// Change in each band's power, dB, from equalizer offsets.
+    std::array<float, kBandCount> response(const std::array<float, kBandCount>& offsets) const noexcept;
+    /// Offsets whose response best meets `wanted` in the bands with a need.
+    std::array<float, kBandCount> offsetsFor(const std::array<float, kBandCount>& wanted,
+                                             const std::array<float, kBandCount>& need) const noexcept;
+
+    MaskingConfig config_;
+    RealFft fft_;
+    std::size_t windowSamples_;
+    std::size_t periodSamples_;
+    /// Frames a window holds.
+    std::size_t windowFrames_;
+    std::size_t phase_ = 0;
+
+    std::vector<float> hann_;
+    std::vector<float> microphone_;
+    std::vector<float> reference_;
+    std::size_t filled_ = 0;
+    std::vector<float> power_;
+    /// Band powers of the frames in the open window, frame-major.
+    std::vector<double> frameMicrophone_;
+    std::vector<double> frameReference_;
+    std::size_t frames_ = 0;
+
+    std::array<Band, kBandCount> bands_;
+    /// interaction_[b][k]: dB in band b per dB of equalizer gain in band k.
+    std::array<std::array<float, kBandCount>, kBandCount> interaction_{};
+    MaskingDecision decision_;
+    /// Running average of the gain each window calls for.
+    float target_ = 0.0f;
+    bool decided_ = false;
+    bool changed_ = false;
+    uint64_t windows_ = 0;
+    uint64_t analyzedFrames_ = 0;
+};
+
+} // namespace sleepster
@@ -0,0 +1,30 @@
+//
+//  MixKernels.hpp
+//  SleepsterCore
+//
+//  Vectorized inner loops shared by the mixer and effects. All kernels are
+//  allocation-free and safe to call from the audio render callback.
+//
+
+#pragma once
+
+#include <cstddef>
+
+namespace sleepster::kernels {
+
+/// Zero `count` samples.
+void clear(float* dst, std::size_t count) noexcept;
+
+/// dst += src * gain, where gain moves linearly from `gainStart` to
+/// `gainEnd` across the block (reaching `gainEnd` on the last sample).
+/// A constant gain takes a faster path.
+void mixAddRamp(float* dst, const float* src, float gainStart, float gainEnd,
+                std::size_t count) noexcept;
+
+/// buffer *= gain, ramped like mixAddRamp.
+void applyGainRamp(float* buffer, float gainStart, float gainEnd, std::size_t count) noexcept;
+
+/// Largest absolute sample value in the block.
+float peak(const float* src, std::size_t count) noexcept;
+
+} // namespace sleepster::kernels
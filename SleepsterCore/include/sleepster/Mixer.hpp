@@ -0,0 +1,279 @@
+//
+//  Mixer.hpp
+//  SleepsterCore
+//
+//  Real-time voice mixer. Every voice lives in a slot preallocated at
+//  construction; the control thread (the main actor in the app) talks to
+//  the render thread only through wait-free SPSC queues, so render() never
+//  locks, allocates or frees. Idle slots cost nothing per block: only the
+//  dense list of active voices is walked.
+//
+
+#pragma once
+
+#include "sleepster/AudioSource.hpp"
+#include "sleepster/Automation.hpp"
+#include "sleepster/Delay.hpp"
+#include "sleepster/Equalizer.hpp"
+#include "sleepster/GainRamp.hpp"
+#include "sleepster/Reverb.hpp"
+#include "sleepster/Semaphore.hpp"
+#include "sleepster/SpscQueue.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace sleepster {
+
+/// Opaque voice handle: slot index in the low 16 bits and a generation
+/// counter in the high 16 bits, so a stale handle can never address a slot
+/// that has since been reused. Zero is never a valid handle.
+using VoiceId = uint32_t;
+constexpr VoiceId kInvalidVoice = 0;
+
+/// Identifies one volume ramp in the events it produces. Zero is never issued.
+using RampToken = uint32_t;
+
+struct MixerConfig {
+    double sampleRate = 48000.0;
+    /// Upper bound on simultaneous voices; slots are allocated up front.
+    uint32_t maxVoices = 64;
+    /// Largest block rendered in one pass. Larger render() requests are
+    /// split internally.
+    uint32_t maxBlockFrames = 1024;
+    uint32_t commandQueueCapacity = 256;
+};
+
+enum class MixerEventType : uint8_t {
+    /// A non-looping source reached its end and the voice was released.
+    VoiceFinished,
+    /// A ramp reached its target on the sample it was scheduled for.
+    RampFinished,
+    /// A ramp was cut short by another volume change, a stop, or the end of
+    /// its source.
+    RampCancelled,
+    /// An automation timeline reached its end and stopped every voice; the
+    /// voice is kInvalidVoice.
+    AutomationFinished,
+};
+
+struct MixerEvent {
+    MixerEventType type;
+    VoiceId voice;
+    /// The ramp concerned; zero for other events.
+    RampToken ramp;
+};
+
+class Mixer {
+public:
+    explicit Mixer(const MixerConfig& config = {});
+    ~Mixer();
+
+    Mixer(const Mixer&) = delete;
+    Mixer& operator=(const Mixer&) = delete;
+
+    const MixerConfig& config() const noexcept { return config_; }
+
+    // MARK: - Control thread
+
+    /// Starts `source` at `volume`. Returns kInvalidVoice when every slot is
+    /// busy or the command queue is full; the source is destroyed in that case.
+    /// Slots of released voices only become free again in collectEvents().
+    VoiceId play(std::unique_ptr<AudioSource> source, float volume);
+
+    /// Stops a voice with a short declick ramp. Returns false for stale
+    /// handles.
+    bool stop(VoiceId voice);
+
+    void stopAll();
+
+    /// Moves to `volume` over the declick time.
+    bool setVolume(VoiceId voice, float volume);
+
+    /// Ramps a voice to `volume` over `seconds`, interpolated per sample on
+    /// the render thread. With `stopWhenDone` the voice is released as soon as
+    /// the ramp ends. Completion (or cancellation) is reported through
+    /// collectEvents() with the returned token; returns 0 for stale handles or
+    /// a full command queue.
+    RampToken rampVolume(VoiceId voice, float volume, double seconds, RampCurve curve,
+                         bool stopWhenDone = false);
+
+    /// Forwards a parameter change to the voice's source on the render
+    /// thread, in order with the other commands. Returns false for stale
+    /// handles or a full command queue.
+    bool setSourceParameter(VoiceId voice, uint32_t parameter, float value);
+
+    void setMasterVolume(float volume);
+
+    /// Plays `timeline` on the render thread, replacing any timeline already
+    /// playing, from `startSeconds` into it. Channel lanes address
+    /// `channels[lane.channel]`; stale handles and channels past `count`
+    /// are skipped. Automated gains multiply the voice and master volumes,
+    /// and automated EQ and effect mixes hold until the timeline stops.
+    /// Returns false when the command queue is full or too many replaced
+    /// timelines are waiting for collectEvents() to free them.
+    bool automate(const AutomationTimeline& timeline, const VoiceId* channels, std::size_t count,
+                  double startSeconds = 0.0);
+
+    /// Stops the timeline, returning every automated value to where the
+    /// control thread left it.
+    void stopAutomation();
+
+    /// EQ on the master bus, after the master volume. Its control methods
+    /// follow the same single-control-thread rule as the mixer's.
+    Equalizer& equalizer() noexcept { return equalizer_; }
+
+    /// Effects after the EQ, in this order; same threading rule. Both are
+    /// bypassed until enabled.
+    StereoDelay& delay() noexcept { return delay_; }
+    FdnReverb& reverb() noexcept { return reverb_; }
+
+    /// True while the voice owns its slot (playing or not yet reclaimed).
+    bool isActive(VoiceId voice) const noexcept;
+
+    /// Number of slots currently owned by voices.
+    std::size_t activeVoiceCount() const noexcept { return busyCount_; }
+
+    /// Reclaims voices the render thread has released, destroying their
+    /// sources here rather than on the render thread, and reports events.
+    /// Returns the number of events written to `out`.
+    std::size_t collectEvents(MixerEvent* out, std::size_t maxEvents);
+
+    /// Blocks until the render thread posts events or the timeout elapses.
+    /// May be called from any thread; follow it with collectEvents() on the
+    /// control thread.
+    bool waitForEvents(int64_t timeoutMs) noexcept { return eventSignal_.wait(timeoutMs); }
+
+    // MARK: - Render thread
+
+    /// Mixes all active voices into `left`/`right` (overwritten).
+    void render(float* left, float* right, std::size_t frames) noexcept;
+
+private:
+    /// A timeline resolved for this mixer, owned by the render thread while
+    /// it plays.
+    struct Automation {
+        /// Channel actions carry the voice's slot as their index.
+        std::vector<AutomationAction> actions;
+        std::vector<Equalizer::Curve> curves;
+        std::vector<uint32_t> slots;
+        uint64_t startFrame = 0;
+        uint64_t endFrame = UINT64_MAX;
+    };
+
+    struct Command {
+        enum class Type : uint8_t {
+            Play,
+            Stop,
+            StopAll,
+            SetVolume,
+            Ramp,
+            SetMasterVolume,
+            SetParameter,
+            Automate,
+        };
+        Type type;
+        uint32_t slot;
+        float value;
+        AudioSource* source;
+        // Ramp only.
+        uint64_t frames = 0;
+        RampToken token = 0;
+        RampCurve curve = RampCurve::Linear;
+        bool stopWhenDone = false;
+        // SetParameter only.
+        uint32_t parameter = 0;
+        // Automate only; null stops the timeline.
+        Automation* automation = nullptr;
+    };
+
+    struct RampEvent {
+        MixerEventType type;
+        uint32_t slot;
+        RampToken token;
+    };
+
+    struct Release {
+        uint32_t slot;
+        AudioSource* source;
+        bool finished;
+    };
+
+    struct RenderVoice {
+        AudioSource* source = nullptr;
+        GainRamp gain;
+        /// Timeline gain, applied on top of `gain` while it is not 1.
+        GainRamp automation{1.0f};
+        /// Ramp whose end the control thread is waiting to hear about.
+        RampToken ramp = 0;
+        uint32_t activeIndex = 0;
+        bool stopWhenDone = false;
+        bool stopping = false;
+        bool finished = false;
+        /// Addressed by the current timeline.
+        bool automated = false;
+    };
+
+    struct SlotState {
+        uint16_t generation = 1;
+        bool busy = false;
+    };
+
+    static uint32_t slotOf(VoiceId voice) noexcept { return voice & 0xFFFFu; }
+    VoiceId makeId(uint32_t slot) const noexcept {
+        return (static_cast<VoiceId>(slots_[slot].generation) << 16) | slot;
+    }
+    bool validate(VoiceId voice) const noexcept;
+    bool send(const Command& command) noexcept;
+
+    void processCommands() noexcept;
+    void activate(uint32_t slot, AudioSource* source, float volume) noexcept;
+    void beginStop(RenderVoice& voice) noexcept;
+    void stopAllVoices() noexcept;
+    void attachAutomation(Automation* automation) noexcept;
+    void detachAutomation(bool finished) noexcept;
+    std::size_t runAutomation(std::size_t frames) noexcept;
+    void applyAction(const AutomationAction& action, uint64_t elapsed) noexcept;
+    void endRamp(uint32_t slot, MixerEventType type) noexcept;
+    void renderBlock(float* left, float* right, std::size_t frames) noexcept;
+    bool retire(uint32_t slot) noexcept;
+
+    const MixerConfig config_;
+
+    // Control-thread state.
+    std::vector<SlotState> slots_;
+    std::vector<uint32_t> freeSlots_;
+    std::size_t busyCount_ = 0;
+    RampToken nextRampToken_ = 1;
+    /// Timelines sent and not yet freed, at most the retired queue's capacity.
+    std::size_t automationsInFlight_ = 0;
+    const uint64_t declickFrames_;
+
+    SpscQueue<Command> commands_;
+    SpscQueue<Release> releases_;
+    SpscQueue<RampEvent> rampEvents_;
+    SpscQueue<Automation*> retiredAutomations_;
+    Semaphore eventSignal_;
+
+    // Render-thread state.
+    std::vector<RenderVoice> voices_;
+    std::vector<uint32_t> activeSlots_;
+    std::size_t activeCount_ = 0;
+    GainRamp masterGain_{1.0f};
+    GainRamp masterAutomation_{1.0f};
+    Automation* automation_ = nullptr;
+    std::size_t nextAction_ = 0;
+    /// Frames since the start of the timeline.
+    uint64_t automationClock_ = 0;
+    /// Set when this render pass queued anything for the control thread.
+    bool eventsPosted_ = false;
+    std::vector<float> scratchLeft_;
+    std::vector<float> scratchRight_;
+    Equalizer equalizer_;
+    StereoDelay delay_;
+    FdnReverb reverb_;
+};
+
+} // namespace sleepster
@@ -0,0 +1,113 @@
+//
+//  MpscQueue.hpp
+//  SleepsterCore
+//
+//  Bounded multi-producer / single-consumer queue. Each slot carries a
+//  sequence number that says whose turn it is, so producers claim a slot
+//  with one compare-and-swap on the tail and publish it with a release
+//  store, and the consumer never touches the tail at all. Nothing locks or
+//  allocates after construction. A producer stalled between claiming and
+//  publishing holds up only the consumer, which sees the queue as empty at
+//  that slot until the element arrives.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace sleepster {
+
+template <typename T>
+class MpscQueue {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "MpscQueue elements are copied with plain stores");
+
+public:
+    /// Capacity is rounded up to the next power of two. All storage is
+    /// allocated here; nothing allocates afterwards.
+    explicit MpscQueue(std::size_t minimumCapacity)
+        : capacity_(roundUpToPowerOfTwo(minimumCapacity < 2 ? 2 : minimumCapacity)),
+          mask_(capacity_ - 1),
+          cells_(new Cell[capacity_]) {
+        for (std::size_t i = 0; i < capacity_; ++i) cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /// Any thread. Returns false when the queue is full; otherwise
+    /// `position` is the element's place in the order of all pushes.
+    bool tryPush(const T& value, std::size_t& position) noexcept {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[tail & mask_];
+            const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<std::ptrdiff_t>(sequence - tail);
+            if (lag == 0) {
+                if (tail_.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(tail + 1, std::memory_order_release);
+                    position = tail;
+                    return true;
+                }
+            } else if (lag < 0) {
+                // The consumer has not freed this slot from the last lap.
+                return false;
+            } else {
+                tail = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPush(const T& value) noexcept {
+        std::size_t position;
+        return tryPush(value, position);
+    }
+
+    /// Consumer side. Returns false when the queue is empty or the next
+    /// element is still being written.
+    bool tryPop(T& out) noexcept {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        Cell& cell = cells_[head & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != head + 1) return false;
+        out = cell.value;
+        cell.sequence.store(head + capacity_, std::memory_order_release);
+        head_.store(head + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// Approximate element count.
+    std::size_t sizeApprox() const noexcept {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    std::size_t capacity() const noexcept { return capacity_; }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        T value;
+    };
+
+    static std::size_t roundUpToPowerOfTwo(std::size_t v) noexcept {
+        std::size_t p = 1;
+        while (p < v) p <<= 1;
+        return p;
+    }
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    // Producers share the tail; the consumer owns the head.
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    alignas(64) std::atomic<std::size_t> head_{0};
+};
+
+} // namespace sleepster
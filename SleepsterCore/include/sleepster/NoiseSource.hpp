@@ -0,0 +1,105 @@
+//
+//  NoiseSource.hpp
+//  SleepsterCore
+//
+//  Procedural noise for the catalog's noise sounds, so they need no asset
+//  and no decoding. Four xorshift32 generators per channel run side by side
+//  in vector lanes to give white noise; pink comes from Paul Kellet's
+//  three-pole filter and brown from a leaky integrator. Every colour is
+//  normalised to the same loudness.
+//
+//  The colour is a tilt in dB per octave, from 0 (white) through -3 (pink)
+//  to -6 (brown). Tilts in between blend the two neighbouring colours, and
+//  a tilt change glides so the sound never switches abruptly.
+//
+
+#pragma once
+
+#include "sleepster/AudioSource.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace sleepster {
+
+enum class NoiseColor : uint8_t {
+    White,
+    Pink,
+    Brown,
+};
+
+class NoiseSource final : public AudioSource {
+public:
+    /// setParameter id for the spectral tilt, in dB per octave.
+    static constexpr uint32_t kTiltParameter = 0;
+    static constexpr float kMinTilt = -6.0f;
+    static constexpr float kMaxTilt = 0.0f;
+    /// Time constant of tilt changes.
+    static constexpr double kGlideSeconds = 0.05;
+    /// RMS level of every colour, about -14 dBFS, leaving headroom for the
+    /// tracks it is mixed with.
+    static constexpr float kLevel = 0.2f;
+
+    static float tiltOf(NoiseColor color) noexcept;
+
+    /// A zero seed is valid; each channel's lanes are seeded from it through
+    /// splitmix64, so equal seeds give identical output.
+    NoiseSource(float tilt, uint64_t seed);
+    NoiseSource(NoiseColor color, uint64_t seed);
+
+    void prepare(double sampleRate, std::size_t maxBlockFrames) override;
+    /// Jumps each generator ahead in O(log n) and restarts the colour
+    /// filters from rest; they settle within a few hundred milliseconds.
+    /// The white noise matches a continuous render exactly when every block
+    /// so far was a whole number of vectors, as the mixer's blocks are.
+    bool seek(uint64_t frame) override;
+    /// Never finishes.
+    std::size_t render(float* left, float* right, std::size_t frames) noexcept override;
+    void setParameter(uint32_t parameter, float value) noexcept override;
+
+private:
+    /// Frames generated per pass; blocks are split to fit the scratch.
+    static constexpr std::size_t kChunk = 256;
+    static constexpr std::size_t kPinkPoles = 3;
+
+    /// Output gain of each colour at a given tilt, normalisation included.
+    struct Weights {
+        float white = 0.0f;
+        float pink = 0.0f;
+        float brown = 0.0f;
+    };
+
+    struct ChannelState {
+        alignas(16) uint32_t lanes[4] = {};
+        std::array<float, kPinkPoles> pink{};
+        float brown = 0.0f;
+    };
+
+    void computeCoefficients(double sampleRate) noexcept;
+    Weights weightsAt(float tilt) const noexcept;
+    void renderChunk(float* left, float* right, std::size_t count) noexcept;
+    void generateWhite(ChannelState& state, float* out, std::size_t count) noexcept;
+    template <bool Pink, bool Brown>
+    void shape(float* left, float* right, std::size_t count, Weights from, Weights step) noexcept;
+
+    // Coefficients for the current sample rate.
+    std::array<float, kPinkPoles> pinkPoles_{};
+    std::array<float, kPinkPoles> pinkGains_{};
+    float pinkDirect_ = 0.0f;
+    float brownPole_ = 0.0f;
+    float whiteNorm_ = 0.0f;
+    float pinkNorm_ = 0.0f;
+    float brownNorm_ = 0.0f;
+    double sampleRate_ = 48000.0;
+
+    // Render-thread state.
+    float tilt_;
+    float targetTilt_;
+    bool pinkActive_ = false;
+    bool brownActive_ = false;
+    std::array<ChannelState, 2> channels_;
+    alignas(16) float white_[2][kChunk] = {};
+};
+
+} // namespace sleepster
@@ -0,0 +1,60 @@
+//
+//  NullAudioSink.hpp
+//  SleepsterCore
+//
+//  Stand-in for the hardware output on machines without audio (Linux CI).
+//  Pulls blocks from a Mixer either synchronously via pump() or from a
+//  thread paced to wall-clock time, exactly like a device callback would.
+//
+
+#pragma once
+
+#include "sleepster/Mixer.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace sleepster {
+
+class NullAudioSink {
+public:
+    NullAudioSink(Mixer& mixer, std::size_t blockFrames);
+    ~NullAudioSink();
+
+    NullAudioSink(const NullAudioSink&) = delete;
+    NullAudioSink& operator=(const NullAudioSink&) = delete;
+
+    /// Renders `frames` frames immediately on the calling thread.
+    void pump(std::size_t frames);
+
+    /// Starts rendering on a background thread at the mixer's sample rate.
+    void start();
+    void stop();
+
+    uint64_t framesRendered() const noexcept { return framesRendered_.load(std::memory_order_relaxed); }
+
+    /// Largest absolute sample seen since construction.
+    float peak() const noexcept { return peak_.load(std::memory_order_relaxed); }
+
+    /// The most recently rendered block.
+    const std::vector<float>& lastLeft() const noexcept { return left_; }
+    const std::vector<float>& lastRight() const noexcept { return right_; }
+
+private:
+    void renderBlock(std::size_t frames);
+    void run();
+
+    Mixer& mixer_;
+    const std::size_t blockFrames_;
+    std::vector<float> left_;
+    std::vector<float> right_;
+    std::atomic<uint64_t> framesRendered_{0};
+    std::atomic<float> peak_{0.0f};
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+} // namespace sleepster
@@ -0,0 +1,146 @@
+//
+//  OfflineRender.hpp
+//  SleepsterCore
+//
+//  Bounces a mix (tracks with volumes and fades, plus the master-bus EQ and
+//  effects) as fast as the CPU allows instead of in real time. The timeline
+//  is cut into fixed chunks that worker threads render in parallel, each
+//  through its own Mixer: a chunk seeks its sources to just before its
+//  start and renders a pre-roll that is thrown away, long enough for the
+//  EQ, delay and reverb to forget that they started from silence. Chunks
+//  overlap by a few milliseconds and are crossfaded where they meet, and
+//  reach the sink in timeline order.
+//
+//  Chunk boundaries depend only on the mix and the chunk length, so the
+//  output is identical whatever the number of threads, and agrees with a
+//  single uninterrupted pass to within the pre-roll's residue.
+//
+
+#pragma once
+
+#include "sleepster/AudioFileWriter.hpp"
+#include "sleepster/AudioSource.hpp"
+#include "sleepster/Automation.hpp"
+#include "sleepster/Decoder.hpp"
+#include "sleepster/Equalizer.hpp"
+#include "sleepster/Reverb.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sleepster {
+
+class Mixer;
+struct PcmBuffer;
+
+/// Master-bus state a mix is rendered with; mirrors the live controls.
+struct BusSettings {
+    float masterVolume = 1.0f;
+
+    bool equalizerEnabled = false;
+    std::array<float, Equalizer::kBandCount> equalizerGainsDb{};
+
+    bool delayEnabled = false;
+    double delaySeconds = 0.1;
+    float delayFeedback = 0.2f;
+    float delayMix = 0.2f;
+
+    bool reverbEnabled = false;
+    ReverbPreset reverbPreset = ReverbPreset::Room;
+    float reverbMix = 0.3f;
+
+    /// Configures the mixer's EQ and effects (not the master volume, which
+    /// the renderer folds into the track volumes).
+    void applyTo(Mixer& mixer) const;
+
+    /// How long the bus takes to forget its input to within -120 dB; the
+    /// pre-roll of every chunk after the first.
+    double settlingSeconds() const noexcept;
+};
+
+struct OfflineTrack {
+    /// Makes a fresh source for one chunk. Called from worker threads,
+    /// possibly several at once; sources for chunks after the first must be
+    /// able to seek().
+    std::function<std::unique_ptr<AudioSource>()> makeSource;
+    float volume = 1.0f;
+    /// Equal-power rise from silence at the start of the render, as
+    /// AudioMixingEngine fades sounds in.
+    double fadeInSeconds = 0.0;
+    /// Exponential fall to silence ending with the render.
+    double fadeOutSeconds = 0.0;
+};
+
+struct OfflineMix {
+    double sampleRate = 48000.0;
+    double durationSeconds = 0.0;
+    std::vector<OfflineTrack> tracks;
+    BusSettings bus;
+    /// Channel lanes address tracks by index. Played sample-accurately in
+    /// every chunk, caught up to the chunk's pre-roll like the sources.
+    AutomationTimeline automation;
+
+    uint64_t frameCount() const noexcept;
+};
+
+struct OfflineRenderOptions {
+    /// Worker threads; 0 uses one per core.
+    unsigned threads = 0;
+    /// Length of each independently rendered piece of the timeline. Longer
+    /// chunks spend less of their time in pre-roll; shorter ones spread
+    /// better across cores and hold less memory in flight.
+    double chunkSeconds = 30.0;
+};
+
+struct OfflineRenderStats {
+    uint64_t frames = 0;
+    unsigned threads = 0;
+    std::size_t chunks = 0;
+    double wallSeconds = 0.0;
+    /// Seconds of audio rendered per second of wall time.
+    double realTimeFactor = 0.0;
+};
+
+/// Receives the render in timeline order, one call at a time. Returning
+/// false stops the render.
+using OfflineSink = std::function<bool(const float* left, const float* right, std::size_t frames)>;
+
+/// Renders `mix` into `sink`. Returns false if a source cannot be made or
+/// cannot seek, or if the sink fails; the sink may have received part of
+/// the render by then.
+bool renderOffline(const OfflineMix& mix, const OfflineRenderOptions& options, const OfflineSink& sink,
+                   OfflineRenderStats* stats = nullptr);
+
+/// Renders into a stereo buffer at the mix rate.
+bool renderOfflineToBuffer(const OfflineMix& mix, const OfflineRenderOptions& options, PcmBuffer& out,
+                           OfflineRenderStats* stats = nullptr);
+
+/// Renders into a stereo file, streaming it out as chunks complete.
+bool renderOfflineToFile(const OfflineMix& mix, const OfflineRenderOptions& options, const std::string& path,
+                         AudioFileType type, WavFormat::Encoding encoding, OfflineRenderStats* stats = nullptr);
+
+/// Plays a decoder by decoding on the rendering thread itself, with no
+/// worker or ring buffer: suited to offline rendering, where blocking on
+/// I/O costs only time, and never to the real-time render thread.
+class DecoderSource final : public AudioSource {
+public:
+    DecoderSource(std::unique_ptr<Decoder> decoder, bool loop);
+
+    /// Wraps the decoder in a ResamplingDecoder if its rate differs.
+    void prepare(double sampleRate, std::size_t maxBlockFrames) override;
+    /// Needs a decoder that knows its length when looping.
+    bool seek(uint64_t frame) override;
+    std::size_t render(float* left, float* right, std::size_t frames) noexcept override;
+
+private:
+    std::unique_ptr<Decoder> decoder_;
+    const bool loop_;
+    bool ended_ = false;
+};
+
+} // namespace sleepster
@@ -0,0 +1,115 @@
+//
+//  Palette.hpp
+//  SleepsterCore
+//
+//  The colours the animated backgrounds draw with, resolved ahead of time
+//  for every colour theme, dimmed state and intensity tier instead of per
+//  element on every frame. A palette holds packed swatches, the stops of
+//  each gradient with the dimmed and intensity opacities already applied,
+//  and each gradient sampled at 256 even positions, so a view picks a
+//  colour by index rather than by switching on the theme and multiplying
+//  opacities.
+//
+//  The definitions are constant tables; the 32 palettes (about 300 KB)
+//  are built from them on first use and kept for the life of the process.
+//  Colours are the dark-appearance system colours the views used, since
+//  the backgrounds are always drawn dark.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sleepster {
+
+namespace palette {
+
+constexpr std::size_t kThemeCount = 4;
+/// intensityLevel 0...3 as stored for a background.
+constexpr std::size_t kTierCount = 4;
+constexpr std::size_t kMaxStops = 4;
+constexpr std::size_t kRampSize = 256;
+
+} // namespace palette
+
+/// ColorTheme, in its declaration order.
+enum class PaletteTheme : uint8_t {
+    Default = 0,
+    Warm = 1,
+    Cool = 2,
+    Monochrome = 3,
+};
+
+enum class Swatch : uint8_t {
+    SheepBody = 0,
+    /// The theme's colour at full opacity.
+    Accent = 1,
+    /// Outlines of the orbiting symbols.
+    AccentStroke = 2,
+};
+
+constexpr std::size_t kSwatchCount = 3;
+
+enum class PaletteGradient : uint8_t {
+    MeadowSky = 0,
+    HorizonGlow = 1,
+    Cloud = 2,
+    /// Clear to the sheep's shadow colour, sampled at its opacity.
+    SheepShadow = 3,
+    OceanDepth = 4,
+    /// Scaled by intensity.
+    Caustics = 5,
+    Bubble = 6,
+    /// Accent coloured and scaled by intensity.
+    MandalaGlow = 7,
+    /// Accent coloured.
+    Crystal = 8,
+};
+
+constexpr std::size_t kPaletteGradientCount = 9;
+
+/// 0xRRGGBBAA, straight (not premultiplied) alpha.
+using PackedColor = uint32_t;
+
+constexpr PackedColor packColor(float r, float g, float b, float a) noexcept {
+    auto channel = [](float value) {
+        const float clamped = value < 0.0f ? 0.0f : value > 1.0f ? 1.0f : value;
+        return static_cast<uint32_t>(clamped * 255.0f + 0.5f);
+    };
+    return channel(r) << 24 | channel(g) << 16 | channel(b) << 8 | channel(a);
+}
+
+constexpr float channelOf(PackedColor color, int index) noexcept {
+    return static_cast<float>((color >> (24 - 8 * index)) & 0xFFu) * (1.0f / 255.0f);
+}
+
+struct GradientStops {
+    PackedColor colors[palette::kMaxStops];
+    /// Evenly spaced, 2...kMaxStops.
+    uint32_t count;
+};
+
+struct Palette {
+    PackedColor swatches[kSwatchCount];
+    GradientStops gradients[kPaletteGradientCount];
+    PackedColor ramps[kPaletteGradientCount][palette::kRampSize];
+
+    PackedColor swatch(Swatch swatch) const noexcept { return swatches[static_cast<std::size_t>(swatch)]; }
+    const GradientStops& stops(PaletteGradient gradient) const noexcept {
+        return gradients[static_cast<std::size_t>(gradient)];
+    }
+    /// The gradient's colour at `position` 0...1, to the nearest of 256.
+    PackedColor sample(PaletteGradient gradient, float position) const noexcept;
+};
+
+/// The tier for a view's intensity (intensityLevel / 3).
+std::size_t paletteTier(float intensity) noexcept;
+
+/// Built on first use; safe to call from any thread.
+const Palette& themePalette(PaletteTheme theme, bool dimmed, std::size_t tier) noexcept;
+
+/// The same palette built without the cache, for tests and benchmarks.
+void buildPalette(PaletteTheme theme, bool dimmed, std::size_t tier, Palette& out) noexcept;
+
+} // namespace sleepster
@@ -0,0 +1,221 @@
+//
+//  ParticleSystem.hpp
+//  SleepsterCore
+//
+//  Particle simulation for the animated backgrounds. Each system stores its
+//  particles as structure-of-arrays columns, so every motion is a handful
+//  of 4-wide vector passes over contiguous floats, and a view draws straight
+//  from the x, y, size and alpha columns.
+//
+//  Systems are seeded: the same seed and the same sequence of time steps
+//  give the same particles on every platform.
+//
+
+#pragma once
+
+#include "sleepster/FrameArena.hpp"
+#include "sleepster/FramePacer.hpp"
+#include "sleepster/Random.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace sleepster {
+
+struct ParticleRange {
+    float min = 0.0f;
+    float max = 0.0f;
+};
+
+enum class ParticleMotion : uint8_t {
+    /// Stays where it spawned (stars, dew).
+    Static,
+    /// Constant velocity, wrapping around the bounds (dust, plankton, mist).
+    Drift,
+    /// Circles an anchor on independent x and y phases while the anchor
+    /// drifts and wraps (floating sheep, jellyfish, fireflies).
+    Orbit,
+    /// Falls (or rises) with the wind and an optional sideways sway, and
+    /// re-enters at the opposite edge after leaving (rain, petals, bubbles).
+    Fall,
+};
+
+struct ParticleBounds {
+    float minX = 0.0f;
+    float minY = 0.0f;
+    float maxX = 0.0f;
+    float maxY = 0.0f;
+};
+
+/// Every range is sampled once per particle at spawn.
+struct ParticleConfig {
+    ParticleMotion motion = ParticleMotion::Static;
+    std::size_t count = 0;
+    /// Drift and Orbit wrap around it. Fall wraps across it and re-enters
+    /// at the top (or, when rising, the bottom) after crossing the far edge.
+    ParticleBounds bounds;
+    /// Where particles start; Fall also re-enters across the x range.
+    ParticleRange x;
+    ParticleRange y;
+    /// Points per second. For Fall the sign of velocityY is the direction.
+    ParticleRange velocityX;
+    ParticleRange velocityY;
+    /// Orbit radii around the anchor. For Fall, radiusX is the sway.
+    ParticleRange radiusX;
+    ParticleRange radiusY;
+    /// Radians per second, drawn separately for the x and y phase.
+    ParticleRange orbitRate;
+    ParticleRange size;
+    /// Alpha at full brightness.
+    ParticleRange alpha{1.0f, 1.0f};
+    /// Radians per second; an all-zero range turns twinkling off.
+    ParticleRange twinkleRate;
+    /// Share of the alpha lost at the dimmest point of a twinkle, 0...1.
+    float twinkleDepth = 0.0f;
+    /// Points per second, added to every particle's velocity.
+    float windX = 0.0f;
+    float windY = 0.0f;
+};
+
+/// A Fall particle that crossed the far edge during the last update, at the
+/// position it was last drawn.
+struct ParticleExit {
+    uint32_t index;
+    float x;
+    float y;
+};
+
+class ParticleSystem {
+public:
+    ParticleSystem(const ParticleConfig& config, uint64_t seed);
+
+    ParticleSystem(const ParticleSystem&) = delete;
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+    /// Advances by `seconds`. Never allocates: per-frame scratch, such as
+    /// the exit list, comes from `arena`.
+    void update(float seconds, FrameArena& arena) noexcept;
+
+    std::size_t count() const noexcept { return count_; }
+    /// Columns of count() values, stable for the system's lifetime.
+    const float* x() const noexcept { return column(X); }
+    const float* y() const noexcept { return column(Y); }
+    /// Where to draw: after ParticleScene::advance, positions interpolated
+    /// between the last two fixed steps; otherwise x() and y().
+    const float* drawX() const noexcept { return column(interpolated_ ? DrawX : X); }
+    const float* drawY() const noexcept { return column(interpolated_ ? DrawY : Y); }
+    const float* size() const noexcept { return column(Size); }
+    const float* alpha() const noexcept { return column(Alpha); }
+
+    /// Valid until the arena the last update used is reset.
+    const ParticleExit* exits() const noexcept { return exits_; }
+    std::size_t exitCount() const noexcept { return exitCount_; }
+
+    /// Takes effect on the next update; particles outside the new bounds
+    /// wrap or re-enter from there.
+    void setBounds(const ParticleBounds& bounds) noexcept { config_.bounds = bounds; }
+    void setWind(float x, float y) noexcept;
+
+    const ParticleConfig& config() const noexcept { return config_; }
+    /// Most arena bytes one update takes.
+    std::size_t scratchBytes() const noexcept;
+
+private:
+    friend class ParticleScene;
+
+    enum Column : std::size_t {
+        X,
+        Y,
+        AnchorX,
+        AnchorY,
+        VelocityX,
+        VelocityY,
+        RadiusX,
+        RadiusY,
+        PhaseX,
+        PhaseY,
+        RateX,
+        RateY,
+        TwinklePhase,
+        TwinkleRate,
+        BaseAlpha,
+        Alpha,
+        Size,
+        PreviousX,
+        PreviousY,
+        DrawX,
+        DrawY,
+        kColumnCount,
+    };
+
+    float* column(Column c) noexcept { return storage_.get() + c * stride_; }
+    const float* column(Column c) const noexcept { return storage_.get() + c * stride_; }
+
+    void spawn(std::size_t index) noexcept;
+    /// Positions from the anchors and alpha from the twinkle phase.
+    void place() noexcept;
+    void collectExits(FrameArena& arena) noexcept;
+    /// One fixed step of ParticleScene::advance, adding to the exits of the
+    /// steps before it in the same frame.
+    void fixedStep(float seconds, FrameArena& arena) noexcept;
+    void clearExits() noexcept;
+    /// Keeps the positions the next step starts from.
+    void keepPrevious() noexcept;
+    void interpolate(float alpha) noexcept;
+
+    ParticleConfig config_;
+    std::size_t count_;
+    /// Column length: count_ rounded up to whole vectors. The padding lanes
+    /// are simulated along with the rest and never reported.
+    std::size_t stride_;
+    bool twinkles_;
+    std::unique_ptr<float[]> storage_;
+    Random random_;
+    ParticleExit* exits_ = nullptr;
+    std::size_t exitCount_ = 0;
+    /// Updates whose exits share one list: 1, or the fixed steps one
+    /// advance may take.
+    std::size_t exitSteps_ = 1;
+    bool interpolated_ = false;
+};
+
+/// The particle systems of one background, advanced together with one
+/// shared scratch arena.
+class ParticleScene {
+public:
+    /// Longest step update() takes; a longer gap (the app was in the
+    /// background, a frame hitched) is shortened rather than jumped.
+    static constexpr double kMaxStepSeconds = 0.25;
+
+    explicit ParticleScene(uint64_t seed) : seed_(seed) {}
+
+    /// Adds a system and returns its index. Allocates; call while setting
+    /// the scene up, not per frame.
+    std::size_t add(const ParticleConfig& config);
+
+    void update(double seconds) noexcept;
+
+    /// Advances by `seconds` of display time in fixed steps of
+    /// kFixedStepSeconds and interpolates the drawn positions between the
+    /// last two, so motion is as smooth at 120 Hz as at 15 Hz and runs at
+    /// the same speed. Exits cover every step taken. Returns the step count.
+    int advance(double seconds) noexcept;
+    static constexpr double kFixedStepSeconds = 1.0 / 60.0;
+    /// Most steps one advance takes; longer gaps are shortened to that.
+    static constexpr int kMaxFixedSteps = 8;
+
+    std::size_t systemCount() const noexcept { return systems_.size(); }
+    ParticleSystem& system(std::size_t index) noexcept { return *systems_[index]; }
+    const ParticleSystem& system(std::size_t index) const noexcept { return *systems_[index]; }
+    const FrameArena& arena() const noexcept { return arena_; }
+
+private:
+    uint64_t seed_;
+    std::vector<std::unique_ptr<ParticleSystem>> systems_;
+    FrameArena arena_;
+    FixedTimestep clock_{kFixedStepSeconds, kMaxFixedSteps};
+};
+
+} // namespace sleepster
@@ -0,0 +1,52 @@
+//
+//  PcmSource.hpp
+//  SleepsterCore
+//
+//  Plays a fully decoded, deinterleaved float buffer, optionally looping.
+//  Buffers recorded at a different rate than the mixer are resampled with
+//  linear interpolation.
+//
+
+#pragma once
+
+#include "sleepster/AudioSource.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace sleepster {
+
+struct PcmBuffer {
+    double sampleRate = 48000.0;
+    std::size_t frameCount = 0;
+    /// One vector per channel (1 or 2 channels); mono is played on both sides.
+    std::vector<std::vector<float>> channels;
+
+    /// Copies `channelCount` planar channel pointers of `frameCount` frames.
+    static std::shared_ptr<PcmBuffer> copyPlanar(const float* const* channelData,
+                                                 uint32_t channelCount,
+                                                 std::size_t frameCount, double sampleRate);
+};
+
+class PcmSource final : public AudioSource {
+public:
+    PcmSource(std::shared_ptr<const PcmBuffer> buffer, bool loop);
+
+    void prepare(double sampleRate, std::size_t maxBlockFrames) override;
+    bool seek(uint64_t frame) override;
+    std::size_t render(float* left, float* right, std::size_t frames) noexcept override;
+
+private:
+    std::size_t renderDirect(float* left, float* right, std::size_t frames) noexcept;
+    std::size_t renderResampled(float* left, float* right, std::size_t frames) noexcept;
+
+    std::shared_ptr<const PcmBuffer> buffer_;
+    const bool loop_;
+    double step_ = 1.0;
+    double position_ = 0.0;
+    std::size_t cursor_ = 0;
+};
+
+} // namespace sleepster
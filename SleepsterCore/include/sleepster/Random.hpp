@@ -0,0 +1,54 @@
+//
+//  Random.hpp
+//  SleepsterCore
+//
+//  Small seeded generators for everything that must be reproducible: equal
+//  seeds give the same sequence on every platform and build, which keeps
+//  noise, particle scenes and their tests deterministic.
+//
+
+#pragma once
+
+#include <cstdint>
+
+namespace sleepster {
+
+/// Advances `state` and returns the next output of splitmix64. Used to
+/// expand one seed into the state of other generators.
+inline uint64_t splitmix64(uint64_t& state) noexcept {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/// PCG32 (XSH-RR). Not for anything security related.
+class Random {
+public:
+    explicit Random(uint64_t seed = 0) noexcept { reseed(seed); }
+
+    void reseed(uint64_t seed) noexcept {
+        state_ = splitmix64(seed);
+        increment_ = splitmix64(seed) | 1u;
+    }
+
+    uint32_t next() noexcept {
+        const uint64_t old = state_;
+        state_ = old * 6364136223846793005ull + increment_;
+        const uint32_t mixed = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        const uint32_t rotation = static_cast<uint32_t>(old >> 59);
+        return (mixed >> rotation) | (mixed << ((32 - rotation) & 31));
+    }
+
+    /// Uniform on [0, 1), in steps of 2^-24 so every value is exact.
+    float uniform() noexcept { return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f); }
+
+    /// Uniform on [low, high); returns `low` for an empty range.
+    float uniform(float low, float high) noexcept { return low + (high - low) * uniform(); }
+
+private:
+    uint64_t state_ = 0;
+    uint64_t increment_ = 1;
+};
+
+} // namespace sleepster
@@ -0,0 +1,52 @@
+//
+//  RealFft.hpp
+//  SleepsterCore
+//
+//  Forward FFT of real signals, as spectral analysis needs it: an N-point
+//  real transform computed as an N/2-point complex one plus a split pass.
+//  Twiddles, bit reversal and scratch are sized at construction, so
+//  transforming never allocates.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sleepster {
+
+class RealFft {
+public:
+    /// `size` must be a power of two of at least 4.
+    explicit RealFft(std::size_t size);
+
+    std::size_t size() const noexcept { return size_; }
+    /// Bins 0 through size / 2.
+    std::size_t binCount() const noexcept { return size_ / 2 + 1; }
+
+    /// Writes binCount() real and imaginary parts of the transform of
+    /// `size` samples. Unscaled.
+    void forward(const float* input, float* real, float* imaginary) noexcept;
+    /// Squared magnitudes of the bins, each divided by size².
+    void powerSpectrum(const float* input, float* power) noexcept;
+
+    /// Heap bytes held.
+    std::size_t memoryBytes() const noexcept;
+
+private:
+    std::size_t size_;
+    std::size_t half_;
+    std::vector<uint32_t> reversed_;
+    /// e^(-2πik/half) for the complex pass and e^(-2πik/size) for the split.
+    std::vector<float> twiddleRe_;
+    std::vector<float> twiddleIm_;
+    std::vector<float> splitRe_;
+    std::vector<float> splitIm_;
+    std::vector<float> re_;
+    std::vector<float> im_;
+    /// Imaginary parts for powerSpectrum.
+    std::vector<float> scratch_;
+};
+
+} // namespace sleepster
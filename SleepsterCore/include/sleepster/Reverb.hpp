@@ -0,0 +1,134 @@
+//
+//  Reverb.hpp
+//  SleepsterCore
+//
+//  Feedback-delay-network reverb for the master bus. Eight delay lines feed
+//  back through an orthogonal Hadamard matrix with per-line gains set from
+//  the decay time and a one-pole damping filter for a darker tail.
+//
+//  Every line is at least kChunk samples long, so a chunk's worth of line
+//  outputs is always known before any of the chunk is written back. The
+//  network therefore runs a chunk at a time, and the matrix reduces to
+//  three butterfly passes of vertical adds and subtracts over whole arrays.
+//
+
+#pragma once
+
+#include "sleepster/DelayLine.hpp"
+#include "sleepster/EffectStage.hpp"
+#include "sleepster/TripleBuffer.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sleepster {
+
+/// The rooms AudioEffectsProcessor offers.
+enum class ReverbPreset : uint8_t {
+    Room,
+    Hall,
+    Cathedral,
+    Plate,
+};
+
+class FdnReverb {
+public:
+    static constexpr std::size_t kLines = 8;
+    /// Samples processed per pass through the network; no line is shorter.
+    static constexpr std::size_t kChunk = 64;
+    static constexpr std::size_t kPresetCount = 4;
+
+    FdnReverb(double sampleRate, std::size_t maxBlockFrames);
+
+    FdnReverb(const FdnReverb&) = delete;
+    FdnReverb& operator=(const FdnReverb&) = delete;
+
+    /// Low-frequency time to decay by 60 dB.
+    static double decaySeconds(ReverbPreset preset) noexcept;
+
+    // MARK: - Control thread
+
+    /// Enabling starts from a silent network; disabling fades the wet signal
+    /// out and then bypasses the effect.
+    void setEnabled(bool enabled);
+    /// Switching presets while running fades the old room out before the
+    /// new one fades in, since the line lengths change.
+    void setPreset(ReverbPreset preset);
+    /// Wet share of the output, 0...1.
+    void setMix(float wet);
+
+    bool isEnabled() const noexcept { return settings_.enabled; }
+
+    // MARK: - Render thread
+
+    void process(float* left, float* right, std::size_t frames) noexcept;
+
+    /// Drives the wet share from an automation timeline: ramps to `wet` over
+    /// `frames` frames, `elapsed` of which have already gone by. While it
+    /// does, mix changes from the control thread wait for restoreMix().
+    void automateMix(float wet, uint64_t frames, uint64_t elapsed) noexcept;
+    /// Returns to the control thread's wet share.
+    void restoreMix() noexcept;
+
+    /// True while the effect does work on each block (enabled and not asleep).
+    bool isRunning() const noexcept { return !bypassed_ && !tail_.isAsleep(); }
+
+private:
+    struct Settings {
+        bool enabled = false;
+        ReverbPreset preset = ReverbPreset::Room;
+        float wet = 0.3f;
+    };
+
+    /// A preset resolved for this sample rate.
+    struct Layout {
+        std::array<std::size_t, kLines> lengths{};
+        std::array<float, kLines> gains{};
+        float damping = 0.0f;
+        std::size_t preDelay = 0;
+        uint64_t tailFrames = 0;
+    };
+
+    static Layout makeLayout(ReverbPreset preset, double sampleRate);
+
+    void publish();
+    void apply(const Settings& settings) noexcept;
+    float mixTarget() const noexcept { return automatedWet_ < 0.0f ? wet_ : automatedWet_; }
+    void loadPreset(ReverbPreset preset) noexcept;
+    void renderWet(const float* left, const float* right, std::size_t frames) noexcept;
+    void renderChunk(const float* left, const float* right, float* wetLeft, float* wetRight,
+                     std::size_t count) noexcept;
+
+    const uint64_t declickFrames_;
+    const uint64_t switchFrames_;
+    const std::array<Layout, kPresetCount> layouts_;
+
+    // Control-thread state.
+    Settings settings_;
+    TripleBuffer<Settings> snapshots_;
+
+    // Render-thread state.
+    std::array<DelayLine, kLines> lines_;
+    DelayLine preDelayLeft_;
+    DelayLine preDelayRight_;
+    const Layout* layout_;
+    ReverbPreset preset_ = ReverbPreset::Room;
+    ReverbPreset pendingPreset_ = ReverbPreset::Room;
+    bool switching_ = false;
+    float wet_ = 0.0f;
+    /// Negative unless a timeline drives the mix.
+    float automatedWet_ = -1.0f;
+    bool enabled_ = false;
+    bool bypassed_ = true;
+    std::array<float, kLines> damped_{};
+    alignas(16) float work_[kLines][kChunk] = {};
+    alignas(16) float input_[2][kChunk] = {};
+    WetDryMix mix_;
+    TailTracker tail_;
+    std::vector<float> wetLeft_;
+    std::vector<float> wetRight_;
+};
+
+} // namespace sleepster
@@ -0,0 +1,91 @@
+//
+//  Semaphore.hpp
+//  SleepsterCore
+//
+//  Counting semaphore whose signal() is safe to call from the audio render
+//  thread. Used to wake a background thread when the render callback posts
+//  events, so nobody has to poll on a timer.
+//
+
+#pragma once
+
+#include <cstdint>
+
+#if defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#else
+#include <cerrno>
+#include <ctime>
+#include <semaphore.h>
+#endif
+
+namespace sleepster {
+
+class Semaphore {
+public:
+    Semaphore() noexcept {
+#if defined(__APPLE__)
+        sem_ = dispatch_semaphore_create(0);
+#else
+        sem_init(&sem_, 0, 0);
+#endif
+    }
+
+    ~Semaphore() {
+#if defined(__APPLE__)
+        dispatch_release(sem_);
+#else
+        sem_destroy(&sem_);
+#endif
+    }
+
+    Semaphore(const Semaphore&) = delete;
+    Semaphore& operator=(const Semaphore&) = delete;
+
+    void signal() noexcept {
+#if defined(__APPLE__)
+        dispatch_semaphore_signal(sem_);
+#else
+        sem_post(&sem_);
+#endif
+    }
+
+    /// Blocks until signalled or until `timeoutMs` elapses (negative waits
+    /// forever). Returns true when the semaphore was signalled.
+    bool wait(int64_t timeoutMs = -1) noexcept {
+#if defined(__APPLE__)
+        const dispatch_time_t deadline =
+            timeoutMs < 0 ? DISPATCH_TIME_FOREVER
+                          : dispatch_time(DISPATCH_TIME_NOW, timeoutMs * 1000000LL);
+        return dispatch_semaphore_wait(sem_, deadline) == 0;
+#else
+        if (timeoutMs < 0) {
+            while (sem_wait(&sem_) != 0) {
+                if (errno != EINTR) return false;
+            }
+            return true;
+        }
+        timespec ts{};
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_sec += static_cast<time_t>(timeoutMs / 1000);
+        ts.tv_nsec += static_cast<long>((timeoutMs % 1000) * 1000000L);
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_sec += 1;
+            ts.tv_nsec -= 1000000000L;
+        }
+        while (sem_timedwait(&sem_, &ts) != 0) {
+            if (errno != EINTR) return false;
+        }
+        return true;
+#endif
+    }
+
+private:
+#if defined(__APPLE__)
+    dispatch_semaphore_t sem_;
+#else
+    sem_t sem_;
+#endif
+};
+
+} // namespace sleepster
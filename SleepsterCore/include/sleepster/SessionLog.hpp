@@ -0,0 +1,185 @@
+//
+//  SessionLog.hpp
+//  SleepsterCore
+//
+//  Append-only store for sleep sessions. Storing a session appends one
+//  record to the log and one fixed-size entry to its index, whatever the
+//  history holds; storing a session again under the same id supersedes the
+//  earlier record, and a tombstone removes it. Opening reads only the
+//  index, and sessions are decoded from a read-only mapping of the log when
+//  asked for.
+//
+//  Layout (little-endian):
+//
+//      log      "SLPS", version, generation                      16 bytes
+//               records: payload length, CRC-32 of payload, payload
+//               (a session's sound events, if any, trail its strings)
+//      index    "SLPI", version, generation                      16 bytes
+//               one 48-byte entry per record: offset, length, kind,
+//               session id, start and end time
+//
+//  Crash safety: a record is written (and by default synced) before its
+//  index entry, every record carries a CRC, and opening truncates a torn
+//  record at the end of the log. The index is only a cache of the log: an
+//  entry that does not match the log is dropped, records past the last
+//  entry are indexed again, and an index from another generation is
+//  rebuilt. Compaction writes a new generation of both files beside the
+//  old ones and renames them into place, log first.
+//
+
+#pragma once
+
+#include "sleepster/MappedFile.hpp"
+#include "sleepster/SoundEventDetector.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sleepster {
+
+namespace sessionlog {
+
+constexpr char kLogMagic[4] = {'S', 'L', 'P', 'S'};
+constexpr char kIndexMagic[4] = {'S', 'L', 'P', 'I'};
+constexpr uint32_t kVersion = 1;
+constexpr std::size_t kHeaderSize = 16;
+constexpr std::size_t kRecordHeaderSize = 8;
+constexpr std::size_t kEntrySize = 48;
+
+enum class RecordKind : uint8_t {
+    Session = 1,
+    Tombstone = 2,
+};
+
+} // namespace sessionlog
+
+/// A session's UUID bytes.
+using SessionId = std::array<uint8_t, 16>;
+
+struct SleepSessionRecord {
+    SessionId id{};
+    /// Seconds since 1970.
+    double startTime = 0.0;
+    /// NaN while the session is running.
+    double endTime = 0.0;
+    double expectedDuration = 0.0;
+    /// NaN when not known.
+    double actualDuration = 0.0;
+    std::vector<std::string> soundsUsed;
+    bool hasBackground = false;
+    std::string backgroundUsed;
+    float masterVolume = 0.0f;
+    std::vector<std::string> activeSounds;
+    std::string equalizerPreset;
+    bool effectsEnabled = false;
+    /// What the microphone heard, with times in seconds since 1970.
+    std::vector<SoundEvent> soundEvents;
+};
+
+struct SessionLogOptions {
+    /// fsync the log after every append. A night produces one or two
+    /// records, so durability is worth the milliseconds.
+    bool syncEachAppend = true;
+    /// needsCompaction() once superseded and removed records make up this
+    /// fraction of the log ...
+    double compactDeadFraction = 0.5;
+    /// ... and at least this many bytes.
+    std::size_t compactMinimumBytes = 64 * 1024;
+};
+
+/// All methods are thread-safe; compaction may run on a background thread
+/// while the owner appends and reads.
+class SessionLog {
+public:
+    /// Opens the log at `path` and its index at `path + ".idx"`, creating
+    /// them if missing and recovering from an interrupted append or
+    /// compaction. Returns nullptr when the files cannot be opened or
+    /// `path` holds something other than a session log.
+    static std::unique_ptr<SessionLog> open(const std::string& path, const SessionLogOptions& options = {});
+
+    ~SessionLog();
+    SessionLog(const SessionLog&) = delete;
+    SessionLog& operator=(const SessionLog&) = delete;
+
+    /// Adds `session`, superseding any earlier record with its id. False
+    /// when the write failed (the log is left as it was) or a string or
+    /// list is longer than 65535.
+    bool append(const SleepSessionRecord& session);
+    /// Appends a tombstone for `id`. False when no live session has it.
+    bool remove(const SessionId& id);
+
+    /// Live sessions, oldest record first.
+    std::size_t size() const;
+    /// Decodes the `index`th live session. False when out of range.
+    bool read(std::size_t index, SleepSessionRecord& out) const;
+    bool find(const SessionId& id, SleepSessionRecord& out) const;
+
+    /// Bytes of the log, and the part of them that compaction would drop.
+    std::size_t fileBytes() const;
+    std::size_t deadBytes() const;
+    /// Records in the log, live or not.
+    std::size_t recordCount() const;
+    bool needsCompaction() const;
+    /// Rewrites the log with only the live sessions. On failure the old
+    /// files stay in use.
+    bool compact();
+
+private:
+    struct Entry {
+        uint64_t offset;
+        uint32_t length;
+        sessionlog::RecordKind kind;
+        bool live;
+        SessionId id;
+        double startTime;
+        double endTime;
+    };
+
+    struct IdHash {
+        std::size_t operator()(const SessionId& id) const noexcept;
+    };
+
+    SessionLog(std::string path, const SessionLogOptions& options);
+
+    bool load();
+    bool createFiles();
+    void loadIndex();
+    void scanLogTail();
+    bool appendRecord(sessionlog::RecordKind kind, const SessionId& id, double startTime, double endTime);
+    void addEntry(const Entry& entry);
+    bool ensureMapped(uint64_t end) const;
+    bool decode(const Entry& entry, SleepSessionRecord& out) const;
+    void rebuildLive() const;
+    void closeFiles() noexcept;
+
+    const std::string path_;
+    const std::string indexPath_;
+    const SessionLogOptions options_;
+
+    mutable std::mutex mutex_;
+    int logFd_ = -1;
+    int indexFd_ = -1;
+    uint64_t generation_ = 0;
+    uint64_t logBytes_ = 0;
+    uint64_t deadBytes_ = 0;
+    std::vector<Entry> entries_;
+    std::unordered_map<SessionId, uint32_t, IdHash> latest_;
+    mutable std::vector<uint32_t> live_;
+    mutable bool liveStale_ = true;
+    mutable MappedFile map_;
+    std::vector<uint8_t> scratch_;
+};
+
+/// Record payload codec, exposed for tests and benchmarks. encodeSession
+/// appends to `out` and leaves it as it was on failure.
+bool encodeSession(const SleepSessionRecord& session, std::vector<uint8_t>& out);
+bool decodeSession(const uint8_t* payload, std::size_t length, SleepSessionRecord& out);
+uint32_t crc32(const uint8_t* data, std::size_t length) noexcept;
+
+} // namespace sleepster
@@ -0,0 +1,131 @@
+//
+//  ShapeGeometry.hpp
+//  SleepsterCore
+//
+//  Outlines of the sacred-geometry and sheep shapes, tessellated once into
+//  flat verb and point arrays. Every one of these shapes is centred in its
+//  rect and scales with min(width, height), so a single unit outline
+//  serves every size: placing it in a rect is a scale and a translation of
+//  its points, with no trigonometry and no allocation.
+//
+//  The fixed angles come from `UnitCircle` tables evaluated at compile
+//  time. Ellipses are kept as four cubics, as Core Graphics adds them, so
+//  the outline stays exact at any size.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sleepster {
+
+namespace detail {
+
+constexpr double kPi = 3.14159265358979323846;
+
+/// sin(x) for |x| <= pi from its Taylor series, for compile-time tables.
+/// Sixteen terms put the error below double rounding over that range.
+constexpr double taylorSin(double x) noexcept {
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 16; ++n) {
+        term *= -x * x / static_cast<double>((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+/// Wraps an angle into -pi...pi.
+constexpr double wrapAngle(double x) noexcept {
+    while (x > kPi) x -= 2.0 * kPi;
+    while (x < -kPi) x += 2.0 * kPi;
+    return x;
+}
+
+} // namespace detail
+
+/// cos and sin of 2 pi k / N for k in 0..<N, computed by the compiler.
+template <int N>
+struct UnitCircle {
+    float cos[N] = {};
+    float sin[N] = {};
+
+    constexpr UnitCircle() noexcept {
+        for (int k = 0; k < N; ++k) {
+            const double angle = detail::wrapAngle(2.0 * detail::kPi * k / N);
+            sin[k] = static_cast<float>(detail::taylorSin(angle));
+            cos[k] = static_cast<float>(detail::taylorSin(detail::wrapAngle(angle + detail::kPi / 2.0)));
+        }
+    }
+};
+
+template <int N>
+inline constexpr UnitCircle<N> kUnitCircle{};
+
+enum class ShapeKind : uint8_t {
+    FlowerOfLife,
+    MetatronsCube,
+    Triquetra,
+    SriYantra,
+    VesicaPiscis,
+    Enneagram,
+    SacredMandala,
+    Sheep,
+};
+
+constexpr int kShapeKindCount = 8;
+
+/// Path elements, as SwiftUI's Path. Move and Line take one point, Quad
+/// two (control, end), Cubic three (two controls, end) and Close none.
+enum class PathVerb : uint8_t {
+    Move,
+    Line,
+    Quad,
+    Cubic,
+    Close,
+};
+
+/// Flat outline: verbs, and their points as interleaved x, y floats.
+class ShapePath {
+public:
+    const std::vector<PathVerb>& verbs() const noexcept { return verbs_; }
+    /// 2 * pointCount() floats.
+    const std::vector<float>& points() const noexcept { return points_; }
+    std::size_t pointCount() const noexcept { return points_.size() / 2; }
+
+    void moveTo(float x, float y);
+    void lineTo(float x, float y);
+    void quadTo(float cx, float cy, float x, float y);
+    void cubicTo(float c1x, float c1y, float c2x, float c2y, float x, float y);
+    void close();
+    /// Ellipse inscribed in a rect: a closed subpath of four cubics starting
+    /// at the right and running clockwise on screen, as CGPath adds it.
+    void addEllipse(float x, float y, float width, float height);
+    /// Closed subpath from the top-left corner, clockwise on screen.
+    void addRect(float x, float y, float width, float height);
+    /// Scales every point about the origin.
+    void scaleBy(float factor) noexcept;
+
+private:
+    void push(float x, float y) {
+        points_.push_back(x);
+        points_.push_back(y);
+    }
+
+    std::vector<PathVerb> verbs_;
+    std::vector<float> points_;
+};
+
+/// The shape's outline centred on the origin, for a rect whose smaller side
+/// is 1. Built on first use and kept for the life of the process; safe to
+/// call from any thread.
+const ShapePath& unitShape(ShapeKind kind);
+
+/// Writes `unit`'s points placed in the rect x, y, width, height (centred,
+/// scaled by its smaller side) to `out`, which holds 2 * pointCount()
+/// floats.
+void placeShape(const ShapePath& unit, float x, float y, float width, float height, float* out) noexcept;
+
+} // namespace sleepster
@@ -0,0 +1,252 @@
+//
+//  Simd.hpp
+//  SleepsterCore
+//
+//  Minimal 4-wide float vector used by the DSP kernels. Maps to NEON on
+//  Apple silicon, SSE on x86 (the Linux test build) and a plain struct
+//  everywhere else so kernels never need per-platform code paths.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SLEEPSTER_SIMD_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SLEEPSTER_SIMD_SSE 1
+#endif
+
+namespace sleepster::simd {
+
+constexpr std::size_t kWidth = 4;
+
+#if SLEEPSTER_SIMD_NEON
+
+using f32x4 = float32x4_t;
+
+inline f32x4 load(const float* p) noexcept { return vld1q_f32(p); }
+inline void store(float* p, f32x4 v) noexcept { vst1q_f32(p, v); }
+inline f32x4 splat(float v) noexcept { return vdupq_n_f32(v); }
+inline f32x4 set(float a, float b, float c, float d) noexcept {
+    const float tmp[4] = {a, b, c, d};
+    return vld1q_f32(tmp);
+}
+inline f32x4 add(f32x4 a, f32x4 b) noexcept { return vaddq_f32(a, b); }
+inline f32x4 sub(f32x4 a, f32x4 b) noexcept { return vsubq_f32(a, b); }
+inline f32x4 mul(f32x4 a, f32x4 b) noexcept { return vmulq_f32(a, b); }
+/// Returns a + b * c.
+inline f32x4 madd(f32x4 a, f32x4 b, f32x4 c) noexcept { return vmlaq_f32(a, b, c); }
+inline f32x4 min(f32x4 a, f32x4 b) noexcept { return vminq_f32(a, b); }
+inline f32x4 max(f32x4 a, f32x4 b) noexcept { return vmaxq_f32(a, b); }
+inline f32x4 abs(f32x4 a) noexcept { return vabsq_f32(a); }
+inline float lane(f32x4 v, int i) noexcept {
+    float tmp[4];
+    vst1q_f32(tmp, v);
+    return tmp[i];
+}
+inline float sum(f32x4 v) noexcept { return vaddvq_f32(v); }
+/// Returns {p[0], p[1], v[0], v[1]}.
+inline f32x4 loadPairUnderLow(const float* p, f32x4 v) noexcept {
+    return vcombine_f32(vld1_f32(p), vget_low_f32(v));
+}
+/// Writes v[2], v[3] to p[0], p[1].
+inline void storeHighPair(float* p, f32x4 v) noexcept { vst1_f32(p, vget_high_f32(v)); }
+/// Returns {a[2], a[3], b[0], b[1]}.
+inline f32x4 highLow(f32x4 a, f32x4 b) noexcept { return vextq_f32(a, b, 2); }
+inline f32x4 floor(f32x4 a) noexcept { return vrndmq_f32(a); }
+/// All ones in the lanes where a < b, zeros elsewhere.
+inline f32x4 lessThan(f32x4 a, f32x4 b) noexcept { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+/// Lanes of `a` where `mask` is set, of `b` elsewhere.
+inline f32x4 select(f32x4 mask, f32x4 a, f32x4 b) noexcept {
+    return vbslq_f32(vreinterpretq_u32_f32(mask), a, b);
+}
+/// Bit i set when lane i of the mask is.
+inline int maskBits(f32x4 mask) noexcept {
+    const uint32x4_t weights = {1, 2, 4, 8};
+    return static_cast<int>(vaddvq_u32(vandq_u32(vreinterpretq_u32_f32(mask), weights)));
+}
+
+using u32x4 = uint32x4_t;
+
+inline u32x4 loadU32(const uint32_t* p) noexcept { return vld1q_u32(p); }
+inline void storeU32(uint32_t* p, u32x4 v) noexcept { vst1q_u32(p, v); }
+inline u32x4 splatU32(uint32_t v) noexcept { return vdupq_n_u32(v); }
+inline u32x4 bitXor(u32x4 a, u32x4 b) noexcept { return veorq_u32(a, b); }
+inline u32x4 bitAnd(u32x4 a, u32x4 b) noexcept { return vandq_u32(a, b); }
+template <int N>
+inline u32x4 shiftLeft(u32x4 a) noexcept { return vshlq_n_u32(a, N); }
+template <int N>
+inline u32x4 shiftRight(u32x4 a) noexcept { return vshrq_n_u32(a, N); }
+/// Converts the bits read as signed integers, giving [-2^31, 2^31).
+inline f32x4 toFloatSigned(u32x4 a) noexcept { return vcvtq_f32_s32(vreinterpretq_s32_u32(a)); }
+
+#elif SLEEPSTER_SIMD_SSE
+
+using f32x4 = __m128;
+
+inline f32x4 load(const float* p) noexcept { return _mm_loadu_ps(p); }
+inline void store(float* p, f32x4 v) noexcept { _mm_storeu_ps(p, v); }
+inline f32x4 splat(float v) noexcept { return _mm_set1_ps(v); }
+inline f32x4 set(float a, float b, float c, float d) noexcept { return _mm_setr_ps(a, b, c, d); }
+inline f32x4 add(f32x4 a, f32x4 b) noexcept { return _mm_add_ps(a, b); }
+inline f32x4 sub(f32x4 a, f32x4 b) noexcept { return _mm_sub_ps(a, b); }
+inline f32x4 mul(f32x4 a, f32x4 b) noexcept { return _mm_mul_ps(a, b); }
+/// Returns a + b * c.
+inline f32x4 madd(f32x4 a, f32x4 b, f32x4 c) noexcept { return _mm_add_ps(a, _mm_mul_ps(b, c)); }
+inline f32x4 min(f32x4 a, f32x4 b) noexcept { return _mm_min_ps(a, b); }
+inline f32x4 max(f32x4 a, f32x4 b) noexcept { return _mm_max_ps(a, b); }
+inline f32x4 abs(f32x4 a) noexcept { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+inline float lane(f32x4 v, int i) noexcept {
+    alignas(16) float tmp[4];
+    _mm_store_ps(tmp, v);
+    return tmp[i];
+}
+inline float sum(f32x4 v) noexcept {
+    alignas(16) float tmp[4];
+    _mm_store_ps(tmp, v);
+    return (tmp[0] + tmp[1]) + (tmp[2] + tmp[3]);
+}
+/// Returns {p[0], p[1], v[0], v[1]}.
+inline f32x4 loadPairUnderLow(const float* p, f32x4 v) noexcept {
+    return _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(p))), v);
+}
+/// Writes v[2], v[3] to p[0], p[1].
+inline void storeHighPair(float* p, f32x4 v) noexcept {
+    _mm_storeh_pd(reinterpret_cast<double*>(p), _mm_castps_pd(v));
+}
+/// Returns {a[2], a[3], b[0], b[1]}.
+inline f32x4 highLow(f32x4 a, f32x4 b) noexcept { return _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 3, 2)); }
+/// Exact for |a| < 2^31, which covers every use here.
+inline f32x4 floor(f32x4 a) noexcept {
+    const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+    return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmplt_ps(a, truncated), _mm_set1_ps(1.0f)));
+}
+/// All ones in the lanes where a < b, zeros elsewhere.
+inline f32x4 lessThan(f32x4 a, f32x4 b) noexcept { return _mm_cmplt_ps(a, b); }
+/// Lanes of `a` where `mask` is set, of `b` elsewhere.
+inline f32x4 select(f32x4 mask, f32x4 a, f32x4 b) noexcept {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+/// Bit i set when lane i of the mask is.
+inline int maskBits(f32x4 mask) noexcept { return _mm_movemask_ps(mask); }
+
+using u32x4 = __m128i;
+
+inline u32x4 loadU32(const uint32_t* p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+inline void storeU32(uint32_t* p, u32x4 v) noexcept { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+inline u32x4 splatU32(uint32_t v) noexcept { return _mm_set1_epi32(static_cast<int>(v)); }
+inline u32x4 bitXor(u32x4 a, u32x4 b) noexcept { return _mm_xor_si128(a, b); }
+inline u32x4 bitAnd(u32x4 a, u32x4 b) noexcept { return _mm_and_si128(a, b); }
+template <int N>
+inline u32x4 shiftLeft(u32x4 a) noexcept { return _mm_slli_epi32(a, N); }
+template <int N>
+inline u32x4 shiftRight(u32x4 a) noexcept { return _mm_srli_epi32(a, N); }
+/// Converts the bits read as signed integers, giving [-2^31, 2^31).
+inline f32x4 toFloatSigned(u32x4 a) noexcept { return _mm_cvtepi32_ps(a); }
+
+#else
+
+struct f32x4 {
+    float v[4];
+};
+
+inline f32x4 load(const float* p) noexcept { return {{p[0], p[1], p[2], p[3]}}; }
+inline void store(float* p, f32x4 a) noexcept {
+    for (int i = 0; i < 4; ++i) p[i] = a.v[i];
+}
+inline f32x4 splat(float x) noexcept { return {{x, x, x, x}}; }
+inline f32x4 set(float a, float b, float c, float d) noexcept { return {{a, b, c, d}}; }
+#define SLEEPSTER_SIMD_LANEWISE(name, expr)                     \
+    inline f32x4 name(f32x4 a, f32x4 b) noexcept {              \
+        f32x4 r;                                                \
+        for (int i = 0; i < 4; ++i) r.v[i] = (expr);            \
+        return r;                                               \
+    }
+SLEEPSTER_SIMD_LANEWISE(add, a.v[i] + b.v[i])
+SLEEPSTER_SIMD_LANEWISE(sub, a.v[i] - b.v[i])
+SLEEPSTER_SIMD_LANEWISE(mul, a.v[i] * b.v[i])
+SLEEPSTER_SIMD_LANEWISE(min, a.v[i] < b.v[i] ? a.v[i] : b.v[i])
+SLEEPSTER_SIMD_LANEWISE(max, a.v[i] > b.v[i] ? a.v[i] : b.v[i])
+#undef SLEEPSTER_SIMD_LANEWISE
+inline f32x4 madd(f32x4 a, f32x4 b, f32x4 c) noexcept { return add(a, mul(b, c)); }
+inline f32x4 abs(f32x4 a) noexcept {
+    for (int i = 0; i < 4; ++i) a.v[i] = a.v[i] < 0.0f ? -a.v[i] : a.v[i];
+    return a;
+}
+inline float lane(f32x4 a, int i) noexcept { return a.v[i]; }
+inline float sum(f32x4 a) noexcept { return (a.v[0] + a.v[1]) + (a.v[2] + a.v[3]); }
+/// Returns {p[0], p[1], v[0], v[1]}.
+inline f32x4 loadPairUnderLow(const float* p, f32x4 v) noexcept { return {{p[0], p[1], v.v[0], v.v[1]}}; }
+/// Writes v[2], v[3] to p[0], p[1].
+inline void storeHighPair(float* p, f32x4 v) noexcept {
+    p[0] = v.v[2];
+    p[1] = v.v[3];
+}
+/// Returns {a[2], a[3], b[0], b[1]}.
+inline f32x4 highLow(f32x4 a, f32x4 b) noexcept { return {{a.v[2], a.v[3], b.v[0], b.v[1]}}; }
+inline f32x4 floor(f32x4 a) noexcept {
+    for (int i = 0; i < 4; ++i) {
+        const float truncated = static_cast<float>(static_cast<int32_t>(a.v[i]));
+        a.v[i] = a.v[i] < truncated ? truncated - 1.0f : truncated;
+    }
+    return a;
+}
+/// Lanes are 1.0 where a < b and 0.0 elsewhere; only select and maskBits
+/// read them.
+inline f32x4 lessThan(f32x4 a, f32x4 b) noexcept {
+    for (int i = 0; i < 4; ++i) a.v[i] = a.v[i] < b.v[i] ? 1.0f : 0.0f;
+    return a;
+}
+/// Lanes of `a` where `mask` is set, of `b` elsewhere.
+inline f32x4 select(f32x4 mask, f32x4 a, f32x4 b) noexcept {
+    for (int i = 0; i < 4; ++i) b.v[i] = mask.v[i] != 0.0f ? a.v[i] : b.v[i];
+    return b;
+}
+/// Bit i set when lane i of the mask is.
+inline int maskBits(f32x4 mask) noexcept {
+    int bits = 0;
+    for (int i = 0; i < 4; ++i) bits |= mask.v[i] != 0.0f ? 1 << i : 0;
+    return bits;
+}
+
+struct u32x4 {
+    uint32_t v[4];
+};
+
+inline u32x4 loadU32(const uint32_t* p) noexcept { return {{p[0], p[1], p[2], p[3]}}; }
+inline void storeU32(uint32_t* p, u32x4 a) noexcept {
+    for (int i = 0; i < 4; ++i) p[i] = a.v[i];
+}
+inline u32x4 splatU32(uint32_t v) noexcept { return {{v, v, v, v}}; }
+inline u32x4 bitXor(u32x4 a, u32x4 b) noexcept {
+    for (int i = 0; i < 4; ++i) a.v[i] ^= b.v[i];
+    return a;
+}
+inline u32x4 bitAnd(u32x4 a, u32x4 b) noexcept {
+    for (int i = 0; i < 4; ++i) a.v[i] &= b.v[i];
+    return a;
+}
+template <int N>
+inline u32x4 shiftLeft(u32x4 a) noexcept {
+    for (int i = 0; i < 4; ++i) a.v[i] <<= N;
+    return a;
+}
+template <int N>
+inline u32x4 shiftRight(u32x4 a) noexcept {
+    for (int i = 0; i < 4; ++i) a.v[i] >>= N;
+    return a;
+}
+/// Converts the bits read as signed integers, giving [-2^31, 2^31).
+inline f32x4 toFloatSigned(u32x4 a) noexcept {
+    f32x4 r;
+    for (int i = 0; i < 4; ++i) r.v[i] = static_cast<float>(static_cast<int32_t>(a.v[i]));
+    return r;
+}
+
+#endif
+
+} // namespace sleepster::simd
@@ -0,0 +1,163 @@
+//
+//  SleepStats.hpp
+//  SleepsterCore
+//
+//  Sleep statistics kept up to date as HealthKit samples arrive, instead of
+//  being re-filtered and re-reduced from the sample array on every query.
+//  Each night, ISO week and calendar month keeps a summary: running moments
+//  of asleep and in-bed durations (Welford, so they stay accurate over
+//  years of samples) and circular moments of bedtimes, so a night that
+//  starts at 23:30 and one that starts at 00:30 average to midnight rather
+//  than to noon. Nights also sit at the leaves of a segment tree, which
+//  answers any range of nights, such as the last week or year, in
+//  O(log n) merges.
+//
+//  Times are seconds since 1970 plus the sample's UTC offset, so nights
+//  follow the local calendar.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace sleepster {
+
+enum class SleepCategory : uint8_t {
+    InBed = 0,
+    Asleep = 1,
+};
+
+/// A HealthKit sample's UUID bytes.
+using SleepSampleId = std::array<uint8_t, 16>;
+
+struct SleepSample {
+    SleepSampleId id{};
+    double startTime = 0.0;
+    double endTime = 0.0;
+    /// Seconds east of UTC where the sample was recorded.
+    int32_t utcOffset = 0;
+    SleepCategory category = SleepCategory::InBed;
+};
+
+/// Count, mean and sum of squared deviations, updated one value at a time.
+struct RunningMoments {
+    uint64_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+
+    void add(double value) noexcept;
+    /// Undoes add(value).
+    void remove(double value) noexcept;
+    /// Folds in another set of values (Chan et al.).
+    void merge(const RunningMoments& other) noexcept;
+
+    double total() const noexcept { return mean * static_cast<double>(count); }
+    /// Population variance; 0 for fewer than two values.
+    double variance() const noexcept;
+    double deviation() const noexcept;
+};
+
+/// Sums of unit vectors for angles on a circle.
+struct CircularMoments {
+    uint64_t count = 0;
+    double sumCos = 0.0;
+    double sumSin = 0.0;
+
+    void add(double radians) noexcept;
+    void remove(double radians) noexcept;
+    void merge(const CircularMoments& other) noexcept;
+
+    /// Mean direction in [0, 2π); 0 while empty.
+    double meanAngle() const noexcept;
+    /// Length of the mean vector: 1 when every angle agrees, near 0 when
+    /// they spread around the circle.
+    double resultantLength() const noexcept;
+    /// Circular standard deviation, sqrt(-2 ln R), in radians.
+    double deviation() const noexcept;
+};
+
+struct SleepSummary {
+    RunningMoments asleep;
+    RunningMoments inBed;
+    /// In-bed start times as angles of the local day.
+    CircularMoments bedtime;
+
+    void merge(const SleepSummary& other) noexcept;
+
+    /// Time asleep as a percentage of time in bed; 0 without both.
+    double efficiency() const noexcept;
+    /// Seconds after local midnight.
+    double meanBedtime() const noexcept;
+    /// Spread of bedtimes in seconds.
+    double bedtimeDeviation() const noexcept;
+    /// 100 minus ten points per hour of bedtime spread, floored at 0; 100
+    /// with fewer than two bedtimes.
+    double bedtimeConsistency() const noexcept;
+};
+
+/// Not thread-safe; the app feeds and queries it on the main actor.
+class SleepStats {
+public:
+    /// The night a moment belongs to: days since 1970-01-01 of local time
+    /// less twelve hours, so a night runs from noon to noon and is named
+    /// after the evening it starts.
+    static int64_t nightOf(double time, int32_t utcOffset) noexcept;
+    /// ISO week (Monday first) holding a night, counted from the week of
+    /// 1970-01-01.
+    static int64_t weekOf(int64_t night) noexcept;
+    /// year * 12 + month - 1 of a night.
+    static int64_t monthOf(int64_t night) noexcept;
+
+    /// Adds a sample to its night, week and month. False when its id is
+    /// already held, it ends before it starts, or it lies centuries from
+    /// the samples already held.
+    bool add(const SleepSample& sample);
+    /// Takes a sample back out, as when HealthKit reports it deleted. False
+    /// when the id is not held.
+    bool remove(const SleepSampleId& id);
+
+    /// Samples held.
+    std::size_t size() const noexcept { return samples_.size(); }
+    const SleepSummary& total() const noexcept { return total_; }
+
+    /// Nights `first` through `last`, inclusive.
+    SleepSummary range(int64_t first, int64_t last) const noexcept;
+    SleepSummary night(int64_t night) const noexcept;
+    SleepSummary week(int64_t week) const;
+    SleepSummary month(int64_t month) const;
+
+private:
+    struct Stored {
+        int64_t night;
+        double duration;
+        /// Of the start time; used for in-bed samples.
+        double angle;
+        SleepCategory category;
+    };
+
+    struct IdHash {
+        std::size_t operator()(const SleepSampleId& id) const noexcept;
+    };
+
+    /// Makes room for `night` among the leaves, doubling as needed.
+    void cover(int64_t night);
+    void update(int64_t night, const Stored& stored, bool adding);
+
+    static void apply(SleepSummary& summary, const Stored& stored, bool adding) noexcept;
+
+    std::unordered_map<SleepSampleId, Stored, IdHash> samples_;
+    /// Segment tree: node 1 is the root and leaf i, night base_ + i, is at
+    /// leaves_ + i.
+    std::vector<SleepSummary> tree_;
+    int64_t base_ = 0;
+    std::size_t leaves_ = 0;
+    std::unordered_map<int64_t, SleepSummary> weeks_;
+    std::unordered_map<int64_t, SleepSummary> months_;
+    SleepSummary total_;
+};
+
+} // namespace sleepster
@@ -0,0 +1,159 @@
+//
+//  SoundEventDetector.hpp
+//  SleepsterCore
+//
+//  Streaming detector for the sounds of a night: snoring, talking,
+//  coughing and loud noise. Microphone samples are cut into hops of half a
+//  frame (about 16 ms at 16 kHz). Each hop's level is compared with a
+//  noise floor that follows the room, steady sleep sounds included; only
+//  hops that stand out are windowed, transformed (RealFft) and reduced to
+//  log-mel band energies, so a quiet night costs little more than a sum of
+//  squares per hop. Consecutive loud hops form an event, and when it ends a
+//  few rules over its duration, onset, loudness modulation and mean
+//  spectral shape decide what it was. Events that match no rule are
+//  dropped.
+//
+//  Every buffer is sized at construction: processing never allocates, and
+//  finished events wait in a fixed-capacity queue until taken.
+//
+
+#pragma once
+
+#include "sleepster/RealFft.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sleepster {
+
+enum class SoundEventKind : uint8_t {
+    Snoring = 1,
+    Talking = 2,
+    Coughing = 3,
+    LoudNoise = 4,
+};
+
+struct SoundEvent {
+    SoundEventKind kind = SoundEventKind::LoudNoise;
+    /// Seconds since the detector started, or since 1970 once stored with
+    /// a session.
+    double time = 0.0;
+    float duration = 0.0f;
+    /// Level of the loudest hop, dBFS.
+    float peakLevel = 0.0f;
+};
+
+struct SoundEventDetectorConfig {
+    double sampleRate = 16000.0;
+    std::size_t melBands = 32;
+    float minFrequency = 50.0f;
+    float maxFrequency = 8000.0f;
+    /// A hop this far above the noise floor opens or extends an event.
+    float activationDb = 10.0f;
+    /// How fast the floor follows the room upward; it falls at once.
+    float floorRiseDbPerSecond = 1.5f;
+    /// An event ends after this long without a loud hop ...
+    double hangoverSeconds = 0.3;
+    /// ... or once it has lasted this long.
+    double maxEventSeconds = 10.0;
+    /// Louder events that match no other rule are loud noise.
+    float loudLevel = -25.0f;
+    std::size_t eventCapacity = 64;
+};
+
+class SoundEventDetector {
+public:
+    explicit SoundEventDetector(const SoundEventDetectorConfig& config = {});
+
+    /// Feeds mono samples in [-1, 1]; any count at a time.
+    void process(const float* samples, std::size_t count) noexcept;
+    /// Ends the event in progress, as at the end of a night.
+    void flush() noexcept;
+
+    /// Moves up to `capacity` finished events to `out`, oldest first.
+    std::size_t takeEvents(SoundEvent* out, std::size_t capacity) noexcept;
+    /// Events dropped because the queue was full.
+    uint64_t droppedEvents() const noexcept { return dropped_; }
+
+    std::size_t frameSize() const noexcept { return fft_.size(); }
+    std::size_t hopSize() const noexcept { return hop_; }
+    /// Seconds of audio processed, in whole hops.
+    double time() const noexcept;
+    /// Hops that were transformed, and hops that only had their level
+    /// measured.
+    uint64_t analyzedHops() const noexcept { return analyzed_; }
+    uint64_t gatedHops() const noexcept { return gated_; }
+    /// dBFS.
+    float noiseFloor() const noexcept { return floor_; }
+    /// Log-mel energies (dB) of the last analyzed frame.
+    const float* bandLevels() const noexcept { return bandLevels_.data(); }
+    /// Heap bytes held; fixed from construction.
+    std::size_t memoryBytes() const noexcept;
+
+private:
+    /// What an open event has gathered so far.
+    struct Open {
+        uint64_t firstHop = 0;
+        uint64_t lastLoudHop = 0;
+        float floor = 0.0f;
+        float peak = -200.0f;
+        float onset = -200.0f;
+        uint32_t analyzed = 0;
+        double low = 0.0;
+        double speech = 0.0;
+        double flatness = 0.0;
+        double centroid = 0.0;
+        /// Loudness peaks separated by dips, as syllables are.
+        uint32_t bursts = 1;
+        float runMax = -200.0f;
+        float runMin = 0.0f;
+        bool dipped = false;
+    };
+
+    void analyzeHop() noexcept;
+    void analyzeSpectrum(Open& event) noexcept;
+    void track(Open& event, float level) noexcept;
+    void close() noexcept;
+    SoundEventKind classify(const Open& event, double duration, bool& keep) const noexcept;
+    void push(const SoundEvent& event) noexcept;
+
+    SoundEventDetectorConfig config_;
+    std::size_t hop_;
+    double hopSeconds_;
+    uint64_t hangoverHops_;
+    uint64_t maxEventHops_;
+    RealFft fft_;
+
+    /// The last frameSize() samples; new ones fill the final hop.
+    std::vector<float> window_;
+    std::size_t filled_ = 0;
+    std::vector<float> hann_;
+    std::vector<float> frame_;
+    std::vector<float> power_;
+
+    /// Triangular mel filters, stored sparsely: band b weights bins
+    /// bandStart_[b]... with weights_[weightStart_[b]...].
+    std::vector<uint32_t> bandStart_;
+    std::vector<uint32_t> bandLength_;
+    std::vector<uint32_t> weightStart_;
+    std::vector<float> weights_;
+    std::vector<float> bandWidth_;
+    std::vector<float> bandCenter_;
+    std::vector<float> bandLevels_;
+
+    uint64_t hopIndex_ = 0;
+    uint64_t analyzed_ = 0;
+    uint64_t gated_ = 0;
+    float floor_ = 0.0f;
+    bool floorSet_ = false;
+    bool open_ = false;
+    Open event_;
+
+    std::vector<SoundEvent> queue_;
+    std::size_t queueHead_ = 0;
+    std::size_t queueSize_ = 0;
+    uint64_t dropped_ = 0;
+};
+
+} // namespace sleepster
@@ -0,0 +1,86 @@
+//
+//  SpscQueue.hpp
+//  SleepsterCore
+//
+//  Bounded single-producer / single-consumer queue. Both ends are wait-free:
+//  a push or pop is a handful of loads and one release store, never a lock
+//  or an allocation, so the audio render thread can sit on either side.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace sleepster {
+
+template <typename T>
+class SpscQueue {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "SpscQueue elements are copied with plain stores");
+
+public:
+    /// Capacity is rounded up to the next power of two. All storage is
+    /// allocated here; nothing allocates afterwards.
+    explicit SpscQueue(std::size_t minimumCapacity)
+        : capacity_(roundUpToPowerOfTwo(minimumCapacity < 2 ? 2 : minimumCapacity)),
+          mask_(capacity_ - 1),
+          slots_(new T[capacity_]) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /// Producer side. Returns false when the queue is full.
+    bool tryPush(const T& value) noexcept {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ == capacity_) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ == capacity_) return false;
+        }
+        slots_[tail & mask_] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer side. Returns false when the queue is empty.
+    bool tryPop(T& out) noexcept {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) return false;
+        }
+        out = slots_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Approximate element count; exact when called from either end while
+    /// the other end is idle.
+    std::size_t sizeApprox() const noexcept {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    std::size_t capacity() const noexcept { return capacity_; }
+
+private:
+    static std::size_t roundUpToPowerOfTwo(std::size_t v) noexcept {
+        std::size_t p = 1;
+        while (p < v) p <<= 1;
+        return p;
+    }
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<T[]> slots_;
+
+    // Producer and consumer indices live on separate cache lines together
+    // with the cached copy of the opposite index each side reads.
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    std::size_t cachedHead_ = 0;
+    alignas(64) std::atomic<std::size_t> head_{0};
+    std::size_t cachedTail_ = 0;
+};
+
+} // namespace sleepster
@@ -0,0 +1,182 @@
+//
+//  StaticLayer.hpp
+//  SleepsterCore
+//
+//  Rasterizer for the parts of the animated backgrounds that never change
+//  while a background is on screen: hills, grass and star sprites. A layer
+//  is generated once from a seed and drawn into a premultiplied RGBA bitmap
+//  at device resolution, which the view then shows as a plain image instead
+//  of rebuilding dozens of gradient-filled shapes on every evaluation.
+//
+//  Coordinates are in points, matching the SwiftUI shapes they replace;
+//  `scale` is pixels per point.
+//
+
+#pragma once
+
+#include "sleepster/ParticleSystem.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sleepster {
+
+/// Straight (not premultiplied) colour, every channel 0...1.
+struct Rgba {
+    float r = 0.0f;
+    float g = 0.0f;
+    float b = 0.0f;
+    float a = 0.0f;
+};
+
+/// Up to three evenly spaced stops, as the backgrounds' SwiftUI gradients.
+struct Gradient {
+    Rgba stops[3];
+    int count = 2;
+
+    /// Colour at `t` in 0...1, clamped.
+    Rgba at(float t) const noexcept;
+};
+
+/// How a filled shape is coloured: a gradient running down from `y` over
+/// `extent` points, or out from the centre `x`, `y` to a radius of `extent`.
+struct Paint {
+    Gradient gradient;
+    bool radial = false;
+    float x = 0.0f;
+    float y = 0.0f;
+    float extent = 1.0f;
+
+    /// Colour at a point.
+    Rgba at(float px, float py) const noexcept;
+};
+
+/// Premultiplied RGBA, eight bits per channel, rows packed top to bottom.
+class Bitmap {
+public:
+    Bitmap() = default;
+    Bitmap(int width, int height);
+
+    int width() const noexcept { return width_; }
+    int height() const noexcept { return height_; }
+    std::size_t bytesPerRow() const noexcept { return static_cast<std::size_t>(width_) * 4; }
+    std::size_t byteCount() const noexcept { return pixels_.size(); }
+    const uint8_t* data() const noexcept { return pixels_.data(); }
+    uint8_t* data() noexcept { return pixels_.data(); }
+
+    /// Premultiplied colour of a pixel; transparent outside the bitmap.
+    Rgba pixel(int x, int y) const noexcept;
+    /// Composites a premultiplied colour over the pixel.
+    void blendOver(int x, int y, const Rgba& premultiplied) noexcept;
+    /// Composites `source`, shifted by dx, dy pixels, over this bitmap.
+    void drawOver(const Bitmap& source, int dx = 0, int dy = 0) noexcept;
+
+private:
+    int width_ = 0;
+    int height_ = 0;
+    std::vector<uint8_t> pixels_;
+};
+
+/// A bitmap and where it sits: its top-left corner in points and how many
+/// pixels it has per point.
+struct StaticLayer {
+    float x = 0.0f;
+    float y = 0.0f;
+    float scale = 1.0f;
+    Bitmap bitmap;
+
+    StaticLayer() = default;
+    StaticLayer(float x, float y, float width, float height, float scale);
+
+    float width() const noexcept { return static_cast<float>(bitmap.width()) / scale; }
+    float height() const noexcept { return static_cast<float>(bitmap.height()) / scale; }
+};
+
+struct Point {
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
+/// Flattens lines and quadratic curves into a closed polygon.
+class PathBuilder {
+public:
+    void moveTo(float x, float y);
+    void lineTo(float x, float y);
+    /// Appends `segments` straight pieces along the curve.
+    void quadTo(float controlX, float controlY, float x, float y, int segments = 12);
+
+    const std::vector<Point>& points() const noexcept { return points_; }
+
+private:
+    std::vector<Point> points_;
+};
+
+/// Fills a polygon (even-odd) into the layer, anti-aliased with exact
+/// horizontal coverage over four sub-rows per pixel row.
+void fillPolygon(StaticLayer& layer, const std::vector<Point>& polygon, const Paint& paint);
+
+/// Approximately Gaussian blur of `radius` points (three box passes).
+void blur(StaticLayer& layer, float radius);
+
+/// Puts a blurred, offset shadow of the layer's coverage underneath it, as
+/// SwiftUI's .shadow(color:radius:x:y:) does.
+void dropShadow(StaticLayer& layer, const Rgba& color, float radius, float dx, float dy);
+
+// MARK: - Background layers
+
+/// EnhancedHillShape drawn into a `width` x `height` frame whose top is
+/// at `top`.
+struct HillConfig {
+    float top = 0.0f;
+    float height = 0.0f;
+    Gradient fill;
+    float blur = 0.0f;
+};
+
+/// Hills back to front, clipped to the layer.
+StaticLayer renderHills(float width, float top, float bottom, float scale, const std::vector<HillConfig>& hills);
+
+/// A row of grass blades (EnhancedGrassShape) standing on `baseline`.
+struct GrassConfig {
+    uint64_t seed = 0;
+    float width = 0.0f;
+    float scale = 1.0f;
+    /// Distance between blades; blade i stands at i * spacing plus jitter.
+    float spacing = 15.0f;
+    float jitterX = 0.0f;
+    float jitterY = 0.0f;
+    float baseline = 0.0f;
+    ParticleRange bladeHeight{30.0f, 60.0f};
+    ParticleRange bladeWidth{2.0f, 4.0f};
+    /// Top to bottom of each blade.
+    Gradient fill;
+    float blur = 0.0f;
+    Rgba shadow;
+    float shadowRadius = 0.0f;
+    float shadowX = 0.0f;
+    float shadowY = 0.0f;
+};
+
+/// The row in a strip just tall enough for the blades and their shadow,
+/// with one extra blade past each side so the strip can sway as a whole.
+StaticLayer renderGrass(const GrassConfig& config);
+
+/// StarShape sprites of evenly spaced sizes, side by side in one strip.
+struct StarSpriteConfig {
+    float scale = 1.0f;
+    /// Frame of the smallest and largest star, in points.
+    ParticleRange size{1.5f, 6.0f};
+    int count = 8;
+    /// Radial fill from the star's centre; the sheep view ends it at 3 pt
+    /// whatever the star's size.
+    Gradient fill;
+    float fillRadius = 3.0f;
+};
+
+/// Sprite i occupies the square cell [i * cell, (i + 1) * cell) of the
+/// strip, where cell = spriteCell(config) pixels.
+StaticLayer renderStarSprites(const StarSpriteConfig& config);
+int spriteCell(const StarSpriteConfig& config) noexcept;
+
+} // namespace sleepster
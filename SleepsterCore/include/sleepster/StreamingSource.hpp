@@ -0,0 +1,119 @@
+//
+//  StreamingSource.hpp
+//  SleepsterCore
+//
+//  Plays a decoder through a small per-voice ring buffer. A shared
+//  background thread keeps each ring topped up ahead of the render cursor,
+//  so resident memory per voice is bounded by the configured lookahead
+//  rather than by the length of the track. Looping is handled by seeking
+//  the decoder, so the render thread never sees the loop point.
+//
+
+#pragma once
+
+#include "sleepster/AudioSource.hpp"
+#include "sleepster/Decoder.hpp"
+#include "sleepster/Semaphore.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sleepster {
+
+class StreamDecodeWorker;
+
+struct StreamingConfig {
+    /// Seconds of decoded audio buffered ahead of the render cursor.
+    double lookaheadSeconds = 2.0;
+    /// Frames decoded before the voice starts, on the calling thread.
+    double prefillSeconds = 0.25;
+    /// Largest single decode call on the background thread.
+    std::size_t chunkFrames = 4096;
+    bool loop = true;
+};
+
+class StreamingSource final : public AudioSource {
+public:
+    StreamingSource(std::unique_ptr<Decoder> decoder, const StreamingConfig& config);
+    StreamingSource(std::unique_ptr<Decoder> decoder, const StreamingConfig& config,
+                    StreamDecodeWorker& worker);
+    ~StreamingSource() override;
+
+    void prepare(double sampleRate, std::size_t maxBlockFrames) override;
+    std::size_t render(float* left, float* right, std::size_t frames) noexcept override;
+
+    /// Frames of silence inserted because the decoder fell behind.
+    uint64_t underrunFrames() const noexcept { return underrunFrames_.load(std::memory_order_relaxed); }
+    std::size_t capacityFrames() const noexcept { return capacity_; }
+    /// Bytes held by the ring buffer.
+    std::size_t bufferBytes() const noexcept { return 2 * capacity_ * sizeof(float); }
+
+private:
+    friend class StreamDecodeWorker;
+
+    /// Decode thread: tops the ring up. Returns true if any frames were added.
+    bool refill();
+    std::size_t fillLevel() const noexcept;
+
+    std::unique_ptr<Decoder> decoder_;
+    const StreamingConfig config_;
+    StreamDecodeWorker& worker_;
+    bool registered_ = false;
+
+    std::vector<float> left_;
+    std::vector<float> right_;
+    std::size_t capacity_ = 0;
+    std::size_t lowWater_ = 0;
+
+    std::atomic<uint64_t> writeIndex_{0};
+    std::atomic<uint64_t> readIndex_{0};
+    std::atomic<bool> endOfStream_{false};
+    std::atomic<bool> refillRequested_{false};
+    std::atomic<uint64_t> underrunFrames_{0};
+};
+
+/// Background thread shared by all streaming sources. It sleeps on a
+/// semaphore and only wakes when a render callback drains a ring below its
+/// low-water mark.
+class StreamDecodeWorker {
+public:
+    StreamDecodeWorker() = default;
+    ~StreamDecodeWorker();
+
+    StreamDecodeWorker(const StreamDecodeWorker&) = delete;
+    StreamDecodeWorker& operator=(const StreamDecodeWorker&) = delete;
+
+    static StreamDecodeWorker& shared();
+
+    void add(StreamingSource* source);
+    /// Blocks while the worker is refilling, so the source can be destroyed
+    /// safely afterwards.
+    void remove(StreamingSource* source);
+
+    /// Safe from the render thread.
+    void wake() noexcept { wakeup_.signal(); }
+
+    /// CPU time spent decoding on the worker thread.
+    double cpuSeconds() const noexcept;
+
+    /// Number of refill passes; each pass is one wakeup of the thread.
+    uint64_t wakeups() const noexcept { return wakeups_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+
+    std::mutex mutex_;
+    std::vector<StreamingSource*> sources_;
+    Semaphore wakeup_;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    std::atomic<uint64_t> cpuNanos_{0};
+    std::atomic<uint64_t> wakeups_{0};
+};
+
+} // namespace sleepster
@@ -0,0 +1,145 @@
+//
+//  TimerWheel.hpp
+//  SleepsterCore
+//
+//  One scheduler for every timer the app runs. Timers live in a
+//  hierarchical timing wheel (six levels of 64 slots over 1 ms ticks), so
+//  scheduling and cancelling cost O(1) and a jump of hours touches each
+//  level once.
+//
+//  Each timer has a deadline and a tolerance: it may fire anywhere in
+//  [deadline, deadline + tolerance]. The wheel wakes at the earliest moment
+//  some timer's window closes and fires every timer whose deadline has
+//  passed by then, so timers with overlapping windows share one wakeup.
+//  Low-power mode (screen off) stretches the tolerances of all but critical
+//  timers, which merges more of them.
+//
+//  Like the frame pacer, the wheel never reads a clock: callers pass the
+//  time in, and the tests replay a whole night in milliseconds.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace sleepster {
+
+/// Names a scheduled timer; a repeating timer keeps its id across firings.
+/// Ids are never reused while the wheel lives, and 0 names no timer.
+using TimerId = uint64_t;
+constexpr TimerId kNoTimer = 0;
+
+struct TimerSpec {
+    /// Seconds on the caller's clock; never fired before it.
+    double deadline = 0.0;
+    /// Repeat period, or 0 for a one-shot. Repeats stay on the grid of the
+    /// first deadline however late each firing was; a firing later than a
+    /// whole period skips the periods it passed.
+    double interval = 0.0;
+    /// How long after the deadline the timer may fire.
+    double tolerance = 0.0;
+    /// Keeps its tolerance in low-power mode.
+    bool critical = false;
+};
+
+struct TimerWheelConfig {
+    /// Length of one tick, the finest the wheel tells deadlines apart.
+    double tickSeconds = 0.001;
+    /// In low-power mode non-critical tolerances are multiplied by this ...
+    double lowPowerSlackFactor = 8.0;
+    /// ... and are at least this long.
+    double lowPowerMinimumSlack = 1.0;
+};
+
+class TimerWheel {
+public:
+    static constexpr int kLevelBits = 6;
+    static constexpr int kSlotsPerLevel = 1 << kLevelBits;
+    /// 2^36 ticks: two years at 1 ms. Later deadlines are clamped.
+    static constexpr int kLevels = 6;
+
+    explicit TimerWheel(double now = 0.0, const TimerWheelConfig& config = {});
+
+    /// Deadlines already passed fire on the next advance.
+    TimerId schedule(const TimerSpec& spec);
+    /// False when the id names no pending timer (it fired or was
+    /// cancelled).
+    bool cancel(TimerId id) noexcept;
+    bool isScheduled(TimerId id) const noexcept;
+    std::size_t size() const noexcept { return live_; }
+
+    /// When the next wakeup is due: the earliest end of any pending
+    /// timer's window. Infinity when nothing is scheduled.
+    double nextWakeup() const noexcept;
+
+    /// Moves the clock to `now` and fires every timer whose deadline has
+    /// passed, in deadline order. The returned list is reused by the next
+    /// call; repeating timers in it are already rescheduled.
+    const std::vector<TimerId>& advance(double now);
+
+    void setLowPower(bool enabled) noexcept;
+    bool lowPower() const noexcept { return lowPower_; }
+
+    double now() const noexcept { return secondsOf(current_); }
+
+    /// Advances that fired at least one timer.
+    uint64_t wakeupCount() const noexcept { return wakeups_; }
+    uint64_t firedCount() const noexcept { return fired_; }
+    /// Wakeups per hour of clock since construction or resetMetrics.
+    double wakeupsPerHour() const noexcept;
+    void resetMetrics() noexcept;
+
+private:
+    static constexpr uint32_t kNil = std::numeric_limits<uint32_t>::max();
+    static constexpr uint64_t kNever = std::numeric_limits<uint64_t>::max();
+
+    struct Node {
+        uint64_t deadline = 0;
+        uint64_t interval = 0;
+        uint64_t tolerance = 0;
+        uint32_t generation = 0;
+        uint32_t next = kNil;
+        uint32_t prev = kNil;
+        uint16_t slot = 0;
+        bool critical = false;
+        bool live = false;
+    };
+
+    uint64_t ticksUntil(double seconds) const noexcept;
+    double secondsOf(uint64_t tick) const noexcept;
+    uint64_t slackOf(const Node& node) const noexcept;
+
+    void place(uint32_t index) noexcept;
+    void unlink(uint32_t index) noexcept;
+    /// Moves every timer in the slot onto `list` and empties the slot.
+    void detachSlot(int slot, std::vector<uint32_t>& list) noexcept;
+    void release(uint32_t index) noexcept;
+    static TimerId idOf(uint32_t index, uint32_t generation) noexcept;
+
+    TimerWheelConfig config_;
+    double origin_;
+    uint64_t current_ = 0;
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> free_;
+    std::array<uint32_t, kLevels * kSlotsPerLevel> heads_;
+    std::array<uint64_t, kLevels> occupied_{};
+    std::size_t live_ = 0;
+    bool lowPower_ = false;
+
+    mutable uint64_t nextWakeup_ = kNever;
+    mutable bool nextWakeupStale_ = false;
+
+    std::vector<uint32_t> detached_;
+    std::vector<uint32_t> due_;
+    std::vector<TimerId> firedIds_;
+
+    uint64_t wakeups_ = 0;
+    uint64_t fired_ = 0;
+    uint64_t metricsSince_ = 0;
+};
+
+} // namespace sleepster
@@ -0,0 +1,156 @@
+//
+//  Trace.hpp
+//  SleepsterCore
+//
+//  Low-overhead tracing of where time goes, the render thread included.
+//  `SLP_TRACE_SPAN` times the rest of its scope and `SLP_TRACE_COUNTER`
+//  samples a value; each lands as one fixed event in a ring owned by the
+//  calling thread, so recording takes no lock, never allocates and never
+//  waits. Rings keep each thread's newest events, overwriting the oldest,
+//  and are exported on demand as Chrome trace-event JSON, which
+//  chrome://tracing and Perfetto open as one track per thread.
+//
+//  Tracing costs one relaxed load per span while it is off. Built with
+//  SLEEPSTER_TRACING=0, the macros expand to nothing and their arguments
+//  are not evaluated.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifndef SLEEPSTER_TRACING
+#define SLEEPSTER_TRACING 1
+#endif
+
+namespace sleepster {
+
+enum class TraceCategory : uint8_t {
+    Audio = 0,
+    Animation = 1,
+    Storage = 2,
+    App = 3,
+};
+
+enum class TracePhase : uint8_t {
+    /// A span, with its start and duration.
+    Complete = 0,
+    /// A sampled value.
+    Counter = 1,
+};
+
+/// An event as exported. Names are not copied: they must outlive the
+/// trace, as string literals do.
+struct TraceEvent {
+    const char* name = nullptr;
+    TraceCategory category = TraceCategory::App;
+    TracePhase phase = TracePhase::Complete;
+    /// Nanoseconds since tracing was first turned on.
+    uint64_t start = 0;
+    uint64_t duration = 0;
+    double value = 0.0;
+};
+
+/// What one thread's ring held, oldest event first.
+struct TraceThread {
+    uint32_t id = 0;
+    std::string name;
+    std::vector<TraceEvent> events;
+};
+
+struct TraceMetrics {
+    /// Events recorded since the last clear, kept or since overwritten.
+    uint64_t recorded = 0;
+    /// Overwritten by newer events before being exported.
+    uint64_t overwritten = 0;
+    /// Dropped because more than kMaxThreads threads traced.
+    uint64_t untracked = 0;
+};
+
+/// Monotonic nanoseconds, the clock spans are measured with.
+inline uint64_t traceNow() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+/// The process-wide trace. Recording is safe from any thread; the rest is
+/// for control threads.
+class Tracer {
+public:
+    static constexpr std::size_t kMaxThreads = 16;
+    /// Per thread; a power of two.
+    static constexpr std::size_t kEventsPerThread = 8192;
+
+    static bool enabled() noexcept { return enabled_.load(std::memory_order_relaxed); }
+    /// Allocates every thread's ring the first time tracing is turned on.
+    static void setEnabled(bool enabled);
+
+    /// Names the calling thread's track. Takes a lock.
+    static void setThreadName(const char* name);
+
+    // Any thread, without locking or allocating. A thread claims a ring on
+    // its first event; once all are claimed, further threads go untracked.
+    static void complete(TraceCategory category, const char* name, uint64_t start, uint64_t end) noexcept;
+    static void counter(TraceCategory category, const char* name, double value) noexcept;
+
+    /// Copies what every ring holds without stopping the threads writing
+    /// to them; events overwritten during the copy are left out.
+    static std::vector<TraceThread> snapshot();
+    static std::string chromeJson();
+    static bool exportChromeJson(const std::string& path);
+
+    /// Forgets everything recorded so far; thread names are kept.
+    static void clear() noexcept;
+    static TraceMetrics metrics() noexcept;
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+/// Times its own lifetime as a span, if tracing was on when it began.
+class TraceScope {
+public:
+    TraceScope(TraceCategory category, const char* name) noexcept
+        : name_(name), start_(Tracer::enabled() ? traceNow() : 0), category_(category) {}
+
+    ~TraceScope() {
+        if (start_ != 0) Tracer::complete(category_, name_, start_, traceNow());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+    uint64_t start_;
+    TraceCategory category_;
+};
+
+} // namespace sleepster
+
+#define SLP_TRACE_CONCAT_(a, b) a##b
+#define SLP_TRACE_CONCAT(a, b) SLP_TRACE_CONCAT_(a, b)
+
+#if SLEEPSTER_TRACING
+/// Times the rest of the enclosing scope, e.g. SLP_TRACE_SPAN(Audio, "mix.render").
+#define SLP_TRACE_SPAN(category, name)                                                                 \
+    ::sleepster::TraceScope SLP_TRACE_CONCAT(slpTraceScope, __LINE__)(::sleepster::TraceCategory::category, \
+                                                                      name)
+/// Samples `value`, which is only evaluated while tracing is on.
+#define SLP_TRACE_COUNTER(category, name, value)                                                       \
+    do {                                                                                               \
+        if (::sleepster::Tracer::enabled()) {                                                          \
+            ::sleepster::Tracer::counter(::sleepster::TraceCategory::category, name,                  \
+                                         static_cast<double>(value));                                 \
+        }                                                                                              \
+    } while (0)
+#else
+#define SLP_TRACE_SPAN(category, name) static_cast<void>(0)
+#define SLP_TRACE_COUNTER(category, name, value) static_cast<void>(0)
+#endif
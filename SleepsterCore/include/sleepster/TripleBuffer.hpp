@@ -0,0 +1,61 @@
+//
+//  TripleBuffer.hpp
+//  SleepsterCore
+//
+//  Latest-value mailbox between one writer and one reader. The writer fills
+//  a private back buffer and publishes it with a single atomic exchange; the
+//  reader picks up the newest published value the same way. Neither side
+//  waits, and intermediate values the reader never saw are simply skipped,
+//  which is what parameter snapshots (EQ curves, effect settings) want.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace sleepster {
+
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    explicit TripleBuffer(const T& initial) { buffers_.fill(initial); }
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // MARK: - Writer
+
+    /// Buffer the writer may fill before calling publish().
+    T& back() noexcept { return buffers_[back_]; }
+
+    void publish() noexcept {
+        const uint8_t previous = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel);
+        back_ = previous & kIndexMask;
+    }
+
+    // MARK: - Reader
+
+    /// Takes the newest published value, if there is one since the last call.
+    bool update() noexcept {
+        if (!(middle_.load(std::memory_order_relaxed) & kFresh)) return false;
+        const uint8_t previous = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = previous & kIndexMask;
+        return true;
+    }
+
+    const T& front() const noexcept { return buffers_[front_]; }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;
+
+    std::array<T, 3> buffers_{};
+    uint8_t back_ = 0;
+    std::atomic<uint8_t> middle_{1};
+    uint8_t front_ = 2;
+};
+
+} // namespace sleepster
@@ -0,0 +1,67 @@
+//
+//  WavFile.hpp
+//  SleepsterCore
+//
+//  RIFF/WAVE support: a memory-mapped streaming decoder for 16/24-bit PCM
+//  and 32-bit float files, plus a simple writer used by tools and tests.
+//
+
+#pragma once
+
+#include "sleepster/Decoder.hpp"
+#include "sleepster/MappedFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace sleepster {
+
+struct WavFormat {
+    enum class Encoding : uint8_t { Pcm16, Pcm24, Float32 };
+
+    Encoding encoding = Encoding::Pcm16;
+    uint32_t channelCount = 0;
+    double sampleRate = 0.0;
+    uint64_t frameCount = 0;
+    /// Offset and length of the sample data inside the file.
+    std::size_t dataOffset = 0;
+    std::size_t dataSize = 0;
+
+    uint32_t bytesPerFrame() const noexcept;
+
+    /// Parses the RIFF header of an in-memory file.
+    static bool parse(const uint8_t* bytes, std::size_t size, WavFormat& out);
+};
+
+class WavDecoder final : public Decoder {
+public:
+    /// Returns nullptr if the file is missing or not a supported WAV.
+    static std::unique_ptr<WavDecoder> open(const std::string& path);
+
+    double sampleRate() const noexcept override { return format_.sampleRate; }
+    uint64_t frameCount() const noexcept override { return format_.frameCount; }
+    const WavFormat& format() const noexcept { return format_; }
+
+    std::size_t decode(float* left, float* right, std::size_t frames) override;
+    bool seek(uint64_t frame) override;
+
+private:
+    WavDecoder(MappedFile file, const WavFormat& format);
+
+    void releaseConsumedPages(uint64_t upToFrame) noexcept;
+
+    MappedFile file_;
+    WavFormat format_;
+    uint64_t cursor_ = 0;
+    /// Frames before this point have had their pages dropped.
+    uint64_t releasedUpTo_ = 0;
+};
+
+/// Writes planar float channels (1 or 2) as a WAV file. `encoding` selects
+/// 16-bit PCM or 32-bit float output.
+bool writeWav(const std::string& path, const float* const* channels, uint32_t channelCount,
+              uint64_t frameCount, double sampleRate,
+              WavFormat::Encoding encoding = WavFormat::Encoding::Float32);
+
+} // namespace sleepster
@@ -0,0 +1,70 @@
+//
+//  WorkStealingPool.hpp
+//  SleepsterCore
+//
+//  Fixed set of worker threads, each with its own job queue. A job
+//  submitted from a worker goes to that worker's queue and is run last in,
+//  first out, so follow-up work stays on the thread whose caches are warm;
+//  a worker that runs dry takes the oldest job of another before it sleeps.
+//  Each queue has its own lock, held only to push or pop, so workers
+//  rarely contend. Not for the render thread: submitting allocates.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sleepster {
+
+class WorkStealingPool {
+public:
+    using Job = std::function<void()>;
+
+    /// 0 threads means one per core but the caller's, and at least one.
+    explicit WorkStealingPool(std::size_t threads = 0);
+    /// Runs every job already submitted, then joins the workers.
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /// Any thread.
+    void submit(Job job);
+
+    std::size_t threadCount() const noexcept { return workers_.size(); }
+    /// The calling thread's index in this pool, or -1 if it is not one of
+    /// its workers.
+    int currentWorker() const noexcept;
+    /// Jobs a worker took from another's queue.
+    uint64_t steals() const noexcept { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    struct Worker {
+        std::mutex lock;
+        std::deque<Job> jobs;
+        std::thread thread;
+    };
+
+    void run(std::size_t index);
+    bool take(std::size_t index, Job& job);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    /// Guards sleeping and stopping_; jobs are counted in pending_.
+    std::mutex sleepLock_;
+    std::condition_variable wake_;
+    std::atomic<std::size_t> pending_{0};
+    std::atomic<std::size_t> nextQueue_{0};
+    std::atomic<uint64_t> steals_{0};
+    bool stopping_ = false;
+};
+
+} // namespace sleepster
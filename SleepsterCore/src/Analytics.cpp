@@ -0,0 +1,376 @@
+//
+//  Analytics.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/Analytics.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace sleepster {
+
+namespace {
+
+uint64_t steadyNanos() noexcept {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+double wallSeconds() noexcept {
+    return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void appendFormat(std::string& out, const char* format, double value) {
+    char buffer[32];
+    const int length = std::snprintf(buffer, sizeof buffer, format, value);
+    if (length > 0) out.append(buffer, static_cast<std::size_t>(std::min<int>(length, sizeof buffer - 1)));
+}
+
+void appendInteger(std::string& out, int64_t value) {
+    char buffer[24];
+    const int length = std::snprintf(buffer, sizeof buffer, "%" PRId64, value);
+    if (length > 0) out.append(buffer, static_cast<std::size_t>(length));
+}
+
+void appendString(std::string& out, std::string_view text) {
+    out += '"';
+    for (const char c : text) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof escaped, "\\u%04x", static_cast<unsigned>(c));
+                out += escaped;
+            } else {
+                out += c;
+            }
+        }
+    }
+    out += '"';
+}
+
+void appendParameters(std::string& out, const AnalyticsNames& names, const AnalyticsParameter* parameters,
+                      std::size_t count) {
+    if (count == 0) return;
+    out += ",\"params\":{";
+    for (std::size_t i = 0; i < count; ++i) {
+        const AnalyticsParameter& parameter = parameters[i];
+        if (i > 0) out += ',';
+        appendString(out, names.name(parameter.key));
+        out += ':';
+        switch (parameter.type) {
+        case AnalyticsValueType::Integer: appendInteger(out, parameter.integer); break;
+        case AnalyticsValueType::Number: appendFormat(out, "%.9g", parameter.number); break;
+        case AnalyticsValueType::Name: appendString(out, names.name(parameter.name)); break;
+        }
+    }
+    out += '}';
+}
+
+bool writeAll(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        const ssize_t written = ::write(fd, data, size);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
+// MARK: - AnalyticsParameter
+
+AnalyticsParameter AnalyticsParameter::of(AnalyticsName key, int64_t value) noexcept {
+    AnalyticsParameter parameter;
+    parameter.key = key;
+    parameter.type = AnalyticsValueType::Integer;
+    parameter.integer = value;
+    return parameter;
+}
+
+AnalyticsParameter AnalyticsParameter::of(AnalyticsName key, double value) noexcept {
+    AnalyticsParameter parameter;
+    parameter.key = key;
+    parameter.type = AnalyticsValueType::Number;
+    parameter.number = value;
+    return parameter;
+}
+
+AnalyticsParameter AnalyticsParameter::named(AnalyticsName key, AnalyticsName value) noexcept {
+    AnalyticsParameter parameter;
+    parameter.key = key;
+    parameter.type = AnalyticsValueType::Name;
+    parameter.name = value;
+    return parameter;
+}
+
+// MARK: - AnalyticsNames
+
+AnalyticsNames::AnalyticsNames(std::size_t capacity)
+    : capacity_(std::min<std::size_t>(capacity, kNoAnalyticsName)), names_(new std::string[capacity_]) {
+    ids_.reserve(capacity_);
+}
+
+AnalyticsName AnalyticsNames::intern(std::string_view name) {
+    if (name.empty()) return kNoAnalyticsName;
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::string key(name);
+    const auto found = ids_.find(key);
+    if (found != ids_.end()) return found->second;
+
+    const std::size_t count = count_.load(std::memory_order_relaxed);
+    if (count == capacity_) return kNoAnalyticsName;
+    names_[count] = key;
+    const auto id = static_cast<AnalyticsName>(count);
+    ids_.emplace(key, id);
+    count_.store(count + 1, std::memory_order_release);
+    return id;
+}
+
+std::string_view AnalyticsNames::name(AnalyticsName id) const noexcept {
+    return id < size() ? std::string_view(names_[id]) : std::string_view();
+}
+
+// MARK: - AnalyticsFileSink
+
+std::unique_ptr<AnalyticsFileSink> AnalyticsFileSink::open(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) return nullptr;
+    return std::unique_ptr<AnalyticsFileSink>(new AnalyticsFileSink(fd));
+}
+
+AnalyticsFileSink::~AnalyticsFileSink() {
+    ::close(fd_);
+}
+
+bool AnalyticsFileSink::write(const AnalyticsBatch& batch) {
+    const AnalyticsNames& names = *batch.names;
+    text_.clear();
+    for (std::size_t i = 0; i < batch.recordCount; ++i) {
+        const AnalyticsRecord& record = batch.records[i];
+        text_ += "{\"time\":";
+        appendFormat(text_, "%.3f", batch.wallTime(record.time));
+        text_ += record.kind == AnalyticsKind::Error ? ",\"error\":" : ",\"event\":";
+        appendString(text_, names.name(record.name));
+        appendParameters(text_, names, record.parameters, record.parameterCount);
+        text_ += "}\n";
+    }
+    for (std::size_t i = 0; i < batch.timingCount; ++i) {
+        const AnalyticsTiming& timing = batch.timings[i];
+        text_ += "{\"time\":";
+        appendFormat(text_, "%.3f", batch.now);
+        text_ += ",\"timed\":";
+        appendString(text_, names.name(timing.event));
+        text_ += ",\"count\":";
+        appendInteger(text_, timing.count);
+        text_ += ",\"total\":";
+        appendFormat(text_, "%.3f", timing.totalSeconds);
+        text_ += ",\"min\":";
+        appendFormat(text_, "%.3f", timing.minSeconds);
+        text_ += ",\"max\":";
+        appendFormat(text_, "%.3f", timing.maxSeconds);
+        appendParameters(text_, names, timing.parameters, timing.parameterCount);
+        text_ += "}\n";
+    }
+    if (batch.dropped > 0) {
+        text_ += "{\"time\":";
+        appendFormat(text_, "%.3f", batch.now);
+        text_ += ",\"dropped\":";
+        appendInteger(text_, static_cast<int64_t>(batch.dropped));
+        text_ += "}\n";
+    }
+    return writeAll(fd_, text_.data(), text_.size());
+}
+
+// MARK: - AnalyticsPipeline
+
+AnalyticsPipeline::AnalyticsPipeline(std::unique_ptr<AnalyticsSink> sink, const AnalyticsConfig& config)
+    : config_(config),
+      names_(config.nameCapacity),
+      sink_(std::move(sink)),
+      queue_(config.capacity),
+      wakeEvery_(queue_.capacity() / 2),
+      messageKey_(names_.intern("message")),
+      epoch_(wallSeconds() - static_cast<double>(steadyNanos()) * 1e-9) {
+    records_.reserve(queue_.capacity());
+    timings_.resize(names_.capacity());
+    ended_.reserve(names_.capacity());
+    endedTimings_.reserve(names_.capacity());
+    thread_ = std::thread([this] { run(); });
+}
+
+AnalyticsPipeline::~AnalyticsPipeline() {
+    running_.store(false, std::memory_order_release);
+    wakeup_.signal();
+    if (thread_.joinable()) thread_.join();
+    flush();
+}
+
+bool AnalyticsPipeline::logEvent(AnalyticsName event, const AnalyticsParameter* parameters,
+                                 std::size_t count) noexcept {
+    return enqueue(AnalyticsKind::Event, event, parameters, count);
+}
+
+bool AnalyticsPipeline::beginTimedEvent(AnalyticsName event, const AnalyticsParameter* parameters,
+                                        std::size_t count) noexcept {
+    return enqueue(AnalyticsKind::TimedBegin, event, parameters, count);
+}
+
+bool AnalyticsPipeline::endTimedEvent(AnalyticsName event, const AnalyticsParameter* parameters,
+                                      std::size_t count) noexcept {
+    return enqueue(AnalyticsKind::TimedEnd, event, parameters, count);
+}
+
+bool AnalyticsPipeline::logError(AnalyticsName error, AnalyticsName message) noexcept {
+    if (message == kNoAnalyticsName) return enqueue(AnalyticsKind::Error, error, nullptr, 0);
+    const AnalyticsParameter parameter = AnalyticsParameter::named(messageKey_, message);
+    return enqueue(AnalyticsKind::Error, error, &parameter, 1);
+}
+
+bool AnalyticsPipeline::enqueue(AnalyticsKind kind, AnalyticsName name, const AnalyticsParameter* parameters,
+                                std::size_t count) noexcept {
+    if (!enabled_.load(std::memory_order_relaxed) || name == kNoAnalyticsName) return false;
+
+    AnalyticsRecord record;
+    record.time = steadyNanos();
+    record.name = name;
+    record.kind = kind;
+    record.parameterCount = static_cast<uint8_t>(std::min(count, AnalyticsRecord::kMaxParameters));
+    for (std::size_t i = 0; i < record.parameterCount; ++i) record.parameters[i] = parameters[i];
+
+    std::size_t position;
+    if (!queue_.tryPush(record, position)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    // The push that fills the ring halfway since the last wakeup sends
+    // the flusher off early; every other push leaves it asleep.
+    if (((position + 1) & (wakeEvery_ - 1)) == 0) wakeup_.signal();
+    return true;
+}
+
+void AnalyticsPipeline::flush() {
+    std::lock_guard<std::mutex> lock(drainMutex_);
+    drain();
+}
+
+AnalyticsMetrics AnalyticsPipeline::metrics() const noexcept {
+    AnalyticsMetrics metrics;
+    metrics.written = written_.load(std::memory_order_relaxed);
+    metrics.dropped = dropped_.load(std::memory_order_relaxed);
+    metrics.batches = batches_.load(std::memory_order_relaxed);
+    metrics.failedBatches = failedBatches_.load(std::memory_order_relaxed);
+    return metrics;
+}
+
+void AnalyticsPipeline::run() {
+    const auto intervalMs = static_cast<int64_t>(config_.flushIntervalSeconds * 1000.0);
+    while (running_.load(std::memory_order_acquire)) {
+        wakeup_.wait(intervalMs);
+        if (!running_.load(std::memory_order_acquire)) break;
+        std::lock_guard<std::mutex> lock(drainMutex_);
+        drain();
+    }
+}
+
+void AnalyticsPipeline::drain() {
+    // At most one ring's worth per batch, so producers that keep up with
+    // the drain cannot hold it here forever.
+    AnalyticsRecord record;
+    for (;;) {
+        bool more = false;
+        for (std::size_t popped = 0; popped < queue_.capacity(); ++popped) {
+            if (!queue_.tryPop(record)) break;
+            more = popped + 1 == queue_.capacity();
+            if (record.kind == AnalyticsKind::TimedBegin || record.kind == AnalyticsKind::TimedEnd) {
+                fold(record);
+            } else {
+                records_.push_back(record);
+            }
+        }
+        writeBatch();
+        if (!more) return;
+    }
+}
+
+void AnalyticsPipeline::fold(const AnalyticsRecord& record) {
+    if (record.name >= timings_.size()) return;
+    Timing& timing = timings_[record.name];
+    if (record.kind == AnalyticsKind::TimedBegin) {
+        timing.startedAt = record.time;
+        timing.running = true;
+        timing.ended.parameterCount = record.parameterCount;
+        std::copy_n(record.parameters, record.parameterCount, timing.ended.parameters);
+        return;
+    }
+    if (!timing.running) return;
+    timing.running = false;
+
+    AnalyticsTiming& ended = timing.ended;
+    const double seconds = static_cast<double>(record.time - timing.startedAt) * 1e-9;
+    if (ended.count == 0) {
+        ended.event = record.name;
+        ended.minSeconds = seconds;
+        ended.maxSeconds = seconds;
+        ended_.push_back(record.name);
+    }
+    ++ended.count;
+    ended.totalSeconds += seconds;
+    ended.minSeconds = std::min(ended.minSeconds, seconds);
+    ended.maxSeconds = std::max(ended.maxSeconds, seconds);
+    if (record.parameterCount > 0) {
+        ended.parameterCount = record.parameterCount;
+        std::copy_n(record.parameters, record.parameterCount, ended.parameters);
+    }
+}
+
+void AnalyticsPipeline::writeBatch() {
+    endedTimings_.clear();
+    for (const AnalyticsName name : ended_) {
+        AnalyticsTiming& ended = timings_[name].ended;
+        endedTimings_.push_back(ended);
+        ended.count = 0;
+        ended.totalSeconds = 0.0;
+    }
+    ended_.clear();
+
+    const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    AnalyticsBatch batch;
+    batch.names = &names_;
+    batch.records = records_.data();
+    batch.recordCount = records_.size();
+    batch.timings = endedTimings_.data();
+    batch.timingCount = endedTimings_.size();
+    batch.dropped = dropped - droppedReported_;
+    batch.epoch = epoch_;
+    batch.now = wallSeconds();
+    droppedReported_ = dropped;
+
+    if (batch.recordCount > 0 || batch.timingCount > 0 || batch.dropped > 0) {
+        const bool stored = sink_ && sink_->write(batch);
+        batches_.fetch_add(1, std::memory_order_relaxed);
+        if (stored) {
+            uint64_t runs = 0;
+            for (const AnalyticsTiming& timing : endedTimings_) runs += timing.count;
+            written_.fetch_add(batch.recordCount + runs, std::memory_order_relaxed);
+        } else {
+            failedBatches_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    records_.clear();
+}
+
+} // namespace sleepster
@@ -0,0 +1,210 @@
+//
+//  AssetPack.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/AssetPack.hpp"
+
+#include "sleepster/Simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "Packed samples are read in place, which assumes a little-endian host"
+#endif
+
+namespace sleepster {
+
+namespace {
+
+uint16_t readU16(const uint8_t* p) noexcept {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t readU32(const uint8_t* p) noexcept {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint64_t readU64(const uint8_t* p) noexcept {
+    return static_cast<uint64_t>(readU32(p)) | (static_cast<uint64_t>(readU32(p + 4)) << 32);
+}
+
+float readF32(const uint8_t* p) noexcept {
+    const uint32_t bits = readU32(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+constexpr float kSampleScale = 1.0f / 32768.0f;
+
+} // namespace
+
+std::shared_ptr<const AssetPack> AssetPack::open(const std::string& path) {
+    MappedFile file;
+    if (!file.open(path)) return nullptr;
+    std::shared_ptr<AssetPack> pack(new AssetPack(std::move(file)));
+    if (!pack->parse()) return nullptr;
+    return pack;
+}
+
+bool AssetPack::parse() {
+    using namespace assetpack;
+    const uint8_t* bytes = file_.data();
+    const std::size_t size = file_.size();
+    if (size < kHeaderSize || std::memcmp(bytes, kMagic, 4) != 0 || readU32(bytes + 4) != kVersion) {
+        return false;
+    }
+    const uint32_t rate = readU32(bytes + 8);
+    const uint32_t count = readU32(bytes + 12);
+    const uint64_t indexOffset = readU64(bytes + 16);
+    // A short file means an interrupted write.
+    if (rate == 0 || readU64(bytes + 24) != size) return false;
+    if (indexOffset > size || count > (size - indexOffset) / kEntrySize) return false;
+    sampleRate_ = rate;
+
+    entries_.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint8_t* entry = bytes + indexOffset + i * kEntrySize;
+        const auto* name = reinterpret_cast<const char*>(entry);
+        Entry parsed;
+        parsed.name.assign(name, strnlen(name, kNameBytes));
+        const uint64_t dataOffset = readU64(entry + 64);
+        AssetView& view = parsed.view;
+        view.frameCount = readU32(entry + 72);
+        view.loopStart = readU32(entry + 76);
+        view.loopEnd = readU32(entry + 80);
+        view.channelCount = readU16(entry + 84);
+        const uint16_t encoding = readU16(entry + 86);
+        view.loudness = readF32(entry + 88);
+        view.peak = readF32(entry + 92);
+        view.sampleRate = rate;
+
+        if (parsed.name.empty() || encoding != static_cast<uint16_t>(Encoding::Pcm16)) return false;
+        if (view.channelCount < 1 || view.channelCount > 2 || dataOffset % kDataAlignment != 0) return false;
+        const uint64_t bytesNeeded = uint64_t(view.frameCount) * view.channelCount * sizeof(int16_t);
+        if (dataOffset > size || bytesNeeded > size - dataOffset) return false;
+        if (view.loopStart >= view.loopEnd || view.loopEnd > view.frameCount) return false;
+        // find() relies on the order.
+        if (!entries_.empty() && !(entries_.back().name < parsed.name)) return false;
+
+        view.samples = reinterpret_cast<const int16_t*>(bytes + dataOffset);
+        entries_.push_back(std::move(parsed));
+    }
+    return true;
+}
+
+const AssetView* AssetPack::find(const char* name) const noexcept {
+    const auto it = std::lower_bound(entries_.begin(), entries_.end(), name,
+                                     [](const Entry& entry, const char* key) { return entry.name < key; });
+    if (it == entries_.end() || it->name != name) return nullptr;
+    return &it->view;
+}
+
+// MARK: - PackedSource
+
+PackedSource::PackedSource(std::shared_ptr<const AssetPack> pack, const AssetView& view, bool loop)
+    : pack_(std::move(pack)), view_(view), loop_(loop) {}
+
+void PackedSource::prepare(double sampleRate, std::size_t maxBlockFrames) {
+    step_ = sampleRate > 0.0 ? view_.sampleRate / sampleRate : 1.0;
+}
+
+bool PackedSource::seek(uint64_t frame) {
+    const uint32_t end = endFrame();
+    const uint32_t loopLength = view_.loopEnd - view_.loopStart;
+    if (step_ == 1.0) {
+        if (frame < end) {
+            cursor_ = static_cast<uint32_t>(frame);
+        } else {
+            cursor_ = loop_ ? view_.loopStart + static_cast<uint32_t>((frame - view_.loopStart) % loopLength) : end;
+        }
+        return true;
+    }
+    position_ = static_cast<double>(frame) * step_;
+    if (position_ >= static_cast<double>(end)) {
+        position_ = loop_ ? view_.loopStart + std::fmod(position_ - view_.loopStart, static_cast<double>(loopLength))
+                          : static_cast<double>(end);
+    }
+    return true;
+}
+
+std::size_t PackedSource::render(float* left, float* right, std::size_t frames) noexcept {
+    if (view_.frameCount == 0) return 0;
+    return step_ == 1.0 ? renderDirect(left, right, frames) : renderResampled(left, right, frames);
+}
+
+std::size_t PackedSource::renderDirect(float* left, float* right, std::size_t frames) noexcept {
+    using namespace simd;
+    const uint32_t end = endFrame();
+    std::size_t written = 0;
+    while (written < frames) {
+        if (cursor_ >= end) {
+            if (!loop_) break;
+            cursor_ = view_.loopStart;
+        }
+        const std::size_t chunk = std::min<std::size_t>(frames - written, end - cursor_);
+        float* outL = left + written;
+        float* outR = right + written;
+
+        if (view_.channelCount == 2) {
+            // A stereo frame is one little-endian word, left in the low half.
+            // Shifting or masking each half to the top turns it into a
+            // signed 32-bit value 65536 times the sample.
+            const auto* words = reinterpret_cast<const uint32_t*>(view_.samples) + cursor_;
+            const f32x4 scale = splat(kSampleScale / 65536.0f);
+            const u32x4 highMask = splatU32(0xFFFF0000u);
+            std::size_t i = 0;
+            for (; i + kWidth <= chunk; i += kWidth) {
+                const u32x4 v = loadU32(words + i);
+                store(outL + i, mul(toFloatSigned(shiftLeft<16>(v)), scale));
+                store(outR + i, mul(toFloatSigned(bitAnd(v, highMask)), scale));
+            }
+            const int16_t* src = view_.samples + 2 * (cursor_ + i);
+            for (; i < chunk; ++i, src += 2) {
+                outL[i] = src[0] * kSampleScale;
+                outR[i] = src[1] * kSampleScale;
+            }
+        } else {
+            const int16_t* src = view_.samples + cursor_;
+            for (std::size_t i = 0; i < chunk; ++i) outL[i] = src[i] * kSampleScale;
+            std::memcpy(outR, outL, chunk * sizeof(float));
+        }
+
+        cursor_ += static_cast<uint32_t>(chunk);
+        written += chunk;
+    }
+    return written;
+}
+
+std::size_t PackedSource::renderResampled(float* left, float* right, std::size_t frames) noexcept {
+    const int16_t* samples = view_.samples;
+    const uint32_t channels = view_.channelCount;
+    const uint32_t rightChannel = channels > 1 ? 1 : 0;
+    const uint32_t endIndex = endFrame();
+    const double end = static_cast<double>(endIndex);
+    const double loopLength = static_cast<double>(view_.loopEnd - view_.loopStart);
+
+    std::size_t written = 0;
+    for (; written < frames; ++written) {
+        if (position_ >= end) {
+            if (!loop_) break;
+            position_ -= loopLength;
+        }
+        const auto i0 = static_cast<uint32_t>(position_);
+        // Past the last frame the interpolator reads the loop start.
+        const uint32_t i1 = i0 + 1 < endIndex ? i0 + 1 : (loop_ ? view_.loopStart : i0);
+        const float frac = static_cast<float>(position_ - static_cast<double>(i0));
+        const float l0 = samples[i0 * channels], l1 = samples[i1 * channels];
+        const float r0 = samples[i0 * channels + rightChannel], r1 = samples[i1 * channels + rightChannel];
+        left[written] = (l0 + (l1 - l0) * frac) * kSampleScale;
+        right[written] = (r0 + (r1 - r0) * frac) * kSampleScale;
+        position_ += step_;
+    }
+    return written;
+}
+
+} // namespace sleepster
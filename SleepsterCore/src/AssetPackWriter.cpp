@@ -0,0 +1,363 @@
+//
+//  AssetPackWriter.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/AssetPackWriter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace sleepster {
+
+namespace {
+
+// MARK: - Resampling
+
+/// Zero crossings of the sinc on each side of the centre tap.
+constexpr double kSincZeroCrossings = 32.0;
+/// Passband edge as a share of the lower Nyquist frequency.
+constexpr double kSincCutoff = 0.95;
+/// Kernel table entries per input sample.
+constexpr std::size_t kKernelSteps = 512;
+
+/// The windowed-sinc kernel sampled from 0 to its half width, in input
+/// samples, so the inner loop interpolates instead of calling sin().
+struct SincKernel {
+    double cutoff;
+    double halfWidth;
+    std::vector<double> table;
+
+    explicit SincKernel(double cutoff)
+        : cutoff(cutoff), halfWidth(kSincZeroCrossings / cutoff) {
+        const auto size = static_cast<std::size_t>(std::ceil(halfWidth * kKernelSteps)) + 2;
+        table.resize(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            const double t = static_cast<double>(i) / kKernelSteps;
+            if (t >= halfWidth) {
+                table[i] = 0.0;
+                continue;
+            }
+            const double x = M_PI * cutoff * t;
+            const double sinc = t == 0.0 ? 1.0 : std::sin(x) / x;
+            // Blackman window over [-halfWidth, halfWidth].
+            const double phase = M_PI * (t / halfWidth + 1.0);
+            const double window = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+            table[i] = cutoff * sinc * window;
+        }
+    }
+
+    double at(double t) const noexcept {
+        const double position = std::fabs(t) * kKernelSteps;
+        const auto i = static_cast<std::size_t>(position);
+        if (i + 1 >= table.size()) return 0.0;
+        const double frac = position - static_cast<double>(i);
+        return table[i] + (table[i + 1] - table[i]) * frac;
+    }
+};
+
+// MARK: - Loudness
+
+struct BiquadDouble {
+    double b0, b1, b2, a1, a2;
+    double z1 = 0.0, z2 = 0.0;
+
+    double process(double x) noexcept {
+        const double y = b0 * x + z1;
+        z1 = b1 * x - a1 * y + z2;
+        z2 = b2 * x - a2 * y;
+        return y;
+    }
+};
+
+/// BS.1770 pre-filter: a high shelf modelling the head, then the RLB
+/// high-pass. Designed from their analogue prototypes so any rate works.
+void kWeighting(double sampleRate, BiquadDouble& shelf, BiquadDouble& highPass) {
+    {
+        const double f0 = 1681.974450955533;
+        const double gainDb = 3.999843853973347;
+        const double q = 0.7071752369554196;
+        const double k = std::tan(M_PI * f0 / sampleRate);
+        const double vh = std::pow(10.0, gainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+        shelf = {(vh + vb * k / q + k * k) / a0, 2.0 * (k * k - vh) / a0, (vh - vb * k / q + k * k) / a0,
+                 2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0};
+    }
+    {
+        const double f0 = 38.13547087602444;
+        const double q = 0.5003270373238773;
+        const double k = std::tan(M_PI * f0 / sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+        highPass = {1.0, -2.0, 1.0, 2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0};
+    }
+}
+
+constexpr double kAbsoluteGateLufs = -70.0;
+
+double lufsOf(double meanSquare) {
+    return -0.691 + 10.0 * std::log10(std::max(meanSquare, 1e-30));
+}
+
+// MARK: - Encoding
+
+/// Below half a 16-bit step, i.e. digital silence once quantised.
+constexpr float kSilence = 0.5f / 32768.0f;
+
+/// Frames compared when matching the loop end against the loop start.
+constexpr std::size_t kLoopMatchFrames = 64;
+
+/// Finds the frame to wrap at: the one whose next kLoopMatchFrames frames
+/// best repeat the first frames of the loop, so the jump is inaudible.
+uint32_t findLoopEnd(const std::vector<std::vector<float>>& channels, std::size_t frames,
+                     std::size_t searchFrames) {
+    const std::size_t window = std::min(kLoopMatchFrames, frames / 4);
+    if (window == 0 || frames < 4 * window) return static_cast<uint32_t>(frames);
+
+    const std::size_t last = frames - window;
+    const std::size_t first = last > searchFrames ? std::max(last - searchFrames, frames / 2) : frames / 2;
+    std::size_t best = frames;
+    double bestCost = 1e300;
+    for (std::size_t end = first; end <= last; ++end) {
+        double cost = 0.0;
+        for (const std::vector<float>& channel : channels) {
+            for (std::size_t k = 0; k < window && cost < bestCost; ++k) {
+                const double d = double(channel[end + k]) - channel[k];
+                // Early frames matter most: they are heard right at the join.
+                cost += d * d * double(window - k);
+            }
+        }
+        if (cost < bestCost) {
+            bestCost = cost;
+            best = end;
+        }
+    }
+    return static_cast<uint32_t>(best);
+}
+
+void putU16(std::vector<uint8_t>& out, std::size_t at, uint16_t v) {
+    out[at] = static_cast<uint8_t>(v);
+    out[at + 1] = static_cast<uint8_t>(v >> 8);
+}
+
+void putU32(std::vector<uint8_t>& out, std::size_t at, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out[at + i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+void putU64(std::vector<uint8_t>& out, std::size_t at, uint64_t v) {
+    putU32(out, at, static_cast<uint32_t>(v));
+    putU32(out, at + 4, static_cast<uint32_t>(v >> 32));
+}
+
+void putF32(std::vector<uint8_t>& out, std::size_t at, float v) {
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    putU32(out, at, bits);
+}
+
+std::size_t alignUp(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+std::vector<float> resampleOffline(const std::vector<float>& input, double fromRate, double toRate) {
+    if (fromRate == toRate || input.empty() || fromRate <= 0.0 || toRate <= 0.0) return input;
+
+    const double ratio = toRate / fromRate;
+    // Downsampling moves the cutoff below the output's Nyquist frequency.
+    const SincKernel kernel(kSincCutoff * std::min(1.0, ratio));
+    const auto outputFrames = static_cast<std::size_t>(std::floor(static_cast<double>(input.size()) * ratio));
+    const auto last = static_cast<long long>(input.size()) - 1;
+
+    std::vector<float> output(outputFrames);
+    for (std::size_t j = 0; j < outputFrames; ++j) {
+        const double centre = static_cast<double>(j) / ratio;
+        const long long begin = std::max(0LL, static_cast<long long>(std::ceil(centre - kernel.halfWidth)));
+        const long long end = std::min(last, static_cast<long long>(std::floor(centre + kernel.halfWidth)));
+        double sum = 0.0;
+        for (long long k = begin; k <= end; ++k) sum += input[static_cast<std::size_t>(k)] * kernel.at(centre - k);
+        output[j] = static_cast<float>(sum);
+    }
+    return output;
+}
+
+double integratedLoudness(const float* const* channels, uint32_t channelCount, std::size_t frameCount,
+                          double sampleRate) {
+    if (channelCount == 0 || frameCount == 0 || sampleRate <= 0.0) return kAbsoluteGateLufs;
+
+    // K-weighted squares, summed over channels (front channels weigh 1).
+    std::vector<double> power(frameCount, 0.0);
+    for (uint32_t c = 0; c < channelCount; ++c) {
+        BiquadDouble shelf{}, highPass{};
+        kWeighting(sampleRate, shelf, highPass);
+        for (std::size_t i = 0; i < frameCount; ++i) {
+            const double y = highPass.process(shelf.process(channels[c][i]));
+            power[i] += y * y;
+        }
+    }
+
+    // 400 ms blocks overlapping by 75%; a shorter sound is one block.
+    const auto blockFrames = std::min(frameCount, static_cast<std::size_t>(0.4 * sampleRate));
+    const auto hop = std::max<std::size_t>(1, blockFrames / 4);
+    std::vector<double> blocks;
+    for (std::size_t start = 0; start + blockFrames <= frameCount; start += hop) {
+        double sum = 0.0;
+        for (std::size_t i = start; i < start + blockFrames; ++i) sum += power[i];
+        blocks.push_back(sum / static_cast<double>(blockFrames));
+    }
+
+    const auto gatedMean = [&](double gateLufs, std::size_t& count) {
+        double sum = 0.0;
+        count = 0;
+        for (double block : blocks) {
+            if (lufsOf(block) > gateLufs) {
+                sum += block;
+                ++count;
+            }
+        }
+        return count > 0 ? sum / static_cast<double>(count) : 0.0;
+    };
+    std::size_t count = 0;
+    const double absoluteMean = gatedMean(kAbsoluteGateLufs, count);
+    if (count == 0) return kAbsoluteGateLufs;
+    const double relativeGate = lufsOf(absoluteMean) - 10.0;
+    const double mean = gatedMean(std::max(kAbsoluteGateLufs, relativeGate), count);
+    return count > 0 ? lufsOf(mean) : kAbsoluteGateLufs;
+}
+
+bool encodeAsset(const std::string& name, const PcmBuffer& buffer, const AssetPackOptions& options,
+                 EncodedAsset& out) {
+    if (name.empty() || name.size() >= assetpack::kNameBytes) return false;
+    if (buffer.channels.empty() || buffer.channels.size() > 2 || buffer.frameCount == 0) return false;
+
+    std::vector<std::vector<float>> channels;
+    for (const std::vector<float>& channel : buffer.channels) {
+        std::vector<float> source(channel.begin(), channel.begin() + buffer.frameCount);
+        channels.push_back(resampleOffline(source, buffer.sampleRate, options.sampleRate));
+    }
+    const std::size_t frames = channels[0].size();
+
+    // Trim the encoder's silent padding at both ends.
+    std::size_t first = frames, last = 0;
+    for (const std::vector<float>& channel : channels) {
+        for (std::size_t i = 0; i < frames; ++i) {
+            if (std::fabs(channel[i]) > kSilence) {
+                first = std::min(first, i);
+                last = std::max(last, i + 1);
+            }
+        }
+    }
+    if (first >= last || last - first > UINT32_MAX) return false;
+    for (std::vector<float>& channel : channels) {
+        channel.erase(channel.begin() + last, channel.end());
+        channel.erase(channel.begin(), channel.begin() + first);
+    }
+    const std::size_t trimmed = last - first;
+
+    out.name = name;
+    out.channelCount = static_cast<uint32_t>(channels.size());
+    out.frameCount = static_cast<uint32_t>(trimmed);
+    out.loopStart = 0;
+    out.loopEnd = findLoopEnd(channels, trimmed, static_cast<std::size_t>(options.loopSearchSeconds * options.sampleRate));
+
+    std::vector<const float*> planar;
+    float peak = 0.0f;
+    for (const std::vector<float>& channel : channels) {
+        planar.push_back(channel.data());
+        for (float sample : channel) peak = std::max(peak, std::fabs(sample));
+    }
+    out.peak = std::min(peak, 1.0f);
+    out.loudness = static_cast<float>(
+        integratedLoudness(planar.data(), out.channelCount, trimmed, options.sampleRate));
+
+    // Quantise with triangular dither so quiet fades do not turn into
+    // correlated distortion.
+    out.samples.resize(trimmed * out.channelCount);
+    uint32_t state = 0x9E3779B9u;
+    const auto uniform = [&state] {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return static_cast<float>(state) * (1.0f / 4294967296.0f);
+    };
+    for (std::size_t i = 0; i < trimmed; ++i) {
+        for (uint32_t c = 0; c < out.channelCount; ++c) {
+            const float dither = uniform() - uniform();
+            const float scaled = channels[c][i] * 32767.0f + dither;
+            out.samples[i * out.channelCount + c] =
+                static_cast<int16_t>(std::lround(std::clamp(scaled, -32768.0f, 32767.0f)));
+        }
+    }
+    return true;
+}
+
+bool writeAssetPack(const std::string& path, std::vector<EncodedAsset> assets, double sampleRate) {
+    using namespace assetpack;
+    if (sampleRate <= 0.0 || sampleRate > UINT32_MAX) return false;
+    std::sort(assets.begin(), assets.end(),
+              [](const EncodedAsset& a, const EncodedAsset& b) { return a.name < b.name; });
+    for (std::size_t i = 0; i < assets.size(); ++i) {
+        const EncodedAsset& asset = assets[i];
+        if (asset.name.empty() || asset.name.size() >= kNameBytes) return false;
+        if (i > 0 && assets[i - 1].name == asset.name) return false;
+        if (asset.samples.size() != std::size_t(asset.frameCount) * asset.channelCount) return false;
+    }
+
+    // Header and index, then each asset on its own page boundary.
+    const std::size_t indexSize = assets.size() * kEntrySize;
+    std::vector<uint64_t> offsets;
+    std::size_t fileSize = alignUp(kHeaderSize + indexSize, kDataAlignment);
+    for (const EncodedAsset& asset : assets) {
+        offsets.push_back(fileSize);
+        fileSize = alignUp(fileSize + asset.samples.size() * sizeof(int16_t), kDataAlignment);
+    }
+
+    std::vector<uint8_t> head(alignUp(kHeaderSize + indexSize, kDataAlignment), 0);
+    std::memcpy(head.data(), kMagic, 4);
+    putU32(head, 4, kVersion);
+    putU32(head, 8, static_cast<uint32_t>(std::lround(sampleRate)));
+    putU32(head, 12, static_cast<uint32_t>(assets.size()));
+    putU64(head, 16, kHeaderSize);
+    putU64(head, 24, fileSize);
+    for (std::size_t i = 0; i < assets.size(); ++i) {
+        const EncodedAsset& asset = assets[i];
+        const std::size_t at = kHeaderSize + i * kEntrySize;
+        std::memcpy(head.data() + at, asset.name.data(), asset.name.size());
+        putU64(head, at + 64, offsets[i]);
+        putU32(head, at + 72, asset.frameCount);
+        putU32(head, at + 76, asset.loopStart);
+        putU32(head, at + 80, asset.loopEnd);
+        putU16(head, at + 84, static_cast<uint16_t>(asset.channelCount));
+        putU16(head, at + 86, static_cast<uint16_t>(Encoding::Pcm16));
+        putF32(head, at + 88, asset.loudness);
+        putF32(head, at + 92, asset.peak);
+    }
+
+    const std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) return false;
+    bool ok = std::fwrite(head.data(), 1, head.size(), file) == head.size();
+    std::size_t written = head.size();
+    const std::vector<uint8_t> padding(kDataAlignment, 0);
+    for (const EncodedAsset& asset : assets) {
+        // Samples go out in host order, which the reader requires to be
+        // little-endian.
+        const std::size_t bytes = asset.samples.size() * sizeof(int16_t);
+        ok = ok && std::fwrite(asset.samples.data(), 1, bytes, file) == bytes;
+        written += bytes;
+        const std::size_t pad = alignUp(written, kDataAlignment) - written;
+        ok = ok && std::fwrite(padding.data(), 1, pad, file) == pad;
+        written += pad;
+    }
+    ok = std::fclose(file) == 0 && ok && written == fileSize;
+    if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace sleepster
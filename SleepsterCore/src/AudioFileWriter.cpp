@@ -0,0 +1,186 @@
+//
+//  AudioFileWriter.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/AudioFileWriter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace sleepster {
+
+namespace {
+
+void putU16(std::vector<uint8_t>& out, uint16_t v) {
+    out.push_back(static_cast<uint8_t>(v));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+void putU32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+// CAF header fields are big-endian.
+void putBigU32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 3; i >= 0; --i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+void putBigU64(std::vector<uint8_t>& out, uint64_t v) {
+    for (int i = 7; i >= 0; --i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+void putTag(std::vector<uint8_t>& out, const char* tag) {
+    out.insert(out.end(), tag, tag + 4);
+}
+
+constexpr uint16_t kWavFormatPcm = 1;
+constexpr uint16_t kWavFormatFloat = 3;
+constexpr long kWavRiffSizeOffset = 4;
+constexpr long kWavDataSizeOffset = 40;
+
+constexpr uint32_t kCafFlagIsFloat = 1;
+constexpr uint32_t kCafFlagIsLittleEndian = 2;
+/// The data chunk's size field: file header, desc chunk, data tag.
+constexpr long kCafDataSizeOffset = 8 + 12 + 32 + 4;
+
+/// Room for either header.
+constexpr std::size_t kHeaderCapacity = 68;
+
+constexpr std::size_t kBlockFrames = 4096;
+
+} // namespace
+
+std::unique_ptr<AudioFileWriter> AudioFileWriter::create(const std::string& path, AudioFileType type,
+                                                         uint32_t channelCount, double sampleRate,
+                                                         WavFormat::Encoding encoding) {
+    if (channelCount == 0 || channelCount > 2 || encoding == WavFormat::Encoding::Pcm24) return nullptr;
+    if (!(sampleRate > 0.0)) return nullptr;
+
+    const bool isFloat = encoding == WavFormat::Encoding::Float32;
+    const uint16_t bits = isFloat ? 32 : 16;
+    const uint32_t blockAlign = channelCount * bits / 8;
+
+    // Sizes start out as placeholders until finish().
+    std::vector<uint8_t> header;
+    header.reserve(kHeaderCapacity);
+    if (type == AudioFileType::Wav) {
+        putTag(header, "RIFF");
+        putU32(header, 36);
+        putTag(header, "WAVE");
+        putTag(header, "fmt ");
+        putU32(header, 16);
+        putU16(header, isFloat ? kWavFormatFloat : kWavFormatPcm);
+        putU16(header, static_cast<uint16_t>(channelCount));
+        putU32(header, static_cast<uint32_t>(std::lround(sampleRate)));
+        putU32(header, static_cast<uint32_t>(std::lround(sampleRate)) * blockAlign);
+        putU16(header, static_cast<uint16_t>(blockAlign));
+        putU16(header, bits);
+        putTag(header, "data");
+        putU32(header, 0);
+    } else {
+        putTag(header, "caff");
+        header.insert(header.end(), {0, 1, 0, 0});
+        putTag(header, "desc");
+        putBigU64(header, 32);
+        uint64_t rateBits;
+        std::memcpy(&rateBits, &sampleRate, sizeof(rateBits));
+        putBigU64(header, rateBits);
+        putTag(header, "lpcm");
+        putBigU32(header, (isFloat ? kCafFlagIsFloat : 0) | kCafFlagIsLittleEndian);
+        putBigU32(header, blockAlign);
+        putBigU32(header, 1);
+        putBigU32(header, channelCount);
+        putBigU32(header, bits);
+        putTag(header, "data");
+        // -1: the data runs to the end of the file, which is what a reader
+        // sees if the render never finishes.
+        putBigU64(header, ~uint64_t(0));
+        // Edit count.
+        putBigU32(header, 0);
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return nullptr;
+    if (std::fwrite(header.data(), 1, header.size(), file) != header.size()) {
+        std::fclose(file);
+        return nullptr;
+    }
+    return std::unique_ptr<AudioFileWriter>(new AudioFileWriter(file, type, channelCount, encoding));
+}
+
+AudioFileWriter::AudioFileWriter(std::FILE* file, AudioFileType type, uint32_t channelCount,
+                                 WavFormat::Encoding encoding)
+    : file_(file),
+      type_(type),
+      channelCount_(channelCount),
+      isFloat_(encoding == WavFormat::Encoding::Float32),
+      blockAlign_(channelCount * (isFloat_ ? 4 : 2)),
+      block_(kBlockFrames * blockAlign_) {}
+
+AudioFileWriter::~AudioFileWriter() {
+    if (file_) std::fclose(file_);
+}
+
+bool AudioFileWriter::write(const float* const* channels, std::size_t frames) {
+    if (!file_ || !ok_) return false;
+    if (type_ == AudioFileType::Wav && (frames_ + frames) * blockAlign_ > 0xFFFFFFFFull - 36) {
+        ok_ = false;
+        return false;
+    }
+
+    for (std::size_t start = 0; start < frames; start += kBlockFrames) {
+        const std::size_t count = std::min(kBlockFrames, frames - start);
+        uint8_t* dst = block_.data();
+        for (std::size_t i = 0; i < count; ++i) {
+            for (uint32_t c = 0; c < channelCount_; ++c) {
+                const float sample = channels[c][start + i];
+                if (isFloat_) {
+                    std::memcpy(dst, &sample, 4);
+                    dst += 4;
+                } else {
+                    const float clamped = std::max(-1.0f, std::min(1.0f, sample));
+                    const int16_t v = static_cast<int16_t>(std::lround(clamped * 32767.0f));
+                    dst[0] = static_cast<uint8_t>(v);
+                    dst[1] = static_cast<uint8_t>(static_cast<uint16_t>(v) >> 8);
+                    dst += 2;
+                }
+            }
+        }
+        const std::size_t bytes = count * blockAlign_;
+        if (std::fwrite(block_.data(), 1, bytes, file_) != bytes) {
+            ok_ = false;
+            return false;
+        }
+    }
+    frames_ += frames;
+    return true;
+}
+
+bool AudioFileWriter::finish() {
+    if (!file_) return false;
+    const uint64_t dataBytes = frames_ * blockAlign_;
+    std::vector<uint8_t> size;
+    if (type_ == AudioFileType::Wav) {
+        putU32(size, static_cast<uint32_t>(36 + dataBytes));
+        ok_ = ok_ && patch(kWavRiffSizeOffset, size);
+        size.clear();
+        putU32(size, static_cast<uint32_t>(dataBytes));
+        ok_ = ok_ && patch(kWavDataSizeOffset, size);
+    } else {
+        // The size covers the edit count too.
+        putBigU64(size, dataBytes + 4);
+        ok_ = ok_ && patch(kCafDataSizeOffset, size);
+    }
+    const bool closed = std::fclose(file_) == 0;
+    file_ = nullptr;
+    return ok_ && closed;
+}
+
+bool AudioFileWriter::patch(long offset, const std::vector<uint8_t>& bytes) {
+    return std::fseek(file_, offset, SEEK_SET) == 0 &&
+           std::fwrite(bytes.data(), 1, bytes.size(), file_) == bytes.size();
+}
+
+} // namespace sleepster
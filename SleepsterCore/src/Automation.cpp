@@ -0,0 +1,264 @@
+//
+//  Automation.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/Automation.hpp"
+
+#include "sleepster/SessionLog.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace sleepster {
+
+using namespace automation;
+
+namespace {
+
+constexpr std::size_t kHeaderSize = sizeof kMagic + 1;
+constexpr std::size_t kCrcSize = 4;
+
+std::vector<Breakpoint> inTimeOrder(const AutomationLane& lane) {
+    std::vector<Breakpoint> points = lane.points;
+    std::stable_sort(points.begin(), points.end(),
+                     [](const Breakpoint& a, const Breakpoint& b) { return a.timeMs < b.timeMs; });
+    return points;
+}
+
+float clampTo(float value, float high) noexcept {
+    if (!(value > 0.0f)) return 0.0f;
+    return std::min(value, high);
+}
+
+RampCurve curveOf(BreakpointShape shape) noexcept {
+    switch (shape) {
+    case BreakpointShape::EqualPower: return RampCurve::EqualPower;
+    case BreakpointShape::Exponential: return RampCurve::Exponential;
+    default: return RampCurve::Linear;
+    }
+}
+
+// MARK: - Encoding
+
+void putU8(std::vector<uint8_t>& out, uint8_t value) {
+    out.push_back(value);
+}
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+void putF32(std::vector<uint8_t>& out, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof bits);
+    putU32(out, bits);
+}
+
+/// Reads the body of an encoding whose size and CRC have been checked.
+class Reader {
+public:
+    Reader(const uint8_t* data, std::size_t length) noexcept : data_(data), end_(data + length) {}
+
+    bool ok() const noexcept { return ok_; }
+    std::size_t remaining() const noexcept { return static_cast<std::size_t>(end_ - data_); }
+
+    uint8_t u8() noexcept {
+        if (!take(1)) return 0;
+        return data_[-1];
+    }
+
+    uint64_t varint() noexcept {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const uint8_t byte = u8();
+            if (!ok_) return 0;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return value;
+        }
+        ok_ = false;
+        return 0;
+    }
+
+    float f32() noexcept {
+        if (!take(4)) return 0.0f;
+        uint32_t bits = 0;
+        for (int i = 0; i < 4; ++i) bits |= static_cast<uint32_t>(data_[i - 4]) << (8 * i);
+        float value;
+        std::memcpy(&value, &bits, sizeof value);
+        return value;
+    }
+
+    /// False (and stays false) when fewer than `count` items of at least
+    /// `bytes` bytes each are left, so no count can ask for more memory
+    /// than the encoding could fill.
+    bool fits(uint64_t count, std::size_t bytes) noexcept {
+        if (count > remaining() / bytes) ok_ = false;
+        return ok_;
+    }
+
+private:
+    bool take(std::size_t count) noexcept {
+        if (!ok_ || remaining() < count) {
+            ok_ = false;
+            return false;
+        }
+        data_ += count;
+        return true;
+    }
+
+    const uint8_t* data_;
+    const uint8_t* end_;
+    bool ok_ = true;
+};
+
+} // namespace
+
+AutomationLane& AutomationTimeline::lane(AutomationTarget target, uint32_t channel) {
+    if (target != AutomationTarget::ChannelVolume) channel = 0;
+    for (AutomationLane& lane : lanes) {
+        if (lane.target == target && lane.channel == channel) return lane;
+    }
+    lanes.push_back({target, channel, {}});
+    return lanes.back();
+}
+
+// MARK: - Scheduling
+
+AutomationSchedule scheduleAutomation(const AutomationTimeline& timeline, double sampleRate) {
+    AutomationSchedule schedule;
+    if (timeline.endMs > 0) schedule.endFrame = automationFrame(timeline.endMs, sampleRate);
+
+    for (const AutomationLane& lane : timeline.lanes) {
+        const bool gain =
+            lane.target == AutomationTarget::ChannelVolume || lane.target == AutomationTarget::MasterVolume;
+        // Where a ramp to the next breakpoint starts: the previous one.
+        uint64_t previous = 0;
+        for (const Breakpoint& point : inTimeOrder(lane)) {
+            const uint64_t frame = automationFrame(point.timeMs, sampleRate);
+            AutomationAction action{frame, lane.target, RampCurve::Linear, lane.channel, 0.0f, 0};
+            if (lane.target == AutomationTarget::EqualizerPreset) {
+                if (!(point.value >= 0.0f && point.value < static_cast<float>(timeline.equalizerPresets.size()))) {
+                    continue;
+                }
+                action.index = static_cast<uint32_t>(point.value);
+                action.value = static_cast<float>(action.index);
+            } else {
+                action.value = clampTo(point.value, gain ? 4.0f : 1.0f);
+                if (point.shape != BreakpointShape::Step) {
+                    action.frame = previous;
+                    action.frames = frame - previous;
+                    action.curve = gain ? curveOf(point.shape) : RampCurve::Linear;
+                }
+            }
+            schedule.actions.push_back(action);
+            previous = frame;
+        }
+    }
+
+    std::stable_sort(schedule.actions.begin(), schedule.actions.end(),
+                     [](const AutomationAction& a, const AutomationAction& b) { return a.frame < b.frame; });
+    return schedule;
+}
+
+// MARK: - Serialization
+
+void encodeAutomation(const AutomationTimeline& timeline, std::vector<uint8_t>& out) {
+    const std::size_t start = out.size();
+    out.insert(out.end(), std::begin(kMagic), std::end(kMagic));
+    putU8(out, kVersion);
+    putVarint(out, timeline.endMs);
+
+    putVarint(out, timeline.equalizerPresets.size());
+    for (const auto& preset : timeline.equalizerPresets) {
+        for (float gain : preset) putF32(out, gain);
+    }
+
+    putVarint(out, timeline.lanes.size());
+    for (const AutomationLane& lane : timeline.lanes) {
+        putU8(out, static_cast<uint8_t>(lane.target));
+        putVarint(out, lane.channel);
+        putVarint(out, lane.points.size());
+        uint64_t time = 0;
+        for (const Breakpoint& point : inTimeOrder(lane)) {
+            putVarint(out, point.timeMs - time);
+            time = point.timeMs;
+            putU8(out, static_cast<uint8_t>(point.shape));
+            if (lane.target == AutomationTarget::EqualizerPreset) {
+                // Anything but a preset index is kept as one past the last,
+                // which scheduling drops as it would have dropped the value.
+                const bool valid = point.value >= 0.0f && point.value < 4294967296.0f;
+                putVarint(out, valid ? static_cast<uint64_t>(point.value) : timeline.equalizerPresets.size());
+            } else {
+                putF32(out, point.value);
+            }
+        }
+    }
+    putU32(out, crc32(out.data() + start, out.size() - start));
+}
+
+bool decodeAutomation(const uint8_t* data, std::size_t length, AutomationTimeline& out) {
+    out = {};
+    if (length < kHeaderSize + kCrcSize || std::memcmp(data, kMagic, sizeof kMagic) != 0 ||
+        data[sizeof kMagic] != kVersion) {
+        return false;
+    }
+    const std::size_t body = length - kCrcSize;
+    uint32_t crc = 0;
+    for (int i = 0; i < 4; ++i) crc |= static_cast<uint32_t>(data[body + i]) << (8 * i);
+    if (crc32(data, body) != crc) return false;
+
+    AutomationTimeline timeline;
+    Reader reader(data + kHeaderSize, body - kHeaderSize);
+    timeline.endMs = reader.varint();
+
+    const uint64_t presetCount = reader.varint();
+    if (!reader.fits(presetCount, 4 * Equalizer::kBandCount)) return false;
+    timeline.equalizerPresets.resize(static_cast<std::size_t>(presetCount));
+    for (auto& preset : timeline.equalizerPresets) {
+        for (float& gain : preset) gain = reader.f32();
+    }
+
+    const uint64_t laneCount = reader.varint();
+    if (!reader.fits(laneCount, 3)) return false;
+    timeline.lanes.resize(static_cast<std::size_t>(laneCount));
+    for (AutomationLane& lane : timeline.lanes) {
+        const uint8_t target = reader.u8();
+        if (target >= kAutomationTargetCount) return false;
+        lane.target = static_cast<AutomationTarget>(target);
+        const uint64_t channel = reader.varint();
+        if (channel > UINT32_MAX) return false;
+        lane.channel = static_cast<uint32_t>(channel);
+
+        const uint64_t pointCount = reader.varint();
+        if (!reader.fits(pointCount, 3)) return false;
+        lane.points.resize(static_cast<std::size_t>(pointCount));
+        uint64_t time = 0;
+        for (Breakpoint& point : lane.points) {
+            const uint64_t delta = reader.varint();
+            if (delta > UINT64_MAX - time) return false;
+            time += delta;
+            point.timeMs = time;
+            const uint8_t shape = reader.u8();
+            if (shape > static_cast<uint8_t>(BreakpointShape::Exponential)) return false;
+            point.shape = static_cast<BreakpointShape>(shape);
+            point.value = lane.target == AutomationTarget::EqualizerPreset
+                ? static_cast<float>(reader.varint())
+                : reader.f32();
+        }
+    }
+    if (!reader.ok() || reader.remaining() != 0) return false;
+    out = std::move(timeline);
+    return true;
+}
+
+} // namespace sleepster
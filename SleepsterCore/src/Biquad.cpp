@@ -0,0 +1,35 @@
+//
+//  Biquad.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/Biquad.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sleepster {
+
+BiquadCoefficients BiquadCoefficients::peaking(double sampleRate, double frequency, double gainDb,
+                                               double bandwidthOctaves) noexcept {
+    if (gainDb == 0.0 || sampleRate <= 0.0) return identity();
+
+    const double f = std::clamp(frequency, 10.0, 0.45 * sampleRate);
+    const double w0 = 2.0 * M_PI * f / sampleRate;
+    const double sinW0 = std::sin(w0);
+    const double cosW0 = std::cos(w0);
+    const double bw = std::max(bandwidthOctaves, 0.05);
+    const double alpha = sinW0 * std::sinh(std::log(2.0) / 2.0 * bw * w0 / sinW0);
+    const double a = std::pow(10.0, gainDb / 40.0);
+
+    const double a0 = 1.0 + alpha / a;
+    BiquadCoefficients c;
+    c.b0 = static_cast<float>((1.0 + alpha * a) / a0);
+    c.b1 = static_cast<float>(-2.0 * cosW0 / a0);
+    c.b2 = static_cast<float>((1.0 - alpha * a) / a0);
+    c.a1 = static_cast<float>(-2.0 * cosW0 / a0);
+    c.a2 = static_cast<float>((1.0 - alpha / a) / a0);
+    return c;
+}
+
+} // namespace sleepster
@@ -0,0 +1,251 @@
+//
+//  Bootstrap.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/Bootstrap.hpp"
+
+#include "sleepster/Trace.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace sleepster {
+
+namespace {
+
+const char* phaseName(BootPhase phase) {
+    switch (phase) {
+    case BootPhase::Critical: return "critical";
+    case BootPhase::FirstFrame: return "first frame";
+    case BootPhase::Idle: return "idle";
+    }
+    return "unknown";
+}
+
+} // namespace
+
+struct Bootstrap::Entry {
+    BootService service;
+    std::vector<std::size_t> dependencies;
+    std::vector<std::size_t> dependents;
+    BootStatus status = BootStatus::Pending;
+    BootTiming timing;
+};
+
+/// One call to run(); lives on its stack until every service it started
+/// has finished.
+struct Bootstrap::Run {
+    explicit Run(WorkStealingPool& pool) : pool(pool) {}
+
+    WorkStealingPool& pool;
+    std::mutex lock;
+    std::condition_variable changed;
+    std::vector<bool> included;
+    /// Dependencies of each included service that have yet to finish.
+    std::vector<std::size_t> remaining;
+    std::deque<std::size_t> callerQueue;
+    std::size_t outstanding = 0;
+    bool failed = false;
+};
+
+Bootstrap::Bootstrap() : epoch_(traceNow()) {}
+
+Bootstrap::~Bootstrap() = default;
+
+bool Bootstrap::add(BootService service) {
+    if (!service.start || byName_.count(service.name) != 0) return false;
+    byName_.emplace(service.name, entries_.size());
+    auto entry = std::make_unique<Entry>();
+    entry->service = std::move(service);
+    entry->timing.name = entry->service.name.c_str();
+    entry->timing.phase = entry->service.phase;
+    entries_.push_back(std::move(entry));
+    return true;
+}
+
+bool Bootstrap::validate(std::string& error) const {
+    std::vector<std::size_t> unresolved(entries_.size(), 0);
+    std::vector<std::vector<std::size_t>> dependents(entries_.size());
+    for (std::size_t i = 0; i < entries_.size(); ++i) {
+        const BootService& service = entries_[i]->service;
+        for (const std::string& dependency : service.dependencies) {
+            const auto found = byName_.find(dependency);
+            if (found == byName_.end()) {
+                error = service.name + " depends on " + dependency + ", which does not exist";
+                return false;
+            }
+            const BootService& needed = entries_[found->second]->service;
+            if (needed.phase > service.phase) {
+                error = service.name + " (" + phaseName(service.phase) + ") depends on " + needed.name + ", which starts later ("
+                    + phaseName(needed.phase) + ")";
+                return false;
+            }
+            ++unresolved[i];
+            dependents[found->second].push_back(i);
+        }
+    }
+
+    // Kahn's algorithm: whatever is never freed lies on a cycle.
+    std::vector<std::size_t> ready;
+    for (std::size_t i = 0; i < entries_.size(); ++i) {
+        if (unresolved[i] == 0) ready.push_back(i);
+    }
+    std::size_t freed = 0;
+    while (!ready.empty()) {
+        const std::size_t i = ready.back();
+        ready.pop_back();
+        ++freed;
+        for (std::size_t d : dependents[i]) {
+            if (--unresolved[d] == 0) ready.push_back(d);
+        }
+    }
+    if (freed < entries_.size()) {
+        error = "dependency cycle through";
+        for (std::size_t i = 0; i < entries_.size(); ++i) {
+            if (unresolved[i] != 0) error += " " + entries_[i]->service.name;
+        }
+        return false;
+    }
+    return true;
+}
+
+bool Bootstrap::run(BootPhase phase, WorkStealingPool& pool) {
+    if (!validate(error_)) return false;
+    error_.clear();
+
+    for (const auto& entry : entries_) {
+        entry->dependencies.clear();
+        entry->dependents.clear();
+    }
+    for (std::size_t i = 0; i < entries_.size(); ++i) {
+        for (const std::string& dependency : entries_[i]->service.dependencies) {
+            const std::size_t needed = byName_.at(dependency);
+            entries_[i]->dependencies.push_back(needed);
+            entries_[needed]->dependents.push_back(i);
+        }
+    }
+
+    Run run(pool);
+    run.included.assign(entries_.size(), false);
+    run.remaining.assign(entries_.size(), 0);
+    std::vector<std::size_t> blocked;
+    for (std::size_t i = 0; i < entries_.size(); ++i) {
+        const Entry& entry = *entries_[i];
+        if (entry.status != BootStatus::Pending || entry.service.phase > phase) continue;
+        run.included[i] = true;
+        ++run.outstanding;
+        for (std::size_t dependency : entry.dependencies) {
+            const BootStatus status = entries_[dependency]->status;
+            if (status == BootStatus::Pending) {
+                ++run.remaining[i];
+            } else if (status != BootStatus::Succeeded) {
+                blocked.push_back(i);
+            }
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(run.lock);
+    const double now = secondsSince(traceNow());
+    for (std::size_t i : blocked) skip(run, i, now);
+    std::vector<std::size_t> toPool;
+    for (std::size_t i = 0; i < entries_.size(); ++i) {
+        Entry& entry = *entries_[i];
+        if (!run.included[i] || entry.status != BootStatus::Pending || run.remaining[i] != 0) continue;
+        entry.timing.ready = now;
+        if (entry.service.affinity == BootAffinity::Caller) {
+            run.callerQueue.push_back(i);
+        } else {
+            toPool.push_back(i);
+        }
+    }
+    lock.unlock();
+    for (std::size_t i : toPool) pool.submit([this, &run, i] { execute(run, i); });
+
+    lock.lock();
+    while (run.outstanding > 0) {
+        if (run.callerQueue.empty()) {
+            run.changed.wait(lock);
+            continue;
+        }
+        const std::size_t i = run.callerQueue.front();
+        run.callerQueue.pop_front();
+        lock.unlock();
+        execute(run, i);
+        lock.lock();
+    }
+    return !run.failed;
+}
+
+void Bootstrap::execute(Run& run, std::size_t index) {
+    Entry& entry = *entries_[index];
+    const uint64_t begin = traceNow();
+    const bool ok = entry.service.start();
+    const uint64_t end = traceNow();
+    if (Tracer::enabled()) Tracer::complete(TraceCategory::App, entry.service.name.c_str(), begin, end);
+
+    std::vector<std::size_t> toPool;
+    {
+        std::lock_guard<std::mutex> guard(run.lock);
+        const double now = secondsSince(end);
+        entry.status = ok ? BootStatus::Succeeded : BootStatus::Failed;
+        entry.timing.status = entry.status;
+        entry.timing.thread = run.pool.currentWorker();
+        entry.timing.begin = secondsSince(begin);
+        entry.timing.end = now;
+        finished_.push_back(index);
+        --run.outstanding;
+        if (!ok) run.failed = true;
+
+        for (std::size_t d : entry.dependents) {
+            Entry& dependent = *entries_[d];
+            if (!run.included[d] || dependent.status != BootStatus::Pending) continue;
+            if (!ok) {
+                skip(run, d, now);
+            } else if (--run.remaining[d] == 0) {
+                dependent.timing.ready = now;
+                if (dependent.service.affinity == BootAffinity::Caller) {
+                    run.callerQueue.push_back(d);
+                } else {
+                    toPool.push_back(d);
+                }
+            }
+        }
+        run.changed.notify_all();
+    }
+    // Whatever is submitted here is still outstanding, so `run` outlives it.
+    for (std::size_t d : toPool) run.pool.submit([this, &run, d] { execute(run, d); });
+}
+
+void Bootstrap::skip(Run& run, std::size_t index, double now) {
+    Entry& entry = *entries_[index];
+    if (entry.status != BootStatus::Pending) return;
+    entry.status = BootStatus::Skipped;
+    entry.timing.status = BootStatus::Skipped;
+    entry.timing.ready = entry.timing.begin = entry.timing.end = now;
+    finished_.push_back(index);
+    --run.outstanding;
+    run.failed = true;
+    for (std::size_t d : entry.dependents) {
+        if (run.included[d]) skip(run, d, now);
+    }
+}
+
+BootStatus Bootstrap::status(const std::string& name) const {
+    const auto found = byName_.find(name);
+    return found == byName_.end() ? BootStatus::Pending : entries_[found->second]->status;
+}
+
+std::vector<BootTiming> Bootstrap::timings() const {
+    std::vector<BootTiming> timings;
+    timings.reserve(finished_.size());
+    for (std::size_t i : finished_) timings.push_back(entries_[i]->timing);
+    return timings;
+}
+
+double Bootstrap::secondsSince(uint64_t nanoseconds) const noexcept {
+    return nanoseconds > epoch_ ? static_cast<double>(nanoseconds - epoch_) * 1e-9 : 0.0;
+}
+
+} // namespace sleepster
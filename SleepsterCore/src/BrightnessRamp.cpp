@@ -0,0 +1,86 @@
+//
+//  BrightnessRamp.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/BrightnessRamp.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sleepster {
+
+namespace {
+
+// CIE 1976 lightness, with the linear segment near black.
+constexpr double kDelta = 6.0 / 29.0;
+/// Keeps a zero or negative step from asking for endless updates.
+constexpr double kSmallestLightnessStep = 0.01;
+
+double clampUnit(double value) noexcept {
+    if (!(value > 0.0)) return 0.0;
+    return value < 1.0 ? value : 1.0;
+}
+
+double lightnessOf(double luminance) noexcept {
+    const double f =
+        luminance > kDelta * kDelta * kDelta ? std::cbrt(luminance) : luminance / (3.0 * kDelta * kDelta) + 4.0 / 29.0;
+    return 116.0 * f - 16.0;
+}
+
+double luminanceOf(double lightness) noexcept {
+    const double f = (lightness + 16.0) / 116.0;
+    return f > kDelta ? f * f * f : 3.0 * kDelta * kDelta * (f - 4.0 / 29.0);
+}
+
+} // namespace
+
+double brightnessToLightness(double brightness, double gamma) noexcept {
+    return lightnessOf(std::pow(clampUnit(brightness), gamma));
+}
+
+double lightnessToBrightness(double lightness, double gamma) noexcept {
+    return clampUnit(std::pow(clampUnit(luminanceOf(lightness)), 1.0 / gamma));
+}
+
+std::size_t planBrightnessRamp(double from, double to, double duration, const BrightnessRampConfig& config,
+                               BrightnessStep* out, std::size_t capacity) noexcept {
+    from = clampUnit(from);
+    to = clampUnit(to);
+    if (from == to) return 0;
+    if (!(duration > 0.0)) {
+        if (out && capacity > 0) out[0] = {0.0, to};
+        return 1;
+    }
+
+    const double startLightness = brightnessToLightness(from, config.gamma);
+    const double endLightness = brightnessToLightness(to, config.gamma);
+    const double change = std::fabs(endLightness - startLightness);
+    // A change below one step still needs its one update; the small
+    // tolerance keeps an exact multiple of the step from gaining one.
+    const double visible = std::ceil(change / std::max(config.lightnessStep, kSmallestLightnessStep) - 1e-9);
+    const double allowed = config.minimumInterval > 0.0 ? std::floor(duration / config.minimumInterval) : visible;
+    const auto count = static_cast<std::size_t>(std::max(1.0, std::min(visible, allowed)));
+
+    const std::size_t written = out ? std::min(count, capacity) : 0;
+    for (std::size_t i = 0; i < written; ++i) {
+        const double fraction = static_cast<double>(i + 1) / static_cast<double>(count);
+        const double lightness = startLightness + (endLightness - startLightness) * fraction;
+        out[i] = {duration * fraction, i + 1 == count ? to : lightnessToBrightness(lightness, config.gamma)};
+    }
+    return count;
+}
+
+std::vector<BrightnessStep> planBrightnessRamp(double from, double to, double duration,
+                                               const BrightnessRampConfig& config) {
+    std::vector<BrightnessStep> steps(planBrightnessRamp(from, to, duration, config, nullptr, 0));
+    planBrightnessRamp(from, to, duration, config, steps.data(), steps.size());
+    return steps;
+}
+
+std::size_t brightnessStepsDue(const BrightnessStep* steps, std::size_t count, double elapsed) noexcept {
+    const auto isDue = [](double time, const BrightnessStep& step) { return time < step.time; };
+    return static_cast<std::size_t>(std::upper_bound(steps, steps + count, elapsed, isDue) - steps);
+}
+
+} // namespace sleepster
@@ -0,0 +1,591 @@
+//
+//  Catalog.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/Catalog.hpp"
+
+#include "sleepster/SessionLog.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace sleepster {
+
+using namespace catalog;
+
+namespace {
+
+constexpr uint32_t kNil = 0xFFFFFFFFu;
+
+// Snapshot flag bits.
+constexpr uint8_t kLiveBit = 1;
+constexpr uint8_t kFavoriteBit = 2;
+constexpr uint8_t kSelectedBit = 4;
+constexpr uint8_t kMixingBit = 8;
+constexpr uint8_t kUnsyncedBit = 0x80;
+
+/// FNV-1a.
+uint32_t hashKey(const char* key, std::size_t length) noexcept {
+    uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<uint8_t>(key[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+class Bitset {
+public:
+    void resize(std::size_t bits) { words_.resize((bits + 63) / 64, 0); }
+
+    bool test(std::size_t i) const noexcept { return (words_[i >> 6] >> (i & 63)) & 1; }
+
+    void set(std::size_t i, bool value) noexcept {
+        const uint64_t bit = uint64_t{1} << (i & 63);
+        words_[i >> 6] = value ? words_[i >> 6] | bit : words_[i >> 6] & ~bit;
+    }
+
+    std::size_t wordCount() const noexcept { return words_.size(); }
+    uint64_t word(std::size_t i) const noexcept { return words_[i]; }
+    void clear() noexcept { std::fill(words_.begin(), words_.end(), 0); }
+
+private:
+    std::vector<uint64_t> words_;
+};
+
+uint32_t readU32(const uint8_t* p) noexcept {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint64_t readU64(const uint8_t* p) noexcept {
+    return static_cast<uint64_t>(readU32(p)) | (static_cast<uint64_t>(readU32(p + 4)) << 32);
+}
+
+void putU32(uint8_t* p, uint32_t v) noexcept {
+    for (int i = 0; i < 4; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+void putU64(uint8_t* p, uint64_t v) noexcept {
+    putU32(p, static_cast<uint32_t>(v));
+    putU32(p + 4, static_cast<uint32_t>(v >> 32));
+}
+
+uint32_t floatBits(float value) noexcept {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof bits);
+    return bits;
+}
+
+float bitsFloat(uint32_t bits) noexcept {
+    float value;
+    std::memcpy(&value, &bits, sizeof value);
+    return value;
+}
+
+bool readFile(const std::string& path, std::vector<uint8_t>& out) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat info {};
+    bool ok = fstat(fd, &info) == 0 && info.st_size > 0;
+    if (ok) {
+        out.resize(static_cast<std::size_t>(info.st_size));
+        std::size_t at = 0;
+        while (ok && at < out.size()) {
+            const ssize_t got = ::read(fd, out.data() + at, out.size() - at);
+            ok = got > 0;
+            if (ok) at += static_cast<std::size_t>(got);
+        }
+    }
+    ::close(fd);
+    return ok;
+}
+
+} // namespace
+
+/// One kind's rows. A row's strings are pool offsets; for sounds `first`
+/// and `second` are the two URLs, for backgrounds `first` is the color
+/// theme.
+struct Catalog::Rows {
+    struct Row {
+        uint32_t key = kNil;
+        uint32_t hash = 0;
+        uint32_t first = kNil;
+        uint32_t second = kNil;
+        int32_t intensity = 2;
+        float speed = 1.0f;
+    };
+
+    std::vector<Row> rows;
+    Bitset live;
+    Bitset favorite;
+    Bitset selected;
+    Bitset mixing;
+    Bitset unsynced;
+    std::size_t liveCount = 0;
+    /// Live row ids by key hash, linear probing, at most half full;
+    /// kNotFound marks an empty slot.
+    std::vector<uint32_t> slots;
+
+    uint32_t append() {
+        const auto id = static_cast<uint32_t>(rows.size());
+        rows.emplace_back();
+        for (Bitset* bits : {&live, &favorite, &selected, &mixing, &unsynced}) bits->resize(rows.size());
+        return id;
+    }
+
+    Bitset* bits(CatalogKind kind, CatalogFlag flag) noexcept {
+        switch (flag) {
+        case CatalogFlag::Favorite: return &favorite;
+        case CatalogFlag::Selected: return &selected;
+        case CatalogFlag::SelectedForMixing: return kind == CatalogKind::Sound ? &mixing : nullptr;
+        }
+        return nullptr;
+    }
+
+    const Bitset* bits(CatalogKind kind, CatalogFlag flag) const noexcept {
+        return const_cast<Rows*>(this)->bits(kind, flag);
+    }
+
+    uint32_t lookup(const char* pool, const char* key, std::size_t length, uint32_t hash) const noexcept {
+        if (slots.empty()) return kNotFound;
+        const std::size_t mask = slots.size() - 1;
+        for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+            const uint32_t id = slots[i];
+            if (id == kNotFound) return kNotFound;
+            const Row& row = rows[id];
+            // strncmp stops at the pool string's NUL, so this never reads
+            // past a shorter one.
+            if (row.hash == hash && std::strncmp(pool + row.key, key, length) == 0 && pool[row.key + length] == '\0') {
+                return id;
+            }
+        }
+    }
+
+    void index(uint32_t id) {
+        if ((liveCount + 1) * 2 > slots.size()) {
+            std::vector<uint32_t> old(std::max<std::size_t>(16, slots.size() * 2), kNotFound);
+            old.swap(slots);
+            for (uint32_t moved : old) {
+                if (moved != kNotFound) place(moved);
+            }
+        }
+        place(id);
+    }
+
+    /// Backward-shift deletion, so lookups never need tombstones.
+    void unindex(uint32_t id) noexcept {
+        const std::size_t mask = slots.size() - 1;
+        std::size_t hole = rows[id].hash & mask;
+        while (slots[hole] != id) hole = (hole + 1) & mask;
+        slots[hole] = kNotFound;
+        for (std::size_t j = (hole + 1) & mask; slots[j] != kNotFound; j = (j + 1) & mask) {
+            const std::size_t home = rows[slots[j]].hash & mask;
+            const bool reachable = hole <= j ? (hole < home && home <= j) : (hole < home || home <= j);
+            if (reachable) continue;
+            slots[hole] = slots[j];
+            slots[j] = kNotFound;
+            hole = j;
+        }
+    }
+
+    /// Lowest id whose bit is set in `bits` and `live`.
+    uint32_t first(const Bitset& bits) const noexcept {
+        for (std::size_t w = 0; w < bits.wordCount(); ++w) {
+            const uint64_t word = bits.word(w) & live.word(w);
+            if (word) return static_cast<uint32_t>(w * 64 + static_cast<std::size_t>(__builtin_ctzll(word)));
+        }
+        return kNotFound;
+    }
+
+    std::vector<uint32_t> all(const Bitset& bits, const Bitset& mask) const {
+        std::vector<uint32_t> ids;
+        for (std::size_t w = 0; w < bits.wordCount(); ++w) {
+            for (uint64_t word = bits.word(w) & mask.word(w); word; word &= word - 1) {
+                ids.push_back(static_cast<uint32_t>(w * 64 + static_cast<std::size_t>(__builtin_ctzll(word))));
+            }
+        }
+        return ids;
+    }
+
+private:
+    void place(uint32_t id) noexcept {
+        const std::size_t mask = slots.size() - 1;
+        std::size_t i = rows[id].hash & mask;
+        while (slots[i] != kNotFound) i = (i + 1) & mask;
+        slots[i] = id;
+    }
+};
+
+Catalog::Catalog() : sounds_(std::make_unique<Rows>()), backgrounds_(std::make_unique<Rows>()) {}
+
+Catalog::~Catalog() = default;
+
+// MARK: - Snapshot
+
+std::unique_ptr<Catalog> Catalog::load(const std::string& path) {
+    std::vector<uint8_t> bytes;
+    if (!readFile(path, bytes) || bytes.size() < kHeaderSize) return nullptr;
+    const uint8_t* header = bytes.data();
+    if (std::memcmp(header, kMagic, sizeof kMagic) != 0 || readU32(header + 4) != kVersion) return nullptr;
+    const uint64_t soundCount = readU32(header + 16);
+    const uint64_t backgroundCount = readU32(header + 20);
+    const uint64_t poolBytes = readU32(header + 24);
+    if (kHeaderSize + soundCount * kSoundRowSize + backgroundCount * kBackgroundRowSize + poolBytes != bytes.size()) {
+        return nullptr;
+    }
+    if (crc32(bytes.data() + kHeaderSize, bytes.size() - kHeaderSize) != readU32(header + 28)) return nullptr;
+
+    auto catalog = std::make_unique<Catalog>();
+    const uint8_t* pool = bytes.data() + bytes.size() - poolBytes;
+    if (poolBytes > 0 && pool[poolBytes - 1] != 0) return nullptr;
+    catalog->strings_.assign(reinterpret_cast<const char*>(pool), static_cast<std::size_t>(poolBytes));
+    catalog->revision_ = readU64(header + 8);
+    catalog->snapshot_ = path;
+    const auto valid = [&](uint32_t offset, bool nullable) { return offset < poolBytes || (nullable && offset == kNil); };
+
+    const uint8_t* row = header + kHeaderSize;
+    for (int pass = 0; pass < 2; ++pass) {
+        const CatalogKind kind = pass == 0 ? CatalogKind::Sound : CatalogKind::Background;
+        Rows& rows = catalog->rows(kind);
+        const uint64_t count = pass == 0 ? soundCount : backgroundCount;
+        for (uint64_t i = 0; i < count; ++i) {
+            const uint32_t id = rows.append();
+            Rows::Row& fields = rows.rows[id];
+            fields.key = readU32(row);
+            fields.first = readU32(row + 4);
+            uint8_t flags;
+            if (kind == CatalogKind::Sound) {
+                fields.second = readU32(row + 8);
+                flags = row[12];
+                row += kSoundRowSize;
+            } else {
+                fields.intensity = static_cast<int32_t>(readU32(row + 8));
+                fields.speed = bitsFloat(readU32(row + 12));
+                flags = row[16];
+                row += kBackgroundRowSize;
+            }
+            if (!valid(fields.key, false) || !valid(fields.first, true) || !valid(fields.second, true)) return nullptr;
+            const char* key = catalog->string(fields.key);
+            const std::size_t length = std::strlen(key);
+            fields.hash = hashKey(key, length);
+            rows.favorite.set(id, flags & kFavoriteBit);
+            rows.selected.set(id, flags & kSelectedBit);
+            rows.mixing.set(id, kind == CatalogKind::Sound && (flags & kMixingBit));
+            rows.unsynced.set(id, flags & kUnsyncedBit);
+            if (flags & kLiveBit) {
+                if (rows.lookup(catalog->strings_.data(), key, length, fields.hash) != kNotFound) return nullptr;
+                rows.live.set(id, true);
+                rows.index(id);
+                ++rows.liveCount;
+            }
+        }
+    }
+    return catalog;
+}
+
+bool Catalog::save(const std::string& path) const {
+    std::vector<uint8_t> out(kHeaderSize);
+    std::string pool;
+    const auto put = [&](uint32_t offset) {
+        if (offset == kNil) return kNil;
+        const auto at = static_cast<uint32_t>(pool.size());
+        pool.append(string(offset));
+        pool.push_back('\0');
+        return at;
+    };
+
+    uint32_t counts[2] = {0, 0};
+    for (int pass = 0; pass < 2; ++pass) {
+        const CatalogKind kind = pass == 0 ? CatalogKind::Sound : CatalogKind::Background;
+        const Rows& rows = this->rows(kind);
+        const std::size_t rowSize = kind == CatalogKind::Sound ? kSoundRowSize : kBackgroundRowSize;
+        for (uint32_t id = 0; id < rows.rows.size(); ++id) {
+            const bool live = rows.live.test(id);
+            const bool unsynced = rows.unsynced.test(id);
+            // A removal already written to the store has nothing left to say.
+            if (!live && !unsynced) continue;
+            const Rows::Row& fields = rows.rows[id];
+            const uint8_t flags = static_cast<uint8_t>((live ? kLiveBit : 0) | (unsynced ? kUnsyncedBit : 0) |
+                                                       (rows.favorite.test(id) ? kFavoriteBit : 0) |
+                                                       (rows.selected.test(id) ? kSelectedBit : 0) |
+                                                       (rows.mixing.test(id) ? kMixingBit : 0));
+            const std::size_t at = out.size();
+            out.resize(at + rowSize, 0);
+            uint8_t* p = out.data() + at;
+            putU32(p, put(fields.key));
+            putU32(p + 4, put(fields.first));
+            if (kind == CatalogKind::Sound) {
+                putU32(p + 8, put(fields.second));
+                p[12] = flags;
+            } else {
+                putU32(p + 8, static_cast<uint32_t>(fields.intensity));
+                putU32(p + 12, floatBits(fields.speed));
+                p[16] = flags;
+            }
+            ++counts[pass];
+        }
+    }
+    out.insert(out.end(), pool.begin(), pool.end());
+
+    std::memcpy(out.data(), kMagic, sizeof kMagic);
+    putU32(out.data() + 4, kVersion);
+    putU64(out.data() + 8, revision_);
+    putU32(out.data() + 16, counts[0]);
+    putU32(out.data() + 20, counts[1]);
+    putU32(out.data() + 24, static_cast<uint32_t>(pool.size()));
+    putU32(out.data() + 28, crc32(out.data() + kHeaderSize, out.size() - kHeaderSize));
+
+    // Not synced: a snapshot torn by a crash fails its CRC and the owner
+    // rebuilds from the store, which is the record that has to survive.
+    const std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) return false;
+    const bool written = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+    if (std::fclose(file) != 0 || !written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    snapshot_ = path;
+    return true;
+}
+
+// MARK: - Records
+
+bool Catalog::addSound(const CatalogSound& sound, uint32_t& id, bool fromStore) {
+    id = find(CatalogKind::Sound, sound.title);
+    if (id != kNotFound) return false;
+    Rows& rows = *sounds_;
+    id = rows.append();
+    rows.live.set(id, true);
+    ++rows.liveCount;
+    setKey(rows, id, sound.title);
+    return updateSound(id, sound, fromStore);
+}
+
+bool Catalog::addBackground(const CatalogBackground& background, uint32_t& id, bool fromStore) {
+    id = find(CatalogKind::Background, background.animationType);
+    if (id != kNotFound) return false;
+    Rows& rows = *backgrounds_;
+    id = rows.append();
+    rows.live.set(id, true);
+    ++rows.liveCount;
+    setKey(rows, id, background.animationType);
+    return updateBackground(id, background, fromStore);
+}
+
+bool Catalog::updateSound(uint32_t id, const CatalogSound& sound, bool fromStore) {
+    Rows& rows = *sounds_;
+    if (!isLive(CatalogKind::Sound, id) || !setKey(rows, id, sound.title)) return false;
+    assign(rows.rows[id].first, sound.hasUrl1, sound.url1);
+    assign(rows.rows[id].second, sound.hasUrl2, sound.url2);
+    rows.favorite.set(id, sound.favorite);
+    rows.selected.set(id, sound.selected);
+    rows.mixing.set(id, sound.selectedForMixing);
+    touch(rows, id, fromStore);
+    return true;
+}
+
+bool Catalog::updateBackground(uint32_t id, const CatalogBackground& background, bool fromStore) {
+    Rows& rows = *backgrounds_;
+    if (!isLive(CatalogKind::Background, id) || !setKey(rows, id, background.animationType)) return false;
+    assign(rows.rows[id].first, background.hasColorTheme, background.colorTheme);
+    rows.rows[id].intensity = background.intensityLevel;
+    rows.rows[id].speed = background.speedMultiplier;
+    rows.favorite.set(id, background.favorite);
+    rows.selected.set(id, background.selected);
+    touch(rows, id, fromStore);
+    return true;
+}
+
+bool Catalog::remove(CatalogKind kind, uint32_t id, bool fromStore) {
+    if (!isLive(kind, id)) return false;
+    Rows& rows = this->rows(kind);
+    rows.unindex(id);
+    rows.live.set(id, false);
+    --rows.liveCount;
+    touch(rows, id, fromStore);
+    return true;
+}
+
+bool Catalog::sound(uint32_t id, CatalogSound& out) const {
+    const Rows& rows = *sounds_;
+    if (id >= rows.rows.size()) return false;
+    const Rows::Row& fields = rows.rows[id];
+    out.title = string(fields.key);
+    out.hasUrl1 = fields.first != kNil;
+    out.url1 = out.hasUrl1 ? string(fields.first) : "";
+    out.hasUrl2 = fields.second != kNil;
+    out.url2 = out.hasUrl2 ? string(fields.second) : "";
+    out.favorite = rows.favorite.test(id);
+    out.selected = rows.selected.test(id);
+    out.selectedForMixing = rows.mixing.test(id);
+    return true;
+}
+
+bool Catalog::background(uint32_t id, CatalogBackground& out) const {
+    const Rows& rows = *backgrounds_;
+    if (id >= rows.rows.size()) return false;
+    const Rows::Row& fields = rows.rows[id];
+    out.animationType = string(fields.key);
+    out.hasColorTheme = fields.first != kNil;
+    out.colorTheme = out.hasColorTheme ? string(fields.first) : "";
+    out.intensityLevel = fields.intensity;
+    out.speedMultiplier = fields.speed;
+    out.favorite = rows.favorite.test(id);
+    out.selected = rows.selected.test(id);
+    return true;
+}
+
+const char* Catalog::key(CatalogKind kind, uint32_t id) const noexcept {
+    const Rows& rows = this->rows(kind);
+    return id < rows.rows.size() ? string(rows.rows[id].key) : nullptr;
+}
+
+uint32_t Catalog::find(CatalogKind kind, const std::string& key) const noexcept {
+    return rows(kind).lookup(strings_.data(), key.data(), key.size(), hashKey(key.data(), key.size()));
+}
+
+bool Catalog::isLive(CatalogKind kind, uint32_t id) const noexcept {
+    const Rows& rows = this->rows(kind);
+    return id < rows.rows.size() && rows.live.test(id);
+}
+
+std::size_t Catalog::size(CatalogKind kind) const noexcept {
+    return rows(kind).liveCount;
+}
+
+std::size_t Catalog::rowCount(CatalogKind kind) const noexcept {
+    return rows(kind).rows.size();
+}
+
+// MARK: - Flags
+
+bool Catalog::setFlag(CatalogKind kind, uint32_t id, CatalogFlag flag, bool value, bool fromStore) {
+    Rows& rows = this->rows(kind);
+    Bitset* bits = rows.bits(kind, flag);
+    if (!bits || !isLive(kind, id)) return false;
+    if (bits->test(id) != value) {
+        bits->set(id, value);
+        touch(rows, id, fromStore);
+    }
+    return true;
+}
+
+bool Catalog::flag(CatalogKind kind, uint32_t id, CatalogFlag flag) const noexcept {
+    const Rows& rows = this->rows(kind);
+    const Bitset* bits = rows.bits(kind, flag);
+    return bits && isLive(kind, id) && bits->test(id);
+}
+
+bool Catalog::select(CatalogKind kind, uint32_t id) {
+    if (!isLive(kind, id)) return false;
+    Rows& rows = this->rows(kind);
+    for (uint32_t other : rows.all(rows.selected, rows.live)) {
+        if (other == id) continue;
+        rows.selected.set(other, false);
+        touch(rows, other, false);
+    }
+    return setFlag(kind, id, CatalogFlag::Selected, true);
+}
+
+uint32_t Catalog::firstWith(CatalogKind kind, CatalogFlag flag) const noexcept {
+    const Rows& rows = this->rows(kind);
+    const Bitset* bits = rows.bits(kind, flag);
+    return bits ? rows.first(*bits) : kNotFound;
+}
+
+std::vector<uint32_t> Catalog::allWith(CatalogKind kind, CatalogFlag flag) const {
+    const Rows& rows = this->rows(kind);
+    const Bitset* bits = rows.bits(kind, flag);
+    return bits ? rows.all(*bits, rows.live) : std::vector<uint32_t>{};
+}
+
+std::size_t Catalog::countWith(CatalogKind kind, CatalogFlag flag) const noexcept {
+    const Rows& rows = this->rows(kind);
+    const Bitset* bits = rows.bits(kind, flag);
+    if (!bits) return 0;
+    std::size_t count = 0;
+    for (std::size_t w = 0; w < bits->wordCount(); ++w) {
+        count += static_cast<std::size_t>(__builtin_popcountll(bits->word(w) & rows.live.word(w)));
+    }
+    return count;
+}
+
+// MARK: - Write-back
+
+std::vector<uint32_t> Catalog::takeChanges(CatalogKind kind) {
+    Rows& rows = this->rows(kind);
+    std::vector<uint32_t> changed = rows.all(rows.unsynced, rows.unsynced);
+    rows.unsynced.clear();
+    return changed;
+}
+
+std::size_t Catalog::pendingChanges(CatalogKind kind) const noexcept {
+    const Rows& rows = this->rows(kind);
+    std::size_t count = 0;
+    for (std::size_t w = 0; w < rows.unsynced.wordCount(); ++w) {
+        count += static_cast<std::size_t>(__builtin_popcountll(rows.unsynced.word(w)));
+    }
+    return count;
+}
+
+// MARK: - Private
+
+Catalog::Rows& Catalog::rows(CatalogKind kind) noexcept {
+    return kind == CatalogKind::Sound ? *sounds_ : *backgrounds_;
+}
+
+const Catalog::Rows& Catalog::rows(CatalogKind kind) const noexcept {
+    return kind == CatalogKind::Sound ? *sounds_ : *backgrounds_;
+}
+
+uint32_t Catalog::intern(const std::string& value) {
+    const auto at = static_cast<uint32_t>(strings_.size());
+    strings_.append(value.c_str());
+    strings_.push_back('\0');
+    return at;
+}
+
+void Catalog::assign(uint32_t& offset, bool present, const std::string& value) {
+    if (!present) {
+        offset = kNil;
+    } else if (offset == kNil || value != string(offset)) {
+        // Replaced strings stay in the pool until the next snapshot load.
+        offset = intern(value);
+    }
+}
+
+const char* Catalog::string(uint32_t offset) const noexcept {
+    return strings_.data() + offset;
+}
+
+bool Catalog::setKey(Rows& rows, uint32_t id, const std::string& key) {
+    Rows::Row& fields = rows.rows[id];
+    if (fields.key != kNil && key == string(fields.key)) return true;
+    const uint32_t hash = hashKey(key.data(), key.size());
+    if (rows.lookup(strings_.data(), key.data(), key.size(), hash) != kNotFound) return false;
+    if (fields.key != kNil) rows.unindex(id);
+    fields.key = intern(key);
+    fields.hash = hash;
+    rows.index(id);
+    return true;
+}
+
+void Catalog::touch(Rows& rows, uint32_t id, bool fromStore) {
+    ++revision_;
+    if (!fromStore) rows.unsynced.set(id, true);
+    if (!snapshot_.empty()) {
+        // Gone before the change can be lost to a crash.
+        std::remove(snapshot_.c_str());
+        snapshot_.clear();
+    }
+}
+
+} // namespace sleepster
@@ -0,0 +1,69 @@
+//
+//  Decoder.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/Decoder.hpp"
+
+#include <cmath>
+
+namespace sleepster {
+
+ResamplingDecoder::ResamplingDecoder(std::unique_ptr<Decoder> inner, double targetRate)
+    : inner_(std::move(inner)),
+      targetRate_(targetRate),
+      step_(inner_->sampleRate() / targetRate),
+      left_(kChunk + 1),
+      right_(kChunk + 1) {}
+
+uint64_t ResamplingDecoder::frameCount() const noexcept {
+    const uint64_t inner = inner_->frameCount();
+    return inner == 0 ? 0 : static_cast<uint64_t>(std::floor(static_cast<double>(inner) / step_));
+}
+
+bool ResamplingDecoder::refill() {
+    // Keep the last decoded frame as index 0 of the new window.
+    if (available_ > 0) {
+        left_[0] = left_[available_ - 1];
+        right_[0] = right_[available_ - 1];
+        position_ -= static_cast<double>(available_ - 1);
+        available_ = 1;
+    }
+    const std::size_t decoded = inner_->decode(left_.data() + available_, right_.data() + available_,
+                                               left_.size() - available_);
+    if (decoded == 0) {
+        ended_ = true;
+        return false;
+    }
+    available_ += decoded;
+    return true;
+}
+
+std::size_t ResamplingDecoder::decode(float* left, float* right, std::size_t frames) {
+    std::size_t written = 0;
+    while (written < frames) {
+        // Need frames i0 and i0 + 1 inside the window.
+        while (static_cast<std::size_t>(position_) + 1 >= available_) {
+            if (ended_ || !refill()) return written;
+        }
+        const std::size_t i0 = static_cast<std::size_t>(position_);
+        const float frac = static_cast<float>(position_ - static_cast<double>(i0));
+        left[written] = left_[i0] + (left_[i0 + 1] - left_[i0]) * frac;
+        right[written] = right_[i0] + (right_[i0 + 1] - right_[i0]) * frac;
+        position_ += step_;
+        ++written;
+    }
+    return written;
+}
+
+bool ResamplingDecoder::seek(uint64_t frame) {
+    const double sourceFrame = static_cast<double>(frame) * step_;
+    const uint64_t whole = static_cast<uint64_t>(sourceFrame);
+    if (!inner_->seek(whole)) return false;
+    available_ = 0;
+    position_ = sourceFrame - static_cast<double>(whole);
+    ended_ = false;
+    return true;
+}
+
+} // namespace sleepster
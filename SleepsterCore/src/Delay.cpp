@@ -0,0 +1,196 @@
+//
+//  Delay.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/Delay.hpp"
+
+#include "sleepster/Simd.hpp"
+#include "sleepster/Trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sleepster {
+
+namespace {
+
+/// Smallest tap position that keeps every Hermite tap in the past.
+constexpr float kMinDelayFrames = 2.0f;
+
+} // namespace
+
+StereoDelay::StereoDelay(double sampleRate, std::size_t maxBlockFrames)
+    : sampleRate_(sampleRate),
+      maxBlockFrames_(std::max<std::size_t>(maxBlockFrames, 1)),
+      declickFrames_(static_cast<uint64_t>(0.01 * sampleRate)),
+      glideCoefficient_(static_cast<float>(1.0 - std::exp(-1.0 / (kGlideSeconds * sampleRate)))),
+      lineLeft_(static_cast<std::size_t>(kMaxSeconds * sampleRate) + 4),
+      lineRight_(static_cast<std::size_t>(kMaxSeconds * sampleRate) + 4),
+      wetLeft_(maxBlockFrames_),
+      wetRight_(maxBlockFrames_),
+      segment_(maxBlockFrames_ + 3) {
+    publish();
+}
+
+// MARK: - Control thread
+
+void StereoDelay::setEnabled(bool enabled) {
+    settings_.enabled = enabled;
+    publish();
+}
+
+void StereoDelay::setTime(double seconds) {
+    settings_.seconds = std::isfinite(seconds) ? std::clamp(seconds, 0.0, kMaxSeconds) : 0.0;
+    publish();
+}
+
+void StereoDelay::setFeedback(float feedback) {
+    settings_.feedback = std::isfinite(feedback) ? std::clamp(feedback, -kMaxFeedback, kMaxFeedback) : 0.0f;
+    publish();
+}
+
+void StereoDelay::setMix(float wet) {
+    settings_.wet = std::isfinite(wet) ? std::clamp(wet, 0.0f, 1.0f) : 0.0f;
+    publish();
+}
+
+void StereoDelay::publish() {
+    snapshots_.back() = settings_;
+    snapshots_.publish();
+}
+
+// MARK: - Render thread
+
+void StereoDelay::apply(const Settings& settings) noexcept {
+    targetDelay_ = std::max(kMinDelayFrames, static_cast<float>(settings.seconds * sampleRate_));
+    targetFeedback_ = settings.feedback;
+
+    wet_ = settings.wet;
+    if (settings.enabled) {
+        // A timeline driving the mix keeps it unless the effect is waking.
+        const bool automated = automatedWet_ >= 0.0f && enabled_ && !bypassed_;
+        if (bypassed_) {
+            lineLeft_.clear();
+            lineRight_.clear();
+            delay_ = targetDelay_;
+            feedback_ = targetFeedback_;
+            tail_.reset();
+            bypassed_ = false;
+        }
+        if (!automated) mix_.rampTo(mixTarget(), declickFrames_);
+    } else if (!bypassed_) {
+        mix_.rampTo(0.0f, declickFrames_);
+    }
+    enabled_ = settings.enabled;
+
+    // Each pass round the loop is at least one delay long and scales the
+    // echo by |feedback|; count the passes until it is 120 dB down, plus
+    // time for the tap to finish gliding.
+    const double gain = std::fabs(static_cast<double>(targetFeedback_));
+    const double passes = gain < 1e-6 ? 1.0 : 1.0 + std::ceil(std::log(1e-6) / std::log(gain));
+    const double longest = std::max(delay_, targetDelay_) + 2.0;
+    const double glide = std::fabs(targetDelay_ - delay_) / kMaxGlideRate + 5.0 * kGlideSeconds * sampleRate_;
+    tail_.setTailFrames(static_cast<uint64_t>(passes * longest + glide));
+}
+
+void StereoDelay::process(float* left, float* right, std::size_t frames) noexcept {
+    if (snapshots_.update()) apply(snapshots_.front());
+    if (bypassed_) return;
+    SLP_TRACE_SPAN(Audio, "delay.process");
+
+    if (!tail_.shouldRun(left, right, frames) && !mix_.isRamping()) {
+        // Nothing is sounding, so pending glides can complete silently.
+        delay_ = targetDelay_;
+        feedback_ = targetFeedback_;
+        if (!enabled_) {
+            mix_.settle();
+            bypassed_ = true;
+        }
+        return;
+    }
+
+    renderWet(left, right, frames);
+    mix_.apply(left, right, wetLeft_.data(), wetRight_.data(), frames);
+    if (!enabled_ && mix_.isDry()) bypassed_ = true;
+}
+
+void StereoDelay::automateMix(float wet, uint64_t frames, uint64_t elapsed) noexcept {
+    // Settings published since the last block decide whether there is a
+    // mix to drive, as they would have before it.
+    if (snapshots_.update()) apply(snapshots_.front());
+    automatedWet_ = std::clamp(wet, 0.0f, 1.0f);
+    if (!enabled_) return;
+    mix_.rampTo(automatedWet_, frames);
+    mix_.advance(elapsed);
+}
+
+void StereoDelay::restoreMix() noexcept {
+    if (automatedWet_ < 0.0f) return;
+    automatedWet_ = -1.0f;
+    if (enabled_) mix_.rampTo(wet_, declickFrames_);
+}
+
+void StereoDelay::renderWet(const float* left, const float* right, std::size_t frames) noexcept {
+    using namespace simd;
+    const std::size_t whole = static_cast<std::size_t>(delay_);
+    if (delay_ != targetDelay_ || feedback_ != targetFeedback_ || whole < frames + 1) {
+        renderGliding(left, right, frames);
+        return;
+    }
+
+    // Settled and longer than the block: every tap the block reads was
+    // written before it, so reads and writes separate into vector passes.
+    const HermiteWeights w = HermiteWeights::at(delay_ - static_cast<float>(whole));
+    const f32x4 w0 = splat(w.w0), w1 = splat(w.w1), w2 = splat(w.w2), w3 = splat(w.w3);
+    const f32x4 feedback = splat(feedback_);
+    const float* inputs[] = {left, right};
+    float* wets[] = {wetLeft_.data(), wetRight_.data()};
+    DelayLine* lines[] = {&lineLeft_, &lineRight_};
+
+    for (std::size_t channel = 0; channel < 2; ++channel) {
+        const float* in = inputs[channel];
+        float* wet = wets[channel];
+        float* seg = segment_.data();
+        // seg[k] .. seg[k + 3] are the four taps of output k, oldest first.
+        lines[channel]->readBlock(whole + 2, seg, frames + 3);
+
+        std::size_t i = 0;
+        for (; i + kWidth <= frames; i += kWidth) {
+            f32x4 y = mul(load(seg + i), w3);
+            y = madd(y, load(seg + i + 1), w2);
+            y = madd(y, load(seg + i + 2), w1);
+            y = madd(y, load(seg + i + 3), w0);
+            store(wet + i, y);
+        }
+        for (; i < frames; ++i) {
+            wet[i] = w.w3 * seg[i] + w.w2 * seg[i + 1] + w.w1 * seg[i + 2] + w.w0 * seg[i + 3];
+        }
+
+        i = 0;
+        for (; i + kWidth <= frames; i += kWidth) {
+            store(seg + i, madd(load(in + i), load(wet + i), feedback));
+        }
+        for (; i < frames; ++i) seg[i] = in[i] + wet[i] * feedback_;
+        lines[channel]->writeBlock(seg, frames);
+    }
+}
+
+void StereoDelay::renderGliding(const float* left, const float* right, std::size_t frames) noexcept {
+    float* wetLeft = wetLeft_.data();
+    float* wetRight = wetRight_.data();
+    for (std::size_t i = 0; i < frames; ++i) {
+        delay_ += std::clamp((targetDelay_ - delay_) * glideCoefficient_, -kMaxGlideRate, kMaxGlideRate);
+        feedback_ += (targetFeedback_ - feedback_) * glideCoefficient_;
+        const float yl = lineLeft_.readFractional(delay_);
+        const float yr = lineRight_.readFractional(delay_);
+        lineLeft_.write(left[i] + feedback_ * yl);
+        lineRight_.write(right[i] + feedback_ * yr);
+        wetLeft[i] = yl;
+        wetRight[i] = yr;
+    }
+    if (std::fabs(delay_ - targetDelay_) < 1e-3f) delay_ = targetDelay_;
+    if (std::fabs(feedback_ - targetFeedback_) < 1e-5f) feedback_ = targetFeedback_;
+}
+
+} // namespace sleepster
@@ -0,0 +1,38 @@
+//
+//  DelayLine.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/DelayLine.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace sleepster {
+
+DelayLine::DelayLine(std::size_t history) {
+    std::size_t size = 1;
+    while (size < history + 1) size <<= 1;
+    buffer_.assign(size, 0.0f);
+    mask_ = size - 1;
+}
+
+void DelayLine::clear() noexcept {
+    std::fill(buffer_.begin(), buffer_.end(), 0.0f);
+}
+
+void DelayLine::readBlock(std::size_t oldestDelay, float* out, std::size_t count) const noexcept {
+    const std::size_t start = (writeIndex_ - oldestDelay) & mask_;
+    const std::size_t first = std::min(count, buffer_.size() - start);
+    std::memcpy(out, buffer_.data() + start, first * sizeof(float));
+    std::memcpy(out + first, buffer_.data(), (count - first) * sizeof(float));
+}
+
+void DelayLine::writeBlock(const float* in, std::size_t count) noexcept {
+    const std::size_t first = std::min(count, buffer_.size() - writeIndex_);
+    std::memcpy(buffer_.data() + writeIndex_, in, first * sizeof(float));
+    std::memcpy(buffer_.data(), in + first, (count - first) * sizeof(float));
+    writeIndex_ = (writeIndex_ + count) & mask_;
+}
+
+} // namespace sleepster
@@ -0,0 +1,75 @@
+//
+//  EchoReference.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/EchoReference.hpp"
+
+#include <algorithm>
+
+namespace sleepster {
+
+namespace {
+
+std::size_t roundUpToPowerOfTwo(std::size_t value) noexcept {
+    std::size_t result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+} // namespace
+
+EchoReference::EchoReference(std::size_t minimumFrames)
+    : capacity_(roundUpToPowerOfTwo(std::max<std::size_t>(minimumFrames, 64))),
+      mask_(capacity_ - 1),
+      samples_(new std::atomic<float>[capacity_]) {
+    for (std::size_t i = 0; i < capacity_; ++i) samples_[i].store(0.0f, std::memory_order_relaxed);
+}
+
+void EchoReference::write(const float* left, const float* right, std::size_t frames, int64_t position) noexcept {
+    int64_t end = end_.load(std::memory_order_relaxed);
+    const int64_t oldest = std::max(begin_.load(std::memory_order_relaxed), end - static_cast<int64_t>(capacity_));
+    if (!written_ || position < oldest) {
+        written_ = true;
+        begin_.store(position, std::memory_order_relaxed);
+        end = position;
+    }
+    // A step back rewrites samples a reader may be copying, so it runs
+    // under an odd count the reader checks, like a seqlock.
+    const bool rewrite = position < end;
+    const uint64_t rewrites = rewrites_.load(std::memory_order_relaxed);
+    if (rewrite) rewrites_.store(rewrites + 1, std::memory_order_relaxed);
+    const int64_t newEnd = std::max(end, position + static_cast<int64_t>(frames));
+    claimed_.store(newEnd, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (int64_t gap = std::max(end, position - static_cast<int64_t>(capacity_)); gap < position; ++gap) {
+        at(gap).store(0.0f, std::memory_order_relaxed);
+    }
+    for (std::size_t i = 0; i < frames; ++i) {
+        at(position + static_cast<int64_t>(i)).store(0.5f * (left[i] + right[i]), std::memory_order_relaxed);
+    }
+    if (rewrite) rewrites_.store(rewrites + 2, std::memory_order_release);
+    end_.store(newEnd, std::memory_order_release);
+}
+
+bool EchoReference::read(float* out, std::size_t frames, int64_t position) const noexcept {
+    const uint64_t rewrites = rewrites_.load(std::memory_order_acquire);
+    const int64_t end = end_.load(std::memory_order_acquire);
+    const int64_t begin = begin_.load(std::memory_order_relaxed);
+    const int64_t last = position + static_cast<int64_t>(frames);
+    if ((rewrites & 1) != 0 || frames > capacity_ || position < begin || last > end) return false;
+
+    for (std::size_t i = 0; i < frames; ++i) {
+        out[i] = at(position + static_cast<int64_t>(i)).load(std::memory_order_relaxed);
+    }
+
+    // Seqlock check: if the writer claimed any of the span, rewrote any of
+    // it or restarted while it was copied, the copy may be torn.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const int64_t claimed = claimed_.load(std::memory_order_relaxed);
+    return begin_.load(std::memory_order_relaxed) == begin && rewrites_.load(std::memory_order_relaxed) == rewrites
+           && position >= claimed - static_cast<int64_t>(capacity_);
+}
+
+} // namespace sleepster
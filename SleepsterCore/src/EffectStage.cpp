@@ -0,0 +1,61 @@
+//
+//  EffectStage.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/EffectStage.hpp"
+
+#include "sleepster/MixKernels.hpp"
+
+#include <algorithm>
+
+namespace sleepster {
+
+void WetDryMix::rampTo(float wet, uint64_t frames) noexcept {
+    wet = std::clamp(wet, 0.0f, 1.0f);
+    dry_.start(1.0f - wet, frames, RampCurve::Linear);
+    wet_.start(wet, frames, RampCurve::Linear);
+}
+
+void WetDryMix::settle() noexcept {
+    dry_.reset(dry_.target());
+    wet_.reset(wet_.target());
+}
+
+void WetDryMix::apply(float* left, float* right, const float* wetLeft, const float* wetRight,
+                      std::size_t frames) noexcept {
+    for (std::size_t offset = 0; offset < frames;) {
+        float gainStart = 0.0f;
+        float gainEnd = 0.0f;
+        const std::size_t span = dry_.nextSpan(frames - offset, gainStart, gainEnd);
+        kernels::applyGainRamp(left + offset, gainStart, gainEnd, span);
+        kernels::applyGainRamp(right + offset, gainStart, gainEnd, span);
+        offset += span;
+    }
+    for (std::size_t offset = 0; offset < frames;) {
+        float gainStart = 0.0f;
+        float gainEnd = 0.0f;
+        const std::size_t span = wet_.nextSpan(frames - offset, gainStart, gainEnd);
+        kernels::mixAddRamp(left + offset, wetLeft + offset, gainStart, gainEnd, span);
+        kernels::mixAddRamp(right + offset, wetRight + offset, gainStart, gainEnd, span);
+        offset += span;
+    }
+}
+
+bool TailTracker::shouldRun(const float* left, const float* right, std::size_t frames) noexcept {
+    const float level = std::max(kernels::peak(left, frames), kernels::peak(right, frames));
+    if (level > kSilence) {
+        silentFrames_ = 0;
+        asleep_ = false;
+        return true;
+    }
+    if (asleep_) return false;
+    if (silentFrames_ >= tailFrames_) {
+        asleep_ = true;
+        return false;
+    }
+    silentFrames_ += frames;
+    return true;
+}
+
+} // namespace sleepster
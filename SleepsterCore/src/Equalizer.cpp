@@ -0,0 +1,315 @@
+//
+//  Equalizer.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/Equalizer.hpp"
+
+#include "sleepster/Simd.hpp"
+#include "sleepster/Trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sleepster {
+
+namespace {
+
+constexpr std::size_t laneOf(std::size_t band, std::size_t channel) noexcept {
+    return (band / 2) * 4 + (band % 2) * 2 + channel;
+}
+
+} // namespace
+
+Equalizer::Equalizer(double sampleRate, std::size_t maxBlockFrames)
+    : sampleRate_(sampleRate),
+      maxBlockFrames_(std::max<std::size_t>(maxBlockFrames, 1)),
+      interleaved_(2 * std::max<std::size_t>(maxBlockFrames, 1)) {
+    std::fill(std::begin(current_.b0), std::end(current_.b0), 1.0f);
+    target_ = current_;
+    publish();
+}
+
+// MARK: - Control thread
+
+void Equalizer::setGains(const float* gainsDb, std::size_t count) {
+    for (std::size_t band = 0; band < kBandCount; ++band) {
+        gains_[band] = band < count && std::isfinite(gainsDb[band])
+            ? std::clamp(gainsDb[band], -24.0f, 24.0f)
+            : 0.0f;
+    }
+    publish();
+}
+
+void Equalizer::setBandwidth(float octaves) {
+    bandwidth_ = std::clamp(octaves, 0.05f, 5.0f);
+    publish();
+}
+
+void Equalizer::setEnabled(bool enabled) {
+    enabled_ = enabled;
+    publish();
+}
+
+Equalizer::Curve Equalizer::design(const float* gainsDb, std::size_t count) const {
+    Curve curve;
+    for (std::size_t band = 0; band < kBandCount; ++band) {
+        const float gain = band < count && std::isfinite(gainsDb[band])
+            ? std::clamp(gainsDb[band], -24.0f, 24.0f)
+            : 0.0f;
+        curve.bands[band] = BiquadCoefficients::peaking(sampleRate_, kFrequencies[band], gain, bandwidth_);
+        curve.flat = curve.flat && gain == 0.0f;
+    }
+    return curve;
+}
+
+void Equalizer::publish() {
+    // Design the whole curve here so the render thread sees one consistent
+    // update rather than ten band-by-band changes.
+    snapshots_.back() = design(gains_.data(), enabled_ ? kBandCount : 0);
+    snapshots_.publish();
+}
+
+// MARK: - Render thread
+
+void Equalizer::process(float* left, float* right, std::size_t frames) noexcept {
+    processChunked<true>(left, right, frames);
+}
+
+void Equalizer::processScalar(float* left, float* right, std::size_t frames) noexcept {
+    processChunked<false>(left, right, frames);
+}
+
+void Equalizer::glideTo(const Curve& curve) noexcept {
+    overridden_ = true;
+    beginGlide(curve);
+}
+
+void Equalizer::restore() noexcept {
+    if (!overridden_) return;
+    overridden_ = false;
+    // The constructor published a curve, so front() holds a real one even
+    // before the first block.
+    snapshots_.update();
+    beginGlide(snapshots_.front());
+}
+
+template <bool Vectorized>
+void Equalizer::processChunked(float* left, float* right, std::size_t frames) noexcept {
+    if (snapshots_.update() && !overridden_) beginGlide(snapshots_.front());
+
+    if (!idle_ && targetFlat_ && glideRemaining_ == 0) {
+        // Flat sections leave their state at exactly zero within two samples;
+        // only then can the work be skipped without a discontinuity.
+        const bool settled = std::all_of(std::begin(z1_), std::end(z1_), [](float z) { return z == 0.0f; })
+            && std::all_of(std::begin(z2_), std::end(z2_), [](float z) { return z == 0.0f; });
+        idle_ = settled;
+    }
+    if (idle_) return;
+    SLP_TRACE_SPAN(Audio, "equalizer.process");
+
+    std::size_t offset = 0;
+    while (offset < frames) {
+        std::size_t count = std::min(frames - offset, maxBlockFrames_);
+        if (glideRemaining_ > 0) count = std::min(count, glideFramesLeftInStep_);
+
+        if constexpr (Vectorized) {
+            runVector(left + offset, right + offset, count);
+        } else {
+            runScalar(left + offset, right + offset, count);
+        }
+
+        if (glideRemaining_ > 0) {
+            glideFramesLeftInStep_ -= count;
+            if (glideFramesLeftInStep_ == 0) advanceGlide();
+        }
+        offset += count;
+    }
+}
+
+void Equalizer::beginGlide(const Curve& curve) noexcept {
+    for (std::size_t band = 0; band < kBandCount; ++band) {
+        const BiquadCoefficients& c = curve.bands[band];
+        for (std::size_t channel = 0; channel < 2; ++channel) {
+            const std::size_t lane = laneOf(band, channel);
+            target_.b0[lane] = c.b0;
+            target_.b1[lane] = c.b1;
+            target_.b2[lane] = c.b2;
+            target_.a1[lane] = c.a1;
+            target_.a2[lane] = c.a2;
+        }
+    }
+    targetFlat_ = curve.flat;
+
+    if (idle_) {
+        if (curve.flat) return;
+        // Waking up: start from a flat response with clean state.
+        std::fill(std::begin(current_.b0), std::end(current_.b0), 1.0f);
+        for (float* term : {current_.b1, current_.b2, current_.a1, current_.a2}) {
+            std::fill(term, term + kLanes, 0.0f);
+        }
+        std::fill(std::begin(z1_), std::end(z1_), 0.0f);
+        std::fill(std::begin(z2_), std::end(z2_), 0.0f);
+        idle_ = false;
+    }
+
+    // Every peaking section's denominator lies inside the (convex) stability
+    // triangle, so straight-line interpolation between two of them stays stable.
+    glideSteps_ = std::max<std::size_t>(
+        1, static_cast<std::size_t>(std::ceil(kGlideSeconds * sampleRate_ / kGlideStepFrames)));
+    const float scale = 1.0f / static_cast<float>(glideSteps_);
+    for (std::size_t lane = 0; lane < kLanes; ++lane) {
+        step_.b0[lane] = (target_.b0[lane] - current_.b0[lane]) * scale;
+        step_.b1[lane] = (target_.b1[lane] - current_.b1[lane]) * scale;
+        step_.b2[lane] = (target_.b2[lane] - current_.b2[lane]) * scale;
+        step_.a1[lane] = (target_.a1[lane] - current_.a1[lane]) * scale;
+        step_.a2[lane] = (target_.a2[lane] - current_.a2[lane]) * scale;
+    }
+    glideRemaining_ = glideSteps_;
+    glideFramesLeftInStep_ = kGlideStepFrames;
+}
+
+void Equalizer::advanceGlide() noexcept {
+    if (--glideRemaining_ == 0) {
+        current_ = target_;
+        return;
+    }
+    for (std::size_t lane = 0; lane < kLanes; ++lane) {
+        current_.b0[lane] += step_.b0[lane];
+        current_.b1[lane] += step_.b1[lane];
+        current_.b2[lane] += step_.b2[lane];
+        current_.a1[lane] += step_.a1[lane];
+        current_.a2[lane] += step_.a2[lane];
+    }
+    glideFramesLeftInStep_ = kGlideStepFrames;
+}
+
+void Equalizer::runVector(float* left, float* right, std::size_t frames) noexcept {
+    using namespace simd;
+    // The wavefront needs at least one full diagonal.
+    if (frames < kBandCount) {
+        runScalar(left, right, frames);
+        return;
+    }
+
+    float* buf = interleaved_.data();
+    for (std::size_t i = 0; i < frames; ++i) {
+        buf[2 * i] = left[i];
+        buf[2 * i + 1] = right[i];
+    }
+
+    auto scalarLane = [this](std::size_t lane, float x) noexcept {
+        const BiquadCoefficients c{current_.b0[lane], current_.b1[lane], current_.b2[lane],
+                                   current_.a1[lane], current_.a2[lane]};
+        BiquadState s{z1_[lane], z2_[lane]};
+        const float y = processBiquad(c, s, x);
+        z1_[lane] = s.z1;
+        z2_[lane] = s.z2;
+        return y;
+    };
+
+    // Wavefront: at step n, band b filters sample n - b, so every band's
+    // input is some band's output from the previous step and all five
+    // vectors (two bands x two channels each) advance independently. The
+    // triangles before the first full diagonal and after the last one run
+    // one lane at a time. edge[b][k] holds band b's output for sample k of
+    // the head, or for sample frames-1-k of the tail.
+    constexpr std::size_t kDepth = kBandCount - 1;
+    float edge[kBandCount][kDepth][2];
+
+    for (std::size_t n = 0; n < kDepth; ++n) {
+        float l = buf[2 * n];
+        float r = buf[2 * n + 1];
+        for (std::size_t band = 0; band + n < kDepth; ++band) {
+            l = edge[band][n][0] = scalarLane(laneOf(band, 0), l);
+            r = edge[band][n][1] = scalarLane(laneOf(band, 1), r);
+        }
+    }
+
+    f32x4 b0[kPairs], b1[kPairs], b2[kPairs], a1[kPairs], a2[kPairs], z1[kPairs], z2[kPairs], y[kPairs];
+    for (std::size_t j = 0; j < kPairs; ++j) {
+        const std::size_t base = j * 4;
+        b0[j] = load(current_.b0 + base);
+        b1[j] = load(current_.b1 + base);
+        b2[j] = load(current_.b2 + base);
+        a1[j] = load(current_.a1 + base);
+        a2[j] = load(current_.a2 + base);
+        z1[j] = load(z1_ + base);
+        z2[j] = load(z2_ + base);
+        // As if step kDepth - 1 had run: band 2j at sample kDepth-1-2j,
+        // band 2j+1 one sample earlier (or nothing, for the last band).
+        const std::size_t low = kDepth - 1 - 2 * j;
+        const bool hasHigh = low > 0;
+        y[j] = set(edge[2 * j][low][0], edge[2 * j][low][1],
+                   hasHigh ? edge[2 * j + 1][low - 1][0] : 0.0f,
+                   hasHigh ? edge[2 * j + 1][low - 1][1] : 0.0f);
+    }
+
+    for (std::size_t n = kDepth; n < frames; ++n) {
+        f32x4 x[kPairs];
+        x[0] = loadPairUnderLow(buf + 2 * n, y[0]);
+        for (std::size_t j = 1; j < kPairs; ++j) x[j] = highLow(y[j - 1], y[j]);
+        for (std::size_t j = 0; j < kPairs; ++j) {
+            y[j] = madd(z1[j], b0[j], x[j]);
+            z1[j] = sub(madd(z2[j], b1[j], x[j]), mul(a1[j], y[j]));
+            z2[j] = sub(mul(b2[j], x[j]), mul(a2[j], y[j]));
+        }
+        storeHighPair(buf + 2 * (n - kDepth), y[kPairs - 1]);
+    }
+
+    for (std::size_t j = 0; j < kPairs; ++j) {
+        store(z1_ + j * 4, z1[j]);
+        store(z2_ + j * 4, z2[j]);
+    }
+
+    // Tail: band b still owes samples frames-b .. frames-1. The first comes
+    // from the last wavefront step, the rest from band b-1's tail.
+    for (std::size_t band = 1; band < kBandCount; ++band) {
+        const std::size_t prev = band - 1;
+        const f32x4 last = y[prev / 2];
+        const int offset = prev % 2 == 0 ? 0 : 2;
+        for (std::size_t k = band; k-- > 0;) {
+            // k counts back from the end: sample frames-1-k.
+            float l = 0.0f;
+            float r = 0.0f;
+            if (k == band - 1) {
+                l = lane(last, offset);
+                r = lane(last, offset + 1);
+            } else {
+                l = edge[prev][k][0];
+                r = edge[prev][k][1];
+            }
+            l = scalarLane(laneOf(band, 0), l);
+            r = scalarLane(laneOf(band, 1), r);
+            if (band == kBandCount - 1) {
+                buf[2 * (frames - 1 - k)] = l;
+                buf[2 * (frames - 1 - k) + 1] = r;
+            } else {
+                edge[band][k][0] = l;
+                edge[band][k][1] = r;
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < frames; ++i) {
+        left[i] = buf[2 * i];
+        right[i] = buf[2 * i + 1];
+    }
+}
+
+void Equalizer::runScalar(float* left, float* right, std::size_t frames) noexcept {
+    for (std::size_t band = 0; band < kBandCount; ++band) {
+        for (std::size_t channel = 0; channel < 2; ++channel) {
+            const std::size_t lane = laneOf(band, channel);
+            const BiquadCoefficients c{current_.b0[lane], current_.b1[lane], current_.b2[lane],
+                                       current_.a1[lane], current_.a2[lane]};
+            BiquadState s{z1_[lane], z2_[lane]};
+            float* samples = channel == 0 ? left : right;
+            for (std::size_t i = 0; i < frames; ++i) samples[i] = processBiquad(c, s, samples[i]);
+            z1_[lane] = s.z1;
+            z2_[lane] = s.z2;
+        }
+    }
+}
+
+} // namespace sleepster
@@ -0,0 +1,134 @@
+//
+//  FramePacer.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/FramePacer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sleepster {
+
+// MARK: - FrameTimeHistogram
+
+FrameTimeHistogram::FrameTimeHistogram(std::size_t capacity) : ring_(std::max<std::size_t>(1, capacity)) {}
+
+std::size_t FrameTimeHistogram::binOf(double seconds) noexcept {
+    if (!(seconds > 0.0)) return 0;
+    const double bin = std::ceil(seconds / kBinSeconds);
+    return bin >= static_cast<double>(kBinCount - 1) ? kBinCount - 1 : static_cast<std::size_t>(bin);
+}
+
+void FrameTimeHistogram::record(double seconds) noexcept {
+    if (count_ == ring_.size()) {
+        --bins_[ring_[next_]];
+    } else {
+        ++count_;
+    }
+    const std::size_t bin = binOf(seconds);
+    ring_[next_] = static_cast<uint16_t>(bin);
+    ++bins_[bin];
+    next_ = (next_ + 1) % ring_.size();
+}
+
+void FrameTimeHistogram::clear() noexcept {
+    bins_.fill(0);
+    next_ = 0;
+    count_ = 0;
+}
+
+double FrameTimeHistogram::percentile(double fraction) const noexcept {
+    if (count_ == 0) return 0.0;
+    const double clamped = std::clamp(fraction, 0.0, 1.0);
+    const auto rank = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(clamped * count_)));
+    std::size_t seen = 0;
+    for (std::size_t bin = 0; bin < kBinCount; ++bin) {
+        seen += bins_[bin];
+        if (seen >= rank) return static_cast<double>(bin) * kBinSeconds;
+    }
+    return static_cast<double>(kBinCount - 1) * kBinSeconds;
+}
+
+// MARK: - FramePacer
+
+namespace {
+
+constexpr int kSlowestLevel = static_cast<int>(kPaceLevels.size()) - 1;
+
+double intervalOf(int level) noexcept { return 1.0 / kPaceLevels[level].framesPerSecond; }
+
+} // namespace
+
+FramePacer::FramePacer(const FramePacerConfig& config)
+    : config_(config), histogram_(config.windowFrames), hold_(config.holdSeconds) {}
+
+bool FramePacer::recordFrame(double seconds) noexcept {
+    if (!(seconds > 0.0)) return false;
+    time_ += seconds;
+    ++frames_;
+    ++framesAtLevel_;
+    if (seconds > intervalOf(level_) * config_.lateFactor) ++lateFrames_;
+    histogram_.record(seconds);
+    if (framesAtLevel_ < config_.settleFrames) return false;
+
+    const double frameTime = histogram_.percentile(config_.percentile);
+    if (frameTime > intervalOf(level_) * config_.lateFactor && level_ < kSlowestLevel) {
+        // Straight to the fastest level the window says is sustainable.
+        int level = level_ + 1;
+        while (level < kSlowestLevel && frameTime > intervalOf(level) * config_.lateFactor) ++level;
+        if (probeSince_ >= 0.0) hold_ = std::min(hold_ * 2.0, config_.maxHoldSeconds);
+        probeSince_ = -1.0;
+        moveTo(level, frameTime);
+        return true;
+    }
+
+    if (probeSince_ >= 0.0 && time_ - probeSince_ >= config_.probeSeconds) {
+        probeSince_ = -1.0;
+        hold_ = config_.holdSeconds;
+    }
+    if (level_ > 0 && probeSince_ < 0.0 && time_ - levelSince_ >= hold_ &&
+        frameTime <= intervalOf(level_) * config_.healthyFactor) {
+        probeSince_ = time_;
+        moveTo(level_ - 1, frameTime);
+        return true;
+    }
+    return false;
+}
+
+void FramePacer::moveTo(int level, double frameTime) noexcept {
+    history_[changes_ % kChangeHistory] = {time_, level_, level, frameTime};
+    ++changes_;
+    level_ = level;
+    levelSince_ = time_;
+    framesAtLevel_ = 0;
+    // Intervals at the old rate say nothing about the new one.
+    histogram_.clear();
+}
+
+std::size_t FramePacer::recentChangeCount() const noexcept {
+    return static_cast<std::size_t>(std::min<uint64_t>(changes_, kChangeHistory));
+}
+
+const LevelChange& FramePacer::recentChange(std::size_t index) const noexcept {
+    const uint64_t first = changes_ - recentChangeCount();
+    return history_[(first + index) % kChangeHistory];
+}
+
+// MARK: - FixedTimestep
+
+int FixedTimestep::advance(double seconds) noexcept {
+    if (seconds > 0.0) accumulated_ += seconds;
+    int steps = static_cast<int>(accumulated_ / step_);
+    if (steps > maxSteps_) {
+        steps = maxSteps_;
+        accumulated_ = 0.0;
+        return steps;
+    }
+    accumulated_ -= steps * step_;
+    // Rounding can leave a hair under zero or a whole step.
+    accumulated_ = std::clamp(accumulated_, 0.0, step_);
+    return steps;
+}
+
+} // namespace sleepster
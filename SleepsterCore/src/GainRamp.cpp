@@ -0,0 +1,88 @@
+//
+//  GainRamp.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/GainRamp.hpp"
+
+#include <algorithm>
+
+namespace sleepster {
+
+namespace {
+
+using ramp_detail::kSegments;
+using ramp_detail::Table;
+
+const Table& tableFor(RampCurve curve) noexcept {
+    switch (curve) {
+    case RampCurve::EqualPower: return ramp_detail::kEqualPower;
+    case RampCurve::Exponential: return ramp_detail::kExponential;
+    case RampCurve::Linear: break;
+    }
+    return ramp_detail::kLinear;
+}
+
+float lookup(const Table& table, double t) noexcept {
+    const double x = std::clamp(t, 0.0, 1.0) * kSegments;
+    const std::size_t index = std::min(static_cast<std::size_t>(x), kSegments - 1);
+    const float frac = static_cast<float>(x - static_cast<double>(index));
+    return table[index] + (table[index + 1] - table[index]) * frac;
+}
+
+} // namespace
+
+float rampShape(RampCurve curve, double t) noexcept {
+    return lookup(tableFor(curve), t);
+}
+
+void GainRamp::reset(float gain) noexcept {
+    from_ = target_ = current_ = gain;
+    length_ = position_ = 0;
+}
+
+void GainRamp::start(float target, uint64_t frames, RampCurve curve) noexcept {
+    if (frames == 0 || target == current_) {
+        reset(target);
+        return;
+    }
+    table_ = &tableFor(curve);
+    from_ = current_;
+    target_ = target;
+    length_ = frames;
+    position_ = 0;
+}
+
+std::size_t GainRamp::nextSpan(std::size_t maxFrames, float& gainStart, float& gainEnd) noexcept {
+    gainStart = current_;
+    if (!isRamping()) {
+        gainEnd = current_;
+        return maxFrames;
+    }
+
+    // The gain is linear between table knots, so stop at the next one.
+    // Knot k sits on the first frame at or after k/kSegments of the ramp.
+    const uint64_t k = position_ * kSegments / length_ + 1;
+    const uint64_t knot = (k * length_ + kSegments - 1) / kSegments;
+    const uint64_t end = std::min<uint64_t>({position_ + maxFrames, std::max(knot, position_ + 1), length_});
+
+    current_ = end == length_ ? target_ : valueAt(end);
+    gainEnd = current_;
+    const std::size_t span = static_cast<std::size_t>(end - position_);
+    position_ = end;
+    return span;
+}
+
+void GainRamp::advance(uint64_t frames) noexcept {
+    if (!isRamping()) return;
+    position_ = std::min(position_ + frames, length_);
+    current_ = position_ == length_ ? target_ : valueAt(position_);
+}
+
+float GainRamp::valueAt(uint64_t frame) const noexcept {
+    const double t = static_cast<double>(frame) / static_cast<double>(length_);
+    if (target_ >= from_) return from_ + (target_ - from_) * lookup(*table_, t);
+    return target_ + (from_ - target_) * lookup(*table_, 1.0 - t);
+}
+
+} // namespace sleepster
@@ -0,0 +1,80 @@
+//
+//  MappedFile.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/MappedFile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <utility>
+
+namespace sleepster {
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info {};
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file.
+    ::close(fd);
+    if (mapping == MAP_FAILED) return false;
+
+    data_ = static_cast<const uint8_t*>(mapping);
+    size_ = static_cast<std::size_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::close() noexcept {
+    if (data_) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
+
+void MappedFile::adviseSequential(std::size_t offset, std::size_t length) const noexcept {
+    if (!data_ || offset >= size_) return;
+    const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    const std::size_t start = offset & ~(page - 1);
+    const std::size_t end = offset + length < size_ ? offset + length : size_;
+    madvise(const_cast<uint8_t*>(data_) + start, end - start, MADV_SEQUENTIAL);
+}
+
+void MappedFile::release(std::size_t offset, std::size_t length) const noexcept {
+    if (!data_ || offset >= size_) return;
+    const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    // Round inwards so pages still partly in use stay mapped.
+    const std::size_t start = (offset + page - 1) & ~(page - 1);
+    const std::size_t end = (offset + length < size_ ? offset + length : size_) & ~(page - 1);
+    if (end > start) madvise(const_cast<uint8_t*>(data_) + start, end - start, MADV_DONTNEED);
+}
+
+} // namespace sleepster
@@ -0,0 +1,367 @@
+//
+//  MaskingController.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/MaskingController.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+
+namespace sleepster {
+
+namespace {
+
+constexpr float kNoLevel = -std::numeric_limits<float>::infinity();
+/// Weight each window's regression sums keep per later window; about 40 s
+/// of memory at the default period.
+constexpr double kForget = 0.97;
+/// Frames the regression needs before its coupling is trusted.
+constexpr double kMinFrames = 12.0;
+/// Output power below this in a band is silence: the microphone hears only
+/// the room there.
+constexpr double kSilence = 1e-14;
+/// Weight of each window's gain target in the running average.
+constexpr float kTargetSmoothing = 0.3f;
+/// Weight of each window's output level in a band's running average.
+constexpr float kBaseSmoothing = 0.2f;
+/// Lowest band a phone microphone measures usefully.
+constexpr float kLowestMeasured = 50.0f;
+
+std::size_t frameSizeFor(double sampleRate) {
+    // The largest power of two within about 45 ms.
+    std::size_t size = 256;
+    while (static_cast<double>(size * 2) <= 0.045 * sampleRate) size *= 2;
+    return size;
+}
+
+double toDb(double power) {
+    return power > 0.0 ? 10.0 * std::log10(power) : -std::numeric_limits<double>::infinity();
+}
+
+float stepToward(float value, float target, float rise, float fall, float deadband) {
+    const float delta = target - value;
+    if (std::fabs(delta) < deadband) return value;
+    return value + std::clamp(delta, -fall, rise);
+}
+
+template <typename T>
+std::size_t bytes(const std::vector<T>& v) {
+    return v.capacity() * sizeof(T);
+}
+
+} // namespace
+
+MaskingController::MaskingController(const MaskingConfig& config)
+    : config_(config), fft_(frameSizeFor(config.sampleRate)) {
+    const std::size_t size = fft_.size();
+    windowFrames_ = std::max<std::size_t>(
+        1, static_cast<std::size_t>(std::lround(config.analysisSeconds * config.sampleRate / size)));
+    windowSamples_ = windowFrames_ * size;
+    periodSamples_ = std::max(windowSamples_, static_cast<std::size_t>(config.periodSeconds * config.sampleRate));
+
+    hann_.resize(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        hann_[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * static_cast<double>(i) / size));
+    }
+    microphone_.assign(size, 0.0f);
+    reference_.assign(size, 0.0f);
+    power_.assign(fft_.binCount(), 0.0f);
+    frameMicrophone_.assign(windowFrames_ * kBandCount, 0.0);
+    frameReference_.assign(windowFrames_ * kBandCount, 0.0);
+
+    // Octave bands around the equalizer's centres.
+    const double binHz = config.sampleRate / static_cast<double>(size);
+    const double nyquist = config.sampleRate / 2.0;
+    for (std::size_t b = 0; b < kBandCount; ++b) {
+        Band& band = bands_[b];
+        const double centre = Equalizer::kFrequencies[b];
+        const double low = centre / std::sqrt(2.0);
+        const double high = centre * std::sqrt(2.0);
+        band.firstBin = static_cast<uint32_t>(std::max(1.0, std::ceil(low / binHz)));
+        band.lastBin = static_cast<uint32_t>(std::min(std::floor(high / binHz), static_cast<double>(size / 2)));
+        band.measured = centre >= kLowestMeasured && high <= nyquist && band.lastBin >= band.firstBin;
+    }
+
+    // How far each equalizer bell moves each band's measured power, per dB
+    // of gain: the bell's power response averaged over the band's bins.
+    constexpr double kProbeDb = 6.0;
+    for (std::size_t k = 0; k < kBandCount; ++k) {
+        const BiquadCoefficients bell =
+            BiquadCoefficients::peaking(config.sampleRate, Equalizer::kFrequencies[k], kProbeDb, 1.0);
+        for (std::size_t b = 0; b < kBandCount; ++b) {
+            const Band& band = bands_[b];
+            double power = 0.0;
+            for (uint32_t bin = band.firstBin; bin <= band.lastBin; ++bin) {
+                const std::complex<double> z = std::polar(1.0, -2.0 * M_PI * bin / static_cast<double>(size));
+                const std::complex<double> numerator =
+                    static_cast<double>(bell.b0) + z * (static_cast<double>(bell.b1) + z * static_cast<double>(bell.b2));
+                const std::complex<double> denominator = 1.0 + z * (static_cast<double>(bell.a1) + z * static_cast<double>(bell.a2));
+                const std::complex<double> h = numerator / denominator;
+                power += std::norm(h);
+            }
+            const uint32_t bins = band.lastBin >= band.firstBin ? band.lastBin - band.firstBin + 1 : 0;
+            interaction_[b][k] = bins > 0 ? static_cast<float>(toDb(power / bins) / kProbeDb) : (b == k ? 1.0f : 0.0f);
+        }
+    }
+}
+
+// MARK: - Clock
+
+std::size_t MaskingController::samplesUntilWindow() const noexcept {
+    return listening() ? 0 : periodSamples_ - phase_;
+}
+
+void MaskingController::process(const float* microphone, const float* reference, std::size_t count) noexcept {
+    const std::size_t size = fft_.size();
+    std::size_t at = 0;
+    while (at < count) {
+        if (!listening()) {
+            const std::size_t skip = std::min(count - at, periodSamples_ - phase_);
+            at += skip;
+            phase_ += skip;
+            if (phase_ == periodSamples_) phase_ = 0;
+            continue;
+        }
+        const std::size_t take = std::min({count - at, windowSamples_ - phase_, size - filled_});
+        std::copy(microphone + at, microphone + at + take, microphone_.begin() + filled_);
+        std::copy(reference + at, reference + at + take, reference_.begin() + filled_);
+        filled_ += take;
+        phase_ += take;
+        at += take;
+        if (filled_ == size) {
+            analyzeFrame();
+            filled_ = 0;
+        }
+        if (phase_ == windowSamples_) closeWindow();
+    }
+}
+
+void MaskingController::advance(std::size_t count) noexcept {
+    while (count > 0) {
+        if (listening()) {
+            // A gap in the audio breaks the frame being gathered.
+            filled_ = 0;
+            const std::size_t skip = std::min(count, windowSamples_ - phase_);
+            count -= skip;
+            phase_ += skip;
+            if (phase_ == windowSamples_) closeWindow();
+            continue;
+        }
+        const std::size_t skip = std::min(count, periodSamples_ - phase_);
+        count -= skip;
+        phase_ += skip;
+        if (phase_ == periodSamples_) phase_ = 0;
+    }
+}
+
+// MARK: - Analysis
+
+void MaskingController::analyzeFrame() noexcept {
+    if (frames_ == windowFrames_) return;
+    const std::size_t size = fft_.size();
+    double* micBands = frameMicrophone_.data() + frames_ * kBandCount;
+    double* refBands = frameReference_.data() + frames_ * kBandCount;
+
+    for (int pass = 0; pass < 2; ++pass) {
+        std::vector<float>& samples = pass == 0 ? microphone_ : reference_;
+        double* out = pass == 0 ? micBands : refBands;
+        for (std::size_t i = 0; i < size; ++i) samples[i] *= hann_[i];
+        fft_.powerSpectrum(samples.data(), power_.data());
+        for (std::size_t b = 0; b < kBandCount; ++b) {
+            const Band& band = bands_[b];
+            double sum = 0.0;
+            if (band.measured) {
+                for (uint32_t k = band.firstBin; k <= band.lastBin; ++k) sum += power_[k];
+            }
+            out[b] = sum;
+        }
+    }
+    ++frames_;
+    ++analyzedFrames_;
+}
+
+void MaskingController::closeWindow() noexcept {
+    ++windows_;
+    const std::size_t frames = frames_;
+    frames_ = 0;
+    filled_ = 0;
+    if (frames < 2) return;
+
+    std::array<float, kBandCount> outputDb;
+    outputDb.fill(kNoLevel);
+    for (std::size_t b = 0; b < kBandCount; ++b) {
+        Band& band = bands_[b];
+        if (!band.measured) continue;
+
+        double meanX = 0.0;
+        double meanY = 0.0;
+        for (std::size_t f = 0; f < frames; ++f) {
+            meanX += frameReference_[f * kBandCount + b];
+            meanY += frameMicrophone_[f * kBandCount + b];
+        }
+        meanX /= static_cast<double>(frames);
+        meanY /= static_cast<double>(frames);
+
+        // Within-window deviations: the microphone repeats the output's
+        // fluctuations scaled by the coupling; the room's are unrelated.
+        double sxx = 0.0;
+        double sxy = 0.0;
+        for (std::size_t f = 0; f < frames; ++f) {
+            const double dx = frameReference_[f * kBandCount + b] - meanX;
+            sxx += dx * dx;
+            sxy += dx * (frameMicrophone_[f * kBandCount + b] - meanY);
+        }
+        band.frames = band.frames * kForget + static_cast<double>(frames);
+        band.sxx = band.sxx * kForget + sxx;
+        band.sxy = band.sxy * kForget + sxy;
+        if (band.frames >= kMinFrames && band.sxx > 0.0) {
+            band.coupling = std::max(0.0, band.sxy / band.sxx);
+            band.coupled = true;
+        }
+
+        // The room is what the echo does not explain. The echo's cross
+        // terms with the room average out over the window's frames.
+        double room;
+        if (meanX < kSilence) {
+            room = meanY;
+        } else if (band.coupled) {
+            room = std::max(0.0, meanY - band.coupling * meanX);
+            outputDb[b] = static_cast<float>(toDb(band.coupling * meanX));
+        } else {
+            continue;
+        }
+
+        // Follow a louder room quickly and a quieter one slowly.
+        if (!band.heard) {
+            band.ambient = room;
+            band.heard = true;
+        } else {
+            band.ambient += (room > band.ambient ? 0.2 : 0.1) * (room - band.ambient);
+        }
+    }
+    decide(outputDb);
+}
+
+// MARK: - Control
+
+void MaskingController::decide(const std::array<float, kBandCount>& outputDb) noexcept {
+    // Per band, the change from the user's own settings that would put the
+    // output `marginDb` above the room.
+    const std::array<float, kBandCount> applied = response(decision_.eqDb);
+    std::array<float, kBandCount> need;
+    std::array<float, kBandCount> candidates;
+    std::size_t valid = 0;
+    for (std::size_t b = 0; b < kBandCount; ++b) {
+        need[b] = kNoLevel;
+        if (outputDb[b] == kNoLevel || !bands_[b].heard) continue;
+        Band& band = bands_[b];
+        const float base = outputDb[b] - decision_.gainDb - applied[b];
+        band.base = band.based ? band.base + kBaseSmoothing * (base - band.base) : base;
+        band.based = true;
+        need[b] = ambientDb(b) + config_.marginDb - band.base;
+        candidates[valid++] = need[b] - config_.maxEqDb;
+    }
+    if (valid == 0) return;
+
+    // The least gain that lets the EQ lift enough bands the rest of the way.
+    const std::size_t index = static_cast<std::size_t>(
+        std::clamp(std::ceil(config_.coverage * static_cast<float>(valid)) - 1.0f, 0.0f, valid - 1.0f));
+    std::nth_element(candidates.begin(), candidates.begin() + index, candidates.begin() + valid);
+    // Averaged over a few windows, so one noisy estimate does not cross
+    // the deadband and send the gain off only to come back. The average may
+    // run a deadband past the limits, so that a room clearly beyond one is
+    // told apart from one that only grazes it.
+    const float target = std::clamp(candidates[index], config_.minGainDb - config_.deadbandDb,
+                                    config_.maxGainDb + config_.deadbandDb);
+    target_ = decided_ ? target_ + kTargetSmoothing * (target - target_) : target;
+
+    MaskingDecision next = decision_;
+    // Past a limit, go all the way to it.
+    const bool pinned = target_ <= config_.minGainDb || target_ >= config_.maxGainDb;
+    next.gainDb = stepToward(decision_.gainDb, std::clamp(target_, config_.minGainDb, config_.maxGainDb),
+                             config_.riseDbPerWindow, config_.fallDbPerWindow, pinned ? 0.0f : config_.deadbandDb);
+
+    // The response each band should get from the offsets. They only
+    // reshape: once the gain is at its floor in a quiet room, they are not
+    // allowed to turn everything down further.
+    std::array<float, kBandCount> wanted{};
+    float highest = kNoLevel;
+    for (std::size_t b = 0; b < kBandCount; ++b) {
+        if (need[b] == kNoLevel) continue;
+        wanted[b] = std::clamp(need[b] - next.gainDb, -config_.maxEqDb, config_.maxEqDb);
+        highest = std::max(highest, wanted[b]);
+    }
+    const float lift = std::max(0.0f, -highest);
+    for (float& value : wanted) value = std::min(value + lift, config_.maxEqDb);
+
+    const std::array<float, kBandCount> offsets = offsetsFor(wanted, need);
+    for (std::size_t b = 0; b < kBandCount; ++b) {
+        const bool pinnedOffset = std::fabs(offsets[b]) >= config_.maxEqDb;
+        next.eqDb[b] = stepToward(decision_.eqDb[b], offsets[b], config_.riseDbPerWindow, config_.fallDbPerWindow,
+                                  pinnedOffset ? 0.0f : config_.deadbandDb);
+    }
+
+    const std::array<float, kBandCount> shaped = response(next.eqDb);
+    std::size_t covered = 0;
+    for (std::size_t b = 0; b < kBandCount; ++b) {
+        if (need[b] != kNoLevel && next.gainDb + shaped[b] >= need[b] - config_.deadbandDb) ++covered;
+    }
+    next.coverage = static_cast<float>(covered) / static_cast<float>(valid);
+
+    changed_ = changed_ || !decided_ || next.gainDb != decision_.gainDb || next.eqDb != decision_.eqDb;
+    decided_ = true;
+    decision_ = next;
+}
+
+std::array<float, MaskingController::kBandCount> MaskingController::response(
+    const std::array<float, kBandCount>& offsets) const noexcept {
+    std::array<float, kBandCount> out{};
+    for (std::size_t b = 0; b < kBandCount; ++b) {
+        for (std::size_t k = 0; k < kBandCount; ++k) out[b] += interaction_[b][k] * offsets[k];
+    }
+    return out;
+}
+
+std::array<float, MaskingController::kBandCount> MaskingController::offsetsFor(
+    const std::array<float, kBandCount>& wanted, const std::array<float, kBandCount>& need) const noexcept {
+    // Neighbouring bells overlap, so each offset is solved for together
+    // with the others (projected Gauss-Seidel); unmeasured bands stay flat.
+    std::array<float, kBandCount> offsets{};
+    for (int sweep = 0; sweep < 24; ++sweep) {
+        for (std::size_t b = 0; b < kBandCount; ++b) {
+            if (need[b] == kNoLevel) continue;
+            float shaped = 0.0f;
+            for (std::size_t k = 0; k < kBandCount; ++k) shaped += interaction_[b][k] * offsets[k];
+            offsets[b] = std::clamp(offsets[b] + (wanted[b] - shaped) / interaction_[b][b], -config_.maxEqDb,
+                                    config_.maxEqDb);
+        }
+    }
+    return offsets;
+}
+
+bool MaskingController::takeDecision(MaskingDecision& out) noexcept {
+    out = decision_;
+    const bool changed = changed_;
+    changed_ = false;
+    return changed;
+}
+
+float MaskingController::ambientDb(std::size_t band) const noexcept {
+    const Band& b = bands_[band];
+    return b.heard ? static_cast<float>(std::max(toDb(b.ambient), -200.0)) : kNoLevel;
+}
+
+float MaskingController::couplingDb(std::size_t band) const noexcept {
+    const Band& b = bands_[band];
+    return b.coupled && b.coupling > 0.0 ? static_cast<float>(toDb(b.coupling)) : kNoLevel;
+}
+
+std::size_t MaskingController::memoryBytes() const noexcept {
+    return fft_.memoryBytes() + bytes(hann_) + bytes(microphone_) + bytes(reference_) + bytes(power_) +
+           bytes(frameMicrophone_) + bytes(frameReference_);
+}
+
+} // namespace sleepster
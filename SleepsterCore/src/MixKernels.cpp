@@ -0,0 +1,87 @@
+//
+//  MixKernels.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/MixKernels.hpp"
+
+#include "sleepster/Simd.hpp"
+
+#include <cmath>
+#include <cstring>
+
+namespace sleepster::kernels {
+
+using namespace simd;
+
+void clear(float* dst, std::size_t count) noexcept {
+    std::memset(dst, 0, count * sizeof(float));
+}
+
+void mixAddRamp(float* dst, const float* src, float gainStart, float gainEnd,
+                std::size_t count) noexcept {
+    if (count == 0) return;
+    std::size_t i = 0;
+
+    if (gainStart == gainEnd) {
+        if (gainStart == 0.0f) return;
+        const f32x4 g = splat(gainStart);
+        for (; i + kWidth <= count; i += kWidth) {
+            store(dst + i, madd(load(dst + i), load(src + i), g));
+        }
+        for (; i < count; ++i) dst[i] += src[i] * gainStart;
+        return;
+    }
+
+    const float step = (gainEnd - gainStart) / static_cast<float>(count);
+    f32x4 g = set(gainStart + step, gainStart + 2.0f * step, gainStart + 3.0f * step,
+                  gainStart + 4.0f * step);
+    const f32x4 gStep = splat(4.0f * step);
+    for (; i + kWidth <= count; i += kWidth) {
+        store(dst + i, madd(load(dst + i), load(src + i), g));
+        g = add(g, gStep);
+    }
+    for (; i < count; ++i) {
+        dst[i] += src[i] * (gainStart + step * static_cast<float>(i + 1));
+    }
+}
+
+void applyGainRamp(float* buffer, float gainStart, float gainEnd, std::size_t count) noexcept {
+    if (count == 0) return;
+    std::size_t i = 0;
+
+    if (gainStart == gainEnd) {
+        if (gainStart == 1.0f) return;
+        const f32x4 g = splat(gainStart);
+        for (; i + kWidth <= count; i += kWidth) {
+            store(buffer + i, mul(load(buffer + i), g));
+        }
+        for (; i < count; ++i) buffer[i] *= gainStart;
+        return;
+    }
+
+    const float step = (gainEnd - gainStart) / static_cast<float>(count);
+    f32x4 g = set(gainStart + step, gainStart + 2.0f * step, gainStart + 3.0f * step,
+                  gainStart + 4.0f * step);
+    const f32x4 gStep = splat(4.0f * step);
+    for (; i + kWidth <= count; i += kWidth) {
+        store(buffer + i, mul(load(buffer + i), g));
+        g = add(g, gStep);
+    }
+    for (; i < count; ++i) {
+        buffer[i] *= gainStart + step * static_cast<float>(i + 1);
+    }
+}
+
+float peak(const float* src, std::size_t count) noexcept {
+    std::size_t i = 0;
+    f32x4 m = splat(0.0f);
+    for (; i + kWidth <= count; i += kWidth) {
+        m = max(m, abs(load(src + i)));
+    }
+    float result = std::fmax(std::fmax(lane(m, 0), lane(m, 1)), std::fmax(lane(m, 2), lane(m, 3)));
+    for (; i < count; ++i) result = std::fmax(result, std::fabs(src[i]));
+    return result;
+}
+
+} // namespace sleepster::kernels
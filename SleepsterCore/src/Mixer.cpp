@@ -0,0 +1,502 @@
+//
+//  Mixer.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/Mixer.hpp"
+
+#include "sleepster/MixKernels.hpp"
+#include "sleepster/Trace.hpp"
+
+#include <algorithm>
+
+namespace sleepster {
+
+namespace {
+
+float clampVolume(float volume) noexcept {
+    // NaN compares false against everything and ends up silent.
+    if (!(volume > 0.0f)) return 0.0f;
+    return std::min(volume, 4.0f);
+}
+
+/// Stops and volume changes fade over this long to avoid clicks.
+constexpr double kDeclickSeconds = 0.005;
+
+/// Replaced timelines waiting for the control thread to free them.
+constexpr std::size_t kRetiredAutomations = 4;
+
+void applyGain(GainRamp& gain, float* left, float* right, std::size_t frames) noexcept {
+    std::size_t offset = 0;
+    while (offset < frames) {
+        float gainStart = 0.0f;
+        float gainEnd = 0.0f;
+        const std::size_t span = gain.nextSpan(frames - offset, gainStart, gainEnd);
+        kernels::applyGainRamp(left + offset, gainStart, gainEnd, span);
+        kernels::applyGainRamp(right + offset, gainStart, gainEnd, span);
+        offset += span;
+    }
+}
+
+bool isUnity(const GainRamp& gain) noexcept {
+    return !gain.isRamping() && gain.current() == 1.0f;
+}
+
+} // namespace
+
+Mixer::Mixer(const MixerConfig& config)
+    : config_(config),
+      slots_(config.maxVoices),
+      declickFrames_(static_cast<uint64_t>(config.sampleRate * kDeclickSeconds)),
+      commands_(config.commandQueueCapacity),
+      // Every voice can be released at most once before the control thread
+      // reclaims it, so this queue can never overflow for long.
+      releases_(config.maxVoices + 1),
+      // Each ramp ends exactly once; this covers a full command queue of
+      // ramps on top of one pending ramp per voice.
+      rampEvents_(config.commandQueueCapacity + config.maxVoices),
+      retiredAutomations_(kRetiredAutomations),
+      voices_(config.maxVoices),
+      activeSlots_(config.maxVoices),
+      scratchLeft_(config.maxBlockFrames),
+      scratchRight_(config.maxBlockFrames),
+      equalizer_(config.sampleRate, config.maxBlockFrames),
+      delay_(config.sampleRate, config.maxBlockFrames),
+      reverb_(config.sampleRate, config.maxBlockFrames) {
+    freeSlots_.reserve(config.maxVoices);
+    for (uint32_t slot = config.maxVoices; slot > 0; --slot) {
+        freeSlots_.push_back(slot - 1);
+    }
+}
+
+Mixer::~Mixer() {
+    // No render callback may be running any more; everything still owned by
+    // either queue or by a voice is destroyed here.
+    Command command{};
+    while (commands_.tryPop(command)) {
+        if (command.type == Command::Type::Play) delete command.source;
+        delete command.automation;
+    }
+    Release release{};
+    while (releases_.tryPop(release)) delete release.source;
+    for (RenderVoice& voice : voices_) delete voice.source;
+    Automation* automation = nullptr;
+    while (retiredAutomations_.tryPop(automation)) delete automation;
+    delete automation_;
+}
+
+// MARK: - Control thread
+
+VoiceId Mixer::play(std::unique_ptr<AudioSource> source, float volume) {
+    if (!source) return kInvalidVoice;
+    if (freeSlots_.empty()) return kInvalidVoice;
+
+    source->prepare(config_.sampleRate, config_.maxBlockFrames);
+
+    const uint32_t slot = freeSlots_.back();
+    Command command{Command::Type::Play, slot, clampVolume(volume), source.get()};
+    if (!send(command)) return kInvalidVoice;
+
+    source.release();
+    freeSlots_.pop_back();
+    slots_[slot].busy = true;
+    ++busyCount_;
+    return makeId(slot);
+}
+
+bool Mixer::stop(VoiceId voice) {
+    if (!validate(voice)) return false;
+    return send({Command::Type::Stop, slotOf(voice), 0.0f, nullptr});
+}
+
+void Mixer::stopAll() {
+    send({Command::Type::StopAll, 0, 0.0f, nullptr});
+}
+
+bool Mixer::setVolume(VoiceId voice, float volume) {
+    if (!validate(voice)) return false;
+    return send({Command::Type::SetVolume, slotOf(voice), clampVolume(volume), nullptr});
+}
+
+RampToken Mixer::rampVolume(VoiceId voice, float volume, double seconds, RampCurve curve,
+                            bool stopWhenDone) {
+    if (!validate(voice)) return 0;
+    const RampToken token = nextRampToken_;
+    Command command{Command::Type::Ramp, slotOf(voice), clampVolume(volume), nullptr};
+    command.frames = seconds > 0.0 ? static_cast<uint64_t>(seconds * config_.sampleRate + 0.5) : 0;
+    command.token = token;
+    command.curve = curve;
+    command.stopWhenDone = stopWhenDone;
+    if (!send(command)) return 0;
+    nextRampToken_ = nextRampToken_ == UINT32_MAX ? 1 : nextRampToken_ + 1;
+    return token;
+}
+
+bool Mixer::setSourceParameter(VoiceId voice, uint32_t parameter, float value) {
+    if (!validate(voice)) return false;
+    Command command{Command::Type::SetParameter, slotOf(voice), value, nullptr};
+    command.parameter = parameter;
+    return send(command);
+}
+
+void Mixer::setMasterVolume(float volume) {
+    send({Command::Type::SetMasterVolume, 0, clampVolume(volume), nullptr});
+}
+
+bool Mixer::automate(const AutomationTimeline& timeline, const VoiceId* channels, std::size_t count,
+                     double startSeconds) {
+    if (automationsInFlight_ >= retiredAutomations_.capacity()) return false;
+
+    const AutomationSchedule schedule = scheduleAutomation(timeline, config_.sampleRate);
+    auto automation = std::make_unique<Automation>();
+    automation->startFrame = startSeconds > 0.0 ? static_cast<uint64_t>(startSeconds * config_.sampleRate + 0.5) : 0;
+    automation->endFrame = schedule.endFrame;
+    automation->curves.reserve(timeline.equalizerPresets.size());
+    for (const auto& preset : timeline.equalizerPresets) {
+        automation->curves.push_back(equalizer_.design(preset.data(), preset.size()));
+    }
+    automation->actions.reserve(schedule.actions.size());
+    for (AutomationAction action : schedule.actions) {
+        if (action.target == AutomationTarget::ChannelVolume) {
+            if (action.index >= count || !validate(channels[action.index])) continue;
+            action.index = slotOf(channels[action.index]);
+        }
+        automation->actions.push_back(action);
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        if (validate(channels[i])) automation->slots.push_back(slotOf(channels[i]));
+    }
+
+    Command command{Command::Type::Automate, 0, 0.0f, nullptr};
+    command.automation = automation.get();
+    if (!send(command)) return false;
+    automation.release();
+    ++automationsInFlight_;
+    return true;
+}
+
+void Mixer::stopAutomation() {
+    send({Command::Type::Automate, 0, 0.0f, nullptr});
+}
+
+bool Mixer::isActive(VoiceId voice) const noexcept {
+    return validate(voice);
+}
+
+std::size_t Mixer::collectEvents(MixerEvent* out, std::size_t maxEvents) {
+    std::size_t written = 0;
+
+    // Ramp events go first: a voice's ramp always ends before the voice is
+    // released, and its slot (hence its handle) is still current here.
+    RampEvent ramp{};
+    while ((!out || written < maxEvents) && rampEvents_.tryPop(ramp)) {
+        const VoiceId id = ramp.type == MixerEventType::AutomationFinished ? kInvalidVoice : makeId(ramp.slot);
+        if (out) out[written++] = {ramp.type, id, ramp.token};
+    }
+
+    Automation* automation = nullptr;
+    while (retiredAutomations_.tryPop(automation)) {
+        delete automation;
+        --automationsInFlight_;
+    }
+
+    Release release{};
+    // With an output buffer, stop once it is full so no event is lost; the
+    // rest is picked up by the next call.
+    while ((!out || written < maxEvents) && releases_.tryPop(release)) {
+        SlotState& state = slots_[release.slot];
+        const VoiceId id = makeId(release.slot);
+        delete release.source;
+
+        state.busy = false;
+        state.generation = static_cast<uint16_t>(state.generation == 0xFFFFu ? 1 : state.generation + 1);
+        freeSlots_.push_back(release.slot);
+        --busyCount_;
+
+        if (release.finished && out) {
+            out[written++] = {MixerEventType::VoiceFinished, id, 0};
+        }
+    }
+    return written;
+}
+
+bool Mixer::validate(VoiceId voice) const noexcept {
+    const uint32_t slot = slotOf(voice);
+    if (voice == kInvalidVoice || slot >= slots_.size()) return false;
+    const SlotState& state = slots_[slot];
+    return state.busy && (voice >> 16) == state.generation;
+}
+
+bool Mixer::send(const Command& command) noexcept {
+    return commands_.tryPush(command);
+}
+
+// MARK: - Render thread
+
+void Mixer::render(float* left, float* right, std::size_t frames) noexcept {
+    SLP_TRACE_SPAN(Audio, "mix.render");
+    processCommands();
+    SLP_TRACE_COUNTER(Audio, "mix.voices", activeCount_);
+
+    const std::size_t blockSize = config_.maxBlockFrames;
+    std::size_t offset = 0;
+    while (offset < frames) {
+        std::size_t chunk = std::min(blockSize, frames - offset);
+        // Blocks split where timeline actions fall, so each starts on its sample.
+        if (automation_) chunk = runAutomation(chunk);
+        renderBlock(left + offset, right + offset, chunk);
+        offset += chunk;
+    }
+
+    if (eventsPosted_) {
+        eventsPosted_ = false;
+        eventSignal_.signal();
+    }
+}
+
+void Mixer::processCommands() noexcept {
+    Command command{};
+    while (commands_.tryPop(command)) {
+        switch (command.type) {
+        case Command::Type::Play:
+            activate(command.slot, command.source, command.value);
+            break;
+        case Command::Type::Stop:
+            if (voices_[command.slot].source) {
+                endRamp(command.slot, MixerEventType::RampCancelled);
+                beginStop(voices_[command.slot]);
+            }
+            break;
+        case Command::Type::StopAll:
+            stopAllVoices();
+            break;
+        case Command::Type::SetVolume:
+            if (voices_[command.slot].source && !voices_[command.slot].stopping) {
+                endRamp(command.slot, MixerEventType::RampCancelled);
+                voices_[command.slot].gain.start(command.value, declickFrames_, RampCurve::Linear);
+            }
+            break;
+        case Command::Type::Ramp: {
+            RenderVoice& voice = voices_[command.slot];
+            if (!voice.source || voice.stopping) {
+                // The voice is already on its way out; report the ramp at once.
+                rampEvents_.tryPush({MixerEventType::RampCancelled, command.slot, command.token});
+                eventsPosted_ = true;
+                break;
+            }
+            endRamp(command.slot, MixerEventType::RampCancelled);
+            voice.gain.start(command.value, command.frames, command.curve);
+            voice.ramp = command.token;
+            voice.stopWhenDone = command.stopWhenDone;
+            break;
+        }
+        case Command::Type::SetMasterVolume:
+            masterGain_.start(command.value, declickFrames_, RampCurve::Linear);
+            break;
+        case Command::Type::SetParameter:
+            if (voices_[command.slot].source) {
+                voices_[command.slot].source->setParameter(command.parameter, command.value);
+            }
+            break;
+        case Command::Type::Automate:
+            attachAutomation(command.automation);
+            break;
+        }
+    }
+}
+
+void Mixer::activate(uint32_t slot, AudioSource* source, float volume) noexcept {
+    RenderVoice& voice = voices_[slot];
+    voice.source = source;
+    // Start at the target gain: the source itself begins at its first
+    // sample, so there is no discontinuity to smooth.
+    voice.gain.reset(volume);
+    voice.ramp = 0;
+    voice.stopWhenDone = false;
+    voice.stopping = false;
+    voice.finished = false;
+    voice.automation.reset(1.0f);
+    voice.automated = false;
+    // A finished timeline leaves the master automation where it ended, under
+    // the voices it stopped; the next voice brings it back to 1.
+    if (!automation_ && !isUnity(masterAutomation_)) {
+        masterAutomation_.start(1.0f, declickFrames_, RampCurve::Linear);
+    }
+    voice.activeIndex = static_cast<uint32_t>(activeCount_);
+    activeSlots_[activeCount_++] = slot;
+}
+
+void Mixer::beginStop(RenderVoice& voice) noexcept {
+    if (voice.stopping) return;
+    voice.stopping = true;
+    voice.gain.start(0.0f, declickFrames_, RampCurve::Linear);
+}
+
+void Mixer::stopAllVoices() noexcept {
+    for (std::size_t i = 0; i < activeCount_; ++i) {
+        endRamp(activeSlots_[i], MixerEventType::RampCancelled);
+        beginStop(voices_[activeSlots_[i]]);
+    }
+}
+
+void Mixer::endRamp(uint32_t slot, MixerEventType type) noexcept {
+    RenderVoice& voice = voices_[slot];
+    if (voice.ramp == 0) return;
+    // Sized so that this cannot fail while the control thread keeps collecting.
+    rampEvents_.tryPush({type, slot, voice.ramp});
+    eventsPosted_ = true;
+    voice.ramp = 0;
+    voice.stopWhenDone = false;
+}
+
+void Mixer::renderBlock(float* left, float* right, std::size_t frames) noexcept {
+    kernels::clear(left, frames);
+    kernels::clear(right, frames);
+
+    float* scratchL = scratchLeft_.data();
+    float* scratchR = scratchRight_.data();
+
+    for (std::size_t i = 0; i < activeCount_;) {
+        const uint32_t slot = activeSlots_[i];
+        RenderVoice& voice = voices_[slot];
+
+        if (!voice.finished) {
+            const std::size_t produced = voice.source->render(scratchL, scratchR, frames);
+            if (produced < frames) {
+                kernels::clear(scratchL + produced, frames - produced);
+                kernels::clear(scratchR + produced, frames - produced);
+                voice.finished = true;
+            }
+            if (!isUnity(voice.automation)) applyGain(voice.automation, scratchL, scratchR, frames);
+            std::size_t offset = 0;
+            while (offset < frames) {
+                float gainStart = 0.0f;
+                float gainEnd = 0.0f;
+                const std::size_t span = voice.gain.nextSpan(frames - offset, gainStart, gainEnd);
+                kernels::mixAddRamp(left + offset, scratchL + offset, gainStart, gainEnd, span);
+                kernels::mixAddRamp(right + offset, scratchR + offset, gainStart, gainEnd, span);
+                offset += span;
+            }
+        }
+
+        if (voice.ramp != 0 && !voice.gain.isRamping() && !voice.finished) {
+            const bool stopAfter = voice.stopWhenDone;
+            endRamp(slot, MixerEventType::RampFinished);
+            if (stopAfter) beginStop(voice);
+        }
+
+        const bool done = voice.finished
+            || (voice.stopping && !voice.gain.isRamping() && voice.gain.current() == 0.0f);
+        if (done && retire(slot)) {
+            // retire() swapped the last active voice into position i.
+            continue;
+        }
+        ++i;
+    }
+
+    applyGain(masterGain_, left, right, frames);
+    if (!isUnity(masterAutomation_)) applyGain(masterAutomation_, left, right, frames);
+
+    equalizer_.process(left, right, frames);
+    delay_.process(left, right, frames);
+    reverb_.process(left, right, frames);
+}
+
+bool Mixer::retire(uint32_t slot) noexcept {
+    RenderVoice& voice = voices_[slot];
+    endRamp(slot, MixerEventType::RampCancelled);
+    // If the control thread is behind, keep the voice parked (silent) and
+    // retry next block rather than dropping the source.
+    if (!releases_.tryPush({slot, voice.source, voice.finished && !voice.stopping})) {
+        voice.finished = true;
+        return false;
+    }
+
+    const uint32_t index = voice.activeIndex;
+    const uint32_t last = activeSlots_[--activeCount_];
+    activeSlots_[index] = last;
+    voices_[last].activeIndex = index;
+    voice = RenderVoice{};
+    eventsPosted_ = true;
+    return true;
+}
+
+// MARK: - Automation
+
+void Mixer::attachAutomation(Automation* automation) noexcept {
+    detachAutomation(false);
+    if (!automation) return;
+    automation_ = automation;
+    nextAction_ = 0;
+    // Actions before the start are caught up on at the first block.
+    automationClock_ = automation->startFrame;
+    for (uint32_t slot : automation->slots) {
+        if (voices_[slot].source) voices_[slot].automated = true;
+    }
+}
+
+void Mixer::detachAutomation(bool finished) noexcept {
+    if (!automation_) return;
+    for (uint32_t slot : automation_->slots) {
+        RenderVoice& voice = voices_[slot];
+        if (!voice.automated) continue;
+        voice.automated = false;
+        // Stopping voices fade out under the gain they have.
+        if (!voice.stopping) voice.automation.start(1.0f, declickFrames_, RampCurve::Linear);
+    }
+    if (!finished) masterAutomation_.start(1.0f, declickFrames_, RampCurve::Linear);
+    equalizer_.restore();
+    delay_.restoreMix();
+    reverb_.restoreMix();
+    // automate() keeps no more timelines in flight than this queue holds.
+    retiredAutomations_.tryPush(automation_);
+    automation_ = nullptr;
+}
+
+std::size_t Mixer::runAutomation(std::size_t frames) noexcept {
+    const std::vector<AutomationAction>& actions = automation_->actions;
+    while (nextAction_ < actions.size() && actions[nextAction_].frame <= automationClock_) {
+        const AutomationAction& action = actions[nextAction_++];
+        applyAction(action, automationClock_ - action.frame);
+    }
+    if (automationClock_ >= automation_->endFrame) {
+        stopAllVoices();
+        rampEvents_.tryPush({MixerEventType::AutomationFinished, 0, 0});
+        eventsPosted_ = true;
+        detachAutomation(true);
+        return frames;
+    }
+
+    uint64_t next = automation_->endFrame;
+    if (nextAction_ < actions.size()) next = std::min(next, actions[nextAction_].frame);
+    frames = static_cast<std::size_t>(std::min<uint64_t>(frames, next - automationClock_));
+    automationClock_ += frames;
+    return frames;
+}
+
+void Mixer::applyAction(const AutomationAction& action, uint64_t elapsed) noexcept {
+    switch (action.target) {
+    case AutomationTarget::ChannelVolume: {
+        RenderVoice& voice = voices_[action.index];
+        if (!voice.automated) break;
+        voice.automation.start(action.value, action.frames, action.curve);
+        voice.automation.advance(elapsed);
+        break;
+    }
+    case AutomationTarget::MasterVolume:
+        masterAutomation_.start(action.value, action.frames, action.curve);
+        masterAutomation_.advance(elapsed);
+        break;
+    case AutomationTarget::EqualizerPreset:
+        equalizer_.glideTo(automation_->curves[action.index]);
+        break;
+    case AutomationTarget::DelayMix:
+        delay_.automateMix(action.value, action.frames, elapsed);
+        break;
+    case AutomationTarget::ReverbMix:
+        reverb_.automateMix(action.value, action.frames, elapsed);
+        break;
+    }
+}
+
+} // namespace sleepster
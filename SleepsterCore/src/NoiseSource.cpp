@@ -0,0 +1,296 @@
+//
+//  NoiseSource.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/NoiseSource.hpp"
+
+#include "sleepster/Random.hpp"
+#include "sleepster/Simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sleepster {
+
+namespace {
+
+/// Kellet's economy pink filter, designed at 44.1 kHz: three one-pole
+/// sections plus a direct path, within half a dB of -3 dB per octave over
+/// the audible range.
+constexpr double kKelletRate = 44100.0;
+constexpr double kKelletPoles[3] = {0.99765, 0.96300, 0.57000};
+constexpr double kKelletGains[3] = {0.0990460, 0.2965164, 1.0526913};
+constexpr double kKelletDirect = 0.1848;
+
+/// Below this the brown integrator levels off instead of running away.
+constexpr double kBrownCornerHz = 10.0;
+
+/// Variance of white noise uniform on [-1, 1).
+constexpr double kWhiteVariance = 1.0 / 3.0;
+
+/// Maps the xorshift output, read as signed, onto [-1, 1).
+constexpr float kIntToUnit = 1.0f / 2147483648.0f;
+
+/// A linear map on 32-bit words over GF(2): column i is the image of bit i.
+using BitMatrix = std::array<uint32_t, 32>;
+
+uint32_t applyMatrix(const BitMatrix& m, uint32_t v) noexcept {
+    uint32_t result = 0;
+    for (int i = 0; v != 0; ++i, v >>= 1) {
+        if (v & 1u) result ^= m[i];
+    }
+    return result;
+}
+
+/// a after b.
+BitMatrix compose(const BitMatrix& a, const BitMatrix& b) noexcept {
+    BitMatrix result;
+    for (int i = 0; i < 32; ++i) result[i] = applyMatrix(a, b[i]);
+    return result;
+}
+
+uint32_t xorshift32(uint32_t s) noexcept {
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+}
+
+/// Xorshift is linear, so `steps` steps are one matrix, built by squaring.
+BitMatrix xorshiftPower(uint64_t steps) noexcept {
+    BitMatrix base, result;
+    for (int i = 0; i < 32; ++i) {
+        base[i] = xorshift32(1u << i);
+        result[i] = 1u << i;
+    }
+    for (; steps != 0; steps >>= 1) {
+        if (steps & 1u) result = compose(base, result);
+        base = compose(base, base);
+    }
+    return result;
+}
+
+} // namespace
+
+float NoiseSource::tiltOf(NoiseColor color) noexcept {
+    switch (color) {
+    case NoiseColor::White: return 0.0f;
+    case NoiseColor::Pink: return -3.0f;
+    case NoiseColor::Brown: return -6.0f;
+    }
+    return 0.0f;
+}
+
+NoiseSource::NoiseSource(float tilt, uint64_t seed)
+    : tilt_(std::isfinite(tilt) ? std::clamp(tilt, kMinTilt, kMaxTilt) : kMaxTilt),
+      targetTilt_(tilt_) {
+    for (ChannelState& channel : channels_) {
+        for (uint32_t& lane : channel.lanes) {
+            lane = static_cast<uint32_t>(splitmix64(seed) >> 32);
+            // Xorshift never leaves the all-zero state.
+            if (lane == 0) lane = 0x6D2B79F5u;
+        }
+    }
+    computeCoefficients(sampleRate_);
+    const Weights weights = weightsAt(tilt_);
+    pinkActive_ = weights.pink != 0.0f;
+    brownActive_ = weights.brown != 0.0f;
+}
+
+NoiseSource::NoiseSource(NoiseColor color, uint64_t seed) : NoiseSource(tiltOf(color), seed) {}
+
+void NoiseSource::prepare(double sampleRate, std::size_t maxBlockFrames) {
+    if (sampleRate > 0.0) {
+        sampleRate_ = sampleRate;
+        computeCoefficients(sampleRate);
+    }
+}
+
+void NoiseSource::computeCoefficients(double sampleRate) noexcept {
+    // Poles move to keep their corner frequencies; gains follow so each
+    // section keeps its DC gain and the sum keeps its shape.
+    double poles[kPinkPoles], gains[kPinkPoles];
+    for (std::size_t i = 0; i < kPinkPoles; ++i) {
+        poles[i] = std::pow(kKelletPoles[i], kKelletRate / sampleRate);
+        gains[i] = kKelletGains[i] * (1.0 - poles[i]) / (1.0 - kKelletPoles[i]);
+        pinkPoles_[i] = static_cast<float>(poles[i]);
+        pinkGains_[i] = static_cast<float>(gains[i]);
+    }
+    pinkDirect_ = static_cast<float>(kKelletDirect);
+
+    // Output variance of the filter: the cross terms of the one-pole impulse
+    // responses, plus the direct path against each of them.
+    double pinkGainSquared = kKelletDirect * kKelletDirect;
+    for (std::size_t i = 0; i < kPinkPoles; ++i) {
+        pinkGainSquared += 2.0 * kKelletDirect * gains[i];
+        for (std::size_t j = 0; j < kPinkPoles; ++j) {
+            pinkGainSquared += gains[i] * gains[j] / (1.0 - poles[i] * poles[j]);
+        }
+    }
+
+    const double brownPole = std::exp(-2.0 * M_PI * kBrownCornerHz / sampleRate);
+    brownPole_ = static_cast<float>(brownPole);
+    const double brownGainSquared = (1.0 - brownPole) / (1.0 + brownPole);
+
+    whiteNorm_ = static_cast<float>(kLevel / std::sqrt(kWhiteVariance));
+    pinkNorm_ = static_cast<float>(kLevel / std::sqrt(kWhiteVariance * pinkGainSquared));
+    brownNorm_ = static_cast<float>(kLevel / std::sqrt(kWhiteVariance * brownGainSquared));
+}
+
+bool NoiseSource::seek(uint64_t frame) {
+    // Each lane steps once per vector of output.
+    const BitMatrix jump = xorshiftPower((frame + simd::kWidth - 1) / simd::kWidth);
+    for (ChannelState& channel : channels_) {
+        for (uint32_t& lane : channel.lanes) lane = applyMatrix(jump, lane);
+        channel.pink.fill(0.0f);
+        channel.brown = 0.0f;
+    }
+    tilt_ = targetTilt_;
+    return true;
+}
+
+NoiseSource::Weights NoiseSource::weightsAt(float tilt) const noexcept {
+    Weights weights;
+    if (tilt >= -3.0f) {
+        const float u = -tilt / 3.0f;
+        weights.white = (1.0f - u) * whiteNorm_;
+        weights.pink = u * pinkNorm_;
+    } else {
+        const float u = (-tilt - 3.0f) / 3.0f;
+        weights.pink = (1.0f - u) * pinkNorm_;
+        weights.brown = u * brownNorm_;
+    }
+    return weights;
+}
+
+// MARK: - Render thread
+
+void NoiseSource::setParameter(uint32_t parameter, float value) noexcept {
+    if (parameter != kTiltParameter || !std::isfinite(value)) return;
+    targetTilt_ = std::clamp(value, kMinTilt, kMaxTilt);
+}
+
+std::size_t NoiseSource::render(float* left, float* right, std::size_t frames) noexcept {
+    for (std::size_t offset = 0; offset < frames; offset += kChunk) {
+        renderChunk(left + offset, right + offset, std::min(kChunk, frames - offset));
+    }
+    return frames;
+}
+
+void NoiseSource::renderChunk(float* left, float* right, std::size_t count) noexcept {
+    const float startTilt = tilt_;
+    if (tilt_ != targetTilt_) {
+        const double coefficient = 1.0 - std::exp(-static_cast<double>(count) / (kGlideSeconds * sampleRate_));
+        tilt_ += static_cast<float>((targetTilt_ - tilt_) * coefficient);
+        if (std::fabs(targetTilt_ - tilt_) < 1e-3f) tilt_ = targetTilt_;
+    }
+
+    // Weights are piecewise linear in the tilt; stepping them linearly over
+    // the chunk keeps a glide free of steps at chunk boundaries.
+    const Weights from = weightsAt(startTilt);
+    const Weights to = weightsAt(tilt_);
+    const float perFrame = 1.0f / static_cast<float>(count);
+    const Weights step = {(to.white - from.white) * perFrame, (to.pink - from.pink) * perFrame,
+                          (to.brown - from.brown) * perFrame};
+
+    // Filters that have been silent start again from rest.
+    const bool pink = from.pink != 0.0f || to.pink != 0.0f;
+    const bool brown = from.brown != 0.0f || to.brown != 0.0f;
+    if (pink && !pinkActive_) {
+        for (ChannelState& channel : channels_) channel.pink.fill(0.0f);
+    }
+    if (brown && !brownActive_) {
+        for (ChannelState& channel : channels_) channel.brown = 0.0f;
+    }
+    pinkActive_ = pink;
+    brownActive_ = brown;
+
+    generateWhite(channels_[0], white_[0], count);
+    generateWhite(channels_[1], white_[1], count);
+    if (pink && brown) {
+        shape<true, true>(left, right, count, from, step);
+    } else if (pink) {
+        shape<true, false>(left, right, count, from, step);
+    } else if (brown) {
+        shape<false, true>(left, right, count, from, step);
+    } else {
+        // Plain white noise at its settled level.
+        using namespace simd;
+        const f32x4 gain = splat(from.white);
+        float* outputs[] = {left, right};
+        for (std::size_t c = 0; c < 2; ++c) {
+            const float* white = white_[c];
+            float* out = outputs[c];
+            std::size_t i = 0;
+            for (; i + kWidth <= count; i += kWidth) store(out + i, mul(load(white + i), gain));
+            for (; i < count; ++i) out[i] = white[i] * from.white;
+        }
+    }
+}
+
+void NoiseSource::generateWhite(ChannelState& state, float* out, std::size_t count) noexcept {
+    using namespace simd;
+    // The scratch is padded to whole vectors, so the tail is generated too
+    // and simply left unused.
+    const f32x4 scale = splat(kIntToUnit);
+    u32x4 s = loadU32(state.lanes);
+    for (std::size_t i = 0; i < count; i += kWidth) {
+        s = bitXor(s, shiftLeft<13>(s));
+        s = bitXor(s, shiftRight<17>(s));
+        s = bitXor(s, shiftLeft<5>(s));
+        store(out + i, mul(toFloatSigned(s), scale));
+    }
+    storeU32(state.lanes, s);
+}
+
+template <bool Pink, bool Brown>
+void NoiseSource::shape(float* left, float* right, std::size_t count, Weights from, Weights step) noexcept {
+    // Both filters are recursive in time, so this stays scalar; running the
+    // two channels in one loop at least overlaps their dependency chains.
+    const float a0 = pinkPoles_[0], a1 = pinkPoles_[1], a2 = pinkPoles_[2];
+    const float g0 = pinkGains_[0], g1 = pinkGains_[1], g2 = pinkGains_[2];
+    const float direct = pinkDirect_;
+    const float brownPole = brownPole_;
+    const float brownInput = 1.0f - brownPole_;
+    ChannelState& l = channels_[0];
+    ChannelState& r = channels_[1];
+    float lp0 = l.pink[0], lp1 = l.pink[1], lp2 = l.pink[2], lb = l.brown;
+    float rp0 = r.pink[0], rp1 = r.pink[1], rp2 = r.pink[2], rb = r.brown;
+    float ww = from.white, wp = from.pink, wb = from.brown;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const float xl = white_[0][i];
+        const float xr = white_[1][i];
+        float yl = ww * xl;
+        float yr = ww * xr;
+        if constexpr (Pink) {
+            lp0 = a0 * lp0 + g0 * xl;
+            rp0 = a0 * rp0 + g0 * xr;
+            lp1 = a1 * lp1 + g1 * xl;
+            rp1 = a1 * rp1 + g1 * xr;
+            lp2 = a2 * lp2 + g2 * xl;
+            rp2 = a2 * rp2 + g2 * xr;
+            yl += wp * (lp0 + lp1 + lp2 + direct * xl);
+            yr += wp * (rp0 + rp1 + rp2 + direct * xr);
+        }
+        if constexpr (Brown) {
+            lb = brownPole * lb + brownInput * xl;
+            rb = brownPole * rb + brownInput * xr;
+            yl += wb * lb;
+            yr += wb * rb;
+        }
+        left[i] = yl;
+        right[i] = yr;
+        ww += step.white;
+        wp += step.pink;
+        wb += step.brown;
+    }
+
+    l.pink = {lp0, lp1, lp2};
+    l.brown = lb;
+    r.pink = {rp0, rp1, rp2};
+    r.brown = rb;
+}
+
+} // namespace sleepster
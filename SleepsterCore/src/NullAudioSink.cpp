@@ -0,0 +1,66 @@
+//
+//  NullAudioSink.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/NullAudioSink.hpp"
+
+#include "sleepster/MixKernels.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace sleepster {
+
+NullAudioSink::NullAudioSink(Mixer& mixer, std::size_t blockFrames)
+    : mixer_(mixer), blockFrames_(blockFrames), left_(blockFrames), right_(blockFrames) {}
+
+NullAudioSink::~NullAudioSink() {
+    stop();
+}
+
+void NullAudioSink::pump(std::size_t frames) {
+    while (frames > 0) {
+        const std::size_t chunk = std::min(frames, blockFrames_);
+        renderBlock(chunk);
+        frames -= chunk;
+    }
+}
+
+void NullAudioSink::start() {
+    if (running_.exchange(true)) return;
+    thread_ = std::thread([this] { run(); });
+}
+
+void NullAudioSink::stop() {
+    if (!running_.exchange(false)) return;
+    if (thread_.joinable()) thread_.join();
+}
+
+void NullAudioSink::renderBlock(std::size_t frames) {
+    left_.resize(frames);
+    right_.resize(frames);
+    mixer_.render(left_.data(), right_.data(), frames);
+
+    const float blockPeak = std::max(kernels::peak(left_.data(), frames),
+                                     kernels::peak(right_.data(), frames));
+    if (blockPeak > peak_.load(std::memory_order_relaxed)) {
+        peak_.store(blockPeak, std::memory_order_relaxed);
+    }
+    framesRendered_.fetch_add(frames, std::memory_order_relaxed);
+}
+
+void NullAudioSink::run() {
+    using Clock = std::chrono::steady_clock;
+    const auto blockDuration = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(static_cast<double>(blockFrames_) / mixer_.config().sampleRate));
+
+    auto deadline = Clock::now();
+    while (running_.load(std::memory_order_relaxed)) {
+        renderBlock(blockFrames_);
+        deadline += blockDuration;
+        std::this_thread::sleep_until(deadline);
+    }
+}
+
+} // namespace sleepster
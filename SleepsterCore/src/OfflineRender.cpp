@@ -0,0 +1,431 @@
+//
+//  OfflineRender.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/OfflineRender.hpp"
+
+#include "sleepster/GainRamp.hpp"
+#include "sleepster/MixKernels.hpp"
+#include "sleepster/Mixer.hpp"
+#include "sleepster/PcmSource.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace sleepster {
+
+namespace {
+
+/// Every chunk and pre-roll starts on a multiple of this, and the mixer
+/// renders in blocks of it, so each chunk sees the same block grid as a
+/// single pass would.
+constexpr std::size_t kBlockFrames = 1024;
+
+/// Crossfade between neighbouring chunks.
+constexpr double kStitchSeconds = 0.01;
+
+/// Shortest pre-roll: covers the EQ's lowest band and the sources' own
+/// filters (the brown noise integrator is the slowest).
+constexpr double kMinSettlingSeconds = 1.0;
+
+/// Longest pre-roll; a delay fed back near unity rings for minutes, and
+/// what is left of it after this long is buried under the live signal.
+constexpr double kMaxSettlingSeconds = 30.0;
+
+/// -120 dB, in decades of amplitude.
+constexpr double kSettledDecades = 6.0;
+
+uint64_t roundUp(uint64_t value, uint64_t multiple) noexcept {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+uint64_t toFrames(double seconds, double sampleRate) noexcept {
+    return seconds > 0.0 ? static_cast<uint64_t>(seconds * sampleRate + 0.5) : 0;
+}
+
+/// A track's fades applied to its source, starting from the frame the
+/// source was positioned at.
+class FadedSource final : public AudioSource {
+public:
+    FadedSource(std::unique_ptr<AudioSource> inner, uint64_t startFrame, uint64_t fadeInFrames,
+                uint64_t fadeOutStart, uint64_t fadeOutFrames)
+        : inner_(std::move(inner)),
+          position_(startFrame),
+          fadeOutStart_(fadeOutStart),
+          fadeOutFrames_(fadeOutFrames) {
+        gain_.reset(1.0f);
+        if (fadeOutFrames_ > 0 && startFrame >= fadeOutStart_) {
+            gain_.start(0.0f, fadeOutFrames_, RampCurve::Exponential);
+            gain_.advance(startFrame - fadeOutStart_);
+            fadingOut_ = true;
+        } else if (startFrame < fadeInFrames) {
+            gain_.reset(0.0f);
+            gain_.start(1.0f, fadeInFrames, RampCurve::EqualPower);
+            gain_.advance(startFrame);
+        }
+    }
+
+    // The inner source was prepared and positioned before it was wrapped.
+
+    std::size_t render(float* left, float* right, std::size_t frames) noexcept override {
+        const std::size_t produced = inner_->render(left, right, frames);
+        std::size_t offset = 0;
+        while (offset < produced) {
+            if (!fadingOut_ && fadeOutFrames_ > 0 && position_ >= fadeOutStart_) {
+                gain_.start(0.0f, fadeOutFrames_, RampCurve::Exponential);
+                fadingOut_ = true;
+            }
+            std::size_t limit = produced - offset;
+            if (!fadingOut_ && fadeOutFrames_ > 0) {
+                limit = static_cast<std::size_t>(std::min<uint64_t>(limit, fadeOutStart_ - position_));
+            }
+            float gainStart = 0.0f;
+            float gainEnd = 0.0f;
+            const std::size_t span = gain_.nextSpan(limit, gainStart, gainEnd);
+            if (gainStart != 1.0f || gainEnd != 1.0f) {
+                kernels::applyGainRamp(left + offset, gainStart, gainEnd, span);
+                kernels::applyGainRamp(right + offset, gainStart, gainEnd, span);
+            }
+            offset += span;
+            position_ += span;
+        }
+        return produced;
+    }
+
+    void setParameter(uint32_t parameter, float value) noexcept override {
+        inner_->setParameter(parameter, value);
+    }
+
+private:
+    std::unique_ptr<AudioSource> inner_;
+    GainRamp gain_;
+    uint64_t position_;
+    const uint64_t fadeOutStart_;
+    const uint64_t fadeOutFrames_;
+    bool fadingOut_ = false;
+};
+
+/// Frame layout shared by every chunk.
+struct Plan {
+    uint64_t totalFrames = 0;
+    uint64_t chunkFrames = 0;
+    uint64_t preRollFrames = 0;
+    uint64_t stitchFrames = 0;
+    std::size_t chunkCount = 0;
+
+    uint64_t chunkStart(std::size_t index) const noexcept { return index * chunkFrames; }
+    uint64_t chunkEnd(std::size_t index) const noexcept {
+        return std::min(totalFrames, chunkStart(index) + chunkFrames);
+    }
+    /// Past the chunk's own end by the overlap with the next one.
+    uint64_t renderEnd(std::size_t index) const noexcept {
+        return std::min(totalFrames, chunkEnd(index) + stitchFrames);
+    }
+};
+
+Plan makePlan(const OfflineMix& mix, const OfflineRenderOptions& options) {
+    Plan plan;
+    plan.totalFrames = mix.frameCount();
+    plan.stitchFrames = toFrames(kStitchSeconds, mix.sampleRate);
+    const uint64_t requested = toFrames(std::max(options.chunkSeconds, 0.0), mix.sampleRate);
+    plan.chunkFrames = roundUp(std::max<uint64_t>({requested, plan.stitchFrames, kBlockFrames}), kBlockFrames);
+    plan.preRollFrames = roundUp(toFrames(mix.bus.settlingSeconds(), mix.sampleRate), kBlockFrames);
+    plan.chunkCount = static_cast<std::size_t>((plan.totalFrames + plan.chunkFrames - 1) / plan.chunkFrames);
+    return plan;
+}
+
+struct RenderedChunk {
+    std::vector<float> left;
+    std::vector<float> right;
+};
+
+bool renderChunk(const OfflineMix& mix, const Plan& plan, std::size_t index, RenderedChunk& out) {
+    const uint64_t start = plan.chunkStart(index);
+    const uint64_t end = plan.renderEnd(index);
+    const uint64_t from = start > plan.preRollFrames ? start - plan.preRollFrames : 0;
+
+    MixerConfig config;
+    config.sampleRate = mix.sampleRate;
+    config.maxVoices = static_cast<uint32_t>(std::max<std::size_t>(mix.tracks.size(), 1));
+    config.maxBlockFrames = static_cast<uint32_t>(kBlockFrames);
+    config.commandQueueCapacity = std::max<uint32_t>(config.commandQueueCapacity, config.maxVoices * 2 + 16);
+    Mixer mixer(config);
+    mix.bus.applyTo(mixer);
+
+    std::vector<VoiceId> voices;
+    voices.reserve(mix.tracks.size());
+    for (const OfflineTrack& track : mix.tracks) {
+        std::unique_ptr<AudioSource> source = track.makeSource ? track.makeSource() : nullptr;
+        if (!source) return false;
+        source->prepare(mix.sampleRate, kBlockFrames);
+        if (from > 0 && !source->seek(from)) return false;
+
+        // The fade-out never starts before the fade-in has finished.
+        const uint64_t fadeIn = std::min(toFrames(track.fadeInSeconds, mix.sampleRate), plan.totalFrames);
+        const uint64_t fadeOut = std::min(toFrames(track.fadeOutSeconds, mix.sampleRate), plan.totalFrames - fadeIn);
+        auto faded = std::make_unique<FadedSource>(std::move(source), from, fadeIn, plan.totalFrames - fadeOut,
+                                                   fadeOut);
+        voices.push_back(mixer.play(std::move(faded), track.volume * mix.bus.masterVolume));
+        if (voices.back() == kInvalidVoice) return false;
+    }
+    if (!mix.automation.empty() &&
+        !mixer.automate(mix.automation, voices.data(), voices.size(), static_cast<double>(from) / mix.sampleRate)) {
+        return false;
+    }
+
+    std::vector<float> scratchLeft(kBlockFrames), scratchRight(kBlockFrames);
+    for (uint64_t position = from; position < start; position += kBlockFrames) {
+        const auto frames = static_cast<std::size_t>(std::min<uint64_t>(kBlockFrames, start - position));
+        mixer.render(scratchLeft.data(), scratchRight.data(), frames);
+    }
+
+    out.left.resize(static_cast<std::size_t>(end - start));
+    out.right.resize(out.left.size());
+    for (std::size_t offset = 0; offset < out.left.size(); offset += kBlockFrames) {
+        const std::size_t frames = std::min(kBlockFrames, out.left.size() - offset);
+        mixer.render(out.left.data() + offset, out.right.data() + offset, frames);
+    }
+    return true;
+}
+
+} // namespace
+
+// MARK: - BusSettings
+
+void BusSettings::applyTo(Mixer& mixer) const {
+    Equalizer& equalizer = mixer.equalizer();
+    equalizer.setGains(equalizerGainsDb.data(), equalizerGainsDb.size());
+    equalizer.setEnabled(equalizerEnabled);
+
+    StereoDelay& delay = mixer.delay();
+    delay.setTime(delaySeconds);
+    delay.setFeedback(delayFeedback);
+    delay.setMix(delayMix);
+    delay.setEnabled(delayEnabled);
+
+    FdnReverb& reverb = mixer.reverb();
+    reverb.setPreset(reverbPreset);
+    reverb.setMix(reverbMix);
+    reverb.setEnabled(reverbEnabled);
+}
+
+double BusSettings::settlingSeconds() const noexcept {
+    double seconds = kMinSettlingSeconds;
+    if (reverbEnabled) {
+        // The decay time is to -60 dB.
+        seconds = std::max(seconds, FdnReverb::decaySeconds(reverbPreset) * kSettledDecades / 3.0);
+    }
+    if (delayEnabled) {
+        // Each echo is `feedback` times the last.
+        const double feedback = std::min(std::fabs(static_cast<double>(delayFeedback)),
+                                         static_cast<double>(StereoDelay::kMaxFeedback));
+        const double echoes = feedback > 0.0 ? kSettledDecades / -std::log10(feedback) : 0.0;
+        seconds = std::max(seconds, std::clamp(delaySeconds, 0.0, StereoDelay::kMaxSeconds) * (1.0 + echoes));
+    }
+    return std::min(seconds, kMaxSettlingSeconds);
+}
+
+uint64_t OfflineMix::frameCount() const noexcept {
+    return toFrames(durationSeconds, sampleRate);
+}
+
+// MARK: - Rendering
+
+bool renderOffline(const OfflineMix& mix, const OfflineRenderOptions& options, const OfflineSink& sink,
+                   OfflineRenderStats* stats) {
+    using Clock = std::chrono::steady_clock;
+    const auto began = Clock::now();
+    if (!(mix.sampleRate > 0.0)) return false;
+
+    const Plan plan = makePlan(mix, options);
+    unsigned threads = options.threads != 0 ? options.threads : std::thread::hardware_concurrency();
+    threads = static_cast<unsigned>(std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(plan.chunkCount, 1)));
+    // Chunks finished ahead of the one the sink is waiting for stay in
+    // memory, so workers may run only this far ahead of it.
+    const std::size_t window = 2 * static_cast<std::size_t>(threads);
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::size_t nextChunk = 0;
+    std::size_t writtenChunks = 0;
+    bool failed = false;
+    std::vector<RenderedChunk> rendered(plan.chunkCount);
+    std::vector<bool> ready(plan.chunkCount, false);
+
+    const auto work = [&] {
+        for (;;) {
+            std::size_t index;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] {
+                    return failed || nextChunk >= plan.chunkCount || nextChunk < writtenChunks + window;
+                });
+                if (failed || nextChunk >= plan.chunkCount) return;
+                index = nextChunk++;
+            }
+            RenderedChunk chunk;
+            const bool ok = renderChunk(mix, plan, index, chunk);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (ok) {
+                    rendered[index] = std::move(chunk);
+                    ready[index] = true;
+                } else {
+                    failed = true;
+                }
+            }
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) workers.emplace_back(work);
+
+    // This thread stitches the chunks together in order and feeds the sink.
+    bool ok = true;
+    std::vector<float> overlapLeft, overlapRight;
+    for (std::size_t index = 0; index < plan.chunkCount && ok; ++index) {
+        RenderedChunk chunk;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&] { return failed || ready[index]; });
+            if (!ready[index]) {
+                ok = false;
+                break;
+            }
+            chunk = std::move(rendered[index]);
+        }
+
+        // Both sides of the overlap carry the same signal to within the
+        // pre-roll's residue, so a linear crossfade keeps the level.
+        const std::size_t overlap = overlapLeft.size();
+        for (std::size_t i = 0; i < overlap; ++i) {
+            const float w = (static_cast<float>(i) + 0.5f) / static_cast<float>(overlap);
+            chunk.left[i] = overlapLeft[i] + (chunk.left[i] - overlapLeft[i]) * w;
+            chunk.right[i] = overlapRight[i] + (chunk.right[i] - overlapRight[i]) * w;
+        }
+
+        const auto body = static_cast<std::size_t>(plan.chunkEnd(index) - plan.chunkStart(index));
+        ok = sink(chunk.left.data(), chunk.right.data(), body);
+        overlapLeft.assign(chunk.left.begin() + body, chunk.left.end());
+        overlapRight.assign(chunk.right.begin() + body, chunk.right.end());
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            writtenChunks = index + 1;
+            if (!ok) failed = true;
+        }
+        changed.notify_all();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!ok) failed = true;
+    }
+    changed.notify_all();
+    for (std::thread& worker : workers) worker.join();
+
+    if (stats) {
+        stats->frames = plan.totalFrames;
+        stats->threads = threads;
+        stats->chunks = plan.chunkCount;
+        stats->wallSeconds = std::chrono::duration<double>(Clock::now() - began).count();
+        stats->realTimeFactor = stats->wallSeconds > 0.0
+            ? static_cast<double>(plan.totalFrames) / mix.sampleRate / stats->wallSeconds
+            : 0.0;
+    }
+    return ok;
+}
+
+bool renderOfflineToBuffer(const OfflineMix& mix, const OfflineRenderOptions& options, PcmBuffer& out,
+                           OfflineRenderStats* stats) {
+    const auto frames = static_cast<std::size_t>(mix.frameCount());
+    out.sampleRate = mix.sampleRate;
+    out.frameCount = frames;
+    out.channels.assign(2, std::vector<float>(frames));
+    std::size_t written = 0;
+    return renderOffline(
+        mix, options,
+        [&](const float* left, const float* right, std::size_t count) {
+            std::memcpy(out.channels[0].data() + written, left, count * sizeof(float));
+            std::memcpy(out.channels[1].data() + written, right, count * sizeof(float));
+            written += count;
+            return true;
+        },
+        stats);
+}
+
+bool renderOfflineToFile(const OfflineMix& mix, const OfflineRenderOptions& options, const std::string& path,
+                         AudioFileType type, WavFormat::Encoding encoding, OfflineRenderStats* stats) {
+    auto writer = AudioFileWriter::create(path, type, 2, mix.sampleRate, encoding);
+    if (!writer) return false;
+    const bool rendered = renderOffline(
+        mix, options,
+        [&](const float* left, const float* right, std::size_t count) {
+            const float* channels[] = {left, right};
+            return writer->write(channels, count);
+        },
+        stats);
+    if (!writer->finish() || !rendered) {
+        writer.reset();
+        std::remove(path.c_str());
+        return false;
+    }
+    return true;
+}
+
+// MARK: - DecoderSource
+
+DecoderSource::DecoderSource(std::unique_ptr<Decoder> decoder, bool loop)
+    : decoder_(std::move(decoder)), loop_(loop) {}
+
+void DecoderSource::prepare(double sampleRate, std::size_t maxBlockFrames) {
+    if (decoder_ && sampleRate > 0.0 && decoder_->sampleRate() != sampleRate) {
+        decoder_ = std::make_unique<ResamplingDecoder>(std::move(decoder_), sampleRate);
+    }
+}
+
+bool DecoderSource::seek(uint64_t frame) {
+    if (!decoder_) return false;
+    ended_ = false;
+    const uint64_t length = decoder_->frameCount();
+    if (loop_) {
+        if (length == 0) return false;
+        frame %= length;
+    } else if (length != 0 && frame >= length) {
+        ended_ = true;
+        return true;
+    }
+    return decoder_->seek(frame);
+}
+
+std::size_t DecoderSource::render(float* left, float* right, std::size_t frames) noexcept {
+    std::size_t written = 0;
+    bool rewound = false;
+    while (written < frames && !ended_ && decoder_) {
+        const std::size_t decoded = decoder_->decode(left + written, right + written, frames - written);
+        if (decoded > 0) {
+            written += decoded;
+            rewound = false;
+            continue;
+        }
+        // An empty decode straight after rewinding means there is nothing
+        // to loop.
+        if (!loop_ || rewound || !decoder_->seek(0)) {
+            ended_ = true;
+            break;
+        }
+        rewound = true;
+    }
+    return written;
+}
+
+} // namespace sleepster
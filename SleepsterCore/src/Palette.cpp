@@ -0,0 +1,210 @@
+//
+//  Palette.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/Palette.hpp"
+
+#include <memory>
+
+namespace sleepster {
+
+namespace {
+
+struct Rgb {
+    float r;
+    float g;
+    float b;
+};
+
+constexpr Rgb rgb8(int r, int g, int b) noexcept {
+    return {static_cast<float>(r) / 255.0f, static_cast<float>(g) / 255.0f, static_cast<float>(b) / 255.0f};
+}
+
+// MARK: - System colours, dark appearance
+
+constexpr Rgb kBlack = {0.0f, 0.0f, 0.0f};
+constexpr Rgb kWhite = {1.0f, 1.0f, 1.0f};
+constexpr Rgb kGray = rgb8(142, 142, 147);
+constexpr Rgb kBlue = rgb8(10, 132, 255);
+constexpr Rgb kIndigo = rgb8(94, 92, 230);
+constexpr Rgb kPurple = rgb8(191, 90, 242);
+constexpr Rgb kTeal = rgb8(64, 200, 224);
+constexpr Rgb kCyan = rgb8(100, 210, 255);
+constexpr Rgb kOrange = rgb8(255, 159, 10);
+constexpr Rgb kYellow = rgb8(255, 214, 10);
+
+// MARK: - Swatches
+
+struct SwatchSpec {
+    Rgb color;
+    float lit;
+    float dimmed;
+};
+
+/// [swatch][theme], as the views chose them per theme.
+constexpr SwatchSpec kSwatches[kSwatchCount][palette::kThemeCount] = {
+    // SheepBody
+    {
+        {kWhite, 0.95f, 0.7f},
+        {{1.0f, 0.95f, 0.9f}, 0.95f, 0.7f},
+        {{0.9f, 0.95f, 1.0f}, 0.95f, 0.7f},
+        {kWhite, 0.95f * 0.8f, 0.7f * 0.8f},
+    },
+    // Accent
+    {
+        {kPurple, 1.0f, 1.0f},
+        {kOrange, 1.0f, 1.0f},
+        {kCyan, 1.0f, 1.0f},
+        {kWhite, 1.0f, 1.0f},
+    },
+    // AccentStroke
+    {
+        {kPurple, 0.6f, 0.3f},
+        {kOrange, 0.6f, 0.3f},
+        {kCyan, 0.6f, 0.3f},
+        {kWhite, 0.6f, 0.3f},
+    },
+};
+
+// MARK: - Gradients
+
+struct StopSpec {
+    Rgb lit;
+    float litAlpha;
+    Rgb dimmed;
+    float dimmedAlpha;
+    /// Takes the theme's accent colour instead of `lit` and `dimmed`.
+    bool accent;
+};
+
+constexpr StopSpec stop(Rgb color, float lit, float dimmed) noexcept {
+    return {color, lit, color, dimmed, false};
+}
+
+constexpr StopSpec accentStop(float lit, float dimmed) noexcept {
+    return {kBlack, lit, kBlack, dimmed, true};
+}
+
+/// Fully transparent, in `color` so that sampling towards it fades
+/// rather than darkens.
+constexpr StopSpec clearStop(Rgb color = kBlack) noexcept {
+    return {color, 0.0f, color, 0.0f, false};
+}
+
+struct GradientSpec {
+    StopSpec stops[palette::kMaxStops];
+    uint32_t count;
+    bool scalesWithIntensity;
+};
+
+constexpr GradientSpec kGradients[kPaletteGradientCount] = {
+    // MeadowSky
+    {{stop(kBlack, 0.85f, 0.95f), stop(kIndigo, 0.6f, 0.4f), stop(kPurple, 0.4f, 0.2f)}, 3, false},
+    // HorizonGlow
+    {{clearStop(kOrange), stop(kOrange, 0.15f, 0.05f), stop(kYellow, 0.08f, 0.02f)}, 3, false},
+    // Cloud
+    {{stop(kWhite, 0.4f, 0.2f), stop(kGray, 0.2f, 0.1f)}, 2, false},
+    // SheepShadow
+    {{clearStop(), stop(kBlack, 0.4f, 0.2f)}, 2, false},
+    // OceanDepth
+    {{{kIndigo, 0.8f, kBlack, 0.9f, false},
+      stop(kBlue, 0.6f, 0.3f),
+      stop(kTeal, 0.5f, 0.2f),
+      stop(kCyan, 0.3f, 0.1f)},
+     4,
+     false},
+    // Caustics
+    {{stop(kCyan, 0.08f, 0.02f), stop(kWhite, 0.04f, 0.01f)}, 2, true},
+    // Bubble
+    {{stop(kWhite, 0.4f, 0.2f), stop(kCyan, 0.2f, 0.1f), clearStop(kCyan)}, 3, false},
+    // MandalaGlow
+    {{accentStop(0.3f, 0.1f), accentStop(0.15f, 0.05f), clearStop()}, 3, true},
+    // Crystal
+    {{accentStop(0.7f, 0.3f), accentStop(0.4f, 0.1f), clearStop()}, 3, false},
+};
+
+/// Straight-alpha linear interpolation, channel by channel.
+PackedColor mix(PackedColor from, PackedColor to, float t) noexcept {
+    float channels[4];
+    for (int i = 0; i < 4; ++i) {
+        channels[i] = channelOf(from, i) + (channelOf(to, i) - channelOf(from, i)) * t;
+    }
+    return packColor(channels[0], channels[1], channels[2], channels[3]);
+}
+
+} // namespace
+
+// MARK: - Palette
+
+PackedColor Palette::sample(PaletteGradient gradient, float position) const noexcept {
+    const float clamped = position < 0.0f ? 0.0f : position > 1.0f ? 1.0f : position;
+    const auto index = static_cast<std::size_t>(clamped * static_cast<float>(palette::kRampSize - 1) + 0.5f);
+    return ramps[static_cast<std::size_t>(gradient)][index];
+}
+
+std::size_t paletteTier(float intensity) noexcept {
+    const float level = intensity * static_cast<float>(palette::kTierCount - 1) + 0.5f;
+    if (!(level > 0.0f)) return 0;
+    const auto tier = static_cast<std::size_t>(level);
+    return tier < palette::kTierCount ? tier : palette::kTierCount - 1;
+}
+
+void buildPalette(PaletteTheme theme, bool dimmed, std::size_t tier, Palette& out) noexcept {
+    const auto themeIndex = static_cast<std::size_t>(theme) % palette::kThemeCount;
+    if (tier >= palette::kTierCount) tier = palette::kTierCount - 1;
+    const float intensity = static_cast<float>(tier) / static_cast<float>(palette::kTierCount - 1);
+
+    for (std::size_t s = 0; s < kSwatchCount; ++s) {
+        const SwatchSpec& spec = kSwatches[s][themeIndex];
+        out.swatches[s] = packColor(spec.color.r, spec.color.g, spec.color.b, dimmed ? spec.dimmed : spec.lit);
+    }
+
+    const Rgb accent = kSwatches[static_cast<std::size_t>(Swatch::Accent)][themeIndex].color;
+    for (std::size_t g = 0; g < kPaletteGradientCount; ++g) {
+        const GradientSpec& spec = kGradients[g];
+        GradientStops& stops = out.gradients[g];
+        stops.count = spec.count;
+        for (std::size_t i = 0; i < palette::kMaxStops; ++i) {
+            if (i >= spec.count) {
+                stops.colors[i] = stops.colors[spec.count - 1];
+                continue;
+            }
+            const StopSpec& stop = spec.stops[i];
+            const Rgb color = stop.accent ? accent : dimmed ? stop.dimmed : stop.lit;
+            float alpha = dimmed ? stop.dimmedAlpha : stop.litAlpha;
+            if (spec.scalesWithIntensity) alpha *= intensity;
+            stops.colors[i] = packColor(color.r, color.g, color.b, alpha);
+        }
+
+        const float segments = static_cast<float>(spec.count - 1);
+        for (std::size_t i = 0; i < palette::kRampSize; ++i) {
+            const float position = static_cast<float>(i) / static_cast<float>(palette::kRampSize - 1) * segments;
+            auto segment = static_cast<std::size_t>(position);
+            if (segment >= spec.count - 1) segment = spec.count - 2;
+            out.ramps[g][i] =
+                mix(stops.colors[segment], stops.colors[segment + 1], position - static_cast<float>(segment));
+        }
+    }
+}
+
+const Palette& themePalette(PaletteTheme theme, bool dimmed, std::size_t tier) noexcept {
+    constexpr std::size_t kCount = palette::kThemeCount * 2 * palette::kTierCount;
+    static const std::unique_ptr<Palette[]> palettes = [] {
+        std::unique_ptr<Palette[]> built(new Palette[kCount]);
+        for (std::size_t t = 0; t < palette::kThemeCount; ++t) {
+            for (std::size_t d = 0; d < 2; ++d) {
+                for (std::size_t i = 0; i < palette::kTierCount; ++i) {
+                    buildPalette(static_cast<PaletteTheme>(t), d != 0, i,
+                                 built[(t * 2 + d) * palette::kTierCount + i]);
+                }
+            }
+        }
+        return built;
+    }();
+    const std::size_t themeIndex = static_cast<std::size_t>(theme) % palette::kThemeCount;
+    if (tier >= palette::kTierCount) tier = palette::kTierCount - 1;
+    return palettes[(themeIndex * 2 + (dimmed ? 1 : 0)) * palette::kTierCount + tier];
+}
+
+} // namespace sleepster
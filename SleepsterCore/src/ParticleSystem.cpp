@@ -0,0 +1,307 @@
+//
+//  ParticleSystem.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/ParticleSystem.hpp"
+
+#include "sleepster/Simd.hpp"
+#include "sleepster/Trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sleepster {
+
+namespace {
+
+using namespace simd;
+
+constexpr float kPi = 3.14159265358979f;
+constexpr float kTwoPi = 2.0f * kPi;
+
+/// Wraps into [-pi, pi), keeping phases small enough for sinWrapped.
+inline f32x4 wrapPhase(f32x4 phase) noexcept {
+    const f32x4 turns = floor(mul(add(phase, splat(kPi)), splat(1.0f / kTwoPi)));
+    return sub(phase, mul(turns, splat(kTwoPi)));
+}
+
+/// sin(x) for x in [-pi, pi], within 1e-6. Folds onto [-pi/2, pi/2] and
+/// evaluates the Taylor series to x^11.
+inline f32x4 sinWrapped(f32x4 x) noexcept {
+    const f32x4 halfPi = splat(0.5f * kPi);
+    const f32x4 negHalfPi = splat(-0.5f * kPi);
+    x = select(lessThan(halfPi, x), sub(splat(kPi), x), x);
+    x = select(lessThan(x, negHalfPi), sub(splat(-kPi), x), x);
+    const f32x4 x2 = mul(x, x);
+    f32x4 p = splat(-1.0f / 39916800.0f);
+    p = madd(splat(1.0f / 362880.0f), p, x2);
+    p = madd(splat(-1.0f / 5040.0f), p, x2);
+    p = madd(splat(1.0f / 120.0f), p, x2);
+    p = madd(splat(-1.0f / 6.0f), p, x2);
+    p = madd(splat(1.0f), p, x2);
+    return mul(x, p);
+}
+
+// Kernels. Every column is a whole number of vectors long.
+
+/// position += (velocity + wind) * dt
+void integrate(float* position, const float* velocity, float wind, float dt, std::size_t n) noexcept {
+    const f32x4 w = splat(wind);
+    const f32x4 step = splat(dt);
+    for (std::size_t i = 0; i < n; i += kWidth) {
+        store(position + i, madd(load(position + i), add(load(velocity + i), w), step));
+    }
+}
+
+/// Wraps positions into [low, high).
+void wrap(float* position, float low, float high, std::size_t n) noexcept {
+    if (!(high > low)) return;
+    const f32x4 lo = splat(low);
+    const f32x4 width = splat(high - low);
+    const f32x4 inverse = splat(1.0f / (high - low));
+    for (std::size_t i = 0; i < n; i += kWidth) {
+        const f32x4 p = load(position + i);
+        const f32x4 laps = floor(mul(sub(p, lo), inverse));
+        store(position + i, sub(p, mul(laps, width)));
+    }
+}
+
+/// phase = wrap(phase + rate * dt)
+void advance(float* phase, const float* rate, float dt, std::size_t n) noexcept {
+    const f32x4 step = splat(dt);
+    for (std::size_t i = 0; i < n; i += kWidth) {
+        store(phase + i, wrapPhase(madd(load(phase + i), load(rate + i), step)));
+    }
+}
+
+/// out = anchor + radius * sin(phase)
+void offset(float* out, const float* anchor, const float* radius, const float* phase, std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; i += kWidth) {
+        store(out + i, madd(load(anchor + i), load(radius + i), sinWrapped(load(phase + i))));
+    }
+}
+
+/// alpha = base * (1 - depth * (1 - sin(phase)) / 2)
+void twinkle(float* alpha, const float* base, const float* phase, float depth, std::size_t n) noexcept {
+    const f32x4 floorLevel = splat(1.0f - 0.5f * depth);
+    const f32x4 swing = splat(0.5f * depth);
+    for (std::size_t i = 0; i < n; i += kWidth) {
+        const f32x4 level = madd(floorLevel, swing, sinWrapped(load(phase + i)));
+        store(alpha + i, mul(load(base + i), level));
+    }
+}
+
+} // namespace
+
+// MARK: - ParticleSystem
+
+ParticleSystem::ParticleSystem(const ParticleConfig& config, uint64_t seed)
+    : config_(config),
+      count_(config.count),
+      stride_((config.count + kWidth - 1) / kWidth * kWidth),
+      twinkles_(config.twinkleRate.min != 0.0f || config.twinkleRate.max != 0.0f),
+      storage_(new float[kColumnCount * stride_]()),
+      random_(seed) {
+    for (std::size_t i = 0; i < count_; ++i) spawn(i);
+    place();
+    keepPrevious();
+}
+
+void ParticleSystem::spawn(std::size_t i) noexcept {
+    const bool anchored = config_.motion == ParticleMotion::Orbit || config_.motion == ParticleMotion::Fall;
+    // Draw order is part of the seed's contract; append, don't reorder.
+    column(anchored ? AnchorX : X)[i] = random_.uniform(config_.x.min, config_.x.max);
+    column(anchored ? AnchorY : Y)[i] = random_.uniform(config_.y.min, config_.y.max);
+    column(VelocityX)[i] = random_.uniform(config_.velocityX.min, config_.velocityX.max);
+    column(VelocityY)[i] = random_.uniform(config_.velocityY.min, config_.velocityY.max);
+    column(RadiusX)[i] = random_.uniform(config_.radiusX.min, config_.radiusX.max);
+    column(RadiusY)[i] = random_.uniform(config_.radiusY.min, config_.radiusY.max);
+    column(PhaseX)[i] = random_.uniform(-kPi, kPi);
+    column(PhaseY)[i] = random_.uniform(-kPi, kPi);
+    column(RateX)[i] = random_.uniform(config_.orbitRate.min, config_.orbitRate.max);
+    column(RateY)[i] = random_.uniform(config_.orbitRate.min, config_.orbitRate.max);
+    column(TwinklePhase)[i] = random_.uniform(-kPi, kPi);
+    column(TwinkleRate)[i] = random_.uniform(config_.twinkleRate.min, config_.twinkleRate.max);
+    column(BaseAlpha)[i] = random_.uniform(config_.alpha.min, config_.alpha.max);
+    column(Size)[i] = random_.uniform(config_.size.min, config_.size.max);
+}
+
+void ParticleSystem::update(float seconds, FrameArena& arena) noexcept {
+    clearExits();
+    exitSteps_ = 1;
+    fixedStep(seconds, arena);
+}
+
+void ParticleSystem::fixedStep(float seconds, FrameArena& arena) noexcept {
+    interpolated_ = false;
+    const std::size_t n = stride_;
+    const ParticleBounds& b = config_.bounds;
+
+    switch (config_.motion) {
+    case ParticleMotion::Static:
+        break;
+    case ParticleMotion::Drift:
+        integrate(column(X), column(VelocityX), config_.windX, seconds, n);
+        integrate(column(Y), column(VelocityY), config_.windY, seconds, n);
+        wrap(column(X), b.minX, b.maxX, n);
+        wrap(column(Y), b.minY, b.maxY, n);
+        break;
+    case ParticleMotion::Orbit:
+    case ParticleMotion::Fall:
+        integrate(column(AnchorX), column(VelocityX), config_.windX, seconds, n);
+        integrate(column(AnchorY), column(VelocityY), config_.windY, seconds, n);
+        wrap(column(AnchorX), b.minX, b.maxX, n);
+        if (config_.motion == ParticleMotion::Orbit) {
+            wrap(column(AnchorY), b.minY, b.maxY, n);
+        } else {
+            collectExits(arena);
+        }
+        advance(column(PhaseX), column(RateX), seconds, n);
+        advance(column(PhaseY), column(RateY), seconds, n);
+        break;
+    }
+    if (twinkles_) advance(column(TwinklePhase), column(TwinkleRate), seconds, n);
+    place();
+}
+
+void ParticleSystem::place() noexcept {
+    const std::size_t n = stride_;
+    if (config_.motion == ParticleMotion::Orbit || config_.motion == ParticleMotion::Fall) {
+        offset(column(X), column(AnchorX), column(RadiusX), column(PhaseX), n);
+        offset(column(Y), column(AnchorY), column(RadiusY), column(PhaseY), n);
+    }
+    if (twinkles_) {
+        twinkle(column(Alpha), column(BaseAlpha), column(TwinklePhase), config_.twinkleDepth, n);
+    } else {
+        std::copy_n(column(BaseAlpha), n, column(Alpha));
+    }
+}
+
+void ParticleSystem::collectExits(FrameArena& arena) noexcept {
+    // Distance past the far edge: the bottom for falling particles, the top
+    // for rising ones. Positive means the particle has left.
+    float* anchorY = column(AnchorY);
+    const float* velocityY = column(VelocityY);
+    const float low = config_.bounds.minY;
+    const float high = config_.bounds.maxY;
+    const f32x4 lo = splat(low);
+    const f32x4 hi = splat(high);
+    const f32x4 zero = splat(0.0f);
+
+    ParticleExit* exits = exits_;
+    const std::size_t capacity = count_ * exitSteps_;
+    for (std::size_t i = 0; i < stride_; i += kWidth) {
+        const f32x4 y = load(anchorY + i);
+        const f32x4 rising = lessThan(load(velocityY + i), zero);
+        const f32x4 past = select(rising, sub(lo, y), sub(y, hi));
+        int bits = maskBits(lessThan(zero, past));
+        for (std::size_t lane = i; bits != 0; ++lane, bits >>= 1) {
+            if (!(bits & 1) || lane >= count_) continue;
+            const bool up = velocityY[lane] < 0.0f;
+            const float overshoot = up ? low - anchorY[lane] : anchorY[lane] - high;
+            if (!exits) exits = arena.allocate<ParticleExit>(capacity);
+            if (exits && exitCount_ < capacity) exits[exitCount_++] = {static_cast<uint32_t>(lane), column(X)[lane], up ? low : high};
+            // Re-enter by the distance overshot, so spacing along the fall
+            // survives however long the step was.
+            const float span = high - low;
+            const float reentry = span > 0.0f ? std::fmod(overshoot, span) : 0.0f;
+            anchorY[lane] = up ? high - reentry : low + reentry;
+            column(AnchorX)[lane] = random_.uniform(config_.x.min, config_.x.max);
+        }
+    }
+    exits_ = exits;
+    if (!exits) exitCount_ = 0;
+}
+
+void ParticleSystem::clearExits() noexcept {
+    exits_ = nullptr;
+    exitCount_ = 0;
+}
+
+void ParticleSystem::keepPrevious() noexcept {
+    std::copy_n(column(X), stride_, column(PreviousX));
+    std::copy_n(column(Y), stride_, column(PreviousY));
+}
+
+void ParticleSystem::interpolate(float alpha) noexcept {
+    if (config_.motion == ParticleMotion::Static) return;
+    const ParticleBounds& b = config_.bounds;
+    // A particle that wrapped or re-entered during the step is drawn where
+    // it is now rather than swept across the screen.
+    const f32x4 jumpX = splat(0.5f * std::fabs(b.maxX - b.minX));
+    const f32x4 jumpY = splat(0.5f * std::fabs(b.maxY - b.minY));
+    const f32x4 a = splat(alpha);
+    const float* x = column(X);
+    const float* y = column(Y);
+    const float* px = column(PreviousX);
+    const float* py = column(PreviousY);
+    float* dx = column(DrawX);
+    float* dy = column(DrawY);
+    for (std::size_t i = 0; i < stride_; i += kWidth) {
+        const f32x4 cx = load(x + i);
+        const f32x4 cy = load(y + i);
+        const f32x4 ox = load(px + i);
+        const f32x4 oy = load(py + i);
+        const f32x4 mx = sub(cx, ox);
+        const f32x4 my = sub(cy, oy);
+        store(dx + i, select(lessThan(jumpX, abs(mx)), cx, madd(ox, mx, a)));
+        store(dy + i, select(lessThan(jumpY, abs(my)), cy, madd(oy, my, a)));
+    }
+    interpolated_ = true;
+}
+
+void ParticleSystem::setWind(float x, float y) noexcept {
+    config_.windX = x;
+    config_.windY = y;
+}
+
+std::size_t ParticleSystem::scratchBytes() const noexcept {
+    if (config_.motion != ParticleMotion::Fall) return 0;
+    return count_ * sizeof(ParticleExit) + FrameArena::kAlignment;
+}
+
+// MARK: - ParticleScene
+
+std::size_t ParticleScene::add(const ParticleConfig& config) {
+    systems_.push_back(std::make_unique<ParticleSystem>(config, splitmix64(seed_)));
+    std::size_t scratch = 0;
+    // advance() keeps the exits of all its steps.
+    for (const auto& system : systems_) scratch += system->scratchBytes() * kMaxFixedSteps;
+    // Growing the arena frees what it held, including last frame's exits.
+    for (const auto& system : systems_) {
+        system->exits_ = nullptr;
+        system->exitCount_ = 0;
+    }
+    arena_.reserve(scratch);
+    return systems_.size() - 1;
+}
+
+void ParticleScene::update(double seconds) noexcept {
+    SLP_TRACE_SPAN(Animation, "particles.update");
+    const float step = static_cast<float>(std::clamp(seconds, 0.0, kMaxStepSeconds));
+    arena_.reset();
+    for (const auto& system : systems_) system->update(step, arena_);
+}
+
+int ParticleScene::advance(double seconds) noexcept {
+    SLP_TRACE_SPAN(Animation, "particles.advance");
+    const int steps = clock_.advance(seconds);
+    const auto step = static_cast<float>(clock_.step());
+    arena_.reset();
+    for (const auto& system : systems_) {
+        system->clearExits();
+        system->exitSteps_ = static_cast<std::size_t>(kMaxFixedSteps);
+    }
+    for (int i = 0; i < steps; ++i) {
+        for (const auto& system : systems_) {
+            if (i == steps - 1) system->keepPrevious();
+            system->fixedStep(step, arena_);
+        }
+    }
+    const auto alpha = static_cast<float>(clock_.alpha());
+    for (const auto& system : systems_) system->interpolate(alpha);
+    return steps;
+}
+
+} // namespace sleepster
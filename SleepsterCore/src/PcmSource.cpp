@@ -0,0 +1,98 @@
+//
+//  PcmSource.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/PcmSource.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace sleepster {
+
+std::shared_ptr<PcmBuffer> PcmBuffer::copyPlanar(const float* const* channelData,
+                                                 uint32_t channelCount,
+                                                 std::size_t frameCount, double sampleRate) {
+    auto buffer = std::make_shared<PcmBuffer>();
+    buffer->sampleRate = sampleRate;
+    buffer->frameCount = frameCount;
+    const uint32_t kept = std::min<uint32_t>(channelCount, 2);
+    buffer->channels.resize(kept);
+    for (uint32_t c = 0; c < kept; ++c) {
+        buffer->channels[c].assign(channelData[c], channelData[c] + frameCount);
+    }
+    return buffer;
+}
+
+PcmSource::PcmSource(std::shared_ptr<const PcmBuffer> buffer, bool loop)
+    : buffer_(std::move(buffer)), loop_(loop) {}
+
+void PcmSource::prepare(double sampleRate, std::size_t maxBlockFrames) {
+    step_ = sampleRate > 0.0 ? buffer_->sampleRate / sampleRate : 1.0;
+}
+
+bool PcmSource::seek(uint64_t frame) {
+    const std::size_t length = buffer_ ? buffer_->frameCount : 0;
+    if (length == 0) return true;
+    if (step_ == 1.0) {
+        cursor_ = loop_ ? static_cast<std::size_t>(frame % length)
+                        : static_cast<std::size_t>(std::min<uint64_t>(frame, length));
+        return true;
+    }
+    const double end = static_cast<double>(length);
+    position_ = static_cast<double>(frame) * step_;
+    if (position_ >= end) position_ = loop_ ? std::fmod(position_, end) : end;
+    return true;
+}
+
+std::size_t PcmSource::render(float* left, float* right, std::size_t frames) noexcept {
+    if (!buffer_ || buffer_->frameCount == 0 || buffer_->channels.empty()) return 0;
+    return step_ == 1.0 ? renderDirect(left, right, frames)
+                        : renderResampled(left, right, frames);
+}
+
+std::size_t PcmSource::renderDirect(float* left, float* right, std::size_t frames) noexcept {
+    const float* srcL = buffer_->channels[0].data();
+    const float* srcR = buffer_->channels.size() > 1 ? buffer_->channels[1].data() : srcL;
+    const std::size_t length = buffer_->frameCount;
+
+    std::size_t written = 0;
+    while (written < frames) {
+        if (cursor_ >= length) {
+            if (!loop_) break;
+            cursor_ = 0;
+        }
+        const std::size_t chunk = std::min(frames - written, length - cursor_);
+        std::memcpy(left + written, srcL + cursor_, chunk * sizeof(float));
+        std::memcpy(right + written, srcR + cursor_, chunk * sizeof(float));
+        cursor_ += chunk;
+        written += chunk;
+    }
+    return written;
+}
+
+std::size_t PcmSource::renderResampled(float* left, float* right, std::size_t frames) noexcept {
+    const float* srcL = buffer_->channels[0].data();
+    const float* srcR = buffer_->channels.size() > 1 ? buffer_->channels[1].data() : srcL;
+    const std::size_t length = buffer_->frameCount;
+    const double end = static_cast<double>(length);
+
+    std::size_t written = 0;
+    for (; written < frames; ++written) {
+        if (position_ >= end) {
+            if (!loop_) break;
+            position_ -= end;
+        }
+        const std::size_t i0 = static_cast<std::size_t>(position_);
+        // The sample after the last one is the first one when looping.
+        const std::size_t i1 = i0 + 1 < length ? i0 + 1 : (loop_ ? 0 : i0);
+        const float frac = static_cast<float>(position_ - static_cast<double>(i0));
+        left[written] = srcL[i0] + (srcL[i1] - srcL[i0]) * frac;
+        right[written] = srcR[i0] + (srcR[i1] - srcR[i0]) * frac;
+        position_ += step_;
+    }
+    return written;
+}
+
+} // namespace sleepster
@@ -0,0 +1,101 @@
+//
+//  RealFft.cpp
+//  SleepsterCore
+//
+//  The N real samples are packed as N/2 complex ones (even samples real,
+//  odd imaginary) and transformed with an iterative radix-2 FFT. The split
+//  pass then separates the transforms of the even and odd samples and
+//  combines them into bins 0...N/2.
+//
+
+#include "sleepster/RealFft.hpp"
+
+#include <cmath>
+
+namespace sleepster {
+
+RealFft::RealFft(std::size_t size)
+    : size_(size), half_(size / 2), reversed_(half_), twiddleRe_(half_ / 2), twiddleIm_(half_ / 2),
+      splitRe_(half_ + 1), splitIm_(half_ + 1), re_(half_), im_(half_), scratch_(half_ + 1) {
+    unsigned bits = 0;
+    while ((std::size_t{1} << bits) < half_) ++bits;
+    for (std::size_t i = 0; i < half_; ++i) {
+        uint32_t r = 0;
+        for (unsigned b = 0; b < bits; ++b) r |= ((i >> b) & 1u) << (bits - 1 - b);
+        reversed_[i] = r;
+    }
+    for (std::size_t k = 0; k < half_ / 2; ++k) {
+        const double angle = -2.0 * M_PI * static_cast<double>(k) / static_cast<double>(half_);
+        twiddleRe_[k] = static_cast<float>(std::cos(angle));
+        twiddleIm_[k] = static_cast<float>(std::sin(angle));
+    }
+    for (std::size_t k = 0; k <= half_; ++k) {
+        const double angle = -2.0 * M_PI * static_cast<double>(k) / static_cast<double>(size_);
+        splitRe_[k] = static_cast<float>(std::cos(angle));
+        splitIm_[k] = static_cast<float>(std::sin(angle));
+    }
+}
+
+std::size_t RealFft::memoryBytes() const noexcept {
+    return reversed_.capacity() * sizeof(uint32_t) +
+           (twiddleRe_.capacity() + twiddleIm_.capacity() + splitRe_.capacity() + splitIm_.capacity() +
+            re_.capacity() + im_.capacity() + scratch_.capacity()) *
+               sizeof(float);
+}
+
+void RealFft::forward(const float* input, float* real, float* imaginary) noexcept {
+    float* re = re_.data();
+    float* im = im_.data();
+    for (std::size_t i = 0; i < half_; ++i) {
+        const uint32_t j = reversed_[i];
+        re[j] = input[2 * i];
+        im[j] = input[2 * i + 1];
+    }
+
+    for (std::size_t length = 2; length <= half_; length *= 2) {
+        const std::size_t step = half_ / length;
+        const std::size_t span = length / 2;
+        for (std::size_t start = 0; start < half_; start += length) {
+            for (std::size_t k = 0; k < span; ++k) {
+                const float wr = twiddleRe_[k * step];
+                const float wi = twiddleIm_[k * step];
+                const std::size_t a = start + k;
+                const std::size_t b = a + span;
+                const float tr = re[b] * wr - im[b] * wi;
+                const float ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+
+    // X[k] = E[k] + W^k O[k], with E and O recovered from Z[k] and
+    // conj(Z[half - k]).
+    for (std::size_t k = 0; k <= half_; ++k) {
+        const std::size_t a = k % half_;
+        const std::size_t b = (half_ - k) % half_;
+        const float zr = re[a];
+        const float zi = im[a];
+        const float cr = re[b];
+        const float ci = -im[b];
+        const float er = 0.5f * (zr + cr);
+        const float ei = 0.5f * (zi + ci);
+        const float orr = 0.5f * (zi - ci);
+        const float oi = -0.5f * (zr - cr);
+        real[k] = er + splitRe_[k] * orr - splitIm_[k] * oi;
+        imaginary[k] = ei + splitRe_[k] * oi + splitIm_[k] * orr;
+    }
+}
+
+void RealFft::powerSpectrum(const float* input, float* power) noexcept {
+    float* imaginary = scratch_.data();
+    forward(input, power, imaginary);
+    const float scale = 1.0f / (static_cast<float>(size_) * static_cast<float>(size_));
+    for (std::size_t k = 0; k <= half_; ++k) {
+        power[k] = (power[k] * power[k] + imaginary[k] * imaginary[k]) * scale;
+    }
+}
+
+} // namespace sleepster
@@ -0,0 +1,285 @@
+//
+//  Reverb.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/Reverb.hpp"
+
+#include "sleepster/Simd.hpp"
+#include "sleepster/Trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace sleepster {
+
+namespace {
+
+struct Design {
+    /// Scale applied to kBaseLengthsMs.
+    double size;
+    double decaySeconds;
+    /// Corner of the damping low-pass inside the loop.
+    double dampingHz;
+    double preDelaySeconds;
+};
+
+constexpr Design kDesigns[FdnReverb::kPresetCount] = {
+    /* Room      */ {0.45, 0.7, 7000.0, 0.004},
+    /* Hall      */ {1.0, 2.0, 5000.0, 0.018},
+    /* Cathedral */ {1.6, 5.0, 3500.0, 0.035},
+    /* Plate     */ {0.3, 1.6, 10000.0, 0.0},
+};
+
+/// Spread over roughly an octave so the modes of the lines interleave.
+constexpr double kBaseLengthsMs[FdnReverb::kLines] = {31.3, 37.9, 41.9, 47.3, 53.7, 61.3, 67.9, 73.1};
+
+/// Brings broadband input back out a few dB down once the damping has
+/// taken its share.
+constexpr float kOutputGain = 0.8f;
+
+bool isPrime(std::size_t n) {
+    if (n < 2) return false;
+    for (std::size_t d = 2; d * d <= n; ++d) {
+        if (n % d == 0) return false;
+    }
+    return true;
+}
+
+/// Prime lengths share no common factors, which keeps echoes from piling up
+/// on the same samples.
+std::size_t primeAtLeast(std::size_t n) {
+    while (!isPrime(n)) ++n;
+    return n;
+}
+
+} // namespace
+
+double FdnReverb::decaySeconds(ReverbPreset preset) noexcept {
+    return kDesigns[static_cast<std::size_t>(preset)].decaySeconds;
+}
+
+FdnReverb::Layout FdnReverb::makeLayout(ReverbPreset preset, double sampleRate) {
+    const Design& design = kDesigns[static_cast<std::size_t>(preset)];
+    Layout layout;
+    std::size_t longest = 0;
+    for (std::size_t k = 0; k < kLines; ++k) {
+        const auto frames = static_cast<std::size_t>(kBaseLengthsMs[k] * 1e-3 * design.size * sampleRate);
+        layout.lengths[k] = primeAtLeast(std::max(frames, kChunk));
+        // -60 dB after decaySeconds, spread over the passes through this line;
+        // 1/sqrt(8) normalises the Hadamard matrix.
+        const double passes = design.decaySeconds * sampleRate / static_cast<double>(layout.lengths[k]);
+        layout.gains[k] = static_cast<float>(std::pow(10.0, -3.0 / passes) / std::sqrt(static_cast<double>(kLines)));
+        longest = std::max(longest, layout.lengths[k]);
+    }
+    layout.damping = static_cast<float>(1.0 - std::exp(-2.0 * M_PI * design.dampingHz / sampleRate));
+    const auto preDelay = static_cast<std::size_t>(design.preDelaySeconds * sampleRate);
+    // The pre-delay also runs a chunk at a time, so it is either off or at
+    // least a chunk long.
+    layout.preDelay = preDelay == 0 ? 0 : std::max(preDelay, kChunk);
+    // Until the loop is 120 dB down.
+    layout.tailFrames = layout.preDelay + longest
+        + static_cast<uint64_t>(2.0 * design.decaySeconds * sampleRate);
+    return layout;
+}
+
+FdnReverb::FdnReverb(double sampleRate, std::size_t maxBlockFrames)
+    : declickFrames_(static_cast<uint64_t>(0.01 * sampleRate)),
+      switchFrames_(static_cast<uint64_t>(0.05 * sampleRate)),
+      layouts_{makeLayout(ReverbPreset::Room, sampleRate), makeLayout(ReverbPreset::Hall, sampleRate),
+               makeLayout(ReverbPreset::Cathedral, sampleRate), makeLayout(ReverbPreset::Plate, sampleRate)},
+      layout_(&layouts_[0]),
+      wetLeft_(std::max<std::size_t>(maxBlockFrames, 1) + simd::kWidth),
+      wetRight_(std::max<std::size_t>(maxBlockFrames, 1) + simd::kWidth) {
+    std::size_t longest = 0;
+    std::size_t preDelay = 0;
+    for (const Layout& layout : layouts_) {
+        longest = std::max(longest, *std::max_element(layout.lengths.begin(), layout.lengths.end()));
+        preDelay = std::max(preDelay, layout.preDelay);
+    }
+    for (DelayLine& line : lines_) line = DelayLine(longest);
+    preDelayLeft_ = DelayLine(preDelay);
+    preDelayRight_ = DelayLine(preDelay);
+    publish();
+}
+
+// MARK: - Control thread
+
+void FdnReverb::setEnabled(bool enabled) {
+    settings_.enabled = enabled;
+    publish();
+}
+
+void FdnReverb::setPreset(ReverbPreset preset) {
+    settings_.preset = preset;
+    publish();
+}
+
+void FdnReverb::setMix(float wet) {
+    settings_.wet = std::isfinite(wet) ? std::clamp(wet, 0.0f, 1.0f) : 0.0f;
+    publish();
+}
+
+void FdnReverb::publish() {
+    snapshots_.back() = settings_;
+    snapshots_.publish();
+}
+
+// MARK: - Render thread
+
+void FdnReverb::apply(const Settings& settings) noexcept {
+    wet_ = settings.wet;
+    if (!settings.enabled) {
+        // A pending preset is simply loaded on the next enable.
+        switching_ = false;
+        if (!bypassed_) mix_.rampTo(0.0f, declickFrames_);
+    } else if (bypassed_) {
+        loadPreset(settings.preset);
+        tail_.reset();
+        bypassed_ = false;
+        mix_.rampTo(mixTarget(), declickFrames_);
+    } else if (settings.preset != preset_) {
+        pendingPreset_ = settings.preset;
+        switching_ = true;
+        mix_.rampTo(0.0f, switchFrames_);
+    } else {
+        // A timeline driving the mix keeps it unless a switch is undone.
+        if (switching_ || automatedWet_ < 0.0f) mix_.rampTo(mixTarget(), declickFrames_);
+        switching_ = false;
+    }
+    enabled_ = settings.enabled;
+}
+
+void FdnReverb::loadPreset(ReverbPreset preset) noexcept {
+    preset_ = preset;
+    layout_ = &layouts_[static_cast<std::size_t>(preset)];
+    for (DelayLine& line : lines_) line.clear();
+    preDelayLeft_.clear();
+    preDelayRight_.clear();
+    damped_.fill(0.0f);
+    tail_.setTailFrames(layout_->tailFrames);
+}
+
+void FdnReverb::process(float* left, float* right, std::size_t frames) noexcept {
+    if (snapshots_.update()) apply(snapshots_.front());
+    if (bypassed_) return;
+    SLP_TRACE_SPAN(Audio, "reverb.process");
+
+    if (!tail_.shouldRun(left, right, frames) && !mix_.isRamping()) {
+        if (switching_) {
+            loadPreset(pendingPreset_);
+            switching_ = false;
+            mix_.rampTo(mixTarget(), 0);
+        }
+        if (!enabled_) {
+            mix_.settle();
+            bypassed_ = true;
+        }
+        return;
+    }
+
+    renderWet(left, right, frames);
+    mix_.apply(left, right, wetLeft_.data(), wetRight_.data(), frames);
+
+    if (switching_ && !mix_.isRamping()) {
+        loadPreset(pendingPreset_);
+        switching_ = false;
+        mix_.rampTo(mixTarget(), switchFrames_);
+    }
+    if (!enabled_ && mix_.isDry()) bypassed_ = true;
+}
+
+void FdnReverb::automateMix(float wet, uint64_t frames, uint64_t elapsed) noexcept {
+    if (snapshots_.update()) apply(snapshots_.front());
+    automatedWet_ = std::clamp(wet, 0.0f, 1.0f);
+    // A preset switch fades in to the new value when it completes.
+    if (!enabled_ || switching_) return;
+    mix_.rampTo(automatedWet_, frames);
+    mix_.advance(elapsed);
+}
+
+void FdnReverb::restoreMix() noexcept {
+    if (automatedWet_ < 0.0f) return;
+    automatedWet_ = -1.0f;
+    if (enabled_ && !switching_) mix_.rampTo(wet_, declickFrames_);
+}
+
+void FdnReverb::renderWet(const float* left, const float* right, std::size_t frames) noexcept {
+    for (std::size_t offset = 0; offset < frames; offset += kChunk) {
+        const std::size_t count = std::min(kChunk, frames - offset);
+        renderChunk(left + offset, right + offset, wetLeft_.data() + offset, wetRight_.data() + offset, count);
+    }
+}
+
+void FdnReverb::renderChunk(const float* left, const float* right, float* wetLeft, float* wetRight,
+                            std::size_t count) noexcept {
+    using namespace simd;
+    const Layout& layout = *layout_;
+    // Vector passes run over whole vectors; the lanes past `count` hold
+    // stale but finite values and are never written back.
+    const std::size_t padded = (count + kWidth - 1) / kWidth * kWidth;
+
+    if (layout.preDelay > 0) {
+        preDelayLeft_.readBlock(layout.preDelay, input_[0], count);
+        preDelayRight_.readBlock(layout.preDelay, input_[1], count);
+        preDelayLeft_.writeBlock(left, count);
+        preDelayRight_.writeBlock(right, count);
+    } else {
+        std::memcpy(input_[0], left, count * sizeof(float));
+        std::memcpy(input_[1], right, count * sizeof(float));
+    }
+
+    for (std::size_t k = 0; k < kLines; ++k) {
+        float* x = work_[k];
+        lines_[k].readBlock(layout.lengths[k], x, count);
+        // The damping filter is recursive in time, so it stays scalar.
+        const float gain = layout.gains[k];
+        float state = damped_[k];
+        for (std::size_t i = 0; i < count; ++i) {
+            state += (x[i] - state) * layout.damping;
+            x[i] = state * gain;
+        }
+        damped_[k] = state;
+    }
+
+    // Two orthogonal rows of the Hadamard matrix give decorrelated outputs.
+    const f32x4 outputGain = splat(kOutputGain);
+    for (std::size_t i = 0; i < padded; i += kWidth) {
+        const f32x4 x0 = load(work_[0] + i), x1 = load(work_[1] + i);
+        const f32x4 x2 = load(work_[2] + i), x3 = load(work_[3] + i);
+        const f32x4 x4 = load(work_[4] + i), x5 = load(work_[5] + i);
+        const f32x4 x6 = load(work_[6] + i), x7 = load(work_[7] + i);
+        const f32x4 l = sub(add(add(x0, x2), add(x4, x6)), add(add(x1, x3), add(x5, x7)));
+        const f32x4 r = sub(add(add(x0, x1), add(x4, x5)), add(add(x2, x3), add(x6, x7)));
+        store(wetLeft + i, mul(l, outputGain));
+        store(wetRight + i, mul(r, outputGain));
+    }
+
+    // Fast Walsh-Hadamard transform across the lines.
+    for (std::size_t span = 1; span < kLines; span *= 2) {
+        for (std::size_t k = 0; k < kLines; k += 2 * span) {
+            for (std::size_t j = k; j < k + span; ++j) {
+                float* a = work_[j];
+                float* b = work_[j + span];
+                for (std::size_t i = 0; i < padded; i += kWidth) {
+                    const f32x4 va = load(a + i);
+                    const f32x4 vb = load(b + i);
+                    store(a + i, add(va, vb));
+                    store(b + i, sub(va, vb));
+                }
+            }
+        }
+    }
+
+    // Left feeds the even lines and right the odd ones; the matrix spreads
+    // both across the network on the next pass.
+    for (std::size_t k = 0; k < kLines; ++k) {
+        float* x = work_[k];
+        const float* in = input_[k % 2];
+        for (std::size_t i = 0; i < padded; i += kWidth) store(x + i, add(load(x + i), load(in + i)));
+        lines_[k].writeBlock(x, count);
+    }
+}
+
+} // namespace sleepster
@@ -0,0 +1,94 @@
+//
+//  SLPAnalytics.cpp
+//  SleepsterCore
+//
+
+#include "SLPAnalytics.h"
+
+#include "sleepster/Analytics.hpp"
+
+#include <algorithm>
+
+using namespace sleepster;
+
+static_assert(SLPAnalyticsNoName == kNoAnalyticsName, "no-name ids must agree");
+static_assert(SLPAnalyticsMaxParameters == AnalyticsRecord::kMaxParameters, "parameter limits must agree");
+
+struct SLPAnalytics {
+    std::unique_ptr<AnalyticsPipeline> pipeline;
+};
+
+namespace {
+
+/// Converts at most a record's worth of parameters onto the stack.
+template <typename Log>
+bool withParameters(const SLPAnalyticsParameter* parameters, size_t count, Log log) {
+    AnalyticsParameter converted[AnalyticsRecord::kMaxParameters];
+    const size_t kept = parameters ? std::min(count, AnalyticsRecord::kMaxParameters) : 0;
+    for (size_t i = 0; i < kept; ++i) {
+        const SLPAnalyticsParameter& parameter = parameters[i];
+        switch (parameter.type) {
+        case SLPAnalyticsValueNumber: converted[i] = AnalyticsParameter::of(parameter.key, parameter.number); break;
+        case SLPAnalyticsValueName: converted[i] = AnalyticsParameter::named(parameter.key, parameter.name); break;
+        default: converted[i] = AnalyticsParameter::of(parameter.key, parameter.integer); break;
+        }
+    }
+    return log(converted, kept);
+}
+
+} // namespace
+
+SLPAnalytics* SLPAnalyticsCreate(const char* path, size_t capacity, double flushIntervalSeconds) {
+    std::unique_ptr<AnalyticsFileSink> sink = AnalyticsFileSink::open(path);
+    if (!sink) return nullptr;
+    AnalyticsConfig config;
+    config.capacity = capacity;
+    config.flushIntervalSeconds = flushIntervalSeconds;
+    return new SLPAnalytics{std::make_unique<AnalyticsPipeline>(std::move(sink), config)};
+}
+
+void SLPAnalyticsDestroy(SLPAnalytics* analytics) {
+    delete analytics;
+}
+
+SLPAnalyticsName SLPAnalyticsIntern(SLPAnalytics* analytics, const char* name) {
+    return analytics->pipeline->intern(name);
+}
+
+bool SLPAnalyticsLogEvent(SLPAnalytics* analytics, SLPAnalyticsName event, const SLPAnalyticsParameter* parameters,
+                          size_t count) {
+    return withParameters(parameters, count, [&](const AnalyticsParameter* converted, size_t kept) {
+        return analytics->pipeline->logEvent(event, converted, kept);
+    });
+}
+
+bool SLPAnalyticsBeginTimedEvent(SLPAnalytics* analytics, SLPAnalyticsName event,
+                                 const SLPAnalyticsParameter* parameters, size_t count) {
+    return withParameters(parameters, count, [&](const AnalyticsParameter* converted, size_t kept) {
+        return analytics->pipeline->beginTimedEvent(event, converted, kept);
+    });
+}
+
+bool SLPAnalyticsEndTimedEvent(SLPAnalytics* analytics, SLPAnalyticsName event,
+                               const SLPAnalyticsParameter* parameters, size_t count) {
+    return withParameters(parameters, count, [&](const AnalyticsParameter* converted, size_t kept) {
+        return analytics->pipeline->endTimedEvent(event, converted, kept);
+    });
+}
+
+bool SLPAnalyticsLogError(SLPAnalytics* analytics, SLPAnalyticsName error, SLPAnalyticsName message) {
+    return analytics->pipeline->logError(error, message);
+}
+
+void SLPAnalyticsSetEnabled(SLPAnalytics* analytics, bool enabled) {
+    analytics->pipeline->setEnabled(enabled);
+}
+
+void SLPAnalyticsFlush(SLPAnalytics* analytics) {
+    analytics->pipeline->flush();
+}
+
+SLPAnalyticsMetrics SLPAnalyticsGetMetrics(const SLPAnalytics* analytics) {
+    const AnalyticsMetrics metrics = analytics->pipeline->metrics();
+    return {metrics.written, metrics.dropped, metrics.batches, metrics.failedBatches};
+}
@@ -0,0 +1,39 @@
+//
+//  SLPAssetPack.cpp
+//  SleepsterCore
+//
+
+#include "SLPAssetPack.h"
+
+#include "SLPInternal.hpp"
+
+using namespace sleepster;
+
+SLPAssetPack* SLPAssetPackOpen(const char* path) {
+    auto pack = AssetPack::open(path);
+    if (!pack) return nullptr;
+    return new SLPAssetPack{std::move(pack)};
+}
+
+void SLPAssetPackClose(SLPAssetPack* pack) {
+    delete pack;
+}
+
+bool SLPAssetPackGetInfo(const SLPAssetPack* pack, const char* name, SLPAssetInfo* info) {
+    const AssetView* view = pack->pack->find(name);
+    if (!view) return false;
+    info->sampleRate = view->sampleRate;
+    info->channelCount = view->channelCount;
+    info->frameCount = view->frameCount;
+    info->loopStart = view->loopStart;
+    info->loopEnd = view->loopEnd;
+    info->loudness = view->loudness;
+    info->peak = view->peak;
+    return true;
+}
+
+SLPSource* SLPSourceCreatePacked(const SLPAssetPack* pack, const char* name, bool loop) {
+    const AssetView* view = pack->pack->find(name);
+    if (!view) return nullptr;
+    return new SLPSource{std::make_unique<PackedSource>(pack->pack, *view, loop)};
+}
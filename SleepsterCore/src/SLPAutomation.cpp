@@ -0,0 +1,66 @@
+//
+//  SLPAutomation.cpp
+//  SleepsterCore
+//
+
+#include "SLPAutomation.h"
+
+#include "SLPInternal.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <vector>
+
+using namespace sleepster;
+
+static_assert(SLPAutomationTargetReverbMix == static_cast<int>(AutomationTarget::ReverbMix),
+              "automation targets must agree");
+static_assert(SLPBreakpointShapeExponential == static_cast<int>(BreakpointShape::Exponential),
+              "breakpoint shapes must agree");
+
+SLPAutomation* SLPAutomationCreate(void) {
+    return new (std::nothrow) SLPAutomation;
+}
+
+void SLPAutomationDestroy(SLPAutomation* automation) {
+    delete automation;
+}
+
+uint32_t SLPAutomationAddEQPreset(SLPAutomation* automation, const float* gainsDb, uint32_t count) {
+    auto& presets = automation->timeline.equalizerPresets;
+    presets.emplace_back();
+    if (gainsDb) std::copy_n(gainsDb, std::min<std::size_t>(count, Equalizer::kBandCount), presets.back().begin());
+    return static_cast<uint32_t>(presets.size() - 1);
+}
+
+void SLPAutomationAddBreakpoint(SLPAutomation* automation, SLPAutomationTarget target, uint32_t channel,
+                                uint64_t timeMs, float value, SLPBreakpointShape shape) {
+    if (static_cast<std::size_t>(target) >= kAutomationTargetCount) return;
+    if (shape < SLPBreakpointShapeStep || shape > SLPBreakpointShapeExponential) shape = SLPBreakpointShapeStep;
+    automation->timeline.lane(static_cast<AutomationTarget>(target), channel)
+        .points.push_back({timeMs, value, static_cast<BreakpointShape>(shape)});
+}
+
+void SLPAutomationSetEnd(SLPAutomation* automation, uint64_t timeMs) {
+    automation->timeline.endMs = timeMs;
+}
+
+uint64_t SLPAutomationGetEnd(const SLPAutomation* automation) {
+    return automation->timeline.endMs;
+}
+
+size_t SLPAutomationEncode(const SLPAutomation* automation, uint8_t* out, size_t capacity) {
+    std::vector<uint8_t> bytes;
+    encodeAutomation(automation->timeline, bytes);
+    if (out && bytes.size() <= capacity) std::memcpy(out, bytes.data(), bytes.size());
+    return bytes.size();
+}
+
+SLPAutomation* SLPAutomationDecode(const uint8_t* data, size_t length) {
+    AutomationTimeline timeline;
+    if (!decodeAutomation(data, length, timeline)) return nullptr;
+    auto* automation = new (std::nothrow) SLPAutomation;
+    if (automation) automation->timeline = std::move(timeline);
+    return automation;
+}
@@ -0,0 +1,59 @@
+//
+//  SLPBootstrap.cpp
+//  SleepsterCore
+//
+
+#include "SLPBootstrap.h"
+
+#include "sleepster/Bootstrap.hpp"
+
+using namespace sleepster;
+
+static_assert(SLPBootPhaseIdle == static_cast<int>(BootPhase::Idle), "boot phases must agree");
+static_assert(SLPBootStatusSkipped == static_cast<int>(BootStatus::Skipped), "boot statuses must agree");
+
+struct SLPBootstrap {
+    explicit SLPBootstrap(size_t threads) : pool(threads) {}
+
+    WorkStealingPool pool;
+    Bootstrap bootstrap;
+    std::vector<SLPBootTiming> timings;
+};
+
+SLPBootstrap* SLPBootstrapCreate(size_t threads) {
+    return new SLPBootstrap(threads);
+}
+
+void SLPBootstrapDestroy(SLPBootstrap* bootstrap) {
+    delete bootstrap;
+}
+
+bool SLPBootstrapAdd(SLPBootstrap* bootstrap, const char* name, SLPBootPhase phase, const char* const* dependencies,
+                     size_t dependencyCount, bool onCallingThread, SLPBootStart start, void* context) {
+    BootService service;
+    service.name = name;
+    service.phase = static_cast<BootPhase>(phase);
+    service.affinity = onCallingThread ? BootAffinity::Caller : BootAffinity::Pool;
+    for (size_t i = 0; i < dependencyCount; ++i) service.dependencies.emplace_back(dependencies[i]);
+    service.start = [start, context] { return start(context); };
+    return bootstrap->bootstrap.add(std::move(service));
+}
+
+bool SLPBootstrapRun(SLPBootstrap* bootstrap, SLPBootPhase phase) {
+    return bootstrap->bootstrap.run(static_cast<BootPhase>(phase), bootstrap->pool);
+}
+
+const char* SLPBootstrapGetError(const SLPBootstrap* bootstrap) {
+    return bootstrap->bootstrap.error().c_str();
+}
+
+size_t SLPBootstrapGetTimings(SLPBootstrap* bootstrap, const SLPBootTiming** timings) {
+    bootstrap->timings.clear();
+    for (const BootTiming& timing : bootstrap->bootstrap.timings()) {
+        bootstrap->timings.push_back({timing.name, static_cast<SLPBootPhase>(timing.phase),
+                                      static_cast<SLPBootStatus>(timing.status), timing.thread, timing.ready,
+                                      timing.begin, timing.end});
+    }
+    *timings = bootstrap->timings.empty() ? nullptr : bootstrap->timings.data();
+    return bootstrap->timings.size();
+}
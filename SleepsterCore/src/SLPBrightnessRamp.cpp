@@ -0,0 +1,31 @@
+//
+//  SLPBrightnessRamp.cpp
+//  SleepsterCore
+//
+
+#include "SLPBrightnessRamp.h"
+
+#include "sleepster/BrightnessRamp.hpp"
+
+#include <cstddef>
+
+using namespace sleepster;
+
+// Steps are passed through without copying.
+static_assert(sizeof(SLPBrightnessStep) == sizeof(BrightnessStep));
+static_assert(offsetof(SLPBrightnessStep, brightness) == offsetof(BrightnessStep, brightness));
+
+SLPBrightnessRampConfig SLPBrightnessRampGetDefaultConfig(void) {
+    const BrightnessRampConfig config;
+    return {config.gamma, config.lightnessStep, config.minimumInterval};
+}
+
+size_t SLPBrightnessRampPlan(double from, double to, double duration, SLPBrightnessRampConfig config,
+                             SLPBrightnessStep* steps, size_t capacity) {
+    const BrightnessRampConfig native{config.gamma, config.lightnessStep, config.minimumInterval};
+    return planBrightnessRamp(from, to, duration, native, reinterpret_cast<BrightnessStep*>(steps), capacity);
+}
+
+size_t SLPBrightnessRampGetStepsDue(const SLPBrightnessStep* steps, size_t count, double elapsed) {
+    return brightnessStepsDue(reinterpret_cast<const BrightnessStep*>(steps), count, elapsed);
+}
@@ -0,0 +1,160 @@
+//
+//  SLPCatalog.cpp
+//  SleepsterCore
+//
+
+#include "SLPCatalog.h"
+
+#include "sleepster/Catalog.hpp"
+
+using namespace sleepster;
+
+static_assert(SLPCatalogNotFound == Catalog::kNotFound, "catalog sentinels must agree");
+static_assert(SLPCatalogFlagSelectedForMixing == static_cast<int>(CatalogFlag::SelectedForMixing),
+              "catalog flags must agree");
+
+struct SLPCatalog {
+    std::unique_ptr<Catalog> catalog;
+    /// What the last Get call handed out.
+    CatalogSound sound;
+    CatalogBackground background;
+    std::vector<uint32_t> ids;
+};
+
+namespace {
+
+CatalogSound soundOf(const SLPCatalogSound& sound) {
+    CatalogSound out;
+    out.title = sound.title;
+    out.hasUrl1 = sound.soundUrl1 != nullptr;
+    if (out.hasUrl1) out.url1 = sound.soundUrl1;
+    out.hasUrl2 = sound.soundUrl2 != nullptr;
+    if (out.hasUrl2) out.url2 = sound.soundUrl2;
+    out.favorite = sound.isFavorite;
+    out.selected = sound.isSelected;
+    out.selectedForMixing = sound.isSelectedForMixing;
+    return out;
+}
+
+CatalogBackground backgroundOf(const SLPCatalogBackground& background) {
+    CatalogBackground out;
+    out.animationType = background.animationType;
+    out.hasColorTheme = background.colorTheme != nullptr;
+    if (out.hasColorTheme) out.colorTheme = background.colorTheme;
+    out.intensityLevel = background.intensityLevel;
+    out.speedMultiplier = background.speedMultiplier;
+    out.favorite = background.isFavorite;
+    out.selected = background.isSelected;
+    return out;
+}
+
+size_t handOut(SLPCatalog* catalog, std::vector<uint32_t> ids, const uint32_t** out) {
+    catalog->ids = std::move(ids);
+    *out = catalog->ids.empty() ? nullptr : catalog->ids.data();
+    return catalog->ids.size();
+}
+
+} // namespace
+
+SLPCatalog* SLPCatalogCreate(void) {
+    return new SLPCatalog{std::make_unique<Catalog>(), {}, {}, {}};
+}
+
+SLPCatalog* SLPCatalogLoad(const char* path) {
+    std::unique_ptr<Catalog> catalog = Catalog::load(path);
+    if (!catalog) return nullptr;
+    return new SLPCatalog{std::move(catalog), {}, {}, {}};
+}
+
+bool SLPCatalogSave(const SLPCatalog* catalog, const char* path) {
+    return catalog->catalog->save(path);
+}
+
+void SLPCatalogDestroy(SLPCatalog* catalog) {
+    delete catalog;
+}
+
+uint64_t SLPCatalogGetRevision(const SLPCatalog* catalog) {
+    return catalog->catalog->revision();
+}
+
+bool SLPCatalogAddSound(SLPCatalog* catalog, const SLPCatalogSound* sound, bool fromStore, uint32_t* id) {
+    return catalog->catalog->addSound(soundOf(*sound), *id, fromStore);
+}
+
+bool SLPCatalogAddBackground(SLPCatalog* catalog, const SLPCatalogBackground* background, bool fromStore,
+                             uint32_t* id) {
+    return catalog->catalog->addBackground(backgroundOf(*background), *id, fromStore);
+}
+
+bool SLPCatalogUpdateSound(SLPCatalog* catalog, uint32_t id, const SLPCatalogSound* sound, bool fromStore) {
+    return catalog->catalog->updateSound(id, soundOf(*sound), fromStore);
+}
+
+bool SLPCatalogUpdateBackground(SLPCatalog* catalog, uint32_t id, const SLPCatalogBackground* background,
+                                bool fromStore) {
+    return catalog->catalog->updateBackground(id, backgroundOf(*background), fromStore);
+}
+
+bool SLPCatalogRemove(SLPCatalog* catalog, SLPCatalogKind kind, uint32_t id, bool fromStore) {
+    return catalog->catalog->remove(static_cast<CatalogKind>(kind), id, fromStore);
+}
+
+uint32_t SLPCatalogFind(const SLPCatalog* catalog, SLPCatalogKind kind, const char* key) {
+    return catalog->catalog->find(static_cast<CatalogKind>(kind), key);
+}
+
+bool SLPCatalogIsLive(const SLPCatalog* catalog, SLPCatalogKind kind, uint32_t id) {
+    return catalog->catalog->isLive(static_cast<CatalogKind>(kind), id);
+}
+
+const char* SLPCatalogGetKey(const SLPCatalog* catalog, SLPCatalogKind kind, uint32_t id) {
+    return catalog->catalog->key(static_cast<CatalogKind>(kind), id);
+}
+
+size_t SLPCatalogGetCount(const SLPCatalog* catalog, SLPCatalogKind kind) {
+    return catalog->catalog->size(static_cast<CatalogKind>(kind));
+}
+
+bool SLPCatalogGetSound(SLPCatalog* catalog, uint32_t id, SLPCatalogSound* out) {
+    CatalogSound& sound = catalog->sound;
+    if (!catalog->catalog->sound(id, sound)) return false;
+    *out = {sound.title.c_str(), sound.hasUrl1 ? sound.url1.c_str() : nullptr,
+            sound.hasUrl2 ? sound.url2.c_str() : nullptr, sound.favorite, sound.selected, sound.selectedForMixing};
+    return true;
+}
+
+bool SLPCatalogGetBackground(SLPCatalog* catalog, uint32_t id, SLPCatalogBackground* out) {
+    CatalogBackground& background = catalog->background;
+    if (!catalog->catalog->background(id, background)) return false;
+    *out = {background.animationType.c_str(), background.hasColorTheme ? background.colorTheme.c_str() : nullptr,
+            background.intensityLevel, background.speedMultiplier, background.favorite, background.selected};
+    return true;
+}
+
+bool SLPCatalogSetFlag(SLPCatalog* catalog, SLPCatalogKind kind, uint32_t id, SLPCatalogFlag flag, bool value,
+                       bool fromStore) {
+    return catalog->catalog->setFlag(static_cast<CatalogKind>(kind), id, static_cast<CatalogFlag>(flag), value,
+                                     fromStore);
+}
+
+bool SLPCatalogGetFlag(const SLPCatalog* catalog, SLPCatalogKind kind, uint32_t id, SLPCatalogFlag flag) {
+    return catalog->catalog->flag(static_cast<CatalogKind>(kind), id, static_cast<CatalogFlag>(flag));
+}
+
+bool SLPCatalogSelect(SLPCatalog* catalog, SLPCatalogKind kind, uint32_t id) {
+    return catalog->catalog->select(static_cast<CatalogKind>(kind), id);
+}
+
+uint32_t SLPCatalogGetFirst(const SLPCatalog* catalog, SLPCatalogKind kind, SLPCatalogFlag flag) {
+    return catalog->catalog->firstWith(static_cast<CatalogKind>(kind), static_cast<CatalogFlag>(flag));
+}
+
+size_t SLPCatalogGetAll(SLPCatalog* catalog, SLPCatalogKind kind, SLPCatalogFlag flag, const uint32_t** ids) {
+    return handOut(catalog, catalog->catalog->allWith(static_cast<CatalogKind>(kind), static_cast<CatalogFlag>(flag)),
+                   ids);
+}
+
+size_t SLPCatalogTakeChanges(SLPCatalog* catalog, SLPCatalogKind kind, const uint32_t** ids) {
+    return handOut(catalog, catalog->catalog->takeChanges(static_cast<CatalogKind>(kind)), ids);
+}
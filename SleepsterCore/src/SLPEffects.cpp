@@ -0,0 +1,36 @@
+//
+//  SLPEffects.cpp
+//  SleepsterCore
+//
+
+#include "SLPEffects.h"
+
+#include "SLPInternal.hpp"
+
+void SLPMixerSetReverbEnabled(SLPMixer* mixer, bool enabled) {
+    mixer->mixer.reverb().setEnabled(enabled);
+}
+
+void SLPMixerSetReverbPreset(SLPMixer* mixer, SLPReverbPreset preset) {
+    mixer->mixer.reverb().setPreset(reverbPresetFrom(preset));
+}
+
+void SLPMixerSetReverbMix(SLPMixer* mixer, float wet) {
+    mixer->mixer.reverb().setMix(wet);
+}
+
+void SLPMixerSetDelayEnabled(SLPMixer* mixer, bool enabled) {
+    mixer->mixer.delay().setEnabled(enabled);
+}
+
+void SLPMixerSetDelayTime(SLPMixer* mixer, double seconds) {
+    mixer->mixer.delay().setTime(seconds);
+}
+
+void SLPMixerSetDelayFeedback(SLPMixer* mixer, float feedback) {
+    mixer->mixer.delay().setFeedback(feedback);
+}
+
+void SLPMixerSetDelayMix(SLPMixer* mixer, float wet) {
+    mixer->mixer.delay().setMix(wet);
+}
@@ -0,0 +1,22 @@
+//
+//  SLPEqualizer.cpp
+//  SleepsterCore
+//
+
+#include "SLPEqualizer.h"
+
+#include "SLPInternal.hpp"
+
+static_assert(SLPEqualizerBandCount == sleepster::Equalizer::kBandCount);
+
+void SLPMixerSetEQEnabled(SLPMixer* mixer, bool enabled) {
+    mixer->mixer.equalizer().setEnabled(enabled);
+}
+
+void SLPMixerSetEQGains(SLPMixer* mixer, const float* gainsDb, uint32_t count) {
+    mixer->mixer.equalizer().setGains(gainsDb, count);
+}
+
+void SLPMixerSetEQBandwidth(SLPMixer* mixer, float octaves) {
+    mixer->mixer.equalizer().setBandwidth(octaves);
+}
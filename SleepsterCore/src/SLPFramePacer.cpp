@@ -0,0 +1,48 @@
+//
+//  SLPFramePacer.cpp
+//  SleepsterCore
+//
+
+#include "SLPFramePacer.h"
+
+#include "sleepster/FramePacer.hpp"
+
+using namespace sleepster;
+
+struct SLPFramePacer {
+    FramePacer pacer;
+};
+
+static_assert(static_cast<int>(QualityTier::Minimal) == SLPQualityTierMinimal);
+
+SLPFramePacer* SLPFramePacerCreate(void) {
+    return new SLPFramePacer();
+}
+
+void SLPFramePacerDestroy(SLPFramePacer* pacer) {
+    delete pacer;
+}
+
+bool SLPFramePacerRecordFrame(SLPFramePacer* pacer, double seconds) {
+    return pacer->pacer.recordFrame(seconds);
+}
+
+double SLPFramePacerGetTargetFramesPerSecond(const SLPFramePacer* pacer) {
+    return pacer->pacer.targetFramesPerSecond();
+}
+
+SLPQualityTier SLPFramePacerGetTier(const SLPFramePacer* pacer) {
+    return static_cast<SLPQualityTier>(pacer->pacer.tier());
+}
+
+SLPFramePacerMetrics SLPFramePacerGetMetrics(const SLPFramePacer* pacer) {
+    const FramePacer& native = pacer->pacer;
+    return {
+        native.percentile(0.5),
+        native.percentile(0.9),
+        native.percentile(0.99),
+        native.frameCount(),
+        native.lateFrameCount(),
+        native.levelChangeCount(),
+    };
+}
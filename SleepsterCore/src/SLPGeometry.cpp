@@ -0,0 +1,27 @@
+//
+//  SLPGeometry.cpp
+//  SleepsterCore
+//
+
+#include "SLPGeometry.h"
+
+#include "sleepster/ShapeGeometry.hpp"
+
+using namespace sleepster;
+
+static_assert(sizeof(PathVerb) == sizeof(uint8_t));
+static_assert(static_cast<int>(PathVerb::Close) == SLPPathVerbClose);
+static_assert(static_cast<int>(ShapeKind::Sheep) == SLPShapeSheep);
+
+SLPShapePath SLPShapeGetUnitPath(SLPShape shape) {
+    const int index = static_cast<int>(shape);
+    const ShapeKind kind = index >= 0 && index < kShapeKindCount ? static_cast<ShapeKind>(index)
+                                                                  : ShapeKind::FlowerOfLife;
+    const ShapePath& path = unitShape(kind);
+    return {
+        reinterpret_cast<const uint8_t*>(path.verbs().data()),
+        static_cast<uint32_t>(path.verbs().size()),
+        path.points().data(),
+        static_cast<uint32_t>(path.pointCount()),
+    };
+}
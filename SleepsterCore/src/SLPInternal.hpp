@@ -0,0 +1,44 @@
+//
+//  SLPInternal.hpp
+//  SleepsterCore
+//
+//  Definitions behind the opaque handles of the C interface, shared by the
+//  SLP*.cpp translation units.
+//
+
+#pragma once
+
+#include "SLPEffects.h"
+#include "sleepster/AssetPack.hpp"
+#include "sleepster/AudioSource.hpp"
+#include "sleepster/Automation.hpp"
+#include "sleepster/Mixer.hpp"
+
+#include <memory>
+
+struct SLPMixer {
+    explicit SLPMixer(const sleepster::MixerConfig& config) : mixer(config) {}
+    sleepster::Mixer mixer;
+};
+
+struct SLPSource {
+    std::unique_ptr<sleepster::AudioSource> impl;
+};
+
+struct SLPAssetPack {
+    std::shared_ptr<const sleepster::AssetPack> pack;
+};
+
+struct SLPAutomation {
+    sleepster::AutomationTimeline timeline;
+};
+
+/// Shared by the live effect controls and the offline mix settings.
+inline sleepster::ReverbPreset reverbPresetFrom(SLPReverbPreset preset) noexcept {
+    switch (preset) {
+    case SLPReverbPresetHall: return sleepster::ReverbPreset::Hall;
+    case SLPReverbPresetCathedral: return sleepster::ReverbPreset::Cathedral;
+    case SLPReverbPresetPlate: return sleepster::ReverbPreset::Plate;
+    default: return sleepster::ReverbPreset::Room;
+    }
+}
@@ -0,0 +1,93 @@
+//
+//  SLPMasking.cpp
+//  SleepsterCore
+//
+
+#include "SLPMasking.h"
+
+#include "sleepster/EchoReference.hpp"
+#include "sleepster/MaskingController.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace sleepster;
+
+struct SLPEchoReference {
+    explicit SLPEchoReference(std::size_t frames) : reference(frames) {}
+
+    EchoReference reference;
+};
+
+struct SLPMaskingController {
+    SLPMaskingController(const MaskingConfig& config, int64_t delay)
+        : controller(config), delay(delay), output(controller.frameSize()) {}
+
+    MaskingController controller;
+    int64_t delay;
+    /// The reference span matching a stretch of microphone samples.
+    std::vector<float> output;
+    uint64_t unmatched = 0;
+};
+
+SLPEchoReference* SLPEchoReferenceCreate(double sampleRate) {
+    return new SLPEchoReference(static_cast<std::size_t>(2.0 * sampleRate));
+}
+
+void SLPEchoReferenceDestroy(SLPEchoReference* reference) {
+    delete reference;
+}
+
+void SLPEchoReferenceWrite(SLPEchoReference* reference, const float* left, const float* right, size_t frames,
+                           int64_t position) {
+    reference->reference.write(left, right, frames, position);
+}
+
+SLPMaskingController* SLPMaskingControllerCreate(double sampleRate, double echoDelaySeconds) {
+    MaskingConfig config;
+    config.sampleRate = sampleRate;
+    return new SLPMaskingController(config, static_cast<int64_t>(std::llround(echoDelaySeconds * sampleRate)));
+}
+
+void SLPMaskingControllerDestroy(SLPMaskingController* controller) {
+    delete controller;
+}
+
+void SLPMaskingControllerProcess(SLPMaskingController* controller, const SLPEchoReference* reference,
+                                 const float* microphone, size_t count, int64_t position) {
+    MaskingController& masking = controller->controller;
+    bool matched = true;
+    size_t at = 0;
+    while (at < count) {
+        if (!masking.listening()) {
+            const size_t skip = std::min(count - at, masking.samplesUntilWindow());
+            masking.advance(skip);
+            at += skip;
+            continue;
+        }
+        const size_t take = std::min(count - at, controller->output.size());
+        const int64_t played = position + static_cast<int64_t>(at) - controller->delay;
+        if (reference->reference.read(controller->output.data(), take, played)) {
+            masking.process(microphone + at, controller->output.data(), take);
+        } else {
+            masking.advance(take);
+            matched = false;
+        }
+        at += take;
+    }
+    if (!matched) ++controller->unmatched;
+}
+
+bool SLPMaskingControllerTakeDecision(SLPMaskingController* controller, SLPMaskingDecision* out) {
+    MaskingDecision decision;
+    const bool changed = controller->controller.takeDecision(decision);
+    out->gainDb = decision.gainDb;
+    std::copy(decision.eqDb.begin(), decision.eqDb.end(), out->eqDb);
+    out->coverage = decision.coverage;
+    return changed;
+}
+
+SLPMaskingMetrics SLPMaskingControllerGetMetrics(const SLPMaskingController* controller) {
+    return {controller->controller.windows(), controller->controller.analyzedFrames(), controller->unmatched};
+}
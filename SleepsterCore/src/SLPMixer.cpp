@@ -0,0 +1,120 @@
+//
+//  SLPMixer.cpp
+//  SleepsterCore
+//
+
+#include "SLPMixer.h"
+
+#include "SLPInternal.hpp"
+#include "sleepster/PcmSource.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <new>
+
+using namespace sleepster;
+
+SLPMixer* SLPMixerCreate(SLPMixerConfig config) {
+    MixerConfig mixerConfig;
+    if (config.sampleRate > 0.0) mixerConfig.sampleRate = config.sampleRate;
+    if (config.maxVoices > 0) mixerConfig.maxVoices = config.maxVoices > 0xFFFFu ? 0xFFFFu : config.maxVoices;
+    if (config.maxBlockFrames > 0) mixerConfig.maxBlockFrames = config.maxBlockFrames;
+    return new (std::nothrow) SLPMixer(mixerConfig);
+}
+
+void SLPMixerDestroy(SLPMixer* mixer) {
+    delete mixer;
+}
+
+uint32_t SLPMixerGetMaxVoices(const SLPMixer* mixer) {
+    return mixer->mixer.config().maxVoices;
+}
+
+SLPSource* SLPSourceCreatePCM(const float* const* channels, uint32_t channelCount,
+                              uint64_t frameCount, double sampleRate, bool loop) {
+    if (channelCount == 0 || frameCount == 0) return nullptr;
+    auto buffer = PcmBuffer::copyPlanar(channels, channelCount,
+                                        static_cast<std::size_t>(frameCount), sampleRate);
+    return new SLPSource{std::make_unique<PcmSource>(std::move(buffer), loop)};
+}
+
+void SLPSourceDestroy(SLPSource* source) {
+    delete source;
+}
+
+SLPVoiceID SLPMixerPlay(SLPMixer* mixer, SLPSource* source, float volume) {
+    std::unique_ptr<SLPSource> owned(source);
+    return mixer->mixer.play(std::move(owned->impl), volume);
+}
+
+bool SLPMixerStop(SLPMixer* mixer, SLPVoiceID voice) {
+    return mixer->mixer.stop(voice);
+}
+
+void SLPMixerStopAll(SLPMixer* mixer) {
+    mixer->mixer.stopAll();
+}
+
+bool SLPMixerSetVolume(SLPMixer* mixer, SLPVoiceID voice, float volume) {
+    return mixer->mixer.setVolume(voice, volume);
+}
+
+void SLPMixerSetMasterVolume(SLPMixer* mixer, float volume) {
+    mixer->mixer.setMasterVolume(volume);
+}
+
+bool SLPMixerSetSourceParameter(SLPMixer* mixer, SLPVoiceID voice, uint32_t parameter, float value) {
+    return mixer->mixer.setSourceParameter(voice, parameter, value);
+}
+
+SLPRampToken SLPMixerRampVolume(SLPMixer* mixer, SLPVoiceID voice, float volume, double seconds,
+                                SLPRampCurve curve, bool stopWhenDone) {
+    RampCurve rampCurve = RampCurve::Linear;
+    if (curve == SLPRampCurveEqualPower) rampCurve = RampCurve::EqualPower;
+    if (curve == SLPRampCurveExponential) rampCurve = RampCurve::Exponential;
+    return mixer->mixer.rampVolume(voice, volume, seconds, rampCurve, stopWhenDone);
+}
+
+bool SLPMixerAutomate(SLPMixer* mixer, const SLPAutomation* automation, const SLPVoiceID* channels,
+                      uint32_t channelCount, double startSeconds) {
+    return mixer->mixer.automate(automation->timeline, channels, channels ? channelCount : 0, startSeconds);
+}
+
+void SLPMixerStopAutomation(SLPMixer* mixer) {
+    mixer->mixer.stopAutomation();
+}
+
+bool SLPMixerIsVoiceActive(const SLPMixer* mixer, SLPVoiceID voice) {
+    return mixer->mixer.isActive(voice);
+}
+
+uint32_t SLPMixerGetActiveVoiceCount(const SLPMixer* mixer) {
+    return static_cast<uint32_t>(mixer->mixer.activeVoiceCount());
+}
+
+uint32_t SLPMixerCollectEvents(SLPMixer* mixer, SLPMixerEvent* events, uint32_t maxEvents) {
+    if (!events || maxEvents == 0) {
+        mixer->mixer.collectEvents(nullptr, 0);
+        return 0;
+    }
+    MixerEvent buffer[32];
+    uint32_t total = 0;
+    while (total < maxEvents) {
+        const std::size_t room = std::min<std::size_t>(32, maxEvents - total);
+        const std::size_t count = mixer->mixer.collectEvents(buffer, room);
+        for (std::size_t i = 0; i < count; ++i) {
+            events[total++] = {static_cast<SLPMixerEventType>(buffer[i].type), buffer[i].voice,
+                               buffer[i].ramp};
+        }
+        if (count < room) break;
+    }
+    return total;
+}
+
+bool SLPMixerWaitForEvents(SLPMixer* mixer, int64_t timeoutMs) {
+    return mixer->mixer.waitForEvents(timeoutMs);
+}
+
+void SLPMixerRender(SLPMixer* mixer, float* left, float* right, uint32_t frameCount) {
+    mixer->mixer.render(left, right, frameCount);
+}
@@ -0,0 +1,24 @@
+//
+//  SLPNoise.cpp
+//  SleepsterCore
+//
+
+#include "SLPNoise.h"
+
+#include "SLPInternal.hpp"
+#include "sleepster/NoiseSource.hpp"
+
+using namespace sleepster;
+
+static_assert(SLPNoiseParameterTilt == NoiseSource::kTiltParameter);
+
+SLPSource* SLPSourceCreateNoise(SLPNoiseColor color, uint64_t seed) {
+    NoiseColor native;
+    switch (color) {
+    case SLPNoiseColorWhite: native = NoiseColor::White; break;
+    case SLPNoiseColorPink: native = NoiseColor::Pink; break;
+    case SLPNoiseColorBrown: native = NoiseColor::Brown; break;
+    default: return nullptr;
+    }
+    return new SLPSource{std::make_unique<NoiseSource>(native, seed)};
+}
@@ -0,0 +1,169 @@
+//
+//  SLPOfflineRender.cpp
+//  SleepsterCore
+//
+
+#include "SLPOfflineRender.h"
+
+#include "SLPInternal.hpp"
+#include "sleepster/NoiseSource.hpp"
+#include "sleepster/OfflineRender.hpp"
+#include "sleepster/WavFile.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace sleepster;
+
+struct SLPOfflineMix {
+    OfflineMix mix;
+};
+
+namespace {
+
+OfflineTrack makeTrack(std::function<std::unique_ptr<AudioSource>()> makeSource,
+                       const SLPOfflineTrackConfig& config) {
+    OfflineTrack track;
+    track.makeSource = std::move(makeSource);
+    track.volume = config.volume;
+    track.fadeInSeconds = config.fadeInSeconds;
+    track.fadeOutSeconds = config.fadeOutSeconds;
+    return track;
+}
+
+OfflineRenderOptions makeOptions(const SLPOfflineRenderConfig& config) {
+    OfflineRenderOptions options;
+    options.threads = config.threads;
+    if (config.chunkSeconds > 0.0) options.chunkSeconds = config.chunkSeconds;
+    return options;
+}
+
+void copyStats(const OfflineRenderStats& from, SLPOfflineRenderStats* to) {
+    if (!to) return;
+    to->frames = from.frames;
+    to->threads = from.threads;
+    to->chunks = static_cast<uint32_t>(from.chunks);
+    to->wallSeconds = from.wallSeconds;
+    to->realTimeFactor = from.realTimeFactor;
+}
+
+} // namespace
+
+SLPOfflineMix* SLPOfflineMixCreate(double sampleRate, double durationSeconds) {
+    if (!(sampleRate > 0.0) || !(durationSeconds >= 0.0)) return nullptr;
+    auto* mix = new SLPOfflineMix;
+    mix->mix.sampleRate = sampleRate;
+    mix->mix.durationSeconds = durationSeconds;
+    return mix;
+}
+
+void SLPOfflineMixDestroy(SLPOfflineMix* mix) {
+    delete mix;
+}
+
+// MARK: - Tracks
+
+bool SLPOfflineMixAddPacked(SLPOfflineMix* mix, const SLPAssetPack* pack, const char* name, bool loop,
+                            SLPOfflineTrackConfig config) {
+    const AssetView* view = pack->pack->find(name);
+    if (!view) return false;
+    std::shared_ptr<const AssetPack> shared = pack->pack;
+    const AssetView copy = *view;
+    mix->mix.tracks.push_back(makeTrack(
+        [shared, copy, loop] { return std::make_unique<PackedSource>(shared, copy, loop); }, config));
+    return true;
+}
+
+bool SLPOfflineMixAddNoise(SLPOfflineMix* mix, SLPNoiseColor color, uint64_t seed, SLPOfflineTrackConfig config) {
+    NoiseColor native;
+    switch (color) {
+    case SLPNoiseColorWhite: native = NoiseColor::White; break;
+    case SLPNoiseColorPink: native = NoiseColor::Pink; break;
+    case SLPNoiseColorBrown: native = NoiseColor::Brown; break;
+    default: return false;
+    }
+    mix->mix.tracks.push_back(makeTrack(
+        [native, seed] { return std::make_unique<NoiseSource>(native, seed); }, config));
+    return true;
+}
+
+bool SLPOfflineMixAddWAV(SLPOfflineMix* mix, const char* path, bool loop, SLPOfflineTrackConfig config) {
+    // Check the file now rather than failing halfway through a render.
+    if (!WavDecoder::open(path)) return false;
+    const std::string file = path;
+    mix->mix.tracks.push_back(makeTrack(
+        [file, loop]() -> std::unique_ptr<AudioSource> {
+            auto decoder = WavDecoder::open(file);
+            if (!decoder) return nullptr;
+            return std::make_unique<DecoderSource>(std::move(decoder), loop);
+        },
+        config));
+    return true;
+}
+
+// MARK: - Master bus
+
+void SLPOfflineMixSetMasterVolume(SLPOfflineMix* mix, float volume) {
+    mix->mix.bus.masterVolume = volume;
+}
+
+void SLPOfflineMixSetEQ(SLPOfflineMix* mix, bool enabled, const float* gainsDb, uint32_t count) {
+    BusSettings& bus = mix->mix.bus;
+    bus.equalizerEnabled = enabled;
+    bus.equalizerGainsDb.fill(0.0f);
+    if (gainsDb) {
+        std::copy_n(gainsDb, std::min<std::size_t>(count, bus.equalizerGainsDb.size()), bus.equalizerGainsDb.begin());
+    }
+}
+
+void SLPOfflineMixSetDelay(SLPOfflineMix* mix, bool enabled, double seconds, float feedback, float wet) {
+    BusSettings& bus = mix->mix.bus;
+    bus.delayEnabled = enabled;
+    bus.delaySeconds = seconds;
+    bus.delayFeedback = feedback;
+    bus.delayMix = wet;
+}
+
+void SLPOfflineMixSetReverb(SLPOfflineMix* mix, bool enabled, SLPReverbPreset preset, float wet) {
+    BusSettings& bus = mix->mix.bus;
+    bus.reverbEnabled = enabled;
+    bus.reverbPreset = reverbPresetFrom(preset);
+    bus.reverbMix = wet;
+}
+
+void SLPOfflineMixSetAutomation(SLPOfflineMix* mix, const SLPAutomation* automation) {
+    mix->mix.automation = automation ? automation->timeline : AutomationTimeline{};
+}
+
+// MARK: - Rendering
+
+bool SLPOfflineMixRenderToFile(const SLPOfflineMix* mix, const char* path, SLPAudioFileType type,
+                               SLPSampleFormat format, SLPOfflineRenderConfig config,
+                               SLPOfflineRenderStats* stats) {
+    OfflineRenderStats result;
+    const bool ok = renderOfflineToFile(
+        mix->mix, makeOptions(config), path, type == SLPAudioFileTypeCAF ? AudioFileType::Caf : AudioFileType::Wav,
+        format == SLPSampleFormatFloat32 ? WavFormat::Encoding::Float32 : WavFormat::Encoding::Pcm16, &result);
+    copyStats(result, stats);
+    return ok;
+}
+
+bool SLPOfflineMixRenderToBuffer(const SLPOfflineMix* mix, float* left, float* right, uint64_t capacity,
+                                 SLPOfflineRenderConfig config, SLPOfflineRenderStats* stats) {
+    const uint64_t wanted = std::min(capacity, mix->mix.frameCount());
+    uint64_t written = 0;
+    OfflineRenderStats result;
+    const bool rendered = renderOffline(
+        mix->mix, makeOptions(config),
+        [&](const float* chunkLeft, const float* chunkRight, std::size_t frames) {
+            const auto count = static_cast<std::size_t>(std::min<uint64_t>(frames, wanted - written));
+            std::memcpy(left + written, chunkLeft, count * sizeof(float));
+            std::memcpy(right + written, chunkRight, count * sizeof(float));
+            written += count;
+            // Stopping early once the buffer is full is not a failure.
+            return written < wanted;
+        },
+        &result);
+    copyStats(result, stats);
+    return rendered || written == wanted;
+}
@@ -0,0 +1,44 @@
+//
+//  SLPPalette.cpp
+//  SleepsterCore
+//
+
+#include "SLPPalette.h"
+
+#include "sleepster/Palette.hpp"
+
+using namespace sleepster;
+
+static_assert(static_cast<int>(PaletteTheme::Monochrome) == SLPPaletteThemeMonochrome);
+static_assert(static_cast<int>(Swatch::AccentStroke) == SLPSwatchAccentStroke);
+static_assert(kSwatchCount == SLPSwatchAccentStroke + 1);
+static_assert(static_cast<int>(PaletteGradient::Crystal) == SLPPaletteGradientCrystal);
+static_assert(kPaletteGradientCount == SLPPaletteGradientCrystal + 1);
+static_assert(palette::kMaxStops == 4);
+
+static const Palette& paletteFor(SLPPaletteTheme theme, bool dimmed, uint32_t tier) {
+    return themePalette(static_cast<PaletteTheme>(theme), dimmed, tier);
+}
+
+uint32_t SLPPaletteTier(float intensity) {
+    return static_cast<uint32_t>(paletteTier(intensity));
+}
+
+uint32_t SLPPaletteGetSwatch(SLPPaletteTheme theme, bool dimmed, uint32_t tier, SLPSwatch swatch) {
+    const auto index = static_cast<std::size_t>(swatch);
+    return index < kSwatchCount ? paletteFor(theme, dimmed, tier).swatches[index] : 0;
+}
+
+SLPGradientStops SLPPaletteGetStops(SLPPaletteTheme theme, bool dimmed, uint32_t tier, SLPPaletteGradient gradient) {
+    const auto index = static_cast<std::size_t>(gradient) % kPaletteGradientCount;
+    const GradientStops& stops = paletteFor(theme, dimmed, tier).gradients[index];
+    SLPGradientStops out;
+    for (std::size_t i = 0; i < palette::kMaxStops; ++i) out.colors[i] = stops.colors[i];
+    out.count = stops.count;
+    return out;
+}
+
+const uint32_t* SLPPaletteGetRamp(SLPPaletteTheme theme, bool dimmed, uint32_t tier, SLPPaletteGradient gradient) {
+    const auto index = static_cast<std::size_t>(gradient) % kPaletteGradientCount;
+    return paletteFor(theme, dimmed, tier).ramps[index];
+}
@@ -0,0 +1,119 @@
+//
+//  SLPParticles.cpp
+//  SleepsterCore
+//
+
+#include "SLPParticles.h"
+
+#include "sleepster/ParticleSystem.hpp"
+
+using namespace sleepster;
+
+struct SLPParticleScene {
+    explicit SLPParticleScene(uint64_t seed) : scene(seed) {}
+    ParticleScene scene;
+};
+
+namespace {
+
+/// Far more than any background draws; keeps a bad count from asking for
+/// gigabytes.
+constexpr uint32_t kMaxParticles = 1u << 20;
+
+ParticleRange rangeFrom(SLPParticleRange range) noexcept { return {range.min, range.max}; }
+
+ParticleBounds boundsFrom(SLPParticleBounds bounds) noexcept {
+    return {bounds.minX, bounds.minY, bounds.maxX, bounds.maxY};
+}
+
+bool motionFrom(SLPParticleMotion motion, ParticleMotion& out) noexcept {
+    switch (motion) {
+    case SLPParticleMotionStatic: out = ParticleMotion::Static; return true;
+    case SLPParticleMotionDrift: out = ParticleMotion::Drift; return true;
+    case SLPParticleMotionOrbit: out = ParticleMotion::Orbit; return true;
+    case SLPParticleMotionFall: out = ParticleMotion::Fall; return true;
+    }
+    return false;
+}
+
+} // namespace
+
+SLPParticleScene* SLPParticleSceneCreate(uint64_t seed) {
+    return new SLPParticleScene(seed);
+}
+
+void SLPParticleSceneDestroy(SLPParticleScene* scene) {
+    delete scene;
+}
+
+int32_t SLPParticleSceneAddSystem(SLPParticleScene* scene, SLPParticleConfig config) {
+    ParticleConfig native;
+    if (!motionFrom(config.motion, native.motion) || config.count > kMaxParticles) return -1;
+    native.count = config.count;
+    native.bounds = boundsFrom(config.bounds);
+    native.x = rangeFrom(config.x);
+    native.y = rangeFrom(config.y);
+    native.velocityX = rangeFrom(config.velocityX);
+    native.velocityY = rangeFrom(config.velocityY);
+    native.radiusX = rangeFrom(config.radiusX);
+    native.radiusY = rangeFrom(config.radiusY);
+    native.orbitRate = rangeFrom(config.orbitRate);
+    native.size = rangeFrom(config.size);
+    native.alpha = rangeFrom(config.alpha);
+    native.twinkleRate = rangeFrom(config.twinkleRate);
+    native.twinkleDepth = config.twinkleDepth;
+    native.windX = config.windX;
+    native.windY = config.windY;
+    return static_cast<int32_t>(scene->scene.add(native));
+}
+
+void SLPParticleSceneStep(SLPParticleScene* scene, double seconds) {
+    scene->scene.update(seconds);
+}
+
+int32_t SLPParticleSceneAdvance(SLPParticleScene* scene, double seconds) {
+    return scene->scene.advance(seconds);
+}
+
+void SLPParticleSceneSetBounds(SLPParticleScene* scene, uint32_t system, SLPParticleBounds bounds) {
+    if (system < scene->scene.systemCount()) scene->scene.system(system).setBounds(boundsFrom(bounds));
+}
+
+void SLPParticleSceneSetWind(SLPParticleScene* scene, uint32_t system, float x, float y) {
+    if (system < scene->scene.systemCount()) scene->scene.system(system).setWind(x, y);
+}
+
+uint32_t SLPParticleSceneGetCount(const SLPParticleScene* scene, uint32_t system) {
+    if (system >= scene->scene.systemCount()) return 0;
+    return static_cast<uint32_t>(scene->scene.system(system).count());
+}
+
+// The column getters trust `system`, as Swift reads them once per frame per
+// particle kind and has the index from SLPParticleSceneAddSystem.
+
+const float* SLPParticleSceneGetX(const SLPParticleScene* scene, uint32_t system) {
+    return scene->scene.system(system).drawX();
+}
+
+const float* SLPParticleSceneGetY(const SLPParticleScene* scene, uint32_t system) {
+    return scene->scene.system(system).drawY();
+}
+
+const float* SLPParticleSceneGetSize(const SLPParticleScene* scene, uint32_t system) {
+    return scene->scene.system(system).size();
+}
+
+const float* SLPParticleSceneGetAlpha(const SLPParticleScene* scene, uint32_t system) {
+    return scene->scene.system(system).alpha();
+}
+
+const SLPParticleExit* SLPParticleSceneGetExits(const SLPParticleScene* scene, uint32_t system, uint32_t* count) {
+    static_assert(sizeof(SLPParticleExit) == sizeof(ParticleExit), "exits are handed out in place");
+    if (system >= scene->scene.systemCount()) {
+        *count = 0;
+        return nullptr;
+    }
+    const ParticleSystem& particles = scene->scene.system(system);
+    *count = static_cast<uint32_t>(particles.exitCount());
+    return reinterpret_cast<const SLPParticleExit*>(particles.exits());
+}
@@ -0,0 +1,122 @@
+//
+//  SLPSessionLog.cpp
+//  SleepsterCore
+//
+
+#include "SLPSessionLog.h"
+
+#include "sleepster/SessionLog.hpp"
+
+#include <cstring>
+
+using namespace sleepster;
+
+struct SLPSessionLog {
+    std::unique_ptr<SessionLog> log;
+};
+
+namespace {
+
+/// The session SLPSessionLogGetSession last decoded on this thread, with the
+/// pointer arrays its SLPSleepSession hands out.
+struct DecodedSession {
+    SleepSessionRecord record;
+    std::vector<const char*> soundsUsed;
+    std::vector<const char*> activeSounds;
+    std::vector<SLPSoundEvent> soundEvents;
+};
+
+thread_local DecodedSession decoded;
+
+std::vector<std::string> stringsOf(const char* const* strings, size_t count) {
+    std::vector<std::string> out;
+    out.reserve(count);
+    for (size_t i = 0; i < count; ++i) out.emplace_back(strings[i]);
+    return out;
+}
+
+void pointTo(const std::vector<std::string>& strings, std::vector<const char*>& pointers) {
+    pointers.clear();
+    for (const std::string& string : strings) pointers.push_back(string.c_str());
+}
+
+} // namespace
+
+SLPSessionLog* SLPSessionLogOpen(const char* path) {
+    std::unique_ptr<SessionLog> log = SessionLog::open(path);
+    if (!log) return nullptr;
+    return new SLPSessionLog{std::move(log)};
+}
+
+void SLPSessionLogClose(SLPSessionLog* log) {
+    delete log;
+}
+
+bool SLPSessionLogAppend(SLPSessionLog* log, const SLPSleepSession* session) {
+    SleepSessionRecord record;
+    std::memcpy(record.id.data(), session->id, record.id.size());
+    record.startTime = session->startTime;
+    record.endTime = session->endTime;
+    record.expectedDuration = session->expectedDuration;
+    record.actualDuration = session->actualDuration;
+    record.soundsUsed = stringsOf(session->soundsUsed, session->soundsUsedCount);
+    record.hasBackground = session->backgroundUsed != nullptr;
+    if (session->backgroundUsed) record.backgroundUsed = session->backgroundUsed;
+    record.masterVolume = session->masterVolume;
+    record.activeSounds = stringsOf(session->activeSounds, session->activeSoundsCount);
+    record.equalizerPreset = session->equalizerPreset;
+    record.effectsEnabled = session->effectsEnabled;
+    record.soundEvents.reserve(session->soundEventsCount);
+    for (size_t i = 0; i < session->soundEventsCount; ++i) {
+        const SLPSoundEvent& event = session->soundEvents[i];
+        record.soundEvents.push_back(
+            {static_cast<SoundEventKind>(event.kind), event.time, event.duration, event.peakLevel});
+    }
+    return log->log->append(record);
+}
+
+bool SLPSessionLogRemove(SLPSessionLog* log, const uint8_t* id) {
+    SessionId sessionId;
+    std::memcpy(sessionId.data(), id, sessionId.size());
+    return log->log->remove(sessionId);
+}
+
+size_t SLPSessionLogGetCount(const SLPSessionLog* log) {
+    return log->log->size();
+}
+
+bool SLPSessionLogGetSession(const SLPSessionLog* log, size_t index, SLPSleepSession* out) {
+    SleepSessionRecord& record = decoded.record;
+    if (!log->log->read(index, record)) return false;
+    pointTo(record.soundsUsed, decoded.soundsUsed);
+    pointTo(record.activeSounds, decoded.activeSounds);
+    decoded.soundEvents.clear();
+    for (const SoundEvent& event : record.soundEvents) {
+        decoded.soundEvents.push_back(
+            {static_cast<SLPSoundEventKind>(event.kind), event.time, event.duration, event.peakLevel});
+    }
+    std::memcpy(out->id, record.id.data(), record.id.size());
+    out->startTime = record.startTime;
+    out->endTime = record.endTime;
+    out->expectedDuration = record.expectedDuration;
+    out->actualDuration = record.actualDuration;
+    out->soundsUsed = decoded.soundsUsed.data();
+    out->soundsUsedCount = decoded.soundsUsed.size();
+    out->backgroundUsed = record.hasBackground ? record.backgroundUsed.c_str() : nullptr;
+    out->masterVolume = record.masterVolume;
+    out->activeSounds = decoded.activeSounds.data();
+    out->activeSoundsCount = decoded.activeSounds.size();
+    out->equalizerPreset = record.equalizerPreset.c_str();
+    out->effectsEnabled = record.effectsEnabled;
+    out->soundEvents = decoded.soundEvents.empty() ? nullptr : decoded.soundEvents.data();
+    out->soundEventsCount = decoded.soundEvents.size();
+    return true;
+}
+
+bool SLPSessionLogNeedsCompaction(const SLPSessionLog* log) {
+    return log->log->needsCompaction();
+}
+
+bool SLPSessionLogCompact(SLPSessionLog* log) {
+    return log->log->compact();
+}
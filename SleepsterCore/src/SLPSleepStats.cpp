@@ -0,0 +1,83 @@
+//
+//  SLPSleepStats.cpp
+//  SleepsterCore
+//
+
+#include "SLPSleepStats.h"
+
+#include "sleepster/SleepStats.hpp"
+
+#include <algorithm>
+
+using namespace sleepster;
+
+struct SLPSleepStats {
+    SleepStats stats;
+};
+
+namespace {
+
+SLPSleepSummary toSummary(const SleepSummary& summary) {
+    SLPSleepSummary out{};
+    out.asleepCount = summary.asleep.count;
+    out.totalAsleep = summary.asleep.total();
+    out.averageAsleep = summary.asleep.mean;
+    out.asleepDeviation = summary.asleep.deviation();
+    out.inBedCount = summary.inBed.count;
+    out.totalInBed = summary.inBed.total();
+    out.efficiency = summary.efficiency();
+    out.meanBedtime = summary.meanBedtime();
+    out.bedtimeDeviation = summary.bedtimeDeviation();
+    out.bedtimeConsistency = summary.bedtimeConsistency();
+    return out;
+}
+
+} // namespace
+
+SLPSleepStats* SLPSleepStatsCreate(void) {
+    return new SLPSleepStats();
+}
+
+void SLPSleepStatsDestroy(SLPSleepStats* stats) {
+    delete stats;
+}
+
+bool SLPSleepStatsAdd(SLPSleepStats* stats, const SLPSleepSample* sample) {
+    SleepSample native;
+    std::copy(sample->id, sample->id + 16, native.id.begin());
+    native.startTime = sample->startTime;
+    native.endTime = sample->endTime;
+    native.utcOffset = sample->utcOffset;
+    native.category = sample->category == SLPSleepCategoryAsleep ? SleepCategory::Asleep : SleepCategory::InBed;
+    return stats->stats.add(native);
+}
+
+bool SLPSleepStatsRemove(SLPSleepStats* stats, const uint8_t* id) {
+    SleepSampleId native;
+    std::copy(id, id + 16, native.begin());
+    return stats->stats.remove(native);
+}
+
+size_t SLPSleepStatsGetCount(const SLPSleepStats* stats) {
+    return stats->stats.size();
+}
+
+int64_t SLPSleepStatsNightOf(double time, int32_t utcOffset) {
+    return SleepStats::nightOf(time, utcOffset);
+}
+
+SLPSleepSummary SLPSleepStatsGetRange(const SLPSleepStats* stats, int64_t firstNight, int64_t lastNight) {
+    return toSummary(stats->stats.range(firstNight, lastNight));
+}
+
+SLPSleepSummary SLPSleepStatsGetWeek(const SLPSleepStats* stats, int64_t night) {
+    return toSummary(stats->stats.week(SleepStats::weekOf(night)));
+}
+
+SLPSleepSummary SLPSleepStatsGetMonth(const SLPSleepStats* stats, int64_t night) {
+    return toSummary(stats->stats.month(SleepStats::monthOf(night)));
+}
+
+SLPSleepSummary SLPSleepStatsGetTotal(const SLPSleepStats* stats) {
+    return toSummary(stats->stats.total());
+}
@@ -0,0 +1,54 @@
+//
+//  SLPSoundEvents.cpp
+//  SleepsterCore
+//
+
+#include "SLPSoundEvents.h"
+
+#include "sleepster/SoundEventDetector.hpp"
+
+using namespace sleepster;
+
+struct SLPSoundEventDetector {
+    explicit SLPSoundEventDetector(const SoundEventDetectorConfig& config) : detector(config) {}
+
+    SoundEventDetector detector;
+};
+
+SLPSoundEventDetector* SLPSoundEventDetectorCreate(double sampleRate) {
+    SoundEventDetectorConfig config;
+    config.sampleRate = sampleRate;
+    return new SLPSoundEventDetector(config);
+}
+
+void SLPSoundEventDetectorDestroy(SLPSoundEventDetector* detector) {
+    delete detector;
+}
+
+void SLPSoundEventDetectorProcess(SLPSoundEventDetector* detector, const float* samples, size_t count) {
+    detector->detector.process(samples, count);
+}
+
+void SLPSoundEventDetectorFlush(SLPSoundEventDetector* detector) {
+    detector->detector.flush();
+}
+
+size_t SLPSoundEventDetectorTakeEvents(SLPSoundEventDetector* detector, SLPSoundEvent* events, size_t capacity) {
+    SoundEvent native[16];
+    size_t taken = 0;
+    while (taken < capacity) {
+        const std::size_t count = detector->detector.takeEvents(native, std::min<size_t>(16, capacity - taken));
+        if (count == 0) break;
+        for (std::size_t i = 0; i < count; ++i) {
+            events[taken + i] = {static_cast<SLPSoundEventKind>(native[i].kind), native[i].time, native[i].duration,
+                                 native[i].peakLevel};
+        }
+        taken += count;
+    }
+    return taken;
+}
+
+SLPSoundEventDetectorMetrics SLPSoundEventDetectorGetMetrics(const SLPSoundEventDetector* detector) {
+    const SoundEventDetector& native = detector->detector;
+    return {native.analyzedHops(), native.gatedHops(), native.droppedEvents(), native.noiseFloor()};
+}
@@ -0,0 +1,94 @@
+//
+//  SLPStaticLayer.cpp
+//  SleepsterCore
+//
+
+#include "SLPStaticLayer.h"
+
+#include "sleepster/StaticLayer.hpp"
+
+#include <algorithm>
+
+using namespace sleepster;
+
+struct SLPStaticLayer {
+    explicit SLPStaticLayer(StaticLayer layer) : layer(std::move(layer)) {}
+    StaticLayer layer;
+};
+
+namespace {
+
+Rgba colorFrom(SLPColor color) noexcept { return {color.r, color.g, color.b, color.a}; }
+
+Gradient gradientFrom(const SLPGradient& gradient) noexcept {
+    Gradient native;
+    native.count = static_cast<int>(std::min<uint32_t>(3, std::max<uint32_t>(1, gradient.count)));
+    for (int i = 0; i < native.count; ++i) native.stops[i] = colorFrom(gradient.stops[i]);
+    return native;
+}
+
+ParticleRange rangeFrom(SLPParticleRange range) noexcept { return {range.min, range.max}; }
+
+} // namespace
+
+SLPStaticLayer* SLPStaticLayerCreateHills(float width, float top, float bottom, float scale,
+                                          const SLPHillConfig* hills, uint32_t count) {
+    std::vector<HillConfig> native(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        native[i] = {hills[i].top, hills[i].height, gradientFrom(hills[i].fill), hills[i].blur};
+    }
+    return new SLPStaticLayer(renderHills(width, top, bottom, scale, native));
+}
+
+SLPStaticLayer* SLPStaticLayerCreateGrass(SLPGrassConfig config) {
+    GrassConfig native;
+    native.seed = config.seed;
+    native.width = config.width;
+    native.scale = config.scale;
+    native.spacing = config.spacing;
+    native.jitterX = config.jitterX;
+    native.jitterY = config.jitterY;
+    native.baseline = config.baseline;
+    native.bladeHeight = rangeFrom(config.bladeHeight);
+    native.bladeWidth = rangeFrom(config.bladeWidth);
+    native.fill = gradientFrom(config.fill);
+    native.blur = config.blur;
+    native.shadow = colorFrom(config.shadow);
+    native.shadowRadius = config.shadowRadius;
+    native.shadowX = config.shadowX;
+    native.shadowY = config.shadowY;
+    return new SLPStaticLayer(renderGrass(native));
+}
+
+SLPStaticLayer* SLPStaticLayerCreateStarSprites(SLPStarSpriteConfig config, uint32_t* cellPixels) {
+    StarSpriteConfig native;
+    native.scale = config.scale;
+    native.size = rangeFrom(config.size);
+    native.count = static_cast<int>(std::max<uint32_t>(1, std::min<uint32_t>(64, config.count)));
+    native.fill = gradientFrom(config.fill);
+    native.fillRadius = config.fillRadius;
+    *cellPixels = static_cast<uint32_t>(spriteCell(native));
+    return new SLPStaticLayer(renderStarSprites(native));
+}
+
+void SLPStaticLayerDestroy(SLPStaticLayer* layer) {
+    delete layer;
+}
+
+SLPLayerFrame SLPStaticLayerGetFrame(const SLPStaticLayer* layer) {
+    const StaticLayer& native = layer->layer;
+    return {native.x, native.y, native.width(), native.height()};
+}
+
+uint32_t SLPStaticLayerGetPixelWidth(const SLPStaticLayer* layer) {
+    return static_cast<uint32_t>(layer->layer.bitmap.width());
+}
+
+uint32_t SLPStaticLayerGetPixelHeight(const SLPStaticLayer* layer) {
+    return static_cast<uint32_t>(layer->layer.bitmap.height());
+}
+
+const uint8_t* SLPStaticLayerGetPixels(const SLPStaticLayer* layer) {
+    const Bitmap& bitmap = layer->layer.bitmap;
+    return bitmap.byteCount() > 0 ? bitmap.data() : nullptr;
+}
@@ -0,0 +1,66 @@
+//
+//  SLPStreaming.cpp
+//  SleepsterCore
+//
+
+#include "SLPStreaming.h"
+
+#include "SLPInternal.hpp"
+#include "sleepster/StreamingSource.hpp"
+#include "sleepster/WavFile.hpp"
+
+using namespace sleepster;
+
+namespace {
+
+/// Adapts host-provided callbacks to the Decoder interface.
+class CallbackDecoder final : public Decoder {
+public:
+    explicit CallbackDecoder(const SLPDecoderCallbacks& callbacks) : callbacks_(callbacks) {}
+
+    ~CallbackDecoder() override {
+        if (callbacks_.release) callbacks_.release(callbacks_.context);
+    }
+
+    double sampleRate() const noexcept override { return callbacks_.sampleRate; }
+    uint64_t frameCount() const noexcept override { return callbacks_.frameCount; }
+
+    std::size_t decode(float* left, float* right, std::size_t frames) override {
+        return static_cast<std::size_t>(callbacks_.decode(callbacks_.context, left, right, frames));
+    }
+
+    bool seek(uint64_t frame) override {
+        return callbacks_.seek(callbacks_.context, frame);
+    }
+
+private:
+    SLPDecoderCallbacks callbacks_;
+};
+
+StreamingConfig makeConfig(const SLPStreamingConfig& config) {
+    StreamingConfig result;
+    if (config.lookaheadSeconds > 0.0) result.lookaheadSeconds = config.lookaheadSeconds;
+    result.loop = config.loop;
+    return result;
+}
+
+} // namespace
+
+SLPSource* SLPSourceCreateStream(SLPDecoderCallbacks callbacks, SLPStreamingConfig config) {
+    if (callbacks.sampleRate <= 0.0) {
+        if (callbacks.release) callbacks.release(callbacks.context);
+        return nullptr;
+    }
+    auto decoder = std::make_unique<CallbackDecoder>(callbacks);
+    return new SLPSource{std::make_unique<StreamingSource>(std::move(decoder), makeConfig(config))};
+}
+
+SLPSource* SLPSourceCreateWAVStream(const char* path, SLPStreamingConfig config) {
+    auto decoder = WavDecoder::open(path);
+    if (!decoder) return nullptr;
+    return new SLPSource{std::make_unique<StreamingSource>(std::move(decoder), makeConfig(config))};
+}
+
+double SLPStreamingGetDecodeCPUSeconds(void) {
+    return StreamDecodeWorker::shared().cpuSeconds();
+}
@@ -0,0 +1,52 @@
+//
+//  SLPTimerWheel.cpp
+//  SleepsterCore
+//
+
+#include "SLPTimerWheel.h"
+
+#include "sleepster/TimerWheel.hpp"
+
+using namespace sleepster;
+
+struct SLPTimerWheel {
+    explicit SLPTimerWheel(double now) : wheel(now) {}
+
+    TimerWheel wheel;
+};
+
+SLPTimerWheel* SLPTimerWheelCreate(double now) {
+    return new SLPTimerWheel(now);
+}
+
+void SLPTimerWheelDestroy(SLPTimerWheel* wheel) {
+    delete wheel;
+}
+
+SLPTimerID SLPTimerWheelSchedule(SLPTimerWheel* wheel, double deadline, double interval, double tolerance,
+                                 bool critical) {
+    return wheel->wheel.schedule({deadline, interval, tolerance, critical});
+}
+
+bool SLPTimerWheelCancel(SLPTimerWheel* wheel, SLPTimerID timer) {
+    return wheel->wheel.cancel(timer);
+}
+
+double SLPTimerWheelGetNextWakeup(const SLPTimerWheel* wheel) {
+    return wheel->wheel.nextWakeup();
+}
+
+size_t SLPTimerWheelAdvance(SLPTimerWheel* wheel, double now, const SLPTimerID** fired) {
+    const std::vector<TimerId>& ids = wheel->wheel.advance(now);
+    *fired = ids.empty() ? nullptr : ids.data();
+    return ids.size();
+}
+
+void SLPTimerWheelSetLowPower(SLPTimerWheel* wheel, bool enabled) {
+    wheel->wheel.setLowPower(enabled);
+}
+
+SLPTimerWheelMetrics SLPTimerWheelGetMetrics(const SLPTimerWheel* wheel) {
+    const TimerWheel& native = wheel->wheel;
+    return {native.wakeupCount(), native.firedCount(), native.wakeupsPerHour()};
+}
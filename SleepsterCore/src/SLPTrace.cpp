@@ -0,0 +1,49 @@
+//
+//  SLPTrace.cpp
+//  SleepsterCore
+//
+
+#include "SLPTrace.h"
+
+#include "sleepster/Trace.hpp"
+
+using namespace sleepster;
+
+static_assert(SLPTraceCategoryApp == static_cast<int>(TraceCategory::App), "trace categories must agree");
+
+void SLPTraceSetEnabled(bool enabled) {
+    Tracer::setEnabled(enabled);
+}
+
+bool SLPTraceIsEnabled(void) {
+    return Tracer::enabled();
+}
+
+void SLPTraceSetThreadName(const char* name) {
+    Tracer::setThreadName(name);
+}
+
+uint64_t SLPTraceBegin(void) {
+    return Tracer::enabled() ? traceNow() : 0;
+}
+
+void SLPTraceEnd(SLPTraceCategory category, const char* name, uint64_t begin) {
+    if (begin != 0) Tracer::complete(static_cast<TraceCategory>(category), name, begin, traceNow());
+}
+
+void SLPTraceCounter(SLPTraceCategory category, const char* name, double value) {
+    if (Tracer::enabled()) Tracer::counter(static_cast<TraceCategory>(category), name, value);
+}
+
+void SLPTraceClear(void) {
+    Tracer::clear();
+}
+
+bool SLPTraceExportChromeJson(const char* path) {
+    return Tracer::exportChromeJson(path);
+}
+
+SLPTraceMetrics SLPTraceGetMetrics(void) {
+    const TraceMetrics metrics = Tracer::metrics();
+    return {metrics.recorded, metrics.overwritten, metrics.untracked};
+}
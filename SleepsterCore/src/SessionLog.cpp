@@ -0,0 +1,655 @@
+//
+//  SessionLog.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/SessionLog.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+namespace sleepster {
+
+using namespace sessionlog;
+
+namespace {
+
+/// Payload bytes before the strings: kind, flags, volume, id and the four
+/// times. A tombstone is the first 24 of them.
+constexpr std::size_t kFixedPayload = 56;
+/// Kind, time, duration and peak level of a sound event. Sessions without
+/// events end after their strings, as they did before events were kept.
+constexpr std::size_t kSoundEventSize = 17;
+constexpr std::size_t kTombstonePayload = 24;
+constexpr uint8_t kHasBackground = 1;
+constexpr uint8_t kEffectsEnabled = 2;
+constexpr std::size_t kMaxString = 0xFFFF;
+
+// MARK: - Bytes
+
+uint32_t readU32(const uint8_t* p) noexcept {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint64_t readU64(const uint8_t* p) noexcept {
+    return static_cast<uint64_t>(readU32(p)) | (static_cast<uint64_t>(readU32(p + 4)) << 32);
+}
+
+float readF32(const uint8_t* p) noexcept {
+    const uint32_t bits = readU32(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+double readF64(const uint8_t* p) noexcept {
+    const uint64_t bits = readU64(p);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void putU16(uint8_t* p, uint16_t v) noexcept {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+void putU32(uint8_t* p, uint32_t v) noexcept {
+    for (int i = 0; i < 4; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+void putU64(uint8_t* p, uint64_t v) noexcept {
+    putU32(p, static_cast<uint32_t>(v));
+    putU32(p + 4, static_cast<uint32_t>(v >> 32));
+}
+
+void putF32(uint8_t* p, float v) noexcept {
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    putU32(p, bits);
+}
+
+void putF64(uint8_t* p, double v) noexcept {
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    putU64(p, bits);
+}
+
+/// Appends a u16 length and the bytes.
+bool putString(std::vector<uint8_t>& out, const std::string& value) {
+    if (value.size() > kMaxString) return false;
+    const std::size_t at = out.size();
+    out.resize(at + 2 + value.size());
+    putU16(out.data() + at, static_cast<uint16_t>(value.size()));
+    std::memcpy(out.data() + at + 2, value.data(), value.size());
+    return true;
+}
+
+bool putStrings(std::vector<uint8_t>& out, const std::vector<std::string>& values) {
+    if (values.size() > kMaxString) return false;
+    const std::size_t at = out.size();
+    out.resize(at + 2);
+    putU16(out.data() + at, static_cast<uint16_t>(values.size()));
+    for (const std::string& value : values) {
+        if (!putString(out, value)) return false;
+    }
+    return true;
+}
+
+/// Reads length-prefixed strings out of a payload, failing past its end.
+class Reader {
+public:
+    Reader(const uint8_t* data, std::size_t length) : data_(data), length_(length) {}
+
+    bool count(std::size_t& out) {
+        if (length_ - at_ < 2) return false;
+        out = static_cast<std::size_t>(data_[at_] | (data_[at_ + 1] << 8));
+        at_ += 2;
+        return true;
+    }
+
+    bool string(std::string& out) {
+        std::size_t size;
+        if (!count(size) || length_ - at_ < size) return false;
+        out.assign(reinterpret_cast<const char*>(data_ + at_), size);
+        at_ += size;
+        return true;
+    }
+
+    bool strings(std::vector<std::string>& out) {
+        std::size_t size;
+        if (!count(size)) return false;
+        out.resize(size);
+        for (std::string& value : out) {
+            if (!string(value)) return false;
+        }
+        return true;
+    }
+
+    /// Points `out` at the next `size` bytes.
+    bool bytes(const uint8_t*& out, std::size_t size) {
+        if (length_ - at_ < size) return false;
+        out = data_ + at_;
+        at_ += size;
+        return true;
+    }
+
+    void skip(std::size_t bytes) { at_ += bytes; }
+    bool atEnd() const { return at_ == length_; }
+
+private:
+    const uint8_t* data_;
+    std::size_t length_;
+    std::size_t at_ = 0;
+};
+
+struct CrcTable {
+    uint32_t values[256];
+};
+
+constexpr CrcTable makeCrcTable() {
+    CrcTable table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        table.values[i] = c;
+    }
+    return table;
+}
+
+constexpr CrcTable kCrcTable = makeCrcTable();
+
+// MARK: - Files
+
+uint64_t newGeneration() {
+    std::random_device device;
+    const auto time = static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+    return ((static_cast<uint64_t>(device()) << 32) | device()) ^ time;
+}
+
+void writeHeader(uint8_t* out, const char* magic, uint64_t generation) {
+    std::memcpy(out, magic, 4);
+    putU32(out + 4, kVersion);
+    putU64(out + 8, generation);
+}
+
+bool writeAll(int fd, const uint8_t* data, std::size_t size, uint64_t offset) {
+    while (size > 0) {
+        const ssize_t written = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+        if (written <= 0) return false;
+        data += written;
+        size -= static_cast<std::size_t>(written);
+        offset += static_cast<uint64_t>(written);
+    }
+    return true;
+}
+
+bool readAll(int fd, uint8_t* data, std::size_t size, uint64_t offset) {
+    while (size > 0) {
+        const ssize_t got = ::pread(fd, data, size, static_cast<off_t>(offset));
+        if (got <= 0) return false;
+        data += got;
+        size -= static_cast<std::size_t>(got);
+        offset += static_cast<uint64_t>(got);
+    }
+    return true;
+}
+
+uint64_t fileSize(int fd) {
+    struct stat info {};
+    return fstat(fd, &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+}
+
+/// Writes `bytes` to a new file at `path` and syncs it.
+bool writeFile(const std::string& path, const std::vector<uint8_t>& bytes) {
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    const bool ok = writeAll(fd, bytes.data(), bytes.size(), 0) && ::fsync(fd) == 0;
+    return ::close(fd) == 0 && ok;
+}
+
+/// Makes renames inside the directory of `path` durable.
+void syncDirectory(const std::string& path) {
+    const std::size_t slash = path.find_last_of('/');
+    const std::string directory = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+    const int fd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    ::fsync(fd);
+    ::close(fd);
+}
+
+void encodeEntry(uint8_t* out, uint64_t offset, uint32_t length, RecordKind kind, const SessionId& id,
+                 double startTime, double endTime) {
+    std::memset(out, 0, kEntrySize);
+    putU64(out, offset);
+    putU32(out + 8, length);
+    out[12] = static_cast<uint8_t>(kind);
+    std::memcpy(out + 16, id.data(), id.size());
+    putF64(out + 32, startTime);
+    putF64(out + 40, endTime);
+}
+
+} // namespace
+
+// MARK: - Codec
+
+uint32_t crc32(const uint8_t* data, std::size_t length) noexcept {
+    uint32_t c = 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < length; ++i) c = kCrcTable.values[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+bool encodeSession(const SleepSessionRecord& session, std::vector<uint8_t>& out) {
+    const std::size_t start = out.size();
+    out.resize(start + kFixedPayload);
+    uint8_t* fixed = out.data() + start;
+    fixed[0] = static_cast<uint8_t>(RecordKind::Session);
+    fixed[1] = static_cast<uint8_t>((session.hasBackground ? kHasBackground : 0) |
+                                    (session.effectsEnabled ? kEffectsEnabled : 0));
+    putU16(fixed + 2, 0);
+    putF32(fixed + 4, session.masterVolume);
+    std::memcpy(fixed + 8, session.id.data(), session.id.size());
+    putF64(fixed + 24, session.startTime);
+    putF64(fixed + 32, session.endTime);
+    putF64(fixed + 40, session.expectedDuration);
+    putF64(fixed + 48, session.actualDuration);
+    const bool ok = putStrings(out, session.soundsUsed) && putString(out, session.backgroundUsed) &&
+                    putStrings(out, session.activeSounds) && putString(out, session.equalizerPreset) &&
+                    session.soundEvents.size() <= kMaxString;
+    if (!ok) {
+        out.resize(start);
+        return false;
+    }
+    if (!session.soundEvents.empty()) {
+        std::size_t at = out.size();
+        out.resize(at + 2 + session.soundEvents.size() * kSoundEventSize);
+        putU16(out.data() + at, static_cast<uint16_t>(session.soundEvents.size()));
+        at += 2;
+        for (const SoundEvent& event : session.soundEvents) {
+            uint8_t* p = out.data() + at;
+            p[0] = static_cast<uint8_t>(event.kind);
+            putF64(p + 1, event.time);
+            putF32(p + 9, event.duration);
+            putF32(p + 13, event.peakLevel);
+            at += kSoundEventSize;
+        }
+    }
+    return true;
+}
+
+bool decodeSession(const uint8_t* payload, std::size_t length, SleepSessionRecord& out) {
+    if (length < kFixedPayload || payload[0] != static_cast<uint8_t>(RecordKind::Session)) return false;
+    out.hasBackground = (payload[1] & kHasBackground) != 0;
+    out.effectsEnabled = (payload[1] & kEffectsEnabled) != 0;
+    out.masterVolume = readF32(payload + 4);
+    std::memcpy(out.id.data(), payload + 8, out.id.size());
+    out.startTime = readF64(payload + 24);
+    out.endTime = readF64(payload + 32);
+    out.expectedDuration = readF64(payload + 40);
+    out.actualDuration = readF64(payload + 48);
+    Reader reader(payload, length);
+    reader.skip(kFixedPayload);
+    out.soundEvents.clear();
+    if (!reader.strings(out.soundsUsed) || !reader.string(out.backgroundUsed) || !reader.strings(out.activeSounds) ||
+        !reader.string(out.equalizerPreset)) {
+        return false;
+    }
+    if (reader.atEnd()) return true;
+
+    std::size_t count;
+    const uint8_t* p;
+    if (!reader.count(count) || count == 0 || !reader.bytes(p, count * kSoundEventSize)) return false;
+    out.soundEvents.resize(count);
+    for (SoundEvent& event : out.soundEvents) {
+        event.kind = static_cast<SoundEventKind>(p[0]);
+        event.time = readF64(p + 1);
+        event.duration = readF32(p + 9);
+        event.peakLevel = readF32(p + 13);
+        p += kSoundEventSize;
+    }
+    return reader.atEnd();
+}
+
+// MARK: - Opening
+
+std::size_t SessionLog::IdHash::operator()(const SessionId& id) const noexcept {
+    return static_cast<std::size_t>(readU64(id.data()) ^ (readU64(id.data() + 8) * 0x9E3779B97F4A7C15ull));
+}
+
+SessionLog::SessionLog(std::string path, const SessionLogOptions& options)
+    : path_(std::move(path)), indexPath_(path_ + ".idx"), options_(options) {}
+
+SessionLog::~SessionLog() {
+    closeFiles();
+}
+
+void SessionLog::closeFiles() noexcept {
+    if (logFd_ >= 0) ::close(logFd_);
+    if (indexFd_ >= 0) ::close(indexFd_);
+    logFd_ = -1;
+    indexFd_ = -1;
+    map_.close();
+}
+
+std::unique_ptr<SessionLog> SessionLog::open(const std::string& path, const SessionLogOptions& options) {
+    std::unique_ptr<SessionLog> log(new SessionLog(path, options));
+    if (!log->load()) return nullptr;
+    return log;
+}
+
+bool SessionLog::load() {
+    logFd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    indexFd_ = ::open(indexPath_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (logFd_ < 0 || indexFd_ < 0) return false;
+
+    logBytes_ = fileSize(logFd_);
+    if (logBytes_ < kHeaderSize) {
+        // New, or interrupted while being created.
+        return createFiles();
+    }
+    uint8_t header[kHeaderSize];
+    if (!readAll(logFd_, header, kHeaderSize, 0) || std::memcmp(header, kLogMagic, 4) != 0 ||
+        readU32(header + 4) != kVersion) {
+        return false;
+    }
+    generation_ = readU64(header + 8);
+    loadIndex();
+    scanLogTail();
+    return true;
+}
+
+bool SessionLog::createFiles() {
+    generation_ = newGeneration();
+    uint8_t header[kHeaderSize];
+    writeHeader(header, kLogMagic, generation_);
+    if (::ftruncate(logFd_, 0) != 0 || !writeAll(logFd_, header, kHeaderSize, 0) || ::fsync(logFd_) != 0) {
+        return false;
+    }
+    writeHeader(header, kIndexMagic, generation_);
+    if (::ftruncate(indexFd_, 0) != 0 || !writeAll(indexFd_, header, kHeaderSize, 0)) return false;
+    logBytes_ = kHeaderSize;
+    return true;
+}
+
+void SessionLog::loadIndex() {
+    std::vector<uint8_t> bytes(fileSize(indexFd_));
+    const bool readable = bytes.size() >= kHeaderSize && readAll(indexFd_, bytes.data(), bytes.size(), 0) &&
+                          std::memcmp(bytes.data(), kIndexMagic, 4) == 0 && readU32(bytes.data() + 4) == kVersion &&
+                          readU64(bytes.data() + 8) == generation_;
+    if (!readable) {
+        // Missing, damaged or left from before a compaction: rebuilt from
+        // the log by scanLogTail.
+        uint8_t header[kHeaderSize];
+        writeHeader(header, kIndexMagic, generation_);
+        if (::ftruncate(indexFd_, 0) == 0) writeAll(indexFd_, header, kHeaderSize, 0);
+        return;
+    }
+
+    // Entries must tile the log from its header onwards; the first that
+    // does not, and everything after it, is dropped.
+    const std::size_t count = (bytes.size() - kHeaderSize) / kEntrySize;
+    entries_.reserve(count + 16);
+    uint64_t expected = kHeaderSize;
+    for (std::size_t i = 0; i < count; ++i) {
+        const uint8_t* p = bytes.data() + kHeaderSize + i * kEntrySize;
+        Entry entry{};
+        entry.offset = readU64(p);
+        entry.length = readU32(p + 8);
+        entry.kind = static_cast<RecordKind>(p[12]);
+        std::memcpy(entry.id.data(), p + 16, entry.id.size());
+        entry.startTime = readF64(p + 32);
+        entry.endTime = readF64(p + 40);
+        const bool knownKind = entry.kind == RecordKind::Session || entry.kind == RecordKind::Tombstone;
+        if (!knownKind || entry.offset != expected || entry.offset + kRecordHeaderSize + entry.length > logBytes_) {
+            break;
+        }
+        addEntry(entry);
+        expected += kRecordHeaderSize + entry.length;
+    }
+
+    // Without a sync per append the index can outlive the record it names,
+    // so the last record is checked against its CRC.
+    if (!entries_.empty()) {
+        const Entry& last = entries_.back();
+        std::vector<uint8_t> record(kRecordHeaderSize + last.length);
+        const bool intact = readAll(logFd_, record.data(), record.size(), last.offset) &&
+                            readU32(record.data()) == last.length &&
+                            readU32(record.data() + 4) == crc32(record.data() + kRecordHeaderSize, last.length);
+        if (!intact) {
+            // Re-adding the rest rebuilds the live set without it.
+            std::vector<Entry> kept(entries_.begin(), entries_.end() - 1);
+            entries_.clear();
+            latest_.clear();
+            deadBytes_ = 0;
+            for (const Entry& entry : kept) addEntry(entry);
+        }
+    }
+    if (::ftruncate(indexFd_, static_cast<off_t>(kHeaderSize + entries_.size() * kEntrySize)) != 0) {
+        // A stale tail is harmless: entries are overwritten in place.
+    }
+}
+
+void SessionLog::scanLogTail() {
+    uint64_t offset = entries_.empty() ? kHeaderSize : entries_.back().offset + kRecordHeaderSize + entries_.back().length;
+    std::vector<uint8_t> payload;
+    while (offset + kRecordHeaderSize <= logBytes_) {
+        uint8_t header[kRecordHeaderSize];
+        if (!readAll(logFd_, header, kRecordHeaderSize, offset)) break;
+        const uint32_t length = readU32(header);
+        if (length < kTombstonePayload || offset + kRecordHeaderSize + length > logBytes_) break;
+        payload.resize(length);
+        if (!readAll(logFd_, payload.data(), length, offset + kRecordHeaderSize) ||
+            readU32(header + 4) != crc32(payload.data(), length)) {
+            break;
+        }
+        Entry entry{};
+        entry.offset = offset;
+        entry.length = length;
+        entry.kind = static_cast<RecordKind>(payload[0]);
+        std::memcpy(entry.id.data(), payload.data() + 8, entry.id.size());
+        if (entry.kind == RecordKind::Session && length >= kFixedPayload) {
+            entry.startTime = readF64(payload.data() + 24);
+            entry.endTime = readF64(payload.data() + 32);
+        } else if (entry.kind != RecordKind::Tombstone) {
+            break;
+        }
+        addEntry(entry);
+        uint8_t encoded[kEntrySize];
+        encodeEntry(encoded, entry.offset, entry.length, entry.kind, entry.id, entry.startTime, entry.endTime);
+        writeAll(indexFd_, encoded, kEntrySize, kHeaderSize + (entries_.size() - 1) * kEntrySize);
+        offset += kRecordHeaderSize + length;
+    }
+    if (offset < logBytes_) {
+        // A torn append: the record never completed, so it never happened.
+        if (::ftruncate(logFd_, static_cast<off_t>(offset)) == 0) {
+            ::fsync(logFd_);
+            logBytes_ = offset;
+        }
+    }
+}
+
+void SessionLog::addEntry(const Entry& added) {
+    const auto index = static_cast<uint32_t>(entries_.size());
+    entries_.push_back(added);
+    Entry& entry = entries_.back();
+    const auto previous = latest_.find(entry.id);
+    if (previous != latest_.end()) {
+        Entry& superseded = entries_[previous->second];
+        superseded.live = false;
+        deadBytes_ += kRecordHeaderSize + superseded.length;
+    }
+    if (entry.kind == RecordKind::Session) {
+        entry.live = true;
+        latest_[entry.id] = index;
+    } else {
+        entry.live = false;
+        deadBytes_ += kRecordHeaderSize + entry.length;
+        if (previous != latest_.end()) latest_.erase(previous);
+    }
+    liveStale_ = true;
+}
+
+// MARK: - Writing
+
+bool SessionLog::appendRecord(RecordKind kind, const SessionId& id, double startTime, double endTime) {
+    // scratch_ holds the record header's space followed by the payload.
+    const auto length = static_cast<uint32_t>(scratch_.size() - kRecordHeaderSize);
+    putU32(scratch_.data(), length);
+    putU32(scratch_.data() + 4, crc32(scratch_.data() + kRecordHeaderSize, length));
+    if (!writeAll(logFd_, scratch_.data(), scratch_.size(), logBytes_) ||
+        (options_.syncEachAppend && ::fsync(logFd_) != 0)) {
+        if (::ftruncate(logFd_, static_cast<off_t>(logBytes_)) != 0) {
+            // The partial record fails its CRC and is cut off on the next
+            // open instead.
+        }
+        return false;
+    }
+
+    Entry entry{};
+    entry.offset = logBytes_;
+    entry.length = length;
+    entry.kind = kind;
+    entry.id = id;
+    entry.startTime = startTime;
+    entry.endTime = endTime;
+    addEntry(entry);
+    logBytes_ += scratch_.size();
+
+    // An index write that fails is repaired by the next open.
+    uint8_t encoded[kEntrySize];
+    encodeEntry(encoded, entry.offset, entry.length, kind, id, startTime, endTime);
+    writeAll(indexFd_, encoded, kEntrySize, kHeaderSize + (entries_.size() - 1) * kEntrySize);
+    return true;
+}
+
+bool SessionLog::append(const SleepSessionRecord& session) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    scratch_.assign(kRecordHeaderSize, 0);
+    if (!encodeSession(session, scratch_)) return false;
+    return appendRecord(RecordKind::Session, session.id, session.startTime, session.endTime);
+}
+
+bool SessionLog::remove(const SessionId& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (latest_.find(id) == latest_.end()) return false;
+    scratch_.assign(kRecordHeaderSize + kTombstonePayload, 0);
+    scratch_[kRecordHeaderSize] = static_cast<uint8_t>(RecordKind::Tombstone);
+    std::memcpy(scratch_.data() + kRecordHeaderSize + 8, id.data(), id.size());
+    return appendRecord(RecordKind::Tombstone, id, 0.0, 0.0);
+}
+
+// MARK: - Reading
+
+void SessionLog::rebuildLive() const {
+    if (!liveStale_) return;
+    live_.clear();
+    live_.reserve(latest_.size());
+    for (std::size_t i = 0; i < entries_.size(); ++i) {
+        if (entries_[i].live) live_.push_back(static_cast<uint32_t>(i));
+    }
+    liveStale_ = false;
+}
+
+bool SessionLog::ensureMapped(uint64_t end) const {
+    if (map_.size() >= end) return true;
+    // Appends went past the mapping; map the file again at its new size.
+    return map_.open(path_) && map_.size() >= end;
+}
+
+bool SessionLog::decode(const Entry& entry, SleepSessionRecord& out) const {
+    if (!ensureMapped(entry.offset + kRecordHeaderSize + entry.length)) return false;
+    return decodeSession(map_.data() + entry.offset + kRecordHeaderSize, entry.length, out);
+}
+
+std::size_t SessionLog::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return latest_.size();
+}
+
+bool SessionLog::read(std::size_t index, SleepSessionRecord& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rebuildLive();
+    if (index >= live_.size()) return false;
+    return decode(entries_[live_[index]], out);
+}
+
+bool SessionLog::find(const SessionId& id, SleepSessionRecord& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = latest_.find(id);
+    return it != latest_.end() && decode(entries_[it->second], out);
+}
+
+std::size_t SessionLog::fileBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<std::size_t>(logBytes_);
+}
+
+std::size_t SessionLog::deadBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<std::size_t>(deadBytes_);
+}
+
+std::size_t SessionLog::recordCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+// MARK: - Compaction
+
+bool SessionLog::needsCompaction() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return deadBytes_ >= options_.compactMinimumBytes &&
+           static_cast<double>(deadBytes_) >= options_.compactDeadFraction * static_cast<double>(logBytes_);
+}
+
+bool SessionLog::compact() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rebuildLive();
+    if (!ensureMapped(logBytes_)) return false;
+
+    uint64_t generation = newGeneration();
+    if (generation == generation_) ++generation;
+    std::vector<uint8_t> log(kHeaderSize);
+    std::vector<uint8_t> index(kHeaderSize + live_.size() * kEntrySize);
+    writeHeader(log.data(), kLogMagic, generation);
+    writeHeader(index.data(), kIndexMagic, generation);
+    log.reserve(static_cast<std::size_t>(logBytes_ - deadBytes_));
+    for (std::size_t i = 0; i < live_.size(); ++i) {
+        const Entry& entry = entries_[live_[i]];
+        const uint8_t* record = map_.data() + entry.offset;
+        encodeEntry(index.data() + kHeaderSize + i * kEntrySize, log.size(), entry.length, entry.kind, entry.id,
+                    entry.startTime, entry.endTime);
+        log.insert(log.end(), record, record + kRecordHeaderSize + entry.length);
+    }
+
+    const std::string logTemporary = path_ + ".compact";
+    const std::string indexTemporary = indexPath_ + ".compact";
+    if (!writeFile(logTemporary, log) || !writeFile(indexTemporary, index) ||
+        std::rename(logTemporary.c_str(), path_.c_str()) != 0) {
+        std::remove(logTemporary.c_str());
+        std::remove(indexTemporary.c_str());
+        return false;
+    }
+    // From here the new log is the log. If the index rename fails, the old
+    // index no longer matches its generation and is rebuilt from the log.
+    std::rename(indexTemporary.c_str(), indexPath_.c_str());
+    syncDirectory(path_);
+
+    closeFiles();
+    entries_.clear();
+    latest_.clear();
+    live_.clear();
+    liveStale_ = true;
+    deadBytes_ = 0;
+    return load();
+}
+
+} // namespace sleepster
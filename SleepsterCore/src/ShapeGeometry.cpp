@@ -0,0 +1,300 @@
+//
+//  ShapeGeometry.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/ShapeGeometry.hpp"
+
+#include "sleepster/Simd.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace sleepster {
+
+namespace {
+
+/// Distance of a cubic's control points from the ends for a quarter circle.
+constexpr float kKappa = 0.5522847498f;
+
+// MARK: - Shapes
+//
+// Each builder follows the SwiftUI shape it replaces element for element,
+// with the rect's centre at the origin and its smaller side as the unit.
+
+void flowerOfLife(ShapePath& path) {
+    const float radius = 1.0f / 6.0f;
+    const auto& circle = kUnitCircle<6>;
+    path.addEllipse(-radius, -radius, radius * 2.0f, radius * 2.0f);
+    for (int i = 0; i < 6; ++i) {
+        const float cx = circle.cos[i] * radius;
+        const float cy = circle.sin[i] * radius;
+        path.addEllipse(cx - radius, cy - radius, radius * 2.0f, radius * 2.0f);
+    }
+}
+
+void metatronsCube(ShapePath& path) {
+    const float radius = 1.0f / 3.0f;
+    const auto& circle = kUnitCircle<6>;
+    for (int i = 0; i < 6; ++i) {
+        for (int j = i + 1; j < 6; ++j) {
+            path.moveTo(circle.cos[i] * radius, circle.sin[i] * radius);
+            path.lineTo(circle.cos[j] * radius, circle.sin[j] * radius);
+        }
+    }
+    for (int i = 0; i < 6; ++i) {
+        path.moveTo(0.0f, 0.0f);
+        path.lineTo(circle.cos[i] * radius, circle.sin[i] * radius);
+    }
+}
+
+void triquetra(ShapePath& path) {
+    const float radius = 1.0f / 3.0f;
+    const auto& circle = kUnitCircle<3>;
+    for (int i = 0; i < 3; ++i) {
+        const float cx = circle.cos[i] * radius * 0.5f;
+        const float cy = circle.sin[i] * radius * 0.5f;
+        path.addEllipse(cx - radius, cy - radius, radius * 2.0f, radius * 2.0f);
+    }
+}
+
+void sriYantra(ShapePath& path) {
+    // Triangles turn in steps of 15 degrees, a 24th of a turn.
+    const auto& circle = kUnitCircle<24>;
+    for (int i = 0; i < 4; ++i) {
+        const float radius = 0.5f * (1.0f - static_cast<float>(i) * 0.2f) / 2.0f;
+        for (int flip = 0; flip < 2; ++flip) {
+            const int rotation = i + flip * 12;
+            for (int k = 0; k < 3; ++k) {
+                const int step = (k * 8 + rotation) % 24;
+                const float px = circle.cos[step] * radius;
+                const float py = circle.sin[step] * radius;
+                if (k == 0) {
+                    path.moveTo(px, py);
+                } else {
+                    path.lineTo(px, py);
+                }
+            }
+            path.close();
+        }
+    }
+}
+
+void vesicaPiscis(ShapePath& path) {
+    const float radius = 1.0f / 3.0f;
+    const float offset = radius * 0.6f;
+    path.addEllipse(-offset - radius, -radius, radius * 2.0f, radius * 2.0f);
+    path.addEllipse(offset - radius, -radius, radius * 2.0f, radius * 2.0f);
+}
+
+void enneagram(ShapePath& path) {
+    // Points start at the top: cos(a - pi/2) = sin a, sin(a - pi/2) = -cos a.
+    const float radius = 0.5f;
+    const auto& circle = kUnitCircle<9>;
+    for (int i = 0; i < 9; ++i) {
+        const int end = (i + 4) % 9;
+        path.moveTo(circle.sin[i] * radius, -circle.cos[i] * radius);
+        path.lineTo(circle.sin[end] * radius, -circle.cos[end] * radius);
+    }
+}
+
+template <int Points>
+void mandalaRing(ShapePath& path, int ring) {
+    const float radius = 0.5f * static_cast<float>(ring) / 5.0f;
+    const auto& circle = kUnitCircle<Points>;
+    for (int i = 0; i < Points; ++i) {
+        const float px = circle.cos[i] * radius;
+        const float py = circle.sin[i] * radius;
+        if (i == 0) {
+            path.moveTo(px, py);
+        } else {
+            path.lineTo(px, py);
+        }
+        // Inner rings have spokes, which also restart the ring's outline.
+        if (ring <= 2) {
+            path.moveTo(0.0f, 0.0f);
+            path.lineTo(px, py);
+        }
+    }
+    path.close();
+}
+
+void sacredMandala(ShapePath& path) {
+    mandalaRing<8>(path, 1);
+    mandalaRing<16>(path, 2);
+    mandalaRing<24>(path, 3);
+    mandalaRing<32>(path, 4);
+    mandalaRing<40>(path, 5);
+}
+
+void droopyEar(ShapePath& path, float cx, float cy, float width, float height) {
+    path.moveTo(cx, cy - height / 2.0f);
+    path.quadTo(cx + width / 2.0f, cy - height / 2.0f, cx + width / 2.0f, cy - height / 4.0f);
+    path.quadTo(cx + width / 2.0f, cy + height / 4.0f, cx + width / 3.0f, cy + height / 2.0f);
+    path.quadTo(cx, cy + height / 2.0f, cx - width / 3.0f, cy + height / 2.0f);
+    path.quadTo(cx - width / 2.0f, cy + height / 4.0f, cx - width / 2.0f, cy - height / 4.0f);
+    path.quadTo(cx - width / 2.0f, cy - height / 2.0f, cx, cy - height / 2.0f);
+}
+
+/// EnhancedSheepShape, in its own units of a 60th of the smaller side.
+void sheep(ShapePath& path) {
+    const float bodyX = -2.0f;
+    const float bodyY = 2.0f;
+    const float bodyWidth = 30.0f;
+    const float bodyHeight = 16.0f;
+    path.addEllipse(bodyX - bodyWidth / 2.0f, bodyY - bodyHeight / 2.0f, bodyWidth, bodyHeight);
+
+    const float top = bodyY - bodyHeight / 2.0f;
+    const float bottom = bodyY + bodyHeight / 2.0f;
+    const float left = bodyX - bodyWidth / 2.0f;
+    const float right = bodyX + bodyWidth / 2.0f;
+    const std::array<std::array<float, 4>, 12> scallops{{
+        {bodyX - 12.0f, top - 2.0f, 5.0f, 5.0f},
+        {bodyX - 5.0f, top - 2.5f, 4.5f, 4.5f},
+        {bodyX + 2.0f, top - 2.0f, 4.0f, 4.0f},
+        {bodyX + 8.0f, top - 1.5f, 3.5f, 3.5f},
+        {left - 2.0f, bodyY - 5.0f, 4.0f, 4.0f},
+        {left - 1.5f, bodyY, 3.5f, 4.0f},
+        {left - 2.0f, bodyY + 4.0f, 4.0f, 3.5f},
+        {right - 2.0f, bodyY - 3.0f, 3.5f, 4.0f},
+        {right - 1.5f, bodyY + 2.0f, 4.0f, 3.5f},
+        {bodyX - 6.0f, bottom - 1.5f, 4.0f, 3.0f},
+        {bodyX + 1.0f, bottom - 2.0f, 3.5f, 3.5f},
+        {bodyX + 7.0f, bottom - 1.0f, 3.0f, 3.0f},
+    }};
+    for (const auto& s : scallops) path.addEllipse(s[0], s[1], s[2], s[3]);
+
+    const float faceX = 12.0f;
+    const float faceY = -2.0f;
+    path.addEllipse(faceX - 5.0f, faceY - 6.0f, 10.0f, 12.0f);
+
+    droopyEar(path, faceX - 3.0f, faceY - 4.0f, 2.5f, 5.0f);
+    droopyEar(path, faceX + 3.0f, faceY - 4.0f, 2.5f, 5.0f);
+
+    const float eyeWidth = 1.5f;
+    const float eyeHeight = 1.2f;
+    path.addEllipse(faceX - 2.5f - eyeWidth / 2.0f, faceY - 1.0f - eyeHeight / 2.0f, eyeWidth, eyeHeight);
+    path.addEllipse(faceX + 1.5f - eyeWidth / 2.0f, faceY - 1.0f - eyeHeight / 2.0f, eyeWidth, eyeHeight);
+
+    const float nose = 0.8f;
+    path.addEllipse(faceX - nose / 2.0f, faceY + 1.5f - nose / 2.0f, nose, nose * 0.7f);
+
+    const float legWidth = 2.0f;
+    const float legHeight = 8.0f;
+    const float hoofWidth = 2.5f;
+    const float hoofHeight = 1.5f;
+    for (float legX : {-8.0f, -3.0f, 3.0f, 8.0f}) {
+        const float legTop = bodyY + 8.0f;
+        path.addRect(bodyX + legX - legWidth / 2.0f, legTop, legWidth, legHeight);
+        path.addEllipse(bodyX + legX - hoofWidth / 2.0f, legTop + legHeight - hoofHeight / 2.0f,
+                        hoofWidth, hoofHeight);
+    }
+}
+
+ShapePath build(ShapeKind kind) {
+    ShapePath path;
+    switch (kind) {
+    case ShapeKind::FlowerOfLife: flowerOfLife(path); break;
+    case ShapeKind::MetatronsCube: metatronsCube(path); break;
+    case ShapeKind::Triquetra: triquetra(path); break;
+    case ShapeKind::SriYantra: sriYantra(path); break;
+    case ShapeKind::VesicaPiscis: vesicaPiscis(path); break;
+    case ShapeKind::Enneagram: enneagram(path); break;
+    case ShapeKind::SacredMandala: sacredMandala(path); break;
+    case ShapeKind::Sheep:
+        sheep(path);
+        path.scaleBy(1.0f / 60.0f);
+        break;
+    }
+    return path;
+}
+
+} // namespace
+
+// MARK: - ShapePath
+
+void ShapePath::moveTo(float x, float y) {
+    verbs_.push_back(PathVerb::Move);
+    push(x, y);
+}
+
+void ShapePath::lineTo(float x, float y) {
+    verbs_.push_back(PathVerb::Line);
+    push(x, y);
+}
+
+void ShapePath::quadTo(float cx, float cy, float x, float y) {
+    verbs_.push_back(PathVerb::Quad);
+    push(cx, cy);
+    push(x, y);
+}
+
+void ShapePath::cubicTo(float c1x, float c1y, float c2x, float c2y, float x, float y) {
+    verbs_.push_back(PathVerb::Cubic);
+    push(c1x, c1y);
+    push(c2x, c2y);
+    push(x, y);
+}
+
+void ShapePath::close() {
+    verbs_.push_back(PathVerb::Close);
+}
+
+void ShapePath::addEllipse(float x, float y, float width, float height) {
+    const float rx = width / 2.0f;
+    const float ry = height / 2.0f;
+    const float cx = x + rx;
+    const float cy = y + ry;
+    const float kx = rx * kKappa;
+    const float ky = ry * kKappa;
+    moveTo(cx + rx, cy);
+    cubicTo(cx + rx, cy + ky, cx + kx, cy + ry, cx, cy + ry);
+    cubicTo(cx - kx, cy + ry, cx - rx, cy + ky, cx - rx, cy);
+    cubicTo(cx - rx, cy - ky, cx - kx, cy - ry, cx, cy - ry);
+    cubicTo(cx + kx, cy - ry, cx + rx, cy - ky, cx + rx, cy);
+    close();
+}
+
+void ShapePath::scaleBy(float factor) noexcept {
+    for (float& value : points_) value *= factor;
+}
+
+void ShapePath::addRect(float x, float y, float width, float height) {
+    moveTo(x, y);
+    lineTo(x + width, y);
+    lineTo(x + width, y + height);
+    lineTo(x, y + height);
+    close();
+}
+
+// MARK: - Cache
+
+const ShapePath& unitShape(ShapeKind kind) {
+    static const std::array<ShapePath, kShapeKindCount> shapes = [] {
+        std::array<ShapePath, kShapeKindCount> built;
+        for (int k = 0; k < kShapeKindCount; ++k) built[k] = build(static_cast<ShapeKind>(k));
+        return built;
+    }();
+    return shapes[static_cast<std::size_t>(kind)];
+}
+
+void placeShape(const ShapePath& unit, float x, float y, float width, float height, float* out) noexcept {
+    const float scale = std::min(width, height);
+    const float cx = x + width / 2.0f;
+    const float cy = y + height / 2.0f;
+    const float* in = unit.points().data();
+    const std::size_t count = unit.points().size();
+
+    const simd::f32x4 s = simd::splat(scale);
+    const simd::f32x4 offset = simd::set(cx, cy, cx, cy);
+    std::size_t i = 0;
+    for (; i + simd::kWidth <= count; i += simd::kWidth) {
+        simd::store(out + i, simd::madd(offset, simd::load(in + i), s));
+    }
+    for (; i < count; i += 2) {
+        out[i] = cx + in[i] * scale;
+        out[i + 1] = cy + in[i + 1] * scale;
+    }
+}
+
+} // namespace sleepster
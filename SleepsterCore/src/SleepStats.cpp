@@ -0,0 +1,302 @@
+//
+//  SleepStats.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/SleepStats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace sleepster {
+
+namespace {
+
+constexpr double kDaySeconds = 86400.0;
+constexpr double kTwoPi = 6.283185307179586;
+/// Nights the tree may span, about 360 years; a sample further out is
+/// treated as garbage rather than allowed to grow the tree without bound.
+constexpr std::size_t kMaxNights = std::size_t{1} << 17;
+
+int64_t floorDiv(int64_t value, int64_t divisor) noexcept {
+    const int64_t quotient = value / divisor;
+    return quotient * divisor > value ? quotient - 1 : quotient;
+}
+
+double angleOf(double localTime) noexcept {
+    double seconds = std::fmod(localTime, kDaySeconds);
+    if (seconds < 0.0) seconds += kDaySeconds;
+    return seconds * (kTwoPi / kDaySeconds);
+}
+
+} // namespace
+
+// MARK: - Moments
+
+void RunningMoments::add(double value) noexcept {
+    ++count;
+    const double delta = value - mean;
+    mean += delta / static_cast<double>(count);
+    m2 += delta * (value - mean);
+}
+
+void RunningMoments::remove(double value) noexcept {
+    if (count <= 1) {
+        *this = {};
+        return;
+    }
+    --count;
+    const double delta = value - mean;
+    mean -= delta / static_cast<double>(count);
+    m2 = std::max(0.0, m2 - delta * (value - mean));
+}
+
+void RunningMoments::merge(const RunningMoments& other) noexcept {
+    if (other.count == 0) return;
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    const double n = static_cast<double>(count);
+    const double otherN = static_cast<double>(other.count);
+    const double combined = n + otherN;
+    const double delta = other.mean - mean;
+    mean += delta * otherN / combined;
+    m2 += other.m2 + delta * delta * n * otherN / combined;
+    count += other.count;
+}
+
+double RunningMoments::variance() const noexcept {
+    return count > 1 ? m2 / static_cast<double>(count) : 0.0;
+}
+
+double RunningMoments::deviation() const noexcept {
+    return std::sqrt(variance());
+}
+
+void CircularMoments::add(double radians) noexcept {
+    ++count;
+    sumCos += std::cos(radians);
+    sumSin += std::sin(radians);
+}
+
+void CircularMoments::remove(double radians) noexcept {
+    if (count <= 1) {
+        *this = {};
+        return;
+    }
+    --count;
+    sumCos -= std::cos(radians);
+    sumSin -= std::sin(radians);
+}
+
+void CircularMoments::merge(const CircularMoments& other) noexcept {
+    count += other.count;
+    sumCos += other.sumCos;
+    sumSin += other.sumSin;
+}
+
+double CircularMoments::meanAngle() const noexcept {
+    if (count == 0) return 0.0;
+    const double angle = std::atan2(sumSin, sumCos);
+    return angle < 0.0 ? angle + kTwoPi : angle;
+}
+
+double CircularMoments::resultantLength() const noexcept {
+    if (count == 0) return 0.0;
+    return std::min(1.0, std::hypot(sumCos, sumSin) / static_cast<double>(count));
+}
+
+double CircularMoments::deviation() const noexcept {
+    const double length = resultantLength();
+    if (length <= 0.0) return std::numeric_limits<double>::infinity();
+    return std::sqrt(-2.0 * std::log(length));
+}
+
+void SleepSummary::merge(const SleepSummary& other) noexcept {
+    asleep.merge(other.asleep);
+    inBed.merge(other.inBed);
+    bedtime.merge(other.bedtime);
+}
+
+double SleepSummary::efficiency() const noexcept {
+    if (asleep.count == 0 || inBed.count == 0) return 0.0;
+    const double inBedTotal = inBed.total();
+    return inBedTotal > 0.0 ? asleep.total() / inBedTotal * 100.0 : 0.0;
+}
+
+double SleepSummary::meanBedtime() const noexcept {
+    return bedtime.meanAngle() * (kDaySeconds / kTwoPi);
+}
+
+double SleepSummary::bedtimeDeviation() const noexcept {
+    return bedtime.deviation() * (kDaySeconds / kTwoPi);
+}
+
+double SleepSummary::bedtimeConsistency() const noexcept {
+    if (bedtime.count < 2) return 100.0;
+    const double hours = bedtimeDeviation() / 3600.0;
+    return std::max(0.0, 100.0 - hours * 10.0);
+}
+
+// MARK: - Calendar
+
+int64_t SleepStats::nightOf(double time, int32_t utcOffset) noexcept {
+    return static_cast<int64_t>(std::floor((time + utcOffset - kDaySeconds / 2.0) / kDaySeconds));
+}
+
+int64_t SleepStats::weekOf(int64_t night) noexcept {
+    // 1970-01-01 was a Thursday.
+    return floorDiv(night + 3, 7);
+}
+
+int64_t SleepStats::monthOf(int64_t night) noexcept {
+    // Civil date from a day count, after Howard Hinnant's civil_from_days.
+    const int64_t z = night + 719468;
+    const int64_t era = floorDiv(z, 146097);
+    const int64_t dayOfEra = z - era * 146097;
+    const int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const int64_t shiftedMonth = (5 * dayOfYear + 2) / 153;
+    const int64_t month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+    const int64_t year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+    return year * 12 + month - 1;
+}
+
+// MARK: - Samples
+
+std::size_t SleepStats::IdHash::operator()(const SleepSampleId& id) const noexcept {
+    uint64_t a = 0;
+    uint64_t b = 0;
+    for (int i = 0; i < 8; ++i) {
+        a = a << 8 | id[i];
+        b = b << 8 | id[i + 8];
+    }
+    return static_cast<std::size_t>(a ^ (b * 0x9E3779B97F4A7C15ull));
+}
+
+bool SleepStats::add(const SleepSample& sample) {
+    if (!std::isfinite(sample.startTime) || !std::isfinite(sample.endTime) || sample.endTime < sample.startTime) {
+        return false;
+    }
+    if (samples_.count(sample.id) != 0) return false;
+
+    const double localStart = sample.startTime + sample.utcOffset;
+    const Stored stored{nightOf(sample.startTime, sample.utcOffset), sample.endTime - sample.startTime,
+                        angleOf(localStart), sample.category};
+    if (leaves_ != 0) {
+        const int64_t low = std::min(base_, stored.night);
+        const int64_t high = std::max(base_ + static_cast<int64_t>(leaves_) - 1, stored.night);
+        if (static_cast<uint64_t>(high - low) >= kMaxNights) return false;
+    }
+
+    cover(stored.night);
+    samples_.emplace(sample.id, stored);
+    update(stored.night, stored, true);
+    return true;
+}
+
+bool SleepStats::remove(const SleepSampleId& id) {
+    const auto found = samples_.find(id);
+    if (found == samples_.end()) return false;
+    const Stored stored = found->second;
+    samples_.erase(found);
+    update(stored.night, stored, false);
+    return true;
+}
+
+void SleepStats::apply(SleepSummary& summary, const Stored& stored, bool adding) noexcept {
+    switch (stored.category) {
+    case SleepCategory::Asleep:
+        adding ? summary.asleep.add(stored.duration) : summary.asleep.remove(stored.duration);
+        break;
+    case SleepCategory::InBed:
+        adding ? summary.inBed.add(stored.duration) : summary.inBed.remove(stored.duration);
+        adding ? summary.bedtime.add(stored.angle) : summary.bedtime.remove(stored.angle);
+        break;
+    }
+}
+
+void SleepStats::update(int64_t night, const Stored& stored, bool adding) {
+    apply(total_, stored, adding);
+    apply(weeks_[weekOf(night)], stored, adding);
+    apply(months_[monthOf(night)], stored, adding);
+
+    // Removal undoes the leaf's moments exactly enough; its ancestors are
+    // merged again from their children rather than un-merged.
+    std::size_t node = leaves_ + static_cast<std::size_t>(night - base_);
+    apply(tree_[node], stored, adding);
+    for (node >>= 1; node >= 1; node >>= 1) {
+        tree_[node] = tree_[2 * node];
+        tree_[node].merge(tree_[2 * node + 1]);
+    }
+}
+
+// MARK: - Tree
+
+void SleepStats::cover(int64_t night) {
+    if (leaves_ == 0) {
+        leaves_ = 64;
+        base_ = night - static_cast<int64_t>(leaves_ / 2);
+        tree_.assign(2 * leaves_, SleepSummary{});
+        return;
+    }
+
+    int64_t base = base_;
+    std::size_t leaves = leaves_;
+    while (night < base || night >= base + static_cast<int64_t>(leaves)) {
+        // Grow toward the new night so history loaded newest first or
+        // oldest first both double the tree a logarithmic number of times.
+        if (night < base) base -= static_cast<int64_t>(leaves);
+        leaves *= 2;
+    }
+    if (leaves == leaves_) return;
+
+    std::vector<SleepSummary> tree(2 * leaves);
+    const std::size_t shift = static_cast<std::size_t>(base_ - base);
+    std::copy(tree_.begin() + static_cast<std::ptrdiff_t>(leaves_), tree_.end(),
+              tree.begin() + static_cast<std::ptrdiff_t>(leaves + shift));
+    for (std::size_t node = leaves - 1; node >= 1; --node) {
+        tree[node] = tree[2 * node];
+        tree[node].merge(tree[2 * node + 1]);
+    }
+    tree_ = std::move(tree);
+    base_ = base;
+    leaves_ = leaves;
+}
+
+SleepSummary SleepStats::range(int64_t first, int64_t last) const noexcept {
+    SleepSummary summary;
+    if (leaves_ == 0) return summary;
+    first = std::max(first, base_);
+    last = std::min(last, base_ + static_cast<int64_t>(leaves_) - 1);
+    if (first > last) return summary;
+
+    std::size_t low = leaves_ + static_cast<std::size_t>(first - base_);
+    std::size_t high = leaves_ + static_cast<std::size_t>(last - base_) + 1;
+    while (low < high) {
+        if (low & 1) summary.merge(tree_[low++]);
+        if (high & 1) summary.merge(tree_[--high]);
+        low >>= 1;
+        high >>= 1;
+    }
+    return summary;
+}
+
+SleepSummary SleepStats::night(int64_t night) const noexcept {
+    if (leaves_ == 0 || night < base_ || night >= base_ + static_cast<int64_t>(leaves_)) return {};
+    return tree_[leaves_ + static_cast<std::size_t>(night - base_)];
+}
+
+SleepSummary SleepStats::week(int64_t week) const {
+    const auto found = weeks_.find(week);
+    return found == weeks_.end() ? SleepSummary{} : found->second;
+}
+
+SleepSummary SleepStats::month(int64_t month) const {
+    const auto found = months_.find(month);
+    return found == months_.end() ? SleepSummary{} : found->second;
+}
+
+} // namespace sleepster
@@ -0,0 +1,294 @@
+//
+//  SoundEventDetector.cpp
+//  SleepsterCore
+//
+//  The rules, applied when an event ends:
+//
+//  - coughing: short (0.15-0.8 s), an abrupt onset at least 20 dB over the
+//    floor within three hops, and broadband energy centred above 700 Hz.
+//  - snoring: 0.25-4 s with most energy below 500 Hz and a low centroid.
+//  - talking: at least 0.4 s, mostly 300-3000 Hz, harmonic (low spectral
+//    flatness) and broken into two or more bursts by dips of 6 dB, as
+//    syllables are.
+//  - loud noise: anything else above the loud level.
+//
+
+#include "sleepster/SoundEventDetector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace sleepster {
+
+namespace {
+
+constexpr float kSilenceDb = -120.0f;
+/// Loudness dips that separate one burst from the next.
+constexpr float kBurstDipDb = 6.0f;
+/// Hops after the start of an event that count toward its onset.
+constexpr uint64_t kOnsetHops = 3;
+
+float decibels(double power) noexcept {
+    return static_cast<float>(10.0 * std::log10(power + 1e-12));
+}
+
+double melOf(double hz) noexcept {
+    return 2595.0 * std::log10(1.0 + hz / 700.0);
+}
+
+double hzOf(double mel) noexcept {
+    return 700.0 * (std::pow(10.0, mel / 2595.0) - 1.0);
+}
+
+/// The largest power of two no longer than 40 ms, and at least 256.
+std::size_t frameSizeFor(double sampleRate) noexcept {
+    std::size_t size = 256;
+    while (static_cast<double>(size * 2) <= 0.04 * sampleRate) size *= 2;
+    return size;
+}
+
+} // namespace
+
+SoundEventDetector::SoundEventDetector(const SoundEventDetectorConfig& config)
+    : config_(config), hop_(frameSizeFor(config.sampleRate) / 2),
+      hopSeconds_(static_cast<double>(hop_) / config.sampleRate),
+      hangoverHops_(static_cast<uint64_t>(std::ceil(config.hangoverSeconds / hopSeconds_))),
+      maxEventHops_(static_cast<uint64_t>(std::ceil(config.maxEventSeconds / hopSeconds_))),
+      fft_(frameSizeFor(config.sampleRate)), window_(fft_.size(), 0.0f), hann_(fft_.size()),
+      frame_(fft_.size()), power_(fft_.binCount()), bandStart_(config.melBands), bandLength_(config.melBands),
+      weightStart_(config.melBands), bandWidth_(config.melBands), bandCenter_(config.melBands),
+      bandLevels_(config.melBands, kSilenceDb), queue_(std::max<std::size_t>(1, config.eventCapacity)) {
+    const std::size_t size = fft_.size();
+    for (std::size_t i = 0; i < size; ++i) {
+        hann_[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * static_cast<double>(i) / size));
+    }
+
+    // Band edges evenly spaced in mel between the frequency limits.
+    const double nyquist = config.sampleRate / 2.0;
+    const double low = melOf(config.minFrequency);
+    const double high = melOf(std::min<double>(config.maxFrequency, nyquist));
+    const std::size_t bands = config.melBands;
+    const double binHz = config.sampleRate / static_cast<double>(size);
+    for (std::size_t b = 0; b < bands; ++b) {
+        const double lower = hzOf(low + (high - low) * static_cast<double>(b) / (bands + 1));
+        const double center = hzOf(low + (high - low) * static_cast<double>(b + 1) / (bands + 1));
+        const double upper = hzOf(low + (high - low) * static_cast<double>(b + 2) / (bands + 1));
+        bandCenter_[b] = static_cast<float>(center);
+        weightStart_[b] = static_cast<uint32_t>(weights_.size());
+
+        const std::size_t first = static_cast<std::size_t>(std::ceil(lower / binHz));
+        const std::size_t last = std::min(fft_.binCount() - 1, static_cast<std::size_t>(std::floor(upper / binHz)));
+        bandStart_[b] = static_cast<uint32_t>(first);
+        float width = 0.0f;
+        for (std::size_t k = first; k <= last; ++k) {
+            const double hz = static_cast<double>(k) * binHz;
+            const double weight = hz <= center ? (hz - lower) / (center - lower) : (upper - hz) / (upper - center);
+            weights_.push_back(static_cast<float>(std::max(0.0, weight)));
+            width += weights_.back();
+        }
+        if (width <= 0.0f) {
+            // Narrower than a bin: take the bin nearest the centre.
+            weights_.resize(weightStart_[b]);
+            bandStart_[b] = static_cast<uint32_t>(std::lround(center / binHz));
+            weights_.push_back(1.0f);
+            width = 1.0f;
+        }
+        bandLength_[b] = static_cast<uint32_t>(weights_.size() - weightStart_[b]);
+        bandWidth_[b] = width;
+    }
+    weights_.shrink_to_fit();
+}
+
+double SoundEventDetector::time() const noexcept {
+    return static_cast<double>(hopIndex_) * hopSeconds_;
+}
+
+std::size_t SoundEventDetector::memoryBytes() const noexcept {
+    auto bytes = [](const auto& v) { return v.capacity() * sizeof(v[0]); };
+    return fft_.memoryBytes() + bytes(window_) + bytes(hann_) + bytes(frame_) + bytes(power_) +
+           bytes(bandStart_) + bytes(bandLength_) + bytes(weightStart_) + bytes(weights_) + bytes(bandWidth_) +
+           bytes(bandCenter_) + bytes(bandLevels_) + bytes(queue_);
+}
+
+// MARK: - Streaming
+
+void SoundEventDetector::process(const float* samples, std::size_t count) noexcept {
+    const std::size_t size = window_.size();
+    while (count > 0) {
+        const std::size_t take = std::min(count, hop_ - filled_);
+        std::memcpy(window_.data() + size - hop_ + filled_, samples, take * sizeof(float));
+        filled_ += take;
+        samples += take;
+        count -= take;
+        if (filled_ == hop_) {
+            analyzeHop();
+            std::memmove(window_.data(), window_.data() + hop_, (size - hop_) * sizeof(float));
+            filled_ = 0;
+        }
+    }
+}
+
+void SoundEventDetector::flush() noexcept {
+    if (open_) close();
+}
+
+void SoundEventDetector::analyzeHop() noexcept {
+    const float* fresh = window_.data() + window_.size() - hop_;
+    double sum = 0.0;
+    for (std::size_t i = 0; i < hop_; ++i) sum += static_cast<double>(fresh[i]) * fresh[i];
+    const float level = decibels(sum / static_cast<double>(hop_));
+    if (!floorSet_) {
+        floor_ = level;
+        floorSet_ = true;
+    }
+
+    const bool loud = level > floor_ + config_.activationDb;
+    if (loud && !open_) {
+        open_ = true;
+        event_ = Open{};
+        event_.firstHop = hopIndex_;
+        event_.floor = floor_;
+    }
+    if (loud) {
+        event_.lastLoudHop = hopIndex_;
+        event_.peak = std::max(event_.peak, level);
+        if (hopIndex_ - event_.firstHop < kOnsetHops) event_.onset = std::max(event_.onset, level);
+        analyzeSpectrum(event_);
+        ++analyzed_;
+    } else {
+        ++gated_;
+    }
+    if (open_) {
+        track(event_, level);
+        if (hopIndex_ - event_.lastLoudHop >= hangoverHops_ || hopIndex_ - event_.firstHop + 1 >= maxEventHops_) {
+            close();
+        }
+    }
+
+    // The floor drops to quiet hops at once and climbs slowly, so it sits
+    // at the room's quietest and absorbs sounds that never stop.
+    if (level < floor_) {
+        floor_ = level;
+    } else {
+        floor_ += std::min(level - floor_, config_.floorRiseDbPerSecond * static_cast<float>(hopSeconds_));
+    }
+    ++hopIndex_;
+}
+
+void SoundEventDetector::analyzeSpectrum(Open& event) noexcept {
+    const std::size_t size = window_.size();
+    for (std::size_t i = 0; i < size; ++i) frame_[i] = window_[i] * hann_[i];
+    fft_.powerSpectrum(frame_.data(), power_.data());
+
+    double total = 0.0;
+    double low = 0.0;
+    double speech = 0.0;
+    double weightedHz = 0.0;
+    double logDensity = 0.0;
+    double density = 0.0;
+    const std::size_t bands = bandLevels_.size();
+    for (std::size_t b = 0; b < bands; ++b) {
+        const float* weight = weights_.data() + weightStart_[b];
+        const float* bin = power_.data() + bandStart_[b];
+        double energy = 0.0;
+        for (uint32_t k = 0; k < bandLength_[b]; ++k) energy += static_cast<double>(weight[k]) * bin[k];
+        bandLevels_[b] = decibels(energy);
+
+        const double center = bandCenter_[b];
+        total += energy;
+        if (center < 500.0) low += energy;
+        if (center >= 300.0 && center <= 3000.0) speech += energy;
+        weightedHz += energy * center;
+        const double perWeight = energy / bandWidth_[b];
+        density += perWeight;
+        logDensity += std::log(perWeight + 1e-20);
+    }
+    if (total <= 0.0) return;
+
+    const double meanDensity = density / static_cast<double>(bands);
+    event.low += low / total;
+    event.speech += speech / total;
+    event.centroid += weightedHz / total;
+    event.flatness += std::exp(logDensity / static_cast<double>(bands)) / meanDensity;
+    ++event.analyzed;
+}
+
+void SoundEventDetector::track(Open& event, float level) noexcept {
+    if (!event.dipped) {
+        if (level > event.runMax) {
+            event.runMax = level;
+        } else if (event.runMax - level >= kBurstDipDb) {
+            event.dipped = true;
+            event.runMin = level;
+        }
+    } else if (level < event.runMin) {
+        event.runMin = level;
+    } else if (level - event.runMin >= kBurstDipDb) {
+        ++event.bursts;
+        event.dipped = false;
+        event.runMax = level;
+    }
+}
+
+// MARK: - Events
+
+void SoundEventDetector::close() noexcept {
+    open_ = false;
+    const double duration = static_cast<double>(event_.lastLoudHop - event_.firstHop + 1) * hopSeconds_;
+    bool keep = false;
+    const SoundEventKind kind = classify(event_, duration, keep);
+    if (!keep) return;
+    SoundEvent event;
+    event.kind = kind;
+    event.time = static_cast<double>(event_.firstHop) * hopSeconds_;
+    event.duration = static_cast<float>(duration);
+    event.peakLevel = event_.peak;
+    push(event);
+}
+
+SoundEventKind SoundEventDetector::classify(const Open& event, double duration, bool& keep) const noexcept {
+    keep = true;
+    const double count = std::max<uint32_t>(1, event.analyzed);
+    const double low = event.low / count;
+    const double speech = event.speech / count;
+    const double centroid = event.centroid / count;
+    const double flatness = event.flatness / count;
+    const float rise = event.onset - event.floor;
+
+    if (duration >= 0.15 && duration <= 0.8 && rise >= 20.0f && centroid > 700.0 && flatness > 0.2) {
+        return SoundEventKind::Coughing;
+    }
+    if (duration >= 0.25 && duration <= 4.0 && low >= 0.55 && centroid < 600.0) {
+        return SoundEventKind::Snoring;
+    }
+    if (duration >= 0.4 && speech >= 0.5 && flatness < 0.2 && event.bursts >= 2) {
+        return SoundEventKind::Talking;
+    }
+    if (event.peak >= config_.loudLevel) {
+        return SoundEventKind::LoudNoise;
+    }
+    keep = false;
+    return SoundEventKind::LoudNoise;
+}
+
+void SoundEventDetector::push(const SoundEvent& event) noexcept {
+    if (queueSize_ == queue_.size()) {
+        ++dropped_;
+        return;
+    }
+    queue_[(queueHead_ + queueSize_) % queue_.size()] = event;
+    ++queueSize_;
+}
+
+std::size_t SoundEventDetector::takeEvents(SoundEvent* out, std::size_t capacity) noexcept {
+    const std::size_t count = std::min(capacity, queueSize_);
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = queue_[queueHead_];
+        queueHead_ = (queueHead_ + 1) % queue_.size();
+    }
+    queueSize_ -= count;
+    return count;
+}
+
+} // namespace sleepster
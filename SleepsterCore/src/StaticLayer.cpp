@@ -0,0 +1,348 @@
+//
+//  StaticLayer.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/StaticLayer.hpp"
+
+#include "sleepster/Random.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sleepster {
+
+namespace {
+
+constexpr float kPi = 3.14159265358979f;
+constexpr int kSubRows = 4;
+
+inline float clamp01(float v) noexcept { return std::min(1.0f, std::max(0.0f, v)); }
+
+inline uint8_t toByte(float v) noexcept { return static_cast<uint8_t>(clamp01(v) * 255.0f + 0.5f); }
+
+inline Rgba lerp(const Rgba& a, const Rgba& b, float t) noexcept {
+    return {a.r + (b.r - a.r) * t, a.g + (b.g - a.g) * t, a.b + (b.b - a.b) * t, a.a + (b.a - a.a) * t};
+}
+
+/// Adds coverage `weight` for the span [xa, xb) of pixel columns, already
+/// clamped to [first, last).
+void addSpan(std::vector<float>& coverage, int first, float xa, float xb, float weight) noexcept {
+    if (!(xb > xa)) return;
+    const int last = first + static_cast<int>(coverage.size());
+    const int ia = static_cast<int>(std::floor(xa));
+    const int ib = static_cast<int>(std::floor(xb));
+    if (ia == ib) {
+        coverage[ia - first] += (xb - xa) * weight;
+        return;
+    }
+    coverage[ia - first] += (static_cast<float>(ia + 1) - xa) * weight;
+    for (int i = ia + 1; i < ib; ++i) coverage[i - first] += weight;
+    if (ib < last) coverage[ib - first] += (xb - static_cast<float>(ib)) * weight;
+}
+
+/// One box pass of half-width `radius` along a line of `count` pixels
+/// `stride` floats apart, four channels each. Edge pixels repeat outwards,
+/// so layers that run off screen do not fade at the screen's edge.
+void boxPass(float* line, std::size_t count, std::size_t stride, int radius, std::vector<float>& scratch) {
+    scratch.resize(count * 4);
+    for (std::size_t i = 0; i < count; ++i) {
+        for (int c = 0; c < 4; ++c) scratch[i * 4 + c] = line[i * stride + c];
+    }
+    const auto at = [&](long i, int c) {
+        const long clamped = std::min<long>(static_cast<long>(count) - 1, std::max<long>(0, i));
+        return scratch[static_cast<std::size_t>(clamped) * 4 + c];
+    };
+    const float inverse = 1.0f / static_cast<float>(2 * radius + 1);
+    for (int c = 0; c < 4; ++c) {
+        float sum = 0.0f;
+        for (long k = -radius; k <= radius; ++k) sum += at(k, c);
+        for (std::size_t i = 0; i < count; ++i) {
+            line[i * stride + c] = sum * inverse;
+            sum += at(static_cast<long>(i) + radius + 1, c) - at(static_cast<long>(i) - radius, c);
+        }
+    }
+}
+
+void blurPixels(Bitmap& bitmap, float sigma) {
+    // Three box passes of width w approximate a Gaussian when
+    // 3 * (w^2 - 1) / 12 = sigma^2.
+    const int radius = static_cast<int>(std::lround((std::sqrt(4.0f * sigma * sigma + 1.0f) - 1.0f) * 0.5f));
+    if (radius < 1 || bitmap.width() == 0 || bitmap.height() == 0) return;
+    const std::size_t width = static_cast<std::size_t>(bitmap.width());
+    const std::size_t height = static_cast<std::size_t>(bitmap.height());
+
+    std::vector<float> pixels(width * height * 4);
+    const uint8_t* bytes = bitmap.data();
+    for (std::size_t i = 0; i < pixels.size(); ++i) pixels[i] = bytes[i] * (1.0f / 255.0f);
+
+    std::vector<float> scratch;
+    for (int pass = 0; pass < 3; ++pass) {
+        for (std::size_t y = 0; y < height; ++y) boxPass(&pixels[y * width * 4], width, 4, radius, scratch);
+        for (std::size_t x = 0; x < width; ++x) boxPass(&pixels[x * 4], height, width * 4, radius, scratch);
+    }
+
+    uint8_t* out = bitmap.data();
+    for (std::size_t i = 0; i < pixels.size(); ++i) out[i] = toByte(pixels[i]);
+}
+
+/// EnhancedHillShape in the rect x, y, width, height.
+std::vector<Point> hillPath(float x, float y, float width, float height) {
+    PathBuilder path;
+    path.moveTo(x, y + height);
+    path.quadTo(width * 0.2f, y + height * 0.3f, width * 0.33f, y + height * 0.2f, 24);
+    path.quadTo(width * 0.5f, y, width * 0.66f, y + height * 0.3f, 24);
+    path.quadTo(width * 0.8f, y + height * 0.4f, x + width, y + height, 24);
+    return path.points();
+}
+
+/// EnhancedGrassShape in the rect x, y, width, height.
+std::vector<Point> grassPath(float x, float y, float width, float height) {
+    const float midX = x + width * 0.5f;
+    const float midY = y + height * 0.5f;
+    PathBuilder path;
+    path.moveTo(midX, y + height);
+    path.quadTo(midX - width * 0.1f, midY, midX - width * 0.2f, y + height * 0.3f, 8);
+    path.quadTo(midX - width * 0.05f, y, midX + width * 0.1f, y, 8);
+    path.quadTo(midX + width * 0.05f, midY, midX, y + height, 8);
+    return path.points();
+}
+
+/// StarShape: ten points alternating between the radius and 0.4 of it.
+std::vector<Point> starPath(float centerX, float centerY, float radius) {
+    std::vector<Point> points;
+    points.reserve(10);
+    for (int i = 0; i < 10; ++i) {
+        const float angle = static_cast<float>(i) * kPi / 5.0f;
+        const float r = i % 2 == 0 ? radius : radius * 0.4f;
+        points.push_back({centerX + std::cos(angle) * r, centerY + std::sin(angle) * r});
+    }
+    return points;
+}
+
+} // namespace
+
+// MARK: - Colour
+
+Rgba Gradient::at(float t) const noexcept {
+    if (count <= 1) return stops[0];
+    const int segments = std::min(count, 3) - 1;
+    const float position = clamp01(t) * static_cast<float>(segments);
+    const int index = std::min(segments - 1, static_cast<int>(position));
+    return lerp(stops[index], stops[index + 1], position - static_cast<float>(index));
+}
+
+Rgba Paint::at(float px, float py) const noexcept {
+    if (radial) {
+        return gradient.at(std::hypot(px - x, py - y) / extent);
+    }
+    return gradient.at((py - y) / extent);
+}
+
+// MARK: - Bitmap
+
+Bitmap::Bitmap(int width, int height)
+    : width_(std::max(0, width)),
+      height_(std::max(0, height)),
+      pixels_(static_cast<std::size_t>(width_) * static_cast<std::size_t>(height_) * 4, 0) {}
+
+Rgba Bitmap::pixel(int x, int y) const noexcept {
+    if (x < 0 || y < 0 || x >= width_ || y >= height_) return {};
+    const uint8_t* p = &pixels_[(static_cast<std::size_t>(y) * width_ + x) * 4];
+    constexpr float k = 1.0f / 255.0f;
+    return {p[0] * k, p[1] * k, p[2] * k, p[3] * k};
+}
+
+void Bitmap::blendOver(int x, int y, const Rgba& source) noexcept {
+    if (x < 0 || y < 0 || x >= width_ || y >= height_ || source.a <= 0.0f) return;
+    uint8_t* p = &pixels_[(static_cast<std::size_t>(y) * width_ + x) * 4];
+    const float keep = 1.0f - clamp01(source.a);
+    constexpr float k = 1.0f / 255.0f;
+    p[0] = toByte(source.r + p[0] * k * keep);
+    p[1] = toByte(source.g + p[1] * k * keep);
+    p[2] = toByte(source.b + p[2] * k * keep);
+    p[3] = toByte(source.a + p[3] * k * keep);
+}
+
+void Bitmap::drawOver(const Bitmap& source, int dx, int dy) noexcept {
+    for (int y = 0; y < source.height_; ++y) {
+        for (int x = 0; x < source.width_; ++x) {
+            const Rgba color = source.pixel(x, y);
+            if (color.a > 0.0f) blendOver(x + dx, y + dy, color);
+        }
+    }
+}
+
+StaticLayer::StaticLayer(float x, float y, float width, float height, float scale)
+    : x(x),
+      y(y),
+      scale(scale),
+      // The small allowance keeps widths computed from whole pixels (a
+      // sprite strip) from gaining a column to rounding.
+      bitmap(static_cast<int>(std::ceil(width * scale - 1e-3f)), static_cast<int>(std::ceil(height * scale - 1e-3f))) {}
+
+// MARK: - Paths
+
+void PathBuilder::moveTo(float x, float y) {
+    points_.clear();
+    points_.push_back({x, y});
+}
+
+void PathBuilder::lineTo(float x, float y) {
+    points_.push_back({x, y});
+}
+
+void PathBuilder::quadTo(float controlX, float controlY, float x, float y, int segments) {
+    if (points_.empty()) points_.push_back({controlX, controlY});
+    const Point start = points_.back();
+    for (int i = 1; i <= segments; ++i) {
+        const float t = static_cast<float>(i) / static_cast<float>(segments);
+        const float u = 1.0f - t;
+        points_.push_back({u * u * start.x + 2.0f * u * t * controlX + t * t * x,
+                           u * u * start.y + 2.0f * u * t * controlY + t * t * y});
+    }
+}
+
+void fillPolygon(StaticLayer& layer, const std::vector<Point>& polygon, const Paint& paint) {
+    Bitmap& bitmap = layer.bitmap;
+    if (polygon.size() < 3 || bitmap.width() == 0 || bitmap.height() == 0) return;
+
+    std::vector<Point> pixels(polygon.size());
+    float minX = INFINITY, maxX = -INFINITY, minY = INFINITY, maxY = -INFINITY;
+    for (std::size_t i = 0; i < polygon.size(); ++i) {
+        pixels[i] = {(polygon[i].x - layer.x) * layer.scale, (polygon[i].y - layer.y) * layer.scale};
+        minX = std::min(minX, pixels[i].x);
+        maxX = std::max(maxX, pixels[i].x);
+        minY = std::min(minY, pixels[i].y);
+        maxY = std::max(maxY, pixels[i].y);
+    }
+    const int firstColumn = std::max(0, static_cast<int>(std::floor(minX)));
+    const int lastColumn = std::min(bitmap.width(), static_cast<int>(std::ceil(maxX)));
+    const int firstRow = std::max(0, static_cast<int>(std::floor(minY)));
+    const int lastRow = std::min(bitmap.height(), static_cast<int>(std::ceil(maxY)));
+    if (firstColumn >= lastColumn || firstRow >= lastRow) return;
+
+    std::vector<float> coverage(static_cast<std::size_t>(lastColumn - firstColumn));
+    std::vector<float> crossings;
+    const float left = static_cast<float>(firstColumn);
+    const float right = static_cast<float>(lastColumn);
+    const float inverseScale = 1.0f / layer.scale;
+
+    for (int row = firstRow; row < lastRow; ++row) {
+        std::fill(coverage.begin(), coverage.end(), 0.0f);
+        bool covered = false;
+        for (int sub = 0; sub < kSubRows; ++sub) {
+            const float sy = static_cast<float>(row) + (static_cast<float>(sub) + 0.5f) / kSubRows;
+            crossings.clear();
+            for (std::size_t i = 0, j = pixels.size() - 1; i < pixels.size(); j = i++) {
+                const Point& a = pixels[j];
+                const Point& b = pixels[i];
+                if ((a.y <= sy) != (b.y <= sy)) {
+                    crossings.push_back(a.x + (sy - a.y) * (b.x - a.x) / (b.y - a.y));
+                }
+            }
+            std::sort(crossings.begin(), crossings.end());
+            for (std::size_t i = 0; i + 1 < crossings.size(); i += 2) {
+                const float xa = std::max(left, crossings[i]);
+                const float xb = std::min(right, crossings[i + 1]);
+                addSpan(coverage, firstColumn, xa, xb, 1.0f / kSubRows);
+                covered = true;
+            }
+        }
+        if (!covered) continue;
+
+        const float py = (static_cast<float>(row) + 0.5f) * inverseScale + layer.y;
+        for (int column = firstColumn; column < lastColumn; ++column) {
+            const float amount = std::min(1.0f, coverage[column - firstColumn]);
+            if (amount <= 0.0f) continue;
+            const float px = (static_cast<float>(column) + 0.5f) * inverseScale + layer.x;
+            const Rgba color = paint.at(px, py);
+            const float alpha = color.a * amount;
+            bitmap.blendOver(column, row, {color.r * alpha, color.g * alpha, color.b * alpha, alpha});
+        }
+    }
+}
+
+void blur(StaticLayer& layer, float radius) {
+    if (radius > 0.0f) blurPixels(layer.bitmap, radius * layer.scale);
+}
+
+void dropShadow(StaticLayer& layer, const Rgba& color, float radius, float dx, float dy) {
+    if (color.a <= 0.0f) return;
+    const Bitmap& source = layer.bitmap;
+    Bitmap shadow(source.width(), source.height());
+    for (int y = 0; y < source.height(); ++y) {
+        for (int x = 0; x < source.width(); ++x) {
+            const float alpha = source.pixel(x, y).a * color.a;
+            if (alpha > 0.0f) shadow.blendOver(x, y, {color.r * alpha, color.g * alpha, color.b * alpha, alpha});
+        }
+    }
+    if (radius > 0.0f) blurPixels(shadow, radius * layer.scale);
+
+    Bitmap combined(source.width(), source.height());
+    combined.drawOver(shadow, static_cast<int>(std::lround(dx * layer.scale)),
+                      static_cast<int>(std::lround(dy * layer.scale)));
+    combined.drawOver(source);
+    layer.bitmap = std::move(combined);
+}
+
+// MARK: - Background layers
+
+StaticLayer renderHills(float width, float top, float bottom, float scale, const std::vector<HillConfig>& hills) {
+    StaticLayer layer(0.0f, top, width, bottom - top, scale);
+    for (const HillConfig& hill : hills) {
+        StaticLayer scratch(layer.x, layer.y, width, bottom - top, scale);
+        fillPolygon(scratch, hillPath(0.0f, hill.top, width, hill.height),
+                    Paint{hill.fill, false, 0.0f, hill.top, hill.height});
+        blur(scratch, hill.blur);
+        layer.bitmap.drawOver(scratch.bitmap);
+    }
+    return layer;
+}
+
+StaticLayer renderGrass(const GrassConfig& config) {
+    // Room for the blur and shadow around the blades, and one blade spacing
+    // past each side so the row can sway without showing its ends.
+    const float margin = 3.0f * (config.blur + config.shadowRadius) +
+                         std::max(std::fabs(config.shadowX), std::fabs(config.shadowY)) + 1.0f;
+    const float top = config.baseline - config.bladeHeight.max - std::fabs(config.jitterY) - margin;
+    const float bottom = config.baseline + std::fabs(config.jitterY) + margin;
+    const float left = -config.spacing;
+    StaticLayer layer(left, top, config.width + 2.0f * config.spacing, bottom - top, config.scale);
+
+    Random random(config.seed);
+    const int blades = config.spacing > 0.0f ? static_cast<int>(config.width / config.spacing) : 0;
+    for (int i = -1; i <= blades; ++i) {
+        const float height = random.uniform(config.bladeHeight.min, config.bladeHeight.max);
+        const float width = random.uniform(config.bladeWidth.min, config.bladeWidth.max);
+        const float centerX = static_cast<float>(i) * config.spacing + random.uniform(-config.jitterX, config.jitterX);
+        const float centerY = config.baseline - height * 0.5f + random.uniform(-config.jitterY, config.jitterY);
+        const float bladeTop = centerY - height * 0.5f;
+        fillPolygon(layer, grassPath(centerX - width * 0.5f, bladeTop, width, height),
+                    Paint{config.fill, false, 0.0f, bladeTop, height});
+    }
+    blur(layer, config.blur);
+    dropShadow(layer, config.shadow, config.shadowRadius, config.shadowX, config.shadowY);
+    return layer;
+}
+
+int spriteCell(const StarSpriteConfig& config) noexcept {
+    return static_cast<int>(std::ceil(config.size.max * config.scale)) + 2;
+}
+
+StaticLayer renderStarSprites(const StarSpriteConfig& config) {
+    const int count = std::max(1, config.count);
+    const float cell = static_cast<float>(spriteCell(config)) / config.scale;
+    StaticLayer layer(0.0f, 0.0f, cell * static_cast<float>(count), cell, config.scale);
+    for (int i = 0; i < count; ++i) {
+        const float t = count > 1 ? static_cast<float>(i) / static_cast<float>(count - 1) : 0.0f;
+        const float size = config.size.min + (config.size.max - config.size.min) * t;
+        const float centerX = (static_cast<float>(i) + 0.5f) * cell;
+        const float centerY = 0.5f * cell;
+        fillPolygon(layer, starPath(centerX, centerY, size * 0.5f),
+                    Paint{config.fill, true, centerX, centerY, config.fillRadius});
+    }
+    return layer;
+}
+
+} // namespace sleepster
@@ -0,0 +1,193 @@
+//
+//  StreamingSource.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/StreamingSource.hpp"
+
+#include "sleepster/MixKernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+
+namespace sleepster {
+
+namespace {
+
+uint64_t threadCpuNanos() noexcept {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+} // namespace
+
+// MARK: - StreamingSource
+
+StreamingSource::StreamingSource(std::unique_ptr<Decoder> decoder, const StreamingConfig& config)
+    : StreamingSource(std::move(decoder), config, StreamDecodeWorker::shared()) {}
+
+StreamingSource::StreamingSource(std::unique_ptr<Decoder> decoder, const StreamingConfig& config,
+                                 StreamDecodeWorker& worker)
+    : decoder_(std::move(decoder)), config_(config), worker_(worker) {}
+
+StreamingSource::~StreamingSource() {
+    if (registered_) worker_.remove(this);
+}
+
+void StreamingSource::prepare(double sampleRate, std::size_t maxBlockFrames) {
+    if (decoder_ && sampleRate > 0.0 && decoder_->sampleRate() != sampleRate) {
+        decoder_ = std::make_unique<ResamplingDecoder>(std::move(decoder_), sampleRate);
+    }
+
+    // The ring must hold at least a couple of render blocks.
+    const std::size_t lookahead = static_cast<std::size_t>(std::ceil(config_.lookaheadSeconds * sampleRate));
+    capacity_ = std::max(lookahead, 4 * maxBlockFrames);
+    lowWater_ = capacity_ / 2;
+    left_.assign(capacity_, 0.0f);
+    right_.assign(capacity_, 0.0f);
+
+    // Decode the first few hundred milliseconds here so the first render
+    // block has audio; the worker fills the rest of the lookahead.
+    const std::size_t prefill = std::min(
+        capacity_, std::max(maxBlockFrames, static_cast<std::size_t>(config_.prefillSeconds * sampleRate)));
+    while (fillLevel() < prefill && !endOfStream_.load(std::memory_order_relaxed)) {
+        if (!refill()) break;
+    }
+
+    if (!registered_) {
+        worker_.add(this);
+        registered_ = true;
+    }
+    worker_.wake();
+}
+
+std::size_t StreamingSource::fillLevel() const noexcept {
+    return static_cast<std::size_t>(writeIndex_.load(std::memory_order_acquire) -
+                                    readIndex_.load(std::memory_order_acquire));
+}
+
+std::size_t StreamingSource::render(float* left, float* right, std::size_t frames) noexcept {
+    // Read the end flag before the write index: once the flag is set the
+    // write index is final.
+    const bool ended = endOfStream_.load(std::memory_order_acquire);
+    const uint64_t read = readIndex_.load(std::memory_order_relaxed);
+    const uint64_t write = writeIndex_.load(std::memory_order_acquire);
+    const std::size_t available = static_cast<std::size_t>(write - read);
+    const std::size_t count = std::min(frames, available);
+
+    if (count > 0) {
+        const std::size_t start = static_cast<std::size_t>(read % capacity_);
+        const std::size_t first = std::min(count, capacity_ - start);
+        std::memcpy(left, left_.data() + start, first * sizeof(float));
+        std::memcpy(right, right_.data() + start, first * sizeof(float));
+        if (first < count) {
+            std::memcpy(left + first, left_.data(), (count - first) * sizeof(float));
+            std::memcpy(right + first, right_.data(), (count - first) * sizeof(float));
+        }
+        readIndex_.store(read + count, std::memory_order_release);
+    }
+
+    if (available - count < lowWater_ && !ended &&
+        !refillRequested_.exchange(true, std::memory_order_acq_rel)) {
+        worker_.wake();
+    }
+
+    if (count == frames) return frames;
+    if (ended) return count;
+
+    // The decoder fell behind: pad with silence but keep the voice alive.
+    kernels::clear(left + count, frames - count);
+    kernels::clear(right + count, frames - count);
+    underrunFrames_.fetch_add(frames - count, std::memory_order_relaxed);
+    return frames;
+}
+
+bool StreamingSource::refill() {
+    refillRequested_.store(false, std::memory_order_release);
+    if (!decoder_ || capacity_ == 0 || endOfStream_.load(std::memory_order_relaxed)) return false;
+
+    bool progressed = false;
+    bool justRewound = false;
+    uint64_t write = writeIndex_.load(std::memory_order_relaxed);
+    for (;;) {
+        const std::size_t used = static_cast<std::size_t>(write - readIndex_.load(std::memory_order_acquire));
+        const std::size_t freeFrames = capacity_ - used;
+        if (freeFrames == 0) break;
+
+        const std::size_t position = static_cast<std::size_t>(write % capacity_);
+        const std::size_t contiguous = std::min({freeFrames, capacity_ - position, config_.chunkFrames});
+        const std::size_t decoded = decoder_->decode(left_.data() + position, right_.data() + position, contiguous);
+
+        if (decoded == 0) {
+            // Rewinding twice in a row means the stream is empty.
+            if (config_.loop && !justRewound && decoder_->seek(0)) {
+                justRewound = true;
+                continue;
+            }
+            endOfStream_.store(true, std::memory_order_release);
+            break;
+        }
+
+        justRewound = false;
+        write += decoded;
+        writeIndex_.store(write, std::memory_order_release);
+        progressed = true;
+    }
+    return progressed;
+}
+
+// MARK: - StreamDecodeWorker
+
+StreamDecodeWorker::~StreamDecodeWorker() {
+    if (running_.exchange(false)) {
+        wakeup_.signal();
+        if (thread_.joinable()) thread_.join();
+    }
+}
+
+StreamDecodeWorker& StreamDecodeWorker::shared() {
+    static StreamDecodeWorker worker;
+    return worker;
+}
+
+void StreamDecodeWorker::add(StreamingSource* source) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sources_.push_back(source);
+    if (!running_.exchange(true)) {
+        thread_ = std::thread([this] { run(); });
+    }
+}
+
+void StreamDecodeWorker::remove(StreamingSource* source) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sources_.erase(std::remove(sources_.begin(), sources_.end(), source), sources_.end());
+}
+
+double StreamDecodeWorker::cpuSeconds() const noexcept {
+    return static_cast<double>(cpuNanos_.load(std::memory_order_relaxed)) * 1e-9;
+}
+
+void StreamDecodeWorker::run() {
+    while (running_.load(std::memory_order_acquire)) {
+        wakeup_.wait();
+        if (!running_.load(std::memory_order_acquire)) break;
+
+        const uint64_t start = threadCpuNanos();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (StreamingSource* source : sources_) {
+                if (source->refillRequested_.load(std::memory_order_acquire) ||
+                    source->fillLevel() < source->capacity_) {
+                    source->refill();
+                }
+            }
+        }
+        cpuNanos_.fetch_add(threadCpuNanos() - start, std::memory_order_relaxed);
+        wakeups_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace sleepster
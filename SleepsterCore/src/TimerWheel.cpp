@@ -0,0 +1,257 @@
+//
+//  TimerWheel.cpp
+//  SleepsterCore
+//
+//  A timer sits at the level of the highest six-bit digit in which its
+//  deadline differs from the current tick, in the slot of that digit. Slots
+//  of a level are therefore ordered, and every slot of a level comes after
+//  every slot of the levels below it. Advancing empties the slots the new
+//  tick has reached, fires what is due and files the rest again, one level
+//  lower.
+//
+
+#include "sleepster/TimerWheel.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sleepster {
+
+namespace {
+
+constexpr uint64_t kMaxTick = (uint64_t{1} << (TimerWheel::kLevelBits * TimerWheel::kLevels)) - 1;
+/// Keeps a time computed as n ticks from landing on n - 1.
+constexpr double kRoundingSlack = 1e-6;
+
+int lowestBit(uint64_t bits) noexcept {
+    return __builtin_ctzll(bits);
+}
+
+int highestBit(uint64_t bits) noexcept {
+    return 63 - __builtin_clzll(bits);
+}
+
+} // namespace
+
+TimerWheel::TimerWheel(double now, const TimerWheelConfig& config) : config_(config), origin_(now) {
+    heads_.fill(kNil);
+}
+
+// MARK: - Ticks
+
+uint64_t TimerWheel::ticksUntil(double seconds) const noexcept {
+    const double ticks = seconds / config_.tickSeconds;
+    if (!(ticks > 0.0)) return 0;
+    if (ticks >= static_cast<double>(kMaxTick)) return kMaxTick;
+    return static_cast<uint64_t>(std::ceil(ticks - kRoundingSlack));
+}
+
+double TimerWheel::secondsOf(uint64_t tick) const noexcept {
+    return origin_ + static_cast<double>(tick) * config_.tickSeconds;
+}
+
+uint64_t TimerWheel::slackOf(const Node& node) const noexcept {
+    if (!lowPower_ || node.critical) return node.tolerance;
+    const auto stretched = static_cast<uint64_t>(static_cast<double>(node.tolerance) * config_.lowPowerSlackFactor);
+    return std::max(stretched, ticksUntil(config_.lowPowerMinimumSlack));
+}
+
+// MARK: - Slots
+
+void TimerWheel::place(uint32_t index) noexcept {
+    Node& node = nodes_[index];
+    int level = 0;
+    uint64_t digit = current_ & (kSlotsPerLevel - 1);
+    if (node.deadline > current_) {
+        level = highestBit(node.deadline ^ current_) / kLevelBits;
+        digit = (node.deadline >> (level * kLevelBits)) & (kSlotsPerLevel - 1);
+    }
+    const int slot = level * kSlotsPerLevel + static_cast<int>(digit);
+    node.slot = static_cast<uint16_t>(slot);
+    node.prev = kNil;
+    node.next = heads_[slot];
+    if (node.next != kNil) nodes_[node.next].prev = index;
+    heads_[slot] = index;
+    occupied_[level] |= uint64_t{1} << digit;
+}
+
+void TimerWheel::unlink(uint32_t index) noexcept {
+    Node& node = nodes_[index];
+    if (node.prev != kNil) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        heads_[node.slot] = node.next;
+    }
+    if (node.next != kNil) nodes_[node.next].prev = node.prev;
+    if (heads_[node.slot] == kNil) {
+        occupied_[node.slot / kSlotsPerLevel] &= ~(uint64_t{1} << (node.slot % kSlotsPerLevel));
+    }
+}
+
+void TimerWheel::detachSlot(int slot, std::vector<uint32_t>& list) noexcept {
+    for (uint32_t index = heads_[slot]; index != kNil; index = nodes_[index].next) {
+        list.push_back(index);
+    }
+    heads_[slot] = kNil;
+    occupied_[slot / kSlotsPerLevel] &= ~(uint64_t{1} << (slot % kSlotsPerLevel));
+}
+
+void TimerWheel::release(uint32_t index) noexcept {
+    Node& node = nodes_[index];
+    node.live = false;
+    if (++node.generation == 0) node.generation = 1;
+    free_.push_back(index);
+    --live_;
+}
+
+TimerId TimerWheel::idOf(uint32_t index, uint32_t generation) noexcept {
+    return (static_cast<uint64_t>(generation) << 32) | index;
+}
+
+// MARK: - Scheduling
+
+TimerId TimerWheel::schedule(const TimerSpec& spec) {
+    uint32_t index;
+    if (!free_.empty()) {
+        index = free_.back();
+        free_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(nodes_.size());
+        nodes_.push_back(Node{});
+        nodes_.back().generation = 1;
+    }
+    Node& node = nodes_[index];
+    node.deadline = ticksUntil(spec.deadline - origin_);
+    node.interval = spec.interval > 0.0 ? std::max<uint64_t>(1, ticksUntil(spec.interval)) : 0;
+    node.tolerance = spec.tolerance > 0.0
+        ? static_cast<uint64_t>(spec.tolerance / config_.tickSeconds + kRoundingSlack)
+        : 0;
+    node.critical = spec.critical;
+    node.live = true;
+    ++live_;
+    place(index);
+    nextWakeupStale_ = true;
+    return idOf(index, node.generation);
+}
+
+bool TimerWheel::cancel(TimerId id) noexcept {
+    if (!isScheduled(id)) return false;
+    const auto index = static_cast<uint32_t>(id);
+    unlink(index);
+    release(index);
+    nextWakeupStale_ = true;
+    return true;
+}
+
+bool TimerWheel::isScheduled(TimerId id) const noexcept {
+    const auto index = static_cast<uint32_t>(id);
+    if (index >= nodes_.size()) return false;
+    const Node& node = nodes_[index];
+    return node.live && node.generation == static_cast<uint32_t>(id >> 32);
+}
+
+void TimerWheel::setLowPower(bool enabled) noexcept {
+    if (lowPower_ == enabled) return;
+    lowPower_ = enabled;
+    nextWakeupStale_ = true;
+}
+
+// MARK: - Time
+
+double TimerWheel::nextWakeup() const noexcept {
+    if (nextWakeupStale_) {
+        // Walk slots in time order, keeping the earliest window end, until a
+        // slot starts after it: nothing from there on can end sooner.
+        uint64_t best = kNever;
+        for (int level = 0; level < kLevels; ++level) {
+            const int shift = level * kLevelBits;
+            const uint64_t base = (current_ >> (shift + kLevelBits)) << (shift + kLevelBits);
+            for (uint64_t bits = occupied_[level]; bits != 0; bits &= bits - 1) {
+                const int digit = lowestBit(bits);
+                const uint64_t start = std::max(current_, base + (static_cast<uint64_t>(digit) << shift));
+                if (start > best) {
+                    level = kLevels;
+                    break;
+                }
+                const int slot = level * kSlotsPerLevel + digit;
+                for (uint32_t index = heads_[slot]; index != kNil; index = nodes_[index].next) {
+                    best = std::min(best, nodes_[index].deadline + slackOf(nodes_[index]));
+                }
+            }
+        }
+        nextWakeup_ = best;
+        nextWakeupStale_ = false;
+    }
+    if (nextWakeup_ == kNever) return std::numeric_limits<double>::infinity();
+    return secondsOf(std::max(nextWakeup_, current_));
+}
+
+const std::vector<TimerId>& TimerWheel::advance(double now) {
+    firedIds_.clear();
+    const double ticks = (now - origin_) / config_.tickSeconds + kRoundingSlack;
+    uint64_t target = current_;
+    if (ticks >= static_cast<double>(kMaxTick)) {
+        target = kMaxTick;
+    } else if (ticks > static_cast<double>(current_)) {
+        target = static_cast<uint64_t>(ticks);
+    }
+
+    // A level whose upper digits change with the move is due as a whole;
+    // otherwise its slots up to the new digit are.
+    detached_.clear();
+    for (int level = 0; level < kLevels; ++level) {
+        const int shift = level * kLevelBits;
+        uint64_t bits = occupied_[level];
+        if ((current_ >> (shift + kLevelBits)) == (target >> (shift + kLevelBits))) {
+            const uint64_t digit = (target >> shift) & (kSlotsPerLevel - 1);
+            bits &= (uint64_t{2} << digit) - 1;
+        }
+        for (; bits != 0; bits &= bits - 1) {
+            detachSlot(level * kSlotsPerLevel + lowestBit(bits), detached_);
+        }
+    }
+    current_ = target;
+
+    due_.clear();
+    for (uint32_t index : detached_) {
+        if (nodes_[index].deadline <= current_) {
+            due_.push_back(index);
+        } else {
+            place(index);
+        }
+    }
+    std::sort(due_.begin(), due_.end(), [this](uint32_t a, uint32_t b) {
+        return nodes_[a].deadline != nodes_[b].deadline ? nodes_[a].deadline < nodes_[b].deadline : a < b;
+    });
+    for (uint32_t index : due_) {
+        Node& node = nodes_[index];
+        firedIds_.push_back(idOf(index, node.generation));
+        if (node.interval > 0) {
+            node.deadline += node.interval * ((current_ - node.deadline) / node.interval + 1);
+            node.deadline = std::min(node.deadline, kMaxTick);
+            place(index);
+        } else {
+            release(index);
+        }
+    }
+
+    if (!due_.empty()) ++wakeups_;
+    fired_ += due_.size();
+    nextWakeupStale_ = true;
+    return firedIds_;
+}
+
+// MARK: - Metrics
+
+double TimerWheel::wakeupsPerHour() const noexcept {
+    const double hours = static_cast<double>(current_ - metricsSince_) * config_.tickSeconds / 3600.0;
+    return hours > 0.0 ? static_cast<double>(wakeups_) / hours : 0.0;
+}
+
+void TimerWheel::resetMetrics() noexcept {
+    wakeups_ = 0;
+    fired_ = 0;
+    metricsSince_ = current_;
+}
+
+} // namespace sleepster
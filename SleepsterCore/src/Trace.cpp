@@ -0,0 +1,302 @@
+//
+//  Trace.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/Trace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+namespace sleepster {
+
+static_assert((Tracer::kEventsPerThread & (Tracer::kEventsPerThread - 1)) == 0,
+              "events per thread must be a power of two");
+
+std::atomic<bool> Tracer::enabled_{false};
+
+namespace {
+
+constexpr uint64_t kCapacity = Tracer::kEventsPerThread;
+constexpr uint64_t kMask = kCapacity - 1;
+
+struct Slot {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> start{0};
+    /// The duration, or the counter value's bits.
+    std::atomic<uint64_t> payload{0};
+    /// Category in the low byte, phase in the next.
+    std::atomic<uint32_t> kind{0};
+};
+
+/// Written only by the thread that claimed it. `started` is bumped before
+/// a slot is overwritten and `written` after, so a reader can tell which
+/// of the slots it copied may have changed under it, as with a seqlock.
+struct alignas(64) Ring {
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> started{0};
+    std::atomic<uint64_t> written{0};
+    std::atomic<uint64_t> cleared{0};
+    /// Guarded by State::lock.
+    std::string name;
+};
+
+struct State {
+    /// Guards allocation and thread names.
+    std::mutex lock;
+    std::unique_ptr<Ring[]> rings;
+    /// Published once the rings and the epoch are set up; never retracted.
+    std::atomic<Ring*> ready{nullptr};
+    std::atomic<std::size_t> claimed{0};
+    std::atomic<uint64_t> untracked{0};
+    uint64_t epoch = 0;
+};
+
+State& state() noexcept {
+    static State instance;
+    return instance;
+}
+
+thread_local Ring* tRing = nullptr;
+thread_local bool tUntracked = false;
+
+/// The calling thread's ring, claimed on first use; null before tracing
+/// was ever on, or once every ring is taken.
+Ring* threadRing() noexcept {
+    if (tRing) return tRing;
+    if (tUntracked) return nullptr;
+    State& s = state();
+    Ring* rings = s.ready.load(std::memory_order_acquire);
+    if (!rings) return nullptr;
+    const std::size_t index = s.claimed.fetch_add(1, std::memory_order_relaxed);
+    if (index >= Tracer::kMaxThreads) {
+        tUntracked = true;
+        return nullptr;
+    }
+    tRing = &rings[index];
+    return tRing;
+}
+
+void record(TraceCategory category, TracePhase phase, const char* name, uint64_t start, uint64_t payload) noexcept {
+    Ring* ring = threadRing();
+    if (!ring) {
+        if (tUntracked) state().untracked.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const uint64_t at = ring->written.load(std::memory_order_relaxed);
+    ring->started.store(at + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Slot& slot = ring->slots[at & kMask];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.payload.store(payload, std::memory_order_relaxed);
+    slot.kind.store(static_cast<uint32_t>(category) | static_cast<uint32_t>(phase) << 8, std::memory_order_relaxed);
+    ring->written.store(at + 1, std::memory_order_release);
+}
+
+std::size_t claimedRings() noexcept {
+    return std::min(state().claimed.load(std::memory_order_acquire), Tracer::kMaxThreads);
+}
+
+const char* categoryName(TraceCategory category) noexcept {
+    switch (category) {
+    case TraceCategory::Audio: return "audio";
+    case TraceCategory::Animation: return "animation";
+    case TraceCategory::Storage: return "storage";
+    case TraceCategory::App: return "app";
+    }
+    return "app";
+}
+
+void appendString(std::string& out, const char* text) {
+    out += '"';
+    for (const char* c = text; *c; ++c) {
+        switch (*c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        default:
+            if (static_cast<unsigned char>(*c) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof escaped, "\\u%04x", static_cast<unsigned>(*c));
+                out += escaped;
+            } else {
+                out += *c;
+            }
+        }
+    }
+    out += '"';
+}
+
+/// Microseconds, as trace-event timestamps are given.
+void appendMicroseconds(std::string& out, uint64_t nanoseconds) {
+    char buffer[32];
+    const int length = std::snprintf(buffer, sizeof buffer, "%.3f", static_cast<double>(nanoseconds) * 1e-3);
+    if (length > 0) out.append(buffer, static_cast<std::size_t>(std::min<int>(length, sizeof buffer - 1)));
+}
+
+} // namespace
+
+void Tracer::setEnabled(bool enabled) {
+    State& s = state();
+    if (enabled) {
+        std::lock_guard<std::mutex> guard(s.lock);
+        if (!s.rings) {
+            s.rings = std::make_unique<Ring[]>(kMaxThreads);
+            for (std::size_t i = 0; i < kMaxThreads; ++i) {
+                s.rings[i].slots = std::make_unique<Slot[]>(kCapacity);
+            }
+            s.epoch = traceNow();
+            s.ready.store(s.rings.get(), std::memory_order_release);
+        }
+    }
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void Tracer::setThreadName(const char* name) {
+    Ring* ring = threadRing();
+    if (!ring) return;
+    std::lock_guard<std::mutex> guard(state().lock);
+    ring->name = name;
+}
+
+void Tracer::complete(TraceCategory category, const char* name, uint64_t start, uint64_t end) noexcept {
+    record(category, TracePhase::Complete, name, start, end > start ? end - start : 0);
+}
+
+void Tracer::counter(TraceCategory category, const char* name, double value) noexcept {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof bits);
+    record(category, TracePhase::Counter, name, traceNow(), bits);
+}
+
+std::vector<TraceThread> Tracer::snapshot() {
+    State& s = state();
+    std::vector<TraceThread> threads;
+    Ring* rings = s.ready.load(std::memory_order_acquire);
+    if (!rings) return threads;
+
+    const std::size_t count = claimedRings();
+    threads.resize(count);
+    for (std::size_t r = 0; r < count; ++r) {
+        Ring& ring = rings[r];
+        TraceThread& thread = threads[r];
+        thread.id = static_cast<uint32_t>(r + 1);
+
+        const uint64_t end = ring.written.load(std::memory_order_acquire);
+        const uint64_t begin = std::max(ring.cleared.load(std::memory_order_relaxed),
+                                        end > kCapacity ? end - kCapacity : 0);
+        thread.events.resize(static_cast<std::size_t>(end - begin));
+        for (uint64_t i = begin; i < end; ++i) {
+            const Slot& slot = ring.slots[i & kMask];
+            TraceEvent& event = thread.events[static_cast<std::size_t>(i - begin)];
+            const uint32_t kind = slot.kind.load(std::memory_order_relaxed);
+            const uint64_t payload = slot.payload.load(std::memory_order_relaxed);
+            event.name = slot.name.load(std::memory_order_relaxed);
+            event.category = static_cast<TraceCategory>(kind & 0xFF);
+            event.phase = static_cast<TracePhase>(kind >> 8);
+            event.start = slot.start.load(std::memory_order_relaxed);
+            if (event.phase == TracePhase::Counter) {
+                std::memcpy(&event.value, &payload, sizeof payload);
+            } else {
+                event.duration = payload;
+            }
+        }
+
+        // The slot of every event from `started - kCapacity` on is intact:
+        // only older ones can have been overwritten while being copied.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t started = ring.started.load(std::memory_order_relaxed);
+        const uint64_t intact = started > kCapacity ? started - kCapacity : 0;
+        if (intact > begin) {
+            const auto torn = static_cast<std::ptrdiff_t>(std::min(intact, end) - begin);
+            thread.events.erase(thread.events.begin(), thread.events.begin() + torn);
+        }
+        for (TraceEvent& event : thread.events) event.start = event.start > s.epoch ? event.start - s.epoch : 0;
+    }
+
+    std::lock_guard<std::mutex> guard(s.lock);
+    for (std::size_t r = 0; r < count; ++r) {
+        threads[r].name = rings[r].name.empty() ? "thread " + std::to_string(r + 1) : rings[r].name;
+    }
+    return threads;
+}
+
+std::string Tracer::chromeJson() {
+    const std::vector<TraceThread> threads = snapshot();
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    const auto separate = [&] {
+        if (!first) out += ",\n";
+        first = false;
+    };
+    for (const TraceThread& thread : threads) {
+        const std::string tid = std::to_string(thread.id);
+        separate();
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":";
+        appendString(out, thread.name.c_str());
+        out += "}}";
+        for (const TraceEvent& event : thread.events) {
+            separate();
+            out += "{\"name\":";
+            appendString(out, event.name ? event.name : "");
+            out += ",\"cat\":\"";
+            out += categoryName(event.category);
+            out += "\",\"ts\":";
+            appendMicroseconds(out, event.start);
+            if (event.phase == TracePhase::Complete) {
+                out += ",\"ph\":\"X\",\"dur\":";
+                appendMicroseconds(out, event.duration);
+                out += ",\"pid\":1,\"tid\":" + tid + "}";
+            } else {
+                char value[32];
+                std::snprintf(value, sizeof value, "%.17g", event.value);
+                out += ",\"ph\":\"C\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"value\":";
+                out += value;
+                out += "}}";
+            }
+        }
+    }
+    out += "]}\n";
+    return out;
+}
+
+bool Tracer::exportChromeJson(const std::string& path) {
+    const std::string json = chromeJson();
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    const bool ok = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+void Tracer::clear() noexcept {
+    State& s = state();
+    Ring* rings = s.ready.load(std::memory_order_acquire);
+    if (!rings) return;
+    const std::size_t count = claimedRings();
+    for (std::size_t r = 0; r < count; ++r) {
+        rings[r].cleared.store(rings[r].written.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+    s.untracked.store(0, std::memory_order_relaxed);
+}
+
+TraceMetrics Tracer::metrics() noexcept {
+    State& s = state();
+    TraceMetrics metrics;
+    metrics.untracked = s.untracked.load(std::memory_order_relaxed);
+    Ring* rings = s.ready.load(std::memory_order_acquire);
+    if (!rings) return metrics;
+    const std::size_t count = claimedRings();
+    for (std::size_t r = 0; r < count; ++r) {
+        const uint64_t written = rings[r].written.load(std::memory_order_acquire);
+        const uint64_t recorded = written - std::min(written, rings[r].cleared.load(std::memory_order_relaxed));
+        metrics.recorded += recorded;
+        metrics.overwritten += recorded > kCapacity ? recorded - kCapacity : 0;
+    }
+    return metrics;
+}
+
+} // namespace sleepster
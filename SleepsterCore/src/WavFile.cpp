@@ -0,0 +1,233 @@
+//
+//  WavFile.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/WavFile.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace sleepster {
+
+namespace {
+
+uint16_t readU16(const uint8_t* p) noexcept {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t readU32(const uint8_t* p) noexcept {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void putU16(std::vector<uint8_t>& out, uint16_t v) {
+    out.push_back(static_cast<uint8_t>(v));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+void putU32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+constexpr uint16_t kFormatPcm = 1;
+constexpr uint16_t kFormatFloat = 3;
+constexpr uint16_t kFormatExtensible = 0xFFFE;
+
+} // namespace
+
+uint32_t WavFormat::bytesPerFrame() const noexcept {
+    switch (encoding) {
+    case Encoding::Pcm16: return 2 * channelCount;
+    case Encoding::Pcm24: return 3 * channelCount;
+    case Encoding::Float32: return 4 * channelCount;
+    }
+    return 0;
+}
+
+bool WavFormat::parse(const uint8_t* bytes, std::size_t size, WavFormat& out) {
+    if (size < 12 || std::memcmp(bytes, "RIFF", 4) != 0 || std::memcmp(bytes + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    bool haveFormat = false;
+    std::size_t offset = 12;
+    while (offset + 8 <= size) {
+        const uint8_t* chunk = bytes + offset;
+        const uint32_t chunkSize = readU32(chunk + 4);
+        const std::size_t body = offset + 8;
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16 && body + 16 <= size) {
+            uint16_t tag = readU16(bytes + body);
+            const uint16_t channels = readU16(bytes + body + 2);
+            const uint32_t rate = readU32(bytes + body + 4);
+            const uint16_t bits = readU16(bytes + body + 14);
+            if (tag == kFormatExtensible && chunkSize >= 40 && body + 26 <= size) {
+                tag = readU16(bytes + body + 24);
+            }
+            if (tag == kFormatPcm && bits == 16) {
+                out.encoding = Encoding::Pcm16;
+            } else if (tag == kFormatPcm && bits == 24) {
+                out.encoding = Encoding::Pcm24;
+            } else if (tag == kFormatFloat && bits == 32) {
+                out.encoding = Encoding::Float32;
+            } else {
+                return false;
+            }
+            if (channels == 0 || rate == 0) return false;
+            out.channelCount = channels;
+            out.sampleRate = rate;
+            haveFormat = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0 && haveFormat) {
+            out.dataOffset = body;
+            // Streams written without a final size report 0 or 0xFFFFFFFF.
+            const std::size_t remaining = size - body;
+            out.dataSize = (chunkSize == 0 || chunkSize > remaining) ? remaining : chunkSize;
+            out.frameCount = out.dataSize / out.bytesPerFrame();
+            return true;
+        }
+
+        // Chunks are padded to even sizes.
+        offset = body + chunkSize + (chunkSize & 1u);
+    }
+    return false;
+}
+
+std::unique_ptr<WavDecoder> WavDecoder::open(const std::string& path) {
+    MappedFile file;
+    if (!file.open(path)) return nullptr;
+
+    WavFormat format;
+    if (!WavFormat::parse(file.data(), file.size(), format)) return nullptr;
+
+    file.adviseSequential(format.dataOffset, format.dataSize);
+    return std::unique_ptr<WavDecoder>(new WavDecoder(std::move(file), format));
+}
+
+WavDecoder::WavDecoder(MappedFile file, const WavFormat& format)
+    : file_(std::move(file)), format_(format) {}
+
+std::size_t WavDecoder::decode(float* left, float* right, std::size_t frames) {
+    const uint64_t remaining = format_.frameCount - cursor_;
+    const std::size_t count = static_cast<std::size_t>(std::min<uint64_t>(frames, remaining));
+    if (count == 0) return 0;
+
+    const uint32_t channels = format_.channelCount;
+    const uint32_t stride = format_.bytesPerFrame();
+    const uint8_t* src = file_.data() + format_.dataOffset + cursor_ * stride;
+    // Channel 1 is the right channel; extra channels beyond stereo are ignored.
+    const uint32_t rightChannel = channels > 1 ? 1 : 0;
+
+    switch (format_.encoding) {
+    case WavFormat::Encoding::Pcm16: {
+        constexpr float kScale = 1.0f / 32768.0f;
+        for (std::size_t i = 0; i < count; ++i, src += stride) {
+            left[i] = static_cast<int16_t>(readU16(src)) * kScale;
+            right[i] = static_cast<int16_t>(readU16(src + 2 * rightChannel)) * kScale;
+        }
+        break;
+    }
+    case WavFormat::Encoding::Pcm24: {
+        constexpr float kScale = 1.0f / 8388608.0f;
+        auto sample = [](const uint8_t* p) {
+            const int32_t v = static_cast<int32_t>(static_cast<uint32_t>(p[0]) << 8 |
+                                                   static_cast<uint32_t>(p[1]) << 16 |
+                                                   static_cast<uint32_t>(p[2]) << 24);
+            return v >> 8;
+        };
+        for (std::size_t i = 0; i < count; ++i, src += stride) {
+            left[i] = sample(src) * kScale;
+            right[i] = sample(src + 3 * rightChannel) * kScale;
+        }
+        break;
+    }
+    case WavFormat::Encoding::Float32:
+        for (std::size_t i = 0; i < count; ++i, src += stride) {
+            std::memcpy(&left[i], src, sizeof(float));
+            std::memcpy(&right[i], src + 4 * rightChannel, sizeof(float));
+        }
+        break;
+    }
+
+    cursor_ += count;
+    releaseConsumedPages(cursor_);
+    return count;
+}
+
+bool WavDecoder::seek(uint64_t frame) {
+    // Looping rewinds to the start; drop everything read so far.
+    releaseConsumedPages(format_.frameCount);
+    cursor_ = std::min(frame, format_.frameCount);
+    releasedUpTo_ = 0;
+    return true;
+}
+
+void WavDecoder::releaseConsumedPages(uint64_t upToFrame) noexcept {
+    // Batch the madvise calls: one per megabyte of consumed data.
+    constexpr std::size_t kReleaseBytes = 1u << 20;
+    const uint32_t stride = format_.bytesPerFrame();
+    if ((upToFrame - releasedUpTo_) * stride < kReleaseBytes && upToFrame < format_.frameCount) return;
+    file_.release(format_.dataOffset + releasedUpTo_ * stride, (upToFrame - releasedUpTo_) * stride);
+    releasedUpTo_ = upToFrame;
+}
+
+bool writeWav(const std::string& path, const float* const* channels, uint32_t channelCount,
+              uint64_t frameCount, double sampleRate, WavFormat::Encoding encoding) {
+    if (channelCount == 0 || channelCount > 2 || encoding == WavFormat::Encoding::Pcm24) return false;
+
+    const bool isFloat = encoding == WavFormat::Encoding::Float32;
+    const uint16_t bits = isFloat ? 32 : 16;
+    const uint32_t blockAlign = channelCount * bits / 8;
+    const uint64_t dataBytes = frameCount * blockAlign;
+    if (dataBytes > 0xFFFFFFFFull - 36) return false;
+
+    std::vector<uint8_t> header;
+    header.reserve(44);
+    header.insert(header.end(), {'R', 'I', 'F', 'F'});
+    putU32(header, static_cast<uint32_t>(36 + dataBytes));
+    header.insert(header.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+    putU32(header, 16);
+    putU16(header, isFloat ? kFormatFloat : kFormatPcm);
+    putU16(header, static_cast<uint16_t>(channelCount));
+    putU32(header, static_cast<uint32_t>(std::lround(sampleRate)));
+    putU32(header, static_cast<uint32_t>(std::lround(sampleRate)) * blockAlign);
+    putU16(header, static_cast<uint16_t>(blockAlign));
+    putU16(header, bits);
+    header.insert(header.end(), {'d', 'a', 't', 'a'});
+    putU32(header, static_cast<uint32_t>(dataBytes));
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    bool ok = std::fwrite(header.data(), 1, header.size(), file) == header.size();
+
+    constexpr std::size_t kBlock = 4096;
+    std::vector<uint8_t> block(kBlock * blockAlign);
+    for (uint64_t start = 0; ok && start < frameCount; start += kBlock) {
+        const std::size_t count = static_cast<std::size_t>(std::min<uint64_t>(kBlock, frameCount - start));
+        uint8_t* dst = block.data();
+        for (std::size_t i = 0; i < count; ++i) {
+            for (uint32_t c = 0; c < channelCount; ++c) {
+                const float sample = channels[c][start + i];
+                if (isFloat) {
+                    std::memcpy(dst, &sample, 4);
+                    dst += 4;
+                } else {
+                    const float clamped = std::max(-1.0f, std::min(1.0f, sample));
+                    const int16_t v = static_cast<int16_t>(std::lround(clamped * 32767.0f));
+                    dst[0] = static_cast<uint8_t>(v);
+                    dst[1] = static_cast<uint8_t>(static_cast<uint16_t>(v) >> 8);
+                    dst += 2;
+                }
+            }
+        }
+        const std::size_t bytes = count * blockAlign;
+        ok = std::fwrite(block.data(), 1, bytes, file) == bytes;
+    }
+
+    return std::fclose(file) == 0 && ok;
+}
+
+} // namespace sleepster
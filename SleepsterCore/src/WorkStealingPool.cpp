@@ -0,0 +1,105 @@
+//
+//  WorkStealingPool.cpp
+//  SleepsterCore
+//
+
+#include "sleepster/WorkStealingPool.hpp"
+
+#include "sleepster/Trace.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace sleepster {
+
+namespace {
+
+thread_local const WorkStealingPool* tPool = nullptr;
+thread_local int tWorker = -1;
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(std::size_t threads) {
+    if (threads == 0) {
+        const unsigned cores = std::thread::hardware_concurrency();
+        threads = cores > 1 ? cores - 1 : 1;
+    }
+    workers_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) workers_.push_back(std::make_unique<Worker>());
+    // Started only once every queue exists, since workers steal from all.
+    for (std::size_t i = 0; i < threads; ++i) workers_[i]->thread = std::thread([this, i] { run(i); });
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> guard(sleepLock_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (const auto& worker : workers_) worker->thread.join();
+}
+
+void WorkStealingPool::submit(Job job) {
+    const int own = currentWorker();
+    const std::size_t index = own >= 0
+        ? static_cast<std::size_t>(own)
+        : nextQueue_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+    {
+        std::lock_guard<std::mutex> guard(workers_[index]->lock);
+        workers_[index]->jobs.push_back(std::move(job));
+    }
+    pending_.fetch_add(1, std::memory_order_release);
+    // Taking the lock orders this wake after a worker's last look at
+    // pending_, so it cannot be missed.
+    std::lock_guard<std::mutex> guard(sleepLock_);
+    wake_.notify_one();
+}
+
+int WorkStealingPool::currentWorker() const noexcept {
+    return tPool == this ? tWorker : -1;
+}
+
+void WorkStealingPool::run(std::size_t index) {
+    tPool = this;
+    tWorker = static_cast<int>(index);
+    Tracer::setThreadName(("pool worker " + std::to_string(index)).c_str());
+
+    Job job;
+    for (;;) {
+        if (take(index, job)) {
+            job();
+            job = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepLock_);
+        wake_.wait(lock, [this] { return stopping_ || pending_.load(std::memory_order_acquire) > 0; });
+        if (stopping_ && pending_.load(std::memory_order_acquire) == 0) return;
+    }
+}
+
+bool WorkStealingPool::take(std::size_t index, Job& job) {
+    {
+        Worker& own = *workers_[index];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    for (std::size_t k = 1; k < workers_.size(); ++k) {
+        Worker& victim = *workers_[(index + k) % workers_.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace sleepster
@@ -0,0 +1,306 @@
+//
+//  AnalyticsTests.cpp
+//  SleepsterCore
+//
+
+#include "TestHarness.hpp"
+
+#include "SLPAnalytics.h"
+#include "sleepster/Analytics.hpp"
+#include "sleepster/MpscQueue.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace sleepster;
+
+namespace {
+
+/// Keeps copies of everything it is given.
+class MemorySink : public AnalyticsSink {
+public:
+    struct Shared {
+        std::vector<AnalyticsRecord> records;
+        std::vector<AnalyticsTiming> timings;
+        uint64_t dropped = 0;
+        int batches = 0;
+    };
+
+    explicit MemorySink(Shared& shared) : shared_(shared) {}
+
+    bool write(const AnalyticsBatch& batch) override {
+        shared_.records.insert(shared_.records.end(), batch.records, batch.records + batch.recordCount);
+        shared_.timings.insert(shared_.timings.end(), batch.timings, batch.timings + batch.timingCount);
+        shared_.dropped += batch.dropped;
+        ++shared_.batches;
+        return true;
+    }
+
+private:
+    Shared& shared_;
+};
+
+/// A flusher that only runs when asked to.
+AnalyticsConfig quietConfig(std::size_t capacity) {
+    AnalyticsConfig config;
+    config.capacity = capacity;
+    config.flushIntervalSeconds = 3600.0;
+    return config;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path);
+    std::stringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+} // namespace
+
+SLP_TEST(mpscQueueKeepsEachProducersOrder) {
+    constexpr int kProducers = 4;
+    constexpr uint64_t kEach = 50000;
+    MpscQueue<uint64_t> queue(64);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (uint64_t i = 0; i < kEach; ++i) {
+                while (!queue.tryPush((static_cast<uint64_t>(p) << 32) | i)) std::this_thread::yield();
+            }
+        });
+    }
+
+    std::vector<uint64_t> next(kProducers, 0);
+    bool ordered = true;
+    for (uint64_t received = 0; received < kProducers * kEach;) {
+        uint64_t value = 0;
+        if (!queue.tryPop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        const auto producer = static_cast<std::size_t>(value >> 32);
+        ordered = ordered && (value & 0xFFFFFFFFu) == next[producer];
+        ++next[producer];
+        ++received;
+    }
+    for (std::thread& producer : producers) producer.join();
+    SLP_CHECK(ordered);
+    uint64_t value = 0;
+    SLP_CHECK(!queue.tryPop(value));
+}
+
+SLP_TEST(mpscPushFailsWhenFull) {
+    MpscQueue<int> queue(3);
+    SLP_CHECK_EQ(queue.capacity(), 4u);
+    std::size_t position = 0;
+    for (int i = 0; i < 4; ++i) {
+        SLP_CHECK(queue.tryPush(i, position));
+        SLP_CHECK_EQ(position, static_cast<std::size_t>(i));
+    }
+    SLP_CHECK(!queue.tryPush(99));
+    int value = -1;
+    SLP_CHECK(queue.tryPop(value));
+    SLP_CHECK_EQ(value, 0);
+    SLP_CHECK(queue.tryPush(4, position));
+    SLP_CHECK_EQ(position, 4u);
+    SLP_CHECK_EQ(queue.sizeApprox(), 4u);
+}
+
+SLP_TEST(namesAreInternedOnce) {
+    AnalyticsNames names(3);
+    const AnalyticsName play = names.intern("play");
+    SLP_CHECK_EQ(names.intern("play"), play);
+    const AnalyticsName stop = names.intern("stop");
+    SLP_CHECK(stop != play);
+    SLP_CHECK(names.name(stop) == "stop");
+    SLP_CHECK_EQ(names.intern(""), kNoAnalyticsName);
+    SLP_CHECK(names.intern("pause") != kNoAnalyticsName);
+    SLP_CHECK_EQ(names.intern("rewind"), kNoAnalyticsName);
+    SLP_CHECK(names.name(kNoAnalyticsName).empty());
+    SLP_CHECK_EQ(names.size(), 3u);
+}
+
+SLP_TEST(eventsReachTheSinkInOrderWithTheirParameters) {
+    MemorySink::Shared seen;
+    AnalyticsPipeline pipeline(std::make_unique<MemorySink>(seen), quietConfig(64));
+    const AnalyticsName play = pipeline.intern("sound_played");
+    const AnalyticsName voices = pipeline.intern("voices");
+    const AnalyticsName volume = pipeline.intern("volume");
+    const AnalyticsName sound = pipeline.intern("sound");
+    const AnalyticsName rain = pipeline.intern("rain");
+
+    const AnalyticsParameter parameters[] = {
+        AnalyticsParameter::of(voices, int64_t{3}),
+        AnalyticsParameter::of(volume, 0.5),
+        AnalyticsParameter::named(sound, rain),
+        AnalyticsParameter::of(voices, int64_t{4}),
+    };
+    SLP_CHECK(pipeline.logEvent(play, parameters, 4));
+    SLP_CHECK(pipeline.logEvent(play));
+    SLP_CHECK(pipeline.logError(pipeline.intern("decode_failed"), kNoAnalyticsName));
+    SLP_CHECK(!pipeline.logEvent(kNoAnalyticsName));
+    pipeline.flush();
+
+    SLP_CHECK_EQ(seen.records.size(), 3u);
+    const AnalyticsRecord& first = seen.records[0];
+    SLP_CHECK_EQ(first.name, play);
+    SLP_CHECK_EQ(first.parameterCount, 3);
+    SLP_CHECK_EQ(first.parameters[0].integer, 3);
+    SLP_CHECK_EQ(first.parameters[1].number, 0.5);
+    SLP_CHECK_EQ(first.parameters[2].name, rain);
+    SLP_CHECK(seen.records[1].time >= first.time);
+    SLP_CHECK(seen.records[2].kind == AnalyticsKind::Error);
+    SLP_CHECK_EQ(pipeline.metrics().written, 3u);
+}
+
+SLP_TEST(timedEventsAreFoldedPerEvent) {
+    MemorySink::Shared seen;
+    AnalyticsPipeline pipeline(std::make_unique<MemorySink>(seen), quietConfig(64));
+    const AnalyticsName mix = pipeline.intern("mix_playing");
+    const AnalyticsName voices = pipeline.intern("voices");
+
+    // An end without a start is ignored.
+    SLP_CHECK(pipeline.endTimedEvent(mix));
+    const AnalyticsParameter started = AnalyticsParameter::of(voices, int64_t{2});
+    const AnalyticsParameter ended = AnalyticsParameter::of(voices, int64_t{5});
+    pipeline.beginTimedEvent(mix, &started, 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    pipeline.endTimedEvent(mix);
+    pipeline.beginTimedEvent(mix, &started, 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    pipeline.endTimedEvent(mix, &ended, 1);
+    pipeline.flush();
+
+    SLP_CHECK(seen.records.empty());
+    SLP_CHECK_EQ(seen.timings.size(), 1u);
+    const AnalyticsTiming& timing = seen.timings[0];
+    SLP_CHECK_EQ(timing.event, mix);
+    SLP_CHECK_EQ(timing.count, 2u);
+    SLP_CHECK(timing.minSeconds >= 0.002 && timing.maxSeconds >= 0.02);
+    SLP_CHECK_NEAR(timing.totalSeconds, timing.minSeconds + timing.maxSeconds, 1e-9);
+    SLP_CHECK_EQ(timing.parameterCount, 1);
+    SLP_CHECK_EQ(timing.parameters[0].integer, 5);
+    SLP_CHECK_EQ(pipeline.metrics().written, 2u);
+
+    // Runs still open wait for their end; finished ones are not repeated.
+    pipeline.beginTimedEvent(mix);
+    pipeline.flush();
+    SLP_CHECK_EQ(seen.timings.size(), 1u);
+    pipeline.endTimedEvent(mix);
+    pipeline.flush();
+    SLP_CHECK_EQ(seen.timings.size(), 2u);
+    SLP_CHECK_EQ(seen.timings[1].count, 1u);
+    SLP_CHECK_EQ(seen.timings[1].parameterCount, 0);
+}
+
+SLP_TEST(aFullRingDropsAndCountsEvents) {
+    MemorySink::Shared seen;
+    uint64_t accepted = 0;
+    {
+        AnalyticsPipeline pipeline(std::make_unique<MemorySink>(seen), quietConfig(8));
+        const AnalyticsName tick = pipeline.intern("tick");
+        for (int i = 0; i < 100; ++i) accepted += pipeline.logEvent(tick) ? 1 : 0;
+        pipeline.flush();
+        const AnalyticsMetrics metrics = pipeline.metrics();
+        SLP_CHECK_EQ(accepted + metrics.dropped, 100u);
+        SLP_CHECK(metrics.dropped > 0);
+        SLP_CHECK_EQ(seen.dropped, metrics.dropped);
+
+        // Turned off, nothing is queued or counted.
+        pipeline.setEnabled(false);
+        SLP_CHECK(!pipeline.logEvent(tick));
+        SLP_CHECK_EQ(pipeline.metrics().dropped, metrics.dropped);
+    }
+    SLP_CHECK_EQ(seen.records.size(), accepted);
+}
+
+SLP_TEST(concurrentProducersReachTheSinkInTheirOwnOrder) {
+    constexpr int kProducers = 4;
+    constexpr int kEach = 20000;
+    MemorySink::Shared seen;
+    uint64_t dropped = 0;
+    {
+        AnalyticsConfig config;
+        config.capacity = 1024;
+        AnalyticsPipeline pipeline(std::make_unique<MemorySink>(seen), config);
+        const AnalyticsName event = pipeline.intern("event");
+        const AnalyticsName sequence = pipeline.intern("sequence");
+        std::vector<std::thread> producers;
+        for (int p = 0; p < kProducers; ++p) {
+            producers.emplace_back([&, p] {
+                for (int i = 0; i < kEach; ++i) {
+                    const AnalyticsParameter parameter =
+                        AnalyticsParameter::of(sequence, static_cast<int64_t>(p) * kEach + i);
+                    while (!pipeline.logEvent(event, &parameter, 1)) std::this_thread::yield();
+                }
+            });
+        }
+        for (std::thread& producer : producers) producer.join();
+        pipeline.flush();
+        dropped = pipeline.metrics().dropped;
+    }
+
+    SLP_CHECK_EQ(seen.records.size(), static_cast<std::size_t>(kProducers * kEach));
+    std::vector<int64_t> last(kProducers, -1);
+    bool ordered = true;
+    for (const AnalyticsRecord& record : seen.records) {
+        const int64_t value = record.parameters[0].integer;
+        const auto producer = static_cast<std::size_t>(value / kEach);
+        ordered = ordered && value > last[producer];
+        last[producer] = value;
+    }
+    SLP_CHECK(ordered);
+    SLP_CHECK_EQ(seen.dropped, dropped);
+    // The flusher woke on its own as the ring filled, in batches.
+    SLP_CHECK(seen.batches > 1);
+}
+
+SLP_TEST(cInterfaceAppendsJsonLines) {
+    const std::string path = "/tmp/sleepster_analytics.jsonl";
+    std::remove(path.c_str());
+    SLPAnalytics* analytics = SLPAnalyticsCreate(path.c_str(), 64, 3600.0);
+    SLP_CHECK(analytics != nullptr);
+
+    const SLPAnalyticsName played = SLPAnalyticsIntern(analytics, "sound_played");
+    const SLPAnalyticsName sound = SLPAnalyticsIntern(analytics, "sound");
+    const SLPAnalyticsName rain = SLPAnalyticsIntern(analytics, "heavy \"rain\"");
+    const SLPAnalyticsName volume = SLPAnalyticsIntern(analytics, "volume");
+    SLP_CHECK_EQ(SLPAnalyticsIntern(analytics, "sound_played"), played);
+
+    SLPAnalyticsParameter parameters[2] = {};
+    parameters[0].key = sound;
+    parameters[0].type = SLPAnalyticsValueName;
+    parameters[0].name = rain;
+    parameters[1].key = volume;
+    parameters[1].type = SLPAnalyticsValueNumber;
+    parameters[1].number = 0.25;
+    SLP_CHECK(SLPAnalyticsLogEvent(analytics, played, parameters, 2));
+    const SLPAnalyticsName tracking = SLPAnalyticsIntern(analytics, "sleep_tracking");
+    SLP_CHECK(SLPAnalyticsBeginTimedEvent(analytics, tracking, nullptr, 0));
+    SLP_CHECK(SLPAnalyticsEndTimedEvent(analytics, tracking, nullptr, 0));
+    SLP_CHECK(SLPAnalyticsLogError(analytics, SLPAnalyticsIntern(analytics, "decode_failed"),
+                                   SLPAnalyticsIntern(analytics, "bad header")));
+    SLPAnalyticsFlush(analytics);
+    SLP_CHECK_EQ(SLPAnalyticsGetMetrics(analytics).written, 3u);
+
+    // Destroying writes the rest.
+    SLP_CHECK(SLPAnalyticsLogEvent(analytics, played, nullptr, 0));
+    SLPAnalyticsDestroy(analytics);
+
+    const std::string text = readFile(path);
+    SLP_CHECK(text.find("\"event\":\"sound_played\",\"params\":{\"sound\":\"heavy \\\"rain\\\"\",\"volume\":0.25}}\n") !=
+              std::string::npos);
+    SLP_CHECK(text.find("\"timed\":\"sleep_tracking\",\"count\":1,") != std::string::npos);
+    SLP_CHECK(text.find("\"error\":\"decode_failed\",\"params\":{\"message\":\"bad header\"}}") != std::string::npos);
+    std::size_t lines = 0;
+    for (char c : text) lines += c == '\n' ? 1 : 0;
+    SLP_CHECK_EQ(lines, 4u);
+    std::remove(path.c_str());
+
+    SLP_CHECK(SLPAnalyticsCreate("/nonexistent/dir/analytics.jsonl", 64, 1.0) == nullptr);
+}
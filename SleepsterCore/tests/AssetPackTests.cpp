@@ -0,0 +1,266 @@
+//
+//  AssetPackTests.cpp
+//  SleepsterCore
+//
+
+#include "TestHarness.hpp"
+
+#include "sleepster/AssetPack.hpp"
+#include "sleepster/AssetPackWriter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace sleepster;
+
+namespace {
+
+constexpr double kRate = 48000.0;
+
+std::string tempPath(const char* name) {
+    return std::string("/tmp/sleepster_") + name;
+}
+
+PcmBuffer sine(double frequency, float amplitude, double rate, std::size_t frames, uint32_t channels,
+               std::size_t leadingSilence = 0) {
+    PcmBuffer buffer;
+    buffer.sampleRate = rate;
+    buffer.frameCount = frames + leadingSilence;
+    buffer.channels.assign(channels, std::vector<float>(buffer.frameCount, 0.0f));
+    for (uint32_t c = 0; c < channels; ++c) {
+        for (std::size_t i = 0; i < frames; ++i) {
+            // The right channel is a quarter turn ahead, to tell them apart.
+            const double phase = 2.0 * M_PI * frequency * double(i) / rate + c * M_PI / 2.0;
+            buffer.channels[c][leadingSilence + i] = amplitude * static_cast<float>(std::sin(phase));
+        }
+    }
+    return buffer;
+}
+
+EncodedAsset encode(const std::string& name, const PcmBuffer& buffer) {
+    EncodedAsset asset;
+    SLP_CHECK(encodeAsset(name, buffer, AssetPackOptions{}, asset));
+    return asset;
+}
+
+std::vector<float> play(AudioSource& source, std::size_t frames, std::vector<float>* right = nullptr) {
+    std::vector<float> left(frames), r(frames);
+    constexpr std::size_t kBlock = 509;
+    std::size_t produced = 0;
+    while (produced < frames) {
+        const std::size_t n = source.render(left.data() + produced, r.data() + produced,
+                                            std::min(kBlock, frames - produced));
+        if (n == 0) break;
+        produced += n;
+    }
+    left.resize(produced);
+    r.resize(produced);
+    if (right) *right = r;
+    return left;
+}
+
+} // namespace
+
+SLP_TEST(packRoundTripsSoundsAndPlaysThemInPlace) {
+    const std::string path = tempPath("roundtrip.slpk");
+    std::vector<EncodedAsset> assets;
+    assets.push_back(encode("rain", sine(440.0, 0.5f, kRate, 9000, 2)));
+    assets.push_back(encode("bell", sine(880.0, 0.25f, kRate, 5000, 1)));
+    SLP_CHECK(writeAssetPack(path, assets, kRate));
+
+    auto pack = AssetPack::open(path);
+    SLP_CHECK(pack != nullptr);
+    if (!pack) return;
+    SLP_CHECK_EQ(pack->size(), std::size_t(2));
+    // Sorted by name on disk.
+    SLP_CHECK(pack->nameAt(0) == "bell");
+    SLP_CHECK(pack->find("wind") == nullptr);
+
+    const AssetView* rain = pack->find("rain");
+    SLP_CHECK(rain != nullptr);
+    if (!rain) return;
+    SLP_CHECK_EQ(rain->channelCount, 2u);
+    SLP_CHECK_EQ(rain->frameCount, assets[0].frameCount);
+    SLP_CHECK_EQ(rain->sampleRate, kRate);
+    SLP_CHECK(std::equal(assets[0].samples.begin(), assets[0].samples.end(), rain->samples));
+    // Zero-copy: every lookup hands out the same pointer into the mapping.
+    SLP_CHECK(pack->find("rain")->samples == rain->samples);
+
+    PackedSource source(pack, *rain, false);
+    source.prepare(kRate, 512);
+    std::vector<float> right;
+    const std::vector<float> left = play(source, 20000, &right);
+    SLP_CHECK_EQ(left.size(), std::size_t(rain->frameCount));
+    for (std::size_t i = 0; i < left.size(); ++i) {
+        SLP_CHECK_EQ(left[i], rain->samples[2 * i] / 32768.0f);
+        SLP_CHECK_EQ(right[i], rain->samples[2 * i + 1] / 32768.0f);
+    }
+
+    const AssetView* bell = pack->find("bell");
+    PackedSource mono(pack, *bell, false);
+    mono.prepare(kRate, 512);
+    const std::vector<float> bellLeft = play(mono, 20000, &right);
+    SLP_CHECK(bellLeft == right);
+    SLP_CHECK_NEAR(*std::max_element(bellLeft.begin(), bellLeft.end()), 0.25f, 1e-3f);
+
+    pack.reset();
+    std::remove(path.c_str());
+}
+
+SLP_TEST(encodingTrimsPaddingAndFindsASeamlessLoop) {
+    // 1234.5 Hz never lines up with the buffer length, so wrapping at the
+    // very end would click.
+    const PcmBuffer buffer = sine(1234.5, 0.5f, kRate, 30011, 2, 1105);
+    const EncodedAsset asset = encode("tone", buffer);
+    // The encoder-style leading silence is gone; the first sample of a sine
+    // at phase zero quantises to silence too.
+    SLP_CHECK(asset.frameCount <= 30011 && asset.frameCount >= 30009);
+    SLP_CHECK(asset.loopEnd < asset.frameCount);
+    SLP_CHECK(asset.loopEnd > asset.frameCount - 64 - 2400 - 1);
+
+    const std::string path = tempPath("loop.slpk");
+    SLP_CHECK(writeAssetPack(path, {asset}, kRate));
+    auto pack = AssetPack::open(path);
+    SLP_CHECK(pack != nullptr);
+    if (!pack) return;
+    PackedSource source(pack, *pack->find("tone"), true);
+    source.prepare(kRate, 512);
+    const std::vector<float> out = play(source, 3 * asset.frameCount);
+    SLP_CHECK_EQ(out.size(), std::size_t(3 * asset.frameCount));
+
+    // The steepest step of the sine itself, plus dither.
+    const float bound = 0.5f * static_cast<float>(2.0 * M_PI * 1234.5 / kRate) + 3.0f / 32768.0f;
+    float largest = 0.0f;
+    for (std::size_t i = 1; i < out.size(); ++i) largest = std::max(largest, std::fabs(out[i] - out[i - 1]));
+    SLP_CHECK(largest <= bound * 1.05f);
+    pack.reset();
+    std::remove(path.c_str());
+}
+
+SLP_TEST(loudnessMatchesTheReferenceSine) {
+    // BS.1770: a 1 kHz sine at full scale in both channels reads 0 LUFS.
+    const PcmBuffer buffer = sine(1000.0, 0.5f, kRate, 48000 * 3, 2);
+    const float* channels[] = {buffer.channels[0].data(), buffer.channels[1].data()};
+    SLP_CHECK_NEAR(integratedLoudness(channels, 2, buffer.frameCount, kRate), -6.02, 0.1);
+    // At 44.1 kHz too, since the filters are designed per rate.
+    const PcmBuffer other = sine(1000.0, 0.5f, 44100.0, 44100 * 3, 1);
+    const float* mono[] = {other.channels[0].data()};
+    SLP_CHECK_NEAR(integratedLoudness(mono, 1, other.frameCount, 44100.0), -9.03, 0.1);
+
+    // The gate ignores near-silence, so a quiet tail does not halve it (-3 dB);
+    // only the few blocks straddling the end of the tone count partially.
+    PcmBuffer gated = sine(1000.0, 0.5f, kRate, 48000 * 3, 2);
+    for (std::vector<float>& channel : gated.channels) channel.resize(48000 * 6, 1e-5f);
+    const float* padded[] = {gated.channels[0].data(), gated.channels[1].data()};
+    SLP_CHECK_NEAR(integratedLoudness(padded, 2, 48000 * 6, kRate), -6.02, 0.3);
+
+    std::vector<float> silence(48000, 0.0f);
+    const float* silent[] = {silence.data()};
+    SLP_CHECK_EQ(integratedLoudness(silent, 1, silence.size(), kRate), -70.0);
+}
+
+SLP_TEST(resamplingKeepsPitchAndLevel) {
+    const PcmBuffer buffer = sine(1000.0, 0.5f, 44100.0, 44100, 1);
+    const std::vector<float> out = resampleOffline(buffer.channels[0], 44100.0, kRate);
+    SLP_CHECK_EQ(out.size(), std::size_t(48000));
+    float error = 0.0f;
+    // Away from the edges, where the kernel runs off the input.
+    for (std::size_t i = 1000; i + 1000 < out.size(); ++i) {
+        const float expected = 0.5f * static_cast<float>(std::sin(2.0 * M_PI * 1000.0 * double(i) / kRate));
+        error = std::max(error, std::fabs(out[i] - expected));
+    }
+    SLP_CHECK(error < 1e-3f);
+}
+
+SLP_TEST(packedSourceResamplesAndLoopsAtAnotherRate) {
+    const std::string path = tempPath("rate.slpk");
+    SLP_CHECK(writeAssetPack(path, {encode("hum", sine(100.0, 0.5f, kRate, 4800, 2))}, kRate));
+    auto pack = AssetPack::open(path);
+    SLP_CHECK(pack != nullptr);
+    if (!pack) return;
+    const AssetView& view = *pack->find("hum");
+
+    PackedSource once(pack, view, false);
+    once.prepare(44100.0, 512);
+    const std::size_t expected = static_cast<std::size_t>(std::ceil(view.frameCount * 44100.0 / kRate));
+    SLP_CHECK(std::abs(static_cast<long>(play(once, 100000).size()) - static_cast<long>(expected)) <= 1);
+
+    PackedSource looping(pack, view, true);
+    looping.prepare(44100.0, 512);
+    const std::vector<float> out = play(looping, 44100);
+    SLP_CHECK_EQ(out.size(), std::size_t(44100));
+    float largest = 0.0f;
+    for (std::size_t i = 1; i < out.size(); ++i) largest = std::max(largest, std::fabs(out[i] - out[i - 1]));
+    SLP_CHECK(largest < 0.5f * 2.0f * static_cast<float>(M_PI * 100.0 / 44100.0) * 1.1f + 1e-3f);
+    pack.reset();
+    std::remove(path.c_str());
+}
+
+SLP_TEST(packedSourceSeeksIntoItsLoop) {
+    const std::string path = tempPath("seek.slpk");
+    SLP_CHECK(writeAssetPack(path, {encode("tone", sine(1234.5, 0.5f, kRate, 9011, 2, 700))}, kRate));
+    auto pack = AssetPack::open(path);
+    SLP_CHECK(pack != nullptr);
+    if (!pack) return;
+    const AssetView& view = *pack->find("tone");
+
+    // Past the first wrap, both at the pack rate and resampled.
+    for (const double rate : {kRate, 44100.0}) {
+        PackedSource continuous(pack, view, true);
+        PackedSource seeked(pack, view, true);
+        continuous.prepare(rate, 512);
+        seeked.prepare(rate, 512);
+        const std::vector<float> reference = play(continuous, 25000);
+        SLP_CHECK(seeked.seek(21000));
+        const std::vector<float> tail = play(seeked, 4000);
+        for (std::size_t i = 0; i < tail.size(); ++i) SLP_CHECK_NEAR(tail[i], reference[21000 + i], 1e-5f);
+    }
+
+    PackedSource once(pack, view, false);
+    once.prepare(kRate, 512);
+    SLP_CHECK(once.seek(view.frameCount + 10));
+    SLP_CHECK(play(once, 100).empty());
+    pack.reset();
+    std::remove(path.c_str());
+}
+
+SLP_TEST(damagedPacksAreRejected) {
+    const std::string path = tempPath("damaged.slpk");
+    SLP_CHECK(AssetPack::open(tempPath("missing.slpk")) == nullptr);
+    SLP_CHECK(writeAssetPack(path, {encode("rain", sine(440.0, 0.5f, kRate, 9000, 2))}, kRate));
+
+    std::vector<uint8_t> bytes;
+    if (std::FILE* file = std::fopen(path.c_str(), "rb")) {
+        uint8_t chunk[4096];
+        std::size_t n;
+        while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) bytes.insert(bytes.end(), chunk, chunk + n);
+        std::fclose(file);
+    }
+    const auto rewrite = [&](const std::vector<uint8_t>& contents) {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        std::fwrite(contents.data(), 1, contents.size(), file);
+        std::fclose(file);
+        return AssetPack::open(path);
+    };
+    SLP_CHECK(rewrite(bytes) != nullptr);
+
+    std::vector<uint8_t> truncated(bytes.begin(), bytes.end() - 4096);
+    SLP_CHECK(rewrite(truncated) == nullptr);
+
+    std::vector<uint8_t> badMagic = bytes;
+    badMagic[0] = 'X';
+    SLP_CHECK(rewrite(badMagic) == nullptr);
+
+    std::vector<uint8_t> badLoop = bytes;
+    // loopEnd of the first entry beyond its frame count.
+    badLoop[32 + 80] = badLoop[32 + 81] = badLoop[32 + 82] = badLoop[32 + 83] = 0xFF;
+    SLP_CHECK(rewrite(badLoop) == nullptr);
+
+    SLP_CHECK(!writeAssetPack(path, {encode("a", sine(440.0, 0.5f, kRate, 900, 1)),
+                                     encode("a", sine(440.0, 0.5f, kRate, 900, 1))},
+                              kRate));
+    std::remove(path.c_str());
+}
@@ -0,0 +1,369 @@
+//
+//  AutomationTests.cpp
+//  SleepsterCore
+//
+
+#include "TestHarness.hpp"
+
+#include "SLPAutomation.h"
+#include "sleepster/Automation.hpp"
+#include "sleepster/Mixer.hpp"
+#include "sleepster/NoiseSource.hpp"
+#include "sleepster/OfflineRender.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace sleepster;
+
+namespace {
+
+/// Plays 1.0 on both channels, so the output is the gain applied to it.
+class UnitSource final : public AudioSource {
+public:
+    bool seek(uint64_t frame) override { return true; }
+    std::size_t render(float* left, float* right, std::size_t frames) noexcept override {
+        std::fill(left, left + frames, 1.0f);
+        std::fill(right, right + frames, 1.0f);
+        return frames;
+    }
+};
+
+MixerConfig smallConfig() {
+    MixerConfig config;
+    config.sampleRate = 48000.0;
+    config.maxVoices = 4;
+    config.maxBlockFrames = 256;
+    return config;
+}
+
+/// Renders in blocks of an awkward size, so breakpoints fall inside them.
+std::vector<float> renderFrames(Mixer& mixer, std::size_t frames, std::size_t block = 300) {
+    std::vector<float> left(frames), right(frames);
+    for (std::size_t offset = 0; offset < frames; offset += block) {
+        mixer.render(left.data() + offset, right.data() + offset, std::min(block, frames - offset));
+    }
+    return left;
+}
+
+std::size_t firstDifference(const std::vector<float>& a, const std::vector<float>& b) {
+    return static_cast<std::size_t>(std::mismatch(a.begin(), a.end(), b.begin()).first - a.begin());
+}
+
+/// What a lane should be on each frame, worked out the long way round.
+class LaneModel {
+public:
+    LaneModel(const AutomationLane& lane, double sampleRate) {
+        uint64_t previous = 0;
+        float value = 1.0f;
+        for (const Breakpoint& point : lane.points) {
+            const uint64_t frame = automationFrame(point.timeMs, sampleRate);
+            const bool step = point.shape == BreakpointShape::Step;
+            segments_.push_back({step ? frame : previous, frame, value, point.value, curveOf(point.shape)});
+            value = point.value;
+            previous = frame;
+        }
+    }
+
+    /// Frames must be asked for in order.
+    float at(uint64_t frame) noexcept {
+        while (next_ < segments_.size() && segments_[next_].start <= frame) ++next_;
+        if (next_ == 0) return 1.0f;
+        const Segment& s = segments_[next_ - 1];
+        if (frame >= s.end) return s.to;
+        // The first frame of a ramp is already one frame into it.
+        const double t = static_cast<double>(frame - s.start + 1) / static_cast<double>(s.end - s.start);
+        if (s.to >= s.from) return s.from + (s.to - s.from) * rampShape(s.curve, t);
+        return s.to + (s.from - s.to) * rampShape(s.curve, 1.0 - t);
+    }
+
+private:
+    struct Segment {
+        uint64_t start;
+        uint64_t end;
+        float from;
+        float to;
+        RampCurve curve;
+    };
+
+    static RampCurve curveOf(BreakpointShape shape) {
+        if (shape == BreakpointShape::EqualPower) return RampCurve::EqualPower;
+        if (shape == BreakpointShape::Exponential) return RampCurve::Exponential;
+        return RampCurve::Linear;
+    }
+
+    std::vector<Segment> segments_;
+    std::size_t next_ = 0;
+};
+
+constexpr uint64_t kMinute = 60 * 1000;
+constexpr uint64_t kHour = 60 * kMinute;
+
+} // namespace
+
+SLP_TEST(stepsLandOnTheirSampleAndRampsRunFromThePreviousBreakpoint) {
+    AutomationTimeline timeline;
+    timeline.lane(AutomationTarget::ChannelVolume, 1).points = {
+        {3000, 0.25f, BreakpointShape::Exponential},
+        {1000, 0.5f, BreakpointShape::Linear},
+        {2000, 9.0f, BreakpointShape::Step},
+    };
+    timeline.lane(AutomationTarget::EqualizerPreset).points = {{500, 0.0f, BreakpointShape::Step}};
+    timeline.lane(AutomationTarget::ReverbMix).points = {{1500, -1.0f, BreakpointShape::EqualPower}};
+    timeline.endMs = 4000;
+    SLP_CHECK(&timeline.lane(AutomationTarget::MasterVolume, 7) == &timeline.lane(AutomationTarget::MasterVolume));
+
+    const AutomationSchedule schedule = scheduleAutomation(timeline, 48000.0);
+    SLP_CHECK_EQ(schedule.endFrame, 192000u);
+    // The EQ breakpoint names a preset the timeline does not have.
+    SLP_CHECK_EQ(schedule.actions.size(), 4u);
+
+    const AutomationAction& first = schedule.actions[0];
+    SLP_CHECK_EQ(first.frame, 0u);
+    SLP_CHECK_EQ(first.frames, 48000u);
+    SLP_CHECK_EQ(first.value, 0.5f);
+    SLP_CHECK_EQ(first.index, 1u);
+    SLP_CHECK(first.target == AutomationTarget::ChannelVolume);
+
+    const AutomationAction& wet = schedule.actions[1];
+    SLP_CHECK(wet.target == AutomationTarget::ReverbMix);
+    SLP_CHECK_EQ(wet.frames, 72000u);
+    SLP_CHECK_EQ(wet.value, 0.0f);
+    SLP_CHECK(wet.curve == RampCurve::Linear);
+
+    // A step and the ramp leaving it start on the same sample, in lane order.
+    SLP_CHECK_EQ(schedule.actions[2].frame, 96000u);
+    SLP_CHECK_EQ(schedule.actions[2].frames, 0u);
+    SLP_CHECK_EQ(schedule.actions[2].value, 4.0f);
+    SLP_CHECK_EQ(schedule.actions[3].frame, 96000u);
+    SLP_CHECK_EQ(schedule.actions[3].frames, 48000u);
+    SLP_CHECK(schedule.actions[3].curve == RampCurve::Exponential);
+
+    SLP_CHECK_EQ(automationFrame(1, 44100.0), 44u);
+    SLP_CHECK_EQ(automationFrame(8 * kHour, 44100.0), 1270080000u);
+}
+
+SLP_TEST(timelinesSerializeCompactlyAndRejectDamage) {
+    AutomationTimeline timeline;
+    timeline.equalizerPresets.push_back({});
+    timeline.equalizerPresets.push_back({6.0f, 4.5f, 3.0f, 0.0f, -1.5f, -3.0f, -6.0f, -9.0f, -12.0f, -12.0f});
+    timeline.lane(AutomationTarget::ChannelVolume, 2).points = {
+        {30 * kMinute, 0.6f, BreakpointShape::Linear},
+        {2 * kHour + 17, 0.3f, BreakpointShape::EqualPower},
+    };
+    timeline.lane(AutomationTarget::EqualizerPreset).points = {{kHour, 1.0f, BreakpointShape::Step}};
+    timeline.lane(AutomationTarget::DelayMix).points = {{3 * kHour, 0.1f, BreakpointShape::Exponential}};
+    timeline.endMs = 7 * kHour + 30 * kMinute;
+
+    std::vector<uint8_t> bytes = {0xAA};
+    encodeAutomation(timeline, bytes);
+    const std::size_t size = bytes.size() - 1;
+    // Dominated by the 80-byte presets; each breakpoint is under 10 bytes.
+    SLP_CHECK(size < 150);
+
+    AutomationTimeline decoded;
+    SLP_CHECK(decodeAutomation(bytes.data() + 1, size, decoded));
+    SLP_CHECK_EQ(decoded.endMs, timeline.endMs);
+    SLP_CHECK(decoded.equalizerPresets == timeline.equalizerPresets);
+    SLP_CHECK_EQ(decoded.lanes.size(), 3u);
+    for (std::size_t i = 0; i < decoded.lanes.size(); ++i) {
+        const AutomationLane& a = timeline.lanes[i];
+        const AutomationLane& b = decoded.lanes[i];
+        SLP_CHECK(a.target == b.target);
+        SLP_CHECK_EQ(a.channel, b.channel);
+        SLP_CHECK_EQ(a.points.size(), b.points.size());
+        for (std::size_t k = 0; k < a.points.size(); ++k) {
+            SLP_CHECK_EQ(a.points[k].timeMs, b.points[k].timeMs);
+            SLP_CHECK_EQ(a.points[k].value, b.points[k].value);
+            SLP_CHECK(a.points[k].shape == b.points[k].shape);
+        }
+    }
+
+    // Any flipped byte, missing byte or extra byte fails, leaving nothing.
+    const std::vector<uint8_t> good(bytes.begin() + 1, bytes.end());
+    for (std::size_t i = 0; i < good.size(); ++i) {
+        std::vector<uint8_t> damaged = good;
+        damaged[i] ^= 0x10;
+        SLP_CHECK(!decodeAutomation(damaged.data(), damaged.size(), decoded));
+        SLP_CHECK(decoded.empty());
+        SLP_CHECK(!decodeAutomation(good.data(), i, decoded));
+    }
+    std::vector<uint8_t> longer = good;
+    longer.push_back(0);
+    SLP_CHECK(!decodeAutomation(longer.data(), longer.size(), decoded));
+
+    // The C interface carries the same bytes.
+    SLPAutomation* automation = SLPAutomationDecode(good.data(), good.size());
+    SLP_CHECK(automation != nullptr);
+    SLP_CHECK_EQ(SLPAutomationGetEnd(automation), timeline.endMs);
+    std::vector<uint8_t> again(SLPAutomationEncode(automation, nullptr, 0));
+    SLP_CHECK_EQ(again.size(), good.size());
+    SLP_CHECK_EQ(SLPAutomationEncode(automation, again.data(), again.size()), good.size());
+    SLP_CHECK(again == good);
+    SLPAutomationDestroy(automation);
+}
+
+SLP_TEST(theMixerStepsAndRampsOnTheBreakpointSample) {
+    AutomationTimeline timeline;
+    timeline.lane(AutomationTarget::MasterVolume).points = {{10, 0.5f, BreakpointShape::Step}};
+    timeline.lane(AutomationTarget::ChannelVolume).points = {
+        {10, 1.0f, BreakpointShape::Step},
+        {20, 0.0f, BreakpointShape::Linear},
+    };
+
+    Mixer mixer(smallConfig());
+    const VoiceId voice = mixer.play(std::make_unique<UnitSource>(), 1.0f);
+    SLP_CHECK(mixer.automate(timeline, &voice, 1));
+    const std::vector<float> out = renderFrames(mixer, 1200);
+
+    SLP_CHECK_EQ(out[479], 1.0f);
+    SLP_CHECK_NEAR(out[480], 0.5f * (1.0f - 1.0f / 480.0f), 1e-6f);
+    SLP_CHECK_NEAR(out[719], 0.25f, 1e-6f);
+    SLP_CHECK_NEAR(out[958], 0.5f / 480.0f, 1e-6f);
+    SLP_CHECK_EQ(out[959], 0.0f);
+    SLP_CHECK_EQ(out[1199], 0.0f);
+
+    // Starting partway in catches up on everything before the start.
+    Mixer late(smallConfig());
+    const VoiceId lateVoice = late.play(std::make_unique<UnitSource>(), 1.0f);
+    SLP_CHECK(late.automate(timeline, &lateVoice, 1, 0.015));
+    const std::vector<float> rest = renderFrames(late, 480);
+    SLP_CHECK_NEAR(rest[0], out[720], 1e-6f);
+    SLP_CHECK_NEAR(rest[100], out[820], 1e-6f);
+    SLP_CHECK_EQ(rest[239], 0.0f);
+}
+
+SLP_TEST(equalizerAndEffectChangesStartOnTheirSample) {
+    const auto renderNoise = [](const AutomationTimeline* timeline) {
+        Mixer mixer(smallConfig());
+        mixer.reverb().setEnabled(true);
+        const VoiceId voice = mixer.play(std::make_unique<NoiseSource>(NoiseColor::Pink, 7), 0.5f);
+        if (timeline) mixer.automate(*timeline, &voice, 1);
+        return renderFrames(mixer, 4096);
+    };
+    const std::vector<float> plain = renderNoise(nullptr);
+
+    AutomationTimeline eq;
+    eq.equalizerPresets.push_back({12.0f, 12.0f, 12.0f, 12.0f, 12.0f, 12.0f, 12.0f, 12.0f, 12.0f, 12.0f});
+    eq.lane(AutomationTarget::EqualizerPreset).points = {{25, 0.0f, BreakpointShape::Step}};
+    // The glide starts on the breakpoint and first moves the coefficients
+    // one step later, as for any EQ change.
+    SLP_CHECK_EQ(firstDifference(plain, renderNoise(&eq)), 1200u + Equalizer::kGlideStepFrames);
+
+    // The reverb fades in over its declick time first; the automated mix
+    // takes over on its sample whether or not that has finished.
+    AutomationTimeline wet;
+    wet.lane(AutomationTarget::ReverbMix).points = {{5, 0.3f, BreakpointShape::Step},
+                                                    {40, 1.0f, BreakpointShape::Linear}};
+    SLP_CHECK_EQ(firstDifference(plain, renderNoise(&wet)), 240u);
+}
+
+SLP_TEST(stoppingOrEndingATimelineHandsBackTheMix) {
+    AutomationTimeline timeline;
+    timeline.lane(AutomationTarget::MasterVolume).points = {{0, 0.25f, BreakpointShape::Step}};
+    timeline.lane(AutomationTarget::ChannelVolume).points = {{0, 0.5f, BreakpointShape::Step}};
+
+    Mixer mixer(smallConfig());
+    const VoiceId voice = mixer.play(std::make_unique<UnitSource>(), 1.0f);
+    SLP_CHECK(mixer.automate(timeline, &voice, 1));
+    SLP_CHECK_EQ(renderFrames(mixer, 256).back(), 0.125f);
+    mixer.stopAutomation();
+    SLP_CHECK_EQ(renderFrames(mixer, 512).back(), 1.0f);
+
+    // Replaced timelines wait for collectEvents() to be freed, and the
+    // mixer refuses more than it can hold.
+    mixer.collectEvents(nullptr, 0);
+    std::size_t accepted = 0;
+    while (mixer.automate(timeline, &voice, 1)) {
+        renderFrames(mixer, 64);
+        ++accepted;
+    }
+    SLP_CHECK_EQ(accepted, 4u);
+    mixer.collectEvents(nullptr, 0);
+    SLP_CHECK(mixer.automate(timeline, &voice, 1));
+
+    timeline.endMs = 10;
+    SLP_CHECK(mixer.automate(timeline, &voice, 1));
+    const std::vector<float> out = renderFrames(mixer, 1024);
+    SLP_CHECK_EQ(out[479], 0.125f);
+    SLP_CHECK(out[480] < 0.125f);
+    SLP_CHECK_EQ(out[1023], 0.0f);
+
+    MixerEvent events[8];
+    const std::size_t count = mixer.collectEvents(events, 8);
+    bool finished = false;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (events[i].type == MixerEventType::AutomationFinished) {
+            finished = true;
+            SLP_CHECK_EQ(events[i].voice, kInvalidVoice);
+        }
+    }
+    SLP_CHECK(finished);
+    SLP_CHECK_EQ(mixer.activeVoiceCount(), 0u);
+
+    // The next voice plays at its own volume.
+    mixer.play(std::make_unique<UnitSource>(), 1.0f);
+    SLP_CHECK_EQ(renderFrames(mixer, 256).back(), 1.0f);
+}
+
+SLP_TEST(anEightHourTimelineRendersOfflineOnTheSample) {
+    // A low rate keeps the night quick to render while breakpoint times
+    // still round to frames that are not block-aligned.
+    constexpr double kRate = 1500.0;
+
+    AutomationTimeline night;
+    night.lane(AutomationTarget::ChannelVolume).points = {
+        {30 * kMinute + 7, 0.8f, BreakpointShape::Step},
+        {90 * kMinute + 333, 0.4f, BreakpointShape::Linear},
+        {3 * kHour + 101, 0.6f, BreakpointShape::Step},
+        {5 * kHour + 50, 0.2f, BreakpointShape::EqualPower},
+        {7 * kHour + 999, 1.0f, BreakpointShape::Linear},
+    };
+    night.lane(AutomationTarget::MasterVolume).points = {
+        {2 * kHour + 13, 0.5f, BreakpointShape::Step},
+        {6 * kHour, 0.25f, BreakpointShape::Exponential},
+    };
+    night.endMs = 7 * kHour + 30 * kMinute + 1;
+
+    // Render what a saved mix would load.
+    std::vector<uint8_t> saved;
+    encodeAutomation(night, saved);
+    SLP_CHECK(saved.size() < 100);
+    OfflineMix mix;
+    SLP_CHECK(decodeAutomation(saved.data(), saved.size(), mix.automation));
+    mix.sampleRate = kRate;
+    mix.durationSeconds = 8 * 3600.0;
+    OfflineTrack track;
+    track.makeSource = [] { return std::make_unique<UnitSource>(); };
+    mix.tracks.push_back(track);
+
+    LaneModel channel(night.lanes[0], kRate);
+    LaneModel master(night.lanes[1], kRate);
+    const uint64_t end = automationFrame(night.endMs, kRate);
+    const uint64_t declick = static_cast<uint64_t>(0.005 * kRate);
+
+    uint64_t frame = 0;
+    uint64_t wrong = 0;
+    float lastBeforeEnd = 0.0f;
+    float atEnd = 0.0f;
+    OfflineRenderOptions options;
+    options.threads = 4;
+    options.chunkSeconds = 900.0;
+    const bool ok = renderOffline(mix, options, [&](const float* left, const float*, std::size_t frames) {
+        for (std::size_t i = 0; i < frames; ++i, ++frame) {
+            if (frame == end - 1) lastBeforeEnd = left[i];
+            if (frame == end) atEnd = left[i];
+            if (frame >= end && frame < end + declick) continue;
+            const float expected = frame < end ? channel.at(frame) * master.at(frame) : 0.0f;
+            if (std::fabs(left[i] - expected) > 1e-4f) ++wrong;
+        }
+        return true;
+    });
+    SLP_CHECK(ok);
+    SLP_CHECK_EQ(frame, mix.frameCount());
+    SLP_CHECK_EQ(wrong, 0u);
+    // The stop begins on the end's sample.
+    SLP_CHECK(atEnd < lastBeforeEnd);
+}
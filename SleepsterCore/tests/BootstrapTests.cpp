@@ -0,0 +1,325 @@
+//
+//  BootstrapTests.cpp
+//  SleepsterCore
+//
+
+#include "TestHarness.hpp"
+
+#include "SLPBootstrap.h"
+#include "sleepster/Bootstrap.hpp"
+#include "sleepster/Trace.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace sleepster;
+
+namespace {
+
+/// Records the order mock services start in.
+struct StartLog {
+    std::mutex lock;
+    std::vector<std::string> order;
+
+    std::size_t position(const std::string& name) {
+        std::lock_guard<std::mutex> guard(lock);
+        return static_cast<std::size_t>(std::find(order.begin(), order.end(), name) - order.begin());
+    }
+};
+
+BootService mock(StartLog& log, const std::string& name, BootPhase phase, std::vector<std::string> dependencies,
+                 int sleepMilliseconds = 0, bool succeeds = true) {
+    BootService service;
+    service.name = name;
+    service.phase = phase;
+    service.dependencies = std::move(dependencies);
+    service.start = [&log, name, sleepMilliseconds, succeeds] {
+        if (sleepMilliseconds > 0) std::this_thread::sleep_for(std::chrono::milliseconds(sleepMilliseconds));
+        std::lock_guard<std::mutex> guard(log.lock);
+        log.order.push_back(name);
+        return succeeds;
+    };
+    return service;
+}
+
+const BootTiming* timingOf(const std::vector<BootTiming>& timings, const char* name) {
+    for (const BootTiming& timing : timings) {
+        if (std::strcmp(timing.name, name) == 0) return &timing;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+SLP_TEST(dependenciesStartBeforeTheirDependents) {
+    StartLog log;
+    Bootstrap bootstrap;
+    // A diamond plus a tail: storage -> {settings, audio} -> mixer -> ui.
+    SLP_CHECK(bootstrap.add(mock(log, "ui", BootPhase::Critical, {"mixer"})));
+    SLP_CHECK(bootstrap.add(mock(log, "mixer", BootPhase::Critical, {"settings", "audio"})));
+    SLP_CHECK(bootstrap.add(mock(log, "settings", BootPhase::Critical, {"storage"}, 3)));
+    SLP_CHECK(bootstrap.add(mock(log, "audio", BootPhase::Critical, {"storage"}, 1)));
+    SLP_CHECK(bootstrap.add(mock(log, "storage", BootPhase::Critical, {}, 2)));
+    SLP_CHECK(!bootstrap.add(mock(log, "storage", BootPhase::Critical, {})));
+
+    WorkStealingPool pool(3);
+    SLP_CHECK(bootstrap.run(BootPhase::Critical, pool));
+    SLP_CHECK_EQ(log.order.size(), 5u);
+    SLP_CHECK(log.position("storage") < log.position("settings"));
+    SLP_CHECK(log.position("storage") < log.position("audio"));
+    SLP_CHECK(log.position("settings") < log.position("mixer"));
+    SLP_CHECK(log.position("audio") < log.position("mixer"));
+    SLP_CHECK(log.position("mixer") < log.position("ui"));
+
+    const std::vector<BootTiming> timings = bootstrap.timings();
+    SLP_CHECK_EQ(timings.size(), 5u);
+    for (const BootTiming& timing : timings) {
+        SLP_CHECK(timing.status == BootStatus::Succeeded);
+        SLP_CHECK(timing.ready <= timing.begin);
+        SLP_CHECK(timing.begin <= timing.end);
+        SLP_CHECK(timing.thread >= 0 && timing.thread < 3);
+    }
+    // Nothing starts before the last of its dependencies has finished.
+    SLP_CHECK(timingOf(timings, "mixer")->ready >= timingOf(timings, "settings")->end);
+    SLP_CHECK(timingOf(timings, "mixer")->ready >= timingOf(timings, "audio")->end);
+}
+
+SLP_TEST(independentServicesStartInParallel) {
+    StartLog log;
+    Bootstrap bootstrap;
+    for (const char* name : {"a", "b", "c", "d"}) {
+        SLP_CHECK(bootstrap.add(mock(log, name, BootPhase::Critical, {}, 40)));
+    }
+    WorkStealingPool pool(4);
+    const auto begin = std::chrono::steady_clock::now();
+    SLP_CHECK(bootstrap.run(BootPhase::Critical, pool));
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    // Serially this would take 160 ms.
+    SLP_CHECK(elapsed < 0.12);
+
+    const std::vector<BootTiming> timings = bootstrap.timings();
+    double latestBegin = 0.0;
+    double earliestEnd = 1e9;
+    for (const BootTiming& timing : timings) {
+        latestBegin = std::max(latestBegin, timing.begin);
+        earliestEnd = std::min(earliestEnd, timing.end);
+    }
+    SLP_CHECK(latestBegin < earliestEnd);
+}
+
+SLP_TEST(aFailedServiceSkipsEverythingDependingOnIt) {
+    StartLog log;
+    Bootstrap bootstrap;
+    SLP_CHECK(bootstrap.add(mock(log, "database", BootPhase::Critical, {}, 0, false)));
+    SLP_CHECK(bootstrap.add(mock(log, "library", BootPhase::Critical, {"database"})));
+    SLP_CHECK(bootstrap.add(mock(log, "favorites", BootPhase::Critical, {"library"})));
+    SLP_CHECK(bootstrap.add(mock(log, "audio", BootPhase::Critical, {})));
+    SLP_CHECK(bootstrap.add(mock(log, "stats", BootPhase::FirstFrame, {"database"})));
+
+    WorkStealingPool pool(2);
+    SLP_CHECK(!bootstrap.run(BootPhase::Critical, pool));
+    SLP_CHECK(bootstrap.error().empty());
+    SLP_CHECK(bootstrap.status("database") == BootStatus::Failed);
+    SLP_CHECK(bootstrap.status("library") == BootStatus::Skipped);
+    SLP_CHECK(bootstrap.status("favorites") == BootStatus::Skipped);
+    SLP_CHECK(bootstrap.status("audio") == BootStatus::Succeeded);
+    SLP_CHECK(bootstrap.status("stats") == BootStatus::Pending);
+    SLP_CHECK_EQ(log.order.size(), 2u);
+
+    // Later phases skip what depends on an earlier failure, too.
+    SLP_CHECK(!bootstrap.run(BootPhase::FirstFrame, pool));
+    SLP_CHECK(bootstrap.status("stats") == BootStatus::Skipped);
+    SLP_CHECK_EQ(log.order.size(), 2u);
+    SLP_CHECK_EQ(bootstrap.timings().size(), 5u);
+}
+
+SLP_TEST(validationRejectsMissingLateAndCyclicDependencies) {
+    StartLog log;
+    std::string error;
+    WorkStealingPool pool(1);
+    {
+        Bootstrap bootstrap;
+        SLP_CHECK(bootstrap.add(mock(log, "mixer", BootPhase::Critical, {"audio"})));
+        SLP_CHECK(!bootstrap.validate(error));
+        SLP_CHECK(error.find("audio") != std::string::npos);
+        SLP_CHECK(!bootstrap.run(BootPhase::Idle, pool));
+        SLP_CHECK_EQ(bootstrap.error(), error);
+    }
+    {
+        Bootstrap bootstrap;
+        SLP_CHECK(bootstrap.add(mock(log, "audio", BootPhase::Critical, {"analytics"})));
+        SLP_CHECK(bootstrap.add(mock(log, "analytics", BootPhase::Idle, {})));
+        SLP_CHECK(!bootstrap.validate(error));
+        SLP_CHECK(error.find("starts later") != std::string::npos);
+    }
+    {
+        Bootstrap bootstrap;
+        SLP_CHECK(bootstrap.add(mock(log, "free", BootPhase::Critical, {})));
+        SLP_CHECK(bootstrap.add(mock(log, "a", BootPhase::Critical, {"c"})));
+        SLP_CHECK(bootstrap.add(mock(log, "b", BootPhase::Critical, {"a", "free"})));
+        SLP_CHECK(bootstrap.add(mock(log, "c", BootPhase::Critical, {"b"})));
+        SLP_CHECK(!bootstrap.validate(error));
+        SLP_CHECK_EQ(error, std::string("dependency cycle through a b c"));
+        SLP_CHECK(!bootstrap.run(BootPhase::Critical, pool));
+    }
+    // Nothing started in any of them.
+    SLP_CHECK(log.order.empty());
+}
+
+SLP_TEST(callerServicesRunOnTheCallingThread) {
+    StartLog log;
+    Bootstrap bootstrap;
+    const std::thread::id caller = std::this_thread::get_id();
+    std::atomic<int> onCaller{0};
+    std::atomic<int> offCaller{0};
+    for (int i = 0; i < 6; ++i) {
+        BootService service = mock(log, "service " + std::to_string(i), BootPhase::Critical,
+                                   i == 0 ? std::vector<std::string>{} : std::vector<std::string>{"service 0"});
+        service.affinity = i % 2 ? BootAffinity::Caller : BootAffinity::Pool;
+        std::function<bool()> start = service.start;
+        const bool wantsCaller = service.affinity == BootAffinity::Caller;
+        service.start = [&, start, wantsCaller] {
+            const bool here = std::this_thread::get_id() == caller;
+            (here == wantsCaller ? onCaller : offCaller).fetch_add(1);
+            return start();
+        };
+        SLP_CHECK(bootstrap.add(std::move(service)));
+    }
+    WorkStealingPool pool(2);
+    SLP_CHECK(bootstrap.run(BootPhase::Critical, pool));
+    SLP_CHECK_EQ(onCaller.load(), 6);
+    SLP_CHECK_EQ(offCaller.load(), 0);
+    for (const BootTiming& timing : bootstrap.timings()) {
+        const bool callerService = std::strcmp(timing.name, "service 1") == 0
+            || std::strcmp(timing.name, "service 3") == 0 || std::strcmp(timing.name, "service 5") == 0;
+        SLP_CHECK_EQ(timing.thread == -1, callerService);
+    }
+}
+
+SLP_TEST(eachPhaseStartsOnlyWhatIsDue) {
+    StartLog log;
+    Bootstrap bootstrap;
+    SLP_CHECK(bootstrap.add(mock(log, "storage", BootPhase::Critical, {})));
+    SLP_CHECK(bootstrap.add(mock(log, "library", BootPhase::FirstFrame, {"storage"})));
+    SLP_CHECK(bootstrap.add(mock(log, "analytics", BootPhase::Idle, {"library"})));
+    SLP_CHECK(bootstrap.add(mock(log, "store", BootPhase::Idle, {})));
+
+    WorkStealingPool pool(2);
+    SLP_CHECK(bootstrap.run(BootPhase::Critical, pool));
+    SLP_CHECK_EQ(log.order, std::vector<std::string>{"storage"});
+    SLP_CHECK(bootstrap.run(BootPhase::FirstFrame, pool));
+    SLP_CHECK_EQ(log.order, (std::vector<std::string>{"storage", "library"}));
+    SLP_CHECK(bootstrap.run(BootPhase::Idle, pool));
+    SLP_CHECK_EQ(log.order.size(), 4u);
+    SLP_CHECK(bootstrap.run(BootPhase::Idle, pool));
+    SLP_CHECK_EQ(log.order.size(), 4u);
+
+    const std::vector<BootTiming> timings = bootstrap.timings();
+    SLP_CHECK_EQ(timings.size(), 4u);
+    SLP_CHECK(timingOf(timings, "library")->phase == BootPhase::FirstFrame);
+    SLP_CHECK(timingOf(timings, "library")->begin >= timingOf(timings, "storage")->end);
+}
+
+SLP_TEST(startsAreRecordedAsTraceSpans) {
+    Tracer::setEnabled(true);
+    Tracer::clear();
+    StartLog log;
+    Bootstrap bootstrap;
+    SLP_CHECK(bootstrap.add(mock(log, "traced", BootPhase::Critical, {}, 1)));
+    WorkStealingPool pool(1);
+    SLP_CHECK(bootstrap.run(BootPhase::Critical, pool));
+
+    int spans = 0;
+    for (const TraceThread& thread : Tracer::snapshot()) {
+        for (const TraceEvent& event : thread.events) {
+            if (!event.name || std::strcmp(event.name, "traced") != 0) continue;
+            ++spans;
+            SLP_CHECK(event.category == TraceCategory::App);
+            SLP_CHECK(event.duration >= 1000000u);
+            SLP_CHECK_EQ(thread.name, std::string("pool worker 0"));
+        }
+    }
+    SLP_CHECK_EQ(spans, 1);
+    Tracer::setEnabled(false);
+}
+
+SLP_TEST(idleWorkersStealQueuedJobs) {
+    std::atomic<int> ran{0};
+    uint64_t steals = 0;
+    {
+        WorkStealingPool pool(3);
+        SLP_CHECK_EQ(pool.threadCount(), 3u);
+        SLP_CHECK_EQ(pool.currentWorker(), -1);
+        // Jobs submitted from a worker land on its own queue; the others
+        // only get them by stealing.
+        pool.submit([&] {
+            for (int i = 0; i < 60; ++i) {
+                pool.submit([&] {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    ran.fetch_add(1);
+                });
+            }
+        });
+        while (ran.load() < 60) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        steals = pool.steals();
+
+        // Queued jobs still run when the pool is destroyed.
+        for (int i = 0; i < 20; ++i) pool.submit([&] { ran.fetch_add(1); });
+    }
+    SLP_CHECK_EQ(ran.load(), 80);
+    SLP_CHECK(steals > 0);
+}
+
+namespace {
+
+struct CContext {
+    std::atomic<int> started{0};
+    bool succeeds = true;
+};
+
+bool startMock(void* context) {
+    CContext* mock = static_cast<CContext*>(context);
+    mock->started.fetch_add(1);
+    return mock->succeeds;
+}
+
+} // namespace
+
+SLP_TEST(cInterfaceRunsPhasesAndReportsTimings) {
+    SLPBootstrap* bootstrap = SLPBootstrapCreate(2);
+    CContext storage;
+    CContext library;
+    CContext main;
+    const char* needsStorage[] = {"storage"};
+    const char* needsBoth[] = {"storage", "library"};
+    SLP_CHECK(SLPBootstrapAdd(bootstrap, "storage", SLPBootPhaseCritical, nullptr, 0, false, startMock, &storage));
+    SLP_CHECK(SLPBootstrapAdd(bootstrap, "library", SLPBootPhaseFirstFrame, needsStorage, 1, false, startMock, &library));
+    SLP_CHECK(SLPBootstrapAdd(bootstrap, "main", SLPBootPhaseFirstFrame, needsBoth, 2, true, startMock, &main));
+    SLP_CHECK(!SLPBootstrapAdd(bootstrap, "main", SLPBootPhaseIdle, nullptr, 0, true, startMock, &main));
+
+    SLP_CHECK(SLPBootstrapRun(bootstrap, SLPBootPhaseCritical));
+    SLP_CHECK(SLPBootstrapRun(bootstrap, SLPBootPhaseFirstFrame));
+    SLP_CHECK_EQ(storage.started.load() + library.started.load() + main.started.load(), 3);
+    SLP_CHECK_EQ(std::string(SLPBootstrapGetError(bootstrap)), std::string());
+
+    const SLPBootTiming* timings = nullptr;
+    SLP_CHECK_EQ(SLPBootstrapGetTimings(bootstrap, &timings), 3u);
+    SLP_CHECK(timings != nullptr);
+    SLP_CHECK_EQ(std::string(timings[2].name), std::string("main"));
+    SLP_CHECK_EQ(timings[2].thread, -1);
+    SLP_CHECK(timings[2].phase == SLPBootPhaseFirstFrame);
+    SLP_CHECK(timings[2].status == SLPBootStatusSucceeded);
+    SLP_CHECK(timings[0].thread >= 0);
+
+    CContext late;
+    SLP_CHECK(SLPBootstrapAdd(bootstrap, "late", SLPBootPhaseCritical, needsBoth, 2, false, startMock, &late));
+    SLP_CHECK(!SLPBootstrapRun(bootstrap, SLPBootPhaseIdle));
+    SLP_CHECK(std::strstr(SLPBootstrapGetError(bootstrap), "late") != nullptr);
+    SLPBootstrapDestroy(bootstrap);
+}
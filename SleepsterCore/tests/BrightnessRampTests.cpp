@@ -0,0 +1,115 @@
+//
+//  BrightnessRampTests.cpp
+//  SleepsterCore
+//
+
+#include "TestHarness.hpp"
+
+#include "SLPBrightnessRamp.h"
+#include "sleepster/BrightnessRamp.hpp"
+
+#include <cmath>
+#include <vector>
+
+using namespace sleepster;
+
+SLP_TEST(lightnessCoversTheBrightnessRangeAndRoundTrips) {
+    SLP_CHECK_NEAR(brightnessToLightness(0.0, 2.2), 0.0, 1e-9);
+    SLP_CHECK_NEAR(brightnessToLightness(1.0, 2.2), 100.0, 1e-9);
+    // Mid grey: half brightness is about a fifth of the luminance.
+    SLP_CHECK_NEAR(brightnessToLightness(0.5, 2.2), 53.8, 0.1);
+    for (double brightness = 0.0; brightness <= 1.0; brightness += 0.01) {
+        SLP_CHECK_NEAR(lightnessToBrightness(brightnessToLightness(brightness, 2.2), 2.2), brightness, 1e-9);
+    }
+    SLP_CHECK_EQ(lightnessToBrightness(150.0, 2.2), 1.0);
+    SLP_CHECK_EQ(lightnessToBrightness(-5.0, 2.2), 0.0);
+}
+
+SLP_TEST(longRampsStepEvenlyInLightnessAndEndOnTheTarget) {
+    const BrightnessRampConfig config;
+    const double change = brightnessToLightness(0.8, 2.2) - brightnessToLightness(0.1, 2.2);
+    const std::vector<BrightnessStep> steps = planBrightnessRamp(0.8, 0.1, 1800.0, config);
+    SLP_CHECK_EQ(steps.size(), static_cast<std::size_t>(std::ceil(change)));
+
+    double lightness = brightnessToLightness(0.8, 2.2);
+    double time = 0.0;
+    for (const BrightnessStep& step : steps) {
+        const double next = brightnessToLightness(step.brightness, 2.2);
+        SLP_CHECK(lightness - next <= config.lightnessStep + 1e-9);
+        SLP_CHECK_NEAR(lightness - next, change / static_cast<double>(steps.size()), 1e-6);
+        SLP_CHECK(step.time > time);
+        lightness = next;
+        time = step.time;
+    }
+    SLP_CHECK_EQ(steps.back().time, 1800.0);
+    SLP_CHECK_EQ(steps.back().brightness, 0.1);
+
+    // Brightening runs the same steps the other way.
+    const std::vector<BrightnessStep> up = planBrightnessRamp(0.1, 0.8, 1800.0, config);
+    SLP_CHECK_EQ(up.size(), steps.size());
+    SLP_CHECK_NEAR(up.front().brightness, steps[steps.size() - 2].brightness, 1e-9);
+    SLP_CHECK_EQ(up.back().brightness, 0.8);
+}
+
+SLP_TEST(shortRampsTakeFewerLargerSteps) {
+    const BrightnessRampConfig config;
+    SLP_CHECK_EQ(planBrightnessRamp(1.0, 0.1, 1.0, config, nullptr, 0), 10u);
+    SLP_CHECK_EQ(planBrightnessRamp(1.0, 0.1, 0.05, config, nullptr, 0), 1u);
+
+    // A change smaller than one step is still made, once.
+    const std::vector<BrightnessStep> nudge = planBrightnessRamp(0.5, 0.501, 600.0, config);
+    SLP_CHECK_EQ(nudge.size(), 1u);
+    SLP_CHECK_EQ(nudge[0].time, 600.0);
+
+    // A coarser step means fewer updates for the same ramp.
+    BrightnessRampConfig coarse;
+    coarse.lightnessStep = 4.0;
+    const std::size_t fine = planBrightnessRamp(0.8, 0.1, 1800.0, config, nullptr, 0);
+    const std::size_t rough = planBrightnessRamp(0.8, 0.1, 1800.0, coarse, nullptr, 0);
+    SLP_CHECK_EQ(rough, (fine + 3) / 4);
+}
+
+SLP_TEST(emptyAndInstantRampsAreExplicit) {
+    const BrightnessRampConfig config;
+    SLP_CHECK_EQ(planBrightnessRamp(0.4, 0.4, 60.0, config, nullptr, 0), 0u);
+    // Both ends clamp, so out-of-range requests can also be empty.
+    SLP_CHECK_EQ(planBrightnessRamp(1.5, 1.0, 60.0, config, nullptr, 0), 0u);
+
+    const std::vector<BrightnessStep> jump = planBrightnessRamp(0.9, 0.2, 0.0, config);
+    SLP_CHECK_EQ(jump.size(), 1u);
+    SLP_CHECK_EQ(jump[0].time, 0.0);
+    SLP_CHECK_EQ(jump[0].brightness, 0.2);
+}
+
+SLP_TEST(aResumedRampPicksUpAtTheDueStep) {
+    const std::vector<BrightnessStep> steps = planBrightnessRamp(0.6, 0.05, 1200.0);
+    const std::size_t count = steps.size();
+    SLP_CHECK_EQ(brightnessStepsDue(steps.data(), count, -1.0), 0u);
+    SLP_CHECK_EQ(brightnessStepsDue(steps.data(), count, 0.0), 0u);
+    SLP_CHECK_EQ(brightnessStepsDue(steps.data(), count, steps[4].time), 5u);
+    SLP_CHECK_EQ(brightnessStepsDue(steps.data(), count, steps[4].time + 1e-6), 5u);
+    SLP_CHECK_EQ(brightnessStepsDue(steps.data(), count, 1200.0), count);
+    SLP_CHECK_EQ(brightnessStepsDue(steps.data(), count, 1e9), count);
+
+    // Replanning from the level reached over the time left keeps to the
+    // same curve.
+    const std::size_t due = brightnessStepsDue(steps.data(), count, 600.0);
+    const std::vector<BrightnessStep> rest =
+        planBrightnessRamp(steps[due - 1].brightness, 0.05, 1200.0 - steps[due - 1].time);
+    SLP_CHECK_EQ(rest.size(), count - due);
+    SLP_CHECK_NEAR(rest[0].brightness, steps[due].brightness, 1e-9);
+    SLP_CHECK_NEAR(rest[0].time + steps[due - 1].time, steps[due].time, 1e-9);
+}
+
+SLP_TEST(theCInterfaceCountsAndFillsPartially) {
+    const SLPBrightnessRampConfig config = SLPBrightnessRampGetDefaultConfig();
+    SLP_CHECK_EQ(config.gamma, 2.2);
+    const size_t count = SLPBrightnessRampPlan(0.8, 0.1, 1800.0, config, nullptr, 0);
+    SLP_CHECK_EQ(count, planBrightnessRamp(0.8, 0.1, 1800.0).size());
+
+    std::vector<SLPBrightnessStep> head(8, SLPBrightnessStep{-1.0, -1.0});
+    SLP_CHECK_EQ(SLPBrightnessRampPlan(0.8, 0.1, 1800.0, config, head.data(), 4), count);
+    SLP_CHECK(head[3].time > 0.0);
+    SLP_CHECK_EQ(head[4].time, -1.0);
+    SLP_CHECK_EQ(SLPBrightnessRampGetStepsDue(head.data(), 4, head[1].time), 2u);
+}
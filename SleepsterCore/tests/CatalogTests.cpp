@@ -0,0 +1,357 @@
+//
+//  CatalogTests.cpp
+//  SleepsterCore
+//
+
+#include "TestHarness.hpp"
+
+#include "SLPCatalog.h"
+#include "sleepster/Catalog.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace sleepster;
+
+namespace {
+
+std::string tempPath(const char* name) {
+    const std::string path = std::string("/tmp/sleepster_") + name;
+    std::remove(path.c_str());
+    return path;
+}
+
+CatalogSound soundNamed(const std::string& title, bool withUrl = true) {
+    CatalogSound sound;
+    sound.title = title;
+    sound.hasUrl1 = withUrl;
+    sound.url1 = withUrl ? title + ".mp3" : "";
+    return sound;
+}
+
+CatalogBackground backgroundOf(const std::string& animationType, const char* theme = "ocean") {
+    CatalogBackground background;
+    background.animationType = animationType;
+    background.hasColorTheme = theme != nullptr;
+    background.colorTheme = theme ? theme : "";
+    background.intensityLevel = 3;
+    background.speedMultiplier = 1.5f;
+    return background;
+}
+
+/// A store-sized catalog: `count` sounds, every fifth a favorite and every
+/// seventh in the mix, and as many backgrounds.
+void fill(Catalog& catalog, int count) {
+    uint32_t id;
+    for (int i = 0; i < count; ++i) {
+        CatalogSound sound = soundNamed("Sound " + std::to_string(i));
+        sound.favorite = i % 5 == 0;
+        sound.selectedForMixing = i % 7 == 0;
+        SLP_CHECK(catalog.addSound(sound, id, true));
+        SLP_CHECK(catalog.addBackground(backgroundOf("animation-" + std::to_string(i)), id, true));
+    }
+}
+
+} // namespace
+
+SLP_TEST(recordsAreFoundByTheirKeys) {
+    Catalog catalog;
+    uint32_t rain;
+    uint32_t waves;
+    uint32_t stars;
+    SLP_CHECK(catalog.addSound(soundNamed("Rain"), rain));
+    SLP_CHECK(catalog.addSound(soundNamed("Waves", false), waves));
+    SLP_CHECK(catalog.addBackground(backgroundOf("starfield", nullptr), stars));
+
+    SLP_CHECK_EQ(catalog.find(CatalogKind::Sound, "Rain"), rain);
+    SLP_CHECK_EQ(catalog.find(CatalogKind::Sound, "Waves"), waves);
+    SLP_CHECK_EQ(catalog.find(CatalogKind::Sound, "Rai"), Catalog::kNotFound);
+    SLP_CHECK_EQ(catalog.find(CatalogKind::Sound, "Rain "), Catalog::kNotFound);
+    SLP_CHECK_EQ(catalog.find(CatalogKind::Sound, "starfield"), Catalog::kNotFound);
+    SLP_CHECK_EQ(catalog.find(CatalogKind::Background, "starfield"), stars);
+
+    CatalogSound sound;
+    SLP_CHECK(catalog.sound(waves, sound));
+    SLP_CHECK_EQ(sound.title, std::string("Waves"));
+    SLP_CHECK(!sound.hasUrl1);
+    SLP_CHECK(!sound.hasUrl2);
+    CatalogBackground background;
+    SLP_CHECK(catalog.background(stars, background));
+    SLP_CHECK(!background.hasColorTheme);
+    SLP_CHECK_EQ(background.intensityLevel, 3);
+    SLP_CHECK_EQ(background.speedMultiplier, 1.5f);
+    SLP_CHECK(!catalog.sound(99, sound));
+
+    // Keys are unique; the holder comes back.
+    uint32_t duplicate;
+    SLP_CHECK(!catalog.addSound(soundNamed("Rain"), duplicate));
+    SLP_CHECK_EQ(duplicate, rain);
+    SLP_CHECK_EQ(catalog.size(CatalogKind::Sound), 2u);
+}
+
+SLP_TEST(theIndexSurvivesGrowthRenamesAndRemovals) {
+    Catalog catalog;
+    fill(catalog, 5000);
+    SLP_CHECK_EQ(catalog.size(CatalogKind::Sound), 5000u);
+    for (int i = 0; i < 5000; i += 3) {
+        SLP_CHECK(catalog.remove(CatalogKind::Sound, catalog.find(CatalogKind::Sound, "Sound " + std::to_string(i))));
+    }
+    for (int i = 1; i < 5000; i += 3) {
+        const uint32_t id = catalog.find(CatalogKind::Sound, "Sound " + std::to_string(i));
+        SLP_CHECK(catalog.updateSound(id, soundNamed("Renamed " + std::to_string(i))));
+    }
+    std::size_t live = 0;
+    for (int i = 0; i < 5000; ++i) {
+        const std::string name = std::to_string(i);
+        const uint32_t original = catalog.find(CatalogKind::Sound, "Sound " + name);
+        const uint32_t renamed = catalog.find(CatalogKind::Sound, "Renamed " + name);
+        if (i % 3 == 0) {
+            SLP_CHECK(original == Catalog::kNotFound && renamed == Catalog::kNotFound);
+        } else if (i % 3 == 1) {
+            SLP_CHECK(original == Catalog::kNotFound && renamed != Catalog::kNotFound);
+            ++live;
+        } else {
+            SLP_CHECK(original != Catalog::kNotFound && renamed == Catalog::kNotFound);
+            ++live;
+        }
+    }
+    SLP_CHECK_EQ(catalog.size(CatalogKind::Sound), live);
+
+    // A rename onto a taken title is refused and changes nothing.
+    const uint32_t two = catalog.find(CatalogKind::Sound, "Sound 2");
+    SLP_CHECK(!catalog.updateSound(two, soundNamed("Renamed 1")));
+    SLP_CHECK_EQ(catalog.find(CatalogKind::Sound, "Sound 2"), two);
+
+    // A removed title can be added again, as a new row.
+    uint32_t again;
+    SLP_CHECK(catalog.addSound(soundNamed("Sound 0"), again));
+    SLP_CHECK_EQ(again, static_cast<uint32_t>(catalog.rowCount(CatalogKind::Sound) - 1));
+}
+
+SLP_TEST(flagsAreBitsetsOverLiveRows) {
+    Catalog catalog;
+    fill(catalog, 200);
+    SLP_CHECK_EQ(catalog.countWith(CatalogKind::Sound, CatalogFlag::Favorite), 40u);
+    SLP_CHECK_EQ(catalog.countWith(CatalogKind::Sound, CatalogFlag::SelectedForMixing), 29u);
+    SLP_CHECK_EQ(catalog.firstWith(CatalogKind::Sound, CatalogFlag::Selected), Catalog::kNotFound);
+
+    const std::vector<uint32_t> mix = catalog.allWith(CatalogKind::Sound, CatalogFlag::SelectedForMixing);
+    SLP_CHECK_EQ(mix.size(), 29u);
+    for (std::size_t i = 1; i < mix.size(); ++i) SLP_CHECK(mix[i - 1] < mix[i]);
+    SLP_CHECK(catalog.flag(CatalogKind::Sound, mix.back(), CatalogFlag::SelectedForMixing));
+
+    // Removed rows drop out of every set.
+    SLP_CHECK(catalog.remove(CatalogKind::Sound, mix.front()));
+    SLP_CHECK_EQ(catalog.countWith(CatalogKind::Sound, CatalogFlag::SelectedForMixing), 28u);
+    SLP_CHECK(!catalog.flag(CatalogKind::Sound, mix.front(), CatalogFlag::SelectedForMixing));
+
+    // Backgrounds are never in the mix.
+    SLP_CHECK(!catalog.setFlag(CatalogKind::Background, 0, CatalogFlag::SelectedForMixing, true));
+    SLP_CHECK_EQ(catalog.countWith(CatalogKind::Background, CatalogFlag::SelectedForMixing), 0u);
+}
+
+SLP_TEST(selectingDeselectsTheRestAndMarksOnlyWhatChanged) {
+    Catalog catalog;
+    fill(catalog, 100);
+    SLP_CHECK_EQ(catalog.pendingChanges(CatalogKind::Sound), 0u);
+    SLP_CHECK(catalog.setFlag(CatalogKind::Sound, 10, CatalogFlag::Selected, true, true));
+    SLP_CHECK(catalog.setFlag(CatalogKind::Sound, 20, CatalogFlag::Selected, true, true));
+    SLP_CHECK_EQ(catalog.firstWith(CatalogKind::Sound, CatalogFlag::Selected), 10u);
+
+    SLP_CHECK(catalog.select(CatalogKind::Sound, 42));
+    SLP_CHECK_EQ(catalog.allWith(CatalogKind::Sound, CatalogFlag::Selected), std::vector<uint32_t>{42});
+    SLP_CHECK_EQ(catalog.takeChanges(CatalogKind::Sound), (std::vector<uint32_t>{10, 20, 42}));
+    SLP_CHECK_EQ(catalog.pendingChanges(CatalogKind::Sound), 0u);
+
+    // Selecting what is already selected, or setting a flag to what it is,
+    // is not a change.
+    const uint64_t revision = catalog.revision();
+    SLP_CHECK(catalog.select(CatalogKind::Sound, 42));
+    SLP_CHECK(catalog.setFlag(CatalogKind::Sound, 0, CatalogFlag::Favorite, true));
+    SLP_CHECK_EQ(catalog.revision(), revision);
+    SLP_CHECK(catalog.takeChanges(CatalogKind::Sound).empty());
+    SLP_CHECK(!catalog.select(CatalogKind::Sound, 100000));
+}
+
+SLP_TEST(changesFromTheStoreAreNotWrittenBack) {
+    Catalog catalog;
+    uint32_t id;
+    SLP_CHECK(catalog.addSound(soundNamed("Rain"), id, true));
+    SLP_CHECK(catalog.setFlag(CatalogKind::Sound, id, CatalogFlag::Favorite, true, true));
+    SLP_CHECK_EQ(catalog.pendingChanges(CatalogKind::Sound), 0u);
+    SLP_CHECK(catalog.revision() > 0);
+
+    uint32_t wind;
+    SLP_CHECK(catalog.addSound(soundNamed("Wind"), wind));
+    SLP_CHECK(catalog.remove(CatalogKind::Sound, id));
+    const std::vector<uint32_t> changes = catalog.takeChanges(CatalogKind::Sound);
+    SLP_CHECK_EQ(changes, (std::vector<uint32_t>{id, wind}));
+    // The removed row still says what to delete.
+    SLP_CHECK(!catalog.isLive(CatalogKind::Sound, id));
+    SLP_CHECK_EQ(std::string(catalog.key(CatalogKind::Sound, id)), std::string("Rain"));
+    SLP_CHECK(catalog.isLive(CatalogKind::Sound, wind));
+}
+
+SLP_TEST(snapshotsRoundTripWithPendingChanges) {
+    const std::string path = tempPath("catalog.snapshot");
+    Catalog catalog;
+    fill(catalog, 300);
+    CatalogSound sound = soundNamed("Noise");
+    sound.hasUrl2 = true;
+    sound.url2 = "noise-b.mp3";
+    uint32_t noise;
+    SLP_CHECK(catalog.addSound(sound, noise));
+    SLP_CHECK(catalog.select(CatalogKind::Background, 7));
+    SLP_CHECK(catalog.remove(CatalogKind::Sound, 3));
+    SLP_CHECK(catalog.remove(CatalogKind::Sound, 4, true));
+    SLP_CHECK(catalog.save(path));
+
+    std::unique_ptr<Catalog> loaded = Catalog::load(path);
+    SLP_CHECK(loaded != nullptr);
+    if (!loaded) return;
+    SLP_CHECK_EQ(loaded->revision(), catalog.revision());
+    SLP_CHECK_EQ(loaded->size(CatalogKind::Sound), catalog.size(CatalogKind::Sound));
+    SLP_CHECK_EQ(loaded->size(CatalogKind::Background), 300u);
+    // Row 4 was removed by the store, so nothing is left to say about it.
+    SLP_CHECK_EQ(loaded->rowCount(CatalogKind::Sound), catalog.rowCount(CatalogKind::Sound) - 1);
+    SLP_CHECK_EQ(loaded->countWith(CatalogKind::Sound, CatalogFlag::Favorite),
+                 catalog.countWith(CatalogKind::Sound, CatalogFlag::Favorite));
+
+    CatalogSound read;
+    SLP_CHECK(loaded->sound(loaded->find(CatalogKind::Sound, "Noise"), read));
+    SLP_CHECK_EQ(read.url1, std::string("Noise.mp3"));
+    SLP_CHECK_EQ(read.url2, std::string("noise-b.mp3"));
+    CatalogBackground background;
+    SLP_CHECK(loaded->background(loaded->firstWith(CatalogKind::Background, CatalogFlag::Selected), background));
+    SLP_CHECK_EQ(background.animationType, std::string("animation-7"));
+    SLP_CHECK_EQ(background.colorTheme, std::string("ocean"));
+
+    // Pending write-backs survive: the removal, the new sound, the selection.
+    const std::vector<uint32_t> sounds = loaded->takeChanges(CatalogKind::Sound);
+    SLP_CHECK_EQ(sounds.size(), 2u);
+    SLP_CHECK(!loaded->isLive(CatalogKind::Sound, sounds[0]));
+    SLP_CHECK_EQ(std::string(loaded->key(CatalogKind::Sound, sounds[0])), std::string("Sound 3"));
+    SLP_CHECK_EQ(std::string(loaded->key(CatalogKind::Sound, sounds[1])), std::string("Noise"));
+    SLP_CHECK_EQ(loaded->takeChanges(CatalogKind::Background).size(), 1u);
+    std::remove(path.c_str());
+}
+
+SLP_TEST(snapshotIsRejectedOnceAFlagChangesAfterTheSave) {
+    const std::string path = tempPath("catalog_stale.snapshot");
+    Catalog catalog;
+    fill(catalog, 20);
+    SLP_CHECK(catalog.save(path));
+    // Setting a flag to what it already is changes nothing.
+    const bool favorite = catalog.flag(CatalogKind::Sound, 2, CatalogFlag::Favorite);
+    SLP_CHECK(catalog.setFlag(CatalogKind::Sound, 2, CatalogFlag::Favorite, favorite, true));
+    SLP_CHECK(Catalog::load(path) != nullptr);
+
+    // Background, foreground, a favorite toggled in the store, a crash.
+    SLP_CHECK(catalog.setFlag(CatalogKind::Sound, 2, CatalogFlag::Favorite, !favorite, true));
+    SLP_CHECK(Catalog::load(path) == nullptr);
+
+    // The next save holds again, until the loaded copy changes in turn.
+    SLP_CHECK(catalog.save(path));
+    std::unique_ptr<Catalog> loaded = Catalog::load(path);
+    SLP_CHECK(loaded != nullptr);
+    if (!loaded) return;
+    SLP_CHECK_EQ(loaded->flag(CatalogKind::Sound, 2, CatalogFlag::Favorite), !favorite);
+    SLP_CHECK(loaded->select(CatalogKind::Background, 3));
+    SLP_CHECK(Catalog::load(path) == nullptr);
+}
+
+SLP_TEST(damagedOrForeignSnapshotsAreRejected) {
+    const std::string path = tempPath("catalog_damaged.snapshot");
+    SLP_CHECK(Catalog::load(path) == nullptr);
+
+    Catalog catalog;
+    fill(catalog, 20);
+    SLP_CHECK(catalog.save(path));
+    std::vector<char> bytes;
+    {
+        std::ifstream file(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    const auto rewrite = [&](const std::vector<char>& contents) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    };
+
+    std::vector<char> flipped = bytes;
+    flipped[bytes.size() - 5] ^= 0x20;
+    rewrite(flipped);
+    SLP_CHECK(Catalog::load(path) == nullptr);
+
+    std::vector<char> otherVersion = bytes;
+    otherVersion[4] = static_cast<char>(catalog::kVersion + 1);
+    rewrite(otherVersion);
+    SLP_CHECK(Catalog::load(path) == nullptr);
+
+    rewrite(std::vector<char>(bytes.begin(), bytes.end() - 1));
+    SLP_CHECK(Catalog::load(path) == nullptr);
+
+    rewrite(bytes);
+    SLP_CHECK(Catalog::load(path) != nullptr);
+    std::remove(path.c_str());
+}
+
+SLP_TEST(cInterfaceWritesBackThroughTakenChanges) {
+    const std::string path = tempPath("catalog_c.snapshot");
+    SLPCatalog* catalog = SLPCatalogCreate();
+    const SLPCatalogSound rain = {"Rain", "rain.mp3", nullptr, false, true, false};
+    const SLPCatalogSound wind = {"Wind", "wind.mp3", nullptr, true, false, true};
+    const SLPCatalogBackground sheep = {"counting-sheep", nullptr, 2, 1.0f, false, false};
+    uint32_t rainId;
+    uint32_t windId;
+    uint32_t sheepId;
+    SLP_CHECK(SLPCatalogAddSound(catalog, &rain, true, &rainId));
+    SLP_CHECK(SLPCatalogAddSound(catalog, &wind, true, &windId));
+    SLP_CHECK(SLPCatalogAddBackground(catalog, &sheep, true, &sheepId));
+    SLP_CHECK(!SLPCatalogAddSound(catalog, &rain, true, &rainId));
+    SLP_CHECK_EQ(SLPCatalogFind(catalog, SLPCatalogKindSound, "Wind"), windId);
+    SLP_CHECK_EQ(SLPCatalogFind(catalog, SLPCatalogKindSound, "Snow"), SLPCatalogNotFound);
+    SLP_CHECK_EQ(SLPCatalogGetFirst(catalog, SLPCatalogKindSound, SLPCatalogFlagSelected), rainId);
+
+    SLP_CHECK(SLPCatalogSelect(catalog, SLPCatalogKindSound, windId));
+    const uint32_t* ids = nullptr;
+    SLP_CHECK_EQ(SLPCatalogTakeChanges(catalog, SLPCatalogKindSound, &ids), 2u);
+    SLP_CHECK(ids && ids[0] == rainId && ids[1] == windId);
+    SLP_CHECK_EQ(SLPCatalogGetAll(catalog, SLPCatalogKindSound, SLPCatalogFlagSelectedForMixing, &ids), 1u);
+
+    SLPCatalogSound read;
+    SLP_CHECK(SLPCatalogGetSound(catalog, windId, &read));
+    SLP_CHECK_EQ(std::string(read.title), std::string("Wind"));
+    SLP_CHECK(read.soundUrl2 == nullptr);
+    SLP_CHECK(read.isSelected && read.isFavorite && read.isSelectedForMixing);
+    SLP_CHECK(SLPCatalogGetFlag(catalog, SLPCatalogKindSound, windId, SLPCatalogFlagSelected));
+    SLP_CHECK(!SLPCatalogGetFlag(catalog, SLPCatalogKindSound, rainId, SLPCatalogFlagSelected));
+    SLP_CHECK_EQ(std::string(SLPCatalogGetKey(catalog, SLPCatalogKindBackground, sheepId)),
+                 std::string("counting-sheep"));
+
+    const SLPCatalogBackground faster = {"counting-sheep", "sunset", 3, 2.0f, true, true};
+    SLP_CHECK(SLPCatalogUpdateBackground(catalog, sheepId, &faster, false));
+    SLP_CHECK(SLPCatalogSave(catalog, path.c_str()));
+    const uint64_t revision = SLPCatalogGetRevision(catalog);
+    SLPCatalogDestroy(catalog);
+
+    catalog = SLPCatalogLoad(path.c_str());
+    SLP_CHECK(catalog != nullptr);
+    if (catalog) {
+        SLP_CHECK_EQ(SLPCatalogGetRevision(catalog), revision);
+        SLP_CHECK_EQ(SLPCatalogGetCount(catalog, SLPCatalogKindSound), 2u);
+        SLPCatalogBackground background;
+        SLP_CHECK(SLPCatalogGetBackground(catalog, 0, &background));
+        SLP_CHECK_EQ(std::string(background.colorTheme), std::string("sunset"));
+        SLP_CHECK_EQ(background.speedMultiplier, 2.0f);
+        SLP_CHECK_EQ(SLPCatalogTakeChanges(catalog, SLPCatalogKindBackground, &ids), 1u);
+        SLP_CHECK(SLPCatalogRemove(catalog, SLPCatalogKindSound, 0, false));
+        SLP_CHECK(!SLPCatalogIsLive(catalog, SLPCatalogKindSound, 0));
+        SLPCatalogDestroy(catalog);
+    }
+    SLP_CHECK(SLPCatalogLoad("/tmp/sleepster_catalog_missing.snapshot") == nullptr);
+    std::remove(path.c_str());
+}
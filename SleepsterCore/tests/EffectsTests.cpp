@@ -0,0 +1,213 @@
+//
+//  EffectsTests.cpp
+//  SleepsterCore
+//
+
+#include "TestHarness.hpp"
+
+#include "sleepster/Delay.hpp"
+#include "sleepster/DelayLine.hpp"
+#include "sleepster/Reverb.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace sleepster;
+
+namespace {
+
+constexpr double kRate = 48000.0;
+constexpr std::size_t kBlock = 256;
+
+/// Runs `left`/`right` through `effect` block by block, in place.
+template <typename Effect>
+void run(Effect& effect, std::vector<float>& left, std::vector<float>& right) {
+    for (std::size_t offset = 0; offset < left.size(); offset += kBlock) {
+        const std::size_t count = std::min(kBlock, left.size() - offset);
+        effect.process(left.data() + offset, right.data() + offset, count);
+    }
+}
+
+/// Processes `frames` of silence, letting ramps and fades settle.
+template <typename Effect>
+void runSilence(Effect& effect, std::size_t frames) {
+    std::vector<float> left(frames), right(frames);
+    run(effect, left, right);
+}
+
+double rmsDb(const std::vector<float>& samples, std::size_t begin, std::size_t end) {
+    double sum = 0.0;
+    for (std::size_t i = begin; i < end; ++i) sum += double(samples[i]) * samples[i];
+    return 10.0 * std::log10(sum / double(end - begin) + 1e-30);
+}
+
+} // namespace
+
+SLP_TEST(delayLineInterpolatesBetweenTaps) {
+    DelayLine line(64);
+    for (int i = 0; i < 32; ++i) line.write(static_cast<float>(i));
+    SLP_CHECK_EQ(line.read(1), 31.0f);
+    SLP_CHECK_EQ(line.readFractional(5.0f), line.read(5));
+    // Hermite interpolation reproduces a straight line exactly.
+    SLP_CHECK_NEAR(line.readFractional(5.25f), 31.0f - 4.25f, 1e-4f);
+
+    float block[8];
+    line.readBlock(8, block, 8);
+    for (int i = 0; i < 8; ++i) SLP_CHECK_EQ(block[i], static_cast<float>(24 + i));
+}
+
+SLP_TEST(disabledEffectsLeaveTheSignalUntouched) {
+    StereoDelay delay(kRate, kBlock);
+    FdnReverb reverb(kRate, kBlock);
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    std::vector<float> left(4096), right(4096);
+    for (std::size_t i = 0; i < left.size(); ++i) left[i] = right[i] = dist(rng);
+    const std::vector<float> original = left;
+
+    run(delay, left, right);
+    run(reverb, left, right);
+    SLP_CHECK(left == original);
+    SLP_CHECK(!delay.isRunning());
+    SLP_CHECK(!reverb.isRunning());
+}
+
+SLP_TEST(delayEchoesAtTheSetTime) {
+    StereoDelay delay(kRate, kBlock);
+    delay.setTime(0.01);
+    delay.setFeedback(0.5f);
+    delay.setMix(0.5f);
+    delay.setEnabled(true);
+    runSilence(delay, 2048);
+
+    std::vector<float> left(4096), right(4096);
+    left[100] = right[100] = 1.0f;
+    run(delay, left, right);
+    SLP_CHECK_NEAR(left[100], 0.5f, 1e-6f);
+    SLP_CHECK_NEAR(left[580], 0.5f, 1e-6f);
+    SLP_CHECK_NEAR(left[1060], 0.25f, 1e-6f);
+    SLP_CHECK_NEAR(left[1540], 0.125f, 1e-6f);
+    SLP_CHECK_NEAR(left[400], 0.0f, 1e-6f);
+}
+
+SLP_TEST(delayTimeChangeGlidesWithoutJumps) {
+    StereoDelay delay(kRate, kBlock);
+    delay.setTime(0.05);
+    delay.setFeedback(0.0f);
+    delay.setMix(1.0f);
+    delay.setEnabled(true);
+
+    constexpr double kFrequency = 440.0;
+    const std::size_t frames = 192 * kBlock;
+    std::vector<float> left(frames), right(frames);
+    for (std::size_t i = 0; i < frames; ++i) {
+        left[i] = right[i] = 0.5f * static_cast<float>(std::sin(2.0 * M_PI * kFrequency * i / kRate));
+    }
+
+    float largestStep = 0.0f;
+    for (std::size_t offset = 0; offset < frames; offset += kBlock) {
+        if (offset == frames / 2) delay.setTime(0.08);
+        delay.process(left.data() + offset, right.data() + offset, std::min(kBlock, frames - offset));
+    }
+    // Skip the start, where the line is still filling.
+    for (std::size_t i = frames / 4; i + 1 < frames; ++i) {
+        largestStep = std::max(largestStep, std::fabs(left[i + 1] - left[i]));
+    }
+    // The steepest slope of the sine, bent up in pitch by at most the glide
+    // rate; a jump of the tap would show up as a step of up to 1.0.
+    const float bound = 0.5f * static_cast<float>(2.0 * M_PI * kFrequency / kRate) * (1.0f + StereoDelay::kMaxGlideRate);
+    SLP_CHECK(largestStep <= bound * 1.05f);
+}
+
+SLP_TEST(reverbDecaysAtThePresetRate) {
+    for (ReverbPreset preset : {ReverbPreset::Room, ReverbPreset::Hall, ReverbPreset::Cathedral, ReverbPreset::Plate}) {
+        FdnReverb reverb(kRate, kBlock);
+        reverb.setPreset(preset);
+        reverb.setMix(1.0f);
+        reverb.setEnabled(true);
+        runSilence(reverb, 2048);
+
+        // A short low-passed noise burst, so the damping filter barely
+        // shortens the tail being measured.
+        const double decay = FdnReverb::decaySeconds(preset);
+        const std::size_t frames = static_cast<std::size_t>((decay + 0.2) * kRate);
+        std::vector<float> left(frames), right(frames);
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        float low = 0.0f;
+        for (std::size_t i = 0; i < 2400; ++i) {
+            low += 0.05f * (dist(rng) - low);
+            left[i] = right[i] = low;
+        }
+        run(reverb, left, right);
+
+        // Slope between two windows well into the tail, against -60 dB per
+        // decay time.
+        const auto at = [&](double seconds) { return static_cast<std::size_t>(seconds * kRate); };
+        const double window = 0.05;
+        const double t1 = 0.2 + 0.2 * decay;
+        const double t2 = 0.2 + 0.7 * decay;
+        const double db1 = rmsDb(left, at(t1), at(t1 + window));
+        const double db2 = rmsDb(left, at(t2), at(t2 + window));
+        const double measured = 60.0 * (t2 - t1) / (db1 - db2);
+        SLP_CHECK(measured > 0.7 * decay && measured < 1.3 * decay);
+        SLP_CHECK(std::isfinite(db1) && db1 < 0.0);
+    }
+}
+
+SLP_TEST(reverbSleepsAfterItsTailAndWakesOnInput) {
+    FdnReverb reverb(kRate, kBlock);
+    reverb.setPreset(ReverbPreset::Room);
+    reverb.setMix(0.5f);
+    reverb.setEnabled(true);
+
+    std::vector<float> left(kBlock, 0.5f), right(kBlock, 0.5f);
+    run(reverb, left, right);
+    SLP_CHECK(reverb.isRunning());
+
+    // Room decays in 0.7 s; its tail is over well within three seconds.
+    runSilence(reverb, static_cast<std::size_t>(3.0 * kRate));
+    SLP_CHECK(!reverb.isRunning());
+
+    std::vector<float> quiet(kBlock), silent(kBlock);
+    run(reverb, quiet, silent);
+    SLP_CHECK(!reverb.isRunning());
+
+    std::fill(left.begin(), left.end(), 0.5f);
+    std::fill(right.begin(), right.end(), 0.5f);
+    run(reverb, left, right);
+    SLP_CHECK(reverb.isRunning());
+}
+
+SLP_TEST(disablingFadesOutAndThenBypasses) {
+    StereoDelay delay(kRate, kBlock);
+    delay.setMix(0.5f);
+    delay.setEnabled(true);
+    FdnReverb reverb(kRate, kBlock);
+    reverb.setMix(0.5f);
+    reverb.setEnabled(true);
+
+    std::vector<float> left(8192, 0.25f), right(8192, 0.25f);
+    run(delay, left, right);
+    run(reverb, left, right);
+    SLP_CHECK(delay.isRunning());
+    SLP_CHECK(reverb.isRunning());
+
+    delay.setEnabled(false);
+    reverb.setEnabled(false);
+    std::fill(left.begin(), left.end(), 0.25f);
+    std::fill(right.begin(), right.end(), 0.25f);
+    run(delay, left, right);
+    run(reverb, left, right);
+    SLP_CHECK(!delay.isRunning());
+    SLP_CHECK(!reverb.isRunning());
+    // Fully dry after the 10 ms fade.
+    SLP_CHECK_EQ(left.back(), 0.25f);
+    float largestStep = 0.0f;
+    for (std::size_t i = 0; i + 1 < left.size(); ++i) {
+        largestStep = std::max(largestStep, std::fabs(left[i + 1] - left[i]));
+    }
+    SLP_CHECK(largestStep < 0.01f);
+}
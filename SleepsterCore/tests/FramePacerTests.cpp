@@ -0,0 +1,168 @@
+//
+//  FramePacerTests.cpp
+//  SleepsterCore
+//
+//  The pacer is driven by synthetic frame-time traces: a device model that
+//  needs a given amount of work per frame and presents on a 60 Hz display,
+//  so each frame lasts a whole number of refreshes.
+//
+
+#include "TestHarness.hpp"
+
+#include "SLPFramePacer.h"
+#include "sleepster/FramePacer.hpp"
+
+#include <cmath>
+
+using namespace sleepster;
+
+namespace {
+
+constexpr double kRefresh = 1.0 / 60.0;
+
+/// How long a frame that takes `work` seconds is on screen at `fps`.
+double presented(double work, double fps) {
+    const double refreshes = std::max(std::ceil(work / kRefresh - 1e-9), std::round(60.0 / fps));
+    return refreshes * kRefresh;
+}
+
+/// Runs the pacer for `seconds` against a device needing `work` per frame.
+/// Returns the seconds spent at each level.
+std::array<double, 4> run(FramePacer& pacer, double seconds, double work) {
+    std::array<double, 4> time{};
+    for (double t = 0.0; t < seconds;) {
+        const double frame = presented(work, pacer.targetFramesPerSecond());
+        time[pacer.level()] += frame;
+        pacer.recordFrame(frame);
+        t += frame;
+    }
+    return time;
+}
+
+} // namespace
+
+SLP_TEST(histogramPercentilesCoverTheRollingWindow) {
+    FrameTimeHistogram histogram(10);
+    SLP_CHECK_EQ(histogram.percentile(0.5), 0.0);
+    for (int ms = 1; ms <= 10; ++ms) histogram.record(ms / 1000.0);
+    SLP_CHECK_NEAR(histogram.percentile(0.5), 0.005, 1e-9);
+    SLP_CHECK_NEAR(histogram.percentile(0.9), 0.009, 1e-9);
+    SLP_CHECK_NEAR(histogram.percentile(1.0), 0.010, 1e-9);
+
+    // Ten newer frames push every old one out.
+    for (int i = 0; i < 10; ++i) histogram.record(0.020);
+    SLP_CHECK_EQ(histogram.count(), 10u);
+    SLP_CHECK_NEAR(histogram.percentile(0.0), 0.020, 1e-9);
+
+    // Frames past the range share the last bin.
+    histogram.record(1.5);
+    SLP_CHECK_NEAR(histogram.percentile(1.0), 0.1, 1e-9);
+}
+
+SLP_TEST(isolatedHitchesKeepSixtyFps) {
+    // The old monitor dropped to battery mode on the first slow frame.
+    FramePacer pacer;
+    for (int second = 0; second < 60; ++second) {
+        for (int frame = 0; frame < 59; ++frame) pacer.recordFrame(kRefresh);
+        pacer.recordFrame(0.1);
+    }
+    SLP_CHECK_EQ(pacer.level(), 0);
+    SLP_CHECK_EQ(pacer.levelChangeCount(), 0u);
+    SLP_CHECK_EQ(pacer.lateFrameCount(), 60u);
+    SLP_CHECK(pacer.percentile(0.9) < 0.017);
+    SLP_CHECK(pacer.percentile(0.99) > 0.09);
+}
+
+SLP_TEST(sustainedSlowFramesDropToTheRateTheyFit) {
+    FramePacer thirty;
+    run(thirty, 3.0, 0.022);
+    SLP_CHECK_EQ(thirty.targetFramesPerSecond(), 30.0);
+    SLP_CHECK(thirty.tier() == QualityTier::Full);
+    SLP_CHECK_EQ(thirty.levelChangeCount(), 1u);
+    const LevelChange& change = thirty.recentChange(0);
+    SLP_CHECK_EQ(change.from, 0);
+    SLP_CHECK_EQ(change.to, 1);
+    SLP_CHECK(change.frameTime > kRefresh * 1.25);
+    // Decided on the first judged window, half a second in.
+    SLP_CHECK(change.time < 1.1);
+
+    // Far too slow for anything faster goes straight to the bottom.
+    FramePacer fifteen;
+    run(fifteen, 5.0, 0.06);
+    SLP_CHECK_EQ(fifteen.targetFramesPerSecond(), 15.0);
+    SLP_CHECK(fifteen.tier() == QualityTier::Minimal);
+    SLP_CHECK_EQ(fifteen.levelChangeCount(), 1u);
+
+    FramePacer twenty;
+    run(twenty, 5.0, 0.045);
+    SLP_CHECK(twenty.tier() == QualityTier::Reduced);
+}
+
+SLP_TEST(recoversOnceTheLoadIsGone) {
+    FramePacer pacer;
+    run(pacer, 10.0, 0.022);
+    SLP_CHECK_EQ(pacer.level(), 1);
+    // Probing during the load failed and lengthened the hold.
+    const uint64_t changes = pacer.levelChangeCount();
+    const double hold = pacer.holdSeconds();
+    SLP_CHECK(hold > 5.0);
+
+    // The next probe comes within the hold, and sticks.
+    const auto time = run(pacer, 30.0, 0.008);
+    SLP_CHECK_EQ(pacer.level(), 0);
+    SLP_CHECK_EQ(pacer.levelChangeCount(), changes + 1);
+    SLP_CHECK(time[1] <= hold);
+    SLP_CHECK_EQ(pacer.holdSeconds(), 5.0);
+}
+
+SLP_TEST(marginalDeviceBacksOffInsteadOfOscillating) {
+    // 18 ms of work: 60 fps never fits, and every probe says so again.
+    FramePacer pacer;
+    const auto time = run(pacer, 20 * 60.0, 0.018);
+    const double total = time[0] + time[1] + time[2] + time[3];
+    SLP_CHECK_EQ(pacer.level(), 1);
+    SLP_CHECK(time[1] / total > 0.98);
+    SLP_CHECK(time[2] + time[3] == 0.0);
+    // Probes after 5, 10, 20, 40, 80 s and then every 120 s: 14 in twenty
+    // minutes, two changes each plus the first drop.
+    SLP_CHECK(pacer.levelChangeCount() <= 30u);
+    SLP_CHECK_EQ(pacer.holdSeconds(), 120.0);
+    SLP_CHECK_EQ(pacer.recentChangeCount(), FramePacer::kChangeHistory);
+    const LevelChange& last = pacer.recentChange(FramePacer::kChangeHistory - 1);
+    SLP_CHECK_EQ(last.from, 0);
+    SLP_CHECK_EQ(last.to, 1);
+}
+
+SLP_TEST(fixedTimestepRunsTheSameStepsAtAnyDisplayRate) {
+    for (double hz : {30.0, 50.0, 60.0, 120.0, 144.0}) {
+        FixedTimestep clock;
+        int steps = 0;
+        for (int frame = 0; frame < static_cast<int>(hz) * 2; ++frame) {
+            steps += clock.advance(1.0 / hz);
+            SLP_CHECK(clock.alpha() >= 0.0 && clock.alpha() <= 1.0);
+        }
+        SLP_CHECK(steps >= 119 && steps <= 120);
+    }
+
+    // A stall simulates at most maxSteps and drops the rest.
+    FixedTimestep clock(1.0 / 60.0, 8);
+    SLP_CHECK_EQ(clock.advance(2.0), 8);
+    SLP_CHECK_EQ(clock.alpha(), 0.0);
+    SLP_CHECK_EQ(clock.advance(0.5 / 60.0), 0);
+    SLP_CHECK_NEAR(clock.alpha(), 0.5, 1e-9);
+}
+
+SLP_TEST(cInterfaceReportsLevelAndMetrics) {
+    SLPFramePacer* pacer = SLPFramePacerCreate();
+    bool changed = false;
+    for (int frame = 0; frame < 60; ++frame) changed |= SLPFramePacerRecordFrame(pacer, 0.07);
+    SLP_CHECK(changed);
+    SLP_CHECK_EQ(SLPFramePacerGetTargetFramesPerSecond(pacer), 15.0);
+    SLP_CHECK_EQ(SLPFramePacerGetTier(pacer), SLPQualityTierMinimal);
+    const SLPFramePacerMetrics metrics = SLPFramePacerGetMetrics(pacer);
+    SLP_CHECK_EQ(metrics.frames, 60u);
+    SLP_CHECK_EQ(metrics.levelChanges, 1u);
+    SLP_CHECK_NEAR(metrics.p50, 0.07, 1e-9);
+    SLP_CHECK(metrics.p99 >= metrics.p90 && metrics.p90 >= metrics.p50);
+    SLPFramePacerDestroy(pacer);
+}
@@ -0,0 +1,191 @@
+//
+//  GainRampTests.cpp
+//  SleepsterCore
+//
+
+#include "TestHarness.hpp"
+
+#include "sleepster/GainRamp.hpp"
+#include "sleepster/Mixer.hpp"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace sleepster;
+
+namespace {
+
+static_assert(ramp_detail::kLinear.front() == 0.0f && ramp_detail::kLinear.back() == 1.0f);
+static_assert(ramp_detail::kEqualPower.front() == 0.0f);
+static_assert(ramp_detail::kExponential.front() == 0.0f);
+
+/// Emits 1.0 on both channels forever, so the output is the gain itself.
+class UnitSource final : public AudioSource {
+public:
+    std::size_t render(float* left, float* right, std::size_t frames) noexcept override {
+        for (std::size_t i = 0; i < frames; ++i) left[i] = right[i] = 1.0f;
+        return frames;
+    }
+};
+
+MixerConfig rampConfig() {
+    MixerConfig config;
+    config.sampleRate = 48000.0;
+    config.maxVoices = 4;
+    config.maxBlockFrames = 256;
+    return config;
+}
+
+/// Renders `frames` in deliberately awkward block sizes.
+std::vector<float> renderFrames(Mixer& mixer, std::size_t frames) {
+    std::vector<float> out(frames), scratch(frames);
+    std::size_t offset = 0;
+    while (offset < frames) {
+        const std::size_t block = std::min<std::size_t>(37, frames - offset);
+        mixer.render(out.data() + offset, scratch.data() + offset, block);
+        offset += block;
+    }
+    return out;
+}
+
+} // namespace
+
+SLP_TEST(curveTablesMatchReferenceFunctions) {
+    const double floor = std::pow(10.0, -kExponentialRangeDb / 20.0);
+    for (int i = 0; i <= 64; ++i) {
+        const double t = i / 64.0;
+        SLP_CHECK_NEAR(rampShape(RampCurve::Linear, t), t, 1e-6);
+        SLP_CHECK_NEAR(rampShape(RampCurve::EqualPower, t), std::sin(t * M_PI / 2.0), 1e-4);
+        const double db = std::pow(10.0, -kExponentialRangeDb / 20.0 * (1.0 - t));
+        SLP_CHECK_NEAR(rampShape(RampCurve::Exponential, t), (db - floor) / (1.0 - floor), 1e-4);
+    }
+}
+
+SLP_TEST(linearRampIsSampleAccurateAcrossBlocks) {
+    GainRamp ramp(0.0f);
+    ramp.start(1.0f, 1000, RampCurve::Linear);
+    std::vector<float> gains;
+    while (ramp.isRamping()) {
+        float start = 0.0f, end = 0.0f;
+        const std::size_t span = ramp.nextSpan(37, start, end);
+        for (std::size_t i = 1; i <= span; ++i) {
+            gains.push_back(start + (end - start) * static_cast<float>(i) / static_cast<float>(span));
+        }
+    }
+    SLP_CHECK_EQ(gains.size(), 1000u);
+    for (std::size_t i = 0; i < gains.size(); ++i) {
+        SLP_CHECK_NEAR(gains[i], static_cast<float>(i + 1) / 1000.0f, 1e-5f);
+    }
+    SLP_CHECK_EQ(ramp.current(), 1.0f);
+}
+
+SLP_TEST(advancingLandsWhereRenderingWould) {
+    GainRamp rendered(0.2f);
+    GainRamp skipped(0.2f);
+    rendered.start(0.9f, 4800, RampCurve::EqualPower);
+    skipped.start(0.9f, 4800, RampCurve::EqualPower);
+    for (std::size_t done = 0; done < 1234;) {
+        float start = 0.0f, end = 0.0f;
+        done += rendered.nextSpan(1234 - done, start, end);
+    }
+    skipped.advance(1234);
+    SLP_CHECK_EQ(skipped.current(), rendered.current());
+
+    // Both continue identically from there, and advancing past the end
+    // settles on the target.
+    float a0 = 0.0f, a1 = 0.0f, b0 = 0.0f, b1 = 0.0f;
+    SLP_CHECK_EQ(rendered.nextSpan(512, a0, a1), skipped.nextSpan(512, b0, b1));
+    SLP_CHECK_EQ(a1, b1);
+    skipped.advance(100000);
+    SLP_CHECK(!skipped.isRamping());
+    SLP_CHECK_EQ(skipped.current(), 0.9f);
+}
+
+SLP_TEST(mixerRampReachesTargetOnScheduledSample) {
+    Mixer mixer(rampConfig());
+    const VoiceId voice = mixer.play(std::make_unique<UnitSource>(), 0.0f);
+    const RampToken token = mixer.rampVolume(voice, 1.0f, 0.5, RampCurve::Linear);
+    SLP_CHECK(token != 0);
+
+    const std::vector<float> out = renderFrames(mixer, 24000 + 100);
+    float largestStep = 0.0f;
+    for (std::size_t i = 1; i < 24000; ++i) largestStep = std::fmax(largestStep, out[i] - out[i - 1]);
+    // A stepped fade would jump by far more than one sample's worth.
+    SLP_CHECK(largestStep < 1.5f / 24000.0f);
+    SLP_CHECK(out[23998] < 1.0f);
+    SLP_CHECK_NEAR(out[23999], 1.0f, 1e-6f);
+    SLP_CHECK_EQ(out.back(), 1.0f);
+
+    SLP_CHECK(mixer.waitForEvents(0));
+    MixerEvent events[4];
+    SLP_CHECK_EQ(mixer.collectEvents(events, 4), 1u);
+    SLP_CHECK(events[0].type == MixerEventType::RampFinished);
+    SLP_CHECK_EQ(events[0].voice, voice);
+    SLP_CHECK_EQ(events[0].ramp, token);
+}
+
+SLP_TEST(equalPowerCrossfadeKeepsPowerConstant) {
+    Mixer fadeIn(rampConfig());
+    Mixer fadeOut(rampConfig());
+    fadeIn.rampVolume(fadeIn.play(std::make_unique<UnitSource>(), 0.0f), 1.0f, 0.1,
+                      RampCurve::EqualPower);
+    fadeOut.rampVolume(fadeOut.play(std::make_unique<UnitSource>(), 1.0f), 0.0f, 0.1,
+                       RampCurve::EqualPower);
+    const std::vector<float> a = renderFrames(fadeIn, 4800);
+    const std::vector<float> b = renderFrames(fadeOut, 4800);
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        SLP_CHECK_NEAR(a[i] * a[i] + b[i] * b[i], 1.0f, 1e-3f);
+    }
+}
+
+SLP_TEST(exponentialRampIsEvenInDecibels) {
+    Mixer mixer(rampConfig());
+    mixer.rampVolume(mixer.play(std::make_unique<UnitSource>(), 1.0f), 0.0f, 1.0,
+                     RampCurve::Exponential);
+    const std::vector<float> out = renderFrames(mixer, 48000);
+    // Halfway through a 60 dB ramp the level is about -30 dB. The curve is
+    // lowered slightly so that it lands on exactly zero, hence the tolerance.
+    SLP_CHECK_NEAR(20.0f * std::log10(out[11999]), -15.0f, 0.5f);
+    SLP_CHECK_NEAR(20.0f * std::log10(out[23999]), -30.0f, 0.5f);
+}
+
+SLP_TEST(stopWhenDoneReleasesVoiceAfterRamp) {
+    Mixer mixer(rampConfig());
+    const VoiceId voice = mixer.play(std::make_unique<UnitSource>(), 1.0f);
+    const RampToken token = mixer.rampVolume(voice, 0.0f, 0.01, RampCurve::Exponential, true);
+    renderFrames(mixer, 1000);
+
+    MixerEvent events[4];
+    SLP_CHECK_EQ(mixer.collectEvents(events, 4), 1u);
+    SLP_CHECK(events[0].type == MixerEventType::RampFinished);
+    SLP_CHECK_EQ(events[0].ramp, token);
+    SLP_CHECK(!mixer.isActive(voice));
+    SLP_CHECK_EQ(mixer.activeVoiceCount(), 0u);
+}
+
+SLP_TEST(supersededRampIsCancelled) {
+    Mixer mixer(rampConfig());
+    const VoiceId voice = mixer.play(std::make_unique<UnitSource>(), 0.0f);
+    const RampToken first = mixer.rampVolume(voice, 1.0f, 10.0, RampCurve::Linear);
+    renderFrames(mixer, 256);
+    const RampToken second = mixer.rampVolume(voice, 0.5f, 0.001, RampCurve::Linear);
+    renderFrames(mixer, 256);
+
+    MixerEvent events[4];
+    SLP_CHECK_EQ(mixer.collectEvents(events, 4), 2u);
+    SLP_CHECK(events[0].type == MixerEventType::RampCancelled);
+    SLP_CHECK_EQ(events[0].ramp, first);
+    SLP_CHECK(events[1].type == MixerEventType::RampFinished);
+    SLP_CHECK_EQ(events[1].ramp, second);
+
+    // Stopping mid-ramp cancels it too.
+    const RampToken third = mixer.rampVolume(voice, 1.0f, 10.0, RampCurve::Linear);
+    renderFrames(mixer, 64);
+    mixer.stop(voice);
+    renderFrames(mixer, 512);
+    SLP_CHECK_EQ(mixer.collectEvents(events, 4), 1u);
+    SLP_CHECK(events[0].type == MixerEventType::RampCancelled);
+    SLP_CHECK_EQ(events[0].ramp, third);
+    SLP_CHECK(!mixer.isActive(voice));
+}
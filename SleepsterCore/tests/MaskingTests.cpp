@@ -0,0 +1,298 @@
+//
+//  MaskingTests.cpp
+//  SleepsterCore
+//
+//  The controller runs against a simulated bedroom: the app's pink noise,
+//  shaped by the gain and EQ offsets the controller last asked for, reaches
+//  the microphone through the phone's speaker along with the room's own
+//  noise. Only the analysis windows are synthesized; the rest of each
+//  period is skipped, as the controller skips it.
+//
+
+#include "TestHarness.hpp"
+
+#include "SLPMasking.h"
+#include "sleepster/EchoReference.hpp"
+#include "sleepster/Equalizer.hpp"
+#include "sleepster/MaskingController.hpp"
+#include "sleepster/NoiseSource.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace sleepster;
+
+namespace {
+
+constexpr double kRate = 16000.0;
+constexpr std::size_t kBlock = 256;
+
+float fromDb(float db) {
+    return std::pow(10.0f, db / 20.0f);
+}
+
+class Room {
+public:
+    /// `echoDb` is the speaker-to-microphone coupling in amplitude.
+    explicit Room(float echoDb = -6.0f, NoiseColor roomColor = NoiseColor::Brown)
+        : output_(NoiseColor::Pink, 1), room_(roomColor, 2), equalizer_(kRate, kBlock), echo_(fromDb(echoDb)) {
+        output_.prepare(kRate, kBlock);
+        room_.prepare(kRate, kBlock);
+        equalizer_.setEnabled(true);
+    }
+
+    /// Room noise level relative to the app's noise at the user's volume.
+    float roomDb = -10.0f;
+    bool playing = true;
+    /// The controller's gain after each window.
+    std::vector<float> gains;
+
+    void run(MaskingController& controller, double seconds) {
+        std::size_t remaining = static_cast<std::size_t>(seconds * kRate);
+        while (remaining > 0) {
+            if (!controller.listening()) {
+                const std::size_t skip = std::min(remaining, controller.samplesUntilWindow());
+                controller.advance(skip);
+                remaining -= skip;
+                continue;
+            }
+            const std::size_t frames = std::min(remaining, kBlock);
+            output_.render(left_, right_, frames);
+            equalizer_.process(left_, right_, frames);
+            room_.render(roomLeft_, roomRight_, frames);
+            const float roomGain = fromDb(roomDb);
+            for (std::size_t i = 0; i < frames; ++i) {
+                reference_[i] = playing ? gain_ * 0.5f * (left_[i] + right_[i]) : 0.0f;
+                microphone_[i] = echo_ * reference_[i] + roomGain * roomLeft_[i];
+            }
+            const uint64_t windows = controller.windows();
+            controller.process(microphone_, reference_, frames);
+            remaining -= frames;
+            if (controller.windows() != windows) closeWindow(controller);
+        }
+    }
+
+private:
+    void closeWindow(MaskingController& controller) {
+        MaskingDecision decision;
+        if (controller.takeDecision(decision)) {
+            gain_ = fromDb(decision.gainDb);
+            equalizer_.setGains(decision.eqDb.data(), decision.eqDb.size());
+        }
+        gains.push_back(controller.decision().gainDb);
+    }
+
+    NoiseSource output_;
+    NoiseSource room_;
+    Equalizer equalizer_;
+    float echo_;
+    float gain_ = 1.0f;
+    float left_[kBlock];
+    float right_[kBlock];
+    float roomLeft_[kBlock];
+    float roomRight_[kBlock];
+    float reference_[kBlock];
+    float microphone_[kBlock];
+};
+
+MaskingConfig config() {
+    MaskingConfig config;
+    config.sampleRate = kRate;
+    return config;
+}
+
+/// Times the gain changed direction, after `from` windows.
+int reversals(const std::vector<float>& gains, std::size_t from) {
+    int count = 0;
+    float lastStep = 0.0f;
+    for (std::size_t i = std::max<std::size_t>(from, 1); i < gains.size(); ++i) {
+        const float step = gains[i] - gains[i - 1];
+        if (step == 0.0f) continue;
+        if (lastStep != 0.0f && (step > 0.0f) != (lastStep > 0.0f)) ++count;
+        lastStep = step;
+    }
+    return count;
+}
+
+} // namespace
+
+SLP_TEST(echoReferenceReturnsWhatWasPlayed) {
+    EchoReference reference(100);
+    SLP_CHECK_EQ(reference.capacity(), std::size_t{128});
+    float left[32];
+    float right[32];
+    for (int i = 0; i < 32; ++i) {
+        left[i] = static_cast<float>(i);
+        right[i] = static_cast<float>(i) + 2.0f;
+    }
+    reference.write(left, right, 32, 1000);
+    reference.write(left, right, 32, 1032);
+    float out[40];
+    SLP_CHECK(reference.read(out, 40, 1010));
+    SLP_CHECK_EQ(out[0], 11.0f);
+    SLP_CHECK_EQ(out[30], 9.0f);
+    SLP_CHECK(!reference.read(out, 40, 1030));
+    SLP_CHECK(!reference.read(out, 10, 990));
+
+    // A gap plays as silence; older samples fall out of the ring.
+    reference.write(left, right, 32, 1100);
+    SLP_CHECK(reference.read(out, 10, 1070));
+    SLP_CHECK_EQ(out[0], 0.0f);
+    SLP_CHECK_EQ(out[9], 0.0f);
+    SLP_CHECK(!reference.read(out, 10, 1000));
+
+    // A step back to samples still held overwrites them in place.
+    float louder[32];
+    for (int i = 0; i < 32; ++i) louder[i] = 100.0f;
+    reference.write(louder, louder, 32, 1098);
+    SLP_CHECK_EQ(reference.end(), int64_t{1132});
+    SLP_CHECK(reference.read(out, 40, 1070));
+    SLP_CHECK_EQ(out[27], 0.0f);
+    SLP_CHECK_EQ(out[28], 100.0f);
+    SLP_CHECK_EQ(out[33], 100.0f);
+    SLP_CHECK(reference.read(out, 2, 1130));
+    SLP_CHECK_EQ(out[0], 31.0f);
+
+    // Going back in time past them starts a new history.
+    reference.write(left, right, 32, 500);
+    SLP_CHECK_EQ(reference.end(), int64_t{532});
+    SLP_CHECK(!reference.read(out, 10, 1100));
+    SLP_CHECK(reference.read(out, 10, 500));
+    SLP_CHECK_EQ(out[3], 4.0f);
+}
+
+SLP_TEST(theEchoIsTakenOutOfTheRoom) {
+    // The same room heard with the app playing and with it silent.
+    MaskingController playing(config());
+    MaskingController silent(config());
+    Room withOutput(-6.0f);
+    Room withoutOutput(-6.0f);
+    withOutput.roomDb = -6.0f;
+    withoutOutput.roomDb = -6.0f;
+    withoutOutput.playing = false;
+    withOutput.run(playing, 300.0);
+    withoutOutput.run(silent, 300.0);
+
+    int measured = 0;
+    for (std::size_t b = 0; b < MaskingController::kBandCount; ++b) {
+        if (!playing.measures(b)) continue;
+        ++measured;
+        SLP_CHECK_NEAR(playing.couplingDb(b), -6.0f, 1.0f);
+        SLP_CHECK_NEAR(playing.ambientDb(b), silent.ambientDb(b), 2.0f);
+    }
+    SLP_CHECK_EQ(measured, 7);
+}
+
+SLP_TEST(aLouderRoomRaisesTheMixAndAQuieterOneLowersIt) {
+    MaskingController controller(config());
+    Room room;
+    room.roomDb = -20.0f;
+    room.run(controller, 600.0);
+    const float quiet = controller.decision().gainDb;
+    SLP_CHECK(quiet < -3.0f);
+
+    room.roomDb = 0.0f;
+    room.run(controller, 600.0);
+    const float loud = controller.decision().gainDb;
+    SLP_CHECK(loud > quiet + 10.0f);
+    SLP_CHECK(controller.decision().coverage >= 0.75f);
+
+    room.roomDb = -20.0f;
+    room.run(controller, 900.0);
+    SLP_CHECK_NEAR(controller.decision().gainDb, quiet, 1.5f);
+}
+
+SLP_TEST(theLoopSettlesWithoutHunting) {
+    MaskingController controller(config());
+    Room room(-10.0f, NoiseColor::Pink);
+    room.roomDb = -4.0f;
+    room.run(controller, 3600.0);
+
+    // Settled within five minutes, then held.
+    const std::size_t settled = 75;
+    SLP_CHECK(room.gains.size() > 800);
+    SLP_CHECK(reversals(room.gains, 0) <= 2);
+    const auto [low, high] = std::minmax_element(room.gains.begin() + settled, room.gains.end());
+    SLP_CHECK(*high - *low <= 1.0f);
+    SLP_CHECK(controller.decision().coverage >= 0.75f);
+}
+
+SLP_TEST(gainsStayWithinTheirLimits) {
+    const MaskingConfig limits = config();
+    MaskingController loud(limits);
+    Room roaring;
+    roaring.roomDb = 30.0f;
+    roaring.run(loud, 600.0);
+    SLP_CHECK_EQ(loud.decision().gainDb, limits.maxGainDb);
+    for (float offset : loud.decision().eqDb) SLP_CHECK(std::fabs(offset) <= limits.maxEqDb);
+
+    // A silent room turns the mix down to the floor but the offsets only
+    // reshape it.
+    MaskingController quiet(limits);
+    Room silent;
+    silent.roomDb = -120.0f;
+    silent.run(quiet, 600.0);
+    SLP_CHECK_EQ(quiet.decision().gainDb, limits.minGainDb);
+    const auto& offsets = quiet.decision().eqDb;
+    SLP_CHECK(*std::max_element(offsets.begin(), offsets.end()) >= 0.0f);
+}
+
+SLP_TEST(windowsOpenOncePerPeriod) {
+    MaskingController controller(config());
+    Room room;
+    room.run(controller, 400.0);
+    SLP_CHECK_EQ(controller.windows(), uint64_t{100});
+    // 0.3 s of 32 ms frames out of every 4 s.
+    SLP_CHECK_EQ(controller.frameSize(), std::size_t{512});
+    SLP_CHECK_EQ(controller.analyzedFrames(), uint64_t{900});
+    SLP_CHECK(controller.memoryBytes() < 64 * 1024);
+}
+
+SLP_TEST(cInterfaceMatchesTheMicrophoneWithWhatWasPlaying) {
+    SLPEchoReference* reference = SLPEchoReferenceCreate(kRate);
+    SLPMaskingController* controller = SLPMaskingControllerCreate(kRate, 0.02);
+    const int64_t delay = 320;
+
+    NoiseSource output(NoiseColor::Pink, 5);
+    NoiseSource roomNoise(NoiseColor::Brown, 6);
+    output.prepare(kRate, kBlock);
+    roomNoise.prepare(kRate, kBlock);
+    std::vector<float> played;
+    std::vector<float> left(kBlock);
+    std::vector<float> right(kBlock);
+    std::vector<float> microphone(kBlock);
+    const int64_t start = 1000000;
+    for (int64_t position = start; position < start + static_cast<int64_t>(120 * kRate); position += kBlock) {
+        output.render(left.data(), right.data(), kBlock);
+        SLPEchoReferenceWrite(reference, left.data(), right.data(), kBlock, position);
+        for (std::size_t i = 0; i < kBlock; ++i) played.push_back(0.5f * (left[i] + right[i]));
+
+        // The microphone hears, now, what was played `delay` ago.
+        const int64_t echoed = position - delay;
+        if (echoed < start) continue;
+        roomNoise.render(left.data(), right.data(), kBlock);
+        for (std::size_t i = 0; i < kBlock; ++i) {
+            microphone[i] = 0.5f * played[static_cast<std::size_t>(echoed - start) + i] + 0.3f * left[i];
+        }
+        SLPMaskingControllerProcess(controller, reference, microphone.data(), kBlock, position);
+    }
+
+    SLPMaskingDecision decision;
+    SLP_CHECK(SLPMaskingControllerTakeDecision(controller, &decision));
+    SLP_CHECK(!SLPMaskingControllerTakeDecision(controller, &decision));
+    SLPMaskingMetrics metrics = SLPMaskingControllerGetMetrics(controller);
+    SLP_CHECK_EQ(metrics.windows, uint64_t{30});
+    SLP_CHECK_EQ(metrics.unmatchedBuffers, uint64_t{0});
+
+    // Output that was never recorded cannot be matched.
+    const int64_t future = start + static_cast<int64_t>(200 * kRate);
+    for (int i = 0; i < 250; ++i) {
+        SLPMaskingControllerProcess(controller, reference, microphone.data(), kBlock, future + i * kBlock);
+    }
+    metrics = SLPMaskingControllerGetMetrics(controller);
+    SLP_CHECK(metrics.unmatchedBuffers > 0);
+
+    SLPMaskingControllerDestroy(controller);
+    SLPEchoReferenceDestroy(reference);
+}
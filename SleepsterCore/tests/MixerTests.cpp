@@ -0,0 +1,163 @@
+//
+//  MixerTests.cpp
+//  SleepsterCore
+//
+
+#include "TestHarness.hpp"
+
+#include "sleepster/Mixer.hpp"
+#include "sleepster/NullAudioSink.hpp"
+#include "sleepster/PcmSource.hpp"
+
+#include <memory>
+#include <vector>
+
+using namespace sleepster;
+
+namespace {
+
+/// Emits a constant value on both channels, optionally for a fixed length.
+class ConstantSource final : public AudioSource {
+public:
+    explicit ConstantSource(float value, std::size_t length = SIZE_MAX)
+        : value_(value), remaining_(length) {}
+
+    std::size_t render(float* left, float* right, std::size_t frames) noexcept override {
+        const std::size_t count = frames < remaining_ ? frames : remaining_;
+        for (std::size_t i = 0; i < count; ++i) left[i] = right[i] = value_;
+        remaining_ -= count;
+        return count;
+    }
+
+private:
+    float value_;
+    std::size_t remaining_;
+};
+
+MixerConfig smallConfig(uint32_t maxVoices = 8) {
+    MixerConfig config;
+    config.sampleRate = 48000.0;
+    config.maxVoices = maxVoices;
+    config.maxBlockFrames = 256;
+    return config;
+}
+
+float renderLastSample(Mixer& mixer, std::size_t frames = 256) {
+    std::vector<float> left(frames), right(frames);
+    mixer.render(left.data(), right.data(), frames);
+    return left.back();
+}
+
+} // namespace
+
+SLP_TEST(rendersSilenceWithoutVoices) {
+    Mixer mixer(smallConfig());
+    std::vector<float> left(300, 1.0f), right(300, 1.0f);
+    mixer.render(left.data(), right.data(), left.size());
+    for (float s : left) SLP_CHECK_EQ(s, 0.0f);
+    for (float s : right) SLP_CHECK_EQ(s, 0.0f);
+}
+
+SLP_TEST(appliesVoiceAndMasterVolume) {
+    Mixer mixer(smallConfig());
+    const VoiceId a = mixer.play(std::make_unique<ConstantSource>(0.5f), 1.0f);
+    const VoiceId b = mixer.play(std::make_unique<ConstantSource>(0.25f), 0.5f);
+    SLP_CHECK(a != kInvalidVoice);
+    SLP_CHECK(b != kInvalidVoice);
+    SLP_CHECK_NEAR(renderLastSample(mixer), 0.625f, 1e-6f);
+
+    mixer.setMasterVolume(0.5f);
+    mixer.setVolume(a, 0.0f);
+    // The change ramps over the declick time and then holds.
+    renderLastSample(mixer);
+    SLP_CHECK_NEAR(renderLastSample(mixer), 0.0625f, 1e-6f);
+}
+
+SLP_TEST(supportsMoreThanFiveVoices) {
+    Mixer mixer(smallConfig(32));
+    for (int i = 0; i < 32; ++i) {
+        SLP_CHECK(mixer.play(std::make_unique<ConstantSource>(0.01f), 1.0f) != kInvalidVoice);
+    }
+    SLP_CHECK(mixer.play(std::make_unique<ConstantSource>(0.01f), 1.0f) == kInvalidVoice);
+    SLP_CHECK_EQ(mixer.activeVoiceCount(), 32u);
+    SLP_CHECK_NEAR(renderLastSample(mixer), 0.32f, 1e-5f);
+}
+
+SLP_TEST(stopReclaimsSlotAndInvalidatesHandle) {
+    Mixer mixer(smallConfig(1));
+    const VoiceId first = mixer.play(std::make_unique<ConstantSource>(1.0f), 1.0f);
+    renderLastSample(mixer);
+    SLP_CHECK(mixer.stop(first));
+    // The declick ramp to silence fits in one block; then the voice is released.
+    renderLastSample(mixer);
+    SLP_CHECK_NEAR(renderLastSample(mixer), 0.0f, 1e-6f);
+
+    MixerEvent events[4];
+    SLP_CHECK_EQ(mixer.collectEvents(events, 4), 0u);
+    SLP_CHECK(!mixer.isActive(first));
+    SLP_CHECK(!mixer.stop(first));
+
+    const VoiceId second = mixer.play(std::make_unique<ConstantSource>(1.0f), 1.0f);
+    SLP_CHECK(second != kInvalidVoice);
+    SLP_CHECK(second != first);
+    SLP_CHECK(!mixer.setVolume(first, 0.5f));
+}
+
+SLP_TEST(finishedSourcePostsEvent) {
+    Mixer mixer(smallConfig());
+    const VoiceId voice = mixer.play(std::make_unique<ConstantSource>(1.0f, 100), 1.0f);
+    renderLastSample(mixer);
+    SLP_CHECK(mixer.waitForEvents(0));
+
+    MixerEvent events[4];
+    SLP_CHECK_EQ(mixer.collectEvents(events, 4), 1u);
+    SLP_CHECK(events[0].type == MixerEventType::VoiceFinished);
+    SLP_CHECK_EQ(events[0].voice, voice);
+    SLP_CHECK_EQ(mixer.activeVoiceCount(), 0u);
+}
+
+SLP_TEST(stopAllReleasesEveryVoice) {
+    Mixer mixer(smallConfig());
+    for (int i = 0; i < 5; ++i) mixer.play(std::make_unique<ConstantSource>(0.1f), 1.0f);
+    renderLastSample(mixer);
+    mixer.stopAll();
+    renderLastSample(mixer);
+    mixer.collectEvents(nullptr, 0);
+    SLP_CHECK_EQ(mixer.activeVoiceCount(), 0u);
+}
+
+SLP_TEST(pcmSourceLoopsAndResamples) {
+    std::vector<float> ramp = {0.0f, 1.0f, 2.0f, 3.0f};
+    const float* channels[] = {ramp.data()};
+    auto buffer = PcmBuffer::copyPlanar(channels, 1, ramp.size(), 24000.0);
+
+    PcmSource source(buffer, true);
+    source.prepare(48000.0, 16);
+    float left[10], right[10];
+    SLP_CHECK_EQ(source.render(left, right, 10), 10u);
+    const float expected[10] = {0.0f, 0.5f, 1.0f, 1.5f, 2.0f, 2.5f, 3.0f, 1.5f, 0.0f, 0.5f};
+    for (int i = 0; i < 10; ++i) {
+        SLP_CHECK_NEAR(left[i], expected[i], 1e-6f);
+        SLP_CHECK_EQ(left[i], right[i]);
+    }
+
+    PcmSource once(buffer, false);
+    once.prepare(24000.0, 16);
+    SLP_CHECK_EQ(once.render(left, right, 10), 4u);
+}
+
+SLP_TEST(nullSinkRendersInRealTime) {
+    Mixer mixer(smallConfig());
+    NullAudioSink sink(mixer, 128);
+    mixer.play(std::make_unique<ConstantSource>(0.5f, 4800), 1.0f);
+
+    sink.start();
+    const bool signalled = mixer.waitForEvents(2000);
+    sink.stop();
+
+    SLP_CHECK(signalled);
+    SLP_CHECK(sink.framesRendered() >= 4800u);
+    SLP_CHECK_NEAR(sink.peak(), 0.5f, 1e-6f);
+    MixerEvent events[2];
+    SLP_CHECK_EQ(mixer.collectEvents(events, 2), 1u);
+}
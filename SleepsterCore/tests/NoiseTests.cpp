@@ -0,0 +1,197 @@
+//
+//  NoiseTests.cpp
+//  SleepsterCore
+//
+
+#include "TestHarness.hpp"
+
+#include "sleepster/Mixer.hpp"
+#include "sleepster/NoiseSource.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace sleepster;
+
+namespace {
+
+constexpr double kRate = 48000.0;
+constexpr std::size_t kBlock = 256;
+
+struct Stereo {
+    std::vector<float> left;
+    std::vector<float> right;
+};
+
+Stereo renderNoise(NoiseSource& source, std::size_t frames) {
+    Stereo out{std::vector<float>(frames), std::vector<float>(frames)};
+    for (std::size_t offset = 0; offset < frames; offset += kBlock) {
+        const std::size_t count = std::min(kBlock, frames - offset);
+        SLP_CHECK_EQ(source.render(out.left.data() + offset, out.right.data() + offset, count), count);
+    }
+    return out;
+}
+
+double rms(const std::vector<float>& samples, std::size_t begin, std::size_t end) {
+    double sum = 0.0;
+    for (std::size_t i = begin; i < end; ++i) sum += double(samples[i]) * samples[i];
+    return std::sqrt(sum / double(end - begin));
+}
+
+/// Power spectrum averaged over Hann-windowed segments, in dB per bin.
+std::vector<double> spectrumDb(const std::vector<float>& samples, std::size_t size) {
+    std::vector<double> power(size / 2, 0.0);
+    std::vector<double> window(size), cosine(size), sine(size);
+    for (std::size_t n = 0; n < size; ++n) {
+        window[n] = 0.5 - 0.5 * std::cos(2.0 * M_PI * n / size);
+        cosine[n] = std::cos(2.0 * M_PI * n / size);
+        sine[n] = std::sin(2.0 * M_PI * n / size);
+    }
+    const std::size_t segments = samples.size() / size;
+    for (std::size_t s = 0; s < segments; ++s) {
+        const float* x = samples.data() + s * size;
+        for (std::size_t k = 1; k < size / 2; ++k) {
+            double re = 0.0, im = 0.0;
+            for (std::size_t n = 0; n < size; ++n) {
+                const std::size_t phase = k * n % size;
+                re += window[n] * x[n] * cosine[phase];
+                im -= window[n] * x[n] * sine[phase];
+            }
+            power[k] += re * re + im * im;
+        }
+    }
+    std::vector<double> db(size / 2);
+    for (std::size_t k = 1; k < size / 2; ++k) db[k] = 10.0 * std::log10(power[k] / double(segments));
+    return db;
+}
+
+/// Least-squares slope of the spectrum in dB per octave, from octave bands
+/// centred on 375 Hz ... 6 kHz.
+double slopeDbPerOctave(const std::vector<float>& samples) {
+    constexpr std::size_t kSize = 512;
+    const std::vector<double> db = spectrumDb(samples, kSize);
+    std::vector<double> xs, ys;
+    for (double centre = 375.0; centre <= 6000.0; centre *= 2.0) {
+        // Average power over the bins within a third of an octave.
+        const auto lo = static_cast<std::size_t>(centre * std::pow(2.0, -1.0 / 6.0) * kSize / kRate);
+        const auto hi = static_cast<std::size_t>(centre * std::pow(2.0, 1.0 / 6.0) * kSize / kRate) + 1;
+        double sum = 0.0;
+        for (std::size_t k = lo; k <= hi; ++k) sum += std::pow(10.0, db[k] / 10.0);
+        xs.push_back(std::log2(centre));
+        ys.push_back(10.0 * std::log10(sum / double(hi - lo + 1)));
+    }
+    double mx = 0.0, my = 0.0;
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        mx += xs[i];
+        my += ys[i];
+    }
+    mx /= double(xs.size());
+    my /= double(ys.size());
+    double num = 0.0, den = 0.0;
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        num += (xs[i] - mx) * (ys[i] - my);
+        den += (xs[i] - mx) * (xs[i] - mx);
+    }
+    return num / den;
+}
+
+/// Mean square of the first difference, which white noise has plenty of and
+/// brown noise almost none.
+double roughness(const std::vector<float>& samples, std::size_t begin, std::size_t end) {
+    double sum = 0.0;
+    for (std::size_t i = begin + 1; i < end; ++i) {
+        const double d = double(samples[i]) - samples[i - 1];
+        sum += d * d;
+    }
+    return sum / double(end - begin - 1);
+}
+
+} // namespace
+
+SLP_TEST(everyColourPlaysAtTheSameLevel) {
+    for (NoiseColor color : {NoiseColor::White, NoiseColor::Pink, NoiseColor::Brown}) {
+        NoiseSource source(color, 42);
+        source.prepare(kRate, kBlock);
+        // Ten seconds, skipping the first while brown settles from rest.
+        const Stereo out = renderNoise(source, static_cast<std::size_t>(10.0 * kRate));
+        const std::size_t begin = static_cast<std::size_t>(kRate);
+        SLP_CHECK_NEAR(rms(out.left, begin, out.left.size()), NoiseSource::kLevel, 0.1f * NoiseSource::kLevel);
+        SLP_CHECK_NEAR(rms(out.right, begin, out.right.size()), NoiseSource::kLevel, 0.1f * NoiseSource::kLevel);
+    }
+}
+
+SLP_TEST(spectrumFallsAtTheColoursTilt) {
+    const struct {
+        NoiseColor color;
+        double slope;
+    } cases[] = {
+        {NoiseColor::White, 0.0},
+        {NoiseColor::Pink, -3.0},
+        {NoiseColor::Brown, -6.0},
+    };
+    for (const auto& entry : cases) {
+        NoiseSource source(entry.color, 7);
+        source.prepare(kRate, kBlock);
+        const Stereo out = renderNoise(source, 256 * 512);
+        SLP_CHECK_NEAR(slopeDbPerOctave(out.left), entry.slope, 0.6);
+    }
+}
+
+SLP_TEST(equalSeedsRepeatAndChannelsAreIndependent) {
+    NoiseSource a(NoiseColor::Pink, 1234);
+    NoiseSource b(NoiseColor::Pink, 1234);
+    NoiseSource c(NoiseColor::Pink, 1235);
+    for (NoiseSource* source : {&a, &b, &c}) source->prepare(kRate, kBlock);
+    const Stereo outA = renderNoise(a, 48000);
+    const Stereo outB = renderNoise(b, 48000);
+    const Stereo outC = renderNoise(c, 48000);
+    SLP_CHECK(outA.left == outB.left);
+    SLP_CHECK(outA.right == outB.right);
+    SLP_CHECK(outA.left != outC.left);
+
+    NoiseSource white(NoiseColor::White, 99);
+    white.prepare(kRate, kBlock);
+    const Stereo out = renderNoise(white, 48000);
+    double lr = 0.0, ll = 0.0, rr = 0.0;
+    for (std::size_t i = 0; i < out.left.size(); ++i) {
+        lr += double(out.left[i]) * out.right[i];
+        ll += double(out.left[i]) * out.left[i];
+        rr += double(out.right[i]) * out.right[i];
+    }
+    SLP_CHECK(std::fabs(lr / std::sqrt(ll * rr)) < 0.02);
+}
+
+SLP_TEST(tiltChangeThroughTheMixerGlides) {
+    MixerConfig config;
+    config.sampleRate = kRate;
+    config.maxBlockFrames = kBlock;
+    Mixer mixer(config);
+    const VoiceId voice = mixer.play(std::make_unique<NoiseSource>(NoiseColor::White, 5), 1.0f);
+    SLP_CHECK(voice != kInvalidVoice);
+
+    const std::size_t blocks = 200;
+    std::vector<float> left(blocks * kBlock), right(blocks * kBlock);
+    for (std::size_t b = 0; b < blocks; ++b) {
+        if (b == 40) SLP_CHECK(mixer.setSourceParameter(voice, NoiseSource::kTiltParameter, -6.0f));
+        mixer.render(left.data() + b * kBlock, right.data() + b * kBlock, kBlock);
+    }
+
+    const auto at = [](std::size_t block) { return block * kBlock; };
+    const double before = roughness(left, at(20), at(40));
+    const double firstBlock = roughness(left, at(40), at(41));
+    const double settled = roughness(left, at(160), at(200));
+    // White noise's difference power is twice its variance; brown's is tiny.
+    SLP_CHECK_NEAR(before, 2.0 * NoiseSource::kLevel * NoiseSource::kLevel, 0.01);
+    SLP_CHECK(settled < 0.01 * before);
+    // The first block after the change has only started to move, where a
+    // switch would already sound brown.
+    SLP_CHECK(firstBlock > 0.5 * before);
+    // And the level holds through the glide.
+    for (std::size_t b = 40; b < 160; b += 10) {
+        SLP_CHECK(rms(left, at(b), at(b + 10)) > 0.5 * NoiseSource::kLevel);
+    }
+
+    SLP_CHECK(!mixer.setSourceParameter(kInvalidVoice, NoiseSource::kTiltParameter, 0.0f));
+}
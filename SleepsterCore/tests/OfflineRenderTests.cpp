@@ -0,0 +1,251 @@
+//
+//  OfflineRenderTests.cpp
+//  SleepsterCore
+//
+
+#include "TestHarness.hpp"
+
+#include "sleepster/NoiseSource.hpp"
+#include "sleepster/OfflineRender.hpp"
+#include "sleepster/PcmSource.hpp"
+#include "sleepster/WavFile.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace sleepster;
+
+namespace {
+
+constexpr double kRate = 48000.0;
+
+/// Plays a constant level on both channels, so the output is the envelope.
+class ConstantSource final : public AudioSource {
+public:
+    explicit ConstantSource(bool seekable) : seekable_(seekable) {}
+    bool seek(uint64_t frame) override { return seekable_; }
+    std::size_t render(float* left, float* right, std::size_t frames) noexcept override {
+        std::fill(left, left + frames, 1.0f);
+        std::fill(right, right + frames, 1.0f);
+        return frames;
+    }
+
+private:
+    const bool seekable_;
+};
+
+std::shared_ptr<const PcmBuffer> tone(double frequency, double rate, std::size_t frames) {
+    auto buffer = std::make_shared<PcmBuffer>();
+    buffer->sampleRate = rate;
+    buffer->frameCount = frames;
+    buffer->channels.assign(2, std::vector<float>(frames));
+    for (std::size_t i = 0; i < frames; ++i) {
+        buffer->channels[0][i] = 0.4f * static_cast<float>(std::sin(2.0 * M_PI * frequency * double(i) / rate));
+        buffer->channels[1][i] = 0.4f * static_cast<float>(std::cos(2.0 * M_PI * frequency * double(i) / rate));
+    }
+    return buffer;
+}
+
+std::vector<float> play(AudioSource& source, std::size_t frames, std::size_t block) {
+    std::vector<float> left(frames), right(frames);
+    for (std::size_t offset = 0; offset < frames; offset += block) {
+        source.render(left.data() + offset, right.data() + offset, std::min(block, frames - offset));
+    }
+    return left;
+}
+
+/// A tone, pink noise, and every bus stage, with fades at both ends.
+OfflineMix richMix(double seconds) {
+    OfflineMix mix;
+    mix.sampleRate = kRate;
+    mix.durationSeconds = seconds;
+    // 44.1 kHz, so the tone is resampled, and a loop that does not divide
+    // the chunk length.
+    const auto buffer = tone(330.0, 44100.0, 16411);
+    mix.tracks.push_back({[buffer] { return std::make_unique<PcmSource>(buffer, true); }, 0.7f, 1.5, 2.0});
+    mix.tracks.push_back({[] { return std::make_unique<NoiseSource>(NoiseColor::Pink, 42); }, 0.5f, 0.5, 0.0});
+    mix.bus.masterVolume = 0.9f;
+    mix.bus.equalizerEnabled = true;
+    mix.bus.equalizerGainsDb = {6, 4, 0, -2, 0, 3, 0, -4, -6, -8};
+    mix.bus.delayEnabled = true;
+    mix.bus.delaySeconds = 0.25;
+    mix.bus.delayFeedback = 0.4f;
+    mix.bus.reverbEnabled = true;
+    mix.bus.reverbPreset = ReverbPreset::Hall;
+    return mix;
+}
+
+float peakOf(const PcmBuffer& buffer) {
+    float peak = 0.0f;
+    for (const std::vector<float>& channel : buffer.channels) {
+        for (const float sample : channel) peak = std::max(peak, std::fabs(sample));
+    }
+    return peak;
+}
+
+float largestDifference(const PcmBuffer& a, const PcmBuffer& b) {
+    float largest = 0.0f;
+    for (std::size_t c = 0; c < 2; ++c) {
+        for (std::size_t i = 0; i < a.frameCount; ++i) {
+            largest = std::max(largest, std::fabs(a.channels[c][i] - b.channels[c][i]));
+        }
+    }
+    return largest;
+}
+
+} // namespace
+
+SLP_TEST(sourcesSeekToWhereRenderingLeavesThem) {
+    // Direct and resampled PCM, looping past the end of the buffer.
+    for (const double rate : {kRate, 44100.0}) {
+        const auto buffer = tone(440.0, rate, 3001);
+        PcmSource continuous(buffer, true);
+        PcmSource seeked(buffer, true);
+        continuous.prepare(kRate, 512);
+        seeked.prepare(kRate, 512);
+        const std::vector<float> reference = play(continuous, 12000, 300);
+        SLP_CHECK(seeked.seek(10000));
+        const std::vector<float> tail = play(seeked, 2000, 300);
+        for (std::size_t i = 0; i < tail.size(); ++i) SLP_CHECK_NEAR(tail[i], reference[10000 + i], 1e-5f);
+    }
+
+    // The generators jump exactly; the pink filters settle from rest.
+    NoiseSource continuous(NoiseColor::Pink, 7);
+    NoiseSource seeked(NoiseColor::Pink, 7);
+    continuous.prepare(kRate, 512);
+    seeked.prepare(kRate, 512);
+    const std::vector<float> reference = play(continuous, 4096 + 48000, 256);
+    SLP_CHECK(seeked.seek(4096));
+    const std::vector<float> tail = play(seeked, 48000, 256);
+    SLP_CHECK(std::fabs(tail[0] - reference[4096]) > 1e-4f);
+    float error = 0.0f;
+    for (std::size_t i = 24000; i < tail.size(); ++i) error = std::max(error, std::fabs(tail[i] - reference[4096 + i]));
+    SLP_CHECK(error < 1e-5f);
+
+    NoiseSource white(NoiseColor::White, 7);
+    NoiseSource whiteSeeked(NoiseColor::White, 7);
+    const std::vector<float> whiteReference = play(white, 1024 * 9, 1024);
+    SLP_CHECK(whiteSeeked.seek(1024 * 8));
+    const std::vector<float> whiteTail = play(whiteSeeked, 1024, 1024);
+    SLP_CHECK(std::equal(whiteTail.begin(), whiteTail.end(), whiteReference.begin() + 1024 * 8));
+}
+
+SLP_TEST(chunkedRenderMatchesASinglePass) {
+    OfflineMix mix = richMix(12.0);
+    mix.bus.equalizerEnabled = false;
+    PcmBuffer single, chunked, serial;
+    SLP_CHECK(renderOfflineToBuffer(mix, {1, 60.0}, single));
+
+    OfflineRenderStats stats;
+    SLP_CHECK(renderOfflineToBuffer(mix, {3, 2.0}, chunked, &stats));
+    SLP_CHECK_EQ(stats.frames, uint64_t(12 * 48000));
+    SLP_CHECK_EQ(stats.chunks, std::size_t(6));
+    SLP_CHECK_EQ(stats.threads, 3u);
+    SLP_CHECK(stats.realTimeFactor > 0.0);
+    SLP_CHECK_EQ(chunked.frameCount, single.frameCount);
+    SLP_CHECK(peakOf(single) > 0.1f);
+    // Well below 16-bit resolution: the seams cannot be heard, or even
+    // found in an exported file.
+    SLP_CHECK(largestDifference(chunked, single) < 1e-5f);
+
+    // The thread count never changes a sample.
+    SLP_CHECK(renderOfflineToBuffer(mix, {1, 2.0}, serial));
+    SLP_CHECK(serial.channels == chunked.channels);
+
+    // The EQ's low bands sit close to the unit circle, where float rounding
+    // leaves a noise floor some 60 dB down that differs between any two
+    // runs started at different points, chunked or not.
+    mix.bus.equalizerEnabled = true;
+    SLP_CHECK(renderOfflineToBuffer(mix, {1, 60.0}, single));
+    SLP_CHECK(renderOfflineToBuffer(mix, {3, 2.0}, chunked));
+    SLP_CHECK(largestDifference(chunked, single) < 1e-3f * peakOf(single));
+}
+
+SLP_TEST(fadesFollowTheirCurvesAcrossChunks) {
+    OfflineMix mix;
+    mix.sampleRate = kRate;
+    mix.durationSeconds = 4.0;
+    mix.tracks.push_back({[] { return std::make_unique<ConstantSource>(true); }, 0.5f, 1.0, 1.0});
+    PcmBuffer out;
+    // Chunks of 12288 frames, so both fades span several of them.
+    SLP_CHECK(renderOfflineToBuffer(mix, {2, 0.25}, out));
+    const std::vector<float>& left = out.channels[0];
+    SLP_CHECK_EQ(left.size(), std::size_t(4 * 48000));
+
+    for (std::size_t i = 0; i < 48000; i += 997) {
+        const float expected = 0.5f * rampShape(RampCurve::EqualPower, double(i + 1) / 48000.0);
+        SLP_CHECK_NEAR(left[i], expected, 1e-4f);
+    }
+    SLP_CHECK_NEAR(left[48000], 0.5f, 1e-6f);
+    SLP_CHECK_NEAR(left[143999], 0.5f, 1e-6f);
+    for (std::size_t i = 144000; i < left.size(); i += 997) {
+        // A fade-out is the time reverse of the rising curve.
+        const float expected = 0.5f * rampShape(RampCurve::Exponential, 1.0 - double(i - 144000 + 1) / 48000.0);
+        SLP_CHECK_NEAR(left[i], expected, 1e-4f);
+    }
+    SLP_CHECK_EQ(left.back(), 0.0f);
+}
+
+SLP_TEST(filesHoldTheSameRenderAsTheBuffer) {
+    const OfflineMix mix = richMix(3.0);
+    PcmBuffer buffer;
+    SLP_CHECK(renderOfflineToBuffer(mix, {2, 1.0}, buffer));
+
+    const std::string wav = "/tmp/sleepster_offline.wav";
+    SLP_CHECK(renderOfflineToFile(mix, {2, 1.0}, wav, AudioFileType::Wav, WavFormat::Encoding::Float32));
+    auto decoder = WavDecoder::open(wav);
+    SLP_CHECK(decoder != nullptr);
+    if (decoder) {
+        SLP_CHECK_EQ(decoder->frameCount(), uint64_t(buffer.frameCount));
+        std::vector<float> left(buffer.frameCount), right(buffer.frameCount);
+        SLP_CHECK_EQ(decoder->decode(left.data(), right.data(), left.size()), left.size());
+        SLP_CHECK(left == buffer.channels[0]);
+        SLP_CHECK(right == buffer.channels[1]);
+    }
+    std::remove(wav.c_str());
+
+    const std::string caf = "/tmp/sleepster_offline.caf";
+    SLP_CHECK(renderOfflineToFile(mix, {2, 1.0}, caf, AudioFileType::Caf, WavFormat::Encoding::Pcm16));
+    std::vector<uint8_t> bytes;
+    if (std::FILE* file = std::fopen(caf.c_str(), "rb")) {
+        uint8_t chunk[4096];
+        std::size_t n;
+        while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) bytes.insert(bytes.end(), chunk, chunk + n);
+        std::fclose(file);
+    }
+    const std::size_t dataBytes = buffer.frameCount * 4;
+    SLP_CHECK_EQ(bytes.size(), 68 + dataBytes);
+    if (bytes.size() == 68 + dataBytes) {
+        SLP_CHECK(std::equal(bytes.begin(), bytes.begin() + 4, "caff"));
+        SLP_CHECK(std::equal(bytes.begin() + 52, bytes.begin() + 56, "data"));
+        uint64_t size = 0;
+        for (int i = 0; i < 8; ++i) size = (size << 8) | bytes[56 + i];
+        SLP_CHECK_EQ(size, uint64_t(dataBytes + 4));
+        // The first frame after the pre-roll-free start: little-endian 16-bit.
+        const int16_t first = static_cast<int16_t>(bytes[68 + 4000] | (bytes[68 + 4001] << 8));
+        SLP_CHECK_NEAR(first / 32767.0f, buffer.channels[0][1000], 1.0f / 32767.0f);
+    }
+    std::remove(caf.c_str());
+}
+
+SLP_TEST(sourcesThatCannotSeekRenderOnlyInOnePiece) {
+    OfflineMix mix;
+    mix.sampleRate = kRate;
+    mix.durationSeconds = 2.0;
+    mix.tracks.push_back({[] { return std::make_unique<ConstantSource>(false); }, 1.0f, 0.0, 0.0});
+
+    const std::string path = "/tmp/sleepster_offline_fail.wav";
+    SLP_CHECK(!renderOfflineToFile(mix, {2, 0.5}, path, AudioFileType::Wav, WavFormat::Encoding::Pcm16));
+    SLP_CHECK(std::fopen(path.c_str(), "rb") == nullptr);
+
+    PcmBuffer out;
+    SLP_CHECK(renderOfflineToBuffer(mix, {2, 10.0}, out));
+    SLP_CHECK_EQ(out.channels[1][95999], 1.0f);
+
+    mix.tracks.push_back({nullptr, 1.0f, 0.0, 0.0});
+    SLP_CHECK(!renderOfflineToBuffer(mix, {2, 10.0}, out));
+}
@@ -0,0 +1,120 @@
+//
+//  PaletteTests.cpp
+//  SleepsterCore
+//
+
+#include "TestHarness.hpp"
+
+#include "SLPPalette.h"
+#include "sleepster/Palette.hpp"
+
+#include <cmath>
+
+using namespace sleepster;
+
+namespace {
+
+float alphaOf(PackedColor color) {
+    return channelOf(color, 3);
+}
+
+} // namespace
+
+SLP_TEST(packedColorsRoundTripTheirChannels) {
+    static_assert(packColor(1.0f, 0.0f, 0.0f, 1.0f) == 0xFF0000FFu);
+    static_assert(packColor(2.0f, -1.0f, 0.5f, 0.0f) == 0xFF008000u);
+    const PackedColor color = packColor(0.2f, 0.4f, 0.6f, 0.8f);
+    for (int i = 0; i < 4; ++i) {
+        SLP_CHECK_NEAR(channelOf(color, i), 0.2f * static_cast<float>(i + 1), 0.5 / 255.0);
+    }
+}
+
+SLP_TEST(swatchesFollowTheThemeAndDimmedState) {
+    const Palette& warm = themePalette(PaletteTheme::Warm, false, 2);
+    const Palette& warmDimmed = themePalette(PaletteTheme::Warm, true, 2);
+    SLP_CHECK_EQ(warm.swatch(Swatch::SheepBody), packColor(1.0f, 0.95f, 0.9f, 0.95f));
+    SLP_CHECK_EQ(warmDimmed.swatch(Swatch::SheepBody), packColor(1.0f, 0.95f, 0.9f, 0.7f));
+    const Palette& monochrome = themePalette(PaletteTheme::Monochrome, false, 2);
+    SLP_CHECK_NEAR(alphaOf(monochrome.swatch(Swatch::SheepBody)), 0.76, 0.003);
+
+    // The accent is the theme's colour; only its opacity depends on dimming.
+    const PackedColor accents[] = {
+        themePalette(PaletteTheme::Default, false, 0).swatch(Swatch::Accent),
+        themePalette(PaletteTheme::Warm, false, 0).swatch(Swatch::Accent),
+        themePalette(PaletteTheme::Cool, false, 0).swatch(Swatch::Accent),
+        themePalette(PaletteTheme::Monochrome, false, 0).swatch(Swatch::Accent),
+    };
+    for (int i = 0; i < 4; ++i) {
+        for (int j = i + 1; j < 4; ++j) SLP_CHECK(accents[i] != accents[j]);
+    }
+    SLP_CHECK_EQ(warm.swatch(Swatch::AccentStroke) >> 8, warm.swatch(Swatch::Accent) >> 8);
+    SLP_CHECK(alphaOf(warmDimmed.swatch(Swatch::AccentStroke)) < alphaOf(warm.swatch(Swatch::AccentStroke)));
+}
+
+SLP_TEST(intensityTiersScaleOnlyTheGradientsThatAskForIt) {
+    SLP_CHECK_EQ(paletteTier(0.0f), 0u);
+    SLP_CHECK_EQ(paletteTier(1.0f / 3.0f), 1u);
+    SLP_CHECK_EQ(paletteTier(2.0f / 3.0f), 2u);
+    SLP_CHECK_EQ(paletteTier(1.0f), 3u);
+    SLP_CHECK_EQ(paletteTier(7.0f), 3u);
+    SLP_CHECK_EQ(paletteTier(-1.0f), 0u);
+    SLP_CHECK_EQ(paletteTier(std::nanf("")), 0u);
+
+    const Palette& low = themePalette(PaletteTheme::Cool, false, 1);
+    const Palette& high = themePalette(PaletteTheme::Cool, false, 3);
+    const GradientStops& faint = low.stops(PaletteGradient::Caustics);
+    const GradientStops& full = high.stops(PaletteGradient::Caustics);
+    SLP_CHECK_NEAR(alphaOf(full.colors[0]), 0.08, 0.003);
+    SLP_CHECK_NEAR(alphaOf(faint.colors[0]), 0.08 / 3.0, 0.003);
+    SLP_CHECK_EQ(low.stops(PaletteGradient::OceanDepth).colors[1],
+                 high.stops(PaletteGradient::OceanDepth).colors[1]);
+    const Palette& off = themePalette(PaletteTheme::Cool, false, 0);
+    SLP_CHECK_EQ(alphaOf(off.stops(PaletteGradient::MandalaGlow).colors[0]), 0.0f);
+}
+
+SLP_TEST(rampsRunThroughEveryStop) {
+    for (bool dimmed : {false, true}) {
+        const Palette& colors = themePalette(PaletteTheme::Default, dimmed, 2);
+        for (std::size_t g = 0; g < kPaletteGradientCount; ++g) {
+            const auto gradient = static_cast<PaletteGradient>(g);
+            const GradientStops& stops = colors.stops(gradient);
+            SLP_CHECK(stops.count >= 2 && stops.count <= palette::kMaxStops);
+            SLP_CHECK_EQ(colors.sample(gradient, 0.0f), stops.colors[0]);
+            SLP_CHECK_EQ(colors.sample(gradient, 1.0f), stops.colors[stops.count - 1]);
+            SLP_CHECK_EQ(colors.sample(gradient, 2.0f), stops.colors[stops.count - 1]);
+            if (stops.count == 3) {
+                // The middle stop falls between entries 127 and 128.
+                for (int c = 0; c < 4; ++c) {
+                    const float middle =
+                        0.5f * (channelOf(colors.ramps[g][127], c) + channelOf(colors.ramps[g][128], c));
+                    SLP_CHECK_NEAR(middle, channelOf(stops.colors[1], c), 2.0 / 255.0);
+                }
+            }
+        }
+    }
+    // Clear stops fade in their neighbour's colour instead of through black.
+    const Palette& colors = themePalette(PaletteTheme::Default, false, 2);
+    const PackedColor halfway = colors.sample(PaletteGradient::HorizonGlow, 0.25f);
+    SLP_CHECK_EQ(halfway >> 8, colors.stops(PaletteGradient::HorizonGlow).colors[1] >> 8);
+    SLP_CHECK_NEAR(alphaOf(halfway), 0.075, 0.005);
+}
+
+SLP_TEST(cachedPalettesMatchFreshBuildsAndTheCInterface) {
+    Palette fresh;
+    buildPalette(PaletteTheme::Monochrome, true, 1, fresh);
+    const Palette& cached = themePalette(PaletteTheme::Monochrome, true, 1);
+    SLP_CHECK(&cached == &themePalette(PaletteTheme::Monochrome, true, 1));
+    for (std::size_t g = 0; g < kPaletteGradientCount; ++g) {
+        for (std::size_t i = 0; i < palette::kRampSize; ++i) SLP_CHECK_EQ(fresh.ramps[g][i], cached.ramps[g][i]);
+    }
+
+    SLP_CHECK_EQ(SLPPaletteTier(0.5f), 2u);
+    SLP_CHECK_EQ(SLPPaletteGetSwatch(SLPPaletteThemeMonochrome, true, 1, SLPSwatchAccentStroke),
+                 cached.swatch(Swatch::AccentStroke));
+    const SLPGradientStops stops =
+        SLPPaletteGetStops(SLPPaletteThemeMonochrome, true, 1, SLPPaletteGradientOceanDepth);
+    SLP_CHECK_EQ(stops.count, 4u);
+    SLP_CHECK_EQ(stops.colors[0], packColor(0.0f, 0.0f, 0.0f, 0.9f));
+    const uint32_t* ramp = SLPPaletteGetRamp(SLPPaletteThemeMonochrome, true, 1, SLPPaletteGradientCloud);
+    SLP_CHECK(ramp == cached.ramps[static_cast<std::size_t>(PaletteGradient::Cloud)]);
+}
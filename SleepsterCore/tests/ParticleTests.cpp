@@ -0,0 +1,345 @@
+//
+//  ParticleTests.cpp
+//  SleepsterCore
+//
+
+#include "TestHarness.hpp"
+
+#include "sleepster/FrameArena.hpp"
+#include "sleepster/ParticleSystem.hpp"
+#include "sleepster/Random.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+using namespace sleepster;
+
+// Counts every heap allocation in this test binary, so a test can assert
+// that a stretch of code makes none.
+static std::atomic<std::size_t> allocationCount{0};
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+ParticleConfig rainConfig(std::size_t count) {
+    ParticleConfig config;
+    config.motion = ParticleMotion::Fall;
+    config.count = count;
+    config.bounds = {0.0f, 0.0f, 400.0f, 800.0f};
+    config.x = {0.0f, 400.0f};
+    config.y = {0.0f, 800.0f};
+    config.velocityY = {250.0f, 500.0f};
+    config.radiusX = {5.0f, 20.0f};
+    config.orbitRate = {0.5f, 1.5f};
+    config.size = {10.0f, 25.0f};
+    config.alpha = {0.3f, 0.9f};
+    config.windX = 30.0f;
+    return config;
+}
+
+ParticleConfig orbitConfig(std::size_t count) {
+    ParticleConfig config;
+    config.motion = ParticleMotion::Orbit;
+    config.count = count;
+    config.bounds = {-200.0f, 0.0f, 600.0f, 800.0f};
+    config.x = {-200.0f, 600.0f};
+    config.y = {150.0f, 500.0f};
+    config.velocityX = {9.0f, 36.0f};
+    config.radiusX = {20.0f, 80.0f};
+    config.radiusY = {10.0f, 40.0f};
+    config.orbitRate = {0.3f, 1.4f};
+    config.size = {1.2f, 2.0f};
+    config.twinkleRate = {0.5f, 2.0f};
+    config.twinkleDepth = 0.6f;
+    return config;
+}
+
+bool sameColumn(const float* a, const float* b, std::size_t n) {
+    return std::memcmp(a, b, n * sizeof(float)) == 0;
+}
+
+} // namespace
+
+SLP_TEST(randomIsSeededAndUniform) {
+    Random a(42), b(42), c(43);
+    bool differs = false;
+    double sum = 0.0;
+    constexpr int kDraws = 100000;
+    for (int i = 0; i < kDraws; ++i) {
+        const uint32_t va = a.next();
+        SLP_CHECK_EQ(va, b.next());
+        differs |= va != c.next();
+        const float u = a.uniform();
+        b.uniform();
+        SLP_CHECK(u >= 0.0f && u < 1.0f);
+        sum += u;
+    }
+    SLP_CHECK(differs);
+    SLP_CHECK_NEAR(sum / kDraws, 0.5, 0.005);
+
+    // A fixed sequence: changing the generator changes every scene.
+    Random golden(0);
+    SLP_CHECK_EQ(golden.next(), 1092706980u);
+    SLP_CHECK_EQ(golden.next(), 27322534u);
+    SLP_CHECK_EQ(golden.next(), 2742124086u);
+}
+
+SLP_TEST(frameArenaBumpsAlignsAndResets) {
+    FrameArena arena(256);
+    auto* bytes = arena.allocate<uint8_t>(3);
+    auto* floats = arena.allocate<float>(4);
+    SLP_CHECK(bytes != nullptr && floats != nullptr);
+    SLP_CHECK_EQ(reinterpret_cast<std::uintptr_t>(floats) % alignof(float), 0u);
+    SLP_CHECK(reinterpret_cast<uint8_t*>(floats) >= bytes + 3);
+    SLP_CHECK(arena.allocate<double>(1000) == nullptr);
+
+    const std::size_t used = arena.used();
+    arena.reset();
+    SLP_CHECK_EQ(arena.used(), 0u);
+    SLP_CHECK_EQ(arena.highWater(), used);
+    // The same memory comes back after a reset.
+    SLP_CHECK(arena.allocate<uint8_t>(3) == bytes);
+    // 3 bytes, padding to 4, then exactly the rest.
+    SLP_CHECK(arena.allocate<float>(63) != nullptr);
+    SLP_CHECK(arena.allocate<float>(1) == nullptr);
+}
+
+SLP_TEST(equalSeedsGiveIdenticalScenes) {
+    ParticleScene a(7), b(7), c(8);
+    for (ParticleScene* scene : {&a, &b, &c}) {
+        scene->add(orbitConfig(101));
+        scene->add(rainConfig(37));
+    }
+    for (int frame = 0; frame < 300; ++frame) {
+        const double step = frame % 3 == 0 ? 1.0 / 30.0 : 1.0 / 60.0;
+        a.update(step);
+        b.update(step);
+        c.update(step);
+    }
+    for (std::size_t s = 0; s < 2; ++s) {
+        const ParticleSystem& pa = a.system(s);
+        const ParticleSystem& pb = b.system(s);
+        SLP_CHECK(sameColumn(pa.x(), pb.x(), pa.count()));
+        SLP_CHECK(sameColumn(pa.y(), pb.y(), pa.count()));
+        SLP_CHECK(sameColumn(pa.alpha(), pb.alpha(), pa.count()));
+        SLP_CHECK(!sameColumn(pa.x(), c.system(s).x(), pa.count()));
+    }
+}
+
+SLP_TEST(driftMovesWithWindAndWraps) {
+    ParticleConfig config;
+    config.motion = ParticleMotion::Drift;
+    config.count = 50;
+    config.bounds = {-10.0f, -10.0f, 410.0f, 810.0f};
+    config.x = {0.0f, 400.0f};
+    config.y = {0.0f, 800.0f};
+    config.velocityX = {-10.0f, 10.0f};
+    config.velocityY = {-4.0f, 4.0f};
+    config.windX = 5.0f;
+    ParticleSystem particles(config, 3);
+    FrameArena arena;
+
+    std::vector<float> x(particles.x(), particles.x() + 50);
+    std::vector<float> y(particles.y(), particles.y() + 50);
+    particles.update(0.5f, arena);
+    // Reference: the velocity is recovered from one step, then the wrapped
+    // positions are checked over a long run.
+    std::vector<float> vx(50), vy(50);
+    for (std::size_t i = 0; i < 50; ++i) {
+        vx[i] = (particles.x()[i] - x[i]) / 0.5f;
+        vy[i] = (particles.y()[i] - y[i]) / 0.5f;
+        SLP_CHECK(vx[i] >= -5.0f - 1e-3f && vx[i] <= 15.0f + 1e-3f);
+        SLP_CHECK(std::fabs(vy[i]) <= 4.0f + 1e-3f);
+    }
+    for (int frame = 0; frame < 6000; ++frame) particles.update(0.1f, arena);
+    for (std::size_t i = 0; i < 50; ++i) {
+        SLP_CHECK(particles.x()[i] >= -10.0f && particles.x()[i] < 410.0f);
+        SLP_CHECK(particles.y()[i] >= -10.0f && particles.y()[i] < 810.0f);
+        // 600.5 s of travel, wrapped into the 420 pt wide box.
+        const double apart = std::fmod(std::fabs(x[i] + 600.5 * vx[i] - particles.x()[i]), 420.0);
+        SLP_CHECK(std::min(apart, 420.0 - apart) < 0.5);
+    }
+}
+
+SLP_TEST(orbitStaysOnItsLoopAndRepeats) {
+    ParticleConfig config = orbitConfig(64);
+    config.velocityX = {0.0f, 0.0f};
+    config.x = {100.0f, 100.0f};
+    config.y = {300.0f, 300.0f};
+    config.radiusX = {50.0f, 50.0f};
+    config.radiusY = {0.0f, 0.0f};
+    config.orbitRate = {1.0f, 1.0f};
+    ParticleSystem particles(config, 11);
+    FrameArena arena;
+
+    const std::vector<float> start(particles.x(), particles.x() + 64);
+    std::vector<float> low(64, 1e9f), high(64, -1e9f);
+    // One full turn in 1000 steps.
+    const float step = static_cast<float>(2.0 * M_PI / 1000.0);
+    for (int frame = 0; frame < 1000; ++frame) {
+        particles.update(step, arena);
+        for (std::size_t i = 0; i < 64; ++i) {
+            low[i] = std::min(low[i], particles.x()[i]);
+            high[i] = std::max(high[i], particles.x()[i]);
+            SLP_CHECK_EQ(particles.y()[i], 300.0f);
+        }
+    }
+    for (std::size_t i = 0; i < 64; ++i) {
+        SLP_CHECK_NEAR(low[i], 50.0f, 1e-2f);
+        SLP_CHECK_NEAR(high[i], 150.0f, 1e-2f);
+        SLP_CHECK(low[i] >= 50.0f - 1e-3f && high[i] <= 150.0f + 1e-3f);
+        // Back where it began after a whole turn, give or take the rounding
+        // of a thousand phase steps.
+        SLP_CHECK_NEAR(particles.x()[i], start[i], 0.05f);
+    }
+
+    // Twinkling keeps alpha between (1 - depth) and 1 of the base.
+    for (std::size_t i = 0; i < 64; ++i) {
+        SLP_CHECK(particles.alpha()[i] >= 0.4f - 1e-5f && particles.alpha()[i] <= 1.0f + 1e-5f);
+    }
+}
+
+SLP_TEST(fallingParticlesReenterAndReportExits) {
+    ParticleConfig config = rainConfig(30);
+    config.velocityY = {100.0f, 100.0f};
+    config.radiusX = {0.0f, 0.0f};
+    ParticleScene scene(5);
+    scene.add(config);
+
+    // 8 s at 100 pt/s through an 800 pt box: every drop leaves exactly once
+    // (those that started low leave and are part way down again).
+    std::size_t exits = 0;
+    for (int frame = 0; frame < 480; ++frame) {
+        scene.update(1.0 / 60.0);
+        const ParticleSystem& rain = scene.system(0);
+        for (std::size_t e = 0; e < rain.exitCount(); ++e) {
+            SLP_CHECK(rain.exits()[e].index < 30u);
+            SLP_CHECK_EQ(rain.exits()[e].y, 800.0f);
+        }
+        exits += rain.exitCount();
+        for (std::size_t i = 0; i < rain.count(); ++i) {
+            SLP_CHECK(rain.y()[i] >= 0.0f && rain.y()[i] <= 800.0f);
+            SLP_CHECK(rain.x()[i] >= 0.0f && rain.x()[i] < 400.0f);
+        }
+    }
+    SLP_CHECK_EQ(exits, 30u);
+
+    // Rising particles leave through the top and come back at the bottom;
+    // starting below the box is entering it, not leaving.
+    ParticleConfig bubbles = rainConfig(12);
+    bubbles.velocityY = {-40.0f, -40.0f};
+    bubbles.y = {850.0f, 900.0f};
+    bubbles.windX = 0.0f;
+    ParticleScene rising(6);
+    rising.add(bubbles);
+    std::size_t risen = 0;
+    for (int frame = 0; frame < 10 * 60; ++frame) {
+        rising.update(1.0 / 60.0);
+        const ParticleSystem& system = rising.system(0);
+        for (std::size_t e = 0; e < system.exitCount(); ++e) SLP_CHECK_EQ(system.exits()[e].y, 0.0f);
+        risen += system.exitCount();
+    }
+    // 400 pt in 10 s covers at most the 900 pt to the top.
+    SLP_CHECK_EQ(risen, 0u);
+    for (int frame = 0; frame < 15 * 60; ++frame) {
+        rising.update(1.0 / 60.0);
+        risen += rising.system(0).exitCount();
+    }
+    SLP_CHECK_EQ(risen, 12u);
+    // Back in at the bottom, at most 3.75 s ago.
+    for (std::size_t i = 0; i < 12; ++i) SLP_CHECK(rising.system(0).y()[i] >= 650.0f - 1e-2f);
+}
+
+SLP_TEST(advanceInterpolatesBetweenFixedSteps) {
+    ParticleConfig config;
+    config.motion = ParticleMotion::Drift;
+    config.count = 4;
+    config.bounds = {0.0f, 0.0f, 10000.0f, 100.0f};
+    config.x = {10.0f, 20.0f};
+    config.y = {50.0f, 50.0f};
+    config.velocityX = {60.0f, 60.0f};
+    ParticleScene scene(3);
+    scene.add(config);
+
+    // At 144 Hz the 60 Hz steps land on some frames and not others; drawn
+    // positions still move the same distance every frame.
+    const double frame = 1.0 / 144.0;
+    int steps = 0;
+    // Drawn positions trail the simulation by a step, so motion shows from
+    // the first step on.
+    scene.advance(1.0 / 60.0);
+    float last = scene.system(0).drawX()[0];
+    for (int i = 0; i < 288; ++i) {
+        steps += scene.advance(frame);
+        const float drawn = scene.system(0).drawX()[0];
+        SLP_CHECK_NEAR(drawn - last, 60.0f * frame, 1e-3f);
+        last = drawn;
+    }
+    // Two seconds of display time is 120 steps, give or take the one in
+    // progress.
+    SLP_CHECK(steps >= 119 && steps <= 120);
+
+    // A variable update draws the simulated positions again.
+    scene.update(frame);
+    SLP_CHECK(scene.system(0).drawX() == scene.system(0).x());
+}
+
+SLP_TEST(advanceReportsExitsFromEveryStep) {
+    ParticleConfig config = rainConfig(1);
+    config.bounds = {0.0f, 0.0f, 400.0f, 10.0f};
+    config.y = {5.0f, 5.0f};
+    // Ten points a step through a ten-point box: one exit per step.
+    config.velocityY = {600.0f, 600.0f};
+    config.radiusX = {0.0f, 0.0f};
+    config.windX = 0.0f;
+    ParticleScene scene(4);
+    scene.add(config);
+
+    SLP_CHECK_EQ(scene.advance(4.5 / 60.0), 4);
+    SLP_CHECK_EQ(scene.system(0).exitCount(), 4u);
+    // No step this frame, so nothing left.
+    SLP_CHECK_EQ(scene.advance(0.1 / 60.0), 0);
+    SLP_CHECK_EQ(scene.system(0).exitCount(), 0u);
+    // Re-entry snaps instead of sweeping back across the box.
+    scene.advance(1.0 / 60.0);
+    SLP_CHECK_NEAR(scene.system(0).drawY()[0], scene.system(0).y()[0], 1e-4f);
+}
+
+SLP_TEST(stepsNeverAllocate) {
+    ParticleScene scene(9);
+    scene.add(orbitConfig(1000));
+    scene.add(rainConfig(1000));
+    ParticleConfig stars;
+    stars.count = 333;
+    stars.twinkleRate = {0.5f, 2.0f};
+    stars.twinkleDepth = 0.6f;
+    scene.add(stars);
+    scene.update(0.0);
+
+    const std::size_t before = allocationCount.load();
+    for (int frame = 0; frame < 600; ++frame) scene.update(1.0 / 60.0);
+    for (int frame = 0; frame < 600; ++frame) scene.advance(1.0 / 45.0);
+    SLP_CHECK_EQ(allocationCount.load(), before);
+    // Every drop could leave in one frame and the exits would still fit.
+    SLP_CHECK(scene.arena().capacity() >= 1000 * sizeof(ParticleExit));
+    SLP_CHECK(scene.arena().highWater() > 0);
+}
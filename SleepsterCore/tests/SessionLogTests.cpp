@@ -0,0 +1,338 @@
+//
+//  SessionLogTests.cpp
+//  SleepsterCore
+//
+
+#include "TestHarness.hpp"
+
+#include "SLPSessionLog.h"
+#include "sleepster/SessionLog.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace sleepster;
+
+namespace {
+
+std::string tempPath(const char* name) {
+    const std::string path = std::string("/tmp/sleepster_") + name;
+    std::remove(path.c_str());
+    std::remove((path + ".idx").c_str());
+    return path;
+}
+
+SessionId idFor(int night) {
+    SessionId id{};
+    for (int i = 0; i < 4; ++i) id[i] = static_cast<uint8_t>(night >> (8 * i));
+    id[15] = 0x5E;
+    return id;
+}
+
+SleepSessionRecord nightOf(int night) {
+    SleepSessionRecord session;
+    session.id = idFor(night);
+    session.startTime = 1.7e9 + night * 86400.0;
+    session.endTime = session.startTime + 7.5 * 3600.0;
+    session.expectedDuration = 8 * 3600.0;
+    session.actualDuration = 7.5 * 3600.0;
+    session.soundsUsed = {"Rain", "Ocean Waves"};
+    session.hasBackground = night % 2 == 0;
+    session.backgroundUsed = session.hasBackground ? "Counting Sheep" : "";
+    session.masterVolume = 0.6f;
+    session.activeSounds = {"Rain"};
+    session.equalizerPreset = "Sleep";
+    session.effectsEnabled = night % 3 == 0;
+    if (night % 4 == 0) {
+        session.soundEvents = {{SoundEventKind::Snoring, session.startTime + 1800.0, 1.2f, -31.0f},
+                               {SoundEventKind::Coughing, session.startTime + 4000.5, 0.4f, -22.5f}};
+    }
+    return session;
+}
+
+std::size_t sizeOf(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return file ? static_cast<std::size_t>(file.tellg()) : 0;
+}
+
+std::vector<uint8_t> contentsOf(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+void overwrite(const std::string& path, const std::vector<uint8_t>& bytes) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+bool sameSession(const SleepSessionRecord& a, const SleepSessionRecord& b) {
+    return a.id == b.id && a.startTime == b.startTime && a.endTime == b.endTime &&
+           a.expectedDuration == b.expectedDuration && a.actualDuration == b.actualDuration &&
+           a.soundsUsed == b.soundsUsed && a.hasBackground == b.hasBackground &&
+           a.backgroundUsed == b.backgroundUsed && a.masterVolume == b.masterVolume &&
+           a.activeSounds == b.activeSounds && a.equalizerPreset == b.equalizerPreset &&
+           a.effectsEnabled == b.effectsEnabled && a.soundEvents.size() == b.soundEvents.size() &&
+           std::equal(a.soundEvents.begin(), a.soundEvents.end(), b.soundEvents.begin(),
+                      [](const SoundEvent& x, const SoundEvent& y) {
+                          return x.kind == y.kind && x.time == y.time && x.duration == y.duration &&
+                                 x.peakLevel == y.peakLevel;
+                      });
+}
+
+SessionLogOptions unsynced() {
+    SessionLogOptions options;
+    options.syncEachAppend = false;
+    return options;
+}
+
+} // namespace
+
+SLP_TEST(sessionsSurviveReopeningWithoutACap) {
+    const std::string path = tempPath("sessions.slog");
+    {
+        auto log = SessionLog::open(path, unsynced());
+        SLP_CHECK(log != nullptr);
+        SLP_CHECK_EQ(log->size(), std::size_t{0});
+        for (int night = 0; night < 365; ++night) SLP_CHECK(log->append(nightOf(night)));
+    }
+    auto log = SessionLog::open(path);
+    SLP_CHECK(log != nullptr);
+    // The old store kept the last 100; the log keeps every night.
+    SLP_CHECK_EQ(log->size(), std::size_t{365});
+    SleepSessionRecord session;
+    for (int night : {0, 99, 100, 364}) {
+        SLP_CHECK(log->read(static_cast<std::size_t>(night), session));
+        SLP_CHECK(sameSession(session, nightOf(night)));
+    }
+    SLP_CHECK(!log->read(365, session));
+    SLP_CHECK_EQ(sizeOf(path + ".idx"), sessionlog::kHeaderSize + 365 * sessionlog::kEntrySize);
+}
+
+SLP_TEST(appendsAreReadableBeforeReopening) {
+    const std::string path = tempPath("fresh.slog");
+    auto log = SessionLog::open(path);
+    SleepSessionRecord session;
+    for (int night = 0; night < 3; ++night) {
+        SLP_CHECK(log->append(nightOf(night)));
+        // Each read past the mapping maps the grown file again.
+        SLP_CHECK(log->read(static_cast<std::size_t>(night), session));
+        SLP_CHECK(sameSession(session, nightOf(night)));
+    }
+}
+
+SLP_TEST(aLaterRecordSupersedesAndATombstoneRemoves) {
+    const std::string path = tempPath("supersede.slog");
+    auto log = SessionLog::open(path, unsynced());
+    // A session is stored when it starts and again when it ends.
+    SleepSessionRecord running = nightOf(1);
+    running.endTime = std::nan("");
+    running.actualDuration = std::nan("");
+    SLP_CHECK(log->append(nightOf(0)));
+    SLP_CHECK(log->append(running));
+    SLP_CHECK(log->append(nightOf(2)));
+    SLP_CHECK(log->append(nightOf(1)));
+    SLP_CHECK_EQ(log->size(), std::size_t{3});
+    SLP_CHECK_EQ(log->recordCount(), std::size_t{4});
+    SLP_CHECK(log->deadBytes() > 0);
+
+    SleepSessionRecord session;
+    SLP_CHECK(log->find(idFor(1), session));
+    SLP_CHECK(!std::isnan(session.endTime));
+    // Live sessions are ordered by their latest record.
+    SLP_CHECK(log->read(2, session));
+    SLP_CHECK(session.id == idFor(1));
+
+    SLP_CHECK(log->remove(idFor(0)));
+    SLP_CHECK(!log->remove(idFor(0)));
+    SLP_CHECK(!log->find(idFor(0), session));
+    log.reset();
+
+    log = SessionLog::open(path);
+    SLP_CHECK_EQ(log->size(), std::size_t{2});
+    SLP_CHECK(log->read(0, session));
+    SLP_CHECK(session.id == idFor(2));
+}
+
+SLP_TEST(aTornAppendIsCutOff) {
+    const std::string path = tempPath("torn.slog");
+    {
+        auto log = SessionLog::open(path);
+        for (int night = 0; night < 5; ++night) log->append(nightOf(night));
+    }
+    // The last record loses its final bytes, as if the device died mid-write.
+    std::vector<uint8_t> bytes = contentsOf(path);
+    const std::size_t intact = bytes.size();
+    bytes.resize(intact - 7);
+    overwrite(path, bytes);
+
+    auto log = SessionLog::open(path);
+    SLP_CHECK(log != nullptr);
+    SLP_CHECK_EQ(log->size(), std::size_t{4});
+    SLP_CHECK(log->fileBytes() < intact - 7);
+    // The next append lands where the torn one began.
+    SLP_CHECK(log->append(nightOf(9)));
+    log.reset();
+    log = SessionLog::open(path);
+    SleepSessionRecord session;
+    SLP_CHECK_EQ(log->size(), std::size_t{5});
+    SLP_CHECK(log->read(4, session));
+    SLP_CHECK(sameSession(session, nightOf(9)));
+}
+
+SLP_TEST(aCorruptRecordEndsTheLog) {
+    const std::string path = tempPath("corrupt.slog");
+    {
+        auto log = SessionLog::open(path);
+        for (int night = 0; night < 3; ++night) log->append(nightOf(night));
+    }
+    // Flip a byte inside the last record and lose the index.
+    std::vector<uint8_t> bytes = contentsOf(path);
+    bytes[bytes.size() - 3] ^= 0xFF;
+    overwrite(path, bytes);
+    std::remove((path + ".idx").c_str());
+
+    auto log = SessionLog::open(path);
+    SLP_CHECK_EQ(log->size(), std::size_t{2});
+    SLP_CHECK_EQ(sizeOf(path + ".idx"), sessionlog::kHeaderSize + 2 * sessionlog::kEntrySize);
+}
+
+SLP_TEST(aMissingOrStaleIndexIsRebuiltFromTheLog) {
+    const std::string path = tempPath("rebuild.slog");
+    {
+        auto log = SessionLog::open(path);
+        for (int night = 0; night < 10; ++night) log->append(nightOf(night));
+    }
+    const std::vector<uint8_t> index = contentsOf(path + ".idx");
+
+    // Index entries lost for the last three appends.
+    std::vector<uint8_t> shortIndex(index.begin(), index.end() - 3 * sessionlog::kEntrySize);
+    overwrite(path + ".idx", shortIndex);
+    {
+        auto log = SessionLog::open(path);
+        SLP_CHECK_EQ(log->size(), std::size_t{10});
+    }
+    SLP_CHECK(contentsOf(path + ".idx") == index);
+
+    // An index from another generation.
+    std::vector<uint8_t> stale = index;
+    stale[8] ^= 0x01;
+    overwrite(path + ".idx", stale);
+    auto log = SessionLog::open(path);
+    SLP_CHECK_EQ(log->size(), std::size_t{10});
+    SleepSessionRecord session;
+    SLP_CHECK(log->read(9, session));
+    SLP_CHECK(sameSession(session, nightOf(9)));
+}
+
+SLP_TEST(compactionKeepsOnlyLiveSessions) {
+    const std::string path = tempPath("compact.slog");
+    SessionLogOptions options = unsynced();
+    options.compactMinimumBytes = 1024;
+    auto log = SessionLog::open(path, options);
+    // Every night stored twice, and every fourth one removed.
+    for (int night = 0; night < 200; ++night) {
+        SleepSessionRecord running = nightOf(night);
+        running.endTime = std::nan("");
+        log->append(running);
+        log->append(nightOf(night));
+        if (night % 4 == 3) log->remove(idFor(night));
+    }
+    SLP_CHECK(log->needsCompaction());
+    const std::size_t before = log->fileBytes();
+    const std::size_t dead = log->deadBytes();
+
+    SLP_CHECK(log->compact());
+    SLP_CHECK_EQ(log->fileBytes(), before - dead);
+    SLP_CHECK_EQ(log->deadBytes(), std::size_t{0});
+    SLP_CHECK_EQ(log->recordCount(), std::size_t{150});
+    SLP_CHECK(!log->needsCompaction());
+    SleepSessionRecord session;
+    SLP_CHECK(log->read(3, session));
+    SLP_CHECK(sameSession(session, nightOf(4)));
+
+    // Appends after compaction go to the new files.
+    SLP_CHECK(log->append(nightOf(500)));
+    log.reset();
+    log = SessionLog::open(path);
+    SLP_CHECK_EQ(log->size(), std::size_t{151});
+    SLP_CHECK(log->read(150, session));
+    SLP_CHECK(sameSession(session, nightOf(500)));
+    SLP_CHECK(access((path + ".compact").c_str(), F_OK) != 0);
+}
+
+SLP_TEST(somethingElseIsNotOverwritten) {
+    const std::string path = tempPath("foreign.slog");
+    overwrite(path, std::vector<uint8_t>(64, 'x'));
+    SLP_CHECK(SessionLog::open(path) == nullptr);
+    SLP_CHECK_EQ(sizeOf(path), std::size_t{64});
+}
+
+SLP_TEST(payloadsRoundTripAndRejectTruncation) {
+    std::vector<uint8_t> payload{0xAA};
+    SLP_CHECK(encodeSession(nightOf(4), payload));
+    SleepSessionRecord session;
+    SLP_CHECK(decodeSession(payload.data() + 1, payload.size() - 1, session));
+    SLP_CHECK(sameSession(session, nightOf(4)));
+    for (std::size_t cut = 1; cut < payload.size() - 1; cut += 5) {
+        SLP_CHECK(!decodeSession(payload.data() + 1, cut, session));
+    }
+    payload.assign(1, 0xAA);
+    SLP_CHECK(encodeSession(nightOf(1), payload));
+    SLP_CHECK(decodeSession(payload.data() + 1, payload.size() - 1, session));
+    SLP_CHECK(session.soundEvents.empty());
+    SleepSessionRecord tooLong = nightOf(1);
+    tooLong.equalizerPreset.assign(70000, 'a');
+    SLP_CHECK(!encodeSession(tooLong, payload));
+    SLP_CHECK_EQ(crc32(reinterpret_cast<const uint8_t*>("123456789"), 9), 0xCBF43926u);
+}
+
+SLP_TEST(cInterfaceStoresAndReadsSessions) {
+    const std::string path = tempPath("c.slog");
+    SLPSessionLog* log = SLPSessionLogOpen(path.c_str());
+    SLP_CHECK(log != nullptr);
+    const char* sounds[] = {"Rain", "Thunder"};
+    SLPSleepSession session{};
+    session.id[0] = 7;
+    session.startTime = 1.7e9;
+    session.endTime = std::nan("");
+    session.expectedDuration = 28800.0;
+    session.actualDuration = std::nan("");
+    session.soundsUsed = sounds;
+    session.soundsUsedCount = 2;
+    session.backgroundUsed = nullptr;
+    session.masterVolume = 0.5f;
+    session.activeSounds = sounds;
+    session.activeSoundsCount = 1;
+    session.equalizerPreset = "Flat";
+    session.effectsEnabled = true;
+    const SLPSoundEvent events[] = {{SLPSoundEventSnoring, 1.7e9 + 3600.0, 1.5f, -30.0f}};
+    session.soundEvents = events;
+    session.soundEventsCount = 1;
+    SLP_CHECK(SLPSessionLogAppend(log, &session));
+    SLP_CHECK_EQ(SLPSessionLogGetCount(log), std::size_t{1});
+
+    SLPSleepSession read{};
+    SLP_CHECK(SLPSessionLogGetSession(log, 0, &read));
+    SLP_CHECK_EQ(read.id[0], 7);
+    SLP_CHECK(std::isnan(read.endTime));
+    SLP_CHECK_EQ(read.soundsUsedCount, std::size_t{2});
+    SLP_CHECK(std::string(read.soundsUsed[1]) == "Thunder");
+    SLP_CHECK(read.backgroundUsed == nullptr);
+    SLP_CHECK(std::string(read.equalizerPreset) == "Flat");
+    SLP_CHECK(read.effectsEnabled);
+    SLP_CHECK_EQ(read.soundEventsCount, std::size_t{1});
+    SLP_CHECK(read.soundEvents[0].kind == SLPSoundEventSnoring);
+    SLP_CHECK_EQ(read.soundEvents[0].time, 1.7e9 + 3600.0);
+    SLP_CHECK(!SLPSessionLogGetSession(log, 1, &read));
+    SLP_CHECK(!SLPSessionLogNeedsCompaction(log));
+
+    SLP_CHECK(SLPSessionLogRemove(log, session.id));
+    SLP_CHECK_EQ(SLPSessionLogGetCount(log), std::size_t{0});
+    SLPSessionLogClose(log);
+}
@@ -0,0 +1,145 @@
+//
+//  ShapeGeometryTests.cpp
+//  SleepsterCore
+//
+
+#include "TestHarness.hpp"
+
+#include "SLPGeometry.h"
+#include "sleepster/ShapeGeometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace sleepster;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+struct Bounds {
+    float minX = 1e30f;
+    float minY = 1e30f;
+    float maxX = -1e30f;
+    float maxY = -1e30f;
+};
+
+Bounds boundsOf(const std::vector<float>& points) {
+    Bounds bounds;
+    for (std::size_t i = 0; i < points.size(); i += 2) {
+        bounds.minX = std::min(bounds.minX, points[i]);
+        bounds.maxX = std::max(bounds.maxX, points[i]);
+        bounds.minY = std::min(bounds.minY, points[i + 1]);
+        bounds.maxY = std::max(bounds.maxY, points[i + 1]);
+    }
+    return bounds;
+}
+
+/// Points each verb consumes, so a path can be walked and checked.
+std::size_t pointsFor(PathVerb verb) {
+    switch (verb) {
+    case PathVerb::Move:
+    case PathVerb::Line: return 1;
+    case PathVerb::Quad: return 2;
+    case PathVerb::Cubic: return 3;
+    case PathVerb::Close: return 0;
+    }
+    return 0;
+}
+
+} // namespace
+
+SLP_TEST(unitCircleTablesMatchLibm) {
+    constexpr auto& circle = kUnitCircle<40>;
+    static_assert(circle.cos[0] == 1.0f);
+    for (int k = 0; k < 40; ++k) {
+        const double angle = 2.0 * kPi * k / 40.0;
+        SLP_CHECK_NEAR(circle.cos[k], std::cos(angle), 1e-7);
+        SLP_CHECK_NEAR(circle.sin[k], std::sin(angle), 1e-7);
+    }
+    SLP_CHECK_NEAR(kUnitCircle<9>.sin[5], std::sin(10.0 * kPi / 9.0), 1e-7);
+}
+
+SLP_TEST(everyShapeHasAsManyPointsAsItsVerbsTake) {
+    for (int k = 0; k < kShapeKindCount; ++k) {
+        const ShapePath& path = unitShape(static_cast<ShapeKind>(k));
+        std::size_t expected = 0;
+        for (PathVerb verb : path.verbs()) expected += pointsFor(verb);
+        SLP_CHECK(!path.verbs().empty());
+        SLP_CHECK_EQ(path.pointCount(), expected);
+        SLP_CHECK(path.verbs().front() == PathVerb::Move);
+    }
+}
+
+SLP_TEST(metatronsCubeJoinsEveryPairOfHexagonVertices) {
+    const ShapePath& path = unitShape(ShapeKind::MetatronsCube);
+    // 15 pair lines and 6 spokes, each a move and a line.
+    SLP_CHECK_EQ(path.verbs().size(), std::size_t{42});
+    const auto& points = path.points();
+    // The first line runs from vertex 0 to vertex 1, a third of the side out.
+    SLP_CHECK_NEAR(points[0], 1.0 / 3.0, 1e-6);
+    SLP_CHECK_NEAR(points[1], 0.0, 1e-6);
+    SLP_CHECK_NEAR(points[2], std::cos(kPi / 3.0) / 3.0, 1e-6);
+    SLP_CHECK_NEAR(points[3], std::sin(kPi / 3.0) / 3.0, 1e-6);
+}
+
+SLP_TEST(enneagramStartsAtTheTop) {
+    const ShapePath& path = unitShape(ShapeKind::Enneagram);
+    const auto& points = path.points();
+    SLP_CHECK_NEAR(points[0], 0.0, 1e-6);
+    SLP_CHECK_NEAR(points[1], -0.5, 1e-6);
+    const double end = 8.0 * kPi / 9.0 - kPi / 2.0;
+    SLP_CHECK_NEAR(points[2], 0.5 * std::cos(end), 1e-6);
+    SLP_CHECK_NEAR(points[3], 0.5 * std::sin(end), 1e-6);
+}
+
+SLP_TEST(mandalaRingsReachHalfTheSmallerSide) {
+    const Bounds bounds = boundsOf(unitShape(ShapeKind::SacredMandala).points());
+    SLP_CHECK_NEAR(bounds.minX, -0.5, 1e-6);
+    SLP_CHECK_NEAR(bounds.maxX, 0.5, 1e-6);
+    SLP_CHECK_NEAR(bounds.maxY, 0.5, 1e-6);
+}
+
+SLP_TEST(ellipsesKeepTheirControlPointsInsideTheRect) {
+    ShapePath path;
+    path.addEllipse(10.0f, 20.0f, 40.0f, 10.0f);
+    SLP_CHECK_EQ(path.verbs().size(), std::size_t{6});
+    const Bounds bounds = boundsOf(path.points());
+    SLP_CHECK_NEAR(bounds.minX, 10.0, 1e-5);
+    SLP_CHECK_NEAR(bounds.maxX, 50.0, 1e-5);
+    SLP_CHECK_NEAR(bounds.minY, 20.0, 1e-5);
+    SLP_CHECK_NEAR(bounds.maxY, 30.0, 1e-5);
+    // Starts on the right, as CGPath's ellipses do.
+    SLP_CHECK_NEAR(path.points()[0], 50.0, 1e-5);
+    SLP_CHECK_NEAR(path.points()[1], 25.0, 1e-5);
+}
+
+SLP_TEST(sheepIsScaledToSixtiethsOfTheSmallerSide) {
+    const Bounds bounds = boundsOf(unitShape(ShapeKind::Sheep).points());
+    // Leftmost scallop at -19 units, hooves' bottom at 18.75 units.
+    SLP_CHECK_NEAR(bounds.minX, -19.0 / 60.0, 1e-6);
+    SLP_CHECK_NEAR(bounds.maxY, 18.75 / 60.0, 1e-6);
+}
+
+SLP_TEST(placedShapeIsCentredAndScaledBySmallerSide) {
+    const ShapePath& unit = unitShape(ShapeKind::FlowerOfLife);
+    std::vector<float> placed(unit.points().size());
+    placeShape(unit, 100.0f, 50.0f, 300.0f, 120.0f, placed.data());
+    for (std::size_t i = 0; i < placed.size(); i += 2) {
+        SLP_CHECK_NEAR(placed[i], 250.0f + unit.points()[i] * 120.0f, 1e-3);
+        SLP_CHECK_NEAR(placed[i + 1], 110.0f + unit.points()[i + 1] * 120.0f, 1e-3);
+    }
+    const Bounds bounds = boundsOf(placed);
+    SLP_CHECK_NEAR(bounds.minX, 250.0 - 40.0, 1e-3);
+    SLP_CHECK_NEAR(bounds.maxY, 110.0 + 20.0 + 10.0 * std::sqrt(3.0), 1e-3);
+}
+
+SLP_TEST(cInterfaceSharesTheUnitArrays) {
+    const SLPShapePath path = SLPShapeGetUnitPath(SLPShapeSriYantra);
+    const ShapePath& native = unitShape(ShapeKind::SriYantra);
+    SLP_CHECK(path.points == native.points().data());
+    SLP_CHECK_EQ(path.verbCount, 32u);
+    SLP_CHECK_EQ(path.pointCount, 24u);
+    SLP_CHECK_EQ(path.verbs[3], static_cast<uint8_t>(SLPPathVerbClose));
+}
@@ -0,0 +1,279 @@
+//
+//  SleepStatsTests.cpp
+//  SleepsterCore
+//
+//  Running summaries are checked against the two-pass reductions
+//  SleepTracker used to make over the whole sample array.
+//
+
+#include "TestHarness.hpp"
+
+#include "SLPSleepStats.h"
+#include "sleepster/Random.hpp"
+#include "sleepster/SleepStats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace sleepster;
+
+namespace {
+
+constexpr double kDay = 86400.0;
+constexpr double kHour = 3600.0;
+/// 2024-01-01, a Monday.
+constexpr int64_t kNewYear2024 = 19723;
+
+SleepSampleId idOf(uint32_t number) {
+    SleepSampleId id{};
+    for (int i = 0; i < 4; ++i) id[i] = static_cast<uint8_t>(number >> (8 * i));
+    return id;
+}
+
+/// A sample starting `hour` hours after local midnight of day `day`.
+SleepSample sampleOn(uint32_t number, int64_t day, double hour, double duration, SleepCategory category,
+                     int32_t utcOffset = 0) {
+    SleepSample sample;
+    sample.id = idOf(number);
+    sample.startTime = static_cast<double>(day) * kDay + hour * kHour - utcOffset;
+    sample.endTime = sample.startTime + duration;
+    sample.utcOffset = utcOffset;
+    sample.category = category;
+    return sample;
+}
+
+/// What the old code computed: filter the samples, then reduce them.
+SleepSummary bruteForce(const std::vector<SleepSample>& samples, int64_t first, int64_t last) {
+    SleepSummary summary;
+    for (const SleepSample& sample : samples) {
+        const int64_t night = SleepStats::nightOf(sample.startTime, sample.utcOffset);
+        if (night < first || night > last) continue;
+        const double duration = sample.endTime - sample.startTime;
+        if (sample.category == SleepCategory::Asleep) {
+            summary.asleep.add(duration);
+        } else {
+            summary.inBed.add(duration);
+            const double local = std::fmod(sample.startTime + sample.utcOffset, kDay);
+            summary.bedtime.add(local / kDay * 6.283185307179586);
+        }
+    }
+    return summary;
+}
+
+void checkSame(const SleepSummary& a, const SleepSummary& b) {
+    SLP_CHECK_EQ(a.asleep.count, b.asleep.count);
+    SLP_CHECK_EQ(a.inBed.count, b.inBed.count);
+    SLP_CHECK_EQ(a.bedtime.count, b.bedtime.count);
+    SLP_CHECK_NEAR(a.asleep.total(), b.asleep.total(), 1e-6 * (1.0 + b.asleep.total()));
+    SLP_CHECK_NEAR(a.inBed.total(), b.inBed.total(), 1e-6 * (1.0 + b.inBed.total()));
+    SLP_CHECK_NEAR(a.asleep.deviation(), b.asleep.deviation(), 1e-3);
+    SLP_CHECK_NEAR(a.efficiency(), b.efficiency(), 1e-6);
+    SLP_CHECK_NEAR(a.bedtime.sumCos, b.bedtime.sumCos, 1e-6);
+    SLP_CHECK_NEAR(a.bedtime.sumSin, b.bedtime.sumSin, 1e-6);
+}
+
+/// `nights` nights from `firstDay`, each an in-bed sample and three asleep
+/// segments.
+std::vector<SleepSample> syntheticYears(int64_t firstDay, int nights, uint64_t seed) {
+    Random random(seed);
+    std::vector<SleepSample> samples;
+    uint32_t number = 1;
+    for (int night = 0; night < nights; ++night) {
+        const int64_t day = firstDay + night;
+        const double bedHour = 21.5 + 3.0 * random.uniform();
+        const double inBed = (7.0 + 2.0 * random.uniform()) * kHour;
+        samples.push_back(sampleOn(number++, day, bedHour, inBed, SleepCategory::InBed, 3600));
+        double hour = bedHour + 0.3;
+        for (int segment = 0; segment < 3; ++segment) {
+            const double length = (1.5 + random.uniform()) * kHour;
+            samples.push_back(sampleOn(number++, day, hour, length, SleepCategory::Asleep, 3600));
+            hour += length / kHour + 0.2;
+        }
+    }
+    return samples;
+}
+
+} // namespace
+
+SLP_TEST(runningMomentsMatchTwoPassReductions) {
+    Random random(7);
+    std::vector<double> values;
+    for (int i = 0; i < 1000; ++i) values.push_back(6.0 * kHour + 2.0 * kHour * random.uniform());
+
+    auto twoPass = [](const std::vector<double>& v, std::size_t from, std::size_t to, double& variance) {
+        double mean = 0.0;
+        for (std::size_t i = from; i < to; ++i) mean += v[i];
+        mean /= static_cast<double>(to - from);
+        variance = 0.0;
+        for (std::size_t i = from; i < to; ++i) variance += (v[i] - mean) * (v[i] - mean);
+        variance /= static_cast<double>(to - from);
+        return mean;
+    };
+
+    RunningMoments all;
+    RunningMoments first;
+    RunningMoments second;
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        all.add(values[i]);
+        (i < 400 ? first : second).add(values[i]);
+    }
+    double variance = 0.0;
+    const double mean = twoPass(values, 0, values.size(), variance);
+    SLP_CHECK_NEAR(all.mean, mean, 1e-6);
+    SLP_CHECK_NEAR(all.variance(), variance, 1e-3 * variance);
+
+    first.merge(second);
+    SLP_CHECK_EQ(first.count, all.count);
+    SLP_CHECK_NEAR(first.mean, mean, 1e-6);
+    SLP_CHECK_NEAR(first.variance(), variance, 1e-3 * variance);
+
+    for (std::size_t i = 0; i < 400; ++i) all.remove(values[i]);
+    const double tailMean = twoPass(values, 400, values.size(), variance);
+    SLP_CHECK_EQ(all.count, 600u);
+    SLP_CHECK_NEAR(all.mean, tailMean, 1e-6);
+    SLP_CHECK_NEAR(all.variance(), variance, 1e-3 * variance);
+}
+
+SLP_TEST(bedtimesAverageAcrossMidnight) {
+    SleepStats stats;
+    stats.add(sampleOn(1, kNewYear2024, 23.5, 8 * kHour, SleepCategory::InBed));
+    stats.add(sampleOn(2, kNewYear2024 + 2, 0.5, 7 * kHour, SleepCategory::InBed));
+
+    const SleepSummary summary = stats.total();
+    const double fromMidnight = std::min(summary.meanBedtime(), kDay - summary.meanBedtime());
+    SLP_CHECK(fromMidnight < 1.0);
+    // Half an hour either side of midnight, not eleven and a half hours
+    // either side of noon as whole-hour arithmetic had it.
+    SLP_CHECK_NEAR(summary.bedtimeDeviation(), 1800.0, 10.0);
+    SLP_CHECK_NEAR(summary.bedtimeConsistency(), 95.0, 0.1);
+}
+
+SLP_TEST(nightsRunFromNoonToNoon) {
+    const int32_t offset = -5 * 3600;
+    const double evening = static_cast<double>(kNewYear2024) * kDay + 22.0 * kHour - offset;
+    SLP_CHECK_EQ(SleepStats::nightOf(evening, offset), kNewYear2024);
+    SLP_CHECK_EQ(SleepStats::nightOf(evening + 5.0 * kHour, offset), kNewYear2024);
+    SLP_CHECK_EQ(SleepStats::nightOf(evening + 15.0 * kHour, offset), kNewYear2024 + 1);
+    // 08:00 the next morning locally is already past noon in UTC.
+    SLP_CHECK_EQ(SleepStats::nightOf(evening + 10.0 * kHour, offset), kNewYear2024);
+    SLP_CHECK_EQ(SleepStats::nightOf(evening + 10.0 * kHour, 0), kNewYear2024 + 1);
+    SLP_CHECK_EQ(SleepStats::nightOf(0.0, 0), -1);
+}
+
+SLP_TEST(weeksAndMonthsFollowTheCalendar) {
+    SLP_CHECK_EQ(SleepStats::monthOf(0), 1970 * 12);
+    SLP_CHECK_EQ(SleepStats::monthOf(-1), 1969 * 12 + 11);
+    SLP_CHECK_EQ(SleepStats::monthOf(kNewYear2024), 2024 * 12);
+    SLP_CHECK_EQ(SleepStats::monthOf(kNewYear2024 - 1), 2023 * 12 + 11);
+    SLP_CHECK_EQ(SleepStats::monthOf(kNewYear2024 + 59), 2024 * 12 + 1); // Feb 29
+    SLP_CHECK_EQ(SleepStats::monthOf(kNewYear2024 + 60), 2024 * 12 + 2);
+
+    const int64_t week = SleepStats::weekOf(kNewYear2024);
+    SLP_CHECK_EQ(SleepStats::weekOf(kNewYear2024 + 6), week);
+    SLP_CHECK_EQ(SleepStats::weekOf(kNewYear2024 + 7), week + 1);
+    SLP_CHECK_EQ(SleepStats::weekOf(kNewYear2024 - 1), week - 1);
+    SLP_CHECK_EQ(SleepStats::weekOf(-3), 0); // Monday 1969-12-29
+    SLP_CHECK_EQ(SleepStats::weekOf(-4), -1);
+}
+
+SLP_TEST(rangesMatchABruteForceRescan) {
+    std::vector<SleepSample> samples = syntheticYears(kNewYear2024 - 3 * 365, 3 * 365, 11);
+    // Arrival order should not matter, and shuffling grows the tree both ways.
+    Random random(3);
+    for (std::size_t i = samples.size() - 1; i > 0; --i) std::swap(samples[i], samples[random.next() % (i + 1)]);
+
+    SleepStats stats;
+    for (const SleepSample& sample : samples) SLP_CHECK(stats.add(sample));
+    SLP_CHECK_EQ(stats.size(), samples.size());
+    checkSame(stats.total(), bruteForce(samples, INT64_MIN, INT64_MAX));
+
+    for (int query = 0; query < 200; ++query) {
+        const int64_t a = kNewYear2024 - 3 * 365 - 10 + static_cast<int64_t>(random.next() % (3 * 365 + 20));
+        const int64_t b = a + static_cast<int64_t>(random.next() % 400);
+        checkSame(stats.range(a, b), bruteForce(samples, a, b));
+    }
+    checkSame(stats.night(kNewYear2024 - 10), bruteForce(samples, kNewYear2024 - 10, kNewYear2024 - 10));
+    SLP_CHECK_EQ(stats.range(kNewYear2024 + 10, kNewYear2024 + 20).asleep.count, 0u);
+}
+
+SLP_TEST(weekAndMonthRollupsMatchTheirRanges) {
+    const std::vector<SleepSample> samples = syntheticYears(kNewYear2024 - 100, 200, 5);
+    SleepStats stats;
+    for (const SleepSample& sample : samples) stats.add(sample);
+
+    checkSame(stats.week(SleepStats::weekOf(kNewYear2024)), stats.range(kNewYear2024, kNewYear2024 + 6));
+    // December 2023 has 31 nights.
+    checkSame(stats.month(2023 * 12 + 11), stats.range(kNewYear2024 - 31, kNewYear2024 - 1));
+    SLP_CHECK_EQ(stats.month(2030 * 12).inBed.count, 0u);
+}
+
+SLP_TEST(removedSamplesLeaveNoTrace) {
+    const std::vector<SleepSample> kept = syntheticYears(kNewYear2024, 60, 1);
+    std::vector<SleepSample> removed = syntheticYears(kNewYear2024 + 30, 60, 2);
+    for (SleepSample& sample : removed) sample.id[15] = 1;
+
+    SleepStats stats;
+    for (const SleepSample& sample : kept) stats.add(sample);
+    for (const SleepSample& sample : removed) stats.add(sample);
+    for (const SleepSample& sample : removed) SLP_CHECK(stats.remove(sample.id));
+
+    SLP_CHECK_EQ(stats.size(), kept.size());
+    checkSame(stats.total(), bruteForce(kept, INT64_MIN, INT64_MAX));
+    checkSame(stats.range(kNewYear2024 + 20, kNewYear2024 + 80), bruteForce(kept, kNewYear2024 + 20, kNewYear2024 + 80));
+    checkSame(stats.month(2024 * 12 + 1), bruteForce(kept, kNewYear2024 + 31, kNewYear2024 + 59));
+    SLP_CHECK_EQ(stats.night(kNewYear2024 + 75).asleep.count, 0u);
+    SLP_CHECK_EQ(stats.night(kNewYear2024 + 75).bedtime.count, 0u);
+}
+
+SLP_TEST(duplicatesAndBadSamplesAreRejected) {
+    SleepStats stats;
+    const SleepSample sample = sampleOn(1, kNewYear2024, 23.0, 8 * kHour, SleepCategory::Asleep);
+    SLP_CHECK(stats.add(sample));
+    SLP_CHECK(!stats.add(sample));
+
+    SleepSample backwards = sampleOn(2, kNewYear2024, 23.0, 8 * kHour, SleepCategory::Asleep);
+    std::swap(backwards.startTime, backwards.endTime);
+    SLP_CHECK(!stats.add(backwards));
+    SleepSample undefined = sampleOn(3, kNewYear2024, 23.0, 8 * kHour, SleepCategory::Asleep);
+    undefined.endTime = std::nan("");
+    SLP_CHECK(!stats.add(undefined));
+    SLP_CHECK(!stats.add(sampleOn(4, kNewYear2024 + 200000, 23.0, kHour, SleepCategory::Asleep)));
+
+    SLP_CHECK(!stats.remove(idOf(9)));
+    SLP_CHECK_EQ(stats.size(), 1u);
+    SLP_CHECK_EQ(stats.total().asleep.count, 1u);
+}
+
+SLP_TEST(cInterfaceSummarizesRanges) {
+    SLPSleepStats* stats = SLPSleepStatsCreate();
+    const double evening = static_cast<double>(kNewYear2024) * kDay + 22.0 * kHour;
+    SLPSleepSample sample{};
+    sample.id[0] = 1;
+    sample.startTime = evening;
+    sample.endTime = evening + 8.0 * kHour;
+    sample.category = SLPSleepCategoryInBed;
+    SLP_CHECK(SLPSleepStatsAdd(stats, &sample));
+    sample.id[0] = 2;
+    sample.startTime += 0.5 * kHour;
+    sample.endTime = sample.startTime + 6.0 * kHour;
+    sample.category = SLPSleepCategoryAsleep;
+    SLP_CHECK(SLPSleepStatsAdd(stats, &sample));
+    SLP_CHECK_EQ(SLPSleepStatsGetCount(stats), 2u);
+
+    const int64_t night = SLPSleepStatsNightOf(evening, 0);
+    const SLPSleepSummary summary = SLPSleepStatsGetRange(stats, night - 6, night);
+    SLP_CHECK_EQ(summary.asleepCount, 1u);
+    SLP_CHECK_NEAR(summary.averageAsleep, 6.0 * kHour, 1e-6);
+    SLP_CHECK_NEAR(summary.efficiency, 75.0, 1e-9);
+    SLP_CHECK_NEAR(summary.meanBedtime, 22.0 * kHour, 1e-3);
+    SLP_CHECK_NEAR(summary.bedtimeConsistency, 100.0, 1e-9);
+    SLP_CHECK_EQ(SLPSleepStatsGetWeek(stats, night).inBedCount, 1u);
+    SLP_CHECK_EQ(SLPSleepStatsGetMonth(stats, night).asleepCount, 1u);
+
+    const uint8_t id[16] = {2};
+    SLP_CHECK(SLPSleepStatsRemove(stats, id));
+    SLP_CHECK_EQ(SLPSleepStatsGetTotal(stats).asleepCount, 0u);
+    SLPSleepStatsDestroy(stats);
+}
@@ -0,0 +1,323 @@
+//
+//  SoundEventTests.cpp
+//  SleepsterCore
+//
+//  The detector is fed WAV files of synthetic night sounds, read back
+//  through WavDecoder as a recording would be: a quiet room with snores,
+//  speech, a cough and a loud noise placed at known times.
+//
+
+#include "TestHarness.hpp"
+
+#include "SLPSoundEvents.h"
+#include "sleepster/Random.hpp"
+#include "sleepster/RealFft.hpp"
+#include "sleepster/SoundEventDetector.hpp"
+#include "sleepster/WavFile.hpp"
+
+#include <cmath>
+#include <complex>
+#include <string>
+#include <vector>
+
+using namespace sleepster;
+
+namespace {
+
+constexpr double kRate = 16000.0;
+constexpr double kPi = 3.14159265358979323846;
+
+std::string tempPath(const char* name) {
+    return std::string("/tmp/sleepster_") + name;
+}
+
+float fromDb(float db) {
+    return std::pow(10.0f, db / 20.0f);
+}
+
+/// A night's recording under construction: room noise plus sounds added at
+/// given times.
+class Recording {
+public:
+    explicit Recording(double seconds, float roomDb = -65.0f) : samples_(static_cast<std::size_t>(seconds * kRate)) {
+        Random random(1);
+        const float gain = fromDb(roomDb) * std::sqrt(3.0f);
+        for (float& sample : samples_) sample = gain * random.uniform(-1.0f, 1.0f);
+    }
+
+    /// A snore: a 90 Hz buzz with falling harmonics under a slow swell.
+    void snore(double at, double seconds, float peakDb = -30.0f) {
+        Random random(static_cast<uint64_t>(at * 1000.0));
+        float rumble = 0.0f;
+        add(at, seconds, [&](double t, double) {
+            const double swell = std::sin(kPi * std::min(1.0, t / seconds));
+            double buzz = 0.0;
+            for (int k = 1; k <= 6; ++k) buzz += std::sin(2.0 * kPi * 90.0 * k * t) / (k * k);
+            rumble += 0.05f * (random.uniform(-1.0f, 1.0f) - rumble);
+            return fromDb(peakDb) * static_cast<float>(swell * swell * (0.8 * buzz + rumble));
+        });
+    }
+
+    /// Speech: a 140 Hz voice shaped by three formants, broken into
+    /// syllables four times a second.
+    void talk(double at, double seconds, float peakDb = -30.0f) {
+        add(at, seconds, [&](double t, double) {
+            const double syllable = std::pow(std::sin(kPi * 4.0 * t), 2.0);
+            double voice = 0.0;
+            for (int k = 1; k * 140.0 < 4000.0; ++k) {
+                const double hz = 140.0 * k;
+                const double shape = formant(hz, 600.0, 150.0) + 0.7 * formant(hz, 1500.0, 200.0) +
+                                     0.4 * formant(hz, 2500.0, 250.0);
+                voice += shape * std::sin(2.0 * kPi * hz * t + k);
+            }
+            return fromDb(peakDb) * static_cast<float>(0.5 * syllable * voice);
+        });
+    }
+
+    /// A cough: a burst of band-limited noise that starts at once and dies
+    /// away in a tenth of a second.
+    void cough(double at, float peakDb = -22.0f) {
+        Random random(static_cast<uint64_t>(at * 1000.0) + 7);
+        float slow = 0.0f;
+        float fast = 0.0f;
+        add(at, 0.4, [&](double t, double) {
+            const float white = random.uniform(-1.0f, 1.0f);
+            slow += 0.15f * (white - slow);
+            fast += 0.7f * (white - fast);
+            return fromDb(peakDb) * 3.0f * static_cast<float>(std::exp(-t / 0.1)) * (fast - slow);
+        });
+    }
+
+    /// A sustained, loud, broadband noise, like a fan heater kicking in.
+    /// `levelDb` is its RMS level.
+    void loudNoise(double at, double seconds, float levelDb = -15.0f) {
+        Random random(static_cast<uint64_t>(at * 1000.0) + 13);
+        add(at, seconds, [&](double t, double) {
+            const double ramp = std::min(1.0, std::min(t, seconds - t) / 0.02);
+            return fromDb(levelDb) * std::sqrt(3.0f) * static_cast<float>(ramp) * random.uniform(-1.0f, 1.0f);
+        });
+    }
+
+    /// Writes the recording and reads it back as the detector's input.
+    std::vector<float> roundTrip(const char* name) const {
+        const std::string path = tempPath(name);
+        const float* channels[] = {samples_.data()};
+        SLP_CHECK(writeWav(path, channels, 1, samples_.size(), kRate, WavFormat::Encoding::Pcm16));
+        auto decoder = WavDecoder::open(path);
+        SLP_CHECK(decoder != nullptr);
+        std::vector<float> left(samples_.size());
+        std::vector<float> right(samples_.size());
+        if (decoder) SLP_CHECK_EQ(decoder->decode(left.data(), right.data(), left.size()), left.size());
+        std::remove(path.c_str());
+        return left;
+    }
+
+private:
+    static double formant(double hz, double center, double width) {
+        const double d = (hz - center) / width;
+        return std::exp(-0.5 * d * d);
+    }
+
+    template <typename Shape>
+    void add(double at, double seconds, Shape shape) {
+        const std::size_t first = static_cast<std::size_t>(at * kRate);
+        const std::size_t count = static_cast<std::size_t>(seconds * kRate);
+        for (std::size_t i = 0; i < count && first + i < samples_.size(); ++i) {
+            samples_[first + i] += shape(static_cast<double>(i) / kRate, seconds);
+        }
+    }
+
+    std::vector<float> samples_;
+};
+
+std::vector<SoundEvent> detect(const std::vector<float>& samples, SoundEventDetector& detector,
+                               std::size_t chunk = 1024) {
+    std::vector<SoundEvent> events;
+    SoundEvent taken[16];
+    for (std::size_t at = 0; at < samples.size(); at += chunk) {
+        detector.process(samples.data() + at, std::min(chunk, samples.size() - at));
+        for (std::size_t n; (n = detector.takeEvents(taken, 16)) > 0;) events.insert(events.end(), taken, taken + n);
+    }
+    detector.flush();
+    for (std::size_t n; (n = detector.takeEvents(taken, 16)) > 0;) events.insert(events.end(), taken, taken + n);
+    return events;
+}
+
+std::size_t countOf(const std::vector<SoundEvent>& events, SoundEventKind kind) {
+    std::size_t count = 0;
+    for (const SoundEvent& event : events) count += event.kind == kind ? 1 : 0;
+    return count;
+}
+
+} // namespace
+
+SLP_TEST(realFftMatchesADirectTransform) {
+    const std::size_t size = 64;
+    RealFft fft(size);
+    Random random(3);
+    std::vector<float> input(size);
+    for (float& x : input) x = random.uniform(-1.0f, 1.0f);
+    std::vector<float> re(fft.binCount());
+    std::vector<float> im(fft.binCount());
+    fft.forward(input.data(), re.data(), im.data());
+    for (std::size_t k = 0; k < fft.binCount(); ++k) {
+        std::complex<double> sum = 0.0;
+        for (std::size_t n = 0; n < size; ++n) sum += static_cast<double>(input[n]) * std::polar(1.0, -2.0 * kPi * k * n / size);
+        SLP_CHECK_NEAR(re[k], sum.real(), 1e-4);
+        SLP_CHECK_NEAR(im[k], sum.imag(), 1e-4);
+    }
+
+    // A full-scale sine puts a quarter of its power in its bin.
+    std::vector<float> power(fft.binCount());
+    for (std::size_t n = 0; n < size; ++n) input[n] = static_cast<float>(std::sin(2.0 * kPi * 5.0 * n / size));
+    fft.powerSpectrum(input.data(), power.data());
+    SLP_CHECK_NEAR(power[5], 0.25f, 1e-5f);
+    SLP_CHECK(power[4] < 1e-8f && power[6] < 1e-8f);
+}
+
+SLP_TEST(melBandsFollowTheSpectrum) {
+    SoundEventDetector detector;
+    std::vector<float> tone(static_cast<std::size_t>(kRate));
+    Random random(5);
+    for (std::size_t i = 0; i < tone.size(); ++i) tone[i] = 1e-4f * random.uniform(-1.0f, 1.0f);
+    for (std::size_t i = tone.size() / 2; i < tone.size(); ++i) {
+        tone[i] += 0.3f * static_cast<float>(std::sin(2.0 * kPi * 1000.0 * i / kRate));
+    }
+    detector.process(tone.data(), tone.size());
+
+    // The loudest band is the one centred nearest 1 kHz.
+    const float* bands = detector.bandLevels();
+    std::size_t loudest = 0;
+    for (std::size_t b = 1; b < 32; ++b) loudest = bands[b] > bands[loudest] ? b : loudest;
+    const double mel = 2595.0 * std::log10(1.0 + 1000.0 / 700.0);
+    const double top = 2595.0 * std::log10(1.0 + 8000.0 / 700.0);
+    const double bottom = 2595.0 * std::log10(1.0 + 50.0 / 700.0);
+    const double expected = (mel - bottom) / (top - bottom) * 33.0 - 1.0;
+    SLP_CHECK(std::fabs(static_cast<double>(loudest) - expected) <= 1.0);
+    SLP_CHECK(bands[loudest] - bands[0] > 40.0f);
+}
+
+SLP_TEST(aNightOfSoundsIsTaggedAtTheRightTimes) {
+    Recording night(60.0);
+    const double snores[] = {5.0, 9.0, 13.0, 17.0};
+    for (double at : snores) night.snore(at, 1.2);
+    night.talk(24.0, 2.0);
+    night.cough(32.0);
+    night.loudNoise(40.0, 1.5);
+    night.cough(48.0);
+
+    SoundEventDetector detector;
+    const std::vector<SoundEvent> events = detect(night.roundTrip("night.wav"), detector);
+
+    SLP_CHECK_EQ(events.size(), std::size_t{8});
+    SLP_CHECK_EQ(countOf(events, SoundEventKind::Snoring), std::size_t{4});
+    SLP_CHECK_EQ(countOf(events, SoundEventKind::Talking), std::size_t{1});
+    SLP_CHECK_EQ(countOf(events, SoundEventKind::Coughing), std::size_t{2});
+    SLP_CHECK_EQ(countOf(events, SoundEventKind::LoudNoise), std::size_t{1});
+    const double starts[] = {5.0, 9.0, 13.0, 17.0, 24.0, 32.0, 40.0, 48.0};
+    for (std::size_t i = 0; i < events.size() && i < 8; ++i) {
+        // Snores swell, so they cross the threshold a little late.
+        SLP_CHECK_NEAR(events[i].time, starts[i], 0.25);
+    }
+    if (events.size() == 8) {
+        SLP_CHECK_NEAR(events[6].duration, 1.5, 0.1);
+        SLP_CHECK_NEAR(events[6].peakLevel, -15.0f, 1.5f);
+    }
+}
+
+SLP_TEST(quietHopsSkipTheSpectrum) {
+    Recording night(120.0);
+    night.snore(60.0, 1.2);
+    SoundEventDetector detector;
+    const std::vector<SoundEvent> events = detect(night.roundTrip("quiet.wav"), detector);
+
+    SLP_CHECK_EQ(events.size(), std::size_t{1});
+    SLP_CHECK_NEAR(detector.time(), 120.0, 0.02);
+    // About a second of loud hops out of two minutes.
+    SLP_CHECK(detector.analyzedHops() * 50 < detector.gatedHops());
+    SLP_CHECK_NEAR(detector.noiseFloor(), -65.0f, 3.0f);
+}
+
+SLP_TEST(aSteadySoundBecomesTheFloor) {
+    // Rain from the app's own speaker starts and never stops: one loud
+    // noise while the floor climbs, then nothing, and a snore on top of
+    // the rain is still heard.
+    Recording night(90.0);
+    night.loudNoise(10.0, 100.0, -35.0f);
+    night.snore(75.0, 1.2, -15.0f);
+    SoundEventDetector detector;
+    const std::vector<SoundEvent> events = detect(night.roundTrip("steady.wav"), detector);
+
+    SLP_CHECK(events.size() <= 3);
+    SLP_CHECK(countOf(events, SoundEventKind::Snoring) == 1);
+    SLP_CHECK_NEAR(detector.noiseFloor(), -35.0f, 3.0f);
+}
+
+SLP_TEST(chunkSizeDoesNotChangeTheResult) {
+    Recording night(30.0);
+    night.snore(5.0, 1.2);
+    night.talk(12.0, 2.0);
+    night.cough(20.0);
+    const std::vector<float> samples = night.roundTrip("chunks.wav");
+
+    SoundEventDetector whole;
+    SoundEventDetector pieces;
+    const std::vector<SoundEvent> a = detect(samples, whole, samples.size());
+    const std::vector<SoundEvent> b = detect(samples, pieces, 77);
+    SLP_CHECK_EQ(a.size(), b.size());
+    for (std::size_t i = 0; i < a.size() && i < b.size(); ++i) {
+        SLP_CHECK(a[i].kind == b[i].kind);
+        SLP_CHECK_EQ(a[i].time, b[i].time);
+    }
+}
+
+SLP_TEST(aFullQueueDropsNewEventsAndCountsThem) {
+    Recording night(40.0);
+    for (int i = 0; i < 8; ++i) night.snore(2.0 + 4.0 * i, 1.2);
+    SoundEventDetectorConfig config;
+    config.eventCapacity = 3;
+    SoundEventDetector detector(config);
+    const std::size_t bytes = detector.memoryBytes();
+    const std::vector<float> samples = night.roundTrip("full.wav");
+    detector.process(samples.data(), samples.size());
+
+    SLP_CHECK_EQ(detector.droppedEvents(), 5u);
+    SoundEvent taken[8];
+    SLP_CHECK_EQ(detector.takeEvents(taken, 8), std::size_t{3});
+    SLP_CHECK_NEAR(taken[0].time, 2.0, 0.25);
+    SLP_CHECK_EQ(detector.memoryBytes(), bytes);
+}
+
+SLP_TEST(cInterfaceDetectsAt48kHz) {
+    // The same snores, at the rate an iPhone microphone delivers.
+    const double rate = 48000.0;
+    std::vector<float> samples(static_cast<std::size_t>(20.0 * rate));
+    Random random(9);
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        const double t = static_cast<double>(i) / rate;
+        float x = 1e-3f * random.uniform(-1.0f, 1.0f);
+        const double into = std::fmod(t, 5.0) - 2.0;
+        if (t > 1.0 && into >= 0.0 && into < 1.2) {
+            const double swell = std::sin(kPi * into / 1.2);
+            double buzz = 0.0;
+            for (int k = 1; k <= 6; ++k) buzz += std::sin(2.0 * kPi * 90.0 * k * t) / (k * k);
+            x += 0.03f * static_cast<float>(swell * swell * buzz);
+        }
+        samples[i] = x;
+    }
+
+    SLPSoundEventDetector* detector = SLPSoundEventDetectorCreate(rate);
+    SLPSoundEventDetectorProcess(detector, samples.data(), samples.size());
+    SLPSoundEventDetectorFlush(detector);
+    SLPSoundEvent events[8];
+    const size_t count = SLPSoundEventDetectorTakeEvents(detector, events, 8);
+    SLP_CHECK_EQ(count, size_t{4});
+    for (size_t i = 0; i < count; ++i) {
+        SLP_CHECK(events[i].kind == SLPSoundEventSnoring);
+        SLP_CHECK_NEAR(events[i].time, 2.0 + 5.0 * i, 0.25);
+    }
+    const SLPSoundEventDetectorMetrics metrics = SLPSoundEventDetectorGetMetrics(detector);
+    SLP_CHECK(metrics.analyzedHops > 0 && metrics.gatedHops > metrics.analyzedHops);
+    SLP_CHECK_EQ(metrics.droppedEvents, 0u);
+    SLPSoundEventDetectorDestroy(detector);
+}
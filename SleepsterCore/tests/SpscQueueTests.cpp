@@ -0,0 +1,70 @@
+//
+//  SpscQueueTests.cpp
+//  SleepsterCore
+//
+
+#include "TestHarness.hpp"
+
+#include "sleepster/SpscQueue.hpp"
+
+#include <cstdint>
+#include <thread>
+
+using sleepster::SpscQueue;
+
+SLP_TEST(capacityRoundsUpToPowerOfTwo) {
+    SpscQueue<int> queue(5);
+    SLP_CHECK_EQ(queue.capacity(), 8u);
+}
+
+SLP_TEST(pushFailsWhenFullAndPopFailsWhenEmpty) {
+    SpscQueue<int> queue(4);
+    for (int i = 0; i < 4; ++i) SLP_CHECK(queue.tryPush(i));
+    SLP_CHECK(!queue.tryPush(99));
+
+    int value = -1;
+    for (int i = 0; i < 4; ++i) {
+        SLP_CHECK(queue.tryPop(value));
+        SLP_CHECK_EQ(value, i);
+    }
+    SLP_CHECK(!queue.tryPop(value));
+}
+
+SLP_TEST(indicesWrapAround) {
+    SpscQueue<int> queue(4);
+    int value = 0;
+    for (int round = 0; round < 100; ++round) {
+        SLP_CHECK(queue.tryPush(round));
+        SLP_CHECK(queue.tryPush(round + 1000));
+        SLP_CHECK(queue.tryPop(value));
+        SLP_CHECK_EQ(value, round);
+        SLP_CHECK(queue.tryPop(value));
+        SLP_CHECK_EQ(value, round + 1000);
+    }
+    SLP_CHECK_EQ(queue.sizeApprox(), 0u);
+}
+
+SLP_TEST(concurrentProducerAndConsumerPreserveOrder) {
+    constexpr uint64_t kCount = 200000;
+    SpscQueue<uint64_t> queue(64);
+
+    std::thread producer([&] {
+        for (uint64_t i = 0; i < kCount; ++i) {
+            while (!queue.tryPush(i)) std::this_thread::yield();
+        }
+    });
+
+    uint64_t expected = 0;
+    bool ordered = true;
+    while (expected < kCount) {
+        uint64_t value = 0;
+        if (!queue.tryPop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ordered = ordered && value == expected;
+        ++expected;
+    }
+    producer.join();
+    SLP_CHECK(ordered);
+}
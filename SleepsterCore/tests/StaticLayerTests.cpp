@@ -0,0 +1,232 @@
+//
+//  StaticLayerTests.cpp
+//  SleepsterCore
+//
+
+#include "TestHarness.hpp"
+
+#include "sleepster/StaticLayer.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace sleepster;
+
+namespace {
+
+const Rgba kWhite{1.0f, 1.0f, 1.0f, 1.0f};
+
+Gradient solid(const Rgba& color) {
+    Gradient gradient;
+    gradient.stops[0] = color;
+    gradient.count = 1;
+    return gradient;
+}
+
+std::vector<Point> rect(float x0, float y0, float x1, float y1) {
+    return {{x0, y0}, {x1, y0}, {x1, y1}, {x0, y1}};
+}
+
+float alphaSum(const Bitmap& bitmap, int x0, int y0, int x1, int y1) {
+    float sum = 0.0f;
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) sum += bitmap.pixel(x, y).a;
+    }
+    return sum;
+}
+
+GrassConfig meadowGrass(uint64_t seed) {
+    GrassConfig config;
+    config.seed = seed;
+    config.width = 120.0f;
+    config.scale = 2.0f;
+    config.spacing = 15.0f;
+    config.jitterX = 3.0f;
+    config.baseline = 100.0f;
+    config.bladeHeight = {30.0f, 60.0f};
+    config.bladeWidth = {2.0f, 4.0f};
+    config.fill.stops[0] = {0.2f, 0.8f, 0.35f, 0.7f};
+    config.fill.stops[1] = {0.0f, 0.0f, 0.0f, 0.5f};
+    return config;
+}
+
+} // namespace
+
+SLP_TEST(gradientInterpolatesEvenlySpacedStops) {
+    Gradient gradient;
+    gradient.stops[0] = {1.0f, 0.0f, 0.0f, 1.0f};
+    gradient.stops[1] = {0.0f, 1.0f, 0.0f, 0.5f};
+    gradient.stops[2] = {0.0f, 0.0f, 1.0f, 0.0f};
+    gradient.count = 3;
+
+    SLP_CHECK_NEAR(gradient.at(0.0f).r, 1.0f, 1e-6f);
+    SLP_CHECK_NEAR(gradient.at(0.25f).r, 0.5f, 1e-6f);
+    SLP_CHECK_NEAR(gradient.at(0.25f).g, 0.5f, 1e-6f);
+    SLP_CHECK_NEAR(gradient.at(0.5f).a, 0.5f, 1e-6f);
+    SLP_CHECK_NEAR(gradient.at(1.0f).b, 1.0f, 1e-6f);
+    SLP_CHECK_NEAR(gradient.at(2.0f).a, 0.0f, 1e-6f);
+    SLP_CHECK_NEAR(gradient.at(-1.0f).r, 1.0f, 1e-6f);
+
+    // Vertical paint runs from y over extent; radial from the centre out.
+    const Paint vertical{gradient, false, 0.0f, 10.0f, 20.0f};
+    SLP_CHECK_NEAR(vertical.at(99.0f, 20.0f).g, 1.0f, 1e-6f);
+    const Paint radial{gradient, true, 5.0f, 5.0f, 4.0f};
+    SLP_CHECK_NEAR(radial.at(5.0f, 7.0f).g, 1.0f, 1e-6f);
+}
+
+SLP_TEST(fillCoversPixelsInProportionToArea) {
+    StaticLayer layer(0.0f, 0.0f, 10.0f, 10.0f, 1.0f);
+    fillPolygon(layer, rect(2.0f, 2.0f, 6.0f, 6.0f), Paint{solid(kWhite)});
+
+    SLP_CHECK_NEAR(layer.bitmap.pixel(2, 2).a, 1.0f, 1e-6f);
+    SLP_CHECK_NEAR(layer.bitmap.pixel(5, 5).a, 1.0f, 1e-6f);
+    SLP_CHECK_EQ(layer.bitmap.pixel(1, 3).a, 0.0f);
+    SLP_CHECK_EQ(layer.bitmap.pixel(6, 3).a, 0.0f);
+    SLP_CHECK_EQ(layer.bitmap.pixel(3, 6).a, 0.0f);
+    SLP_CHECK_NEAR(alphaSum(layer.bitmap, 0, 0, 10, 10), 16.0f, 1e-3f);
+
+    // Half a pixel wide on the left, a quarter tall at the top.
+    StaticLayer edges(0.0f, 0.0f, 10.0f, 10.0f, 1.0f);
+    fillPolygon(edges, rect(2.5f, 1.75f, 6.0f, 6.0f), Paint{solid(kWhite)});
+    SLP_CHECK_NEAR(edges.bitmap.pixel(2, 4).a, 0.5f, 0.01f);
+    SLP_CHECK_NEAR(edges.bitmap.pixel(4, 1).a, 0.25f, 0.01f);
+    SLP_CHECK_NEAR(edges.bitmap.pixel(2, 1).a, 0.125f, 0.01f);
+
+    // Colours are stored premultiplied.
+    StaticLayer faint(0.0f, 0.0f, 4.0f, 4.0f, 1.0f);
+    fillPolygon(faint, rect(0.0f, 0.0f, 4.0f, 4.0f), Paint{solid({1.0f, 0.5f, 0.0f, 0.5f})});
+    SLP_CHECK_NEAR(faint.bitmap.pixel(1, 1).r, 0.5f, 0.01f);
+    SLP_CHECK_NEAR(faint.bitmap.pixel(1, 1).g, 0.25f, 0.01f);
+    SLP_CHECK_NEAR(faint.bitmap.pixel(1, 1).a, 0.5f, 0.01f);
+}
+
+SLP_TEST(layerMapsPointsToDevicePixels) {
+    // A 3x layer whose top-left corner sits at (10, 20) points.
+    StaticLayer layer(10.0f, 20.0f, 10.0f, 5.0f, 3.0f);
+    SLP_CHECK_EQ(layer.bitmap.width(), 30);
+    SLP_CHECK_EQ(layer.bitmap.height(), 15);
+    SLP_CHECK_NEAR(layer.width(), 10.0f, 1e-6f);
+
+    fillPolygon(layer, rect(12.0f, 21.0f, 14.0f, 22.0f), Paint{solid(kWhite)});
+    SLP_CHECK_NEAR(alphaSum(layer.bitmap, 0, 0, 30, 15), 6.0f * 3.0f, 1e-3f);
+    SLP_CHECK_NEAR(layer.bitmap.pixel(6, 3).a, 1.0f, 1e-6f);
+    SLP_CHECK_NEAR(layer.bitmap.pixel(11, 5).a, 1.0f, 1e-6f);
+    SLP_CHECK_EQ(layer.bitmap.pixel(5, 3).a, 0.0f);
+    SLP_CHECK_EQ(layer.bitmap.pixel(12, 3).a, 0.0f);
+}
+
+SLP_TEST(blurSpreadsCoverageWithoutLosingIt) {
+    StaticLayer layer(0.0f, 0.0f, 40.0f, 40.0f, 1.0f);
+    fillPolygon(layer, rect(16.0f, 16.0f, 24.0f, 24.0f), Paint{solid(kWhite)});
+    const float before = alphaSum(layer.bitmap, 0, 0, 40, 40);
+
+    blur(layer, 2.0f);
+    SLP_CHECK_NEAR(alphaSum(layer.bitmap, 0, 0, 40, 40), before, before * 0.02f);
+    SLP_CHECK(layer.bitmap.pixel(20, 20).a < 1.0f);
+    SLP_CHECK(layer.bitmap.pixel(14, 20).a > 0.0f);
+    SLP_CHECK_EQ(layer.bitmap.pixel(2, 2).a, 0.0f);
+    // Symmetric about the square's centre.
+    SLP_CHECK_NEAR(layer.bitmap.pixel(14, 20).a, layer.bitmap.pixel(25, 20).a, 1.0f / 255.0f);
+}
+
+SLP_TEST(shadowSitsUnderTheShapeAtItsOffset) {
+    StaticLayer layer(0.0f, 0.0f, 20.0f, 20.0f, 1.0f);
+    fillPolygon(layer, rect(5.0f, 5.0f, 10.0f, 10.0f), Paint{solid(kWhite)});
+    dropShadow(layer, {0.0f, 0.0f, 0.0f, 0.5f}, 0.0f, 3.0f, 3.0f);
+
+    // The shape is untouched; its shadow shows to the lower right.
+    const Rgba shape = layer.bitmap.pixel(6, 6);
+    SLP_CHECK_NEAR(shape.r, 1.0f, 1e-6f);
+    SLP_CHECK_NEAR(shape.a, 1.0f, 1e-6f);
+    const Rgba shadow = layer.bitmap.pixel(11, 11);
+    SLP_CHECK_NEAR(shadow.r, 0.0f, 1e-6f);
+    SLP_CHECK_NEAR(shadow.a, 0.5f, 0.01f);
+    SLP_CHECK_EQ(layer.bitmap.pixel(4, 4).a, 0.0f);
+}
+
+SLP_TEST(grassIsSeededAndStandsOnItsBaseline) {
+    const StaticLayer a = renderGrass(meadowGrass(7));
+    const StaticLayer b = renderGrass(meadowGrass(7));
+    const StaticLayer c = renderGrass(meadowGrass(8));
+
+    SLP_CHECK_EQ(a.bitmap.byteCount(), b.bitmap.byteCount());
+    SLP_CHECK(std::memcmp(a.bitmap.data(), b.bitmap.data(), a.bitmap.byteCount()) == 0);
+    SLP_CHECK(std::memcmp(a.bitmap.data(), c.bitmap.data(), a.bitmap.byteCount()) != 0);
+
+    // One spacing of overhang on each side, and the strip ends just below
+    // the baseline.
+    SLP_CHECK_NEAR(a.x, -15.0f, 1e-6f);
+    SLP_CHECK_NEAR(a.width(), 150.0f, 0.5f);
+    SLP_CHECK(a.y < 100.0f - 60.0f);
+    SLP_CHECK(a.y + a.height() > 100.0f);
+
+    const int width = a.bitmap.width();
+    const int baselineRow = static_cast<int>((100.0f - a.y) * a.scale);
+    SLP_CHECK_EQ(alphaSum(a.bitmap, 0, baselineRow, width, a.bitmap.height()), 0.0f);
+    SLP_CHECK(alphaSum(a.bitmap, 0, baselineRow - 20, width, baselineRow) > 10.0f);
+    // Every blade is at least 30 pt tall.
+    const int shortestTop = static_cast<int>((100.0f - 29.0f - a.y) * a.scale);
+    int bladesAtShortest = 0;
+    for (int x = 0; x < width; ++x) {
+        if (a.bitmap.pixel(x, shortestTop).a > 0.0f) ++bladesAtShortest;
+    }
+    SLP_CHECK(bladesAtShortest >= 8);
+}
+
+SLP_TEST(hillsFollowTheHillShape) {
+    const float width = 200.0f;
+    const float top = 100.0f;
+    const float height = 400.0f;
+    HillConfig hill;
+    hill.top = top;
+    hill.height = height;
+    hill.fill = solid(kWhite);
+    const StaticLayer layer = renderHills(width, top, 300.0f, 1.0f, {hill});
+    SLP_CHECK_EQ(layer.bitmap.height(), 200);
+
+    // The middle curve peaks between its ends, at t = 0.5: x = 0.4975 w,
+    // y = top + 0.125 h.
+    const int column = static_cast<int>(0.4975f * width);
+    int firstRow = -1;
+    for (int y = 0; y < layer.bitmap.height(); ++y) {
+        if (layer.bitmap.pixel(column, y).a > 0.5f) {
+            firstRow = y;
+            break;
+        }
+    }
+    SLP_CHECK_NEAR(static_cast<float>(firstRow), 0.125f * height, 2.0f);
+    // Solid below the ridge, empty above it.
+    SLP_CHECK_NEAR(layer.bitmap.pixel(column, 150).a, 1.0f, 1e-6f);
+    SLP_CHECK_EQ(layer.bitmap.pixel(column, 10).a, 0.0f);
+}
+
+SLP_TEST(starSpritesAreCentredAndGrowWithSize) {
+    StarSpriteConfig config;
+    config.scale = 3.0f;
+    config.size = {1.5f, 6.0f};
+    config.count = 4;
+    config.fill.stops[0] = kWhite;
+    config.fill.stops[1] = {0.0f, 0.5f, 1.0f, 0.3f};
+    config.fill.stops[2] = {0.0f, 0.0f, 0.0f, 0.0f};
+    config.fill.count = 3;
+    config.fillRadius = 3.0f;
+
+    const int cell = spriteCell(config);
+    const StaticLayer layer = renderStarSprites(config);
+    SLP_CHECK_EQ(cell, 20);
+    SLP_CHECK_EQ(layer.bitmap.width(), 4 * cell);
+    SLP_CHECK_EQ(layer.bitmap.height(), cell);
+
+    float previous = 0.0f;
+    for (int i = 0; i < 4; ++i) {
+        const int x0 = i * cell;
+        const float coverage = alphaSum(layer.bitmap, x0, 0, x0 + cell, cell);
+        SLP_CHECK(coverage > previous);
+        previous = coverage;
+        SLP_CHECK(layer.bitmap.pixel(x0 + cell / 2, cell / 2).a > (i == 3 ? 0.8f : 0.2f));
+        // Cells keep a clear border so sprites never bleed into each other.
+        SLP_CHECK_EQ(alphaSum(layer.bitmap, x0, 0, x0 + 1, cell), 0.0f);
+        SLP_CHECK_EQ(alphaSum(layer.bitmap, x0, 0, x0 + cell, 1), 0.0f);
+    }
+}
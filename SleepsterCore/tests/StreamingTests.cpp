@@ -0,0 +1,189 @@
+//
+//  StreamingTests.cpp
+//  SleepsterCore
+//
+
+#include "TestHarness.hpp"
+
+#include "sleepster/Mixer.hpp"
+#include "sleepster/StreamingSource.hpp"
+#include "sleepster/WavFile.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace sleepster;
+
+namespace {
+
+/// In-memory decoder producing sample n == n (mod length), so any gap or
+/// repeat in the stream is visible.
+class CountingDecoder final : public Decoder {
+public:
+    CountingDecoder(uint64_t length, double rate) : length_(length), rate_(rate) {}
+
+    double sampleRate() const noexcept override { return rate_; }
+    uint64_t frameCount() const noexcept override { return length_; }
+
+    std::size_t decode(float* left, float* right, std::size_t frames) override {
+        std::size_t count = 0;
+        for (; count < frames && cursor_ < length_; ++count, ++cursor_) {
+            left[count] = static_cast<float>(cursor_);
+            right[count] = -static_cast<float>(cursor_);
+        }
+        return count;
+    }
+
+    bool seek(uint64_t frame) override {
+        cursor_ = frame;
+        return true;
+    }
+
+private:
+    uint64_t length_;
+    double rate_;
+    uint64_t cursor_ = 0;
+};
+
+std::string tempPath(const char* name) {
+    return std::string("/tmp/sleepster_") + name;
+}
+
+/// Renders `total` frames in blocks, giving the worker time to refill.
+std::vector<float> drain(AudioSource& source, std::size_t total, std::size_t block,
+                         std::size_t* producedOut = nullptr) {
+    std::vector<float> out;
+    std::vector<float> left(block), right(block);
+    std::size_t produced = 0;
+    while (out.size() < total) {
+        const std::size_t n = source.render(left.data(), right.data(), block);
+        out.insert(out.end(), left.begin(), left.begin() + n);
+        produced += n;
+        if (n < block) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    if (producedOut) *producedOut = produced;
+    return out;
+}
+
+} // namespace
+
+SLP_TEST(wavRoundTripsPcm16AndFloat) {
+    std::vector<float> left = {0.0f, 0.5f, -0.5f, 0.25f};
+    std::vector<float> right = {1.0f, -1.0f, 0.125f, 0.0f};
+    const float* channels[] = {left.data(), right.data()};
+
+    for (auto encoding : {WavFormat::Encoding::Pcm16, WavFormat::Encoding::Float32}) {
+        const std::string path = tempPath("roundtrip.wav");
+        SLP_CHECK(writeWav(path, channels, 2, left.size(), 44100.0, encoding));
+
+        auto decoder = WavDecoder::open(path);
+        SLP_CHECK(decoder != nullptr);
+        if (!decoder) continue;
+        SLP_CHECK_EQ(decoder->frameCount(), 4u);
+        SLP_CHECK_EQ(decoder->sampleRate(), 44100.0);
+
+        float l[8], r[8];
+        SLP_CHECK_EQ(decoder->decode(l, r, 8), 4u);
+        for (int i = 0; i < 4; ++i) {
+            SLP_CHECK_NEAR(l[i], left[i], 1e-4f);
+            SLP_CHECK_NEAR(r[i], right[i], 1e-4f);
+        }
+        SLP_CHECK_EQ(decoder->decode(l, r, 8), 0u);
+        std::remove(path.c_str());
+    }
+}
+
+SLP_TEST(monoWavIsDuplicatedToBothChannels) {
+    std::vector<float> mono = {0.25f, -0.25f};
+    const float* channels[] = {mono.data()};
+    const std::string path = tempPath("mono.wav");
+    SLP_CHECK(writeWav(path, channels, 1, mono.size(), 48000.0));
+
+    auto decoder = WavDecoder::open(path);
+    SLP_CHECK(decoder != nullptr);
+    if (decoder) {
+        float l[2], r[2];
+        SLP_CHECK_EQ(decoder->decode(l, r, 2), 2u);
+        SLP_CHECK_EQ(l[1], -0.25f);
+        SLP_CHECK_EQ(r[1], -0.25f);
+    }
+    std::remove(path.c_str());
+}
+
+SLP_TEST(streamLoopsSeamlesslyAtDecoderLevel) {
+    StreamDecodeWorker worker;
+    StreamingConfig config;
+    config.lookaheadSeconds = 0.05;
+    config.chunkFrames = 512;
+    StreamingSource source(std::make_unique<CountingDecoder>(3000, 48000.0), config, worker);
+    source.prepare(48000.0, 256);
+
+    const std::vector<float> out = drain(source, 20000, 256);
+    bool continuous = out.size() >= 20000;
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        continuous = continuous && out[i] == static_cast<float>(i % 3000);
+    }
+    SLP_CHECK(continuous);
+    SLP_CHECK_EQ(source.underrunFrames(), 0u);
+}
+
+SLP_TEST(nonLoopingStreamFinishes) {
+    StreamDecodeWorker worker;
+    StreamingConfig config;
+    config.lookaheadSeconds = 0.02;
+    config.loop = false;
+    StreamingSource source(std::make_unique<CountingDecoder>(5000, 48000.0), config, worker);
+    source.prepare(48000.0, 256);
+
+    std::size_t produced = 0;
+    drain(source, 100000, 256, &produced);
+    SLP_CHECK_EQ(produced, 5000u);
+}
+
+SLP_TEST(memoryIsBoundedByLookaheadNotTrackLength) {
+    StreamDecodeWorker worker;
+    StreamingConfig config;
+    config.lookaheadSeconds = 2.0;
+    // Ten minutes of audio.
+    StreamingSource source(std::make_unique<CountingDecoder>(48000ull * 600, 48000.0), config, worker);
+    source.prepare(48000.0, 1024);
+    SLP_CHECK_EQ(source.capacityFrames(), 96000u);
+    SLP_CHECK_EQ(source.bufferBytes(), 96000u * 2 * sizeof(float));
+}
+
+SLP_TEST(resamplingDecoderDoublesRate) {
+    ResamplingDecoder decoder(std::make_unique<CountingDecoder>(100, 24000.0), 48000.0);
+    SLP_CHECK_EQ(decoder.frameCount(), 200u);
+    float l[64], r[64];
+    SLP_CHECK_EQ(decoder.decode(l, r, 64), 64u);
+    for (int i = 0; i < 64; ++i) SLP_CHECK_NEAR(l[i], 0.5f * i, 1e-5f);
+}
+
+SLP_TEST(streamPlaysThroughMixer) {
+    std::vector<float> tone(4800, 0.5f);
+    const float* channels[] = {tone.data()};
+    const std::string path = tempPath("mixer_stream.wav");
+    SLP_CHECK(writeWav(path, channels, 1, tone.size(), 48000.0));
+
+    Mixer mixer;
+    StreamingConfig config;
+    config.loop = false;
+    const VoiceId voice = mixer.play(std::make_unique<StreamingSource>(WavDecoder::open(path), config), 1.0f);
+    SLP_CHECK(voice != kInvalidVoice);
+
+    std::vector<float> left(256), right(256);
+    mixer.render(left.data(), right.data(), left.size());
+    SLP_CHECK_NEAR(left[100], 0.5f, 1e-6f);
+
+    for (int i = 0; i < 100 && mixer.activeVoiceCount() > 0; ++i) {
+        mixer.render(left.data(), right.data(), left.size());
+        MixerEvent events[2];
+        mixer.collectEvents(events, 2);
+    }
+    SLP_CHECK_EQ(mixer.activeVoiceCount(), 0u);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,61 @@
+//
+//  TestHarness.hpp
+//  SleepsterCore
+//
+//  Dependency-free test registration for the Linux build. Each test file
+//  defines cases with SLP_TEST and links against TestMain.cpp.
+//
+
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+namespace sleepster::test {
+
+struct TestCase {
+    const char* name;
+    std::function<void()> body;
+};
+
+inline std::vector<TestCase>& registry() {
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+inline int& failureCount() {
+    static int failures = 0;
+    return failures;
+}
+
+struct Registrar {
+    Registrar(const char* name, std::function<void()> body) {
+        registry().push_back({name, std::move(body)});
+    }
+};
+
+inline void reportFailure(const char* file, int line, const char* expression) {
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+    ++failureCount();
+}
+
+} // namespace sleepster::test
+
+#define SLP_TEST_CONCAT_INNER(a, b) a##b
+#define SLP_TEST_CONCAT(a, b) SLP_TEST_CONCAT_INNER(a, b)
+
+#define SLP_TEST(name)                                                                   \
+    static void name();                                                                  \
+    static ::sleepster::test::Registrar SLP_TEST_CONCAT(name, _registrar)(#name, &name); \
+    static void name()
+
+#define SLP_CHECK(expression)                                                            \
+    do {                                                                                 \
+        if (!(expression)) ::sleepster::test::reportFailure(__FILE__, __LINE__, #expression); \
+    } while (0)
+
+#define SLP_CHECK_EQ(a, b) SLP_CHECK((a) == (b))
+
+#define SLP_CHECK_NEAR(a, b, tolerance) SLP_CHECK(std::fabs((a) - (b)) <= (tolerance))
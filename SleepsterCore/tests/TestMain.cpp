@@ -0,0 +1,23 @@
+//
+//  TestMain.cpp
+//  SleepsterCore
+//
+
+#include "TestHarness.hpp"
+
+#include <cstdio>
+
+int main() {
+    using namespace sleepster::test;
+
+    int failedCases = 0;
+    for (const TestCase& testCase : registry()) {
+        const int before = failureCount();
+        testCase.body();
+        const bool passed = failureCount() == before;
+        if (!passed) ++failedCases;
+        std::printf("[%s] %s\n", passed ? "  OK  " : " FAIL ", testCase.name);
+    }
+    std::printf("%zu tests, %d failed\n", registry().size(), failedCases);
+    return failedCases == 0 ? 0 : 1;
+}
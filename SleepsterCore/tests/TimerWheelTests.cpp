@@ -0,0 +1,362 @@
+//
+//  TimerWheelTests.cpp
+//  SleepsterCore
+//
+//  Besides the unit cases, a whole night of the app's timers is replayed
+//  against the wheel: every timer must fire inside its window, and the
+//  wakeups it costs are compared with one wakeup per timer firing.
+//
+
+#include "TestHarness.hpp"
+
+#include "SLPTimerWheel.h"
+#include "sleepster/Random.hpp"
+#include "sleepster/TimerWheel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+using namespace sleepster;
+
+namespace {
+
+std::vector<TimerId> fire(TimerWheel& wheel, double now) {
+    const std::vector<TimerId>& fired = wheel.advance(now);
+    return {fired.begin(), fired.end()};
+}
+
+bool contains(const std::vector<TimerId>& ids, TimerId id) {
+    return std::find(ids.begin(), ids.end(), id) != ids.end();
+}
+
+// MARK: - Night
+
+/// A scripted change to the set of timers, such as the screen turning off.
+struct Event {
+    double time;
+    std::function<void()> apply;
+};
+
+/// Replays a night against a wheel: runs it from wakeup to wakeup and
+/// checks every firing against the window of the timer that fired.
+class Night {
+public:
+    explicit Night(bool coalesce) : coalesce_(coalesce) {}
+
+    TimerId every(double start, double interval, double tolerance, bool critical = false) {
+        return add({start, interval, tolerance, critical});
+    }
+
+    TimerId once(double deadline, double tolerance, bool critical = false) {
+        return add({deadline, 0.0, tolerance, critical});
+    }
+
+    void cancel(TimerId id) {
+        wheel_.cancel(id);
+        expected_.erase(id);
+    }
+
+    void screen(bool on) {
+        if (coalesce_) wheel_.setLowPower(!on);
+    }
+
+    void at(double time, std::function<void()> apply) { events_.push_back({time, std::move(apply)}); }
+
+    /// Returns false when a timer fired outside its window.
+    bool run(double until) {
+        std::stable_sort(events_.begin(), events_.end(), [](const Event& a, const Event& b) { return a.time < b.time; });
+        std::size_t nextEvent = 0;
+        bool inWindow = true;
+        for (;;) {
+            double now = wheel_.nextWakeup();
+            if (nextEvent < events_.size()) now = std::min(now, events_[nextEvent].time);
+            if (now > until) break;
+            for (TimerId id : fire(wheel_, now)) {
+                Expected& timer = expected_.at(id);
+                const double slack = wheel_.lowPower() && !timer.spec.critical
+                    ? std::max(timer.spec.tolerance * 8.0, 1.0)
+                    : timer.spec.tolerance;
+                inWindow = inWindow && now >= timer.deadline - 1e-9 && now <= timer.deadline + slack + 2e-3;
+                if (timer.spec.interval > 0.0) {
+                    timer.deadline += timer.spec.interval * (std::floor((now - timer.deadline) / timer.spec.interval + 1e-9) + 1.0);
+                } else {
+                    expected_.erase(id);
+                }
+            }
+            while (nextEvent < events_.size() && events_[nextEvent].time <= now) {
+                events_[nextEvent++].apply();
+            }
+        }
+        wheel_.advance(until);
+        return inWindow;
+    }
+
+    const TimerWheel& wheel() const { return wheel_; }
+
+private:
+    struct Expected {
+        TimerSpec spec;
+        double deadline;
+    };
+
+    TimerId add(TimerSpec spec) {
+        Expected expected{spec, spec.deadline};
+        if (!coalesce_) spec.tolerance = 0.0;
+        const TimerId id = wheel_.schedule(spec);
+        expected.spec.tolerance = spec.tolerance;
+        expected_[id] = expected;
+        return id;
+    }
+
+    bool coalesce_;
+    TimerWheel wheel_;
+    std::map<TimerId, Expected> expected_;
+    std::vector<Event> events_;
+};
+
+constexpr double kNightSeconds = 8.0 * 3600.0;
+
+/// Bedtime with a 45 minute sleep timer and the screen on for the first
+/// 20 minutes, then the overnight housekeeping until morning.
+void script(Night& night) {
+    // All night: the performance monitor, sleep-tracking samples, analytics
+    // and stats flushes.
+    night.every(1.0, 1.0, 0.5);
+    night.every(30.0, 30.0, 3.0);
+    night.every(60.0, 60.0, 6.0);
+    night.every(300.0, 300.0, 30.0);
+
+    // The sleep timer's countdown tick and its critical end, which starts
+    // the 10 s fade-out.
+    const TimerId tick = night.every(1.0, 1.0, 0.1);
+    night.once(2700.0, 0.0, true);
+    night.at(2700.0, [&night, tick] {
+        night.cancel(tick);
+        night.once(2710.0, 0.05);
+    });
+
+    // The counting-sheep jumps while the background is on screen.
+    const TimerId sheep = night.every(3.0, 3.0, 0.3);
+    night.at(1200.0, [&night, sheep] {
+        night.cancel(sheep);
+        night.screen(false);
+    });
+
+    // Dragging the volume and timer sliders for the first minute restarts a
+    // 300 ms debounce every 100 ms; the last one fires.
+    auto debounce = std::make_shared<TimerId>(kNoTimer);
+    for (int step = 0; step < 600; ++step) {
+        night.at(step * 0.1, [&night, debounce] {
+            if (*debounce != kNoTimer) night.cancel(*debounce);
+            *debounce = night.once(night.wheel().now() + 0.3, 0.03);
+        });
+    }
+}
+
+} // namespace
+
+// MARK: - Scheduling
+
+SLP_TEST(timersFireAtTheirDeadlineOnEveryLevel) {
+    TimerWheel wheel;
+    const double deadlines[] = {0.005, 0.07, 5.0, 300.0, 3.0 * 3600.0, 40.0 * 86400.0};
+    std::vector<TimerId> ids;
+    for (double deadline : deadlines) ids.push_back(wheel.schedule({deadline}));
+    SLP_CHECK_EQ(wheel.size(), std::size_t{6});
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        SLP_CHECK_NEAR(wheel.nextWakeup(), deadlines[i], 1e-9);
+        SLP_CHECK(fire(wheel, deadlines[i] - 0.002).empty());
+        const std::vector<TimerId> fired = fire(wheel, wheel.nextWakeup());
+        SLP_CHECK_EQ(fired.size(), std::size_t{1});
+        SLP_CHECK(contains(fired, ids[i]));
+        SLP_CHECK(!wheel.isScheduled(ids[i]));
+    }
+    SLP_CHECK(std::isinf(wheel.nextWakeup()));
+}
+
+SLP_TEST(overlappingWindowsShareOneWakeup) {
+    TimerWheel wheel;
+    const TimerId a = wheel.schedule({1.00, 0.0, 0.20});
+    const TimerId b = wheel.schedule({1.10, 0.0, 0.50});
+    const TimerId c = wheel.schedule({1.15, 0.0, 0.00});
+    const TimerId d = wheel.schedule({1.30, 0.0, 0.10});
+    // c's window closes first, at 1.15; a and b are due by then, d is not.
+    SLP_CHECK_NEAR(wheel.nextWakeup(), 1.15, 1e-9);
+    std::vector<TimerId> fired = fire(wheel, wheel.nextWakeup());
+    SLP_CHECK_EQ(fired.size(), std::size_t{3});
+    SLP_CHECK_EQ(fired[0], a);
+    SLP_CHECK_EQ(fired[1], b);
+    SLP_CHECK_EQ(fired[2], c);
+    SLP_CHECK_NEAR(wheel.nextWakeup(), 1.40, 1e-9);
+    fired = fire(wheel, wheel.nextWakeup());
+    SLP_CHECK(contains(fired, d));
+    SLP_CHECK_EQ(wheel.wakeupCount(), 2u);
+    SLP_CHECK_EQ(wheel.firedCount(), 4u);
+}
+
+SLP_TEST(anEarlyAdvanceFiresEverythingAlreadyDue) {
+    TimerWheel wheel;
+    const TimerId a = wheel.schedule({2.0, 0.0, 5.0});
+    const TimerId b = wheel.schedule({3.0, 0.0, 5.0});
+    SLP_CHECK_NEAR(wheel.nextWakeup(), 7.0, 1e-9);
+    // Woken for something else at 2.5, the wheel takes a along.
+    const std::vector<TimerId> fired = fire(wheel, 2.5);
+    SLP_CHECK_EQ(fired.size(), std::size_t{1});
+    SLP_CHECK(contains(fired, a));
+    SLP_CHECK(wheel.isScheduled(b));
+}
+
+SLP_TEST(cancelledAndFiredIdsAreRejected) {
+    TimerWheel wheel;
+    const TimerId a = wheel.schedule({1.0});
+    const TimerId b = wheel.schedule({2.0});
+    SLP_CHECK(a != kNoTimer);
+    SLP_CHECK(wheel.cancel(a));
+    SLP_CHECK(!wheel.cancel(a));
+    SLP_CHECK_NEAR(wheel.nextWakeup(), 2.0, 1e-9);
+    // The freed node is reused under a new id.
+    const TimerId c = wheel.schedule({3.0});
+    SLP_CHECK(c != a);
+    SLP_CHECK(!wheel.isScheduled(a));
+    fire(wheel, 5.0);
+    SLP_CHECK(!wheel.cancel(b));
+    SLP_CHECK(!wheel.cancel(c));
+    SLP_CHECK_EQ(wheel.size(), std::size_t{0});
+}
+
+SLP_TEST(repeatingTimersStayOnTheirGrid) {
+    TimerWheel wheel;
+    const TimerId id = wheel.schedule({1.0, 1.0, 0.4});
+    fire(wheel, 1.3);
+    SLP_CHECK(wheel.isScheduled(id));
+    SLP_CHECK_NEAR(wheel.nextWakeup(), 2.4, 1e-9);
+    // A stall skips the missed periods instead of firing them all.
+    const std::vector<TimerId> fired = fire(wheel, 5.5);
+    SLP_CHECK_EQ(fired.size(), std::size_t{1});
+    SLP_CHECK_NEAR(wheel.nextWakeup(), 6.4, 1e-9);
+}
+
+SLP_TEST(lowPowerStretchesAllButCriticalTolerances) {
+    TimerWheel wheel;
+    wheel.schedule({10.0, 0.0, 0.5});
+    wheel.schedule({20.0, 0.0, 0.5, true});
+    wheel.setLowPower(true);
+    SLP_CHECK_NEAR(wheel.nextWakeup(), 14.0, 1e-9);
+    fire(wheel, wheel.nextWakeup());
+    SLP_CHECK_NEAR(wheel.nextWakeup(), 20.5, 1e-9);
+    wheel.schedule({21.0, 0.0, 0.0});
+    // The one-second floor applies to timers without tolerance.
+    SLP_CHECK_NEAR(wheel.nextWakeup(), 20.5, 1e-9);
+    fire(wheel, 20.5);
+    SLP_CHECK_NEAR(wheel.nextWakeup(), 22.0, 1e-9);
+    wheel.setLowPower(false);
+    SLP_CHECK_NEAR(wheel.nextWakeup(), 21.0, 1e-9);
+}
+
+SLP_TEST(matchesASortedListUnderRandomOperations) {
+    // The reference keeps (deadline tick, id) for every live one-shot.
+    TimerWheel wheel;
+    std::map<TimerId, int64_t> reference;
+    Random random(13);
+    int64_t nowTick = 0;
+    for (int step = 0; step < 20000; ++step) {
+        const uint32_t op = random.next() % 8;
+        if (op < 4) {
+            // Spread deadlines from the current slot to days ahead.
+            const int magnitude = static_cast<int>(random.next() % 8);
+            const int64_t delta = static_cast<int64_t>(random.next() % (uint32_t{1} << (3 * magnitude + 1)));
+            const int64_t deadline = nowTick + delta;
+            reference[wheel.schedule({deadline * 0.001})] = deadline;
+        } else if (op < 5 && !reference.empty()) {
+            auto it = reference.begin();
+            std::advance(it, random.next() % reference.size());
+            SLP_CHECK(wheel.cancel(it->first));
+            reference.erase(it);
+        } else {
+            const int magnitude = static_cast<int>(random.next() % 7);
+            nowTick += static_cast<int64_t>(random.next() % (uint32_t{1} << (3 * magnitude)));
+            std::vector<TimerId> expected;
+            for (auto it = reference.begin(); it != reference.end();) {
+                if (it->second <= nowTick) {
+                    expected.push_back(it->first);
+                    it = reference.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            std::vector<TimerId> fired = fire(wheel, nowTick * 0.001);
+            std::sort(fired.begin(), fired.end());
+            std::sort(expected.begin(), expected.end());
+            SLP_CHECK(fired == expected);
+        }
+        if (!reference.empty() && step % 97 == 0) {
+            int64_t earliest = reference.begin()->second;
+            for (const auto& entry : reference) earliest = std::min(earliest, entry.second);
+            SLP_CHECK_NEAR(wheel.nextWakeup(), std::max(earliest, nowTick) * 0.001, 1e-6);
+        }
+    }
+    SLP_CHECK_EQ(wheel.size(), reference.size());
+}
+
+// MARK: - A night
+
+SLP_TEST(aNightOfTimersFiresInsideItsWindowsWithFewerWakeups) {
+    Night separate(false);
+    script(separate);
+    SLP_CHECK(separate.run(kNightSeconds));
+
+    Night coalesced(true);
+    script(coalesced);
+    SLP_CHECK(coalesced.run(kNightSeconds));
+
+    // Once the screen is off, a one-second timer's stretched tolerance
+    // reaches its next period, and it skips the periods it slept through.
+    SLP_CHECK(coalesced.wheel().firedCount() < separate.wheel().firedCount());
+    const double before = separate.wheel().wakeupsPerHour();
+    const double after = coalesced.wheel().wakeupsPerHour();
+    SLP_CHECK(after < before / 2.0);
+}
+
+SLP_TEST(theScreenTurningOffCutsOvernightWakeups) {
+    Night night(true);
+    script(night);
+    SLP_CHECK(night.run(3600.0));
+
+    Night awake(true);
+    script(awake);
+    // Keep this one's screen on all night.
+    awake.at(1200.0, [&awake] { awake.screen(true); });
+    SLP_CHECK(awake.run(3600.0));
+
+    // Only the all-night timers run after the first 45 minutes: one second
+    // of tolerance and up lets the screen-off wheel take them in batches.
+    const double dark = night.wheel().wakeupsPerHour();
+    const double lit = awake.wheel().wakeupsPerHour();
+    SLP_CHECK(dark < lit * 0.75);
+}
+
+SLP_TEST(cInterfaceFiresAndReportsMetrics) {
+    SLPTimerWheel* wheel = SLPTimerWheelCreate(100.0);
+    const SLPTimerID a = SLPTimerWheelSchedule(wheel, 101.0, 0.0, 0.5, false);
+    const SLPTimerID b = SLPTimerWheelSchedule(wheel, 101.2, 1.0, 0.0, false);
+    SLP_CHECK_NEAR(SLPTimerWheelGetNextWakeup(wheel), 101.2, 1e-9);
+    const SLPTimerID* fired = nullptr;
+    SLP_CHECK_EQ(SLPTimerWheelAdvance(wheel, 101.2, &fired), std::size_t{2});
+    SLP_CHECK_EQ(fired[0], a);
+    SLP_CHECK_EQ(fired[1], b);
+    SLP_CHECK_EQ(SLPTimerWheelAdvance(wheel, 101.5, &fired), std::size_t{0});
+    SLP_CHECK(fired == nullptr);
+    SLP_CHECK(SLPTimerWheelCancel(wheel, b));
+    SLP_CHECK(std::isinf(SLPTimerWheelGetNextWakeup(wheel)));
+    SLPTimerWheelSetLowPower(wheel, true);
+    SLPTimerWheelAdvance(wheel, 100.0 + 3600.0, &fired);
+    const SLPTimerWheelMetrics metrics = SLPTimerWheelGetMetrics(wheel);
+    SLP_CHECK_EQ(metrics.wakeups, 1u);
+    SLP_CHECK_EQ(metrics.fired, 2u);
+    SLP_CHECK_NEAR(metrics.wakeupsPerHour, 1.0, 1e-9);
+    SLPTimerWheelDestroy(wheel);
+}
@@ -0,0 +1,215 @@
+//
+//  TraceTests.cpp
+//  SleepsterCore
+//
+
+#include "TestHarness.hpp"
+
+#include "SLPTrace.h"
+#include "sleepster/Trace.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace sleepster;
+
+namespace {
+
+/// Every event called `name`, from any thread.
+std::vector<TraceEvent> eventsNamed(const char* name) {
+    std::vector<TraceEvent> found;
+    for (const TraceThread& thread : Tracer::snapshot()) {
+        for (const TraceEvent& event : thread.events) {
+            if (event.name && std::strcmp(event.name, name) == 0) found.push_back(event);
+        }
+    }
+    return found;
+}
+
+void restart() {
+    Tracer::setEnabled(true);
+    Tracer::clear();
+}
+
+} // namespace
+
+SLP_TEST(spansRecordTheirDurationOnTheCallingThread) {
+    restart();
+    {
+        TraceScope scope(TraceCategory::App, "test.sleep");
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    const std::vector<TraceEvent> events = eventsNamed("test.sleep");
+    SLP_CHECK_EQ(events.size(), 1u);
+    SLP_CHECK(events[0].phase == TracePhase::Complete);
+    SLP_CHECK(events[0].category == TraceCategory::App);
+    SLP_CHECK(events[0].duration >= 2000000u);
+    SLP_CHECK(events[0].duration < 1000000000u);
+}
+
+SLP_TEST(nothingIsRecordedWhileTracingIsOff) {
+    restart();
+    Tracer::setEnabled(false);
+    { TraceScope scope(TraceCategory::App, "test.off"); }
+    SLP_CHECK(eventsNamed("test.off").empty());
+    SLP_CHECK_EQ(Tracer::metrics().recorded, 0u);
+
+    // A span that began while tracing was off stays unrecorded.
+    {
+        TraceScope scope(TraceCategory::App, "test.off");
+        Tracer::setEnabled(true);
+    }
+    SLP_CHECK(eventsNamed("test.off").empty());
+}
+
+SLP_TEST(countersKeepTheirValues) {
+    restart();
+    Tracer::counter(TraceCategory::Audio, "test.voices", 3.0);
+    Tracer::counter(TraceCategory::Audio, "test.voices", 0.25);
+    const std::vector<TraceEvent> events = eventsNamed("test.voices");
+    SLP_CHECK_EQ(events.size(), 2u);
+    SLP_CHECK(events[0].phase == TracePhase::Counter);
+    SLP_CHECK_EQ(events[0].value, 3.0);
+    SLP_CHECK_EQ(events[1].value, 0.25);
+    SLP_CHECK(events[1].start >= events[0].start);
+}
+
+SLP_TEST(theRingKeepsTheNewestEvents) {
+    restart();
+    const uint64_t base = traceNow();
+    const std::size_t extra = 100;
+    for (std::size_t i = 0; i < Tracer::kEventsPerThread + extra; ++i) {
+        Tracer::complete(TraceCategory::App, "test.ring", base + i, base + 2 * i);
+    }
+    const std::vector<TraceEvent> events = eventsNamed("test.ring");
+    SLP_CHECK_EQ(events.size(), Tracer::kEventsPerThread);
+    SLP_CHECK_EQ(events.front().duration, extra);
+    SLP_CHECK_EQ(events.back().duration, Tracer::kEventsPerThread + extra - 1);
+    SLP_CHECK_EQ(events.back().start - events.front().start, Tracer::kEventsPerThread - 1);
+
+    const TraceMetrics metrics = Tracer::metrics();
+    SLP_CHECK_EQ(metrics.recorded, Tracer::kEventsPerThread + extra);
+    SLP_CHECK_EQ(metrics.overwritten, extra);
+}
+
+SLP_TEST(eachThreadRecordsIntoItsOwnNamedTrack) {
+    restart();
+    const char* names[] = {"test worker 0", "test worker 1", "test worker 2"};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 3; ++t) {
+        workers.emplace_back([&, t] {
+            Tracer::setThreadName(names[t]);
+            for (int i = 0; i < 10 * (t + 1); ++i) {
+                TraceScope scope(TraceCategory::Storage, "test.worker");
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+
+    int found = 0;
+    for (const TraceThread& thread : Tracer::snapshot()) {
+        for (int t = 0; t < 3; ++t) {
+            if (thread.name != names[t]) continue;
+            ++found;
+            SLP_CHECK_EQ(thread.events.size(), static_cast<std::size_t>(10 * (t + 1)));
+            for (const TraceEvent& event : thread.events) SLP_CHECK(event.category == TraceCategory::Storage);
+        }
+    }
+    SLP_CHECK_EQ(found, 3);
+}
+
+SLP_TEST(snapshotsTakenWhileRecordingAreNeverTorn) {
+    restart();
+    static const char* const kEven = "test.even";
+    static const char* const kOdd = "test.odd";
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        const uint64_t base = traceNow();
+        for (uint64_t k = 0; !stop.load(std::memory_order_relaxed); ++k) {
+            Tracer::complete(TraceCategory::App, k % 2 ? kOdd : kEven, base, base + k);
+        }
+    });
+
+    for (int round = 0; round < 200; ++round) {
+        for (const TraceThread& thread : Tracer::snapshot()) {
+            const TraceEvent* previous = nullptr;
+            for (const TraceEvent& event : thread.events) {
+                if (event.name != kEven && event.name != kOdd) continue;
+                SLP_CHECK(event.name == (event.duration % 2 ? kOdd : kEven));
+                if (previous) SLP_CHECK_EQ(event.duration, previous->duration + 1);
+                previous = &event;
+            }
+        }
+    }
+    stop.store(true);
+    writer.join();
+}
+
+SLP_TEST(chromeJsonHoldsSpansCountersAndThreadNames) {
+    restart();
+    Tracer::setThreadName("test main");
+    { TraceScope scope(TraceCategory::Animation, "test.\"quoted\""); }
+    Tracer::counter(TraceCategory::Audio, "test.level", 1.5);
+
+    const std::string json = Tracer::chromeJson();
+    SLP_CHECK(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0);
+    SLP_CHECK(json.find("\"args\":{\"name\":\"test main\"}") != std::string::npos);
+    SLP_CHECK(json.find("{\"name\":\"test.\\\"quoted\\\"\",\"cat\":\"animation\",\"ts\":") != std::string::npos);
+    SLP_CHECK(json.find("\"ph\":\"X\",\"dur\":") != std::string::npos);
+    SLP_CHECK(json.find("{\"name\":\"test.level\",\"cat\":\"audio\"") != std::string::npos);
+    SLP_CHECK(json.find("\"ph\":\"C\"") != std::string::npos);
+    SLP_CHECK(json.find("\"args\":{\"value\":1.5}") != std::string::npos);
+
+    const char* path = "/tmp/sleepster_trace_tests.json";
+    SLP_CHECK(Tracer::exportChromeJson(path));
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    SLP_CHECK(contents.str() == Tracer::chromeJson());
+    std::remove(path);
+}
+
+#if SLEEPSTER_TRACING
+SLP_TEST(macrosRecordOnlyWhileTracingIsOn) {
+    restart();
+    int evaluated = 0;
+    {
+        SLP_TRACE_SPAN(App, "test.macro");
+        SLP_TRACE_COUNTER(App, "test.macroCount", ++evaluated);
+    }
+    SLP_CHECK_EQ(eventsNamed("test.macro").size(), 1u);
+    SLP_CHECK_EQ(eventsNamed("test.macroCount").size(), 1u);
+    SLP_CHECK_EQ(evaluated, 1);
+
+    Tracer::setEnabled(false);
+    SLP_TRACE_COUNTER(App, "test.macroCount", ++evaluated);
+    SLP_CHECK_EQ(evaluated, 1);
+}
+#endif
+
+SLP_TEST(cInterfaceRecordsSpansFromBeginToEnd) {
+    SLPTraceSetEnabled(false);
+    SLP_CHECK_EQ(SLPTraceBegin(), 0u);
+    SLPTraceEnd(SLPTraceCategoryStorage, "test.c", 0);
+
+    SLPTraceSetEnabled(true);
+    SLPTraceClear();
+    SLP_CHECK(SLPTraceIsEnabled());
+    const uint64_t begin = SLPTraceBegin();
+    SLP_CHECK(begin != 0);
+    SLPTraceEnd(SLPTraceCategoryStorage, "test.c", begin);
+    SLPTraceCounter(SLPTraceCategoryStorage, "test.c", 7.0);
+
+    const std::vector<TraceEvent> events = eventsNamed("test.c");
+    SLP_CHECK_EQ(events.size(), 2u);
+    SLP_CHECK(events[0].category == TraceCategory::Storage);
+    SLP_CHECK(events[1].phase == TracePhase::Counter);
+    SLP_CHECK_EQ(SLPTraceGetMetrics().recorded, 2u);
+}
@@ -0,0 +1,97 @@
+//
+//  SoundPacker.cpp
+//  SleepsterCore
+//
+//  Builds the app's sound pack from WAV files (16/24-bit PCM or 32-bit
+//  float). Each sound is named after its file, without directory or
+//  extension, which is the name the app plays it by.
+//
+//  Usage: SoundPacker [--rate Hz] output.slpk input.wav...
+//
+//  The bundled sounds are MP3; convert them first, e.g. on macOS with
+//  `afconvert -f WAVE -d LEI16 rain.mp3 rain.wav`.
+//
+
+#include "sleepster/AssetPackWriter.hpp"
+#include "sleepster/WavFile.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace sleepster;
+
+namespace {
+
+std::string stem(const std::string& path) {
+    const std::size_t slash = path.find_last_of('/');
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    const std::size_t dot = name.find_last_of('.');
+    return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+bool readWav(const std::string& path, PcmBuffer& buffer) {
+    auto decoder = WavDecoder::open(path);
+    if (!decoder) return false;
+    const auto frames = static_cast<std::size_t>(decoder->frameCount());
+    std::vector<float> left(frames), right(frames);
+    if (decoder->decode(left.data(), right.data(), frames) != frames) return false;
+
+    buffer.sampleRate = decoder->sampleRate();
+    buffer.frameCount = frames;
+    buffer.channels.clear();
+    buffer.channels.push_back(std::move(left));
+    // Mono stays mono in the pack; the player duplicates it.
+    if (decoder->format().channelCount > 1) buffer.channels.push_back(std::move(right));
+    return true;
+}
+
+int usage() {
+    std::fprintf(stderr, "usage: SoundPacker [--rate Hz] output.slpk input.wav...\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    AssetPackOptions options;
+    int arg = 1;
+    if (arg + 1 < argc && std::strcmp(argv[arg], "--rate") == 0) {
+        options.sampleRate = std::atof(argv[arg + 1]);
+        arg += 2;
+    }
+    if (options.sampleRate <= 0.0 || argc - arg < 2) return usage();
+    const std::string output = argv[arg++];
+
+    std::vector<EncodedAsset> assets;
+    std::size_t pcmBytes = 0;
+    std::printf("%-24s %10s %10s %10s %8s %7s\n", "name", "frames", "loopStart", "loopEnd", "LUFS", "peak");
+    for (; arg < argc; ++arg) {
+        const std::string path = argv[arg];
+        PcmBuffer buffer;
+        if (!readWav(path, buffer)) {
+            std::fprintf(stderr, "%s: not a readable WAV file\n", path.c_str());
+            return 1;
+        }
+        EncodedAsset asset;
+        if (!encodeAsset(stem(path), buffer, options, asset)) {
+            std::fprintf(stderr, "%s: silent, or name longer than %zu bytes\n", path.c_str(),
+                         assetpack::kNameBytes - 1);
+            return 1;
+        }
+        std::printf("%-24s %10u %10u %10u %8.1f %7.3f\n", asset.name.c_str(), asset.frameCount, asset.loopStart,
+                    asset.loopEnd, asset.loudness, asset.peak);
+        pcmBytes += asset.samples.size() * sizeof(int16_t);
+        assets.push_back(std::move(asset));
+    }
+
+    if (!writeAssetPack(output, std::move(assets), options.sampleRate)) {
+        std::fprintf(stderr, "%s: write failed (duplicate names?)\n", output.c_str());
+        return 1;
+    }
+    std::printf("wrote %s: %.1f MB of PCM at %.0f Hz\n", output.c_str(), pcmBytes / (1024.0 * 1024.0),
+                options.sampleRate);
+    return 0;
+}
@@ -11,6 +11,10 @@
 //  this copyright and permission notice. Attribution in compiled projects is
 //  appreciated but not required.
 //
+//  Created once through dispatch_once rather than under @synchronized, so
+//  after the first call the accessor is a plain load with no lock taken.
+//  Instances come only from the accessor; any other alloc returns nil.
+//
 
 #define SYNTHESIZE_SINGLETON_FOR_CLASS(classname) \
  \
@@ -18,28 +22,16 @@ static classname *shared##classname = nil; \
  \
 + (classname *)shared##classname \
 { \
-	@synchronized(self) \
-	{ \
-		if (shared##classname == nil) \
-		{ \
-			shared##classname = [[self alloc] init]; \
-		} \
-	} \
+	static dispatch_once_t onceToken; \
+	dispatch_once(&onceToken, ^{ \
+		shared##classname = [[super allocWithZone:NULL] init]; \
+	}); \
 	 \
 	return shared##classname; \
 } \
  \
 + (id)allocWithZone:(NSZone *)zone \
 { \
-	@synchronized(self) \
-	{ \
-		if (shared##classname == nil) \
-		{ \
-			shared##classname = [super allocWithZone:zone]; \
-			return shared##classname; \
-		} \
-	} \
-	 \
 	return nil; \
 } \
  \
@@ -108,6 +108,14 @@ class MainViewModel: ObservableObject {
                 self?.handleTimerCompletion()
             }
             .store(in: &cancellables)
+        
+        // A mix timeline that ends the night stops the sounds itself
+        audioMixingEngine.automationFinishedPublisher
+            .receive(on: DispatchQueue.main)
+            .sink { [weak self] in
+                self?.handleTimerCompletion()
+            }
+            .store(in: &cancellables)
     }
     
     private func loadInitialData() {
@@ -290,6 +290,11 @@ class SoundsViewModel: ObservableObject {
         // Check if sound file exists
         guard let soundURL = sound.soundUrl1 else { return false }
         
+        // Procedural noise is generated, so there is no file to find
+        if ProceduralNoise(soundName: soundURL) != nil {
+            return true
+        }
+        
         // For local files, check if they exist in bundle
         if !soundURL.contains("http") {
             return Bundle.main.path(forResource: soundURL.replacingOccurrences(of: ".mp3", with: ""), ofType: "mp3") != nil